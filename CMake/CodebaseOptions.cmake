@@ -13,6 +13,7 @@ set (CMAKE_CXX_STANDARD_REQUIRED ON)
 set (CMAKE_CXX_EXTENSIONS OFF)
 
 option (STRIP "Strip all symbols from the binaries" OFF)
+option (BENCHMARKS "Build the benchmark programs" OFF)
 
 # Compiler warning settings
 if (MSVC)
@@ -0,0 +1,193 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#define PROGRAM_NAME "BinaryIOBenchmark"
+#define EXECUTABLE_NAME "BinaryIOBenchmark"
+
+#include <MainCommon.h>
+
+#include "messages.h"
+#include <io/inc/BinaryIO.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+using namespace common;
+using namespace columbus;
+
+static unsigned records = 2000000;
+static unsigned runs = 3;
+
+// The benchmark generates its input, it has no input files.
+static void ppFile( char *filename ) {
+}
+
+static bool ppRecords( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  records = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppRuns( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  runs = value > 0 ? value : 1;
+  return true;
+}
+
+const Option OPTIONS_OBJ [] = {
+  { false,  "-records",     1, "number",            0, OT_WC,    ppRecords,      NULL, "The number of the written and read records. The default value is 2000000."},
+  { false,  "-runs",        1, "number",            0, OT_WC,    ppRuns,         NULL, "The number of the measured runs. The default value is 3."},
+  COMMON_CL_ARGS
+};
+
+static double elapsed( chrono::steady_clock::time_point start ) {
+  return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+}
+
+/**
+* Writes records like the ones of the saved ASG nodes: an id, a kind, a few keys and positions, flags
+* and sometimes a string.
+*/
+static unsigned long long write( const string& filename, bool buffered ) {
+  unsigned long long checksum = 0;
+  io::BinaryIO file( filename, io::IOBase::omWrite );
+  file.setBuffered( buffered );
+  for ( unsigned i = 0; i < records; ++i ) {
+    file.writeUInt4( i );
+    file.writeUShort2( (unsigned short)( i % 300 ) );
+    file.writeUInt4( i * 2654435761u );
+    file.writeUInt4( i / 3 );
+    file.writeUShort2( (unsigned short)( i % 2000 ) );
+    file.writeUByte1( (unsigned char)( i % 80 ) );
+    file.writeBool1( i % 2 == 0 );
+    file.writeLongLong8( (long long)i * 1000003 );
+    checksum += (unsigned long long)i + i % 300 + i * 2654435761u + i / 3 + i % 2000 + i % 80 + ( i % 2 == 0 ) + (unsigned long long)i * 1000003;
+    if ( i % 16 == 0 ) {
+      string name = "name" + to_string( i );
+      file.writeString( name );
+      checksum += name.size();
+    }
+  }
+  file.writeUInt4( 0 );
+  file.close();
+  return checksum;
+}
+
+static unsigned long long read( const string& filename, bool buffered ) {
+  unsigned long long checksum = 0;
+  io::BinaryIO file( filename, io::IOBase::omRead );
+  file.setBuffered( buffered );
+  string name;
+  for ( unsigned i = 0; i < records; ++i ) {
+    checksum += file.readUInt4();
+    checksum += file.readUShort2();
+    checksum += file.readUInt4();
+    checksum += file.readUInt4();
+    checksum += file.readUShort2();
+    checksum += file.readUByte1();
+    checksum += file.readBool1();
+    checksum += file.readLongLong8();
+    if ( i % 16 == 0 ) {
+      file.readString( name );
+      checksum += name.size();
+    }
+  }
+  checksum += file.readUInt4();
+  file.close();
+  return checksum;
+}
+
+static bool sameFiles( const string& lhs, const string& rhs ) {
+  ifstream lhsStream( lhs.c_str(), ios::binary );
+  ifstream rhsStream( rhs.c_str(), ios::binary );
+  return equal( istreambuf_iterator<char>( lhsStream ), istreambuf_iterator<char>(), istreambuf_iterator<char>( rhsStream ) )
+    && boost::filesystem::file_size( lhs ) == boost::filesystem::file_size( rhs );
+}
+
+static void summary( const char* phase, vector<double>& times ) {
+  sort( times.begin(), times.end() );
+  WriteMsg::write( CMSG_SUMMARY, phase, times.front(), times[times.size() / 2], runs );
+}
+
+int main( int argc, char *argv[] ) {
+
+  MAIN_BEGIN
+
+    MainInit( argc, argv, "-" );
+
+    WriteMsg::write( CMSG_GENERATING_RECORDS, records );
+
+    boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path( "BinaryIOBenchmark-%%%%-%%%%" );
+    boost::filesystem::create_directories( directory );
+    const string unbufferedFile = ( directory / "unbuffered.bin" ).string();
+    const string bufferedFile = ( directory / "buffered.bin" ).string();
+
+    int result = 0;
+    vector<double> writeTimes, readTimes, bufferedWriteTimes, bufferedReadTimes;
+    for ( unsigned run = 1; run <= runs && result == 0; ++run ) {
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      unsigned long long checksum = write( unbufferedFile, false );
+      writeTimes.push_back( elapsed( start ) );
+
+      start = chrono::steady_clock::now();
+      if ( read( unbufferedFile, false ) != checksum ) {
+        WriteMsg::write( CMSG_WRONG_CHECKSUM, "unbuffered" );
+        result = 1;
+      }
+      readTimes.push_back( elapsed( start ) );
+
+      start = chrono::steady_clock::now();
+      write( bufferedFile, true );
+      bufferedWriteTimes.push_back( elapsed( start ) );
+
+      start = chrono::steady_clock::now();
+      if ( read( bufferedFile, true ) != checksum ) {
+        WriteMsg::write( CMSG_WRONG_CHECKSUM, "buffered" );
+        result = 1;
+      }
+      bufferedReadTimes.push_back( elapsed( start ) );
+
+      if ( !sameFiles( unbufferedFile, bufferedFile ) ) {
+        WriteMsg::write( CMSG_DIFFERENT_FILES );
+        result = 1;
+      }
+
+      WriteMsg::write( CMSG_RUN_TIME, run, writeTimes.back(), readTimes.back(), bufferedWriteTimes.back(), bufferedReadTimes.back() );
+    }
+
+    boost::filesystem::remove_all( directory );
+    if ( result != 0 ) {
+      return result;
+    }
+
+    summary( "unbuffered write", writeTimes );
+    summary( "unbuffered read", readTimes );
+    summary( "buffered write", bufferedWriteTimes );
+    summary( "buffered read", bufferedReadTimes );
+
+  MAIN_END
+
+  return 0;
+}
@@ -0,0 +1,31 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+#ifndef _BINARYIOBENCHMARK_MESSAGES_H_
+#define _BINARYIOBENCHMARK_MESSAGES_H_
+
+#define CMSG_GENERATING_RECORDS           common::WriteMsg::mlNormal, "Writing and reading %u records\n"
+#define CMSG_RUN_TIME                     common::WriteMsg::mlNormal, "Run %u: unbuffered write %.3f s, read %.3f s, buffered write %.3f s, read %.3f s\n"
+#define CMSG_SUMMARY                      common::WriteMsg::mlNormal, "%-17s min %.3f s, median %.3f s of %u runs\n"
+#define CMSG_WRONG_CHECKSUM               common::WriteMsg::mlError,  "Error: the %s read gives back different values\n"
+#define CMSG_DIFFERENT_FILES              common::WriteMsg::mlError,  "Error: the buffered write gives a different file\n"
+
+#endif
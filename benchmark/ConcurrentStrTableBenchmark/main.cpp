@@ -0,0 +1,192 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#define PROGRAM_NAME "ConcurrentStrTableBenchmark"
+#define EXECUTABLE_NAME "ConcurrentStrTableBenchmark"
+
+#include <MainCommon.h>
+
+#include "messages.h"
+#include <strtable/inc/ConcurrentStrTable.h>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace std;
+using namespace common;
+using namespace columbus;
+
+static unsigned strings = 2000000;
+static unsigned distinct = 200000;
+static unsigned maxThreads = 64;
+static unsigned runs = 3;
+
+// The benchmark generates its input, it has no input files.
+static void ppFile( char *filename ) {
+}
+
+static bool ppStrings( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  strings = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppDistinct( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  distinct = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppMaxThreads( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  maxThreads = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppRuns( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  runs = value > 0 ? value : 1;
+  return true;
+}
+
+const Option OPTIONS_OBJ [] = {
+  { false,  "-strings",     1, "number",            0, OT_WC,    ppStrings,      NULL, "The number of the interned strings (shared by the threads). The default value is 2000000."},
+  { false,  "-distinct",    1, "number",            0, OT_WC,    ppDistinct,     NULL, "The number of the different strings among them. The default value is 200000."},
+  { false,  "-maxthreads",  1, "number",            0, OT_WC,    ppMaxThreads,   NULL, "The thread counts are measured from 1, doubled up to this value. The default value is 64."},
+  { false,  "-runs",        1, "number",            0, OT_WC,    ppRuns,         NULL, "The number of the measured runs per thread count. The default value is 3."},
+  COMMON_CL_ARGS
+};
+
+static double elapsed( chrono::steady_clock::time_point start ) {
+  return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+}
+
+/**
+* The strings of the per-file work: like the unique names of the ASG nodes, most of them come from a few packages
+* and the frequent ones (e.g. the library types) are interned by every file.
+*/
+static void generate( vector<string>& input ) {
+  vector<string> names;
+  for ( unsigned i = 0; i < distinct; ++i ) {
+    names.push_back( "java.package" + to_string( i % 113 ) + ".Class" + to_string( i / 113 ) + ".member" + to_string( i % 7 ) + "(I)V" );
+  }
+
+  mt19937 random( 42 );
+  geometric_distribution<unsigned> frequent( 1.0 / ( distinct / 16.0 ) );
+  uniform_int_distribution<unsigned> any( 0, distinct - 1 );
+  input.reserve( strings );
+  // every name is interned at least once, the rest are the repeated lookups
+  for ( unsigned i = 0; i < strings; ++i ) {
+    input.push_back( names[i < distinct ? i : ( i % 2 ? any( random ) : min( frequent( random ), distinct - 1 ) )] );
+  }
+  shuffle( input.begin(), input.end(), random );
+}
+
+template <class Table>
+static void intern( Table& table, const vector<string>& input, size_t begin, size_t end, unsigned long long& checksum ) {
+  unsigned long long sum = 0;
+  for ( size_t i = begin; i < end; ++i ) {
+    sum += table.set( input[i] );
+  }
+  checksum = sum;
+}
+
+/**
+* The StrTable shared by the threads the way it could be done without the ConcurrentStrTable.
+*/
+class LockedStrTable {
+  public:
+    Key set( const string& s ) {
+      boost::mutex::scoped_lock lock( mutex );
+      return table.set( s );
+    }
+
+  private:
+    boost::mutex mutex;
+    StrTable table;
+};
+
+template <class Table>
+static double measure( Table& table, const vector<string>& input, unsigned threads ) {
+  vector<unsigned long long> checksums( threads );
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  boost::thread_group group;
+  for ( unsigned t = 0; t < threads; ++t ) {
+    group.create_thread( boost::bind( &intern<Table>, boost::ref( table ), boost::cref( input ), input.size() * t / threads, input.size() * ( t + 1 ) / threads, boost::ref( checksums[t] ) ) );
+  }
+  group.join_all();
+  return elapsed( start );
+}
+
+static double median( vector<double>& times ) {
+  sort( times.begin(), times.end() );
+  return times[times.size() / 2];
+}
+
+int main( int argc, char *argv[] ) {
+
+  MAIN_BEGIN
+
+    MainInit( argc, argv, "-" );
+
+    if ( distinct > strings ) {
+      distinct = strings;
+    }
+    WriteMsg::write( CMSG_GENERATING_STRINGS, strings, distinct );
+    vector<string> input;
+    generate( input );
+
+    double concurrentBase = 0;
+    double lockedBase = 0;
+    for ( unsigned threads = 1; threads <= maxThreads; threads *= 2 ) {
+      vector<double> concurrentTimes, lockedTimes;
+      for ( unsigned run = 1; run <= runs; ++run ) {
+        {
+          ConcurrentStrTable table;
+          concurrentTimes.push_back( measure( table, input, threads ) );
+          if ( table.size() != distinct ) {
+            WriteMsg::write( CMSG_WRONG_SIZE, (unsigned)table.size(), distinct );
+            return 1;
+          }
+        }
+        {
+          LockedStrTable table;
+          lockedTimes.push_back( measure( table, input, threads ) );
+        }
+        WriteMsg::write( CMSG_RUN_TIME, threads, run, concurrentTimes.back(), lockedTimes.back() );
+      }
+
+      double concurrent = median( concurrentTimes );
+      double locked = median( lockedTimes );
+      if ( threads == 1 ) {
+        concurrentBase = concurrent;
+        lockedBase = locked;
+      }
+      WriteMsg::write( CMSG_SUMMARY, threads, concurrent, concurrentBase / concurrent, locked, lockedBase / locked );
+    }
+
+  MAIN_END
+
+  return 0;
+}
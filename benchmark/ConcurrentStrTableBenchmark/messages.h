@@ -0,0 +1,29 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _CONCURRENTSTRTABLEBENCHMARK_MESSAGES_H_
+#define _CONCURRENTSTRTABLEBENCHMARK_MESSAGES_H_
+
+#define CMSG_GENERATING_STRINGS           common::WriteMsg::mlNormal, "Interning %u strings (%u different ones)\n"
+#define CMSG_RUN_TIME                     common::WriteMsg::mlNormal, "%2u thread(s), run %u: ConcurrentStrTable %.3f s, locked StrTable %.3f s\n"
+#define CMSG_SUMMARY                      common::WriteMsg::mlNormal, "%2u thread(s): ConcurrentStrTable median %.3f s (speedup %.2f), locked StrTable median %.3f s (speedup %.2f)\n"
+#define CMSG_WRONG_SIZE                   common::WriteMsg::mlError,  "Error: the table contains %u strings instead of %u\n"
+
+#endif
@@ -0,0 +1,219 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+#define PROGRAM_NAME "DirectoryFilterBenchmark"
+#define EXECUTABLE_NAME "DirectoryFilterBenchmark"
+
+#include <MainCommon.h>
+
+#include "messages.h"
+#include <common/inc/DirectoryFilter.h>
+#include <threadpool/inc/Executor.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/regex.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+using namespace std;
+using namespace common;
+
+static unsigned paths = 200000;
+static unsigned maxThreads = 8;
+static unsigned runs = 3;
+
+// The benchmark generates its input, it has no input files.
+static void ppFile( char *filename ) {
+}
+
+static bool ppPaths( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  paths = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppMaxThreads( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  maxThreads = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppRuns( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  runs = value > 0 ? value : 1;
+  return true;
+}
+
+const Option OPTIONS_OBJ [] = {
+  { false,  "-paths",       1, "number",            0, OT_WC,    ppPaths,        NULL, "The number of the filtered paths. The default value is 200000."},
+  { false,  "-maxthreads",  1, "number",            0, OT_WC,    ppMaxThreads,   NULL, "The thread counts of areFilteredOut are measured from 1, doubled up to this value. The default value is 8."},
+  { false,  "-runs",        1, "number",            0, OT_WC,    ppRuns,         NULL, "The number of the measured runs. The default value is 3."},
+  COMMON_CL_ARGS
+};
+
+/**
+* The rules of a usual filter file: directories excluded by a literal, some of them anchored, a few real regular expressions
+* and inclusions overriding the earlier exclusions.
+*/
+static const char* rules[] = {
+  "-/test/",
+  "-/tests/",
+  "-^/home/user/project/build/",
+  "-/node_modules/",
+  "-/\\.git/",
+  "-\\.min\\.js$",
+  "-/gen(erated)?/",
+  "-\\<setup\\.py$",
+  "-(vendor|third_party)/",
+  "+/test/fixtures/keep/",
+  "-[0-9]+\\.tmp$",
+  "+^/home/user/project/module7/",
+};
+static const unsigned ruleCount = sizeof( rules ) / sizeof( rules[0] );
+
+static void generate( vector<string>& input ) {
+  const char* directories[] = { "src", "test", "tests", "gen", "generated", "vendor", "third_party", "node_modules", "lib", "test/fixtures/keep" };
+  const char* files[] = { ".py", ".min.js", ".js", ".tmp", "_setup.py" };
+  input.reserve( paths );
+  for ( unsigned i = 0; i < paths; ++i ) {
+    input.push_back( string( i % 97 == 0 ? "/home/user/project/build/" : "/home/user/project/" ) + "module" + to_string( i % 50 )
+      + "/" + directories[( i / 50 ) % 10] + "/package" + to_string( i % 13 ) + "/File" + to_string( i ) + files[( i / 7 ) % 5] );
+  }
+}
+
+static double elapsed( chrono::steady_clock::time_point start ) {
+  return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+}
+
+static double median( vector<double>& times ) {
+  sort( times.begin(), times.end() );
+  return times[times.size() / 2];
+}
+
+/**
+* Matches every rule as a compiled extended regular expression, this gives the expected results.
+*/
+static double matchRegex( const vector<string>& input, vector<bool>& result ) {
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  vector<boost::regex> expressions;
+  for ( unsigned i = 0; i < ruleCount; ++i ) {
+#ifdef _WIN32
+    expressions.push_back( boost::regex( rules[i] + 1, boost::regex::extended | boost::regex::icase ) );
+#else
+    expressions.push_back( boost::regex( rules[i] + 1, boost::regex::extended ) );
+#endif
+  }
+  result.assign( input.size(), false );
+  for ( size_t p = 0; p < input.size(); ++p ) {
+    for ( unsigned i = ruleCount; i-- > 0; ) {
+      if ( boost::regex_search( input[p], expressions[i] ) ) {
+        result[p] = rules[i][0] == '-';
+        break;
+      }
+    }
+  }
+  return elapsed( start );
+}
+
+static bool same( const vector<string>& input, const vector<bool>& expected, const vector<bool>& result ) {
+  for ( size_t i = 0; i < input.size(); ++i ) {
+    if ( result[i] != expected[i] ) {
+      WriteMsg::write( CMSG_WRONG_RESULT, input[i].c_str() );
+      return false;
+    }
+  }
+  return true;
+}
+
+int main( int argc, char *argv[] ) {
+
+  MAIN_BEGIN
+
+    MainInit( argc, argv, "-" );
+
+    WriteMsg::write( CMSG_GENERATING_PATHS, paths, ruleCount );
+    vector<string> input;
+    generate( input );
+
+    boost::filesystem::path filterFile = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path( "DirectoryFilterBenchmark-%%%%-%%%%.txt" );
+    {
+      ofstream out( filterFile.string().c_str() );
+      for ( unsigned i = 0; i < ruleCount; ++i ) {
+        out << rules[i] << "\n";
+      }
+    }
+
+    vector<bool> expected;
+    vector<double> regexTimes, sequentialTimes;
+    for ( unsigned run = 1; run <= runs; ++run ) {
+      regexTimes.push_back( matchRegex( input, expected ) );
+
+      // a new filter in every run, so its cache does not help
+      DirectoryFilter filter;
+      filter.openFilterFile( filterFile.string() );
+      vector<bool> result( input.size() );
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      for ( size_t i = 0; i < input.size(); ++i ) {
+        result[i] = filter.isFilteredOut( input[i] );
+      }
+      sequentialTimes.push_back( elapsed( start ) );
+      if ( !same( input, expected, result ) ) {
+        boost::filesystem::remove( filterFile );
+        return 1;
+      }
+      WriteMsg::write( CMSG_RUN_TIME, run, regexTimes.back(), sequentialTimes.back() );
+    }
+    WriteMsg::write( CMSG_FILTERED_COUNT, (unsigned)count( expected.begin(), expected.end(), true ) );
+    double regex = median( regexTimes );
+    double sequential = median( sequentialTimes );
+    WriteMsg::write( CMSG_SUMMARY, regex, sequential, regex / sequential );
+
+    double batchBase = 0;
+    for ( unsigned threads = 1; threads <= maxThreads; threads *= 2 ) {
+      columbus::thread::Executor executor( threads );
+      vector<double> batchTimes;
+      for ( unsigned run = 1; run <= runs; ++run ) {
+        // on one thread the paths are cached by the filter
+        DirectoryFilter filter;
+        filter.openFilterFile( filterFile.string() );
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        vector<bool> result = filter.areFilteredOut( input, executor );
+        batchTimes.push_back( elapsed( start ) );
+        if ( !same( input, expected, result ) ) {
+          boost::filesystem::remove( filterFile );
+          return 1;
+        }
+        WriteMsg::write( CMSG_BATCH_RUN_TIME, threads, run, batchTimes.back() );
+      }
+      double batch = median( batchTimes );
+      if ( threads == 1 ) {
+        batchBase = batch;
+      }
+      WriteMsg::write( CMSG_BATCH_SUMMARY, threads, batch, batchBase / batch );
+    }
+    boost::filesystem::remove( filterFile );
+
+  MAIN_END
+
+  return 0;
+}
@@ -0,0 +1,33 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+#ifndef _DIRECTORYFILTERBENCHMARK_MESSAGES_H_
+#define _DIRECTORYFILTERBENCHMARK_MESSAGES_H_
+
+#define CMSG_GENERATING_PATHS             common::WriteMsg::mlNormal, "Filtering %u paths with %u rules\n"
+#define CMSG_RUN_TIME                     common::WriteMsg::mlNormal, "run %u: regular expressions %.3f s, isFilteredOut %.3f s\n"
+#define CMSG_BATCH_RUN_TIME               common::WriteMsg::mlNormal, "%2u thread(s), run %u: areFilteredOut %.3f s\n"
+#define CMSG_SUMMARY                      common::WriteMsg::mlNormal, "regular expressions median %.3f s, isFilteredOut median %.3f s (speedup %.2f)\n"
+#define CMSG_BATCH_SUMMARY                common::WriteMsg::mlNormal, "%2u thread(s): areFilteredOut median %.3f s (speedup %.2f)\n"
+#define CMSG_FILTERED_COUNT               common::WriteMsg::mlNormal, "%u paths are filtered out\n"
+#define CMSG_WRONG_RESULT                 common::WriteMsg::mlError,  "Error: the result of the filter differs from the regular expressions for %s\n"
+
+#endif
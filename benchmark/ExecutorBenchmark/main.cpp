@@ -0,0 +1,224 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#define PROGRAM_NAME "ExecutorBenchmark"
+#define EXECUTABLE_NAME "ExecutorBenchmark"
+
+#include <MainCommon.h>
+
+#include "messages.h"
+#include <threadpool/inc/Executor.h>
+#include <threadpool/inc/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+using namespace std;
+using namespace common;
+using namespace columbus;
+
+static unsigned tasks = 5000;
+static unsigned work = 20000;
+static unsigned elements = 50000000;
+static unsigned threads = 4;
+static unsigned runs = 3;
+
+// The benchmark generates its input, it has no input files.
+static void ppFile( char *filename ) {
+}
+
+static bool ppTasks( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  tasks = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppWork( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  work = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppElements( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  elements = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppThreads( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  threads = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppRuns( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  runs = value > 0 ? value : 1;
+  return true;
+}
+
+const Option OPTIONS_OBJ [] = {
+  { false,  "-tasks",       1, "number",            0, OT_WC,    ppTasks,        NULL, "The number of the independent tasks. The default value is 5000."},
+  { false,  "-work",        1, "number",            0, OT_WC,    ppWork,         NULL, "The number of the work units of a task. The default value is 20000."},
+  { false,  "-elements",    1, "number",            0, OT_WC,    ppElements,     NULL, "The number of the elements summed by the fork/join reduction. The default value is 50000000."},
+  { false,  "-threads",     1, "number",            0, OT_WC,    ppThreads,      NULL, "The number of the threads of the ThreadPool and the Executor. The default value is 4."},
+  { false,  "-runs",        1, "number",            0, OT_WC,    ppRuns,         NULL, "The number of the measured runs. The default value is 3."},
+  COMMON_CL_ARGS
+};
+
+static double elapsed( chrono::steady_clock::time_point start ) {
+  return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+}
+
+// The work of one task, it depends on the index of the task so it can not be optimized away.
+static unsigned long long compute( unsigned task ) {
+  unsigned long long value = task;
+  for ( unsigned i = 0; i < work; ++i ) {
+    value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+  }
+  return value >> 32;
+}
+
+/**
+* A task of the ThreadPool adding its result to the common sum.
+*/
+class ComputeTask : public thread::Task {
+  public:
+    ComputeTask( unsigned task, atomic<unsigned long long>& sum ) : task( task ), sum( sum ) {}
+
+    virtual void operator()() {
+      sum += compute( task );
+    }
+
+  private:
+    unsigned task;
+    atomic<unsigned long long>& sum;
+};
+
+static unsigned long long runSequential() {
+  unsigned long long sum = 0;
+  for ( unsigned t = 0; t < tasks; ++t ) {
+    sum += compute( t );
+  }
+  return sum;
+}
+
+// The ThreadPool starts a thread for every added task, so the tasks are added in waves to stay below the thread limit of the system.
+static const unsigned THREADPOOL_WAVE = 1000;
+
+static unsigned long long runThreadPool() {
+  atomic<unsigned long long> sum( 0 );
+  for ( unsigned wave = 0; wave < tasks; wave += THREADPOOL_WAVE ) {
+    thread::ThreadPool pool( threads );
+    for ( unsigned t = wave; t < tasks && t < wave + THREADPOOL_WAVE; ++t ) {
+      pool.add( thread::ThreadPool::PtrTask( new ComputeTask( t, sum ) ) );
+    }
+    pool.wait();
+  }
+  return sum;
+}
+
+static unsigned long long runExecutor( thread::Executor& executor ) {
+  vector<future<unsigned long long> > results;
+  results.reserve( tasks );
+  for ( unsigned t = 0; t < tasks; ++t ) {
+    results.push_back( executor.submit( [t]() { return compute( t ); } ) );
+  }
+  unsigned long long sum = 0;
+  for ( vector<future<unsigned long long> >::iterator it = results.begin(); it != results.end(); ++it ) {
+    sum += it->get();
+  }
+  return sum;
+}
+
+static unsigned long long element( unsigned i ) {
+  return ( i * 2654435761u ) >> 7;
+}
+
+static unsigned long long sumSequential() {
+  unsigned long long sum = 0;
+  for ( unsigned i = 0; i < elements; ++i ) {
+    sum += element( i );
+  }
+  return sum;
+}
+
+static unsigned long long sumExecutor( thread::Executor& executor ) {
+  return thread::parallel_reduce( executor, 0u, elements, 0u, 0ULL, []( unsigned i ) { return element( i ); },
+    []( unsigned long long lhs, unsigned long long rhs ) { return lhs + rhs; } );
+}
+
+static void summary( const char* phase, vector<double>& times ) {
+  sort( times.begin(), times.end() );
+  WriteMsg::write( CMSG_SUMMARY, phase, times.front(), times[times.size() / 2], runs );
+}
+
+template <typename Func>
+static double measure( const Func& func, unsigned long long expected, const char* name, bool& ok ) {
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  unsigned long long result = func();
+  double time = elapsed( start );
+  if ( result != expected ) {
+    WriteMsg::write( CMSG_WRONG_RESULT, name );
+    ok = false;
+  }
+  return time;
+}
+
+int main( int argc, char *argv[] ) {
+
+  MAIN_BEGIN
+
+    MainInit( argc, argv, "-" );
+
+    WriteMsg::write( CMSG_PARAMETERS, tasks, work, elements, threads );
+    thread::Executor executor( threads );
+
+    bool ok = true;
+    vector<double> sequentialTimes, threadPoolTimes, executorTimes, sumSequentialTimes, sumExecutorTimes;
+    for ( unsigned run = 1; run <= runs && ok; ++run ) {
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      unsigned long long expected = runSequential();
+      sequentialTimes.push_back( elapsed( start ) );
+      threadPoolTimes.push_back( measure( runThreadPool, expected, "ThreadPool", ok ) );
+      executorTimes.push_back( measure( [&executor]() { return runExecutor( executor ); }, expected, "Executor", ok ) );
+
+      start = chrono::steady_clock::now();
+      expected = sumSequential();
+      sumSequentialTimes.push_back( elapsed( start ) );
+      sumExecutorTimes.push_back( measure( [&executor]() { return sumExecutor( executor ); }, expected, "parallel_reduce", ok ) );
+
+      WriteMsg::write( CMSG_RUN_TIME, run, sequentialTimes.back(), threadPoolTimes.back(), executorTimes.back(), sumSequentialTimes.back(), sumExecutorTimes.back() );
+    }
+    if ( !ok ) {
+      return 1;
+    }
+
+    summary( "tasks sequential", sequentialTimes );
+    summary( "tasks ThreadPool", threadPoolTimes );
+    summary( "tasks Executor", executorTimes );
+    summary( "fork/join sequential", sumSequentialTimes );
+    summary( "fork/join parallel_reduce", sumExecutorTimes );
+
+  MAIN_END
+
+  return 0;
+}
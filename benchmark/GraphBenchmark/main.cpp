@@ -0,0 +1,206 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#define PROGRAM_NAME "GraphBenchmark"
+#define EXECUTABLE_NAME "GraphBenchmark"
+
+#include <MainCommon.h>
+
+#include "messages.h"
+#include <graph/inc/graph.h>
+#include <common/inc/Stat.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+using namespace common;
+using namespace columbus;
+using namespace columbus::graph;
+
+static string graphFile;
+static unsigned nodes = 400000;
+static unsigned attributes = 5;
+static unsigned runs = 3;
+static bool measureList = true;
+static bool measureCompact = true;
+
+static void ppFile( char *filename ) {
+  graphFile = filename;
+}
+
+static bool ppNodes( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  nodes = value > 1 ? value : 2;
+  return true;
+}
+
+static bool ppAttributes( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  attributes = value > 0 ? value : 0;
+  return true;
+}
+
+static bool ppRuns( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  runs = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppBackend( const Option *o, char *argv[] ) {
+  string backend = argv[0];
+  if ( backend != "list" && backend != "compact" && backend != "both" ) {
+    return false;
+  }
+  measureList = backend != "compact";
+  measureCompact = backend != "list";
+  return true;
+}
+
+const Option OPTIONS_OBJ [] = {
+  { false,  "-nodes",       1, "number",            0, OT_WC,    ppNodes,        NULL, "The number of the nodes of the generated graph, if no graph file is given. The default value is 400000."},
+  { false,  "-attributes",  1, "number",            0, OT_WC,    ppAttributes,   NULL, "The number of the integer attributes per node of the generated graph. The default value is 5."},
+  { false,  "-runs",        1, "number",            0, OT_WC,    ppRuns,         NULL, "The number of the measured runs. The default value is 3."},
+  { false,  "-backend",     1, "list|compact|both", 0, OT_WC,    ppBackend,      NULL, "The storage of the loaded graph: the list based (modifiable) graph, the read-only compact graph (loadBinary(filename, true)) or both of them. The default value is both."},
+  COMMON_CL_ARGS
+};
+
+static double elapsed( chrono::steady_clock::time_point start ) {
+  return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+}
+
+/**
+* Generates a tree shaped graph (like the containment tree of a result graph) where every edge has a reverse pair,
+* and every node has the given number of integer metrics.
+*/
+static void generate( const string& filename ) {
+  Graph graph;
+  for ( unsigned i = 0; i < nodes; ++i ) {
+    Node node = graph.createNode( "N" + to_string( i ), Node::NodeType( "Class" ) );
+    for ( unsigned a = 0; a < attributes; ++a ) {
+      node.addAttribute( graph.createAttributeInt( "M" + to_string( a ), "metric", i + a ) );
+    }
+  }
+  for ( unsigned i = 1; i < nodes; ++i ) {
+    graph.createDirectedEdge( "N" + to_string( i / 2 ), "N" + to_string( i ), "contains", true );
+  }
+  graph.saveBinary( filename );
+}
+
+/**
+* Visits every node, its attributes and its out edges with their pairs, like the exporters do.
+*/
+static unsigned long long traverse( Graph& graph, vector<string>* uids ) {
+  unsigned long long checksum = 0;
+  Node::NodeIterator nodeIt = graph.getNodes();
+  while ( nodeIt.hasNext() ) {
+    Node node = nodeIt.next();
+    if ( uids ) {
+      uids->push_back( node.getUID() );
+    }
+    Attribute::AttributeIterator attributeIt = node.getAttributes();
+    while ( attributeIt.hasNext() ) {
+      Attribute& attribute = attributeIt.next();
+      if ( attribute.getType() == Attribute::atInt ) {
+        checksum += dynamic_cast<AttributeInt&>( attribute ).getValue();
+      }
+    }
+    Edge::EdgeIterator edgeIt = node.getOutEdges();
+    while ( edgeIt.hasNext() ) {
+      Edge edge = edgeIt.next();
+      checksum += edge.getReversePair() != Graph::invalidEdge;
+    }
+  }
+  return checksum;
+}
+
+static void summary( const char* phase, vector<double>& times ) {
+  sort( times.begin(), times.end() );
+  WriteMsg::write( CMSG_SUMMARY, phase, times.front(), times[times.size() / 2], runs );
+}
+
+int main( int argc, char *argv[] ) {
+
+  MAIN_BEGIN
+
+    MainInit( argc, argv, "-" );
+
+    boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path( "GraphBenchmark-%%%%-%%%%" );
+    boost::filesystem::create_directories( directory );
+
+    if ( graphFile.empty() ) {
+      WriteMsg::write( CMSG_GENERATING_GRAPH, nodes, attributes );
+      graphFile = ( directory / "generated.graph" ).string();
+      generate( graphFile );
+    }
+    WriteMsg::write( CMSG_LOADING_GRAPH, graphFile.c_str() );
+    const string savedFile = ( directory / "saved.graph" ).string();
+
+    for ( int compact = 0; compact < 2; ++compact ) {
+      if ( compact ? !measureCompact : !measureList ) {
+        continue;
+      }
+      const char* backend = compact ? "compact" : "list";
+      WriteMsg::write( CMSG_BACKEND, backend );
+
+      vector<double> loadTimes, traverseTimes, findTimes, saveTimes;
+      for ( unsigned run = 1; run <= runs; ++run ) {
+        Graph graph;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        graph.loadBinary( graphFile, compact != 0 );
+        loadTimes.push_back( elapsed( start ) );
+        double resident = getProcessUsedMemSize().resident / ( 1024.0 * 1024.0 );
+
+        // the exporters go through the graph more than once
+        vector<string> uids;
+        start = chrono::steady_clock::now();
+        unsigned long long checksum = traverse( graph, &uids );
+        checksum += traverse( graph, NULL );
+        checksum += traverse( graph, NULL );
+        traverseTimes.push_back( elapsed( start ) );
+
+        start = chrono::steady_clock::now();
+        for ( vector<string>::const_iterator it = uids.begin(); it != uids.end(); ++it ) {
+          checksum += graph.findNode( *it ) != Graph::invalidNode;
+        }
+        findTimes.push_back( elapsed( start ) );
+
+        start = chrono::steady_clock::now();
+        graph.saveBinary( savedFile );
+        saveTimes.push_back( elapsed( start ) );
+
+        WriteMsg::write( CMSG_RUN_TIME, run, loadTimes.back(), traverseTimes.back(), findTimes.back(), saveTimes.back(), resident );
+        WriteMsg::write( CMSG_CHECKSUM, checksum );
+      }
+
+      summary( "load", loadTimes );
+      summary( "traverse", traverseTimes );
+      summary( "findNode", findTimes );
+      summary( "save", saveTimes );
+    }
+
+    boost::filesystem::remove_all( directory );
+
+  MAIN_END
+
+  return 0;
+}
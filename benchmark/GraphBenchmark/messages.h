@@ -0,0 +1,31 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _GRAPHBENCHMARK_MESSAGES_H_
+#define _GRAPHBENCHMARK_MESSAGES_H_
+
+#define CMSG_GENERATING_GRAPH             common::WriteMsg::mlNormal, "Generating a graph with %u nodes and %u attributes per node\n"
+#define CMSG_LOADING_GRAPH                common::WriteMsg::mlNormal, "Measuring %s\n"
+#define CMSG_BACKEND                      common::WriteMsg::mlNormal, "Backend: %s\n"
+#define CMSG_RUN_TIME                     common::WriteMsg::mlNormal, "Run %u: load %.3f s, traverse %.3f s, findNode %.3f s, save %.3f s, resident memory %.1f MB\n"
+#define CMSG_SUMMARY                      common::WriteMsg::mlNormal, "%-8s min %.3f s, median %.3f s of %u runs\n"
+#define CMSG_CHECKSUM                     common::WriteMsg::mlDebug,  "Debug: checksum %llu\n"
+
+#endif
@@ -0,0 +1,251 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#define PROGRAM_NAME "GraphRangeIndexerBenchmark"
+#define EXECUTABLE_NAME "GraphRangeIndexerBenchmark"
+
+#include <MainCommon.h>
+
+#include "messages.h"
+#include <graph/inc/graph.h>
+#include <graphsupport/inc/GraphRangeIndexer.h>
+#include <graphsupport/inc/Metric.h>
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <random>
+
+using namespace std;
+using namespace common;
+using namespace columbus;
+using namespace columbus::graph;
+using namespace columbus::graphsupport;
+
+typedef GraphRangeIndexer::RangeQuery Warning;
+
+static string graphFile;
+static string reportFile;
+static unsigned files = 2000;
+static unsigned nodesPerFile = 100;
+static unsigned warnings = 500000;
+static unsigned runs = 3;
+
+static void ppFile( char *filename ) {
+  graphFile = filename;
+}
+
+static bool ppReport( const Option *o, char *argv[] ) {
+  reportFile = argv[0];
+  return true;
+}
+
+static bool ppFiles( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  files = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppNodesPerFile( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  nodesPerFile = value > 1 ? value : 2;
+  return true;
+}
+
+static bool ppWarnings( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  warnings = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppRuns( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  runs = value > 0 ? value : 1;
+  return true;
+}
+
+const Option OPTIONS_OBJ [] = {
+  { false,  "-report",        1, "filename",          0, OT_WC,    ppReport,       NULL, "The PMD report (xml) replayed on the graph. If it is not given, the warnings are generated from the positions of the nodes."},
+  { false,  "-files",         1, "number",            0, OT_WC,    ppFiles,        NULL, "The number of the source files of the generated graph, if no graph file is given. The default value is 2000."},
+  { false,  "-nodesperfile",  1, "number",            0, OT_WC,    ppNodesPerFile, NULL, "The number of the nodes per source file of the generated graph. The default value is 100."},
+  { false,  "-warnings",      1, "number",            0, OT_WC,    ppWarnings,     NULL, "The number of the generated warnings, if no report is given. The default value is 500000."},
+  { false,  "-runs",          1, "number",            0, OT_WC,    ppRuns,         NULL, "The number of the measured runs. The default value is 3."},
+  COMMON_CL_ARGS
+};
+
+static double elapsed( chrono::steady_clock::time_point start ) {
+  return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+}
+
+static string getPath( unsigned file ) {
+  return "/home/user/project/src/package" + to_string( file % 50 ) + "/File" + to_string( file ) + ".java";
+}
+
+/**
+* Generates a graph like the one converted from the LIM: every file has a class spanning the whole file
+* and its methods following each other.
+*/
+static void generate( Graph& graph ) {
+  for ( unsigned f = 0; f < files; ++f ) {
+    const string path = getPath( f );
+    const string uid = "F" + to_string( f );
+    const int methodLines = 12;
+    Node cls = graph.createNode( uid, Node::NodeType( "Class" ) );
+    addPositionAttribute( graph, cls, path, 1, 1, nodesPerFile * methodLines + 2, 2 );
+    for ( unsigned m = 1; m < nodesPerFile; ++m ) {
+      Node method = graph.createNode( uid + "M" + to_string( m ), Node::NodeType( "Method" ) );
+      addPositionAttribute( graph, method, path, m * methodLines, 3, m * methodLines + methodLines - 2, 4 );
+    }
+  }
+}
+
+static string getAttribute( const string& line, const string& name ) {
+  size_t begin = line.find( " " + name + "=\"" );
+  if ( begin == string::npos ) {
+    return "";
+  }
+  begin += name.size() + 3;
+  return line.substr( begin, line.find( '"', begin ) - begin );
+}
+
+/**
+* Reads the violations of a PMD report in their order, it expects the attributes of an element in one line.
+*/
+static void readReport( vector<Warning>& result ) {
+  ifstream report( reportFile.c_str() );
+  string line, path;
+  while ( getline( report, line ) ) {
+    if ( line.find( "<file " ) != string::npos ) {
+      path = getAttribute( line, "name" );
+    } else if ( line.find( "<violation " ) != string::npos ) {
+      result.push_back( Warning( path, atoi( getAttribute( line, "beginline" ).c_str() ), atoi( getAttribute( line, "begincolumn" ).c_str() ),
+        atoi( getAttribute( line, "endline" ).c_str() ), atoi( getAttribute( line, "endcolumn" ).c_str() ) ) );
+    }
+  }
+}
+
+/**
+* Generates warnings at the lines of random nodes, grouped by file and ordered by line like in a PMD report.
+*/
+static void generateWarnings( Graph& graph, vector<Warning>& result ) {
+  vector<Warning> positions;
+  Node::NodeIterator nodeIt = graph.getNodes();
+  while ( nodeIt.hasNext() ) {
+    Warning position;
+    if ( getPositionAttribute( nodeIt.next(), position.path, position.line, position.col, position.endLine, position.endCol ) ) {
+      positions.push_back( position );
+    }
+  }
+  if ( positions.empty() ) {
+    return;
+  }
+
+  mt19937 random( 42 );
+  uniform_int_distribution<size_t> node( 0, positions.size() - 1 );
+  for ( unsigned i = 0; i < warnings; ++i ) {
+    const Warning& position = positions[node( random )];
+    int line = position.line + (int)( random() % ( position.endLine - position.line + 1 ) );
+    result.push_back( Warning( position.path, line, 1, min( line + (int)( random() % 3 ), position.endLine ), 80 ) );
+  }
+  stable_sort( result.begin(), result.end(), []( const Warning& lhs, const Warning& rhs ) {
+    return lhs.path != rhs.path ? lhs.path < rhs.path : lhs.line < rhs.line;
+  } );
+}
+
+static void summary( const char* phase, vector<double>& times ) {
+  sort( times.begin(), times.end() );
+  WriteMsg::write( CMSG_SUMMARY, phase, times.front(), times[times.size() / 2], runs );
+}
+
+int main( int argc, char *argv[] ) {
+
+  MAIN_BEGIN
+
+    MainInit( argc, argv, "-" );
+
+    Graph graph;
+    if ( graphFile.empty() ) {
+      WriteMsg::write( CMSG_GENERATING_GRAPH, files, nodesPerFile );
+      generate( graph );
+    } else {
+      WriteMsg::write( CMSG_LOADING_GRAPH, graphFile.c_str() );
+      graph.loadBinary( graphFile );
+    }
+
+    vector<Warning> queries;
+    if ( reportFile.empty() ) {
+      WriteMsg::write( CMSG_GENERATING_WARNINGS, warnings );
+      generateWarnings( graph, queries );
+    } else {
+      WriteMsg::write( CMSG_READING_REPORT, reportFile.c_str() );
+      readReport( queries );
+    }
+    WriteMsg::write( CMSG_WARNINGS, (unsigned)queries.size() );
+
+    GraphRangeIndexer& indexer = GraphRangeIndexer::getGraphRangeIndexerInstance();
+    vector<double> turnOnTimes, queryTimes, batchTimes;
+    for ( unsigned run = 1; run <= runs; ++run ) {
+      indexer.turnOff( graph );
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      indexer.turnOn( graph );
+      turnOnTimes.push_back( elapsed( start ) );
+
+      // the query of the converters (e.g. PMD2Graph): every node overlapping the lines of the warning
+      unsigned long long checksum = 0;
+      vector<size_t> counts;
+      counts.reserve( queries.size() );
+      start = chrono::steady_clock::now();
+      for ( vector<Warning>::const_iterator it = queries.begin(); it != queries.end(); ++it ) {
+        list<Node> nodes;
+        indexer.findNodesByRange( graph, it->path, it->line, INT_MIN, it->endLine, INT_MAX, nodes );
+        counts.push_back( nodes.size() );
+        checksum += nodes.size();
+      }
+      queryTimes.push_back( elapsed( start ) );
+
+      vector<Warning> batch( queries );
+      for ( vector<Warning>::iterator it = batch.begin(); it != batch.end(); ++it ) {
+        it->col = INT_MIN;
+        it->endCol = INT_MAX;
+      }
+      vector< list<Node> > found;
+      start = chrono::steady_clock::now();
+      indexer.findNodesByRanges( graph, batch, found );
+      batchTimes.push_back( elapsed( start ) );
+      for ( size_t i = 0; i < queries.size(); ++i ) {
+        if ( found[i].size() != counts[i] ) {
+          WriteMsg::write( CMSG_DIFFERENT_RESULT, queries[i].path.c_str(), queries[i].line );
+          return 1;
+        }
+      }
+
+      WriteMsg::write( CMSG_RUN_TIME, run, turnOnTimes.back(), queryTimes.back(), batchTimes.back() );
+      WriteMsg::write( CMSG_CHECKSUM, checksum );
+    }
+
+    summary( "turnOn", turnOnTimes );
+    summary( "findNodesByRange", queryTimes );
+    summary( "findNodesByRanges", batchTimes );
+
+  MAIN_END
+
+  return 0;
+}
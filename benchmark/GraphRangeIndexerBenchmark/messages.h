@@ -0,0 +1,35 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+#ifndef _GRAPHRANGEINDEXERBENCHMARK_MESSAGES_H_
+#define _GRAPHRANGEINDEXERBENCHMARK_MESSAGES_H_
+
+#define CMSG_GENERATING_GRAPH             common::WriteMsg::mlNormal, "Generating a graph of %u files with %u nodes per file\n"
+#define CMSG_LOADING_GRAPH                common::WriteMsg::mlNormal, "Loading %s\n"
+#define CMSG_GENERATING_WARNINGS          common::WriteMsg::mlNormal, "Generating %u warnings\n"
+#define CMSG_READING_REPORT               common::WriteMsg::mlNormal, "Reading the PMD report %s\n"
+#define CMSG_WARNINGS                     common::WriteMsg::mlNormal, "Replaying %u warnings\n"
+#define CMSG_RUN_TIME                     common::WriteMsg::mlNormal, "Run %u: turnOn %.3f s, findNodesByRange %.3f s, findNodesByRanges %.3f s\n"
+#define CMSG_SUMMARY                      common::WriteMsg::mlNormal, "%-17s min %.3f s, median %.3f s of %u runs\n"
+#define CMSG_DIFFERENT_RESULT             common::WriteMsg::mlError,  "Error: findNodesByRanges gives different nodes for the warning at %s:%d\n"
+#define CMSG_CHECKSUM                     common::WriteMsg::mlDebug,  "Debug: %llu nodes found\n"
+
+#endif
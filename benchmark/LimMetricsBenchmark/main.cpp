@@ -0,0 +1,366 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#define PROGRAM_NAME "LimMetricsBenchmark"
+#define EXECUTABLE_NAME "LimMetricsBenchmark"
+
+#include <MainCommon.h>
+
+#include "messages.h"
+#include <lim/inc/lim.h>
+#include <lim2graph/inc/Lim2GraphConverter.h>
+#include <limmetrics/inc/LimMetrics.h>
+#include <rul/inc/RulHandler.h>
+#include <csi/inc/PropertyData.h>
+#include <common/inc/FileSup.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace std;
+using namespace common;
+using namespace columbus;
+using namespace columbus::lim::asg;
+
+static string limFile;
+static string saveFile;
+static string rulFile = "MET.rul";
+static string rulConfig;
+static unsigned packages = 0;
+static unsigned classes = 0;
+static bool cpp = false;
+static unsigned seed = 1;
+static unsigned threads = 1;
+static unsigned runs = 3;
+
+static void ppFile( char *filename ) {
+  limFile = filename;
+}
+
+static bool ppGenerate( const Option *o, char *argv[] ) {
+  packages = atoi( argv[0] );
+  classes = atoi( argv[1] );
+  return true;
+}
+
+static bool ppCpp( const Option *o, char *argv[] ) {
+  cpp = true;
+  return true;
+}
+
+static bool ppSeed( const Option *o, char *argv[] ) {
+  seed = atoi( argv[0] );
+  return true;
+}
+
+static bool ppSave( const Option *o, char *argv[] ) {
+  saveFile = argv[0];
+  return true;
+}
+
+static bool ppRul( const Option *o, char *argv[] ) {
+  rulFile = argv[0];
+  return true;
+}
+
+static bool ppRulConfig( const Option *o, char *argv[] ) {
+  rulConfig = argv[0];
+  return true;
+}
+
+static bool ppThreads( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  threads = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppRuns( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  runs = value > 0 ? value : 1;
+  return true;
+}
+
+const Option OPTIONS_OBJ [] = {
+  { false,  "-generate",    2, "packages classes",  0, OT_WS,    ppGenerate,     NULL, "Generates a random LIM with the given number of top level packages and classes per package instead of loading a .lim file."},
+  { false,  "-cpp",         0, "",                  0, OT_NONE,  ppCpp,          NULL, "The generated LIM is a C++ one (Java by default)."},
+  { false,  "-seed",        1, "number",            0, OT_WC,    ppSeed,         NULL, "The seed of the generated LIM. The default value is 1."},
+  { false,  "-save",        1, "filename",          0, OT_WC,    ppSave,         NULL, "Saves the generated LIM, so LIM2Metrics can be measured on it as well."},
+  { false,  "-threads",     1, "number",            0, OT_WC,    ppThreads,      NULL, "The number of threads of the LimMetricsVisitor. The default value is 1."},
+  { false,  "-runs",        1, "number",            0, OT_WC,    ppRuns,         NULL, "The number of the measured runs. The default value is 3."},
+  CL_RUL_AND_RULCONFIG("MET.rul")
+  COMMON_CL_ARGS
+};
+
+/**
+* Builds a random LIM which has the shape of a real one: packages with classes, nested and local classes,
+* inheritance, methods with calls, attribute accesses and type uses, components and files.
+*/
+class LimGenerator {
+
+  public:
+
+    LimGenerator( Factory& factory, bool cpp, unsigned seed ) : factory( factory ), language( cpp ? lnkCpp : lnkJava ), cpp( cpp ), random( seed ) {}
+
+    void build( unsigned packages, unsigned classesPerPackage ) {
+      base::Component& root = factory.getComponentRootRef();
+      for ( int i = 0; i < 3; ++i ) {
+        base::Component& component = factory.createComponent( "component" + to_string( i ) );
+        root.addContains( &component );
+        components.push_back( &component );
+      }
+      components[0]->addContains( components[2] );
+
+      for ( int i = 0; i < 20; ++i ) {
+        physical::File& file = factory.createFile( "src/dir" + to_string( i % 4 ) + "/file" + to_string( i ) + ( cpp ? ".cpp" : ".java" ) );
+        file.setLOC( 100 + rnd( 100 ) );
+        file.setLLOC( 50 + rnd( 50 ) );
+        file.setCLOC( rnd( 30 ) );
+        file.setNumberOfBranches( rnd( 20 ) );
+        components[rnd( 3 )]->addFiles( &file );
+        files.push_back( file.getId() );
+      }
+
+      for ( unsigned i = 0; i < packages; ++i ) {
+        package( *factory.getRoot(), "package" + to_string( i ), 0, classesPerPackage );
+      }
+
+      for ( size_t i = 0; i < methods.size(); ++i ) {
+        logical::Method& method = dynamic_cast<logical::Method&>( factory.getRef( methods[i] ) );
+        for ( unsigned c = rnd( 5 ); c; --c ) {
+          method.addCalls( &factory.createMethodCall( methods[rnd( methods.size() )] ) );
+        }
+        for ( unsigned a = attributes.empty() ? 0 : rnd( 4 ); a; --a ) {
+          method.addAccessesAttribute( &factory.createAttributeAccess( attributes[rnd( attributes.size() )] ) );
+        }
+        if ( rnd( 3 ) == 0 ) {
+          method.addUses( classType() );
+        }
+      }
+    }
+
+    unsigned getClassCount() const { return (unsigned) classes.size(); }
+    unsigned getMethodCount() const { return (unsigned) methods.size(); }
+
+  private:
+
+    unsigned rnd( size_t n ) {
+      return (unsigned) ( random() % n );
+    }
+
+    NodeId classType() {
+      factory.beginType();
+      factory.addTypeFormer( factory.createTypeFormerType( classes[rnd( classes.size() )] ).getId() );
+      return factory.endType().getId();
+    }
+
+    void member( logical::Member& node, const string& name ) {
+      dynamic_cast<base::Named&>( node ).setName( name );
+      node.setLanguage( language );
+      node.setAccessibility( (AccessibilityKind) rnd( ackLAST ) );
+      node.setIsStatic( rnd( 4 ) == 0 );
+      node.setCommentLines( rnd( 3 ) ? 0 : rnd( 20 ) );
+      if ( rnd( 2 ) ) {
+        node.addComment( &factory.createComment( "/** comment */" ) );
+      }
+
+      SourcePosition position;
+      position.setRealizationLevel( rnd( 5 ) ? relDefines : relDeclares );
+      position.setLine( 1 + rnd( 100 ) );
+      position.setColumn( 1 );
+      position.setEndLine( 100 + rnd( 100 ) );
+      position.setEndColumn( 2 );
+      node.addIsContainedIn( files[rnd( files.size() )], position );
+      node.addBelongsTo( components[rnd( components.size() )] );
+    }
+
+    void scope( logical::Scope& node ) {
+      unsigned loc = 1 + rnd( 200 );
+      node.setLOC( loc );
+      node.setLLOC( loc / 2 );
+      node.setTLOC( loc + rnd( 50 ) );
+      node.setTLLOC( loc / 2 + rnd( 20 ) );
+    }
+
+    logical::Method& method( logical::Scope& parent, const string& name ) {
+      logical::Method& node = *factory.createMethodNode();
+      member( node, name );
+      scope( node );
+      const MethodKind kinds[] = { mekNormal, mekNormal, mekGet, mekSet, mekConstructor };
+      node.setMethodKind( kinds[rnd( 5 )] );
+      node.setNumberOfBranches( rnd( 12 ) );
+      node.setNumberOfStatements( rnd( 40 ) );
+      node.setNestingLevel( rnd( 5 ) );
+      node.setNestingLevelElseIf( rnd( 5 ) );
+      node.setDistinctOperands( rnd( 30 ) );
+      node.setDistinctOperators( rnd( 20 ) );
+      node.setTotalOperands( rnd( 100 ) );
+      node.setTotalOperators( rnd( 90 ) );
+      node.setIsAbstract( rnd( 8 ) == 0 );
+      node.setIsVirtual( rnd( 3 ) == 0 );
+      for ( unsigned i = rnd( 4 ); i; --i ) {
+        logical::Parameter* parameter = factory.createParameterNode();
+        parameter->setName( "p" + to_string( i ) );
+        node.addParameter( parameter );
+      }
+      parent.addMember( &node );
+      methods.push_back( node.getId() );
+      return node;
+    }
+
+    void attribute( logical::Scope& parent, const string& name ) {
+      logical::Attribute& node = *factory.createAttributeNode();
+      member( node, name );
+      parent.addMember( &node );
+      attributes.push_back( node.getId() );
+    }
+
+    void clazz( logical::Scope& parent, const string& name, int depth ) {
+      logical::Class& node = *factory.createClassNode();
+      member( node, name );
+      scope( node );
+      const ClassKind cppKinds[] = { clkClass, clkClass, clkStruct, clkUnion, clkInterface, clkEnum };
+      const ClassKind javaKinds[] = { clkClass, clkClass, clkClass, clkInterface, clkEnum, clkAnnotation };
+      node.setClassKind( cpp ? cppKinds[rnd( 6 )] : javaKinds[rnd( 6 )] );
+      node.setIsAbstract( rnd( 5 ) == 0 );
+      parent.addMember( &node );
+      if ( ! classes.empty() && rnd( 3 ) ) {
+        node.addIsSubclass( classType() );
+      }
+      classes.push_back( node.getId() );
+
+      for ( unsigned i = rnd( 5 ); i; --i ) {
+        attribute( node, name + "_a" + to_string( i ) );
+      }
+      for ( unsigned i = 1 + rnd( 6 ); i; --i ) {
+        logical::Method& m = method( node, name + "_m" + to_string( i ) );
+        if ( depth < 2 && rnd( 10 ) == 0 ) {
+          clazz( m, name + "_local" + to_string( i ), depth + 1 );
+        }
+      }
+      if ( depth < 2 && rnd( 5 ) == 0 ) {
+        clazz( node, name + "_inner", depth + 1 );
+      }
+    }
+
+    void package( logical::Package& parent, const string& name, int depth, unsigned classesPerPackage ) {
+      logical::Package& node = *factory.createPackageNode();
+      node.setName( name );
+      node.setLanguage( language );
+      node.setAccessibility( ackPublic );
+      scope( node );
+      parent.addMember( &node );
+
+      for ( unsigned i = 0; i < classesPerPackage; ++i ) {
+        clazz( node, name + "_C" + to_string( i ), 0 );
+      }
+      if ( cpp ) {
+        for ( unsigned i = rnd( 4 ); i; --i ) {
+          method( node, name + "_f" + to_string( i ) );
+        }
+        for ( unsigned i = rnd( 3 ); i; --i ) {
+          attribute( node, name + "_g" + to_string( i ) );
+        }
+      }
+      if ( depth < 2 ) {
+        for ( unsigned i = rnd( 3 ); i; --i ) {
+          package( node, name + "_sub" + to_string( i ), depth + 1, classesPerPackage / 2 + 1 );
+        }
+      }
+    }
+
+    Factory& factory;
+    LanguageKind language;
+    bool cpp;
+    mt19937 random;
+    vector<NodeId> classes;
+    vector<NodeId> methods;
+    vector<NodeId> attributes;
+    vector<NodeId> files;
+    vector<base::Component*> components;
+};
+
+int main( int argc, char *argv[] ) {
+
+  MAIN_BEGIN
+
+    MainInit( argc, argv, "-" );
+
+    if ( limFile.empty() && packages == 0 ) {
+      WriteMsg::write( CMSG_NO_INPUT );
+      clError();
+    }
+
+    RefDistributorStrTable strTable;
+    Factory factory( strTable, "", cpp ? limLangCpp : limLangJava );
+    OverrideRelations overrides( factory );
+    PropertyData properties;
+    list<HeaderData*> header;
+    header.push_back( &properties );
+    header.push_back( &overrides );
+
+    if ( ! limFile.empty() ) {
+      WriteMsg::write( CMSG_LOADING_LIM, limFile.c_str() );
+      factory.load( limFile, header );
+    } else {
+      LimGenerator generator( factory, cpp, seed );
+      generator.build( packages, classes );
+      WriteMsg::write( CMSG_GENERATED_LIM, (unsigned) factory.size(), generator.getClassCount(), generator.getMethodCount() );
+      if ( ! saveFile.empty() ) {
+        WriteMsg::write( CMSG_SAVING_LIM, saveFile.c_str() );
+        factory.save( saveFile, header );
+      }
+    }
+    factory.initializeFilter();
+
+    if ( rulConfig.empty() ) {
+      rulConfig = factory.getLanguage() == limLangCpp ? "cpp" : "java";
+    }
+    rul::RulHandler rul( common::indep_fullpath( rulFile ), rulConfig, "eng" );
+
+    // only the visitor is measured, every run gets a new graph and new containers
+    vector<double> times;
+    for ( unsigned run = 1; run <= runs; ++run ) {
+      graph::Graph graph;
+      lim2graph::convertBaseGraph( factory, graph, true, true, true, true, false );
+
+      lim::metrics::SharedContainers shared;
+      lim::metrics::InheritanceHelper inheritance( factory.getReverseEdges() );
+      shared.overrides = &overrides;
+      shared.factory = &factory;
+      shared.inheritance = &inheritance;
+      shared.LCOMMap = NULL;
+
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      lim::metrics::LimMetricsVisitor visitor( factory, graph, rul, shared, threads );
+      visitor.run();
+      double time = chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+
+      WriteMsg::write( CMSG_RUN_TIME, run, time );
+      times.push_back( time );
+    }
+
+    sort( times.begin(), times.end() );
+    WriteMsg::write( CMSG_SUMMARY, threads, times.front(), times[times.size() / 2], runs );
+
+  MAIN_END
+
+  return 0;
+}
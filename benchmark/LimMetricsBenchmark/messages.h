@@ -0,0 +1,31 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _LIMMETRICSBENCHMARK_MESSAGES_H_
+#define _LIMMETRICSBENCHMARK_MESSAGES_H_
+
+#define CMSG_NO_INPUT                     common::WriteMsg::mlError,  "Error: Either a .lim file or the -generate option has to be given\n"
+#define CMSG_LOADING_LIM                  common::WriteMsg::mlNormal, "Loading %s\n"
+#define CMSG_GENERATED_LIM                common::WriteMsg::mlNormal, "Generated a LIM with %u nodes (%u classes, %u methods)\n"
+#define CMSG_SAVING_LIM                   common::WriteMsg::mlNormal, "Saving the generated LIM to %s\n"
+#define CMSG_RUN_TIME                     common::WriteMsg::mlNormal, "Run %u: %.3f s\n"
+#define CMSG_SUMMARY                      common::WriteMsg::mlNormal, "Metrics with %u thread(s): min %.3f s, median %.3f s of %u runs\n"
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#include "MapStrTable.h"
+#include <io/inc/BinaryIO.h>
+
+#include <cstring>
+
+using namespace std;
+using namespace columbus;
+
+static const unsigned char random_numbers[] =  /* Table from p. 678.*/
+{    /* Pseudorandom Permutation of the Integers 0 through 255: */
+     1, 14,110, 25, 97,174,132,119,138,170,125,118, 27,233,140, 51,
+    87,197,177,107,234,169, 56, 68, 30,  7,173, 73,188, 40, 36, 65,
+    49,213,104,190, 57,211,148,223, 48,115, 15,  2, 67,186,210, 28,
+    12,181,103, 70, 22, 58, 75, 78,183,167,238,157,124,147,172,144,
+   176,161,141, 86, 60, 66,128, 83,156,241, 79, 46,168,198, 41,254,
+   178, 85,253,237,250,154,133, 88, 35,206, 95,116,252,192, 54,221,
+   102,218,255,240, 82,106,158,201, 61,  3, 89,  9, 42,155,159, 93,
+   166, 80, 50, 34,175,195,100, 99, 26,150, 16,145,  4, 33,  8,189,
+   121, 64, 77, 72,208,245,130,122,143, 55,105,134, 29,164,185,194,
+   193,239,101,242,  5,171,126, 11, 74, 59,137,228,108,191,232,139,
+     6, 24, 81, 20,127, 17, 91, 92,251,151,225,207, 21, 98,113,112,
+    84,226, 18,214,199,187, 13, 32, 94,220,224,212,247,204,196, 43,
+   249,236, 45,244,111,182,153,136,129, 90,217,202, 19,165,231, 71,
+   230,142, 96,227, 62,179,246,114,162, 53,160,215,205,180, 47,109,
+    44, 38, 31,149,135,  0,216, 52, 63, 23, 37, 69, 39,117,146,184,
+   163,200,222,235,248,243,219, 10,152,131,123,229,203, 76,120,209
+};
+
+MapStrTable::MapStrTable( const unsigned buckets ) : buckets( buckets ), count( buckets, 1 ), table( buckets ) {
+}
+
+/* Hashing function described in                   */
+/* "Fast Hashing of Variable-Length Text Strings," */
+/* by Peter K. Pearson, CACM, June 1990.           */
+unsigned short MapStrTable::hash( const char* s, size_t length ) const {
+  const unsigned char* v = (const unsigned char*)s;
+  if ( length == 0 ) {
+    return 0;
+  }
+
+  unsigned hashHi = 0;
+  for ( size_t i = 0; i < length; ++i ) {
+    hashHi = random_numbers[hashHi ^ v[i]];
+  }
+
+  // Increment the first character by one and recalculate the hash
+  unsigned hashLow = random_numbers[( v[0] + 1 ) & 0xFF];
+  for ( size_t i = 1; i < length; ++i ) {
+    hashLow = random_numbers[hashLow ^ v[i]];
+  }
+
+  return ( hashHi << 8 ) | hashLow;
+}
+
+Key MapStrTable::get( const char* s, size_t length, unsigned short hashValue, unsigned bucketIndex ) const {
+  Map::const_iterator from = table[bucketIndex].lower_bound( (Key)hashValue << 16 );
+  Map::const_iterator to = table[bucketIndex].upper_bound( ( (Key)hashValue << 16 ) + 0xFFFF );
+  for ( Map::const_iterator it = from; it != to; ++it ) {
+    if ( it->second.length() == length && it->second.compare( 0, length, s, length ) == 0 ) {
+      return it->first;
+    }
+  }
+  return 0;
+}
+
+Key MapStrTable::set( const string& s ) {
+  if ( s.empty() ) {
+    return 0;
+  }
+
+  unsigned short hashValue = hash( s.c_str(), s.size() );
+  unsigned bucketIndex = hashValue % buckets;
+  Key key = get( s.c_str(), s.size(), hashValue, bucketIndex );
+  if ( ! key ) {
+    key = ( (Key)hashValue << 16 ) | count[bucketIndex]++;
+    table[bucketIndex].insert( Map::value_type( key, s ) );
+  }
+  return key;
+}
+
+Key MapStrTable::get( const string& s ) const {
+  if ( s.empty() ) {
+    return 0;
+  }
+
+  unsigned short hashValue = hash( s.c_str(), s.size() );
+  return get( s.c_str(), s.size(), hashValue, hashValue % buckets );
+}
+
+const string& MapStrTable::get( Key key ) const {
+  static string emptyString;
+  const Map& bucket = table[( key >> 16 ) % buckets];
+  Map::const_iterator it = bucket.find( key );
+  return it != bucket.end() ? it->second : emptyString;
+}
+
+void MapStrTable::save( io::BinaryIO& file ) const {
+  file.writeData( "STRTBL", 6 );
+  file.writeUInt4( buckets );
+  for ( unsigned i = 0; i < buckets; ++i ) {
+    file.writeUShort2( count[i] );
+  }
+
+  for ( unsigned i = 0; i < buckets; ++i ) {
+    for ( Map::const_iterator it = table[i].begin(); it != table[i].end(); ++it ) {
+      file.writeUInt4( it->first );
+      file.writeUInt4( (unsigned)it->second.size() );
+      file.writeData( it->second.c_str(), it->second.size() );
+    }
+  }
+  // the end of the string table
+  file.writeUInt4( 0 );
+}
+
+void MapStrTable::load( io::BinaryIO& file ) {
+  char id[6];
+  file.readData( id, 6 );
+  if ( strncmp( id, "STRTBL", 6 ) ) {
+    return;
+  }
+
+  buckets = file.readUInt4();
+  table.clear();
+  table.resize( buckets );
+  count.assign( buckets, 0 );
+  for ( unsigned i = 0; i < buckets; ++i ) {
+    count[i] = file.readUShort2();
+  }
+
+  vector<char> buffer;
+  for ( Key key = file.readUInt4(); key; key = file.readUInt4() ) {
+    unsigned size = file.readUInt4();
+    buffer.resize( size + 1 );
+    file.readData( &buffer[0], size );
+    table[( key >> 16 ) % buckets].insert( Map::value_type( key, string( &buffer[0], size ) ) );
+  }
+}
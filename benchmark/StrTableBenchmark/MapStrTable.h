@@ -0,0 +1,65 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _STRTABLEBENCHMARK_MAPSTRTABLE_H_
+#define _STRTABLEBENCHMARK_MAPSTRTABLE_H_
+
+#include <strtable/inc/StrTable.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+* The former StrTable, which stored the strings of every bucket in a map ordered by their keys, kept as the
+* baseline of the benchmark. It gives the same keys and saves the same file as StrTable (only the interface
+* used by the benchmark is kept).
+*/
+class MapStrTable {
+
+  public:
+
+    MapStrTable( const unsigned buckets = 511 );
+
+    columbus::Key set( const std::string& s );
+
+    columbus::Key get( const std::string& s ) const;
+
+    const std::string& get( columbus::Key key ) const;
+
+    void save( columbus::io::BinaryIO& file ) const;
+
+    void load( columbus::io::BinaryIO& file );
+
+  private:
+
+    typedef std::map<columbus::Key, std::string> Map;
+
+    unsigned short hash( const char* s, size_t length ) const;
+
+    columbus::Key get( const char* s, size_t length, unsigned short hashValue, unsigned bucketIndex ) const;
+
+    unsigned buckets;                 ///> The number of the buckets
+    std::vector<unsigned short> count;  ///> The counter of the keys of every bucket
+    std::vector<Map> table;           ///> The strings of every bucket by their keys
+
+};
+
+#endif
@@ -0,0 +1,252 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#define PROGRAM_NAME "StrTableBenchmark"
+#define EXECUTABLE_NAME "StrTableBenchmark"
+
+#include <MainCommon.h>
+
+#include "messages.h"
+#include "MapStrTable.h"
+#include <strtable/inc/StrTable.h>
+#include <io/inc/BinaryIO.h>
+#include <common/inc/Stat.h>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <unordered_set>
+
+using namespace std;
+using namespace common;
+using namespace columbus;
+
+static string inputFile;
+static unsigned strings = 3000000;
+static unsigned distinct = 300000;
+static unsigned runs = 3;
+static bool measureStrTable = true;
+static bool measureMapStrTable = true;
+
+static void ppFile( char *filename ) {
+  inputFile = filename;
+}
+
+static bool ppStrings( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  strings = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppDistinct( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  distinct = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppRuns( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  runs = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppTable( const Option *o, char *argv[] ) {
+  string table = argv[0];
+  measureStrTable = table != "map";
+  measureMapStrTable = table != "strtable";
+  return true;
+}
+
+const Option OPTIONS_OBJ [] = {
+  { false,  "-strings",     1, "number",            0, OT_WC,    ppStrings,      NULL, "The number of the interned strings, if no string list is given. The default value is 3000000."},
+  { false,  "-distinct",    1, "number",            0, OT_WC,    ppDistinct,     NULL, "The number of the different strings among them, if no string list is given. The default value is 300000."},
+  { false,  "-runs",        1, "number",            0, OT_WC,    ppRuns,         NULL, "The number of the measured runs. The default value is 3."},
+  { false,  "-table",       1, "strtable|map|both", 0, OT_WC,    ppTable,        NULL, "The measured implementation: the StrTable, the former map based table or both of them (default). The resident memory of the process is only comparable if one implementation is measured."},
+  COMMON_CL_ARGS
+};
+
+static double elapsed( chrono::steady_clock::time_point start ) {
+  return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+}
+
+/**
+* The strings set by the ASG builders: names, qualified names and paths of different lengths, most of the
+* occurrences are repeated ones.
+*/
+static void generate( vector<string>& input ) {
+  vector<string> names;
+  for ( unsigned i = 0; i < distinct; ++i ) {
+    switch ( i % 3 ) {
+      case 0: names.push_back( "name" + to_string( i ) ); break;
+      case 1: names.push_back( "org.example.package" + to_string( i % 211 ) + ".Class" + to_string( i ) ); break;
+      default: names.push_back( "/home/user/project/src/module" + to_string( i % 37 ) + "/File" + to_string( i ) + ".java" ); break;
+    }
+  }
+
+  mt19937 random( 42 );
+  uniform_int_distribution<unsigned> any( 0, distinct - 1 );
+  input.reserve( strings );
+  // every name is set at least once
+  for ( unsigned i = 0; i < strings; ++i ) {
+    input.push_back( names[i < distinct ? i : any( random )] );
+  }
+  shuffle( input.begin(), input.end(), random );
+}
+
+/**
+* Reads a dumped string list, every line is an interned string in the order of the set calls (the empty lines
+* are skipped, as the tables do not store empty strings).
+*/
+static bool readInput( vector<string>& input ) {
+  ifstream in( inputFile.c_str() );
+  if ( ! in.is_open() ) {
+    return false;
+  }
+  string line;
+  while ( getline( in, line ) ) {
+    if ( ! line.empty() && line[line.size() - 1] == '\r' ) {
+      line.erase( line.size() - 1 );
+    }
+    if ( ! line.empty() ) {
+      input.push_back( line );
+    }
+  }
+  return true;
+}
+
+static void summary( const char* table, const char* phase, vector<double>& times ) {
+  sort( times.begin(), times.end() );
+  WriteMsg::write( CMSG_SUMMARY, table, phase, times.front(), times[times.size() / 2], runs );
+}
+
+/**
+* Measures the runs of a table implementation, the keys of the first run are given back.
+*/
+template <class Table>
+static bool measure( const char* name, const vector<string>& input, const string& savedFile, vector<Key>& firstKeys ) {
+  vector<double> setTimes, getStringTimes, getKeyTimes, saveTimes, loadTimes;
+  for ( unsigned run = 1; run <= runs; ++run ) {
+    Table table;
+    vector<Key> keys( input.size() );
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for ( size_t i = 0; i < input.size(); ++i ) {
+      keys[i] = table.set( input[i] );
+    }
+    setTimes.push_back( elapsed( start ) );
+    double resident = getProcessUsedMemSize().resident / ( 1024.0 * 1024.0 );
+
+    unsigned long long checksum = 0;
+    start = chrono::steady_clock::now();
+    for ( size_t i = 0; i < input.size(); ++i ) {
+      checksum += table.get( input[i] );
+    }
+    getStringTimes.push_back( elapsed( start ) );
+
+    start = chrono::steady_clock::now();
+    for ( size_t i = 0; i < keys.size(); ++i ) {
+      checksum += table.get( keys[i] ).size();
+    }
+    getKeyTimes.push_back( elapsed( start ) );
+
+    start = chrono::steady_clock::now();
+    {
+      io::BinaryIO file( savedFile, io::IOBase::omWrite );
+      table.save( file );
+      file.close();
+    }
+    saveTimes.push_back( elapsed( start ) );
+
+    Table loaded;
+    start = chrono::steady_clock::now();
+    {
+      io::BinaryIO file( savedFile, io::IOBase::omRead );
+      loaded.load( file );
+      file.close();
+    }
+    loadTimes.push_back( elapsed( start ) );
+
+    // the keys are saved with the strings
+    for ( size_t i = 0; i < input.size(); ++i ) {
+      if ( loaded.get( input[i] ) != keys[i] ) {
+        WriteMsg::write( CMSG_WRONG_KEY, name, input[i].c_str() );
+        return false;
+      }
+    }
+
+    WriteMsg::write( CMSG_RUN_TIME, name, run, setTimes.back(), getStringTimes.back(), getKeyTimes.back(), saveTimes.back(), loadTimes.back(), resident );
+    WriteMsg::write( CMSG_CHECKSUM, checksum );
+    if ( run == 1 ) {
+      firstKeys.swap( keys );
+    }
+  }
+
+  summary( name, "set", setTimes );
+  summary( name, "get string", getStringTimes );
+  summary( name, "get key", getKeyTimes );
+  summary( name, "save", saveTimes );
+  summary( name, "load", loadTimes );
+  return true;
+}
+
+int main( int argc, char *argv[] ) {
+
+  MAIN_BEGIN
+
+    MainInit( argc, argv, "-" );
+
+    vector<string> input;
+    if ( inputFile.empty() ) {
+      if ( distinct > strings ) {
+        distinct = strings;
+      }
+      generate( input );
+    } else {
+      WriteMsg::write( CMSG_READING_STRINGS, inputFile.c_str() );
+      if ( ! readInput( input ) ) {
+        WriteMsg::write( CMSG_CANNOT_OPEN_FILE, inputFile.c_str() );
+        return 1;
+      }
+      distinct = (unsigned)unordered_set<string>( input.begin(), input.end() ).size();
+    }
+    WriteMsg::write( CMSG_INTERNING_STRINGS, (unsigned)input.size(), distinct );
+
+    const string savedFile = ( boost::filesystem::temp_directory_path() / boost::filesystem::unique_path( "StrTableBenchmark-%%%%-%%%%.str" ) ).string();
+
+    vector<Key> keys, mapKeys;
+    bool ok = ( ! measureStrTable || measure<StrTable>( "StrTable", input, savedFile, keys ) )
+      && ( ! measureMapStrTable || measure<MapStrTable>( "map", input, savedFile, mapKeys ) );
+    boost::filesystem::remove( savedFile );
+    if ( ! ok ) {
+      return 1;
+    }
+
+    // the tables give the same keys, so their files can be read by each other
+    if ( measureStrTable && measureMapStrTable && keys != mapKeys ) {
+      WriteMsg::write( CMSG_DIFFERENT_KEYS );
+      return 1;
+    }
+
+  MAIN_END
+
+  return 0;
+}
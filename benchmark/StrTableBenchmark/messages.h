@@ -0,0 +1,34 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+#ifndef _STRTABLEBENCHMARK_MESSAGES_H_
+#define _STRTABLEBENCHMARK_MESSAGES_H_
+
+#define CMSG_READING_STRINGS              common::WriteMsg::mlNormal, "Reading the string list %s\n"
+#define CMSG_CANNOT_OPEN_FILE             common::WriteMsg::mlError,  "Error: cannot open %s\n"
+#define CMSG_INTERNING_STRINGS            common::WriteMsg::mlNormal, "Interning %u strings (%u different ones)\n"
+#define CMSG_RUN_TIME                     common::WriteMsg::mlNormal, "%s run %u: set %.3f s, get string %.3f s, get key %.3f s, save %.3f s, load %.3f s, resident memory %.1f MB\n"
+#define CMSG_SUMMARY                      common::WriteMsg::mlNormal, "%-8s %-10s min %.3f s, median %.3f s of %u runs\n"
+#define CMSG_WRONG_KEY                    common::WriteMsg::mlError,  "Error: %s: the key of %s is different after the load\n"
+#define CMSG_DIFFERENT_KEYS               common::WriteMsg::mlError,  "Error: the map based table gives different keys than the StrTable\n"
+#define CMSG_CHECKSUM                     common::WriteMsg::mlDebug,  "Debug: checksum %llu\n"
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#include "PeakMemory.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+// The heap memory allocated by the process and its peak.
+static atomic<size_t> allocated( 0 );
+static atomic<size_t> peakAllocated( 0 );
+
+// The size of an allocation is stored before the returned block, the header keeps the alignment of new.
+static const size_t HEADER_SIZE = sizeof( max_align_t );
+
+void* operator new( size_t size ) {
+  char* block = static_cast<char*>( malloc( size + HEADER_SIZE ) );
+  if ( ! block ) {
+    throw bad_alloc();
+  }
+  *reinterpret_cast<size_t*>( block ) = size;
+  size_t current = allocated += size;
+  size_t peak = peakAllocated;
+  while ( peak < current && ! peakAllocated.compare_exchange_weak( peak, current ) ) {
+  }
+  return block + HEADER_SIZE;
+}
+
+void* operator new[]( size_t size ) {
+  return operator new( size );
+}
+
+void operator delete( void* pointer ) noexcept {
+  if ( pointer ) {
+    char* block = static_cast<char*>( pointer ) - HEADER_SIZE;
+    allocated -= *reinterpret_cast<size_t*>( block );
+    free( block );
+  }
+}
+
+void operator delete[]( void* pointer ) noexcept {
+  operator delete( pointer );
+}
+
+PeakMemory::PeakMemory() : before( allocated ) {
+  peakAllocated = before;
+}
+
+double PeakMemory::get() const {
+  return ( peakAllocated - before ) / ( 1024.0 * 1024.0 );
+}
@@ -0,0 +1,47 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _SUFFIXARRAYBENCHMARK_PEAKMEMORY_H_
+#define _SUFFIXARRAYBENCHMARK_PEAKMEMORY_H_
+
+#include <cstddef>
+
+/**
+* Measures the peak of the heap memory allocated while it exists (above the memory allocated at its construction).
+* The allocations are counted by the global operator new and delete, which are replaced in PeakMemory.cpp.
+*/
+class PeakMemory {
+
+  public:
+
+    PeakMemory();
+
+    /**
+    * Gives back the peak memory in MB.
+    */
+    double get() const;
+
+  private:
+
+    size_t before;  ///> The memory allocated at the construction
+
+};
+
+#endif
@@ -0,0 +1,221 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#define PROGRAM_NAME "SuffixArrayBenchmark"
+#define EXECUTABLE_NAME "SuffixArrayBenchmark"
+
+#include <MainCommon.h>
+
+#include "messages.h"
+#include "PeakMemory.h"
+#include <suffixarray/inc/suffix_array.h>
+#include <threadpool/inc/Executor.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+
+using namespace std;
+using namespace common;
+using namespace columbus::suffix_array;
+
+static unsigned length = 5000000;
+static unsigned threads = 4;
+static unsigned runs = 3;
+static string inputFile;
+
+static void ppFile( char *filename ) {
+  inputFile = filename;
+}
+
+static bool ppLength( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  length = value > 1 ? value : 2;
+  return true;
+}
+
+static bool ppThreads( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  threads = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppRuns( const Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  runs = value > 0 ? value : 1;
+  return true;
+}
+
+const Option OPTIONS_OBJ [] = {
+  { false,  "-length",      1, "number",            0, OT_WC,    ppLength,       NULL, "The length of the generated sequence, it is used if there is no input file. The default value is 5000000."},
+  { false,  "-threads",     1, "number",            0, OT_WC,    ppThreads,      NULL, "The number of the threads of the executor used by sais. The default value is 4."},
+  { false,  "-runs",        1, "number",            0, OT_WC,    ppRuns,         NULL, "The number of the measured runs. The default value is 3."},
+  COMMON_CL_ARGS
+};
+
+static double elapsed( chrono::steady_clock::time_point start ) {
+  return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+}
+
+/**
+* Gives access to the suffixes of the measured builders, so their results can be compared.
+*/
+template <class Builder>
+class Measured : public Builder {
+  public:
+    Measured( Sequence<int>& sequence ) : Builder( sequence ) {}
+    Measured( Sequence<int>& sequence, columbus::thread::Executor* executor ) : Builder( sequence, executor ) {}
+
+    unsigned getPosition( unsigned i ) const { return this->SuffixArray<int>::suffixes[i].position; }
+    unsigned getLcp( unsigned i ) const { return this->SuffixArray<int>::suffixes[i].lcp; }
+};
+
+/**
+* Reads the serialized ASG of the clone detection: the node kinds (and the unique separator values) in the order
+* of the sequence built by the DuplicatedCodeFinder, as whitespace separated integers.
+*/
+static bool readInput( vector<int>& symbols ) {
+  ifstream in( inputFile.c_str() );
+  if ( ! in.is_open() ) {
+    WriteMsg::write( CMSG_CANNOT_OPEN_FILE, inputFile.c_str() );
+    return false;
+  }
+  int symbol;
+  while ( in >> symbol ) {
+    symbols.push_back( symbol );
+  }
+  if ( ! in.eof() ) {
+    WriteMsg::write( CMSG_WRONG_INPUT, inputFile.c_str(), (unsigned)symbols.size() );
+    return false;
+  }
+  if ( symbols.size() < 2 ) {
+    WriteMsg::write( CMSG_TOO_SHORT_SEQUENCE, inputFile.c_str() );
+    return false;
+  }
+  return true;
+}
+
+/**
+* The generated input modelled on the serialized ASG of the clone detection: the node kinds of the code units,
+* many units are copies of a few others with small changes.
+*/
+static void generate( vector<int>& symbols ) {
+  mt19937 random( 42 );
+  uniform_int_distribution<int> kind( 1, 400 );
+  uniform_int_distribution<unsigned> unitLength( 20, 200 );
+  uniform_int_distribution<unsigned> percent( 0, 99 );
+
+  vector<vector<int> > units( 2000 );
+  for ( vector<vector<int> >::iterator it = units.begin(); it != units.end(); ++it ) {
+    it->resize( unitLength( random ) );
+    for ( vector<int>::iterator symbol = it->begin(); symbol != it->end(); ++symbol ) {
+      *symbol = kind( random );
+    }
+  }
+
+  uniform_int_distribution<size_t> unit( 0, units.size() - 1 );
+  symbols.reserve( length );
+  while ( symbols.size() < length ) {
+    const vector<int>& copied = units[unit( random )];
+    for ( size_t i = 0; i < copied.size() && symbols.size() < length; ++i ) {
+      symbols.push_back( percent( random ) < 5 ? kind( random ) : copied[i] );
+    }
+  }
+}
+
+template <class Builder>
+static bool same( const Measured<LinearSuffixArray<int> >& expected, const Builder& result, const char* name ) {
+  for ( unsigned i = 0; i < length; ++i ) {
+    if ( expected.getPosition( i ) != result.getPosition( i ) || expected.getLcp( i ) != result.getLcp( i ) ) {
+      WriteMsg::write( CMSG_DIFFERENT_RESULT, name, i );
+      return false;
+    }
+  }
+  return true;
+}
+
+static void summary( const char* phase, vector<double>& times, const vector<double>& memory ) {
+  sort( times.begin(), times.end() );
+  WriteMsg::write( CMSG_SUMMARY, phase, times.front(), times[times.size() / 2], runs, *max_element( memory.begin(), memory.end() ) );
+}
+
+int main( int argc, char *argv[] ) {
+
+  MAIN_BEGIN
+
+    MainInit( argc, argv, "-" );
+
+    vector<int> symbols;
+    if ( inputFile.empty() ) {
+      generate( symbols );
+    } else {
+      WriteMsg::write( CMSG_READING_SEQUENCE, inputFile.c_str() );
+      if ( ! readInput( symbols ) ) {
+        return 1;
+      }
+      length = (unsigned)symbols.size();
+    }
+    WriteMsg::write( CMSG_GENERATING_SEQUENCE, length, threads );
+    Sequence<int> sequence( symbols );
+    columbus::thread::Executor executor( threads );
+
+    vector<double> dc3Times, saisTimes, parallelSaisTimes;
+    vector<double> dc3Memory, saisMemory, parallelSaisMemory;
+    for ( unsigned run = 1; run <= runs; ++run ) {
+      PeakMemory dc3Peak;
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      Measured<LinearSuffixArray<int> > dc3( sequence );
+      dc3Times.push_back( elapsed( start ) );
+      dc3Memory.push_back( dc3Peak.get() );
+
+      {
+        PeakMemory peak;
+        start = chrono::steady_clock::now();
+        Measured<SaisSuffixArray<int> > sais( sequence );
+        saisTimes.push_back( elapsed( start ) );
+        saisMemory.push_back( peak.get() );
+        if ( !same( dc3, sais, "sais" ) ) {
+          return 1;
+        }
+      }
+
+      {
+        PeakMemory peak;
+        start = chrono::steady_clock::now();
+        Measured<SaisSuffixArray<int> > sais( sequence, &executor );
+        parallelSaisTimes.push_back( elapsed( start ) );
+        parallelSaisMemory.push_back( peak.get() );
+        if ( !same( dc3, sais, "parallel sais" ) ) {
+          return 1;
+        }
+      }
+
+      WriteMsg::write( CMSG_RUN_TIME, run, dc3Times.back(), dc3Memory.back(), saisTimes.back(), saisMemory.back(), parallelSaisTimes.back(), parallelSaisMemory.back() );
+    }
+
+    summary( "dc3", dc3Times, dc3Memory );
+    summary( "sais", saisTimes, saisMemory );
+    summary( "sais on the executor", parallelSaisTimes, parallelSaisMemory );
+
+  MAIN_END
+
+  return 0;
+}
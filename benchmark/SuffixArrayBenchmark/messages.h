@@ -0,0 +1,34 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+#ifndef _SUFFIXARRAYBENCHMARK_MESSAGES_H_
+#define _SUFFIXARRAYBENCHMARK_MESSAGES_H_
+
+#define CMSG_READING_SEQUENCE             common::WriteMsg::mlNormal, "Reading the sequence from %s\n"
+#define CMSG_CANNOT_OPEN_FILE             common::WriteMsg::mlError,  "Error: cannot open %s\n"
+#define CMSG_WRONG_INPUT                  common::WriteMsg::mlError,  "Error: %s is not a whitespace separated integer list (after %u symbols)\n"
+#define CMSG_TOO_SHORT_SEQUENCE           common::WriteMsg::mlError,  "Error: the sequence of %s has less than 2 symbols\n"
+#define CMSG_GENERATING_SEQUENCE          common::WriteMsg::mlNormal, "Building the suffix array of %u symbols, %u thread(s)\n"
+#define CMSG_RUN_TIME                     common::WriteMsg::mlNormal, "Run %u: dc3 %.3f s (peak %.1f MB), sais %.3f s (peak %.1f MB), sais on the executor %.3f s (peak %.1f MB)\n"
+#define CMSG_SUMMARY                      common::WriteMsg::mlNormal, "%-22s min %.3f s, median %.3f s of %u runs, peak memory %.1f MB\n"
+#define CMSG_DIFFERENT_RESULT             common::WriteMsg::mlError,  "Error: the %s suffix array differs from the dc3 one at %u\n"
+
+#endif
@@ -57,7 +57,11 @@ struct Config {
     , freeVersion(false)
     , statementFilter(true)
     , smallGenealogy(true)
+    , segmentedGenealogy(false)
     , xmlDumpFile ("")
+    , saisSuffixArray(true)
+    , threads(1)
+    , asgCacheSize(1024ULL * 1024 * 1024)
   { memset(&stat,0,sizeof(stat)); }
 
   unsigned int           minLines;              ///< minimum lines in clone
@@ -101,6 +105,8 @@ struct Config {
     uint64_t      finalizeTime;
     uint64_t      buildCloneTreeTime;
     uint64_t      evolutionMappingTime;
+    uint64_t      asgLoadTime;
+    uint64_t      asgLoadTimeSaved;
     
     unsigned int serializedASGLength;
     unsigned int serializedASGLengthFiltered;
@@ -109,13 +115,19 @@ struct Config {
     unsigned int numOfFoundsuffixClass;
     unsigned int numberOfInstancesInTheLastSystem;
     unsigned int numberOfTrivialPairs;
+    unsigned int asgCacheHits;
+    unsigned int asgCacheMisses;
 
   } stat;
 
   bool freeVersion;
   bool statementFilter;
   bool smallGenealogy;                          ///< keep the string attributes of the last system only in the genealogy output
+  bool segmentedGenealogy;                      ///< the genealogy file is the index of a segmented genealogy, the new system is appended as a new segment
   std::string            xmlDumpFile;
+  bool                   saisSuffixArray;       ///< build the suffix array with SA-IS instead of DC3
+  unsigned int           threads;               ///< number of threads used by the clone detection
+  uint64_t               asgCacheSize;          ///< memory budget of the cached component ASGs in bytes
 };
 
 #endif
@@ -24,12 +24,37 @@
 #include "common.h"
 #include <string>
 #include <map>
+#include <set>
+#include <list>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 namespace columbus { namespace dcf {
 
+/**
+ * The loaded components are pinned until release() is called. The released components are kept in a
+ * least recently used cache while their estimated size fits into config.asgCacheSize, so the next
+ * loadComponent() of the same file does not deserialize it again.
+ * The components can be loaded and released on several threads at the same time, every component has its own
+ * factory and string table.
+ */
 class LanguageFactory {
 
 protected:
+  // The remembered data of a component which has been loaded at least once.
+  struct ComponentInfo {
+    std::string componentID;
+    uint64_t size;      // estimated memory usage in bytes
+    uint64_t loadTime;  // wall time of the last real load in 1/100 sec
+    ComponentInfo() : componentID(), size(0), loadTime(0) {}
+  };
+
+  // A released factory kept in the cache.
+  struct CacheEntry {
+    Factory* factory;
+    std::list<std::string>::iterator lruPosition;
+  };
+
   bool loaded;
   std::map<std::string, Factory*> factories;
   std::map<std::string, std::string> limComponentNameFileNameMap;
@@ -37,6 +62,26 @@ protected:
   
   std::map<std::string, std::size_t> hashCodes;
 
+  std::map<std::string, ComponentInfo> componentInfos;
+  std::map<std::string, CacheEntry> cache;
+  std::list<std::string> lruList;   // the cached files, the most recently used is the first
+  uint64_t pinnedSize;
+  uint64_t cachedSize;
+
+  // The members are guarded by this mutex, the files being loaded are signaled by the condition variable.
+  mutable boost::mutex mutex;
+  boost::condition_variable loadingCond;
+  std::set<std::string> loading;
+  unsigned runningLoads;
+  unsigned long long startedLoads;
+
+  Factory* takeFromCache(const std::string& fname);
+  Factory* loadFromFile(const std::string& fname, ComponentInfo& info, uint64_t& memoryGrowth);
+  void loadFilter(Factory* factory, const std::string& fname);
+  void unpin(const std::string& fname, Factory* factory);
+  void trimCache(uint64_t reserve);
+  void deleteFactory(Factory* factory);
+
 public:
   LanguageFactory();
   virtual ~LanguageFactory();
@@ -55,8 +100,27 @@ public:
 
 
   std::string getFileNameByComponentId(const std::string& id);
+
+  /**
+   * @brief Unpins all loaded components. They are moved into the cache or deleted if they do not fit into it.
+   */
   void release() ;
 
+  /**
+   * @brief Unpins one loaded component.
+   */
+  void release(const std::string& fname);
+
+  /**
+   * @brief Deletes the cached components.
+   */
+  void clearCache();
+
+  /**
+   * @brief Returns true if the component is loaded or cached, so loading it does not read the file.
+   */
+  bool isResident(const std::string& fname) const;
+
   LanguageFactory& operator=(LanguageFactory& lf) ;
 
   Factory* operator()(const std::string& component) ;
@@ -116,6 +116,11 @@ public:
 
   void visitBase   (const Base& n);
   void fillCoverage(CCMap& cov);
+
+  /**
+   * \brief Adds the counters of the other visitor to the counters of this one.
+   */
+  void merge(const CoverageVisitorBase& other);
   virtual void acceptNode(Base& b);
   virtual void acceptEndNode(Base& b);
 
@@ -455,6 +455,12 @@ protected:
    */
   void patternFilter();
 
+  /**
+   * \internal
+   * \brief builds the suffix array of the sequence with the configured algorithm.
+   */
+  suffix_array::SuffixArray<int>* createSuffixArray(suffix_array::Sequence<int>& sequence) const;
+
    /**
    * \internal
    * \brief serialize the all given asg-es.
@@ -522,6 +528,12 @@ protected:
   const std::string& getAsgNameByLimId(columbus::NodeId limId, const columbus::lim::asg::Factory& factory) const;
   
   std::vector<genealogy::CloneInstance*> getInstancesOfaSystem(const genealogy::System& system) const;
+
+  /**
+   * \internal
+   * \brief connects the instances of the last system to the most similar instances of the current system.
+   */
+  void mapCloneInstances(const std::vector<genealogy::CloneInstance*>& instancesOfTheLastSystem, const std::vector<genealogy::CloneInstance*>& instancesOfTheCurrentSystem);
   
 #endif
 public:
@@ -626,7 +638,7 @@ public:
 
   void setFilterOut(std::ostream& out);
   void computeCoveredLines();
-  void calculateCOOForLangASG( columbus::NodeId componenetId,const std::string& );
+  void calculateCOOForLangASG( columbus::NodeId componenetId, Factory& factory);
 
   friend class ProcessCC;
   friend class ProcessPatternFilter;
@@ -49,6 +49,9 @@
 #define CMSG_STATISTICS                         common::WriteMsg::mlNormal, "\nStatistics:\n"
 #define CMSG_DETECTING_TIME                     common::WriteMsg::mlNormal, "\tDetection time      :%lu 1/100sec\n"
 #define CMSG_PEAK_MEMORY_USAGE                  common::WriteMsg::mlNormal, "\tPeak memory usage   :%lu MByte\n"
+#define CMSG_ASG_CACHE_HITS                     common::WriteMsg::mlNormal, "\tASG cache hits      :%u/%u (%u%%)\n"
+#define CMSG_ASG_LOAD_TIME                      common::WriteMsg::mlNormal, "\tASG load time       :%lu 1/100sec\n"
+#define CMSG_ASG_LOAD_TIME_SAVED                common::WriteMsg::mlNormal, "\tASG load time saved :%lu 1/100sec\n"
 #define CMSG_COMPUTING_COVERED_NODES            common::WriteMsg::mlNormal, "Computing clone coverage...\n"
 #define CMSG_START_FINALIZING                   common::WriteMsg::mlNormal, "Finalizing...\n"
 #define CMSG_START_EVOLUTION_MAPPING            common::WriteMsg::mlNormal, "Evolution mapping...\n"
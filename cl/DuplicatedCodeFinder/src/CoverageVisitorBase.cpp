@@ -137,6 +137,16 @@ void CoverageVisitorBase::fillCoverage( CCMap& cov )
   
 }
 
+void CoverageVisitorBase::merge( const CoverageVisitorBase& other )
+{
+  for (CCCounterMap::const_iterator iter = other.all.begin(); iter != other.all.end(); ++iter)
+    *getCounter(all, iter->first) += iter->second;
+  for (CCCounterMap::const_iterator iter = other.coverage.begin(); iter != other.coverage.end(); ++iter)
+    *getCounter(coverage, iter->first) += iter->second;
+  for (CCCounterMap::const_iterator iter = other.complexity.begin(); iter != other.complexity.end(); ++iter)
+    *getCounter(complexity, iter->first) += iter->second;
+}
+
 void CoverageVisitorBase::acceptNode( Base& b )
 {
   b.accept(dynamic_cast<Visitor&>(*this));
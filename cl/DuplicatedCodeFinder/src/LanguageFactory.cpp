@@ -22,6 +22,7 @@
 #include "../inc/LanguageFactory.h"
 
 #include <boost/functional/hash.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <Exception.h>
 
 using namespace std;
@@ -33,36 +34,185 @@ namespace columbus { namespace dcf {
     , factories()
     , limComponentNameFileNameMap()
     , hashCodes()
+    , componentInfos()
+    , cache()
+    , lruList()
+    , pinnedSize(0)
+    , cachedSize(0)
+    , mutex()
+    , loadingCond()
+    , loading()
+    , runningLoads(0)
+    , startedLoads(0)
   {}
 
   LanguageFactory::~LanguageFactory() {
     release();
+    clearCache();
   }
 
   void LanguageFactory::loadComponent(const std::string& fname, bool deleteFiltered, unsigned long long* hash, std::string* componentID /*=NULL*/) {
+    Factory* factory = NULL;
+    ComponentInfo info;
+    bool pinned = false;
+    unsigned long long startedBefore = 0;
+    {
+      boost::unique_lock<boost::mutex> lock(mutex);
+      while (loading.find(fname) != loading.end())
+        loadingCond.wait(lock);
+
+      std::map<std::string, Factory*>::iterator it = factories.find(fname);
+      if (it != factories.end()) {
+        // already pinned
+        factory = it->second;
+        pinned = true;
+      } else {
+        factory = takeFromCache(fname);
+        if (factory) {
+          ++config.stat.asgCacheHits;
+          config.stat.asgLoadTimeSaved += componentInfos[fname].loadTime;
+        } else {
+          ++config.stat.asgCacheMisses;
+          ++runningLoads;
+          startedBefore = ++startedLoads;
+        }
+        loading.insert(fname);
+      }
+      info = componentInfos[fname];
+    }
+
+    if (!pinned) {
+      bool fresh = factory == NULL;
+      uint64_t knownSize = info.size;
+      uint64_t memoryGrowth = 0;
+      try {
+        if (fresh) {
+          factory = loadFromFile(fname, info, memoryGrowth);
+        } else {
+          // restore the state of a freshly loaded factory
+          factory->turnFilterOn();
+          loadFilter(factory, fname);
+        }
+      } catch (...) {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        if (fresh)
+          --runningLoads;
+        else
+          deleteFactory(factory);
+        loading.erase(fname);
+        loadingCond.notify_all();
+        throw;
+      }
+
+      boost::unique_lock<boost::mutex> lock(mutex);
+      if (fresh) {
+        // the memory growth of the process is only meaningful if no other load was running meanwhile
+        if (runningLoads == 1 && startedLoads == startedBefore && memoryGrowth > info.size)
+          info.size = memoryGrowth;
+        else if (knownSize > info.size)
+          info.size = knownSize;
+        --runningLoads;
+        config.stat.asgLoadTime += info.loadTime;
+        componentInfos[fname] = info;
+      }
+      loading.erase(fname);
+      loadingCond.notify_all();
+
+      if(hash) {
+        lock.unlock();
+        unsigned long long calc_hash = calculateHash(factory, fname);
+        lock.lock();
+        if(calc_hash != *hash) {
+          pinnedSize += info.size;
+          unpin(fname, factory);
+          throw columbus::Exception(COLUMBUS_LOCATION, CMSG_EX_HASH_CODE_MISMATCH(fname));
+        }
+      }
+
+      pinnedSize += info.size;
+      factories.insert(make_pair(fname, factory));
+      loaded=true;
+      trimCache(0);
+    } else if(hash) {
+      unsigned long long calc_hash = calculateHash(factory, fname);
+      if(calc_hash != *hash)
+        throw columbus::Exception(COLUMBUS_LOCATION, CMSG_EX_HASH_CODE_MISMATCH(fname));
+    }
+
+    if (componentID) {
+      *componentID = info.componentID;
+      boost::unique_lock<boost::mutex> lock(mutex);
+      limComponentNameFileNameMap[*componentID] = fname;
+    }
+  }
+
+  Factory* LanguageFactory::takeFromCache(const std::string& fname) {
+    std::map<std::string, CacheEntry>::iterator it = cache.find(fname);
+    if (it == cache.end()) {
+      // make room for the new component before loading it
+      boost::system::error_code error;
+      uint64_t fileSize = boost::filesystem::file_size(fname, error);
+      if (error)
+        fileSize = 0;
+      uint64_t knownSize = componentInfos[fname].size;
+      trimCache(knownSize > fileSize ? knownSize : fileSize);
+      return NULL;
+    }
+
+    Factory* factory = it->second.factory;
+    lruList.erase(it->second.lruPosition);
+    cache.erase(it);
+    cachedSize -= componentInfos[fname].size;
+    return factory;
+  }
+
+  Factory* LanguageFactory::loadFromFile(const std::string& fname, ComponentInfo& info, uint64_t& memoryGrowth) {
+    boost::system::error_code error;
+    uint64_t fileSize = boost::filesystem::file_size(fname, error);
+    if (error)
+      fileSize = 0;
+
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+    uint64_t memoryBefore = common::getProcessUsedMemSize().size;
+
     columbus::RefDistributorStrTable *stt=new columbus::RefDistributorStrTable();
     Factory* factory = new Factory(*stt);
 
+    std::string componentID;
+    try {
 #if defined(SCHEMA_JAVA) || defined SCHEMA_PYTHON
-    columbus::CsiHeader header;
-    factory->load(fname, header);
+      columbus::CsiHeader header;
+      factory->load(fname, header);
 
 #elif defined SCHEMA_CSHARP || defined (SCHEMA_JAVASCRIPT)
-    std::list<HeaderData*> headerList;
-    columbus::PropertyData header;
-    headerList.push_back(&header);
-    factory->load(fname, headerList);
+      std::list<HeaderData*> headerList;
+      columbus::PropertyData header;
+      headerList.push_back(&header);
+      factory->load(fname, headerList);
 
 #endif
 
-    if (componentID) {
-      if (!header.get(header.csih_OriginalLocation,*componentID)) {
-        *componentID = fname;
-        common::changePath(*componentID, config.changepathfrom, config.changepathto);
+      if (!header.get(header.csih_OriginalLocation,componentID)) {
+        componentID = fname;
+        common::changePath(componentID, config.changepathfrom, config.changepathto);
       }
 
-      limComponentNameFileNameMap[*componentID] = fname;
+      loadFilter(factory, fname);
+    } catch (...) {
+      deleteFactory(factory);
+      throw;
     }
+
+    // the growth of the process is only an estimation, as the allocator can reuse the freed memory
+    uint64_t memoryAfter = common::getProcessUsedMemSize().size;
+    memoryGrowth = memoryAfter > memoryBefore ? memoryAfter - memoryBefore : 0;
+    info.size = fileSize;
+    info.componentID = componentID;
+    info.loadTime = (boost::posix_time::microsec_clock::universal_time() - start).total_milliseconds() / 10;
+    return factory;
+  }
+
+  void LanguageFactory::loadFilter(Factory* factory, const std::string& fname) {
     factory->initializeFilter();
     boost::filesystem::path f(fname);
     f=boost::filesystem::change_extension(f, FILTER_FILE_EXTENSION);
@@ -74,16 +224,58 @@ namespace columbus { namespace dcf {
         factory->loadFilter(f.string());
       }
     }
+  }
 
-    if(hash) {
-      unsigned long long calc_hash = calculateHash(factory, fname);
-      if(calc_hash != *hash)
-        throw columbus::Exception(COLUMBUS_LOCATION, CMSG_EX_HASH_CODE_MISMATCH(fname));
+  void LanguageFactory::unpin(const std::string& fname, Factory* factory) {
+    uint64_t size = componentInfos[fname].size;
+    pinnedSize -= size;
+
+    if (size > config.asgCacheSize) {
+      deleteFactory(factory);
+      return;
     }
 
-    factories.insert(make_pair(fname, factory));
-    loaded=true;
+    // the reverse edges can be rebuilt, they are not worth the memory
+    if (factory->getExistsReverseEdges())
+      factory->disableReverseEdges();
 
+    lruList.push_front(fname);
+    CacheEntry entry;
+    entry.factory = factory;
+    entry.lruPosition = lruList.begin();
+    cache.insert(make_pair(fname, entry));
+    cachedSize += size;
+  }
+
+  void LanguageFactory::trimCache(uint64_t reserve) {
+    while (!lruList.empty() && pinnedSize + cachedSize + reserve > config.asgCacheSize) {
+      std::string fname = lruList.back();
+      lruList.pop_back();
+      std::map<std::string, CacheEntry>::iterator it = cache.find(fname);
+      deleteFactory(it->second.factory);
+      cache.erase(it);
+      cachedSize -= componentInfos[fname].size;
+    }
+  }
+
+  void LanguageFactory::deleteFactory(Factory* factory) {
+    columbus::RefDistributorStrTable* stt = &factory->getStringTable();
+    delete factory;
+    delete stt;
+  }
+
+  void LanguageFactory::clearCache() {
+    boost::unique_lock<boost::mutex> lock(mutex);
+    for (std::map<std::string, CacheEntry>::iterator it = cache.begin(); it != cache.end(); ++it)
+      deleteFactory(it->second.factory);
+    cache.clear();
+    lruList.clear();
+    cachedSize = 0;
+  }
+
+  bool LanguageFactory::isResident(const std::string& fname) const {
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return factories.find(fname) != factories.end() || cache.find(fname) != cache.end();
   }
 
 #ifdef GENEALOGY
@@ -99,27 +291,47 @@ namespace columbus { namespace dcf {
 #endif
 
   void LanguageFactory::release() {
+    boost::unique_lock<boost::mutex> lock(mutex);
     std::map<std::string, Factory*>::iterator iter=factories.begin();
     while (iter!=factories.end()) {
-      Factory* factory=(Factory*)(*iter).second;
-      delete &(factory->getStringTable());
-      delete factory;
+      unpin(iter->first, iter->second);
       iter++;
     }
     factories.clear();
     loaded=false;
+    trimCache(0);
+  }
+
+  void LanguageFactory::release(const std::string& fname) {
+    boost::unique_lock<boost::mutex> lock(mutex);
+    std::map<std::string, Factory*>::iterator iter=factories.find(fname);
+    if (iter == factories.end())
+      return;
+    unpin(iter->first, iter->second);
+    factories.erase(iter);
+    loaded=!factories.empty();
+    trimCache(0);
   }
 
   LanguageFactory& LanguageFactory::operator=(LanguageFactory& lf) {
     release();
+    boost::unique_lock<boost::mutex> lock(mutex);
+    boost::unique_lock<boost::mutex> lfLock(lf.mutex);
     factories=lf.factories;
     lf.factories.clear();
+    for (std::map<std::string, Factory*>::iterator it = factories.begin(); it != factories.end(); ++it) {
+      uint64_t size = lf.componentInfos[it->first].size;
+      componentInfos[it->first] = lf.componentInfos[it->first];
+      pinnedSize += size;
+      lf.pinnedSize -= size;
+    }
     loaded=lf.loaded;
     lf.loaded=false;
     return *this;
   }
 
   Factory* LanguageFactory::operator()(const std::string& component) {
+    boost::unique_lock<boost::mutex> lock(mutex);
     std::map<std::string, Factory*>::iterator iter=factories.find(component);
     if (iter!=factories.end())
       return (*iter).second;
@@ -129,24 +341,30 @@ namespace columbus { namespace dcf {
   std::size_t LanguageFactory::calculateHash(const Factory* factory, const std::string& name) {
     size_t hash = 0;
 #ifdef GENEALOGY
-    std::map<std::string, std::size_t>::const_iterator hashCodeIt =  hashCodes.find(name);
-    if(hashCodeIt != hashCodes.end()) {
-      return hashCodeIt->second;
+    {
+      boost::unique_lock<boost::mutex> lock(mutex);
+      std::map<std::string, std::size_t>::const_iterator hashCodeIt =  hashCodes.find(name);
+      if(hashCodeIt != hashCodes.end()) {
+        return hashCodeIt->second;
+      }
     }
     Factory::ConstIterator nodesIt = factory->constIterator();
     while(nodesIt.hasNext()) {
       const Base& node = nodesIt.next();
       boost::hash_combine(hash, node.getNodeKind());
     }
+    boost::unique_lock<boost::mutex> lock(mutex);
     hashCodes.insert(make_pair(name, hash));
 #endif
     return hash;
   }
 
   void LanguageFactory::loadComponentByComponentID( const std::string& componentID ) {
-
-
-    std::string& fileName = limComponentNameFileNameMap[componentID];
+    std::string fileName;
+    {
+      boost::unique_lock<boost::mutex> lock(mutex);
+      fileName = limComponentNameFileNameMap[componentID];
+    }
 
     loadComponent(fileName);
   }
@@ -158,6 +376,7 @@ namespace columbus { namespace dcf {
 
   std::string LanguageFactory::getFileNameByComponentId( const std::string& id )
   {
+    boost::unique_lock<boost::mutex> lock(mutex);
     std::map<std::string, std::string>::iterator it = limComponentNameFileNameMap.find(id);
     if (it != limComponentNameFileNameMap.end()) {
       return it->second;
@@ -33,6 +33,11 @@
 #include <lim/inc/visitors/Visitor.h>
 #include <boost/filesystem/path.hpp>
 #include <vector>
+#include <memory>
+#include <atomic>
+#include <common/inc/math/linear/block_assignment.h>
+#include <functional>
+#include <genealogy/inc/SegmentStore.h>
 
 using namespace common;
 #define ROOT_COMPONENT_NAME "<System>"
@@ -283,9 +288,9 @@ namespace columbus {
     }
     
     double DuplicatedCodeMiner::similarity(const columbus::genealogy::CloneInstance& from, const columbus::genealogy::CloneInstance& to) {
-      static unsigned long counter = 0;
+      static std::atomic<unsigned long> counterSequence(0);
       double inf=std::numeric_limits<double>::max();
-      ++counter;
+      unsigned long counter = ++counterSequence;
       DEBUGPRINTF(printf("[%lu]Similarity:%d -> %d:", counter, from.getId(), to.getId());)
 
       double dist = 0.0;
@@ -464,6 +469,211 @@ namespace columbus {
       return instances;
     }
 
+    namespace {
+
+      // Two instances can be similar only if these attributes are equal, otherwise the similarity
+      // exceeds the bound already by one of its terms, so only the instances with the same key are compared.
+      struct SimilarityKey {
+        unsigned headNodeKind;
+        unsigned rootLength;
+        unsigned ordinalNumber;
+        unsigned emptyAttributes;
+
+        bool operator<(const SimilarityKey& other) const {
+          if (headNodeKind != other.headNodeKind)
+            return headNodeKind < other.headNodeKind;
+          if (rootLength != other.rootLength)
+            return rootLength < other.rootLength;
+          if (ordinalNumber != other.ordinalNumber)
+            return ordinalNumber < other.ordinalNumber;
+          return emptyAttributes < other.emptyAttributes;
+        }
+      };
+
+      SimilarityKey getSimilarityKey(const genealogy::CloneInstance& instance) {
+        SimilarityKey key;
+        key.headNodeKind = instance.getCloneClass()->getHeadNodeKind();
+        key.rootLength = instance.getRootLength();
+        key.ordinalNumber = instance.getF2_OrdinalNumber();
+        key.emptyAttributes = (instance.getF3_HeadNodeUniqueName().empty() ? 1 : 0)
+                            | (instance.getPath().empty() ? 2 : 0)
+                            | (instance.getF4_AncestorUniqueName().empty() ? 4 : 0)
+                            | (instance.getF6_LexicalStructure().empty() ? 8 : 0);
+        return key;
+      }
+
+      struct SimilarityEdge {
+        unsigned last;       // index of the instance of the last system
+        unsigned current;    // index of the instance of the current system
+        double similarity;
+        SimilarityEdge(unsigned last, unsigned current, double similarity) : last(last), current(current), similarity(similarity) {}
+      };
+
+      // The components of the similarity graph having at most this many rows and columns are solved with the dense
+      // HungarianMethod as before. The larger ones are solved with the exact SparseAssignment, so the genealogy of
+      // the systems having such components can differ from the one computed by earlier versions.
+      const unsigned DENSE_ASSIGNMENT_LIMIT = 64;
+
+      template<class Func>
+      void forEachIndex(unsigned threads, size_t n, const Func& func) {
+        if (threads > 1)
+          columbus::thread::parallel_for(columbus::thread::Executor::global(), (size_t)0, n, (size_t)1, func);
+        else
+          for (size_t i = 0; i < n; ++i)
+            func(i);
+      }
+
+    }
+
+    namespace {
+
+      // Loads the next components of a sequential pass on the global executor, while the current one is visited.
+      class ComponentPrefetcher {
+      public:
+        ComponentPrefetcher(LanguageFactory& factory, const std::vector<std::string>& order, unsigned window)
+          : factory(factory)
+          , order(order)
+          , window(window)
+          , next(0)
+          , pending()
+        {}
+
+        ~ComponentPrefetcher() {
+          // the components loaded in vain are released
+          for (std::map<std::string, std::future<void> >::iterator it = pending.begin(); it != pending.end(); ++it) {
+            try {
+              it->second.get();
+              factory.release(it->first);
+            } catch (...) {
+              // the error is reported if the component is loaded again
+            }
+          }
+        }
+
+        // Loads the component (or takes the prefetched one) and starts loading the following ones.
+        void loadComponent(const std::string& fname, std::string* componentID = NULL) {
+          size_t position = std::find(order.begin() + next, order.end(), fname) - order.begin();
+          if (position < order.size()) {
+            next = position + 1;
+            for (size_t i = next; i < order.size() && i <= position + window; ++i) {
+              const std::string& ahead = order[i];
+              if (pending.find(ahead) == pending.end() && ahead != fname) {
+                LanguageFactory& languageFactory = factory;
+                pending.insert(std::make_pair(ahead, columbus::thread::Executor::global().submit([&languageFactory, ahead]() {
+                  languageFactory.loadComponent(ahead);
+                })));
+              }
+            }
+          }
+
+          std::map<std::string, std::future<void> >::iterator it = pending.find(fname);
+          if (it != pending.end()) {
+            std::future<void> loading = std::move(it->second);
+            pending.erase(it);
+            loading.get();
+          }
+          factory.loadComponent(fname, false, NULL, componentID);
+        }
+
+      private:
+        ComponentPrefetcher(const ComponentPrefetcher&);
+        ComponentPrefetcher& operator=(const ComponentPrefetcher&);
+
+        LanguageFactory& factory;
+        std::vector<std::string> order;
+        unsigned window;
+        size_t next;
+        std::map<std::string, std::future<void> > pending;
+      };
+
+      // The number of components loaded ahead of the sequential passes.
+      unsigned prefetchWindow() {
+        return config.threads > 1 ? config.threads : 0;
+      }
+
+    }
+
+    void DuplicatedCodeMiner::mapCloneInstances(const std::vector<genealogy::CloneInstance*>& instancesOfTheLastSystem, const std::vector<genealogy::CloneInstance*>& instancesOfTheCurrentSystem) {
+      // group the instances which are not connected yet by their similarity keys
+      typedef std::map<SimilarityKey, std::pair<std::vector<unsigned>, std::vector<unsigned> > > SimilarityBlockMap;
+      SimilarityBlockMap blocks;
+      for (unsigned i = 0; i < instancesOfTheLastSystem.size(); ++i) {
+        genealogy::CloneInstance* instance = instancesOfTheLastSystem[i];
+        if (instance->getNextIsEmpty() && !instance->getIsVirtual())
+          blocks[getSimilarityKey(*instance)].first.push_back(i);
+      }
+      for (unsigned j = 0; j < instancesOfTheCurrentSystem.size(); ++j) {
+        genealogy::CloneInstance* instance = instancesOfTheCurrentSystem[j];
+        if (instance->getPrevIsEmpty() && !instance->getIsVirtual())
+          blocks[getSimilarityKey(*instance)].second.push_back(j);
+      }
+
+      // compute the similarities inside the blocks only once, the infinite ones are not stored
+      std::vector<std::pair<unsigned, const std::vector<unsigned>*> > rows;
+      for (SimilarityBlockMap::const_iterator it = blocks.begin(); it != blocks.end(); ++it)
+        if (!it->second.second.empty())
+          for (std::vector<unsigned>::const_iterator rowIt = it->second.first.begin(); rowIt != it->second.first.end(); ++rowIt)
+            rows.push_back(std::make_pair(*rowIt, &it->second.second));
+
+      std::vector<std::vector<SimilarityEdge> > rowEdges(rows.size());
+      forEachIndex(config.threads, rows.size(), [&](size_t row) {
+        genealogy::CloneInstance& instanceOfTheLastSystem = *instancesOfTheLastSystem[rows[row].first];
+        const std::vector<unsigned>& cols = *rows[row].second;
+        for (std::vector<unsigned>::const_iterator colIt = cols.begin(); colIt != cols.end(); ++colIt) {
+          double sim = similarity(instanceOfTheLastSystem, *instancesOfTheCurrentSystem[*colIt]);
+          if (sim != std::numeric_limits<double>::max())
+            rowEdges[row].push_back(SimilarityEdge(rows[row].first, *colIt, sim));
+        }
+      });
+      SimilarityBlockMap().swap(blocks);
+      updateMemoryStat();
+
+      // connect the trivial pairs, every instance of the current system to the first identical one of the last system
+      std::vector<std::vector<unsigned> > identicalInstances(instancesOfTheCurrentSystem.size());
+      for (std::vector<std::vector<SimilarityEdge> >::const_iterator rowIt = rowEdges.begin(); rowIt != rowEdges.end(); ++rowIt)
+        for (std::vector<SimilarityEdge>::const_iterator it = rowIt->begin(); it != rowIt->end(); ++it)
+          if (it->similarity == 0.0)
+            identicalInstances[it->current].push_back(it->last);
+
+      for (unsigned j = 0; j < identicalInstances.size(); ++j) {
+        std::vector<unsigned>& candidates = identicalInstances[j];
+        std::sort(candidates.begin(), candidates.end());
+        for (std::vector<unsigned>::const_iterator it = candidates.begin(); it != candidates.end(); ++it) {
+          genealogy::CloneInstance* instanceOfTheLastSystem = instancesOfTheLastSystem[*it];
+          if (instanceOfTheLastSystem->getNextIsEmpty()) {
+            instanceOfTheLastSystem->addNext(instancesOfTheCurrentSystem[j]);
+            instancesOfTheCurrentSystem[j]->addPrev(instanceOfTheLastSystem);
+            trivial_pairs++;
+            break;
+          }
+        }
+      }
+      std::vector<std::vector<unsigned> >().swap(identicalInstances);
+      config.stat.numberOfTrivialPairs = trivial_pairs;
+
+      // the remaining instances and their similarities form a sparse bipartite graph,
+      // the optimal assignment is computed for its connected components independently
+      common::math::BlockAssignment<double> assignment(instancesOfTheLastSystem.size(), instancesOfTheCurrentSystem.size(), DENSE_ASSIGNMENT_LIMIT);
+      for (std::vector<std::vector<SimilarityEdge> >::iterator rowIt = rowEdges.begin(); rowIt != rowEdges.end(); ++rowIt) {
+        for (std::vector<SimilarityEdge>::const_iterator it = rowIt->begin(); it != rowIt->end(); ++it) {
+          if (!instancesOfTheLastSystem[it->last]->getNextIsEmpty() || !instancesOfTheCurrentSystem[it->current]->getPrevIsEmpty())
+            continue;
+          assignment.addEdge(it->last, it->current, it->similarity);
+        }
+        std::vector<SimilarityEdge>().swap(*rowIt);
+      }
+
+      std::map<unsigned int, unsigned int> pairs = assignment.solve([&](size_t n, const std::function<void(size_t)>& func) {
+        forEachIndex(config.threads, n, func);
+      });
+
+      // connect the pairs in the order of the instances of the current system
+      for (std::map<unsigned int, unsigned int>::const_iterator it = pairs.begin(); it != pairs.end(); ++it) {
+        instancesOfTheLastSystem[it->second]->addNext(instancesOfTheCurrentSystem[it->first]->getId());
+        instancesOfTheCurrentSystem[it->first]->addPrev(instancesOfTheLastSystem[it->second]->getId());
+      }
+    }
+
 #endif //GENEALOGY
 
 
@@ -613,6 +823,12 @@ namespace columbus {
     };
 
 
+    SuffixArray<int>* DuplicatedCodeMiner::createSuffixArray(Sequence<int>& sequence) const {
+      if(config.saisSuffixArray)
+        return new SaisSuffixArray<int>(sequence, config.threads > 1 ? &columbus::thread::Executor::global() : NULL);
+      return new LinearSuffixArray<int>(sequence);
+    }
+
     void DuplicatedCodeMiner::patternFilter() {
       if(config.patternMaxSingleLength == 0 || config.patternMinFullLength == 0)
         return;
@@ -625,8 +841,8 @@ namespace columbus {
       ppf.dcm = this;
       ppf.filteredNodes = &filteredNodes;
 
-      LinearSuffixArray<int> suffixArray(sequence);
-      LinearSuffixArray<int>::Duplicateiterator lduplicateIterator = suffixArray.iterator(1, config.patternMaxSingleLength, config.patternMinFullLength, false);
+      std::unique_ptr<SuffixArray<int> > suffixArray(createSuffixArray(sequence));
+      SuffixArray<int>::Duplicateiterator lduplicateIterator = suffixArray->iterator(1, config.patternMaxSingleLength, config.patternMinFullLength, false);
 
 
       lduplicateIterator.run(ppf);
@@ -662,16 +878,16 @@ namespace columbus {
 
       Sequence<int> sequence(nodeKindSequence);
 
-      LinearSuffixArray<int> suffixArray(sequence);
+      std::unique_ptr<SuffixArray<int> > suffixArray(createSuffixArray(sequence));
       common::WriteMsg::write(CMSG_CLONE_DETECTION_DONE_IN, common::getProcessUsedTime().user - time.user);
 
       common::WriteMsg::write(CMSG_GENERATING_CLONE_INSTANCES);
 
-      //LinearSuffixArray<int>::DuplicateIterator duplicateIterator = suffixArray.iterator(config.minAsgNodes, true);
-      //LinearSuffixArray<int>::CloneClass suffixCl;
+      //SuffixArray<int>::DuplicateIterator duplicateIterator = suffixArray->iterator(config.minAsgNodes, true);
+      //SuffixArray<int>::CloneClass suffixCl;
 
       time = common::getProcessUsedTime();
-      LinearSuffixArray<int>::Duplicateiterator lduplicateIterator = suffixArray.iterator( config.minAsgNodes, 0, 0, true);
+      SuffixArray<int>::Duplicateiterator lduplicateIterator = suffixArray->iterator( config.minAsgNodes, 0, 0, true);
 
       ProcessCC processCC;
 
@@ -1562,12 +1778,14 @@ namespace columbus {
       while (bp_iter!=config.bpaths.end()) {
         theCloneVisitor->addBlockPath((*bp_iter++));
       }
+      // the components are loaded ahead, but they are visited in order, as the blocked lines and lim nodes depend on it
+      ComponentPrefetcher prefetcher(currentFactory, std::vector<std::string>(config.files.begin(), config.files.end()), prefetchWindow());
       for  (std::list<std::string>::iterator fileIter=config.files.begin();fileIter!=config.files.end();fileIter++) {
         std::string fname=(*fileIter);
         std::string componenetID;
         common::WriteMsg::write(CMSG_LOADING,fname.c_str());
         try {
-          currentFactory.loadComponent(fname,false,NULL,&componenetID);
+          prefetcher.loadComponent(fname,&componenetID);
           if(createComponent) {
             // create component to genealogy
             columbus::genealogy::Component* componentRef=genealogyFact->createComponentNode();
@@ -1613,7 +1831,7 @@ namespace columbus {
 
         common::WriteMsg::write(CMSG_DONE_IN, common::getProcessUsedTime().user - time.user );
         updateMemoryStat();
-        currentFactory.release();
+        currentFactory.release(fname);
         common::WriteMsg::write(CMSG_DONE_D);
       }
 
@@ -1700,26 +1918,64 @@ namespace columbus {
         //compute connected edges
         NODE_EMBEDDEDNESS_VISITOR visitor(conectedEdgesMap,*this);
 
+        // Every component fills the connected edges of its own nodes only, so the components are visited in
+        // parallel, if their lim components differ. The aliases are merged in the order of the components,
+        // so the later ones overwrite the earlier ones as in a sequential run.
+        std::vector<std::map<std::string, std::set<NodeId> >::iterator> coveredComponents;
+        std::vector<NodeId> limComponentIds;
         for (std::map<std::string, std::set<NodeId> >::iterator itCoverages = coveredNodes.begin();itCoverages != coveredNodes.end();++itCoverages) {
-          currentFactory.loadComponentByComponentID(itCoverages->first);
-          LANGUAGE_NS::asg::Factory& factory = *currentFactory.getByComponentID(itCoverages->first);
+          coveredComponents.push_back(itCoverages);
+          limComponentIds.push_back(getLimComponenetIdByName(itCoverages->first,*limFact));
+        }
+        std::vector<NodeId> sortedLimComponentIds(limComponentIds);
+        std::sort(sortedLimComponentIds.begin(), sortedLimComponentIds.end());
+        bool distinctComponents = std::adjacent_find(sortedLimComponentIds.begin(), sortedLimComponentIds.end()) == sortedLimComponentIds.end();
+
+        std::vector<NODE_EMBEDDEDNESS_VISITOR::ConectedEdgesMap> componentEdges(coveredComponents.size());
+        std::vector<NODE_EMBEDDEDNESS_VISITOR::NodeAliasMap> componentAliases(coveredComponents.size());
+        forEachIndex(distinctComponents ? config.threads : 1, coveredComponents.size(), [&](size_t i) {
+          const std::string& componentName = coveredComponents[i]->first;
+          currentFactory.loadComponentByComponentID(componentName);
+          LANGUAGE_NS::asg::Factory& factory = *currentFactory.getByComponentID(componentName);
           factory.getReverseEdges();
           factory.turnFilterOff();
-          visitor.LimComponenetId(getLimComponenetIdByName(itCoverages->first,*limFact));
 
-          for (std::set<NodeId>::iterator itNodes = itCoverages->second.begin(); itNodes != itCoverages->second.end();++itNodes) {
+          NODE_EMBEDDEDNESS_VISITOR componentVisitor(distinctComponents ? componentEdges[i] : conectedEdgesMap, *this);
+          componentVisitor.LimComponenetId(limComponentIds[i]);
+          if (!distinctComponents)
+            componentVisitor.aliasMap.swap(visitor.aliasMap);
+
+          for (std::set<NodeId>::iterator itNodes = coveredComponents[i]->second.begin(); itNodes != coveredComponents[i]->second.end();++itNodes) {
             
-            (factory.getRef(*itNodes)).accept(visitor);
+            (factory.getRef(*itNodes)).accept(componentVisitor);
           }
-          currentFactory.release();
+
+          if (distinctComponents)
+            componentAliases[i].swap(componentVisitor.aliasMap);
+          else
+            visitor.aliasMap.swap(componentVisitor.aliasMap);
+          currentFactory.release(currentFactory.getFileNameByComponentId(componentName));
+        });
+
+        for (size_t i = 0; i < componentEdges.size(); ++i) {
+          for (NODE_EMBEDDEDNESS_VISITOR::ConectedEdgesMap::iterator it = componentEdges[i].begin(); it != componentEdges[i].end(); ++it) {
+            std::list<NODE_EMBEDDEDNESS_VISITOR::NodeWithWeight>& edges = conectedEdgesMap[it->first];
+            edges.splice(edges.begin(), it->second);
+          }
+          for (NODE_EMBEDDEDNESS_VISITOR::NodeAliasMap::const_iterator it = componentAliases[i].begin(); it != componentAliases[i].end(); ++it)
+            visitor.aliasMap[it->first] = it->second;
         }
+        std::vector<NODE_EMBEDDEDNESS_VISITOR::ConectedEdgesMap>().swap(componentEdges);
+        std::vector<NODE_EMBEDDEDNESS_VISITOR::NodeAliasMap>().swap(componentAliases);
 
         updateMemoryStat();
         WriteMsg::write(CMSG_BUILD_CE);
         
+        // the aliases found in a component are used by the following ones, so this pass is sequential
+        ComponentPrefetcher prefetcher(currentFactory, std::vector<std::string>(config.files.begin(), config.files.end()), prefetchWindow());
         for  (std::list<std::string>::iterator fileIter=config.files.begin();fileIter!=config.files.end();++fileIter) {
           std::string componenetID;
-          currentFactory.loadComponent(*fileIter,false,NULL,&componenetID);
+          prefetcher.loadComponent(*fileIter,&componenetID);
           LANGUAGE_NS::asg::Factory& factory = *currentFactory(*fileIter);
           visitor.LimComponenetId(getLimComponenetIdByName(componenetID,*limFact));
 
@@ -1736,7 +1992,7 @@ namespace columbus {
               }
             }
           }
-          currentFactory.release();
+          currentFactory.release(*fileIter);
         }
       }
 
@@ -1819,7 +2075,11 @@ namespace columbus {
         try {
           if (boost::filesystem::exists(genealogyFile)) {
             columbus::CsiHeader header;
-            genealogyFact->load(config.genealogyFilename, header);
+            if (config.segmentedGenealogy)
+              // Only the segment of the last system is needed for the evolution mapping
+              columbus::genealogy::SegmentStore(config.genealogyFilename).loadLast(*genealogyFact, header);
+            else
+              genealogyFact->load(config.genealogyFilename, header);
             // We should replace the string table to reset the internal bucket counters due to the enormous amount of delete operations
             columbus::RefDistributorStrTable* newStrTable = new RefDistributorStrTable();
             genealogyFact->swapStringTable(*newStrTable);
@@ -1868,21 +2128,36 @@ namespace columbus {
 
 
       vector<genealogy::CloneInstance*> instancesOfTheCurrentSystem = getInstancesOfaSystem(systemRef);
-      unsigned numberOfInstancesInTheRefSystem = instancesOfTheCurrentSystem.size();
 
       std::sort(instancesOfTheCurrentSystem.begin(), instancesOfTheCurrentSystem.end(), sortCloneInstancesByComponentId());
+      // the attributes of the instances are independent, so the components still in the memory are processed first
+      // (only the processing order is changed, the mapping needs the instances sorted by the components)
+      vector<genealogy::CloneInstance*> attributeOrder(instancesOfTheCurrentSystem);
+      std::stable_partition(attributeOrder.begin(), attributeOrder.end(), [this](const genealogy::CloneInstance* instance) {
+        return currentFactory.isResident(instance->getComponent()->getLocation());
+      });
       unsigned int prev = 0;
+      std::string prevLocation;
+
+      std::vector<std::string> componentOrder;
+      for (vector<genealogy::CloneInstance*>::const_iterator it = attributeOrder.begin(); it != attributeOrder.end(); ++it)
+        if (componentOrder.empty() || componentOrder.back() != (*it)->getComponent()->getLocation())
+          componentOrder.push_back((*it)->getComponent()->getLocation());
 
       // calculate the similarity attributes for all instances
-      for (vector<genealogy::CloneInstance*>::iterator currentInsatnceIt = instancesOfTheCurrentSystem.begin(); currentInsatnceIt != instancesOfTheCurrentSystem.end();++currentInsatnceIt) {
-        genealogy::CloneInstance* instanceOfTheCurentSystem = *currentInsatnceIt;
-        if(prev != instanceOfTheCurentSystem->getComponent()->getId()) {
-          prev = instanceOfTheCurentSystem->getComponent()->getId();
-          currentFactory.release();
-          currentFactory.loadComponent(instanceOfTheCurentSystem->getComponent()->getLocation(),true);
-          updateMemoryStat();
+      {
+        ComponentPrefetcher prefetcher(currentFactory, componentOrder, prefetchWindow());
+        for (vector<genealogy::CloneInstance*>::iterator currentInsatnceIt = attributeOrder.begin(); currentInsatnceIt != attributeOrder.end();++currentInsatnceIt) {
+          genealogy::CloneInstance* instanceOfTheCurentSystem = *currentInsatnceIt;
+          if(prev != instanceOfTheCurentSystem->getComponent()->getId()) {
+            prev = instanceOfTheCurentSystem->getComponent()->getId();
+            currentFactory.release(prevLocation);
+            prevLocation = instanceOfTheCurentSystem->getComponent()->getLocation();
+            prefetcher.loadComponent(prevLocation);
+            updateMemoryStat();
+          }
+          computeSimilarityAttributes(*instanceOfTheCurentSystem);
         }
-        computeSimilarityAttributes(*instanceOfTheCurentSystem);
       }
       currentFactory.release();
 
@@ -1895,101 +2170,8 @@ namespace columbus {
         unsigned numberOfInstancesInTheLastSystem = instancesOfTheLastSystem.size();
         config.stat.numberOfInstancesInTheLastSystem = numberOfInstancesInTheLastSystem;
 
-        for (vector<genealogy::CloneInstance*>::iterator currentInsatnceIt = instancesOfTheCurrentSystem.begin(); currentInsatnceIt != instancesOfTheCurrentSystem.end();++currentInsatnceIt) {
-          genealogy::CloneInstance* instanceOfTheCurentSystem = *currentInsatnceIt;
-
-          if (!instanceOfTheCurentSystem->getPrevIsEmpty() || instanceOfTheCurentSystem->getIsVirtual())
-            continue;
-
-          for (vector<genealogy::CloneInstance*>::iterator prevInsatnceIt = instancesOfTheLastSystem.begin(); prevInsatnceIt != instancesOfTheLastSystem.end();++prevInsatnceIt) {
-            genealogy::CloneInstance* instanceOfTheLastSystem = *prevInsatnceIt;
-
-            if (!instanceOfTheLastSystem->getNextIsEmpty() || instanceOfTheLastSystem->getIsVirtual())
-              continue;
-
-            double sim=similarity(*instanceOfTheLastSystem, *instanceOfTheCurentSystem);
-            if (sim==0.0) {
-              instanceOfTheLastSystem->addNext(instanceOfTheCurentSystem);
-              instanceOfTheCurentSystem->addPrev(instanceOfTheLastSystem);
-              trivial_pairs++;
-              break;
-            }
-          }
-        }
-
-        config.stat.numberOfTrivialPairs = trivial_pairs;
         try{
-          boost::numeric::ublas::matrix<double> m(numberOfInstancesInTheLastSystem - trivial_pairs, numberOfInstancesInTheRefSystem - trivial_pairs);
-
-          for (unsigned int q1=0; q1<m.size1(); q1++) {
-            for (unsigned int q2=0; q2<m.size2(); q2++) {
-              m(q1,q2)=std::numeric_limits<double>::max();
-            }
-          }
-
-          updateMemoryStat();
-
-          unsigned int row=0;
-          unsigned int col=0;
-          typedef boost::bimap<unsigned int, columbus::genealogy::CloneInstance*> IntCloneInstanceBimap;
-          typedef std::map<unsigned int, columbus::genealogy::CloneInstance*> IntCloneInstanceMap;
-
-          IntCloneInstanceMap row_map;
-          IntCloneInstanceBimap col_map;
-
-          for (vector<genealogy::CloneInstance*>::iterator prevInsatnceIt = instancesOfTheLastSystem.begin(); prevInsatnceIt != instancesOfTheLastSystem.end();++prevInsatnceIt) {
-            genealogy::CloneInstance* instanceOfTheLastSystem = *prevInsatnceIt;    
-
-            if (!instanceOfTheLastSystem->getNextIsEmpty() || instanceOfTheLastSystem->getIsVirtual())
-              continue;
-
-            row_map.insert(IntCloneInstanceMap::value_type(row, instanceOfTheLastSystem));
-
-            for (vector<genealogy::CloneInstance*>::iterator currentInsatnceIt = instancesOfTheCurrentSystem.begin(); currentInsatnceIt != instancesOfTheCurrentSystem.end();++currentInsatnceIt) {
-              genealogy::CloneInstance* instanceOfTheCurentSystem = *currentInsatnceIt;
-
-              if (!instanceOfTheCurentSystem->getPrevIsEmpty() || instanceOfTheCurentSystem->getIsVirtual())
-                continue;
-
-              IntCloneInstanceBimap::right_iterator leftIter=col_map.right.find(instanceOfTheCurentSystem);
-              unsigned int mycol = 0;
-              if (leftIter != col_map.right.end())
-                mycol = leftIter->second;
-              else {
-                col_map.insert(IntCloneInstanceBimap::value_type(col, instanceOfTheCurentSystem));
-                mycol = col;
-                col++;
-              }
-              double sim = similarity(*instanceOfTheLastSystem, *instanceOfTheCurentSystem);  // Ez mar egyszer ki lett szamolva! Lehet el kellene tarolni es nem megegyszer kiszamolni.
-              m(row, mycol) = sim;
-            }
-            row++;
-          }
-
-          updateMemoryStat();
-          boost::numeric::ublas::matrix<double> m_orig(m);
-          common::math::HungarianMethod<std::string, double> Hm(m_orig);
-          std::map<unsigned int, unsigned int> solution=Hm.solve(common::math::HungarianMethod<std::string, double>::INJECTIVE_KIND);
-          std::map<unsigned int, unsigned int>::iterator sol_iter=solution.begin();
-          unsigned int nontrivial_maps=0;
-          double overall_similarity=0.0;
-          while (sol_iter!=solution.end()) {
-            unsigned int second=(*sol_iter).first;
-            unsigned int first=(*sol_iter).second;
-            sol_iter++;
-            if (first>=m.size1() || second>=m.size2() || m(first,second)==numeric_limits<double>::max())
-              continue;
-            IntCloneInstanceMap::iterator iter1;
-            if ((iter1=row_map.find(first))==row_map.end())
-              continue;
-            IntCloneInstanceBimap::left_iterator iter2;
-            if ((iter2=col_map.left.find(second))==col_map.left.end())
-              continue;
-            (*iter1).second->addNext((*iter2).second->getId());
-            (*iter2).second->addPrev((*iter1).second->getId());
-            nontrivial_maps++;
-            overall_similarity+=m(first, second);
-          }
+          mapCloneInstances(instancesOfTheLastSystem, instancesOfTheCurrentSystem);
         }catch (std::bad_alloc&) {
           common::WriteMsg::write(CMSG_NOT_ENOUGH_MEMORY_TO_EVOLUTE);
         }
@@ -2221,32 +2403,60 @@ namespace columbus {
         return;
 
       common::WriteMsg::write(CMSG_COMPUTING_COVERAGE_AND_GENERATE_GRAPH_FORM_LIM);
-      std::string asg;
 
+      // the positions of the sequence grouped by their components in the order of their first occurrence
+      std::vector<std::pair<std::string, std::set<NodeId> > > components;
+      std::vector<std::vector<unsigned long> > componentPositions;
+      std::map<std::string, size_t> componentIndex;
       for (unsigned long l=0; l<nodeIdSequence.size(); l++) {
         ClonePositioned* px=nodeIdSequence[l];
-        if (px==NULL) {
+        if (px==NULL || px->getLimComponentId() == 0) {
           continue;
         }
 
-        if (px->getLimComponentId() != 0) {
-          std::string newASg=getAsgNameByLimId(px->getLimComponentId(),*limFact);
-          if (newASg!=asg) {
-            currentFactory.release();
-            currentFactory.loadComponentByComponentID(newASg);
-            coverageVisitor->setFactory(limFact, newASg, coveredNodes);
-            asg = newASg;
+        std::string asg=getAsgNameByLimId(px->getLimComponentId(),*limFact);
+        std::map<std::string, size_t>::iterator it = componentIndex.find(asg);
+        if (it == componentIndex.end()) {
+          it = componentIndex.insert(std::make_pair(asg, components.size())).first;
+          components.push_back(std::make_pair(asg, std::set<NodeId>()));
+          componentPositions.push_back(std::vector<unsigned long>());
+        }
+        components[it->second].second.insert(px->getLimComponentId());
+        componentPositions[it->second].push_back(l);
+      }
 
-            calculateCOOForLangASG (px->getLimComponentId(), newASg);
+      // the lim graph is only read by the visitors, so its lazy parts are created in advance
+      limFact->materializeAll();
+      limFact->getReverseEdges();
 
-            
-          }
+      // the counters are summed up, so the coverage does not depend on the order of the components
+      std::vector<COVERAGE_VISITOR*> componentVisitors(components.size(), NULL);
+      forEachIndex(config.threads, components.size(), [&](size_t i) {
+        const std::string& asg = components[i].first;
+        currentFactory.loadComponentByComponentID(asg);
+        Factory& factory = *currentFactory.getByComponentID(asg);
+
+        COVERAGE_VISITOR* componentVisitor = new COVERAGE_VISITOR();
+        componentVisitors[i] = componentVisitor;
+        componentVisitor->setFactory(limFact, asg, coveredNodes);
 
-          Base& node=currentFactory.getByComponentID(newASg)->getRef(px->getId());
+        for (std::set<NodeId>::const_iterator it = components[i].second.begin(); it != components[i].second.end(); ++it)
+          calculateCOOForLangASG(*it, factory);
 
-          coverageVisitor->setLimNodeId(px->getLimNodeId());
-          coverageVisitor->acceptNode(node);
+        for (std::vector<unsigned long>::const_iterator it = componentPositions[i].begin(); it != componentPositions[i].end(); ++it) {
+          ClonePositioned* px=nodeIdSequence[*it];
+          Base& node=factory.getRef(px->getId());
+
+          componentVisitor->setLimNodeId(px->getLimNodeId());
+          componentVisitor->acceptNode(node);
         }
+
+        currentFactory.release(currentFactory.getFileNameByComponentId(asg));
+      });
+
+      for (std::vector<COVERAGE_VISITOR*>::iterator it = componentVisitors.begin(); it != componentVisitors.end(); ++it) {
+        coverageVisitor->merge(**it);
+        delete *it;
       }
       common::WriteMsg::write(CMSG_COMPUTING_COVERAGE_DONE);
     }
@@ -2303,7 +2513,19 @@ namespace columbus {
 
       if (!config.genealogyFilename.empty()){
 
-        if (config.smallGenealogy) {
+        genealogy::SegmentStore::Links segmentLinks;
+        if (config.segmentedGenealogy) {
+          // The edges to the previous systems are saved beside the new segment, then only the current system is kept
+          genealogy::SegmentStore::collectLinks(*genealogyFact, currentSystem->getId(), segmentLinks);
+          std::list<NodeId> otherSystems;
+          for (genealogy::ListIterator<genealogy::System> it = genealogyFact->getRoot()->getSystemsListIteratorBegin(); it != genealogyFact->getRoot()->getSystemsListIteratorEnd(); ++it) {
+            if (&*it != currentSystem)
+              otherSystems.push_back(it->getId());
+          }
+          for (std::list<NodeId>::const_iterator it = otherSystems.begin(); it != otherSystems.end(); ++it)
+            genealogyFact->destroyNode(*it);
+          lastSystem = NULL;
+        } else if (config.smallGenealogy) {
           // Remove the last system
           if (lastSystem != NULL) {
             genealogyFact->destroyNode(lastSystem->getId());
@@ -2323,7 +2545,10 @@ namespace columbus {
         }
         common::WriteMsg::write(CMSG_SAVE_GENEALOGY);
         columbus::CsiHeader header;
-        genealogyFact->save(config.genealogyFilename, header);
+        if (config.segmentedGenealogy)
+          genealogy::SegmentStore(config.genealogyFilename).append(*genealogyFact, header, segmentLinks);
+        else
+          genealogyFact->save(config.genealogyFilename, header);
         common::WriteMsg::write(CMSG_DONE_D);
       }
 #endif
@@ -2851,7 +3076,7 @@ namespace columbus {
             limFact = new columbus::lim::asg::Factory(*strTable, "", columbus::lim::asg::limLangOther);
             std::list<HeaderData*> headerList;
             headerList.push_back(&limOrigin);
-            limFact->load(config.limFileName, headerList);
+            limFact->loadLazy(config.limFileName, headerList);
             limFact->initializeFilter();
 
             boost::filesystem::path f(config.limFileName);
@@ -3359,16 +3584,16 @@ namespace columbus {
     }
 
 
-    void DuplicatedCodeMiner::calculateCOOForLangASG( columbus::NodeId componenetId,const std::string& sCompId)
+    void DuplicatedCodeMiner::calculateCOOForLangASG( columbus::NodeId componenetId, Factory& factory)
     {
       for(genealogy::ListIterator<genealogy::CloneClass> cloneClassIt = currentSystem->getCloneClassesListIteratorBegin();cloneClassIt != currentSystem->getCloneClassesListIteratorEnd();++cloneClassIt) {
         columbus::genealogy::CloneClass& cc= (columbus::genealogy::CloneClass&) cloneClassIt->getFactory().getRef(  cloneClassIt->getId());
         if (cc.getIsVirtual())
           continue;
-        int length = lengths[cc.getId()];
+        int length = getLength(cc.getId());
         for(genealogy::ListIterator<genealogy::CloneInstance> cloneInstanceIt = cc.getItemsListIteratorBegin(); cloneInstanceIt != cc.getItemsListIteratorEnd();++cloneInstanceIt) {
           columbus::genealogy::CloneInstance& ci= (columbus::genealogy::CloneInstance&)cloneInstanceIt->getFactory().getRef(  cloneInstanceIt->getId());
-          int sequencePos = positions[ci.getId()] ;
+          int sequencePos = getPosition(ci.getId());
           const ClonePositioned* cp = getNode(sequencePos);
           if (cp->getLimComponentId() == componenetId){
             int cco = 0;
@@ -3377,7 +3602,7 @@ namespace columbus {
             for(int i = 0; i < length; ++i) {
               const ClonePositioned* position = getNode(sequencePos + i);
               if (position) {
-                Base& langNode = currentFactory.getByComponentID(sCompId)->getRef(position->getId());
+                Base& langNode = factory.getRef(position->getId());
                 if (position && coverageVisitor.isIncTheComplexity( langNode)){
                   cco++;
                 }
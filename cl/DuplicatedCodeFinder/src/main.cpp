@@ -93,6 +93,11 @@ static bool ppGenealogy (const Option *o, char *argv[]) {
   config.genealogyFilename = argv[0];
   return true;
 }
+
+static bool ppSegmentedGenealogy (const Option *o, char *argv[]) {
+  config.segmentedGenealogy = true;
+  return true;
+}
 #endif
 
 static void ppFile(char *filename) {
@@ -142,6 +147,27 @@ static bool  ppFst (const Option *o, char *argv[]) {
   return true;
 }
 
+static bool ppSuffixArray (const Option *o, char *argv[]) {
+  if (strcmp(argv[0], "sais") == 0)
+    config.saisSuffixArray = true;
+  else if (strcmp(argv[0], "dc3") == 0)
+    config.saisSuffixArray = false;
+  else
+    return false;
+  return true;
+}
+
+static bool ppThreads (const Option *o, char *argv[]) {
+  unsigned int value = boost::lexical_cast<unsigned int>(argv[0]);
+  config.threads = value > 0 ? value : 1;
+  return true;
+}
+
+static bool ppAsgCacheSize (const Option *o, char *argv[]) {
+  config.asgCacheSize = boost::lexical_cast<uint64_t>(argv[0]) * 1024 * 1024;
+  return true;
+}
+
 const common::Option OPTIONS_OBJ [] = {
   CL_LIM
   { false,  "-metrics",       0, "",                      0, OT_WC,    ppMetrics,      NULL,   "Calculate clone metrics."},
@@ -153,6 +179,7 @@ const common::Option OPTIONS_OBJ [] = {
 
 #ifdef GENEALOGY
   { false,  "-genealogy",      1, "filename",             0, OT_WC,    ppGenealogy,    NULL,    "The geneology while, which contains historical information about the clones."},
+  { false,  "-segmentedgenealogy", 0, "",                 0, OT_NONE,  ppSegmentedGenealogy, NULL, "The genealogy file is the index of a segmented genealogy. Only the segment of the last system is loaded, and the new system is appended as a new segment."},
 #endif
 
   { false, "-graph",           1, "filename",             0, OT_WC,    ppGraph,        NULL,   "Save structured result of the clones and metrics in binary graph format."},
@@ -162,6 +189,9 @@ const common::Option OPTIONS_OBJ [] = {
   { false,  "-multipleasgroot",      0, "",               0, OT_WC,    ppMultipleAsgRoot, NULL,"Clone instances can have multiple ASG root."},
   { false,  "-onlyfunctionclone",    0, "",               0, OT_WC,    ppFc,              NULL,"Clones are detected only inside the functions."},
   { false,  "-statementNotReq",      0, "",               0, OT_WC,    ppFst,             NULL,"Not filter clone instance which has not contained statement."},
+  { false,  "-suffixarray",          1, "sais|dc3",       0, OT_WC,    ppSuffixArray,     NULL,"The algorithm building the suffix array of the serialized ASG. The default value is sais."},
+  { false,  "-threads",              1, "number",         0, OT_WC,    ppThreads,         NULL,"Sets the number of threads used by the clone detection. The default value is 1."},
+  { false,  "-asgcachesize",         1, "MByte",          0, OT_WC,    ppAsgCacheSize,    NULL,"The memory budget of the loaded component ASGs kept between the passes of the detection. 0 disables the cache. The default value is 1024."},
   CL_RUL_AND_RULCONFIG("DCF.rul")
   CL_EXPORTRUL
   CL_INPUT_LIST
@@ -264,6 +294,7 @@ int main(int argc, char* argv[]){
    
   setStartTime(&time);
   initValues();
+  columbus::thread::Executor::setGlobalConcurrency(config.threads);
   
   /**
   * Checking whether config file exists
@@ -340,6 +371,10 @@ int main(int argc, char* argv[]){
   WriteMsg::write(CMSG_STATISTICS);
   WriteMsg::write(CMSG_DETECTING_TIME, time);
   WriteMsg::write(CMSG_PEAK_MEMORY_USAGE, config.stat.memory_peak / (1024 * 1024));
+  unsigned int asgLoads = config.stat.asgCacheHits + config.stat.asgCacheMisses;
+  WriteMsg::write(CMSG_ASG_CACHE_HITS, config.stat.asgCacheHits, asgLoads, asgLoads ? config.stat.asgCacheHits * 100 / asgLoads : 0);
+  WriteMsg::write(CMSG_ASG_LOAD_TIME, config.stat.asgLoadTime);
+  WriteMsg::write(CMSG_ASG_LOAD_TIME_SAVED, config.stat.asgLoadTimeSaved);
 
 
   MAIN_END
@@ -51,6 +51,7 @@ ResultConverter::ResultConverter(const std::string& limFileName, const std::stri
   loadFilter(limFactory, limFileName, ".flim");
   lim2graph::convertBaseGraph(limFactory, graph, true, true, true, true, false);
   graphIndexer.turnOn(graph);
+  graphsupport::GraphWarningIndexer::getGraphWarningIndexerInstance().turnOn(graph);
   if(exportRul) {
     graphsupport::buildRulToGraph(graph, rulHandler);
   }
@@ -91,6 +91,7 @@ void ResultConverter::buildtree(const bool exportRul) {
   
   lim2graph::convertBaseGraph(limFact, graph, /*edges=*/ true, /*attributes=*/ true, /*components=*/ true, /*variants=*/ false, /*instances=*/ false);
   graphIndexer.turnOn(graph);
+  graphsupport::GraphWarningIndexer::getGraphWarningIndexerInstance().turnOn(graph);
   if (exportRul)
     graphsupport::buildRulToGraph(graph, *xRulhandler);
 }
@@ -88,6 +88,7 @@ void ReportConverter::buildtree(const bool exportRul) {
 	lim2graph::convertBaseGraph(limFact, graph, /*edges=*/ true, /*attributes=*/ true, /*components=*/ true, /*variants=*/ false, /*instances=*/ false);
 
 	graphIndexer.turnOn(graph);
+	GraphWarningIndexer::getGraphWarningIndexerInstance().turnOn(graph);
 	if (exportRul)
 		buildRulToGraph(graph, *xRulhandler);
 }
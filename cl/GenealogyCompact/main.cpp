@@ -0,0 +1,113 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#define PROGRAM_NAME "GenealogyCompact"
+#define EXECUTABLE_NAME "GenealogyCompact"
+
+#include <MainCommon.h>
+#include <boost/lexical_cast.hpp>
+
+#include "messages.h"
+#include <genealogy/inc/genealogy.h>
+#include <genealogy/inc/SegmentStore.h>
+#include "common/inc/Arguments.h"
+
+using namespace std;
+using namespace common;
+using namespace columbus;
+using namespace columbus::genealogy;
+
+static string indexFilename;
+static string importFilename;
+static string exportFilename;
+static unsigned keep = 1;
+
+static void ppFile(char *filename) {
+  indexFilename = filename;
+}
+
+static bool ppKeep(const Option *o, char *argv[]) {
+  keep = boost::lexical_cast<unsigned>(argv[0]);
+  return true;
+}
+
+static bool ppImport(const Option *o, char *argv[]) {
+  importFilename = argv[0];
+  return true;
+}
+
+static bool ppExport(const Option *o, char *argv[]) {
+  exportFilename = argv[0];
+  return true;
+}
+
+const Option OPTIONS_OBJ [] = {
+  { false,  "-keep",        1, "number",        0, OT_WC,    ppKeep,            NULL, "The number of the newest segments which are not compacted. The default value is 1, so the segment of the last system stays small for the next analysis."},
+  { false,  "-import",      1, "filename",      0, OT_WC,    ppImport,          NULL, "Appends the given single file genealogy to the empty segment index as its first segment."},
+  { false,  "-export",      1, "filename",      0, OT_WC,    ppExport,          NULL, "Saves all the systems of the segmented genealogy into the given single file genealogy."},
+  COMMON_CL_ARGS
+};
+
+int main(int argc, char** argv) {
+  MAIN_BEGIN
+
+    MainInit(argc, argv, "-");
+
+    if (indexFilename.empty()) {
+      WriteMsg::write(CMSG_NO_INPUT_FILE);
+      clError();
+    }
+
+    SegmentStore store(indexFilename);
+
+    if (!importFilename.empty()) {
+      if (store.getSegmentCount() != 0) {
+        WriteMsg::write(CMSG_IMPORT_INTO_NONEMPTY);
+        clError();
+      }
+      WriteMsg::write(CMSG_IMPORT_FILE, importFilename.c_str());
+      RefDistributorStrTable strTable;
+      Factory factory(strTable);
+      CsiHeader header;
+      factory.load(importFilename, header);
+      store.append(factory, header, SegmentStore::Links());
+    }
+
+    unsigned segmentCount = store.getSegmentCount();
+    if (segmentCount > keep + 1) {
+      WriteMsg::write(CMSG_COMPACT_SEGMENTS, segmentCount - keep, segmentCount);
+      store.compact(segmentCount - keep);
+    } else {
+      WriteMsg::write(CMSG_NOTHING_TO_COMPACT, segmentCount);
+    }
+
+    if (!exportFilename.empty()) {
+      WriteMsg::write(CMSG_EXPORT_FILE, exportFilename.c_str());
+      RefDistributorStrTable strTable;
+      Factory factory(strTable);
+      store.merge(factory);
+      CsiHeader header;
+      factory.save(exportFilename, header);
+    }
+
+  MAIN_END
+
+  return 0;
+}
@@ -0,0 +1,32 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _GENEALOGYCOMPACT_MESSAGES_H
+#define _GENEALOGYCOMPACT_MESSAGES_H
+
+//main.cpp messages
+#define CMSG_NO_INPUT_FILE          common::WriteMsg::mlError,    "Error: No segment index was specified\n"
+#define CMSG_IMPORT_INTO_NONEMPTY   common::WriteMsg::mlError,    "Error: A genealogy can be imported only into an empty segment index\n"
+#define CMSG_IMPORT_FILE            common::WriteMsg::mlNormal,   "Importing: %s\n"
+#define CMSG_COMPACT_SEGMENTS       common::WriteMsg::mlNormal,   "Compacting %u segments of %u\n"
+#define CMSG_NOTHING_TO_COMPACT     common::WriteMsg::mlNormal,   "Nothing to compact (%u segments)\n"
+#define CMSG_EXPORT_FILE            common::WriteMsg::mlNormal,   "Exporting: %s\n"
+
+#endif
@@ -58,6 +58,10 @@ static bool ppSaveXML (const common::Option *o, char *argv[]) {
   return true;
 }
 
+static void mergeFile(const string& filename, void* data) {
+  WriteMsg::write(CMSG_MERGE_FILE, filename.c_str());
+}
+
 const Option OPTIONS_OBJ [] = {
   { false,  "-out",         1, "filename",      1, OT_WC,    ppOut,             NULL, "The merged output graph."},
   { false,  "-dumpxml",     0, "",              0, OT_NONE,  ppSaveXML,         NULL, "Dump the graph in xml format."},
@@ -81,10 +85,8 @@ int main(int argc, char** argv) {
     Graph g;
     WriteMsg::write(CMSG_LOAD_FILE, files[0].c_str());
     g.loadBinary(files[0]);
-    for (size_t i = 1; i < files.size(); ++i) {
-      WriteMsg::write(CMSG_MERGE_FILE, files[i].c_str());
-      g.mergeWithBinary(files[i], Graph::mmUnionAttribute, Graph::csmmUnionNewAttributes, Graph::nmmSummarizeAttributes, Graph::mmUnionAttribute, Graph::csmmUnionNewAttributes, Graph::nmmSummarizeAttributes);
-    }
+    g.mergeWithBinary(vector<string>(files.begin() + 1, files.end()), Graph::mmUnionAttribute, Graph::csmmUnionNewAttributes, Graph::nmmSummarizeAttributes,
+      Graph::mmUnionAttribute, Graph::csmmUnionNewAttributes, Graph::nmmSummarizeAttributes, 0, mergeFile, NULL);
     summarizeWarningMetricsByPriority(g, true); 
 
     WriteMsg::write(CMSG_SAVE_FILE, out.c_str());
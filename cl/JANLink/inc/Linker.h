@@ -25,6 +25,7 @@
 #include <list>
 #include <java/inc/java.h>
 #include <common/inc/DirectoryFilter.h>
+#include "LinkerHelper.h"
 
 class Linker
 {
@@ -36,7 +37,7 @@ public:
     JANLinkStat() : inputFiles(0), peakMemory(0), linkingTime(0) {}
     unsigned long inputFiles;
     uint64_t        peakMemory;
-    unsigned long linkingTime;
+    unsigned long linkingTime;      // Wall-clock time of loading and linking the input ASGs in milliseconds
   };
 
   Linker(std::string OutputPath,
@@ -47,13 +48,15 @@ public:
          bool filterRefl,
          bool safemode,
          JANLinkStat& janlinkStat,
-         std::string changesetID);
+         std::string changesetID,
+         unsigned threads = 1);
   ~Linker();
   common::ErrorCode link(std::list<std::string>&);
   columbus::java::asg::Factory* getFactory();
 
 private:
   common::ErrorCode loadASG(std::list<std::string>&);
+  common::ErrorCode loadASGParallel(std::list<std::string>&, columbus::java::linker::UniqueMap&, columbus::java::linker::StrNodeIdMap&);
   common::ErrorCode saveASG();
 
   void saveJML();
@@ -75,6 +78,8 @@ private:
 
   std::string _changesetID;
 
+  unsigned _threads;              // Number of threads loading the input ASGs (1: sequential loading)
+
 };
 
 extern const std::string jmlext;
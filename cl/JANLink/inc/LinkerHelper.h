@@ -22,6 +22,7 @@
 #define _JAVA_LINKERHELPER_H_
 
 #include <java/inc/java.h>
+#include <strtable/inc/ConcurrentStrTable.h>
 
 
 namespace columbus { namespace java { namespace linker {
@@ -68,20 +69,37 @@ namespace columbus { namespace java { namespace linker {
 
       virtual ~LinkerHelper();
 
+      /**
+      * \brief Computes the unique strings of the nodes of the given ASG which are looked up during its linking.
+      *        It only reads the ASG, so it can run on a worker thread while an other ASG is linked.
+      * \param fact  [in]  The input ASG.
+      * \param names [in]  The strings are interned into this table, it can be shared by several threads.
+      * \param keys  [out] The keys of the unique strings indexed by the node ids (0 if it is not computed).
+      */
+      static void collectUniqueStrings(const columbus::java::asg::Factory& fact, ConcurrentStrTable& names, std::vector<Key>& keys);
+
+      /**
+      * \brief Sets the unique strings computed in advance by collectUniqueStrings() for the nodes of the linked ASG.
+      */
+      void setUniqueStrings(const ConcurrentStrTable& names, const std::vector<Key>& keys);
+
     protected:
 
       virtual NodeId remap(NodeId oldId);
       void storeUniqueString(const columbus::java::asg::base::Base& node);
-      bool getIsNeeded(const columbus::java::asg::base::Base& node);
+      static bool getIsNeeded(const columbus::java::asg::base::Base& node);
       bool needToStorePath(const columbus::java::asg::base::Base& node);
-      std::string getPositionString(const columbus::java::asg::base::Base& node, bool withLineInfo = false);
+      static std::string getPositionString(const columbus::java::asg::base::Base& node, bool withLineInfo = false);
       std::string getUniqueString(const columbus::java::asg::base::Base& node);
+      static std::string computeUniqueString(const columbus::java::asg::base::Base& node);
 
     protected:
 
       UniqueMap& strMap;
       StrNodeIdMap& pathMap;
       NodeId create;
+      const ConcurrentStrTable* uniqueStrings;    // The unique strings computed in advance (if any)
+      const std::vector<Key>* uniqueStringKeys;   // Their keys indexed by the node ids
   };
 
 }}}
@@ -35,6 +35,10 @@
 #define CMSG_LOAD_HEADER            WriteMsg::mlNormal, "Loading ASG header: \"%s\"\n"
 #define CMSG_SKIP_DUPLICATE         WriteMsg::mlNormal, "Skipping duplicated ASG \"%s\" (timestamp: \"%s\", previous ASG: \"%s\")\n"
 #define CMSG_SAVING_NEW_LIST        WriteMsg::mlNormal, "Saving new list file: \"%s\"\n"
+#define CMSG_STATISTICS             WriteMsg::mlNormal, "\nStatistics:\n"
+#define CMSG_STAT_INPUT_FILES       WriteMsg::mlNormal, "\tNumber of input files  : %10lu\n"
+#define CMSG_STAT_LINKING_TIME      WriteMsg::mlNormal, "\tLinking time           : %10.2fs\n"
+#define CMSG_STAT_PEAK_MEMORY       WriteMsg::mlNormal, "\tPeak memory usage      : %10.2fMB\n"
 
 //WARNING messages
 #define CMSG_CANNOT_OPEN_FILE       WriteMsg::mlWarning, "Warning: Cannot open file: \"%s\"\n"
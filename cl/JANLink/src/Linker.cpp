@@ -30,6 +30,13 @@
 #include "../inc/VisitorStrMap.h"
 #include "../inc/VisitorLinker.h"
 #include "boost/date_time/posix_time/posix_time.hpp"
+#include <boost/bind.hpp>
+#include <boost/exception_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <deque>
 
 using namespace std;
 using namespace common;
@@ -49,6 +56,134 @@ static boost::posix_time::time_duration::tick_type milliseconds_since_epoch() {
   return (microsec_clock::universal_time() - epoch).total_milliseconds();
 }
 
+namespace {
+
+  /**
+  * \brief Loads the input ASGs on worker threads ahead of the linking.
+  *        The workers also compute the unique strings of the nodes, which are interned into a table shared by them.
+  *        The ASGs are given back in the order they were added, so the linking (and its result)
+  *        is the same as with the sequential loading.
+  */
+  class ASGPrefetcher {
+  public:
+
+    /**
+    * \brief An input ASG loaded into its own factory.
+    */
+    struct LoadedASG {
+      LoadedASG(const std::string& path) : path(path), stt(), fact(stt), header(), uniqueStringKeys(), done(false), failed(false), error() {}
+      std::string path;
+      columbus::RefDistributorStrTable stt;
+      columbus::java::asg::Factory fact;
+      CsiHeader header;
+      std::vector<Key> uniqueStringKeys; // The keys of the unique strings of the nodes in the shared table
+      bool done;                  // The loading is finished
+      bool failed;                // The file cannot be opened
+      boost::exception_ptr error; // Any other error of the loading
+    };
+
+    typedef boost::shared_ptr<LoadedASG> PtrLoadedASG;
+
+    ASGPrefetcher(unsigned threads) : uniqueStrings(), mutex(), cond(), waiting(), pending(), stopped(false), workers() {
+      for (unsigned i = 0; i < threads; ++i)
+        workers.create_thread(boost::bind(&ASGPrefetcher::work, this));
+    }
+
+    ~ASGPrefetcher() {
+      {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        stopped = true;
+      }
+      cond.notify_all();
+      workers.join_all();
+    }
+
+    // Adds a file to the end of the loading queue.
+    void add(const std::string& path) {
+      PtrLoadedASG asg(new LoadedASG(path));
+      {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        waiting.push_back(asg);
+        pending.push_back(asg);
+      }
+      cond.notify_all();
+    }
+
+    // The number of the files which are added but not taken yet.
+    size_t size() {
+      boost::unique_lock<boost::mutex> lock(mutex);
+      return pending.size();
+    }
+
+    // Waits for the loading of the oldest added file and gives it back.
+    PtrLoadedASG next() {
+      boost::unique_lock<boost::mutex> lock(mutex);
+      PtrLoadedASG asg = pending.front();
+      pending.pop_front();
+      while (!asg->done)
+        cond.wait(lock);
+      return asg;
+    }
+
+    // The unique strings of the nodes of all the loaded ASGs.
+    const columbus::ConcurrentStrTable& getUniqueStrings() const {
+      return uniqueStrings;
+    }
+
+  private:
+
+    void work() {
+      while (true) {
+        PtrLoadedASG asg;
+        {
+          boost::unique_lock<boost::mutex> lock(mutex);
+          while (!stopped && waiting.empty())
+            cond.wait(lock);
+          if (stopped)
+            return;
+          asg = waiting.front();
+          waiting.pop_front();
+        }
+
+        try {
+          asg->fact.load(asg->path, asg->header);
+          LinkerHelper::collectUniqueStrings(asg->fact, uniqueStrings, asg->uniqueStringKeys);
+        } catch (IOException&) {
+          asg->failed = true;
+        } catch (...) {
+          asg->error = boost::current_exception();
+        }
+
+        {
+          boost::unique_lock<boost::mutex> lock(mutex);
+          asg->done = true;
+        }
+        cond.notify_all();
+      }
+    }
+
+    columbus::ConcurrentStrTable uniqueStrings;
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    std::deque<PtrLoadedASG> waiting;  // The files whose loading is not started yet
+    std::deque<PtrLoadedASG> pending;  // The files which are not taken yet (in the order they were added)
+    bool stopped;
+    boost::thread_group workers;
+  };
+
+}
+
+static void linkASG(columbus::java::asg::Factory& fact, columbus::java::asg::Factory& tmpFact, UniqueMap& strmap, StrNodeIdMap& pathMap, bool safemode,
+                    const columbus::ConcurrentStrTable* uniqueStrings = NULL, const std::vector<Key>* uniqueStringKeys = NULL) {
+  VisitorLinker vlinker(strmap, pathMap, fact, tmpFact);
+  if (uniqueStrings)
+    vlinker.setUniqueStrings(*uniqueStrings, *uniqueStringKeys);
+  columbus::java::asg::AlgorithmPreorder algPre;
+  if (safemode)
+    algPre.setSafeMode();
+  algPre.run(tmpFact,vlinker);
+}
+
 Linker::Linker(std::string OutputPath,
                std::string OutputFilterPath,
                bool bDumpJML,
@@ -57,7 +192,8 @@ Linker::Linker(std::string OutputPath,
                bool filterRefl,
                bool safemode,
                JANLinkStat& janlinkStat,
-               std::string changesetID)
+               std::string changesetID,
+               unsigned threads)
   : filter(filter),
     filterRefl(filterRefl),
     _OutputPath(OutputPath),
@@ -68,7 +204,8 @@ Linker::Linker(std::string OutputPath,
     _stt(0),
     _fact(0),
     janlinkStat(janlinkStat),
-    _changesetID(changesetID)
+    _changesetID(changesetID),
+    _threads(threads)
 {
   updateMemoryStat();
 }
@@ -92,7 +229,9 @@ ErrorCode Linker::link(std::list<std::string>& csiList) {
   ErrorCode ec = retLinkingOK;
   ErrorCode save_ec;
 
+  boost::posix_time::time_duration::tick_type start = milliseconds_since_epoch();
   ec = loadASG(csiList);
+  janlinkStat.linkingTime = (unsigned long)(milliseconds_since_epoch() - start);
 
   save_ec = saveASG();
   if (ec == retASGLoadOK)
@@ -130,6 +269,9 @@ ErrorCode Linker::loadASG(std::list<std::string>& JSIList) {
 
   updateMemoryStat();
 
+  if (_threads > 1)
+    return loadASGParallel(JSIList, _strmap, _pathMap);
+
   std::set<std::string> extraAsgs;
   for (std::list<std::string>::iterator i = JSIList.begin(); i != JSIList.end(); ++i) {
     WriteMsg::write(CMSG_LOAD_FILE, i->c_str());
@@ -159,11 +301,56 @@ ErrorCode Linker::loadASG(std::list<std::string>& JSIList) {
 
     janlinkStat.inputFiles++;
 
-    VisitorLinker vlinker(_strmap, _pathMap, *_fact, tmpFact);
-    columbus::java::asg::AlgorithmPreorder algPre;
-    if (_safemode)
-      algPre.setSafeMode();
-    algPre.run(tmpFact,vlinker);
+    linkASG(*_fact, tmpFact, _strmap, _pathMap, _safemode);
+
+    updateMemoryStat();
+  }
+
+  return ec;
+}
+
+ErrorCode Linker::loadASGParallel(std::list<std::string>& JSIList, UniqueMap& strmap, StrNodeIdMap& pathMap) {
+  ErrorCode ec = retASGLoadOK;
+
+  // At most this many ASGs are loaded in advance, which limits the extra memory usage.
+  const size_t prefetchLimit = 2 * _threads;
+
+  ASGPrefetcher prefetcher(_threads);
+  std::set<std::string> extraAsgs;
+
+  // The extra ASGs are appended to the list during the linking, so the last queued element is stored instead of the next one.
+  std::list<std::string>::iterator lastQueued = JSIList.begin();
+  prefetcher.add(*lastQueued);
+
+  for (std::list<std::string>::iterator i = JSIList.begin(); i != JSIList.end(); ++i) {
+    std::list<std::string>::iterator nextToQueue = lastQueued;
+    while (++nextToQueue != JSIList.end() && prefetcher.size() < prefetchLimit) {
+      prefetcher.add(*nextToQueue);
+      lastQueued = nextToQueue;
+    }
+
+    ASGPrefetcher::PtrLoadedASG asg = prefetcher.next();
+    WriteMsg::write(CMSG_LOAD_FILE, i->c_str());
+
+    if (asg->error)
+      boost::rethrow_exception(asg->error);
+
+    if (asg->failed) {
+      WriteMsg::write(CMSG_CANNOT_OPEN_FILE, i->c_str());
+      ec = retASGLoadWarning;
+      continue;
+    }
+
+    //adding the extra jsi to the input list
+    std::string extra;
+    if (asg->header.get("ExtraAsg", extra)) {
+      if (extraAsgs.insert(extra).second)
+        JSIList.push_back(extra);
+    }
+
+    janlinkStat.inputFiles++;
+
+    linkASG(*_fact, asg->fact, strmap, pathMap, _safemode, &prefetcher.getUniqueStrings(), &asg->uniqueStringKeys);
 
     updateMemoryStat();
   }
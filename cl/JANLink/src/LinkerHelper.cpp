@@ -63,13 +63,36 @@ UniqueMap::UniqueMap() :
 }
 
 LinkerHelper::LinkerHelper(UniqueMap& strMap, StrNodeIdMap& pathMap)
-  : strMap(strMap), pathMap(pathMap), create(0)
+  : strMap(strMap), pathMap(pathMap), create(0), uniqueStrings(NULL), uniqueStringKeys(NULL)
 {
 }
 
 LinkerHelper::~LinkerHelper() {
 }
 
+void LinkerHelper::collectUniqueStrings(const Factory& fact, ConcurrentStrTable& names, std::vector<Key>& keys) {
+  keys.assign(fact.size(), 0);
+  for (NodeId id = 0; id < fact.size(); ++id) {
+    if (!fact.getExist(id))
+      continue;
+
+    const base::Base& node = *fact.getPointer(id);
+    if (!getIsNeeded(node) && !Common::getIsComment(node) && !Common::getIsType(node))
+      continue;
+
+    try {
+      keys[id] = names.set(computeUniqueString(node));
+    } catch (const columbus::Exception&) {
+      // the string is computed again if the node is linked, which reports the error
+    }
+  }
+}
+
+void LinkerHelper::setUniqueStrings(const ConcurrentStrTable& names, const std::vector<Key>& keys) {
+  uniqueStrings = &names;
+  uniqueStringKeys = &keys;
+}
+
 NodeId LinkerHelper::remap(NodeId oldId) {
   return oldId;
 }
@@ -156,6 +179,15 @@ std::string LinkerHelper::getPositionString(const columbus::java::asg::base::Bas
 }
 
 std::string LinkerHelper::getUniqueString(const columbus::java::asg::base::Base& node) {
+  if (uniqueStringKeys && node.getId() < uniqueStringKeys->size()) {
+    Key key = (*uniqueStringKeys)[node.getId()];
+    if (key)
+      return uniqueStrings->get(key);
+  }
+  return computeUniqueString(node);
+}
+
+std::string LinkerHelper::computeUniqueString(const columbus::java::asg::base::Base& node) {
   switch (node.getNodeKind()) {
     case ndkCompilationUnit:
       return dynamic_cast<const struc::CompilationUnit&>(node).getPosition().getPath();
@@ -40,6 +40,7 @@ using namespace columbus;
 static std::string out, outflt, lst, mem, fltp, check;
 static bool filterRefl = false;
 static bool safemode = false;
+static unsigned threads = 1;
 
 static std::list<std::string> files;
 // <---------------------
@@ -79,6 +80,12 @@ static bool ppMem (const Option *o, char *argv[]) {
   return true;
 }
 
+static bool ppThreads (const Option *o, char *argv[]) {
+  int value = atoi(argv[0]);
+  threads = value > 0 ? value : 1;
+  return true;
+}
+
 static bool ppCheck (const Option *o, char *argv[]) {
   check = argv[0];
   return true;
@@ -91,6 +98,7 @@ static void ppFile(char *filename) {
 const Option OPTIONS_OBJ [] = {
   { false,  "-out",           1,   "filename",              0, OT_WC,      ppOut,            NULL,   "The linked ASG file."},
   { false,  "-maxmem",        1,   "number",                0, OT_WC,      ppMem,            NULL,   "Sets the maximum memory usage in MB."},
+  { false,  "-threads",        1,   "number",                0, OT_WC,      ppThreads,        NULL,   "Sets the number of threads loading the input ASGs and computing the unique names of their nodes in parallel with the linking. The default value is 1 (sequential loading)."},
   { false,  "-checklist",     1,   "filename",              0, OT_WC,      ppCheck,          NULL,   "Output list file. Delete the same ASG's from the original list (uses timestamps of the graph headers)."},
   CL_REFLECTION_FILTER
   CL_SAFEMODE
@@ -242,11 +250,16 @@ int main(int argc, char *argv[]) {
     }
 
     Linker::JANLinkStat janlinkStat;
-    Linker linker(out, outflt, false, mem, filter, filterRefl, safemode, janlinkStat, "");
+    Linker linker(out, outflt, false, mem, filter, filterRefl, safemode, janlinkStat, "", threads);
     ec = linker.link(files);
     if (ec == common::retLinkingOK)
       ec = retOk;
 
+    WriteMsg::write(CMSG_STATISTICS);
+    WriteMsg::write(CMSG_STAT_INPUT_FILES, janlinkStat.inputFiles);
+    WriteMsg::write(CMSG_STAT_LINKING_TIME, janlinkStat.linkingTime / 1000.0);
+    WriteMsg::write(CMSG_STAT_PEAK_MEMORY, janlinkStat.peakMemory / (1024.0 * 1024.0));
+
   MAIN_END
 
   return ec;
@@ -64,6 +64,7 @@ static string rulConfig;
 static bool pathLower = false;
 static bool exportRul = false;
 static char csvSeparator = ',';
+static unsigned threads = 1;
 static list<string> inputFiles;
 
 static bool ppGraph( const common::Option *o, char *argv[] ) {
@@ -96,6 +97,12 @@ static bool ppRulConfig( const common::Option *o, char *argv[] ) {
   return true;
 }
 
+static bool ppThreads( const common::Option *o, char *argv[] ) {
+  int value = atoi( argv[0] );
+  threads = value > 0 ? value : 1;
+  return true;
+}
+
 static void ppFile( char *filename ) {
   inputFiles.push_back( filename );
 }
@@ -116,6 +123,7 @@ const common::Option OPTIONS_OBJ [] = {
   { false,  "-csv",                 1, "filename",        0, common::OT_WC,             ppCsv,                NULL,       "Create csv output file"},
   CL_CSVSEPARATOR
   { false,  "-pathlower",           0, "",                0, common::OT_NONE,           ppPathLower,          NULL,       "Paths are converted to lower case for writting out"},
+  { false,  "-threads",             1, "number",          0, common::OT_WC,             ppThreads,            NULL,       "Sets the number of threads computing the metrics of the top level classes and functions in parallel. The default value is 1 (sequential computation)."},
   CL_RUL_AND_RULCONFIG("MET.rul")
   CL_EXPORTRUL
   COMMON_CL_ARGS
@@ -227,7 +235,7 @@ int main(int argc, char *argv[]) {
     //
 
     common::WriteMsg::write( CMSG_LIM2METRICS_DEBUG_VISITOR_RUN );
-    lim::metrics::LimMetricsVisitor visitor( limFact, limGraph, rul, shared);
+    lim::metrics::LimMetricsVisitor visitor( limFact, limGraph, rul, shared, threads );
     visitor.run();
     
     //
@@ -23,6 +23,8 @@
 
 #include <graph/inc/graph.h>
 #include <rul/inc/RulHandler.h>
+#include <fstream>
+#include <vector>
 #include "ThresholdReader.h"
 #include "Threshold.h"
 
@@ -30,10 +32,39 @@ namespace columbus { namespace rul {
 
   class MetricChecker {
   private:
+    /**
+     * \brief the relation of a rule, parsed from its setting
+     */
+    enum Relation {
+      relLessThan,
+      relGreaterThan,
+      relLessEqual,
+      relGreaterEqual,
+      relUnknown
+    };
+
+    /**
+     * \brief an enabled rule with its settings resolved once for a node type
+     */
+    struct RuleCheck {
+      std::string rulid;
+      std::string metricName;
+      std::string relationStr;
+      std::string baselineStr;
+      Relation relation;
+      double baseline;
+      size_t metricIndex;  // the index of the metric among the metrics of the checks of the node type
+    };
+
     graph::Graph& theGraph;
     rul::RulHandler *rul;
     std::set<std::string> nodeTypes;
     std::string txtOutputFileName;
+    std::ofstream txtOutputStream;
+    std::ostream* txtOutput;
+
+    static Relation parseRelation(const std::string& relation);
+    void checkMetric(columbus::graph::Node& node, const RuleCheck& check, const graph::Attribute& attr);
   public:
     int count;
     void addNodeType(std::string& nodeType);
@@ -44,7 +75,7 @@ namespace columbus { namespace rul {
     void save(const std::string& savingPath, bool saveXML, const std::string& xmlPath);
     void executeCheck(columbus::graph::Node& node, const std::string& metricName, const std::string& rulename, const std::string& relation, const std::string& baseline);
     MetricChecker(graph::Graph& graph, rul::RulHandler& handler, const std::string& txtOutputFileName);
-    ~MetricChecker() { }
+    ~MetricChecker();
   };
 
 } }
@@ -30,6 +30,8 @@
 #include <graph/inc/graph.h>
 #include <graphsupport/inc/Metric.h>
 #include <graphsupport/inc/GraphConstants.h>
+#include <boost/unordered_map.hpp>
+#include <algorithm>
 
 #include <xercesc/sax2/SAX2XMLReader.hpp>
 #include <xercesc/sax2/XMLReaderFactory.hpp>
@@ -44,8 +46,17 @@ using namespace columbus::rul;
 
 namespace columbus { namespace rul {
 
-  MetricChecker::MetricChecker(graph::Graph& graph, rul::RulHandler& handler, const string& txtOutputFileName) : theGraph(graph), rul(&handler), txtOutputFileName(txtOutputFileName) {    
+  MetricChecker::MetricChecker(graph::Graph& graph, rul::RulHandler& handler, const string& txtOutputFileName) : theGraph(graph), rul(&handler), txtOutputFileName(txtOutputFileName), txtOutputStream(txtOutputFileName.c_str(), ios::app), txtOutput(NULL) {    
     count=0;
+    if (txtOutputStream)
+      txtOutput = &txtOutputStream;
+    else
+      txtOutput = &cout;
+    graphsupport::GraphWarningIndexer::getGraphWarningIndexerInstance().turnOn(theGraph);
+  };
+
+  MetricChecker::~MetricChecker() {
+    graphsupport::GraphWarningIndexer::getGraphWarningIndexerInstance().turnOff(theGraph);
   };
 
   const bool MetricChecker::checkRuleProperties(string& rulid, const string& nodetype) {
@@ -63,6 +74,18 @@ namespace columbus { namespace rul {
     nodeTypes.insert(nodeType);
   }
 
+  MetricChecker::Relation MetricChecker::parseRelation(const string& relation) {
+    if (relation == LESS_THAN)
+      return relLessThan;
+    if (relation == GREATER_THAN)
+      return relGreaterThan;
+    if (relation == LESS_EQUAL)
+      return relLessEqual;
+    if (relation == GREATER_EQUAL)
+      return relGreaterEqual;
+    return relUnknown;
+  }
+
   void MetricChecker::runChecker(){
     set<string> allRules;
     rul->getRuleIdList(allRules);
@@ -76,22 +99,86 @@ namespace columbus { namespace rul {
 
     for(set<string>::const_iterator iter = nodeTypes.begin(); iter != nodeTypes.end(); iter++) {
       const string& nodetype = *iter;
+
+      // The settings of the rules are resolved only once for each node type.
+      vector<RuleCheck> checks;
+      boost::unordered_map<string, size_t> metricIndexes;
+      for(set<string>::const_iterator it = notGroupRules.begin(); it != notGroupRules.end(); it++) {
+        string rulid = *it;
+        if(!checkRuleProperties(rulid, nodetype))
+          continue;
+
+        RuleCheck check;
+        check.rulid = rulid;
+        check.metricName = rul->getSettingValue(rulid, "metricName");
+        check.relationStr = rul->getSettingValue(rulid, "relation");
+        check.baselineStr = rul->getSettingValue(rulid, "threshold");
+        check.relation = parseRelation(check.relationStr);
+        check.baseline = 0;
+        common::str2double(check.baselineStr, check.baseline);
+        check.metricIndex = metricIndexes.insert(make_pair(check.metricName, metricIndexes.size())).first->second;
+        checks.push_back(check);
+      }
+
+      if (checks.empty())
+        continue;
+
+      vector<const graph::Attribute*> metrics(metricIndexes.size());
       graph::Node::NodeIterator methodNodes = theGraph.findNodes(graph::Node::NodeType( nodetype ));
       while(methodNodes.hasNext()){
         graph::Node mn = methodNodes.next();
-        for(set<string>::const_iterator it = notGroupRules.begin(); it != notGroupRules.end(); it++) {
-          
-          string rulid = *it;
-          string whichMetric = rul->getSettingValue(rulid, "metricName");
-          string whichRelation = rul->getSettingValue(rulid, "relation");
-          string whichBaseline = rul->getSettingValue(rulid, "threshold"); 
-
-          if(checkRuleProperties( rulid, nodetype)){
-            executeCheck(mn, whichMetric, rulid, whichRelation, whichBaseline);
-          }
+
+        // collect the first attribute of each checked metric in one pass
+        fill(metrics.begin(), metrics.end(), (const graph::Attribute*)NULL);
+        graph::Attribute::AttributeIterator aIt = mn.getAttributes();
+        while (aIt.hasNext()) {
+          const graph::Attribute& attr = aIt.next();
+          boost::unordered_map<string, size_t>::const_iterator indexIt = metricIndexes.find(attr.getName());
+          if (indexIt != metricIndexes.end() && metrics[indexIt->second] == NULL)
+            metrics[indexIt->second] = &attr;
+        }
+
+        for(vector<RuleCheck>::const_iterator it = checks.begin(); it != checks.end(); it++) {
+          if (metrics[it->metricIndex] != NULL)
+            checkMetric(mn, *it, *metrics[it->metricIndex]);
         }
       }
     }
+
+    txtOutput->flush();
+  }
+
+  void MetricChecker::checkMetric(columbus::graph::Node& node, const RuleCheck& check, const graph::Attribute& attr) {
+    double metricValue = 0;
+    if(attr.getType() == graph::Attribute::atInt) {
+      metricValue = ((const graph::AttributeInt&)attr).getValue();
+    } else if(attr.getType() == graph::Attribute::atFloat) {
+      metricValue = ((const graph::AttributeFloat&)attr).getValue();
+    } else {
+      return;
+    }
+
+    bool violated = false;
+    switch (check.relation) {
+      case relLessThan:
+        violated = (float)metricValue < check.baseline;
+        break;
+      case relGreaterThan:
+        violated = (float)metricValue > check.baseline;
+        break;
+      case relLessEqual:
+        violated = (float)metricValue <= check.baseline;
+        break;
+      case relGreaterEqual:
+        violated = (float)metricValue >= check.baseline;
+        break;
+      default:
+        WriteMsg::write(CMSG_UNKNOWN_REL_ERROR);
+        return;
+    }
+
+    if (violated)
+      addWarning(node, check.rulid, getWarningString(check.metricName, node.getType().getType(), check.relationStr, attr.getStringValue(), check.baselineStr));
   }
 
   void MetricChecker::addWarning(columbus::graph::Node& node, const string& warningName, const string& warningText){
@@ -107,18 +194,10 @@ namespace columbus { namespace rul {
     string filledWarningText = common::replace(warningText.c_str(), "%", name.c_str());
 
     if(graphsupport::addWarningOnce(theGraph, node, warningName, path, line, col, endline, endcol, filledWarningText)) {
-      ofstream txtOutputStream(txtOutputFileName.c_str(), ios::app);
-      ostream* output = NULL;
-
-      if (txtOutputStream)
-        output = &txtOutputStream;
-      else
-        output = &cout;
-
       if (!path.empty())
-        (*output) << path << "(" << line << "):" << warningName << ": " << filledWarningText << "\n";
+        (*txtOutput) << path << "(" << line << "):" << warningName << ": " << filledWarningText << "\n";
       else
-        (*output) << warningName << ": " << filledWarningText << "\n";
+        (*txtOutput) << warningName << ": " << filledWarningText << "\n";
         
       WriteMsg::write(CMSG_WARNING_ADDED, node.getUID().c_str(), warningName.c_str());
       count++;
@@ -284,6 +284,8 @@ void checkUserProperties()
   const path smDir = "openstaticanalyzer";
 
   props.logDir =  props.projectTimedResultDir / smDir / "log";
+  props.timelineFile = props.logDir / "timeline.csv";
+  props.taskTimesFile = props.projectResultDir / "task-times.csv";
   props.tempDir = props.projectTimedResultDir / smDir / "temp";
   props.asgDir = props.projectTimedResultDir / smDir / "asg";
   props.graphDir = props.projectTimedResultDir / smDir / "graph";
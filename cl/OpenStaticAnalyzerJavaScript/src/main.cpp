@@ -287,6 +287,8 @@ void checkUserProperties()
   const path osaDir = "openstaticanalyzer";
   
   props.logDir =  props.projectTimedResultDir / osaDir / "log";
+  props.timelineFile = props.logDir / "timeline.csv";
+  props.taskTimesFile = props.projectResultDir / "task-times.csv";
   props.tempDir = props.projectTimedResultDir / osaDir / "temp";
   props.asgDir = props.projectTimedResultDir / osaDir / "asg";
   props.graphDir = props.projectTimedResultDir / osaDir / "graph";
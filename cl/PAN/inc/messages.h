@@ -30,6 +30,10 @@
 #define CLARG_ANALYZE_PKG     "Analyze python packages."
 #define CLARG_IGNORE          "List of file and directory names separated by colon which will be ignored during the analysis. Default: tests."
 #define CLARG_PYBIN           "Sets Python 2.7/3.x binary executable name (full path is required if its directory is not in PATH)."
+#define CLARG_JOBS            "Parses the input files in the given number of worker processes and merges their ASGs. Default: 1."
+#define CLARG_THREADS         "Checks the input files against the filter file on the given number of threads. Default: 1."
+#define CLARG_SHARD_INDEX     "The index of the shard of the input files parsed by this worker process."
+#define CLARG_SHARD_COUNT     "The number of the shards of the input files."
 
 #define CMSG_NO_INPUT_FILES               WriteMsg::mlWarning, "Warning: No input files\n"
 #define CMSG_ONE_INPUT_REQ                WriteMsg::mlError, "Error: Exactly 1 input directory is required, when analyzing packages\n"
@@ -50,6 +54,9 @@
 #define CMSG_PAN_PY_COMPAT_ERROR          WriteMsg::mlError, "Error: PAN python version (%s) is not compatible with the python executable (%s).\n"
 #define CMSG_PY_LIB_NOT_FOUND             WriteMsg::mlError, "Error: Couldn't found the python lib directory.\n"
 #define CMSG_ERROR_ENVSET_FAILURE         WriteMsg::mlError, "Error: Failed to set '%s' environment variable!\n"
+#define CMSG_STARTING_SHARD               WriteMsg::mlNormal, "Starting parser process %u of %u (%u files)\n"
+#define CMSG_SHARD_FAILED                 WriteMsg::mlError, "Error: Parser process %u failed (exit code: %d)\n"
+#define CMSG_MERGING_SHARD                WriteMsg::mlNormal, "Merging ASG file: \"%s\"\n"
 
 //PBuilder messages
 #define CMSG_EX_WRONG_NUM_OP_OR_OP        "Wrong number of operands or operators"
@@ -27,6 +27,8 @@
 #define EXECUTABLE_NAME PROGRAM_NAME
 
 #include <boost/regex.hpp>
+// before the python headers, their macros (e.g. Index) break the templates of the executor
+#include <threadpool/inc/Executor.h>
 #include "../inc/PVisitor.h"
 #include "../inc/VisitorType.h"
 #include "../inc/messages.h"
@@ -36,6 +38,9 @@
 #include <common/inc/PlatformDependentDefines.h>
 #include <io/inc/CsvIO.h>
 #include <boost/filesystem.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
 #include <python/inc/PythonCollector.h>
 
 using namespace std;
@@ -46,6 +51,9 @@ using namespace columbus::python::asg;
 
 static int parseErrors = 0;
 
+// the header property of the ASG of a shard containing its number of parser errors
+static const std::string SHARD_PARSE_ERRORS = "ShardParseErrors";
+
 // command line
 static std::string listFile;
 static std::string out;
@@ -57,6 +65,10 @@ static bool pkg = false;
 static std::string filterFile;
 static bool analyzePackages = false;
 static std::string pythonBinary;
+static unsigned jobs = 1;
+static unsigned threads = 1;
+static int shardIndex = -1;
+static unsigned shardCount = 0;
 
 // Callback methods for argument processing
 static bool ppList (const Option *o, char *argv[]) {
@@ -103,6 +115,30 @@ bool ppPythonBinary(const common::Option *o, char *argv[]) {
   return true;
 }
 
+static bool ppJobs (const Option *o, char *argv[]) {
+  jobs = boost::lexical_cast<unsigned>(argv[0]);
+  if (jobs == 0)
+    jobs = 1;
+  return true;
+}
+
+static bool ppThreads (const Option *o, char *argv[]) {
+  threads = boost::lexical_cast<unsigned>(argv[0]);
+  if (threads == 0)
+    threads = 1;
+  return true;
+}
+
+static bool ppShardIndex (const Option *o, char *argv[]) {
+  shardIndex = boost::lexical_cast<int>(argv[0]);
+  return true;
+}
+
+static bool ppShardCount (const Option *o, char *argv[]) {
+  shardCount = boost::lexical_cast<unsigned>(argv[0]);
+  return true;
+}
+
 const common::Option OPTIONS_OBJ [] = {
   { false,      "-lst",               1,  "filename",   0,     OT_WC,         ppList,             NULL,   CLARG_LST},
   { false,      "-out",               1,  "filename",   0,     OT_WC,         ppOut,              NULL,   CLARG_OUT},
@@ -111,6 +147,10 @@ const common::Option OPTIONS_OBJ [] = {
   { false,      "-pkg",               0,  "",           0,     OT_NONE,       ppPkg,              NULL,   CLARG_PKG},
   { false,      "-analyzepackages",   0,  "",           0,     OT_NONE,       ppAnalyzePackages,  NULL,   CLARG_ANALYZE_PKG},
   { false,      "-pythonBinary",      1,  "filename",   0,     OT_WC,         ppPythonBinary,     NULL,   CLARG_PYBIN},
+  { false,      "-jobs",              1,  "number",     0,     OT_WC,         ppJobs,             NULL,   CLARG_JOBS},
+  { false,      "-threads",           1,  "number",     0,     OT_WC,         ppThreads,          NULL,   CLARG_THREADS},
+  { true,       "-shardindex",        1,  "number",     0,     OT_WC,         ppShardIndex,       NULL,   CLARG_SHARD_INDEX},
+  { true,       "-shardcount",        1,  "number",     0,     OT_WC,         ppShardCount,       NULL,   CLARG_SHARD_COUNT},
   CL_FLTP
   COMMON_CL_ARGS
 };
@@ -270,6 +310,148 @@ void run(const std::string& name, ASTVisitor& ast_visitor) {
   PyArena_Free(arena);
 }
 
+void parseFiles(Factory& factory) {
+  if( !Py_IsInitialized() ) {
+    Py_NoSiteFlag = 1;
+    Py_DontWriteBytecodeFlag = 1; // Suppress writing bytecode files (*.pyc)
+    Py_FrozenFlag = 1; // Suppress errors from getpath.c (could not find prefix/exec_prefix... on linux)
+    Py_Initialize();
+  }
+
+  // the nodes of the shards get disjoint ids, so their ASGs can be merged without renumbering
+  if (shardIndex >= 0)
+    factory.setNodeIdStride(shardIndex, shardCount);
+
+  PBuilder p_builder(&factory, pkg);
+  ASTVisitor ast_visitor(p_builder);
+
+  for(std::list<std::string>::iterator it = inputFiles.begin(); it != inputFiles.end(); it++) {
+    run(*it, ast_visitor);
+  }
+}
+
+// Splits the files into contiguous shards of about the same size, so the merged ASG keeps the order of the sequential parsing
+static void splitIntoShards(const std::list<std::string>& files, unsigned count, std::vector<std::list<std::string> >& shards) {
+  std::vector<uintmax_t> sizes;
+  uintmax_t total = 0;
+  for (std::list<std::string>::const_iterator it = files.begin(); it != files.end(); ++it) {
+    boost::system::error_code ec;
+    uintmax_t size = boost::filesystem::file_size(*it, ec);
+    if (ec || size == 0)
+      size = 1;
+    sizes.push_back(size);
+    total += size;
+  }
+
+  std::vector<std::list<std::string> > parts(count);
+  uintmax_t before = 0;
+  size_t i = 0;
+  for (std::list<std::string>::const_iterator it = files.begin(); it != files.end(); ++it, ++i) {
+    parts[(size_t)(before * count / total)].push_back(*it);
+    before += sizes[i];
+  }
+
+  for (std::vector<std::list<std::string> >::iterator it = parts.begin(); it != parts.end(); ++it) {
+    if (!it->empty()) {
+      shards.push_back(std::list<std::string>());
+      shards.back().swap(*it);
+    }
+  }
+}
+
+static void runShard(const std::string& program, const std::vector<std::string>& args, int* result) {
+  *result = common::run(program, args);
+}
+
+/**
+ * Removes the temporary files of the shards when the parsing of the shards is over, even if it failed.
+ * (exit() does not unwind the stack, so the failure paths call removeAll() before it.)
+ */
+class ShardFiles {
+public:
+  ~ShardFiles() {
+    removeAll();
+  }
+
+  void add(const std::string& filename) {
+    filenames.push_back(filename);
+  }
+
+  void removeAll() {
+    for (std::vector<std::string>::const_iterator it = filenames.begin(); it != filenames.end(); ++it) {
+      boost::system::error_code error;
+      boost::filesystem::remove(*it, error);
+    }
+    filenames.clear();
+  }
+
+private:
+  std::vector<std::string> filenames;
+};
+
+// Parses the shards of the input files in worker processes (the embedded parser is single threaded) and merges their ASGs
+void parseShards(const std::string& program, Factory& factory) {
+  std::vector<std::list<std::string> > shards;
+  splitIntoShards(inputFiles, jobs, shards);
+
+  ShardFiles temporaryFiles;
+
+  std::vector<std::string> shardFiles(shards.size());
+  std::vector<int> results(shards.size(), EXIT_FAILURE);
+  boost::thread_group workers;
+
+  for (size_t i = 0; i < shards.size(); ++i) {
+    std::string shardPath = outPath + ".shard" + common::toString((unsigned long)i);
+    std::string shardList = shardPath + ".lst";
+    shardFiles[i] = shardPath + ".psi";
+    temporaryFiles.add(shardList);
+    temporaryFiles.add(shardFiles[i]);
+
+    std::ofstream lst(shardList.c_str());
+    for (std::list<std::string>::const_iterator it = shards[i].begin(); it != shards[i].end(); ++it)
+      lst << *it << std::endl;
+    lst.close();
+
+    std::vector<std::string> args;
+    args.push_back("-lst:" + shardList);
+    args.push_back("-out:" + shardFiles[i]);
+    args.push_back("-shardindex:" + common::toString((unsigned long)i));
+    args.push_back("-shardcount:" + common::toString((unsigned long)shards.size()));
+    if (!prefix.empty())
+      args.push_back("-basepath:" + prefix);
+    if (pkg)
+      args.push_back("-pkg");
+    if (!pythonBinary.empty())
+      args.push_back("-pythonBinary:" + pythonBinary);
+
+    WriteMsg::write(CMSG_STARTING_SHARD, (unsigned)i + 1, (unsigned)shards.size(), (unsigned)shards[i].size());
+    workers.create_thread(boost::bind(&runShard, program, args, &results[i]));
+  }
+  workers.join_all();
+
+  bool failed = false;
+  for (size_t i = 0; i < shards.size(); ++i) {
+    if (results[i] != 0) {
+      WriteMsg::write(CMSG_SHARD_FAILED, (unsigned)i + 1, results[i]);
+      failed = true;
+    }
+  }
+  if (failed) {
+    temporaryFiles.removeAll();
+    exit(EXIT_FAILURE);
+  }
+
+  for (size_t i = 0; i < shards.size(); ++i) {
+    WriteMsg::write(CMSG_MERGING_SHARD, shardFiles[i].c_str());
+    CsiHeader header;
+    factory.merge(shardFiles[i], header);
+    int shardParseErrors = 0;
+    if (header.getInt(SHARD_PARSE_ERRORS, shardParseErrors))
+      parseErrors += shardParseErrors;
+  }
+  temporaryFiles.removeAll();
+}
+
 void checkPython() {
   std::string pyBin;
 
@@ -408,9 +590,12 @@ int main(int argc, char** argv)
       return EXIT_FAILURE;
     }
     if (!filter.isEmpty()) {
+      columbus::thread::Executor executor(threads);
+      std::vector<bool> filtered = filter.areFilteredOut(std::vector<std::string>(inputFiles.begin(), inputFiles.end()), executor);
+      std::vector<bool>::const_iterator filteredIt = filtered.begin();
       std::list<std::string>::iterator it = inputFiles.begin();
       while (it != inputFiles.end()) {
-        if (filter.isFilteredOut(*it)) {
+        if (*filteredIt++) {
           WriteMsg::write(CMSG_FILTERED_FILE, it->c_str());
           it = inputFiles.erase(it);
         } else {
@@ -432,22 +617,16 @@ int main(int argc, char** argv)
   setStartTime(&parseTime);
 
   if (!inputFiles.empty()) {
-    if( !Py_IsInitialized() ) {
-      Py_NoSiteFlag = 1;
-      Py_DontWriteBytecodeFlag = 1; // Suppress writing bytecode files (*.pyc)
-      Py_FrozenFlag = 1; // Suppress errors from getpath.c (could not find prefix/exec_prefix... on linux)
-      Py_Initialize();
-    }
-
-    PBuilder p_builder(factory, pkg);
-    ASTVisitor ast_visitor(p_builder);
-
-    for(std::list<std::string>::iterator it = inputFiles.begin(); it != inputFiles.end(); it++) {
-      run(*it, ast_visitor);
-    }
+    if (jobs > 1 && shardIndex < 0 && inputFiles.size() > 1)
+      parseShards(argv[0], *factory);
+    else
+      parseFiles(*factory);
 
     updateMemStat(&maxMem);
+  }
 
+  // the types are built on the merged ASG
+  if (!inputFiles.empty() && shardIndex < 0) {
     VisitorType* edge_visit = new VisitorType(factory, ExpressionsAndInit);
     AlgorithmPreorder ap;
     ap.setVisitSpecialNodes(false, false);
@@ -477,8 +656,14 @@ int main(int argc, char** argv)
   WriteMsg::write(CMSG_SAVING_ASG, out.c_str());
   CsiHeader header;
   header.add(header.csih_OriginalLocation,out);
+  if (shardIndex >= 0)
+    header.addInt(SHARD_PARSE_ERRORS, parseErrors);
 
   factory->save(out, header);
+  if (shardIndex >= 0) {
+    delete factory;
+    return EXIT_SUCCESS;
+  }
   factory->saveFilter(outPath + ".fpsi");
 
   updateMemStat(&maxMem);
@@ -30,6 +30,7 @@
 #include <xercesc/util/PlatformUtils.hpp>
 #include <common/inc/FileSup.h>
 #include "MetricTree.h"
+#include <graphsupport/inc/GraphWarningIndexer.h>
 #include <rul/inc/RulHandler.h>
 #include <common/inc/WriteMessage.h>
 #include <graph/inc/graph.h>
@@ -76,7 +77,14 @@ public:
 
   virtual void saveGraph(const std::string& filename, bool exportRul);
 
-  void setGraph(columbus::graph::Graph& ingraph) { this->graphIndexer.turnOff(this->graph); graph = ingraph; this->graphIndexer.turnOn(this->graph);}
+  void setGraph(columbus::graph::Graph& ingraph) {
+    columbus::graphsupport::GraphWarningIndexer& warningIndexer = columbus::graphsupport::GraphWarningIndexer::getGraphWarningIndexerInstance();
+    this->graphIndexer.turnOff(this->graph);
+    warningIndexer.turnOff(this->graph);
+    graph = ingraph;
+    this->graphIndexer.turnOn(this->graph);
+    warningIndexer.turnOn(this->graph);
+  }
 
 protected:
   XERCES_CPP_NAMESPACE_QUALIFIER DOMDocument* doc;
@@ -54,6 +54,7 @@ MetricTree::MetricTree(std::string& fileName, std::string& rul, std::string& rul
   std::string iniFileName = ((common::pathFindFileName(rul) == rul) ? "." + std::string(DIRDIVSTRING) : "") + rul;
   xRulhandler = new columbus::rul::RulHandler(iniFileName, rulConfig, "eng", "ISO-8859-1");
   this->graphIndexer.turnOn(this->graph);
+  graphsupport::GraphWarningIndexer::getGraphWarningIndexerInstance().turnOn(this->graph);
 }
 
 
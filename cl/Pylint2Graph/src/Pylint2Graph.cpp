@@ -118,6 +118,7 @@ void Pylint2Graph::buildGraph(const string& limFileName) {
 
   lim2graph::convertBaseGraph(limFact, graph, /*edges=*/ true, /*attributes=*/ true, /*components=*/ true, /*variants=*/ false, /*instances=*/ false);
   graphIndexer.turnOn(graph);
+  graphsupport::GraphWarningIndexer::getGraphWarningIndexerInstance().turnOn(graph);
 }
 
 
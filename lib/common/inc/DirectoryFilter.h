@@ -23,7 +23,12 @@
 
 #include <string>
 #include <list>
-#include <map>
+#include <vector>
+#include <unordered_map>
+
+namespace columbus { namespace thread {
+  class Executor;
+}}
 
 class DirectoryFilter {
 public:
@@ -43,14 +48,34 @@ public:
   */
   bool isFilteredOut(std::string path);
 
+  /**
+  * \brief Determines for each of the given paths if it is filtered or not. The paths are checked in parallel
+  *        and the results are not cached.
+  * \param paths      [in] The given paths.
+  * \param executor   [in] The executor checking the paths, they are checked sequentially if its concurrency is 1.
+  * \return           The results in the order of the paths.
+  */
+  std::vector<bool> areFilteredOut(const std::vector<std::string>& paths, columbus::thread::Executor& executor);
+
   /**
   * \return           True, if the filter_list is empty, false otherwise.
   */
   bool isEmpty();
 
 private:
+  struct Rule;
+
+  DirectoryFilter(const DirectoryFilter&);
+  DirectoryFilter& operator=(const DirectoryFilter&);
+
+  /**
+  * \brief Evaluates the rules from the last one for the given path without using the cache.
+  */
+  bool match(const std::string& path) const;
+
   std::list<std::string> filter_list;
-  std::map<std::string, bool> filter_cache;
+  std::vector<Rule*> rules;
+  std::unordered_map<std::string, bool> filter_cache;
 };
 
 #endif
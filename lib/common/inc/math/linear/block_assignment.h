@@ -0,0 +1,171 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef __COLUMBUS__COMMON__MATH_BLOCK_ASSIGNMENT_H
+#define __COLUMBUS__COMMON__MATH_BLOCK_ASSIGNMENT_H
+#include "hungarian_method.h"
+#include "sparse_assignment.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <map>
+#include <limits>
+
+namespace common { namespace math {
+
+  /**
+   * \brief Assignment problem on a sparse bipartite graph, solved for its connected components independently.
+   *
+   * The allowed (row, column) pairs are given with their costs like for the SparseAssignment. The components
+   * having at most denseLimit rows and columns are solved by the HungarianMethod on the dense matrix of the
+   * component (the missing pairs are infinite), which gives the same pairs as the HungarianMethod on the whole
+   * block-diagonal matrix. The larger components are solved by the SparseAssignment, which is exact, so their
+   * pairs can differ from the ones of the HungarianMethod (never fewer pairs, never higher total cost).
+   */
+  template<typename eType>
+  class BlockAssignment {
+  private:
+    struct Edge {
+      unsigned int row;
+      unsigned int col;
+      eType cost;
+      Edge(unsigned int row, unsigned int col, eType cost) : row(row), col(col), cost(cost) {}
+    };
+
+    unsigned int rows;
+    unsigned int cols;
+    unsigned int denseLimit;
+    std::vector<Edge> edges;
+
+    static unsigned int findRoot(std::vector<unsigned int>& parent, unsigned int node) {
+      while (parent[node] != node) {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+      }
+      return node;
+    }
+
+    // Gives the optimal pairs (column, row) of a connected component.
+    std::map<unsigned int, unsigned int> solveComponent(const std::vector<Edge>& component) const {
+      std::vector<unsigned int> componentRows;
+      std::vector<unsigned int> componentCols;
+      for (typename std::vector<Edge>::const_iterator it = component.begin(); it != component.end(); ++it) {
+        componentRows.push_back(it->row);
+        componentCols.push_back(it->col);
+      }
+      std::sort(componentRows.begin(), componentRows.end());
+      componentRows.erase(std::unique(componentRows.begin(), componentRows.end()), componentRows.end());
+      std::sort(componentCols.begin(), componentCols.end());
+      componentCols.erase(std::unique(componentCols.begin(), componentCols.end()), componentCols.end());
+
+      std::map<unsigned int, unsigned int> solution;
+      if (componentRows.size() <= denseLimit && componentCols.size() <= denseLimit) {
+        const eType inf = std::numeric_limits<eType>::max();
+        boost::numeric::ublas::matrix<eType> m(componentRows.size(), componentCols.size());
+        for (unsigned int q1 = 0; q1 < m.size1(); q1++)
+          for (unsigned int q2 = 0; q2 < m.size2(); q2++)
+            m(q1, q2) = inf;
+        for (typename std::vector<Edge>::const_iterator it = component.begin(); it != component.end(); ++it)
+          m(std::lower_bound(componentRows.begin(), componentRows.end(), it->row) - componentRows.begin(),
+            std::lower_bound(componentCols.begin(), componentCols.end(), it->col) - componentCols.begin()) = it->cost;
+
+        boost::numeric::ublas::matrix<eType> m_orig(m);
+        HungarianMethod<std::string, eType> Hm(m_orig);
+        std::map<unsigned int, unsigned int> hmSolution = Hm.solve(HungarianMethod<std::string, eType>::INJECTIVE_KIND);
+        for (std::map<unsigned int, unsigned int>::const_iterator it = hmSolution.begin(); it != hmSolution.end(); ++it)
+          if (it->second < m.size1() && it->first < m.size2() && m(it->second, it->first) != inf)
+            solution.insert(std::make_pair(componentCols[it->first], componentRows[it->second]));
+      } else {
+        SparseAssignment<eType> assignment(componentRows.size(), componentCols.size());
+        for (typename std::vector<Edge>::const_iterator it = component.begin(); it != component.end(); ++it)
+          assignment.addEdge(std::lower_bound(componentRows.begin(), componentRows.end(), it->row) - componentRows.begin(),
+            std::lower_bound(componentCols.begin(), componentCols.end(), it->col) - componentCols.begin(), it->cost);
+        std::map<unsigned int, unsigned int> sparseSolution = assignment.solve();
+        for (std::map<unsigned int, unsigned int>::const_iterator it = sparseSolution.begin(); it != sparseSolution.end(); ++it)
+          solution.insert(std::make_pair(componentCols[it->first], componentRows[it->second]));
+      }
+      return solution;
+    }
+
+    struct Sequential {
+      template<class Func>
+      void operator()(size_t n, const Func& func) const {
+        for (size_t i = 0; i < n; ++i)
+          func(i);
+      }
+    };
+
+  public:
+    BlockAssignment(unsigned int _rows, unsigned int _cols, unsigned int _denseLimit) : rows(_rows), cols(_cols), denseLimit(_denseLimit), edges() {}
+
+    /**
+     * \brief allows the pairing of the row and the column with the given cost
+     */
+    void addEdge(unsigned int row, unsigned int col, eType cost) {
+      edges.push_back(Edge(row, col, cost));
+    }
+
+    /**
+     * \brief computes the assignment of every component
+     * \return the row of each assigned column (the same orientation as the result of HungarianMethod)
+     */
+    std::map<unsigned int, unsigned int> solve() {
+      return solve(Sequential());
+    }
+
+    /**
+     * \brief computes the assignment of every component, the components are solved by forEachIndex(n, func),
+     *        which has to call func(i) for each i in [0, n) (for example concurrently)
+     * \return the row of each assigned column (the same orientation as the result of HungarianMethod)
+     */
+    template<class ForEach>
+    std::map<unsigned int, unsigned int> solve(const ForEach& forEachIndex) {
+      // the rows are the nodes 0..rows-1, the columns are the nodes rows..rows+cols-1
+      std::vector<unsigned int> parent(rows + cols);
+      for (unsigned int i = 0; i < parent.size(); ++i)
+        parent[i] = i;
+      for (typename std::vector<Edge>::const_iterator it = edges.begin(); it != edges.end(); ++it)
+        parent[findRoot(parent, it->row)] = findRoot(parent, rows + it->col);
+
+      std::map<unsigned int, unsigned int> componentIndex;
+      std::vector<std::vector<Edge> > components;
+      for (typename std::vector<Edge>::const_iterator it = edges.begin(); it != edges.end(); ++it) {
+        std::map<unsigned int, unsigned int>::iterator indexIt = componentIndex.insert(std::make_pair(findRoot(parent, it->row), (unsigned int)components.size())).first;
+        if (indexIt->second == components.size())
+          components.push_back(std::vector<Edge>());
+        components[indexIt->second].push_back(*it);
+      }
+      std::vector<Edge>().swap(edges);
+
+      std::vector<std::map<unsigned int, unsigned int> > componentSolutions(components.size());
+      forEachIndex(components.size(), [&](size_t component) {
+        componentSolutions[component] = solveComponent(components[component]);
+      });
+
+      std::map<unsigned int, unsigned int> solution;
+      for (typename std::vector<std::map<unsigned int, unsigned int> >::const_iterator it = componentSolutions.begin(); it != componentSolutions.end(); ++it)
+        solution.insert(it->begin(), it->end());
+      return solution;
+    }
+  };
+
+}}
+
+#endif
@@ -0,0 +1,189 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef __COLUMBUS__COMMON__MATH_SPARSE_ASSIGNMENT_H
+#define __COLUMBUS__COMMON__MATH_SPARSE_ASSIGNMENT_H
+#include <vector>
+#include <map>
+#include <queue>
+#include <limits>
+#include <functional>
+
+namespace common { namespace math {
+
+  /**
+   * \brief Assignment problem on a sparse bipartite graph.
+   *
+   * Only the allowed (row, column) pairs are given with their nonnegative costs, the missing pairs are forbidden.
+   * The solution is a matching with the maximum number of pairs, and with the minimal total cost among these.
+   * It is the same as the result of the HungarianMethod on the dense matrix where the forbidden pairs are
+   * infinite, if the optimal assignment is unique.
+   *
+   * The matching is built by successive shortest augmenting paths, the paths are searched by Dijkstra's
+   * algorithm on the reduced costs, so the running time is O(k * e * log(n)) for k pairs and e edges.
+   */
+  template<typename eType>
+  class SparseAssignment {
+  private:
+    struct Edge {
+      unsigned int row;
+      unsigned int col;
+      eType cost;
+      Edge(unsigned int row, unsigned int col, eType cost) : row(row), col(col), cost(cost) {}
+    };
+
+    static const unsigned int NONE = (unsigned int)-1;
+
+    unsigned int rows;
+    unsigned int cols;
+    std::vector<Edge> edges;
+
+  public:
+    SparseAssignment(unsigned int _rows, unsigned int _cols) : rows(_rows), cols(_cols), edges() {}
+
+    /**
+     * \brief allows the pairing of the row and the column with the given cost
+     */
+    void addEdge(unsigned int row, unsigned int col, eType cost) {
+      edges.push_back(Edge(row, col, cost));
+    }
+
+    /**
+     * \brief computes the optimal assignment
+     * \return the row of each assigned column (the same orientation as the result of HungarianMethod)
+     */
+    std::map<unsigned int, unsigned int> solve() {
+      const eType inf = std::numeric_limits<eType>::max();
+
+      // the edges starting from the rows
+      std::vector<unsigned int> first(rows + 1, 0);
+      for (typename std::vector<Edge>::const_iterator it = edges.begin(); it != edges.end(); ++it)
+        first[it->row + 1]++;
+      for (unsigned int i = 0; i < rows; ++i)
+        first[i + 1] += first[i];
+      std::vector<unsigned int> adjacent(edges.size());
+      {
+        std::vector<unsigned int> next(first.begin(), first.end() - 1);
+        for (unsigned int e = 0; e < edges.size(); ++e)
+          adjacent[next[edges[e].row]++] = e;
+      }
+
+      // the nodes are the rows (0..rows-1) and the columns (rows..rows+cols-1)
+      const unsigned int nodes = rows + cols;
+      std::vector<eType> potential(nodes, eType());
+      std::vector<unsigned int> rowMatch(rows, NONE);   // edge index
+      std::vector<unsigned int> colMatch(cols, NONE);   // edge index
+
+      std::vector<eType> dist(nodes);
+      std::vector<unsigned int> via(nodes);              // the edge through the node was reached
+      std::vector<bool> done(nodes);
+      typedef std::pair<eType, unsigned int> QueueItem;
+
+      while (true) {
+        std::fill(dist.begin(), dist.end(), inf);
+        std::fill(via.begin(), via.end(), NONE);
+        std::fill(done.begin(), done.end(), false);
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > queue;
+
+        for (unsigned int r = 0; r < rows; ++r) {
+          if (rowMatch[r] == NONE && first[r] != first[r + 1]) {
+            dist[r] = eType();
+            queue.push(QueueItem(dist[r], r));
+          }
+        }
+
+        // the closest free column
+        unsigned int target = NONE;
+        while (!queue.empty()) {
+          QueueItem item = queue.top();
+          queue.pop();
+          unsigned int node = item.second;
+          if (done[node])
+            continue;
+          done[node] = true;
+
+          if (node >= rows) {
+            unsigned int col = node - rows;
+            if (colMatch[col] == NONE) {
+              target = node;
+              break;
+            }
+            // go back through the matched edge
+            const Edge& edge = edges[colMatch[col]];
+            eType reduced = -edge.cost + potential[node] - potential[edge.row];
+            if (reduced < eType())
+              reduced = eType();
+            if (dist[node] + reduced < dist[edge.row]) {
+              dist[edge.row] = dist[node] + reduced;
+              via[edge.row] = colMatch[col];
+              queue.push(QueueItem(dist[edge.row], edge.row));
+            }
+          } else {
+            for (unsigned int i = first[node]; i < first[node + 1]; ++i) {
+              unsigned int e = adjacent[i];
+              if (rowMatch[node] == e)
+                continue;
+              const Edge& edge = edges[e];
+              unsigned int colNode = rows + edge.col;
+              eType reduced = edge.cost + potential[node] - potential[colNode];
+              if (reduced < eType())
+                reduced = eType();
+              if (dist[node] + reduced < dist[colNode]) {
+                dist[colNode] = dist[node] + reduced;
+                via[colNode] = e;
+                queue.push(QueueItem(dist[colNode], colNode));
+              }
+            }
+          }
+        }
+
+        if (target == NONE)
+          break;
+
+        // update the potentials, so the reduced costs remain nonnegative
+        const eType limit = dist[target];
+        for (unsigned int n = 0; n < nodes; ++n)
+          potential[n] += (done[n] && dist[n] < limit) ? dist[n] : limit;
+
+        // flip the edges along the path
+        unsigned int node = target;
+        while (true) {
+          unsigned int e = via[node];
+          const Edge& edge = edges[e];
+          unsigned int prevMatch = rowMatch[edge.row];
+          colMatch[edge.col] = e;
+          rowMatch[edge.row] = e;
+          if (prevMatch == NONE)
+            break;
+          node = rows + edges[prevMatch].col;
+        }
+      }
+
+      std::map<unsigned int, unsigned int> solution;
+      for (unsigned int c = 0; c < cols; ++c)
+        if (colMatch[c] != NONE)
+          solution.insert(std::make_pair(c, edges[colMatch[c]].row));
+      return solution;
+    }
+  };
+
+}}
+
+#endif
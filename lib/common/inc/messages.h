@@ -31,7 +31,7 @@
 #define  CMSG_UNRECOGNIZED_PARAM         common::WriteMsg::mlWarning, "Warning: Unrecognized parameter: '%s'\n"
 
 // DirectoryFilter
-#define  CMSG_CANT_PARSE                 common::WriteMsg::mlError,   "Error: [DirectoryFilter::isFilteredOut] Cannot parse '%s'. Regular expressions error: '%s'\n"
+#define  CMSG_CANT_PARSE                 common::WriteMsg::mlError,   "Error: [DirectoryFilter::openFilterFile] Cannot parse '%s'. Regular expressions error: '%s'\n"
 
 //FileSup
 #define  CMSG_BUFFER_TOO_SMALL           common::WriteMsg::mlError,   "Error: [common::getPrivateProfile...] The given buffer is too small\n"
@@ -22,53 +22,195 @@
 #include "../inc/WriteMessage.h"
 #include "../inc/messages.h"
 #include "../inc/StringSup.h"
+#include <threadpool/inc/Executor.h>
 #include <boost/regex.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <fstream>
 
 using namespace common;
 
-bool DirectoryFilter::isFilteredOut( std::string path )
-{
-  if (filter_list.empty())
-    return false;
-
-  std::map<std::string, bool>::const_iterator pathIt = filter_cache.find(path);
-  if (pathIt != filter_cache.end())
-    return pathIt->second;
-    
-  bool isFiltered = false;
+// The cache is cleared when it reaches this size.
+static const size_t MAX_CACHE_SIZE = 1 << 16;
 
-  for (std::list<std::string>::const_reverse_iterator rit = filter_list.rbegin(); rit != filter_list.rend(); ++rit) {
-    try {
-      char fltp = (*rit)[0];
-      std::string tmp = rit->substr(1, std::string::npos);
+// The number of the paths checked by one task of areFilteredOut.
+static const size_t BATCH_CHUNK_SIZE = 256;
 
+struct DirectoryFilter::Rule {
+  bool exclude;             // the line starts with '-'
+  bool valid;               // the regular expression could be compiled
+  bool pureLiteral;         // the expression matches exactly the paths containing the literal
+  bool anchored;            // the expression starts with '^'
+  std::string literal;      // string contained by every matching path
+  boost::regex re;
+};
 
-#ifdef __unix__
-      boost::regex re(tmp, boost::regex::extended);
-#endif
-
+static std::string normalizeCase(const std::string& str)
+{
 #ifdef _WIN32
-      boost::regex re(tmp, boost::regex::extended | boost::regex::icase);
+  std::string result(str);
+  std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+  return result;
+#else
+  return str;
 #endif
+}
 
-      if(boost::regex_search(path, re)) {
-        if (fltp == '-') {
-          isFiltered = true;
-        }
-        break;
+// Computes the longest string which is contained by every path matched by the given extended regular
+// expression, and whether the expression is just this string (optionally anchored to the beginning).
+static void analyzePattern(const std::string& pattern, std::string& literal, bool& pureLiteral, bool& anchored)
+{
+  literal.clear();
+  pureLiteral = true;
+  anchored = false;
+
+  if (pattern.find('|') != std::string::npos) {
+    pureLiteral = false;
+    return;
+  }
+
+  size_t i = 0;
+  if (!pattern.empty() && pattern[0] == '^') {
+    anchored = true;
+    i = 1;
+  }
+
+  int depth = 0;
+  std::string run;
+  while (i < pattern.size()) {
+    char c = pattern[i];
+    std::string atom;
+    bool isLiteral = true;
+
+    // \< \> \` \' are zero-width assertions, not escaped characters
+    if (c == '\\' && i + 1 < pattern.size() && !isalnum((unsigned char)pattern[i + 1]) && strchr("<>`'", pattern[i + 1]) == NULL) {
+      atom = pattern[i + 1];
+      i += 2;
+    } else if (strchr(".[]()^$*+?{}\\", c) != NULL) {
+      isLiteral = false;
+      pureLiteral = false;
+      if (c == '[') {
+        // skip the bracket expression, a ']' right after the opening '[' or '[^' belongs to the list
+        size_t j = i + 1;
+        if (j < pattern.size() && pattern[j] == '^')
+          ++j;
+        if (j < pattern.size() && pattern[j] == ']')
+          ++j;
+        j = pattern.find(']', j);
+        i = (j == std::string::npos) ? pattern.size() : j + 1;
+      } else {
+        if (c == '(')
+          ++depth;
+        else if (c == ')')
+          --depth;
+        else if (c == '\\')
+          ++i;
+        ++i;
       }
+    } else {
+      atom = c;
+      ++i;
     }
-    catch (boost::bad_expression e ){
-      WriteMsg::write(CMSG_CANT_PARSE,rit->c_str(),e.what());
+
+    char quantifier = i < pattern.size() ? pattern[i] : 0;
+    bool quantified = quantifier == '*' || quantifier == '?' || quantifier == '+' || quantifier == '{';
+    if (quantified) {
+      pureLiteral = false;
+      if (quantifier == '{') {
+        size_t j = pattern.find('}', i);
+        i = (j == std::string::npos) ? pattern.size() : j + 1;
+      } else
+        ++i;
+    }
+
+    if (isLiteral && depth == 0 && (!quantified || quantifier == '+'))
+      run += atom;
+    if (!isLiteral || depth != 0 || quantified) {
+      if (run.size() > literal.size())
+        literal = run;
+      run.clear();
     }
   }
-  
+  if (run.size() > literal.size())
+    literal = run;
+
+  if (depth != 0)
+    pureLiteral = false;
+}
+
+bool DirectoryFilter::match(const std::string& path) const
+{
+  std::string normalizedPath = normalizeCase(path);
+
+  for (std::vector<Rule*>::const_reverse_iterator rit = rules.rbegin(); rit != rules.rend(); ++rit) {
+    const Rule& rule = **rit;
+    if (!rule.valid)
+      continue;
+
+    bool matched;
+    if (rule.pureLiteral) {
+      if (rule.anchored)
+        matched = normalizedPath.compare(0, rule.literal.size(), rule.literal) == 0;
+      else
+        matched = normalizedPath.find(rule.literal) != std::string::npos;
+    } else {
+      if (!rule.literal.empty() && normalizedPath.find(rule.literal) == std::string::npos)
+        continue;
+      matched = boost::regex_search(path, rule.re);
+    }
+
+    if (matched)
+      return rule.exclude;
+  }
+
+  return false;
+}
+
+bool DirectoryFilter::isFilteredOut( std::string path )
+{
+  if (filter_list.empty())
+    return false;
+
+  std::unordered_map<std::string, bool>::const_iterator pathIt = filter_cache.find(path);
+  if (pathIt != filter_cache.end())
+    return pathIt->second;
+    
+  bool isFiltered = match(path);
+
+  if (filter_cache.size() >= MAX_CACHE_SIZE)
+    filter_cache.clear();
   filter_cache.insert(std::make_pair(path, isFiltered));
     
   return isFiltered;
 }
 
+std::vector<bool> DirectoryFilter::areFilteredOut(const std::vector<std::string>& paths, columbus::thread::Executor& executor)
+{
+  std::vector<bool> result(paths.size(), false);
+  if (filter_list.empty())
+    return result;
+
+  if (executor.getConcurrency() < 2 || paths.size() <= BATCH_CHUNK_SIZE) {
+    for (size_t i = 0; i < paths.size(); ++i)
+      result[i] = isFilteredOut(paths[i]);
+    return result;
+  }
+
+  // std::vector<bool> cannot be written concurrently
+  std::vector<char> filtered(paths.size(), 0);
+  size_t chunks = (paths.size() + BATCH_CHUNK_SIZE - 1) / BATCH_CHUNK_SIZE;
+  columbus::thread::parallel_for(executor, (size_t)0, chunks, (size_t)1, [&](size_t chunk) {
+    size_t end = std::min(paths.size(), (chunk + 1) * BATCH_CHUNK_SIZE);
+    for (size_t i = chunk * BATCH_CHUNK_SIZE; i < end; ++i)
+      filtered[i] = match(paths[i]) ? 1 : 0;
+  });
+
+  for (size_t i = 0; i < paths.size(); ++i)
+    result[i] = filtered[i] != 0;
+  return result;
+}
+
 bool DirectoryFilter::openFilterFile( std::string fltp )
 {
   std::ifstream ifs(fltp.c_str());
@@ -86,6 +228,31 @@ bool DirectoryFilter::openFilterFile( std::string fltp )
       if (!line.empty()) {
         if (line[0] == '+' || line[0] == '-') {
           filter_list.push_back(line);
+
+          // the rules are compiled only once
+          Rule* rule = new Rule;
+          rule->exclude = line[0] == '-';
+          rule->valid = true;
+          std::string pattern = line.substr(1, std::string::npos);
+          analyzePattern(pattern, rule->literal, rule->pureLiteral, rule->anchored);
+          rule->literal = normalizeCase(rule->literal);
+          if (!rule->pureLiteral) {
+            try {
+#ifdef __unix__
+              rule->re.assign(pattern, boost::regex::extended);
+#endif
+
+#ifdef _WIN32
+              rule->re.assign(pattern, boost::regex::extended | boost::regex::icase);
+#endif
+            }
+            catch (const boost::bad_expression& e ){
+              WriteMsg::write(CMSG_CANT_PARSE,line.c_str(),e.what());
+              rule->valid = false;
+            }
+          }
+          rules.push_back(rule);
+          filter_cache.clear();
         } else {
           continue;
         }
@@ -104,9 +271,13 @@ bool DirectoryFilter::isEmpty()
 
 DirectoryFilter::DirectoryFilter()
   :filter_list()
+  ,rules()
+  ,filter_cache()
 {
 }
 
 DirectoryFilter::~DirectoryFilter()
 {
+  for (std::vector<Rule*>::iterator it = rules.begin(); it != rules.end(); ++it)
+    delete *it;
 }
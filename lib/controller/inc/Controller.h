@@ -52,6 +52,8 @@ class Controller {
 
     int getTaskId(Task* t);
     Task* getTask(const std::string& str);
+    void loadTaskTimes(std::map<std::string, double>& taskTimes) const;
+    void saveTaskTimes(const std::map<std::string, double>& taskTimes) const;
     std::map<std::string, Task*> _taskMap;
     std::vector<Task*> _tasks;
     const BaseProperties& _props;
@@ -33,6 +33,8 @@ struct BaseProperties {
     , verbose (false)
   {}
   boost::filesystem::path logDir;       // Absolute path of the directory of the log files
+  boost::filesystem::path timelineFile; // The start and end times of the tasks are written into this csv file (if it is set)
+  boost::filesystem::path taskTimesFile;// The durations of the tasks are read from and saved into this file to prioritize the tasks in the next run (if it is set)
   int maxThreads;                       // The maximum number of concurent threads the controller can start
   bool verbose;                         // Verbose mode
 };
@@ -23,6 +23,9 @@
 
 #include <iterator>
 #include <algorithm>
+#include <deque>
+#include <fstream>
+#include <queue>
 #include <time.h>
 
 #include <boost/graph/adjacency_list.hpp>
@@ -30,6 +33,8 @@
 #include <boost/graph/depth_first_search.hpp>
 #include <boost/graph/visitors.hpp>
 #include <boost/date_time.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include <common/inc/WriteMessage.h>
 #include <common/inc/StringSup.h>
@@ -51,6 +56,27 @@ namespace columbus
 namespace controller
 {
 
+// The data of a task shared between the controller and the worker running it.
+struct TaskExecution
+{
+  TaskExecution() : task(NULL), result(), start(), end(), priority(0), remainingDependencies(0), successors() {}
+  Task* task;
+  Task::ExecutionResult result;
+  posix_time::ptime start;
+  posix_time::ptime end;
+  double priority;                      // The estimated time from the start of the task to the end of the whole execution
+  size_t remainingDependencies;         // The number of not yet finished tasks this task depends on
+  vector<size_t> successors;            // The tasks depending on this task
+};
+
+// The workers report the end of their tasks through this object.
+struct FinishedTasks
+{
+  boost::mutex mutex;
+  boost::condition_variable cond;
+  deque<size_t> ids;
+};
+
 // Worker is a functor class defines the operator() functions.
 // It can be passed for a new thread as well as a simple function,
 // but it can be parameterized through it's constructor. It only
@@ -58,31 +84,61 @@ namespace controller
 class Worker : public columbus::thread::Task 
 {
 public:
-  Worker(columbus::controller::Task* task, columbus::controller::Task::ExecutionResult* result, boost::shared_mutex& taskLockSharedMutex) : _task(task), _result(result), _taskLockSharedMutex(taskLockSharedMutex) {}
+  Worker(size_t id, TaskExecution* execution, FinishedTasks* finished, boost::shared_mutex& taskLockSharedMutex) : _id(id), _execution(execution), _finished(finished), _taskLockSharedMutex(taskLockSharedMutex) {}
 
   void operator()()
   {
+    columbus::controller::Task* task = _execution->task;
+    columbus::controller::Task::ExecutionResult& result = _execution->result;
     {
       columbus::thread::ThreadPool::TaskLock lock(_taskLockSharedMutex);
-      WriteMsg::write(WriteMsg::mlNormal, "  [%s] Starting task: %s\n",  common::getCurrentTimeAndDate("%Y-%m-%d %H:%M:%S").c_str(), _task->getName().c_str());
+      WriteMsg::write(WriteMsg::mlNormal, "  [%s] Starting task: %s\n",  common::getCurrentTimeAndDate("%Y-%m-%d %H:%M:%S").c_str(), task->getName().c_str());
     }
     
     fflush(stdout);
     fflush(stderr);
-    *_result = _task->execute();
+    _execution->start = posix_time::microsec_clock::local_time();
+    try {
+      result = task->execute();
+    } catch (...) {
+      result.setCriticalError();
+    }
+    _execution->end = posix_time::microsec_clock::local_time();
     
     {
       columbus::thread::ThreadPool::TaskLock lock(_taskLockSharedMutex);
-      WriteMsg::write(WriteMsg::mlNormal, "  [%s] Task ended: %s Result:%s\n", common::getCurrentTimeAndDate("%Y-%m-%d %H:%M:%S").c_str(), _task->getName().c_str(), _result->toString().c_str());
+      WriteMsg::write(WriteMsg::mlNormal, "  [%s] Task ended: %s Result:%s\n", common::getCurrentTimeAndDate("%Y-%m-%d %H:%M:%S").c_str(), task->getName().c_str(), result.toString().c_str());
     }
+
+    {
+      boost::unique_lock<boost::mutex> lock(_finished->mutex);
+      _finished->ids.push_back(_id);
+    }
+    _finished->cond.notify_one();
   }
       
 protected:
-  columbus::controller::Task* _task;
-  columbus::controller::Task::ExecutionResult* _result;
+  size_t _id;
+  TaskExecution* _execution;
+  FinishedTasks* _finished;
   boost::shared_mutex& _taskLockSharedMutex;
 };
 
+// Orders the ready tasks: the task with the longest remaining path is started first, then the one added first.
+struct ReadyTaskOrder
+{
+  ReadyTaskOrder(const vector<TaskExecution>& executions) : executions(executions) {}
+
+  bool operator()(size_t left, size_t right) const
+  {
+    if (executions[left].priority != executions[right].priority)
+      return executions[left].priority < executions[right].priority;
+    return left > right;
+  }
+
+  const vector<TaskExecution>& executions;
+};
+
 
 // Gets a pointer to a Task object by it's name.
 Task* Controller::getTask(const string& str)
@@ -106,10 +162,6 @@ int Controller::getTaskId(Task* t)
 
 int Controller::executeTasks(ExecutionMode executionMode)
 {
-  // contains the parallel topological sort's result. The key is the execution level, the 
-  // second vector contains the tasks, that are can be executed in the same time parallelly
-  map<unsigned, vector<string> > sortedMap;
-  
   vector<string> names;
   typedef pair<int, int> Edge_s;
   vector<Edge_s> edges;
@@ -140,113 +192,165 @@ int Controller::executeTasks(ExecutionMode executionMode)
   WriteMsg::write(WriteMsg::mlDDebug, "\n");
 
   size_t N = names.size();
-  
-  const size_t nedges = edges.size();
-  typedef pair<int,int> Edge;
-  vector<Edge> used_by;
-  used_by.resize(nedges);
-
-  vector<Edge_s>::iterator it2;
-  size_t cnt;
-  for(it2 = edges.begin(), cnt = 0; it2 != edges.end(); it2++, cnt++)
-    used_by[cnt] = make_pair(it2->first, it2->second);
-
 
   typedef adjacency_list<vecS, vecS, bidirectionalS> Graph;
   Graph g(N);
   
-  for (size_t j = 0; j < nedges; ++j)
-    add_edge(used_by[j].first, used_by[j].second, g);
-  
+  for(vector<Edge_s>::iterator it = edges.begin(); it != edges.end(); it++)
+    add_edge(it->first, it->second, g);
 
   typedef graph_traits<Graph>::vertex_descriptor Vertex;
-  
-  bool failed = false;
 
-  // Determine ordering for a full run of the tasks
-  // and provide the order of tasks that can be executed in parallel
+  // The tasks are prioritized by their critical path, which is estimated from the durations of the previous run.
+  // The tasks without a known duration are counted with 1 second.
+  map<string, double> taskTimes;
+  loadTaskTimes(taskTimes);
+
+  vector<TaskExecution> executions(N);
   {
-    typedef list<Vertex> MakeOrder;
-    MakeOrder::iterator i;
-    MakeOrder make_order;
-    
-    // Linear execution ordering
+    list<Vertex> make_order;
     topological_sort(g, front_inserter(make_order));
-    
-    // Parallel execution ordering
-    vector<int> time(N, 0);
-    for (i = make_order.begin(); i != make_order.end(); ++i) {    
-      // Walk through the in_edges an calculate the maximum time.
-      if (in_degree (*i, g) > 0) {
-        Graph::in_edge_iterator j, j_end;
-        int maxdist = 0;
-        // Through the order from topological sort, we are sure that every 
-        // time we are using here is already initialized.
-        for (boost::tuples::tie(j, j_end) = in_edges(*i, g); j != j_end; ++j)
-          maxdist = max(time[source(*j, g)], maxdist);
-        time[*i] = maxdist+1;
+
+    for (list<Vertex>::reverse_iterator i = make_order.rbegin(); i != make_order.rend(); ++i) {
+      TaskExecution& execution = executions[*i];
+      execution.task = _tasks[*i];
+      execution.remainingDependencies = in_degree(*i, g);
+
+      double maxSuccessor = 0;
+      Graph::out_edge_iterator j, j_end;
+      for (boost::tuples::tie(j, j_end) = out_edges(*i, g); j != j_end; ++j) {
+        execution.successors.push_back(target(*j, g));
+        maxSuccessor = max(executions[target(*j, g)].priority, maxSuccessor);
       }
+
+      map<string, double>::const_iterator time = taskTimes.find(names[*i]);
+      execution.priority = (time != taskTimes.end() ? time->second : 1.0) + maxSuccessor;
     }
+  }
 
-    {
-      graph_traits<Graph>::vertex_iterator i, iend;
-      for (boost::tuples::tie(i,iend) = vertices(g); i != iend; ++i)
-      {
-        sortedMap[time[*i]].push_back(names[*i]);
-      }
+  WriteMsg::write(WriteMsg::mlDebug, "TASK PRIORITIES:\n");
+  for (size_t i = 0; i < N; ++i)
+    WriteMsg::write(WriteMsg::mlDebug, "  %s %.2f\n", names[i].c_str(), executions[i].priority);
+  WriteMsg::write(WriteMsg::mlDebug, "\n");
 
-      WriteMsg::write(WriteMsg::mlDebug, "EXECUTION ORDER:\n");
-      
-      map<unsigned, vector<string> >::iterator it;
-      for(it = sortedMap.begin(); it != sortedMap.end(); it++) {
-        WriteMsg::write(WriteMsg::mlDebug, "  ");
-        for(vector<string>::iterator s_it = it->second.begin(); s_it != it->second.end(); s_it++)
-          WriteMsg::write(WriteMsg::mlDebug, "%s ", getTask(*s_it)->getName().c_str());
-        WriteMsg::write(WriteMsg::mlDebug, "\n");
-      }
-      WriteMsg::write(WriteMsg::mlDebug, "\n");
-      
-      WriteMsg::write(WriteMsg::mlNormal, "Executing tasks. (Multithread:%d)\n",  _props.maxThreads);
+  WriteMsg::write(WriteMsg::mlNormal, "Executing tasks. (Multithread:%d)\n",  _props.maxThreads);
 
-      for(it = sortedMap.begin(); it != sortedMap.end() && !failed; it++)
-      {
-        typedef list<pair<Task*, Task::ExecutionResult> > TaskResultVector;
-        TaskResultVector runningTasks;
-        
-        columbus::thread::ThreadPool threadPool(_props.maxThreads);
-        
-        for(vector<string>::iterator s_it = it->second.begin(); s_it != it->second.end(); s_it++)
+  // Every task is started as soon as all of its dependencies are finished and there is a free thread.
+  bool failed = false;
+  const size_t maxThreads = _props.maxThreads > 0 ? _props.maxThreads : 1;
+  size_t running = 0;
+  FinishedTasks finished;
+  ReadyTaskOrder order(executions);
+  priority_queue<size_t, vector<size_t>, ReadyTaskOrder> ready(order);
+  for (size_t i = 0; i < N; ++i)
+    if (executions[i].remainingDependencies == 0)
+      ready.push(i);
+
+  posix_time::ptime executionStart = posix_time::microsec_clock::local_time();
+  {
+    columbus::thread::ThreadPool threadPool((unsigned)maxThreads);
+
+    while (true) {
+      while (!failed && !ready.empty() && running < maxThreads) {
+        size_t id = ready.top();
+        ready.pop();
+
+        Task* task = executions[id].task;
+        if (!task->openLogFile())
         {
-          Task* task = getTask(*s_it);
-          if (!task->openLogFile())
-          {
-            string logfilename = (_props.logDir / (task->getName() + ".log")).string();
-            WriteMsg::write(WriteMsg::mlError, "Can not open log file for writing: %s\n", logfilename.c_str());
-          }
-
-          runningTasks.push_back(make_pair(task, Task::ExecutionResult()));
-          threadPool.add(columbus::thread::ThreadPool::PtrTask(new Worker(runningTasks.back().first, &runningTasks.back().second, threadPool.getTaskLockMutex())));
+          string logfilename = (_props.logDir / (task->getName() + ".log")).string();
+          WriteMsg::write(WriteMsg::mlError, "Can not open log file for writing: %s\n", logfilename.c_str());
         }
-        threadPool.wait();
-        
-        for(const auto& taskResultPair : runningTasks)
-        {
-          const Task::ExecutionResult& result = taskResultPair.second;
 
-          if (result.hasCriticalError())
-            failed = true;
+        ++running;
+        threadPool.add(columbus::thread::ThreadPool::PtrTask(new Worker(id, &executions[id], &finished, threadPool.getTaskLockMutex())));
+      }
+
+      if (running == 0)
+        break;
 
-          if (result.hasError() && executionMode == EM_FAIL_ON_ANY_ERROR)
-            failed = true;
-        }
+      size_t id;
+      {
+        boost::unique_lock<boost::mutex> lock(finished.mutex);
+        while (finished.ids.empty())
+          finished.cond.wait(lock);
+        id = finished.ids.front();
+        finished.ids.pop_front();
       }
+      --running;
+
+      const Task::ExecutionResult& result = executions[id].result;
+
+      if (result.hasCriticalError())
+        failed = true;
+
+      if (result.hasError() && executionMode == EM_FAIL_ON_ANY_ERROR)
+        failed = true;
+
+      for (vector<size_t>::const_iterator it = executions[id].successors.begin(); it != executions[id].successors.end(); ++it)
+        if (--executions[*it].remainingDependencies == 0)
+          ready.push(*it);
     }
-    WriteMsg::write(WriteMsg::mlDebug, "\nParallel runing is finished.\n");
+
+    threadPool.wait();
   }
-  
+  WriteMsg::write(WriteMsg::mlDebug, "\nParallel runing is finished.\n");
+
+  // writing the timeline and the durations of the tasks
+  if (!_props.timelineFile.empty()) {
+    ofstream timeline(_props.timelineFile.string().c_str());
+    if (timeline.is_open()) {
+      timeline << "Task,Start,End,Duration,Result\n";
+      for (vector<TaskExecution>::const_iterator it = executions.begin(); it != executions.end(); ++it) {
+        if (it->start.is_not_a_date_time())
+          continue;
+        timeline << it->task->getName() << ","
+                 << (it->start - executionStart).total_milliseconds() / 1000.0 << ","
+                 << (it->end - executionStart).total_milliseconds() / 1000.0 << ","
+                 << (it->end - it->start).total_milliseconds() / 1000.0 << ","
+                 << it->result.toString() << "\n";
+      }
+    } else
+      WriteMsg::write(WriteMsg::mlWarning, "Can not open timeline file for writing: %s\n", _props.timelineFile.string().c_str());
+  }
+
+  for (vector<TaskExecution>::const_iterator it = executions.begin(); it != executions.end(); ++it)
+    if (!it->start.is_not_a_date_time())
+      taskTimes[it->task->getName()] = (it->end - it->start).total_milliseconds() / 1000.0;
+  saveTaskTimes(taskTimes);
+
   return failed?1:0;
 }
 
+void Controller::loadTaskTimes(map<string, double>& taskTimes) const
+{
+  if (_props.taskTimesFile.empty())
+    return;
+
+  ifstream file(_props.taskTimesFile.string().c_str());
+  string line;
+  while (getline(file, line)) {
+    string::size_type separator = line.rfind(',');
+    if (separator == string::npos)
+      continue;
+    taskTimes[line.substr(0, separator)] = atof(line.c_str() + separator + 1);
+  }
+}
+
+void Controller::saveTaskTimes(const map<string, double>& taskTimes) const
+{
+  if (_props.taskTimesFile.empty())
+    return;
+
+  ofstream file(_props.taskTimesFile.string().c_str());
+  if (!file.is_open()) {
+    WriteMsg::write(WriteMsg::mlWarning, "Can not open file for writing: %s\n", _props.taskTimesFile.string().c_str());
+    return;
+  }
+  for (map<string, double>::const_iterator it = taskTimes.begin(); it != taskTimes.end(); ++it)
+    file << it->first << "," << it->second << "\n";
+}
+
 void Controller::addTask( Task* task )
 {
   _taskMap[task->getName()] = task;
@@ -149,6 +149,7 @@ void Factory::save(io::ZippedIO& zipIo, std::list<HeaderData*> &headerDataList,
 
   if (zip)
     zipIo.setZip(true);
+  zipIo.setBuffered(true);
   // saving the ASG
   AlgorithmPreorder algPre;
   algPre.setSafeMode();
@@ -244,6 +245,7 @@ void Factory::load( io::ZippedIO &zipIo, const std::list<HeaderData*> &headerDat
   loadHeader(zipIo, headerDataList);
   if (zip)
     zipIo.setZip(true);
+  zipIo.setBuffered(true);
   // loading the ASG
   NodeId id = zipIo.readUInt4();
   NodeKind kind = (NodeKind)zipIo.readUShort2();
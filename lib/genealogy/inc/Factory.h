@@ -101,6 +101,22 @@ namespace columbus { namespace genealogy {
       */
       void load(const std::string &filename, CsiHeader &header);
 
+      /**
+      * \brief Loads the systems of the given graph next to the existing ones (for example a segment of a segmented genealogy).
+      *        The systems of the loaded root are appended to the systems of the root, and the strings are moved into the string table of the factory.
+      *        The edges pointing to nodes which are not loaded are kept as they are.
+      * \param filename [in] The graph is loaded from this file.
+      * \param header   [in] The header information (also will be loaded).
+      * \throw GenealogyException If a loaded node (except the root) has the same id as an existing node, GenealogyException is thrown.
+      */
+      void merge(const std::string &filename, CsiHeader &header);
+
+      /**
+      * \brief Forgets the ids of the deleted nodes, so the new nodes get greater ids than the existing ones.
+      *        The segments of a segmented genealogy must not share node ids, so it is called after loading the last segment.
+      */
+      void clearDeletedNodeIds();
+
       void clear();
 
       /**
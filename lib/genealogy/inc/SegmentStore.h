@@ -0,0 +1,172 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _GENEALOGY_SEGMENTSTORE_H_
+#define _GENEALOGY_SEGMENTSTORE_H_
+
+#include "genealogy/inc/genealogy.h"
+
+/**
+* \file SegmentStore.h
+* \brief Contains declaration of SegmentStore class.
+*/
+
+namespace columbus { namespace genealogy {
+  /**
+  * \brief Append-only genealogy, which is stored as a list of immutable segments and an index.
+  *
+  * A segment is a normal genealogy file containing the root and the systems of the segment (one system, unless
+  * the segment is the result of a compaction). The edges between the nodes of different segments (the prev/next
+  * edges of the systems and of the tracked nodes, etc.) are not saved into the segments, they are saved into the
+  * link file of the later segment, so every segment can be loaded alone. The links are restored when the segments
+  * are merged.
+  * The index is a text file, its first line is the format identifier and every other line is the sequence number
+  * and the file name of a segment (relative to the directory of the index). A segment is committed by appending
+  * its line to the index, so an interrupted run does not corrupt the genealogy.
+  */
+  class SegmentStore {
+    public:
+
+      /**
+      * \brief An edge between the nodes of two different segments.
+      */
+      struct Link {
+        NodeId from;
+        NodeId to;
+        EdgeKind kind;
+      };
+
+      /** \brief Type definition to store the links. */
+      typedef std::vector<Link> Links;
+
+      /**
+      * \brief Constructor, it reads the index if it exists.
+      * \param indexFilename [in] The name of the index file.
+      * \throw GenealogyException If the index is malformed.
+      */
+      SegmentStore(const std::string& indexFilename);
+
+      /**
+      * \brief Gives back the number of the segments.
+      */
+      unsigned getSegmentCount() const;
+
+      /**
+      * \brief Loads the last segment (which contains the last system) into the empty factory.
+      *        The new nodes of the factory get greater ids than the loaded ones, so the new segment can be appended.
+      *        The node ids must be monotonic across the segments: the free ids of the loaded segment below its
+      *        greatest id belong to the nodes of the earlier segments, which are not loaded. The factory would
+      *        reuse them for the new nodes, and merge() would fail on the same id in two segments, so the free ids
+      *        are dropped by Factory::clearDeletedNodeIds() after the load.
+      * \param factory [in] The factory.
+      * \param header  [out] The header of the segment.
+      */
+      void loadLast(Factory& factory, CsiHeader& header) const;
+
+      /**
+      * \brief Collects the edges between the subtree of the system and the other nodes (except the root).
+      * \param factory  [in] The factory.
+      * \param systemId [in] The id of the system.
+      * \param links    [out] The collected links are appended to it.
+      */
+      static void collectLinks(Factory& factory, NodeId systemId, Links& links);
+
+      /**
+      * \brief Saves the factory as a new segment with its links, and appends it to the index.
+      *        The factory must not contain edges to the nodes which are not saved (they must be in the links).
+      * \param factory [in] The factory.
+      * \param header  [in] The header of the segment.
+      * \param links   [in] The links of the segment.
+      */
+      void append(const Factory& factory, CsiHeader& header, const Links& links);
+
+      /**
+      * \brief Merges the given number of oldest segments into one segment and removes the merged ones.
+      * \param count [in] The number of the merged segments.
+      */
+      void compact(unsigned count);
+
+      /**
+      * \brief Loads all the segments into the empty factory and restores the links between them.
+      * \param factory [in] The factory.
+      */
+      void merge(Factory& factory) const;
+
+    protected:
+
+      /**
+      * \internal
+      * \brief A line of the index.
+      */
+      struct Segment {
+        unsigned sequence;
+        std::string filename;
+      };
+
+      /** \internal \brief Type definition to store the segments. */
+      typedef std::vector<Segment> Segments;
+
+      /**
+      * \internal
+      * \brief Merges the first count segments into the factory, and collects the links which could not be restored.
+      */
+      void mergeSegments(Factory& factory, size_t count, Links& unresolved) const;
+
+      /**
+      * \internal
+      * \brief Gives back the path of the file of a segment.
+      */
+      std::string getPath(const std::string& filename) const;
+
+      /**
+      * \internal
+      * \brief Gives back the file name of the segment containing the systems from the first to the last sequence number.
+      */
+      std::string getSegmentFilename(unsigned first, unsigned last) const;
+
+      /**
+      * \internal
+      * \brief Gives back the name of the link file of the segment.
+      */
+      static std::string getLinksFilename(const std::string& filename);
+
+      /**
+      * \internal
+      * \brief Rewrites the index with the given segments (into a temporary file which is renamed at the end).
+      */
+      void saveIndex(const Segments& newSegments) const;
+
+      /** \internal \brief Saves the links into the file. */
+      static void saveLinks(const std::string& filename, const Links& links);
+
+      /** \internal \brief Loads the links from the file. */
+      static void loadLinks(const std::string& filename, Links& links);
+
+      /** \internal \brief The name of the index file. */
+      std::string indexFilename;
+
+      /** \internal \brief The segments in the order of the index. */
+      Segments segments;
+  };
+
+}}
+
+#endif
+
@@ -48,6 +48,7 @@
 #define CMSG_EX_INVALID_NODE_ID(ID)                     "Invalid NodeId (" + Common::toString(ID) + ")"
 #define CMSG_EX_YOU_MUST_ENABLE_THE_REVERSE_EDGE_FIRST  "The reverse edge must be enabled first"
 #define CMSG_EX_THE_NODE_DOES_NOT_EXISTS                "The node does not exist"
+#define CMSG_EX_THE_NODE_ALREADY_EXISTS(ID)             "The node already exists (" + Common::toString(ID) + ")"
 #define CMSG_EX_NEXT_ELEMENT_DOES_NOT_EXIST             "Next element does not exist"
 #define CMSG_EX_THE_LOADED_FILTER_DOES_NOT_MATCH_TO_THE_CURRENT "The loaded filter does not match to the current ASG"
 #define CMSG_EX_INVALID_NODE_KIND                       "Invalid node kind"
@@ -68,5 +69,8 @@
 #define CMSG_EX_NEITHER_NEXT_NOR_PREVIOUS_HAVE_BEEN_CALLED "Neither next() nor previous() have been called, or remove() or add() have been called after the last call to next() or previous()"
 #define CMSG_EX_THE_ITERATION_HAS_NOT_NEXT_ELEMENT      "The iteration does not have next element"
 #define CMSG_EX_THE_ITERATION_HAS_NOT_PREVIOUS_ELEMENT  "The iteration does not have previous element"
+#define CMSG_EX_WRONG_SEGMENT_INDEX(FILENAME)          "Wrong segment index (" + FILENAME + ")"
+#define CMSG_EX_CAN_T_WRITE_SEGMENT_INDEX(FILENAME)     "Cannot write the segment index (" + FILENAME + ")"
+#define CMSG_EX_WRONG_SEGMENT_COUNT(COUNT)              "Wrong number of segments to compact (" + Common::toString(COUNT) + ")"
 
 #endif
\ No newline at end of file
@@ -75,6 +75,7 @@ void Factory::save(const std::string &filename , CsiHeader &header) const {
 
   header.write(zipIo);
 
+  zipIo.setBuffered(true);
   // saving the ASG
   AlgorithmPreorder algPre;
   VisitorSave vSave(zipIo);
@@ -131,6 +132,7 @@ void Factory::load(const std::string &filename, CsiHeader &header) {
   header.read(zipIo);
   checkHeader(header);
 
+  zipIo.setBuffered(true);
   // loading the ASG
   NodeId id = zipIo.readUInt4();
   NodeKind kind = (NodeKind)zipIo.readUShort2();
@@ -156,6 +158,68 @@ void Factory::load(const std::string &filename, CsiHeader &header) {
 
 }
 
+void Factory::merge(const std::string &filename, CsiHeader &header) {
+  disableReverseEdges();
+
+  io::ZippedIO zipIo(filename.c_str(), io::IOBase::omRead, false);
+
+  // loading header
+  header.read(zipIo);
+  checkHeader(header);
+
+  zipIo.setBuffered(true);
+  // loading the ASG (the root is saved last, so its systems are already loaded when it is read)
+  std::list<NodeId> loadedNodes;
+  std::list<NodeId> loadedSystems;
+  NodeId id = zipIo.readUInt4();
+  NodeKind kind = (NodeKind)zipIo.readUShort2();
+
+  while (id || kind) {
+    if (kind == ndkProject) {
+      Project loadedRoot(id, this);
+      loadedRoot.load(zipIo);
+      for (ListIterator<System> it = loadedRoot.getSystemsListIteratorBegin(); it != loadedRoot.getSystemsListIteratorEnd(); ++it)
+        loadedSystems.push_back(it->getId());
+    } else {
+      if (getExist(id))
+        throw GenealogyException(COLUMBUS_LOCATION, CMSG_EX_THE_NODE_ALREADY_EXISTS(id));
+      createNode(kind, id);
+      container[id]->load(zipIo);
+      loadedNodes.push_back(id);
+    }
+
+    id = zipIo.readUInt4();
+    kind = (NodeKind)zipIo.readUShort2();
+  }
+
+  // loading the string table of the file and moving the strings of the loaded nodes into the own one
+  RefDistributorStrTable loadedStrTable;
+  loadedStrTable.loadWithKeepingTheRefMap(zipIo);
+  zipIo.close();
+
+  RefDistributorStrTable* ownStrTable = strTable;
+  strTable = &loadedStrTable;
+  std::map<Key,Key> oldAndNewStrKeyMap;
+  for (std::list<NodeId>::const_iterator it = loadedNodes.begin(); it != loadedNodes.end(); ++it)
+    container[*it]->swapStringTable(*ownStrTable, oldAndNewStrKeyMap);
+  strTable = ownStrTable;
+
+  for (std::list<NodeId>::const_iterator it = loadedSystems.begin(); it != loadedSystems.end(); ++it) {
+    container[*it]->parent = 0;
+    root->addSystems(*it);
+  }
+
+  // fill the deletedNodeIdList with the free ids
+  deletedNodeIdList.clear();
+  for (size_t id = 100; id < container.size(); ++id)
+    if (container[id] == NULL)
+      deletedNodeIdList.push_back(id);
+}
+
+void Factory::clearDeletedNodeIds() {
+  deletedNodeIdList.clear();
+}
+
 void Factory::clear() {
   disableReverseEdges();
   for (Container::iterator i = container.begin(); i != container.end(); ++i) {
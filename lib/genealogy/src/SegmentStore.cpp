@@ -0,0 +1,223 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#include "genealogy/inc/genealogy.h"
+#include "genealogy/inc/SegmentStore.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <boost/filesystem.hpp>
+#include "io/inc/BinaryIO.h"
+#include "genealogy/inc/messages.h"
+
+namespace columbus { namespace genealogy {
+
+static const char* SEGMENT_INDEX_FORMAT = "GENEALOGY-SEGMENTS 1";
+
+SegmentStore::SegmentStore(const std::string& indexFilename) : indexFilename(indexFilename), segments() {
+  std::ifstream index(indexFilename.c_str());
+  if (!index.is_open())
+    return;
+
+  std::string line;
+  if (!std::getline(index, line) || line != SEGMENT_INDEX_FORMAT)
+    throw GenealogyException(COLUMBUS_LOCATION, CMSG_EX_WRONG_SEGMENT_INDEX(indexFilename));
+
+  while (std::getline(index, line)) {
+    if (line.empty())
+      continue;
+    std::istringstream fields(line);
+    Segment segment;
+    if (!(fields >> segment.sequence >> segment.filename) || (!segments.empty() && segment.sequence <= segments.back().sequence))
+      throw GenealogyException(COLUMBUS_LOCATION, CMSG_EX_WRONG_SEGMENT_INDEX(indexFilename));
+    segments.push_back(segment);
+  }
+}
+
+unsigned SegmentStore::getSegmentCount() const {
+  return (unsigned)segments.size();
+}
+
+void SegmentStore::loadLast(Factory& factory, CsiHeader& header) const {
+  if (segments.empty())
+    return;
+
+  factory.load(getPath(segments.back().filename), header);
+  // the ids of the nodes of the earlier segments can be among the free ids of the last one
+  factory.clearDeletedNodeIds();
+}
+
+void SegmentStore::collectLinks(Factory& factory, NodeId systemId, Links& links) {
+  std::list<NodeId> subtree;
+  VisitorSubtreeCollector visitor(subtree);
+  AlgorithmPreorder().run(factory, visitor, systemId);
+
+  std::vector<bool> inSystem(factory.size(), false);
+  for (std::list<NodeId>::const_iterator it = subtree.begin(); it != subtree.end(); ++it)
+    inSystem[*it] = true;
+
+  const NodeId rootId = factory.getRoot()->getId();
+  const ReverseEdges& reverseEdges = factory.getReverseEdges();
+  std::vector<EdgeKind> edges;
+  for (NodeId id = 0; id < factory.size(); ++id) {
+    if (id == rootId || !factory.getExist(id))
+      continue;
+
+    edges.clear();
+    reverseEdges.getAllExistingEdges(id, edges);
+    for (std::vector<EdgeKind>::const_iterator edge = edges.begin(); edge != edges.end(); ++edge) {
+      for (ListIterator<Base> it = reverseEdges.constIteratorBegin(id, *edge); it != reverseEdges.constIteratorEnd(id, *edge); ++it) {
+        NodeId from = it->getId();
+        if (from == rootId || inSystem[from] == inSystem[id])
+          continue;
+        Link link = { from, id, *edge };
+        links.push_back(link);
+      }
+    }
+  }
+}
+
+void SegmentStore::append(const Factory& factory, CsiHeader& header, const Links& links) {
+  Segment segment;
+  segment.sequence = segments.empty() ? 1 : segments.back().sequence + 1;
+  segment.filename = getSegmentFilename(segment.sequence, segment.sequence);
+
+  factory.save(getPath(segment.filename), header);
+  saveLinks(getPath(getLinksFilename(segment.filename)), links);
+
+  // the segment is committed by its line in the index
+  bool newIndex = !boost::filesystem::exists(indexFilename);
+  std::ofstream index(indexFilename.c_str(), std::ios::out | std::ios::app);
+  if (newIndex)
+    index << SEGMENT_INDEX_FORMAT << '\n';
+  index << segment.sequence << ' ' << segment.filename << '\n';
+  index.close();
+  if (index.fail())
+    throw GenealogyException(COLUMBUS_LOCATION, CMSG_EX_CAN_T_WRITE_SEGMENT_INDEX(indexFilename));
+
+  segments.push_back(segment);
+}
+
+void SegmentStore::compact(unsigned count) {
+  if (count < 2 || count > segments.size())
+    throw GenealogyException(COLUMBUS_LOCATION, CMSG_EX_WRONG_SEGMENT_COUNT(count));
+
+  RefDistributorStrTable strTable;
+  Factory factory(strTable);
+  Links unresolved;
+  mergeSegments(factory, count, unresolved);
+
+  Segments newSegments;
+  Segment compacted;
+  compacted.sequence = segments[count - 1].sequence;
+  compacted.filename = getSegmentFilename(segments[0].sequence, compacted.sequence);
+  newSegments.push_back(compacted);
+  newSegments.insert(newSegments.end(), segments.begin() + count, segments.end());
+
+  CsiHeader header;
+  factory.save(getPath(compacted.filename), header);
+  saveLinks(getPath(getLinksFilename(compacted.filename)), unresolved);
+  saveIndex(newSegments);
+
+  // the merged segments are not referenced any more
+  for (size_t i = 0; i < count; ++i) {
+    boost::filesystem::remove(getPath(segments[i].filename));
+    boost::filesystem::remove(getPath(getLinksFilename(segments[i].filename)));
+  }
+  segments.swap(newSegments);
+}
+
+void SegmentStore::merge(Factory& factory) const {
+  Links unresolved;
+  mergeSegments(factory, segments.size(), unresolved);
+}
+
+void SegmentStore::mergeSegments(Factory& factory, size_t count, Links& unresolved) const {
+  for (size_t i = 0; i < count; ++i) {
+    CsiHeader header;
+    factory.merge(getPath(segments[i].filename), header);
+
+    Links links;
+    loadLinks(getPath(getLinksFilename(segments[i].filename)), links);
+    for (Links::const_iterator it = links.begin(); it != links.end(); ++it) {
+      if (factory.getExist(it->from) && factory.getExist(it->to))
+        factory.getRef(it->from).setEdge(it->kind, &factory.getRef(it->to));
+      else
+        unresolved.push_back(*it);
+    }
+  }
+}
+
+std::string SegmentStore::getPath(const std::string& filename) const {
+  return (boost::filesystem::path(indexFilename).parent_path() / filename).string();
+}
+
+std::string SegmentStore::getSegmentFilename(unsigned first, unsigned last) const {
+  std::ostringstream filename;
+  filename << boost::filesystem::path(indexFilename).filename().string() << '.' << std::setfill('0') << std::setw(6) << first;
+  if (first != last)
+    filename << '-' << std::setw(6) << last;
+  filename << ".gsi";
+  return filename.str();
+}
+
+std::string SegmentStore::getLinksFilename(const std::string& filename) {
+  return filename + ".links";
+}
+
+void SegmentStore::saveIndex(const Segments& newSegments) const {
+  const std::string tmpFilename = indexFilename + ".tmp";
+  std::ofstream index(tmpFilename.c_str(), std::ios::out | std::ios::trunc);
+  index << SEGMENT_INDEX_FORMAT << '\n';
+  for (Segments::const_iterator it = newSegments.begin(); it != newSegments.end(); ++it)
+    index << it->sequence << ' ' << it->filename << '\n';
+  index.close();
+  if (index.fail())
+    throw GenealogyException(COLUMBUS_LOCATION, CMSG_EX_CAN_T_WRITE_SEGMENT_INDEX(tmpFilename));
+
+  boost::filesystem::rename(tmpFilename, indexFilename);
+}
+
+void SegmentStore::saveLinks(const std::string& filename, const Links& links) {
+  io::BinaryIO binIo(filename, io::IOBase::omWrite);
+  binIo.writeUInt4((unsigned)links.size());
+  for (Links::const_iterator it = links.begin(); it != links.end(); ++it) {
+    binIo.writeUInt4(it->from);
+    binIo.writeUInt4(it->to);
+    binIo.writeUShort2(it->kind);
+  }
+  binIo.close();
+}
+
+void SegmentStore::loadLinks(const std::string& filename, Links& links) {
+  io::BinaryIO binIo(filename, io::IOBase::omRead);
+  unsigned size = binIo.readUInt4();
+  links.reserve(links.size() + size);
+  for (unsigned i = 0; i < size; ++i) {
+    Link link;
+    link.from = binIo.readUInt4();
+    link.to = binIo.readUInt4();
+    link.kind = (EdgeKind)binIo.readUShort2();
+    links.push_back(link);
+  }
+  binIo.close();
+}
+
+}}
@@ -358,6 +358,32 @@ namespace columbus {  namespace graph {
           */
           Container::iterator safeRemove(const Container::iterator& it);
 
+          /**
+          * \internal
+          * \brief Switches the iterator to the attribute slots of a compact graph if it has no container, otherwise registers it.
+          */
+          void init();
+
+          /**
+          * \internal
+          * \brief Gives back the next slot of a compact graph (like nextItem()).
+          * \return Returns the next slot (or compactEnd if there is no next element).
+          */
+          unsigned nextCompactItem();
+
+          /**
+          * \internal
+          * \brief Gives back the previous slot of a compact graph (like previousItem()).
+          * \return Returns the previous slot (or compactEnd if there is no previous element).
+          */
+          unsigned previousCompactItem();
+
+          /**
+          * \internal
+          * \brief Gives back the attribute of the slot of a compact graph.
+          */
+          Attribute* compactItem(unsigned slot) const;
+
           /**
           * \internal
           * \brief Invalidates the iterator (sets its state to op_Invalidated).
@@ -414,6 +440,18 @@ namespace columbus {  namespace graph {
             iteratorOnComposite
           } iteratorType;
 
+          /** \internal \brief True if the iterator goes on the attribute slots of a compact graph (it is not registered then). */
+          bool compact;
+
+          /** \internal \brief The first attribute slot in a compact graph. */
+          unsigned compactBegin;
+
+          /** \internal \brief The attribute slot after the last attribute in a compact graph. */
+          unsigned compactEnd;
+
+          /** \internal \brief Inner slot in a compact graph. */
+          unsigned compactIt;
+
           friend class Graph;
           friend class Node;
           friend class Edge;
@@ -721,6 +759,19 @@ namespace columbus {  namespace graph {
       */
       virtual void setGraph(Graph* graph);
 
+      /**
+      * \internal
+      * \brief returns true if the contained attributes are stored in the attribute pool of a compact graph
+      */
+      bool isPooled() const;
+
+      /**
+      * \internal
+      * \brief collects the contained attributes (from the list or from the attribute pool of a compact graph)
+      * \param result [out] the contained attributes
+      */
+      void getValues(AttributeVector& result) const;
+
     friend class AttributeIterator;
     friend class Graph;
     friend class GraphSchemaReader;
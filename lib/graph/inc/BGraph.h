@@ -25,6 +25,9 @@
 #include <set>
 #include <map>
 #include <queue>
+#include <vector>
+#include <string>
+#include <boost/unordered_map.hpp>
 #include <strtable/inc/StrTable.h>
 #include <io/inc/IO.h>
 
@@ -44,8 +47,13 @@ namespace columbus {  namespace graph {
   /** \internal \brief edge visitor */
   typedef void (*edgeVisitorCallback)(const Edge& edge, void *data);
 
+  /** \internal \brief file visitor (e.g. for reporting the progress of a merge) */
+  typedef void (*fileVisitorCallback)(const std::string& filename, void *data);
+
   class GraphSchemaReader;
 
+  class CompactStorage;
+
   /**
   * \brief class represent graph
   */
@@ -177,15 +185,17 @@ namespace columbus {  namespace graph {
       BGraph* g;
       StrTable* strTable;
 
-      typedef std::map<Key,GraphVertex> KeyMap;
-      typedef std::map<GraphEdge, GraphEdge> EdgePairMap; 
+      /** \internal \brief hash index of the nodes by their UID */
+      typedef boost::unordered_map<Key,GraphVertex> KeyMap;
 
       KeyMap nodeUIDs;
-      EdgePairMap edgePairMap;
 
       /** \internal \brief graph Schema reader */
       GraphSchemaReader* gsReader;
 
+      /** \internal \brief the read-only storage of the nodes, edges and attributes (NULL if the graph is stored in g) */
+      CompactStorage* compactStorage;
+
     protected:
 
       /**
@@ -265,11 +275,54 @@ namespace columbus {  namespace graph {
       AttributeList* getAttributeList(const GraphVertex& vertex) const;
       const Edge::EdgeType getEdgeType(const GraphEdge& edge) const;
       AttributeList* getAttributeList(const GraphEdge& edge) const;
+      Key getVertexUIDKey(const GraphVertex& vertex) const;
+      Key getVertexTypeKey(const GraphVertex& vertex) const;
+      Key getEdgeTypeKey(const GraphEdge& edge) const;
+      Edge::eDirectionType getEdgeDirection(const GraphEdge& edge) const;
+      size_t getAttributeCount(const GraphVertex& vertex) const;
+      size_t getAttributeCount(const GraphEdge& edge) const;
+
+      /**
+      * \internal
+      * \brief throws GraphException if the graph is compact, so its structure and attribute lists cannot be modified
+      */
+      void checkModifiable() const;
+
+      /**
+      * \internal
+      * \brief calls the visitor for each vertex in the order of their creation (in both storages)
+      */
+      template<class Visitor>
+      void forEachVertex(Visitor visitor) const;
+
+      /**
+      * \internal
+      * \brief calls the visitor for each out edge of the vertex in the order of their creation (in both storages)
+      */
+      template<class Visitor>
+      void forEachOutEdge(GraphVertex vertex, Visitor visitor) const;
+
+      /**
+      * \internal
+      * \brief calls the visitor for each attribute of the vertex, the edge or the composite attribute (in both storages)
+      */
+      template<class Visitor>
+      void forEachAttribute(GraphVertex vertex, Visitor visitor) const;
+      template<class Visitor>
+      void forEachAttribute(const GraphEdge& edge, Visitor visitor) const;
+      template<class Visitor>
+      void forEachAttribute(const AttributeComposite& composite, Visitor visitor) const;
 
       GraphEdge createEdge(GraphVertex fromVertex, GraphVertex toVertex, const std::string& type, Edge::eDirectionType directionType);
       GraphEdge getEdgePair(GraphEdge edge) const;
       bool hasEdgePair(GraphEdge edge) const;
 
+      /**
+      * \internal
+      * \brief makes the two edges the pair of each other (the pairs are stored in the edge properties)
+      */
+      void setEdgePair(GraphEdge edge, GraphEdge pair);
+
       void traverseDepthFirstPostorder(const Node& startNode, const Edge::EdgeTypeSet& edges,
         nodeVisitorCallback nodeVisitorFunc, edgeVisitorCallback edgeVisitorFunc,std::set<GraphVertex>& visitedVertexes, void* data);
 
@@ -286,6 +339,12 @@ namespace columbus {  namespace graph {
       void clear_node(const GraphVertex& node);
       void delete_edge(const GraphEdge& edge) ;
 
+      /**
+      * \internal
+      * \brief delete all nodes and edges, but keep the string table and the header
+      */
+      void clearNodes();
+
     public:
 
       /**
@@ -475,7 +534,23 @@ namespace columbus {  namespace graph {
       void loadXML(const std::string& filename) ;
       
       void saveBinary(const std::string& filename) const;
-      void loadBinary(const std::string& filename) ;
+
+      /**
+      * The compact graph keeps its nodes, edges and attributes in contiguous arrays with CSR adjacency and typed
+      * attribute pools, which is smaller and faster to traverse. It is read-only: nodes, edges and attributes cannot be
+      * added or deleted (GraphException is thrown), but the values of the attributes, the types and UIDs of the nodes
+      * and the header can be changed, and it can be saved or copied into a normal graph. Loading or clearing the graph
+      * again makes it a normal graph.
+      * \brief load graph from binary file
+      * \param filename [in] the graph file
+      * \param compact [in] if true, the graph is loaded into the read-only compact storage
+      */
+      void loadBinary(const std::string& filename, bool compact = false);
+
+      /**
+      * \brief gives back true if the graph was loaded into the read-only compact storage
+      */
+      bool isCompact() const;
 
       void saveCSV(const std::string& filename, const std::string& edge) const;
       void saveCSV(const std::string& filename) ;
@@ -530,6 +605,26 @@ namespace columbus {  namespace graph {
       void mergeWithBinary(const std::string& filename, Graph::MergeMode nodeMode, Graph::CompsiteAndStringMergeMode nodeAttributeStringAndCompositeMode, Graph::NumericMergeMode nodeAttributeNumericMode,
         Graph::MergeMode edgeMode, Graph::CompsiteAndStringMergeMode edgeAttributeStringAndCompositeMode, Graph::NumericMergeMode edgeAttributeNumericMode);
 
+      /**
+      * The files are merged in their order, as with repeated mergeWithBinary() calls. They are not loaded into
+      * separate graphs: the files are memory mapped, their string tables are loaded in parallel (at most 'threads'
+      * files ahead of the merge), and their nodes are merged one by one as they are read.
+      * \brief merge the graphs of the binary files to this graph
+      * \param filenames [in] the merged graph files
+      * \param nodeMode [in] merge mode to nodes
+      * \param nodeAttributeStringAndCompositeMode [in] node string and composite attribute merge mode
+      * \param nodeAttributeNumericMode [in] node string and composite aattribute merge mode
+      * \param edgeMode [in] merge mode to edges
+      * \param edgeAttributeStringAndCompositeMode [in] edge string and composite aattribute merge mode
+      * \param edgeAttributeNumericMode [in] edge string and composite attribute merge mode
+      * \param threads [in] the number of files prepared in parallel (0 means the concurrency of the global executor)
+      * \param mergeFileFunc [in] called before merging each file (can be NULL)
+      * \param data [in] passed to mergeFileFunc
+      */
+      void mergeWithBinary(const std::vector<std::string>& filenames, Graph::MergeMode nodeMode, Graph::CompsiteAndStringMergeMode nodeAttributeStringAndCompositeMode, Graph::NumericMergeMode nodeAttributeNumericMode,
+        Graph::MergeMode edgeMode, Graph::CompsiteAndStringMergeMode edgeAttributeStringAndCompositeMode, Graph::NumericMergeMode edgeAttributeNumericMode,
+        unsigned threads = 0, fileVisitorCallback mergeFileFunc = NULL, void* data = NULL);
+
       /**
       * \brief merge 'graph' to this graph
       * \param filename [in] this graph merged with thath graph witch in 'filename' file
@@ -551,6 +646,26 @@ namespace columbus {  namespace graph {
 
 
     private:
+      /**
+      * \internal
+      * \brief binary graph file prepared for a streaming merge
+      */
+      struct BinaryMergeInput;
+
+      /**
+      * \internal
+      * \brief maps the file and loads its string table and header
+      * \return false if the file cannot be mapped
+      */
+      static bool prepareBinaryMergeInput(BinaryMergeInput& input);
+
+      /**
+      * \internal
+      * \brief merges the nodes of the prepared file to this graph one by one
+      */
+      void mergeBinaryMergeInput(BinaryMergeInput& input, Graph::MergeMode nodeMode, Graph::CompsiteAndStringMergeMode nodeAttributeStringAndCompositeMode, Graph::NumericMergeMode nodeAttributeNumericMode,
+          Graph::MergeMode edgeMode, Graph::CompsiteAndStringMergeMode edgeAttributeStringAndCompositeMode, Graph::NumericMergeMode edgeAttributeNumericMode);
+
       void convertEdgeMerge(std::multimap<std::string, Edge>& oldNodeTargets, Edge& newEdge, Graph& oldGraph, MergeMode mode,
           Graph::CompsiteAndStringMergeMode attributeStringAndCompositeMode, Graph::NumericMergeMode attributeNumericMode);
 
@@ -573,6 +688,19 @@ namespace columbus {  namespace graph {
       Edge createBidirectedEdge(const Node& from, const Node& to, Key typeKey);
       Edge createDirectedEdge(const Node& from, const Node& to, Key typeKey, bool createReverse);
 
+      /**
+      * \internal
+      * \brief loads the nodes and edges of the binary file (after its string table and header) into the compact storage
+      */
+      void loadCompactBinary(io::BinaryIO& in, Key invalidNodeType);
+
+      /**
+      * \internal
+      * \brief reads 'count' attributes into the attribute pool of the compact storage starting from the 'first' slot
+      * \return the slot after the last read attribute
+      */
+      unsigned readCompactAttributes(io::BinaryIO& in, unsigned first, unsigned count);
+
 
     friend class Node;
     friend class Edge;  
@@ -23,6 +23,7 @@
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/properties.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "strtable/inc/StrTable.h"
 #include "graph/inc/graph.h"
@@ -127,7 +128,9 @@ namespace columbus {  namespace graph {
   // create edge proportyes
 
 
-  typedef boost::property<edge_attributes_t,AttributeList* > EdgeAttributes;
+  // the property object of the reverse or bidirectional pair of the edge (NULL if it has no pair)
+  typedef boost::property<edge_pair_t,void* > EdgePair;
+  typedef boost::property<edge_attributes_t,AttributeList*,EdgePair> EdgeAttributes;
   typedef boost::property<edge_direction_t,int/*eDirectionType*/,EdgeAttributes> EdgeDirection;
   typedef boost::property<edge_type_t,Key,EdgeDirection> EdgeProperty;
 
@@ -146,6 +149,16 @@ namespace columbus {  namespace graph {
   //edges
   typedef boost::graph_traits<BGraph>::edge_descriptor GraphEdge;
 
+  /**
+  * \internal
+  * \brief hash function of the edges, the edges are identified by their property objects (like in their operator==)
+  */
+  struct GraphEdgeHash {
+    std::size_t operator()(const GraphEdge& edge) const {
+      return boost::hash<const void*>()(edge.get_property());
+    }
+  };
+
   //iterators
 
   typedef boost::graph_traits<BGraph>::vertex_iterator vertex_iter;
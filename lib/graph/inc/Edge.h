@@ -157,6 +157,19 @@ namespace columbus {  namespace graph {
           */
           EdgeIterator(out_edge_iter container_begin,out_edge_iter container_end, IteratorContainer *itContainer, Graph* graph, GraphVertex vertex,const EdgeTypeSet &filteredEdges);
 
+          /**
+          * \internal
+          * \brief Non-public constructor, which creates a usable new iterator on the out edges of a vertex of a compact graph.
+          * \param graph         [in] The compact graph.
+          * \param vertex        [in] The source vertex.
+          * \param begin         [in] The index of the first out edge.
+          * \param end           [in] The index after the last out edge.
+          * \param filteredEdges [in] If it is empty, we use all edges, else we use only filteredEdges edges
+          *
+          * The iterator is not registered in the graph, because the edges of a compact graph cannot be deleted.
+          */
+          EdgeIterator(Graph* graph, GraphVertex vertex, unsigned begin, unsigned end, const EdgeTypeSet &filteredEdges);
+
           /**
           * \internal
           * \brief Inserts the specified element into the list.
@@ -298,6 +311,32 @@ namespace columbus {  namespace graph {
           */
           out_edge_iter safeRemove(const out_edge_iter& it);
 
+          /**
+          * \internal
+          * \brief Gives back the index of the next edge of a compact graph (like nextItem()).
+          * \return Returns the index of the next edge (or compactEnd if there is no next element).
+          */
+          unsigned nextCompactItem();
+
+          /**
+          * \internal
+          * \brief Gives back the index of the previous edge of a compact graph (like previousItem()).
+          * \return Returns the index of the previous edge (or compactEnd if there is no previous element).
+          */
+          unsigned previousCompactItem();
+
+          /**
+          * \internal
+          * \brief Returns true if the edge of the compact graph is filtered out by filteredEdges.
+          */
+          bool isOutFilteredCompactItem(unsigned index) const;
+
+          /**
+          * \internal
+          * \brief Gives back the edge descriptor of the edge of the compact graph.
+          */
+          GraphEdge compactEdge(unsigned index) const;
+
           /**
           * \internal
           * \brief Invalidates the iterator (sets its state to op_Invalidated).
@@ -327,6 +366,18 @@ namespace columbus {  namespace graph {
           /** \internal \brief State of the iterator (the last operation done on the iterator). */
           op lastOp;
 
+          /** \internal \brief True if the iterator goes on the out edges of a vertex of a compact graph. */
+          bool compact;
+
+          /** \internal \brief The index of the first out edge in a compact graph. */
+          unsigned compactBegin;
+
+          /** \internal \brief The index after the last out edge in a compact graph. */
+          unsigned compactEnd;
+
+          /** \internal \brief Inner edge index in a compact graph. */
+          unsigned compactIt;
+
           friend class Graph;
           friend class Node;
       };
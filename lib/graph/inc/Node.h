@@ -145,6 +145,17 @@ namespace columbus {  namespace graph {
           */
           NodeIterator(vertex_iter container_begin,vertex_iter container_end, IteratorContainer *itContainer, Graph* graph,const NodeTypeSet& NTYPE);
 
+          /**
+          * \internal
+          * \brief Non-public constructor, which creates a usable new iterator on the vertices of a compact graph.
+          * \param graph        [in] The compact graph.
+          * \param vertexCount  [in] The number of the vertices.
+          * \param NTYPE        [in] If it is empty, we use all nodes, else we use only filteredEdegs nodes
+          *
+          * The iterator is not registered in the graph, because the vertices of a compact graph cannot be deleted.
+          */
+          NodeIterator(Graph* graph, unsigned vertexCount, const NodeTypeSet& NTYPE);
+
           /**
           * \internal
           * \brief Insert the specified element into the list.
@@ -286,6 +297,26 @@ namespace columbus {  namespace graph {
           */
           vertex_iter safeRemove(const vertex_iter& it);
 
+          /**
+          * \internal
+          * \brief Gives back the index of the next vertex of a compact graph (like nextItem()).
+          * \return Returns the index of the next vertex (or compactEnd if there is no next element).
+          */
+          unsigned nextCompactItem();
+
+          /**
+          * \internal
+          * \brief Gives back the index of the previous vertex of a compact graph (like previousItem()).
+          * \return Returns the index of the previous vertex (or compactEnd if there is no previous element).
+          */
+          unsigned previousCompactItem();
+
+          /**
+          * \internal
+          * \brief Returns true if the vertex of the compact graph is filtered out by filteredNodes.
+          */
+          bool isOutFilteredCompactItem(unsigned index) const;
+
           /**
           * \internal
           * \brief Invalidates the iterator (sets its state to op_Invalidated).
@@ -313,6 +344,15 @@ namespace columbus {  namespace graph {
           /** \internal \brief State of the iterator (the last operation done on the iterator). */
           op lastOp;
 
+          /** \internal \brief True if the iterator goes on the vertices of a compact graph. */
+          bool compact;
+
+          /** \internal \brief Inner vertex index in a compact graph. */
+          unsigned compactIt;
+
+          /** \internal \brief The number of the vertices in a compact graph. */
+          unsigned compactEnd;
+
 
         friend class Graph;
       };
@@ -393,6 +433,13 @@ namespace columbus {  namespace graph {
 
       Node(Graph* g, GraphVertex vertex);
 
+      /**
+      * \internal
+      * \brief gives back iterator to the out edges of the node of a compact graph
+      * \param types [in] if it is empty, we use all edges, else we use only these edges
+      */
+      Edge::EdgeIterator compactOutEdges(const Edge::EdgeTypeSet& types) const;
+
     protected:
 
       Graph *g;
@@ -0,0 +1,202 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _GRAPHCOMPACTSTORAGE_H
+#define _GRAPHCOMPACTSTORAGE_H
+
+#include <vector>
+#include <deque>
+#include "graph/inc/graph.h"
+
+/**
+* \internal
+* \file CompactStorage.h
+* \brief Contains the read-only compact storage of the graph lib
+*/
+
+namespace columbus {  namespace graph {
+
+  /**
+  * \internal
+  * \brief composite attribute of a compact graph, its contained attributes are the [valuesBegin, valuesEnd) slots of the attribute pool
+  */
+  class CompactAttributeComposite : public AttributeComposite {
+
+    public:
+
+      /**
+      * \internal
+      * \brief constructor, the contained attributes are set by the loader
+      * \param nameKey [in] the key of the name
+      * \param contextKey [in] the key of the context
+      * \param g [in] the compact graph owning the attribute pool
+      */
+      CompactAttributeComposite(Key nameKey, Key contextKey, Graph* g);
+
+      /**
+      * \internal
+      * \brief copy constructor, which shares the slot range of the other composite (used by the pool only)
+      */
+      CompactAttributeComposite(const CompactAttributeComposite& attribute);
+
+      /** \internal \brief the first slot of the contained attributes */
+      unsigned valuesBegin;
+
+      /** \internal \brief the slot after the last contained attribute */
+      unsigned valuesEnd;
+  };
+
+  /**
+  * \internal
+  * \brief read-only storage of a graph loaded by Graph::loadBinary(filename, true)
+  *
+  * The vertices and the edges are stored in parallel arrays, the out edges of a vertex are a contiguous range
+  * of the edge arrays (CSR). The attributes are stored in typed pools, the attributes of a vertex, an edge or a
+  * composite attribute are a contiguous range of the slot array pointing into these pools.
+  * Vertices and edges are encoded in the usual descriptors: a vertex is its index + 1, the property of an edge
+  * is its index + 1. The descriptors remain valid until the graph is cleared.
+  */
+  class CompactStorage {
+
+    public:
+
+      /** \internal \brief the pair index of the edges without pair */
+      static const unsigned noPair = ~0u;
+
+      /**
+      * \internal
+      * \brief constructor
+      */
+      CompactStorage();
+
+      /**
+      * \internal
+      * \brief gives back the number of the vertices
+      */
+      unsigned getVertexCount() const {
+        return static_cast<unsigned>(vertexUIDs.size());
+      }
+
+      /**
+      * \internal
+      * \brief appends a new vertex without attributes
+      * \return the index of the new vertex
+      */
+      unsigned addVertex(Key uid, Key type);
+
+      /**
+      * \internal
+      * \brief appends a new edge without attributes and pair (in creation order, before buildAdjacency() is called)
+      * \return the index of the new edge
+      */
+      unsigned addEdge(unsigned source, unsigned target, Key type, unsigned char direction);
+
+      /**
+      * \internal
+      * \brief sets the pair of the edges if they do not have one yet (like Graph::setEdgePair)
+      */
+      void setEdgePair(unsigned first, unsigned second);
+
+      /**
+      * \internal
+      * \brief sorts the edges by their source vertex (keeping the creation order of the out edges) and builds the adjacency offsets
+      */
+      void buildAdjacency();
+
+      /**
+      * \internal
+      * \brief encodes a vertex index as a vertex descriptor
+      */
+      static GraphVertex vertex(unsigned index) {
+        return reinterpret_cast<GraphVertex>(static_cast<size_t>(index) + 1);
+      }
+
+      /**
+      * \internal
+      * \brief decodes the index of a vertex descriptor
+      */
+      static unsigned vertexIndex(GraphVertex vertex) {
+        return static_cast<unsigned>(reinterpret_cast<size_t>(vertex) - 1);
+      }
+
+      /**
+      * \internal
+      * \brief encodes an edge index as an edge descriptor
+      */
+      static GraphEdge edge(GraphVertex source, GraphVertex target, unsigned index) {
+        return GraphEdge(source, target, reinterpret_cast<void*>(static_cast<size_t>(index) + 1));
+      }
+
+      /**
+      * \internal
+      * \brief decodes the index of an edge descriptor
+      */
+      static unsigned edgeIndex(const GraphEdge& edge) {
+        return static_cast<unsigned>(reinterpret_cast<size_t>(edge.get_property()) - 1);
+      }
+
+      /** \internal \brief the UIDs of the vertices */
+      std::vector<Key> vertexUIDs;
+      /** \internal \brief the types of the vertices */
+      std::vector<Key> vertexTypes;
+      /** \internal \brief the first attribute slots of the vertices */
+      std::vector<unsigned> vertexAttributeBegin;
+      /** \internal \brief the attribute slots after the last attributes of the vertices */
+      std::vector<unsigned> vertexAttributeEnd;
+      /** \internal \brief the out edges of vertex i are the [outEdgeBegin[i], outEdgeBegin[i + 1]) edges */
+      std::vector<unsigned> outEdgeBegin;
+
+      /** \internal \brief the source vertices of the edges (only while loading) */
+      std::vector<unsigned> edgeSources;
+      /** \internal \brief the target vertices of the edges */
+      std::vector<unsigned> edgeTargets;
+      /** \internal \brief the types of the edges */
+      std::vector<Key> edgeTypes;
+      /** \internal \brief the directions (Edge::eDirectionType) of the edges */
+      std::vector<unsigned char> edgeDirections;
+      /** \internal \brief the indices of the edge pairs (or noPair) */
+      std::vector<unsigned> edgePairs;
+      /** \internal \brief the first attribute slots of the edges */
+      std::vector<unsigned> edgeAttributeBegin;
+      /** \internal \brief the attribute slots after the last attributes of the edges */
+      std::vector<unsigned> edgeAttributeEnd;
+
+      /** \internal \brief the attribute slots pointing into the pools */
+      std::vector<Attribute*> attributeSlots;
+      /** \internal \brief the pool of the integer attributes */
+      std::deque<AttributeInt> ints;
+      /** \internal \brief the pool of the float attributes */
+      std::deque<AttributeFloat> floats;
+      /** \internal \brief the pool of the string attributes */
+      std::deque<AttributeString> strings;
+      /** \internal \brief the pool of the composite attributes */
+      std::deque<CompactAttributeComposite> composites;
+
+    private:
+
+      /** \internal \brief disabled copy constructor */
+      CompactStorage(const CompactStorage&);
+      /** \internal \brief disabled assignment operator */
+      CompactStorage& operator=(const CompactStorage&);
+  };
+
+}}
+
+#endif
@@ -83,5 +83,6 @@
 #define CMSG_EX_WRONG_XML_FORMAT                    "Wrong XML format"
 #define CMSG_EX_INVALID_ATTRIBUTE_FOUND             "Invalid attribute found"
 #define CMSG_EX_UNHANDLED_ATTRIBUTE_TYPE_FOUND      "Unhandled attribute type found"
+#define CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY          "The compact graph is read-only"
 
 #endif
@@ -23,6 +23,7 @@
 #include <iostream>
 #include <algorithm>
 #include "../privinc/messages.h"
+#include "../privinc/CompactStorage.h"
 
 using namespace std;
 
@@ -417,9 +418,13 @@ namespace columbus {  namespace graph {
     graphVertex(graphVertex),
     graphEdge(),
     attributeComposite(NULL),
-    iteratorType(iteratorOnVertex)
+    iteratorType(iteratorOnVertex),
+    compact(false),
+    compactBegin(0),
+    compactEnd(0),
+    compactIt(0)
   {
-    iterators->push_back(this);
+    init();
   }
 
   Attribute::AttributeIterator::AttributeIterator(Container *container, IteratorContainer *itContainer, Graph *graph, GraphEdge graphEdge, FilterFlags filter, Attribute::aType type , const string& name, const string& context) :
@@ -437,9 +442,13 @@ namespace columbus {  namespace graph {
     graphVertex(),
     graphEdge(graphEdge),
     attributeComposite(NULL),
-    iteratorType(iteratorOnEdge)
+    iteratorType(iteratorOnEdge),
+    compact(false),
+    compactBegin(0),
+    compactEnd(0),
+    compactIt(0)
   {
-    iterators->push_back(this);
+    init();
   }
 
   Attribute::AttributeIterator::AttributeIterator(Container *container, IteratorContainer *itContainer, Graph *graph, AttributeComposite* attrComposite, FilterFlags filter, Attribute::aType type , const string& name, const string& context) :
@@ -457,9 +466,13 @@ namespace columbus {  namespace graph {
     graphVertex(),
     graphEdge(),
     attributeComposite(attrComposite),
-    iteratorType(iteratorOnComposite)
+    iteratorType(iteratorOnComposite),
+    compact(false),
+    compactBegin(0),
+    compactEnd(0),
+    compactIt(0)
   {
-    iterators->push_back(this);
+    init();
   }
 
 
@@ -478,9 +491,13 @@ namespace columbus {  namespace graph {
     graphVertex(graphVertex),
     graphEdge(),
     attributeComposite(NULL),
-    iteratorType(iteratorOnVertex)
+    iteratorType(iteratorOnVertex),
+    compact(false),
+    compactBegin(0),
+    compactEnd(0),
+    compactIt(0)
   {
-    iterators->push_back(this);
+    init();
   }
 
   Attribute::AttributeIterator::AttributeIterator(Container *container, IteratorContainer *itContainer, Graph *graph, GraphEdge graphEdge) :
@@ -498,9 +515,13 @@ namespace columbus {  namespace graph {
     graphVertex(),
     graphEdge(graphEdge),
     attributeComposite(NULL),
-    iteratorType(iteratorOnEdge)
+    iteratorType(iteratorOnEdge),
+    compact(false),
+    compactBegin(0),
+    compactEnd(0),
+    compactIt(0)
   {
-    iterators->push_back(this);
+    init();
   }
 
   Attribute::AttributeIterator::AttributeIterator(Container *container, IteratorContainer *itContainer, Graph *graph, AttributeComposite* attrComposite) :
@@ -518,12 +539,42 @@ namespace columbus {  namespace graph {
     graphVertex(),
     graphEdge(),
     attributeComposite(attrComposite),
-    iteratorType(iteratorOnComposite)
+    iteratorType(iteratorOnComposite),
+    compact(false),
+    compactBegin(0),
+    compactEnd(0),
+    compactIt(0)
   {
-    iterators->push_back(this);
+    init();
+  }
+
+  void Attribute::AttributeIterator::init() {
+    if (container == NULL && graph != NULL && graph->compactStorage != NULL) {
+      const CompactStorage& storage = *graph->compactStorage;
+      compact = true;
+      switch (iteratorType) {
+        case iteratorOnVertex:
+          compactBegin = storage.vertexAttributeBegin[CompactStorage::vertexIndex(graphVertex)];
+          compactEnd = storage.vertexAttributeEnd[CompactStorage::vertexIndex(graphVertex)];
+          break;
+        case iteratorOnEdge:
+          compactBegin = storage.edgeAttributeBegin[CompactStorage::edgeIndex(graphEdge)];
+          compactEnd = storage.edgeAttributeEnd[CompactStorage::edgeIndex(graphEdge)];
+          break;
+        case iteratorOnComposite:
+          compactBegin = static_cast<CompactAttributeComposite*>(attributeComposite)->valuesBegin;
+          compactEnd = static_cast<CompactAttributeComposite*>(attributeComposite)->valuesEnd;
+          break;
+      }
+      compactIt = compactEnd;
+    } else if (iterators) {
+      iterators->push_back(this);
+    }
   }
 
   void Attribute::AttributeIterator::add(const Attribute& attribute) {
+    if (compact)
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
 
     for(AttributeList::iterator itc = container->begin(); itc != container->end(); itc++){
       if(attribute.equals(**itc)) throw AlreadyExist( COLUMBUS_LOCATION, CMSG_EX_ATTRIBUTE_ALREADY_EXIST);
@@ -550,6 +601,8 @@ namespace columbus {  namespace graph {
   }
 
   void Attribute::AttributeIterator::remove() {
+    if (compact)
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
     switch (lastOp) {
       case op_None:
       case op_Add:
@@ -582,7 +635,11 @@ namespace columbus {  namespace graph {
     graphVertex(),
     graphEdge(),
     attributeComposite(NULL),
-    iteratorType(iteratorOnEdge)
+    iteratorType(iteratorOnEdge),
+    compact(false),
+    compactBegin(0),
+    compactEnd(0),
+    compactIt(0)
   {
   }
 
@@ -602,7 +659,11 @@ namespace columbus {  namespace graph {
     graphVertex(iterator.graphVertex),
     graphEdge(iterator.graphEdge),
     attributeComposite(iterator.attributeComposite),
-    iteratorType(iterator.iteratorType)
+    iteratorType(iterator.iteratorType),
+    compact(iterator.compact),
+    compactBegin(iterator.compactBegin),
+    compactEnd(iterator.compactEnd),
+    compactIt(iterator.compactIt)
   {
     if (lastOp != op_Invalidated && iterators)
       iterators->push_back(this);
@@ -633,6 +694,10 @@ namespace columbus {  namespace graph {
     graphVertex = otherIt.graphVertex;
     graphEdge = otherIt.graphEdge;
     attributeComposite = otherIt.attributeComposite;
+    compact = otherIt.compact;
+    compactBegin = otherIt.compactBegin;
+    compactEnd = otherIt.compactEnd;
+    compactIt = otherIt.compactIt;
 
     container = otherIt.container;
     if (otherIt.lastOp != op_None )
@@ -654,10 +719,22 @@ namespace columbus {  namespace graph {
   }
 
   bool Attribute::AttributeIterator::hasNext() {
+    if (compact)
+      return nextCompactItem() != compactEnd;
     return nextItem() != container->end();
   }
 
   Attribute& Attribute::AttributeIterator::next() {
+    if (compact) {
+      compactIt = nextCompactItem();
+      lastOp = op_Next;
+
+      if (compactIt == compactEnd)
+        throw GraphNoSuchElementException( COLUMBUS_LOCATION, CMSG_EX_ITERATOR_NOT_PREVIUS_ELEMENT);
+
+      return *compactItem(compactIt);
+    }
+
     it = nextItem();
     lastOp = op_Next;
 
@@ -668,10 +745,22 @@ namespace columbus {  namespace graph {
   }
 
   bool Attribute::AttributeIterator::hasPrevious() {
+    if (compact)
+      return previousCompactItem() != compactEnd;
     return previousItem() != container->end();
   }
 
   Attribute& Attribute::AttributeIterator::previous() {
+    if (compact) {
+      compactIt = previousCompactItem();
+      lastOp = op_Previous;
+
+      if (compactIt == compactEnd)
+        throw GraphNoSuchElementException( COLUMBUS_LOCATION, CMSG_EX_ITERATOR_NOT_PREVIUS_ELEMENT);
+
+      return *compactItem(compactIt);
+    }
+
     it = previousItem();
     lastOp = op_Previous;
 
@@ -686,10 +775,11 @@ namespace columbus {  namespace graph {
       throw GraphInvalidIteratorException( COLUMBUS_LOCATION, CMSG_EX_INVALID_ITERATOR);
     bool itEqual = false;
     if ((lastOp != op_None || otherIt.lastOp != op_None ))
-      itEqual = it == otherIt.it;
+      itEqual = compact ? compactIt == otherIt.compactIt : it == otherIt.it;
     else
       itEqual = true;
     return itEqual && (lastOp == otherIt.lastOp) && (fFlags == otherIt.fFlags) && (container == otherIt.container)
+      && (compact == otherIt.compact) && (compactBegin == otherIt.compactBegin)
       && (graph == otherIt.graph) 
       && ((iteratorType == iteratorOnVertex)?(graphVertex == otherIt.graphVertex):1)
       && ((iteratorType == iteratorOnEdge)?(graphEdge == otherIt.graphEdge):1)
@@ -774,6 +864,37 @@ namespace columbus {  namespace graph {
     return container->end();
   }
 
+  unsigned Attribute::AttributeIterator::nextCompactItem() {
+    unsigned j;
+    switch (lastOp) {
+      case op_None:       j = compactBegin; break;
+      case op_Previous:   return compactIt;
+      case op_Invalidated:
+        throw GraphInvalidIteratorException( COLUMBUS_LOCATION, CMSG_EX_INVALID_ITERATOR);
+      default:            j = compactIt == compactEnd ? compactEnd : compactIt + 1; break;
+    }
+    while (j != compactEnd && isOutFilteredItem(compactItem(j)))
+      ++j;
+    return j;
+  }
+
+  unsigned Attribute::AttributeIterator::previousCompactItem() {
+    switch (lastOp) {
+      case op_None:       return compactEnd;
+      case op_Add:
+      case op_Next:       return compactIt;
+      case op_Remove:
+      case op_Previous:   return compactIt == compactBegin ? compactEnd : compactIt - 1;
+      case op_Invalidated:
+        throw GraphInvalidIteratorException( COLUMBUS_LOCATION, CMSG_EX_INVALID_ITERATOR);
+    }
+    return compactEnd;
+  }
+
+  Attribute* Attribute::AttributeIterator::compactItem(unsigned slot) const {
+    return graph->compactStorage->attributeSlots[slot];
+  }
+
   Attribute::AttributeIterator::Container::iterator Attribute::AttributeIterator::safeRemove(const Attribute::AttributeIterator::Container::iterator &_it) {
     Container::iterator nextElement = _it;
     ++nextElement;
@@ -850,7 +971,14 @@ namespace columbus {  namespace graph {
     if (this == &attribute)
       return;
       
-    if (attribute.values == NULL) {
+    if (attribute.isPooled()) {
+      values = new AttributeList();
+      AttributeVector pooledValues;
+      attribute.getValues(pooledValues);
+      for(AttributeVector::iterator it = pooledValues.begin(); it != pooledValues.end(); it++) {
+        values->push_back( (*it)->copy() );
+      }
+    } else if (attribute.values == NULL) {
       values = NULL;
     } else {
       values = new AttributeList();
@@ -871,9 +999,20 @@ namespace columbus {  namespace graph {
     if (this == &copy)
       return *this;
       
+    if (isPooled())
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
+
     Attribute::operator=(copy);
     iterators = copy.iterators;
-    if (copy.values == NULL) {
+    if (copy.isPooled()) {
+      iterators = NULL;
+      values = new AttributeList();
+      AttributeVector pooledValues;
+      copy.getValues(pooledValues);
+      for(AttributeVector::iterator it = pooledValues.begin(); it != pooledValues.end(); it++) {
+        values->push_back( (*it)->copy() );
+      }
+    } else if (copy.values == NULL) {
       values = NULL;
     } else {
       values = new AttributeList();
@@ -903,6 +1042,8 @@ namespace columbus {  namespace graph {
   bool AttributeComposite::deleteAttribute(const Attribute& attribute){
     if(graph == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_NODE);
+    if(isPooled())
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
     for(AttributeList::iterator it = values->begin(); it != values->end(); it++){
       if(attribute == **it) {
         delete *it;
@@ -917,6 +1058,8 @@ namespace columbus {  namespace graph {
   bool AttributeComposite::deleteAttribute(Attribute::aType type, const string& name){
     if(graph == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_NODE);
+    if(isPooled())
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
     bool deleted = false;;
     for(AttributeList::iterator it = values->begin(); it != values->end();){
       if( ((**it).getName() == name) && ((**it).getType() == type) ) {
@@ -934,6 +1077,8 @@ namespace columbus {  namespace graph {
   bool AttributeComposite::deleteAttribute(Attribute::aType type){
     if(graph == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_NODE);
+    if(isPooled())
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
     bool deleted = false;
     for(AttributeList::iterator it = values->begin(); it != values->end();){
       if( ((**it).getType() == type) ) {
@@ -957,6 +1102,18 @@ namespace columbus {  namespace graph {
     const AttributeComposite& attributeComposite = static_cast<const AttributeComposite&>(attribute);
     bool eq = Attribute::equals(attribute);
 
+    if (isPooled() || attributeComposite.isPooled()) {
+      AttributeVector values1, values2;
+      getValues(values1);
+      attributeComposite.getValues(values2);
+      if (values1.size() != values2.size())
+        return false;
+      for(size_t i = 0; eq && i < values1.size(); ++i) {
+        eq = values1[i]->equals(*values2[i]);
+      }
+      return eq;
+    }
+
     AttributeList::iterator it = values->begin();
     AttributeList::iterator it2 = attributeComposite.values->begin() ;
     for( ; eq && ( (it != values->end()) && (it2 != attributeComposite.values->end()) ); it++, it2++) {
@@ -969,8 +1126,16 @@ namespace columbus {  namespace graph {
 
   int AttributeComposite::hashCode() const {
     size_t hash = Attribute::hashCode();
-    for(AttributeList::iterator it = values->begin() ; it != values->end() ; it++) {
-      hash ^= (size_t)((*it)->hashCode());
+    if (isPooled()) {
+      AttributeVector attributes;
+      getValues(attributes);
+      for(AttributeVector::iterator it = attributes.begin() ; it != attributes.end() ; it++) {
+        hash ^= (size_t)((*it)->hashCode());
+      }
+    } else {
+      for(AttributeList::iterator it = values->begin() ; it != values->end() ; it++) {
+        hash ^= (size_t)((*it)->hashCode());
+      }
     }
     HASHLONGTOINT(hash)
     return (int)hash;
@@ -983,6 +1148,8 @@ namespace columbus {  namespace graph {
     if(value.graph == NULL) {
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_ADD_INVALID_ATTRIBUTE_TO_ATTRIBUTE);
     }
+    if(isPooled())
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
     
 /*    for(AttributeList::iterator it = values->begin(); it != values->end(); it++) {
       if(value.equals(**it)) throw AlreadyExist("Attribute::add(const Attribute& value)","Attribute is already exist");
@@ -1003,7 +1170,7 @@ namespace columbus {  namespace graph {
   Attribute::AttributeIterator AttributeComposite::findAttribute(const aType type, const string& name, const string& context) {
 
     Attribute::AttributeIterator::FilterFlags filter(true, true, true);
-    if(iterators == NULL)
+    if(iterators == NULL && values != NULL)
       iterators = new AttributeIterator::IteratorContainer();
     return Attribute::AttributeIterator(values, iterators, graph, this, filter, type, name, context);
 
@@ -1012,7 +1179,7 @@ namespace columbus {  namespace graph {
   Attribute::AttributeIterator AttributeComposite::findAttributeByType(Attribute::aType type)  {
 
     Attribute::AttributeIterator::FilterFlags filter(true, false, false);
-    if(iterators == NULL)
+    if(iterators == NULL && values != NULL)
       iterators = new AttributeIterator::IteratorContainer();
     return Attribute::AttributeIterator(values, iterators, graph, this, filter, type, "", "");
 
@@ -1021,7 +1188,7 @@ namespace columbus {  namespace graph {
   Attribute::AttributeIterator AttributeComposite::findAttributeByName(const string& name) {
 
     Attribute::AttributeIterator::FilterFlags filter(false, true, false);
-    if(iterators == NULL)
+    if(iterators == NULL && values != NULL)
       iterators = new AttributeIterator::IteratorContainer();
     return Attribute::AttributeIterator(values, iterators, graph, this, filter, Attribute::atInt, name, "");
 
@@ -1030,7 +1197,7 @@ namespace columbus {  namespace graph {
   Attribute::AttributeIterator AttributeComposite::findAttributeByContext(const string& context) {
 
     Attribute::AttributeIterator::FilterFlags filter(false, false, true);
-    if(iterators == NULL)
+    if(iterators == NULL && values != NULL)
       iterators = new AttributeIterator::IteratorContainer();
     return Attribute::AttributeIterator(values, iterators, graph, this, filter, Attribute::atInt, "", context);
 
@@ -1038,6 +1205,8 @@ namespace columbus {  namespace graph {
 
 
   void AttributeComposite::copyStrings(StrTable *from,StrTable *to) {
+    if(isPooled())
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
     Attribute::copyStrings(from, to);
     for(AttributeList::iterator it = values->begin(); it != values->end(); it++) {
       (*it)->copyStrings(from, to);
@@ -1045,12 +1214,28 @@ namespace columbus {  namespace graph {
   }
 
   void AttributeComposite::setGraph(Graph* graph) {
+    if(isPooled())
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
     this->graph = graph;
     for(AttributeList::iterator it = values->begin(); it != values->end(); it++) {
       (*it)->setGraph(graph);
     }
   }
 
+  bool AttributeComposite::isPooled() const {
+    return values == NULL && graph != NULL;
+  }
+
+  void AttributeComposite::getValues(AttributeVector& result) const {
+    if (isPooled()) {
+      const CompactAttributeComposite& pooled = static_cast<const CompactAttributeComposite&>(*this);
+      const vector<Attribute*>& slots = graph->compactStorage->attributeSlots;
+      result.assign(slots.begin() + pooled.valuesBegin, slots.begin() + pooled.valuesEnd);
+    } else if (values != NULL) {
+      result.assign(values->begin(), values->end());
+    }
+  }
+
   Attribute* AttributeComposite::copy() const{
     return new AttributeComposite(*this);
   }
@@ -1058,7 +1243,7 @@ namespace columbus {  namespace graph {
 
 
   Attribute::AttributeIterator AttributeComposite::getAttributes() {
-    if(iterators == NULL) {
+    if(iterators == NULL && values != NULL) {
       iterators = new AttributeIterator::IteratorContainer();
     }
     return Attribute::AttributeIterator(values, iterators, graph, this);
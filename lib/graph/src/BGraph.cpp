@@ -22,10 +22,14 @@
 
 #include "../privinc/GraphXmlHandler.h"
 #include "../privinc/GraphSchemaReader.h"
+#include "../privinc/CompactStorage.h"
 #include "boost/tuple/tuple_comparison.hpp"
 #include "boost/lexical_cast.hpp"
 #include "boost/algorithm/string/split.hpp"
 #include "boost/algorithm/string/classification.hpp"
+#include "boost/unordered_set.hpp"
+#include "boost/iostreams/device/mapped_file.hpp"
+#include <threadpool/inc/Executor.h>
 #include "../privinc/messages.h"
 
 using namespace boost;
@@ -61,8 +65,8 @@ namespace columbus {  namespace graph {
     , g( new BGraph())
     , strTable( new StrTable())
     , nodeUIDs()
-    , edgePairMap()
     , gsReader( new GraphSchemaReader())
+    , compactStorage(NULL)
   {
 
   }
@@ -71,6 +75,7 @@ namespace columbus {  namespace graph {
     
     clearAttributes();
     clearHelperContaioners();
+    delete compactStorage;
     clearHeaderInfo();
     delete g;
     delete strTable;
@@ -102,9 +107,17 @@ namespace columbus {  namespace graph {
     }
   }
   
+  void Graph::clearNodes() {
+    clearAttributes();
+    clearHelperContaioners();
+    delete compactStorage;
+    compactStorage = NULL;
+    delete g;
+    g = new BGraph();
+  }
+
   void Graph::clearHelperContaioners() {
     nodeUIDs.clear();
-    edgePairMap.clear();
     for(Attribute::AttributeIteratorOnVertexMap::iterator it = attributeIteratorsOnVertex.begin(); it != attributeIteratorsOnVertex.end(); ++it) {
       for(Attribute::AttributeIteratorList::iterator it2 = it->second->begin(); it2 != it->second->end(); ++it2) {
         (*it2)->invalidate();
@@ -221,8 +234,8 @@ namespace columbus {  namespace graph {
     , g(new BGraph())
     , strTable(new StrTable(*graph.strTable))
     , nodeUIDs()
-    , edgePairMap()
     , gsReader(new GraphSchemaReader(*graph.gsReader))
+    , compactStorage(NULL)
   {
     copyGraph(graph);
   }
@@ -237,11 +250,15 @@ namespace columbus {  namespace graph {
     headerInformations = graph.headerInformations;
 
     clearHelperContaioners();
+    delete compactStorage;
+    compactStorage = NULL;
     copyGraph(graph);
     return *this;
   }
 
   Attribute::AttributeIteratorList* Graph::getAttributeIteratorOnVertex(GraphVertex vertex) {
+    if (compactStorage)
+      return NULL;
     Attribute::AttributeIteratorOnVertexMap::iterator it = attributeIteratorsOnVertex.find(vertex);
     if(it == attributeIteratorsOnVertex.end()) {
       Attribute::AttributeIteratorList* attributeList = new Attribute::AttributeIteratorList();
@@ -264,6 +281,8 @@ namespace columbus {  namespace graph {
   }
 
   Attribute::AttributeIteratorList* Graph::getAttributeIteratorOnEdge(GraphEdge edge) {
+    if (compactStorage)
+      return NULL;
     Attribute::AttributeIteratorOnEdgeMap::iterator it = attributeIteratorsOnEdge.find(edge);
     if(it == attributeIteratorsOnEdge.end()) {
       Attribute::AttributeIteratorList* attributeList = new Attribute::AttributeIteratorList();
@@ -286,6 +305,8 @@ namespace columbus {  namespace graph {
   }
 
   Graph::EdgeIteratorList* Graph::getEdgeIteratorOnNode(GraphVertex vertex) {
+    if (compactStorage)
+      return NULL;
     EdgeIteratorOnNodeMap::iterator it = edgeIteratorOnNode.find(vertex);
     if(it == edgeIteratorOnNode.end()) {
       EdgeIteratorList* edgeList = new EdgeIteratorList();
@@ -313,6 +334,7 @@ namespace columbus {  namespace graph {
   }
 
   Node Graph::createNode(const string& UID, const Node::NodeType& NTYPE){
+    checkModifiable();
 
     if(!gsReader->canAddNode(NTYPE.getType())) 
       throw GraphSchemaException( COLUMBUS_LOCATION, CMSG_EX_CANT_ADD_TYPE( NTYPE.getType()));
@@ -337,6 +359,7 @@ namespace columbus {  namespace graph {
   }
 
   Node Graph::createNode(Key UIDKey, Key NTYPEKey){
+    checkModifiable();
 
     KeyMap::iterator it = nodeUIDs.find(UIDKey);
     if(it != nodeUIDs.end() ) {
@@ -360,6 +383,7 @@ namespace columbus {  namespace graph {
   }
 
   Node Graph::addNode(const Node& node) {
+    checkModifiable();
     if(!gsReader->canAddNode(node.getType().getType()))
       throw GraphSchemaException( COLUMBUS_LOCATION, CMSG_EX_CANT_ADD_TYPE( node.getType().getType()));
 
@@ -403,13 +427,13 @@ namespace columbus {  namespace graph {
       edge_iter edge_it_del = edge_it;
       ++edge_it;
       if(source(*edge_it_del, *g) == node || target(*edge_it_del, *g) == node) {
-        edgePairMap.erase(*edge_it_del);
         delete_edge(*edge_it_del);
       }
     }
   }
 
   bool Graph::deleteNode(const string& UID) {
+    checkModifiable();
     Key UIDKey = strTable->set(UID);
     KeyMap::iterator it = nodeUIDs.find(UIDKey);
     if(it == nodeUIDs.end() ) {
@@ -435,6 +459,7 @@ namespace columbus {  namespace graph {
   }
 
   bool Graph::deleteNode(const Node::NodeType& NTYPE) {
+    checkModifiable();
     bool deleted = false;
 
     IndexMapVertexTypes types = get(vertex_type,*g);
@@ -476,7 +501,7 @@ namespace columbus {  namespace graph {
   }
 
   const string& Graph::getVertexUID(const GraphVertex& vertex) const {
-    return getStrTable()->get( get(vertex_UID,*getBGraph(),vertex) );
+    return getStrTable()->get( getVertexUIDKey(vertex) );
   }
 
   void Graph::setVertexUID(const GraphVertex& vertex, const string& uid) {
@@ -484,7 +509,7 @@ namespace columbus {  namespace graph {
     if(it != nodeUIDs.end()) {
       throw AlreadyExist( COLUMBUS_LOCATION, CMSG_EX_NODE_ALREADY_EXIST_WITH_ID( uid));
     }
-    Key& uidKey = get(vertex_UID,*getBGraph(),vertex);
+    Key& uidKey = compactStorage ? compactStorage->vertexUIDs[CompactStorage::vertexIndex(vertex)] : get(vertex_UID,*getBGraph(),vertex);
     it = nodeUIDs.find(uidKey);
     if(it != nodeUIDs.end()) {
       nodeUIDs.erase(it);
@@ -495,27 +520,146 @@ namespace columbus {  namespace graph {
 
 
   const Node::NodeType Graph::getVertexType(const GraphVertex& vertex) const {
-    return Node::NodeType(getStrTable()->get( get(vertex_type,*getBGraph(),vertex) ));
+    return Node::NodeType(getStrTable()->get( getVertexTypeKey(vertex) ));
   }
 
   AttributeList* Graph::getAttributeList(const GraphVertex& vertex) const {
+    if (compactStorage)
+      return NULL;
     return get(vertex_attributes,*getBGraph(),vertex);
   }
 
   const Edge::EdgeType Graph::getEdgeType(const GraphEdge& edge) const {
-    return Edge::EdgeType(getStrTable()->get( get(edge_type,*getBGraph(),edge) ),(Edge::eDirectionType)get(edge_direction,*getBGraph(),edge) );
+    return Edge::EdgeType(getStrTable()->get( getEdgeTypeKey(edge) ), getEdgeDirection(edge) );
   }
 
   AttributeList* Graph::getAttributeList(const GraphEdge& edge) const {
+    if (compactStorage)
+      return NULL;
     return get(edge_attributes,*getBGraph(),edge);
   }
 
+  Key Graph::getVertexUIDKey(const GraphVertex& vertex) const {
+    if (compactStorage)
+      return compactStorage->vertexUIDs[CompactStorage::vertexIndex(vertex)];
+    return get(vertex_UID,*getBGraph(),vertex);
+  }
+
+  Key Graph::getVertexTypeKey(const GraphVertex& vertex) const {
+    if (compactStorage)
+      return compactStorage->vertexTypes[CompactStorage::vertexIndex(vertex)];
+    return get(vertex_type,*getBGraph(),vertex);
+  }
+
+  Key Graph::getEdgeTypeKey(const GraphEdge& edge) const {
+    if (compactStorage)
+      return compactStorage->edgeTypes[CompactStorage::edgeIndex(edge)];
+    return get(edge_type,*getBGraph(),edge);
+  }
+
+  Edge::eDirectionType Graph::getEdgeDirection(const GraphEdge& edge) const {
+    if (compactStorage)
+      return (Edge::eDirectionType)compactStorage->edgeDirections[CompactStorage::edgeIndex(edge)];
+    return (Edge::eDirectionType)get(edge_direction,*getBGraph(),edge);
+  }
+
+  size_t Graph::getAttributeCount(const GraphVertex& vertex) const {
+    if (compactStorage) {
+      unsigned index = CompactStorage::vertexIndex(vertex);
+      return compactStorage->vertexAttributeEnd[index] - compactStorage->vertexAttributeBegin[index];
+    }
+    return get(vertex_attributes,*getBGraph(),vertex)->size();
+  }
+
+  size_t Graph::getAttributeCount(const GraphEdge& edge) const {
+    if (compactStorage) {
+      unsigned index = CompactStorage::edgeIndex(edge);
+      return compactStorage->edgeAttributeEnd[index] - compactStorage->edgeAttributeBegin[index];
+    }
+    return get(edge_attributes,*getBGraph(),edge)->size();
+  }
+
+  void Graph::checkModifiable() const {
+    if (compactStorage)
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
+  }
+
+  bool Graph::isCompact() const {
+    return compactStorage != NULL;
+  }
+
+  template<class Visitor>
+  void Graph::forEachVertex(Visitor visitor) const {
+    if (compactStorage) {
+      unsigned vertexCount = compactStorage->getVertexCount();
+      for (unsigned i = 0; i < vertexCount; ++i)
+        visitor(CompactStorage::vertex(i));
+      return;
+    }
+    vertex_iter vertex_begin, vertex_end;
+    for (boost::tie(vertex_begin, vertex_end) = vertices(*g); vertex_begin != vertex_end; ++vertex_begin)
+      visitor(*vertex_begin);
+  }
+
+  template<class Visitor>
+  void Graph::forEachOutEdge(GraphVertex vertex, Visitor visitor) const {
+    if (compactStorage) {
+      unsigned index = CompactStorage::vertexIndex(vertex);
+      for (unsigned i = compactStorage->outEdgeBegin[index]; i < compactStorage->outEdgeBegin[index + 1]; ++i)
+        visitor(CompactStorage::edge(vertex, CompactStorage::vertex(compactStorage->edgeTargets[i]), i));
+      return;
+    }
+    out_edge_iter edge_begin, edge_end;
+    for (boost::tie(edge_begin, edge_end) = out_edges(vertex, *g); edge_begin != edge_end; ++edge_begin)
+      visitor(*edge_begin);
+  }
+
+  template<class Visitor>
+  void Graph::forEachAttribute(GraphVertex vertex, Visitor visitor) const {
+    if (compactStorage) {
+      unsigned index = CompactStorage::vertexIndex(vertex);
+      for (unsigned i = compactStorage->vertexAttributeBegin[index]; i < compactStorage->vertexAttributeEnd[index]; ++i)
+        visitor(*compactStorage->attributeSlots[i]);
+      return;
+    }
+    AttributeList* attributes = get(vertex_attributes, *g, vertex);
+    for (AttributeList::iterator it = attributes->begin(); it != attributes->end(); ++it)
+      visitor(**it);
+  }
+
+  template<class Visitor>
+  void Graph::forEachAttribute(const GraphEdge& edge, Visitor visitor) const {
+    if (compactStorage) {
+      unsigned index = CompactStorage::edgeIndex(edge);
+      for (unsigned i = compactStorage->edgeAttributeBegin[index]; i < compactStorage->edgeAttributeEnd[index]; ++i)
+        visitor(*compactStorage->attributeSlots[i]);
+      return;
+    }
+    AttributeList* attributes = get(edge_attributes, *g, edge);
+    for (AttributeList::iterator it = attributes->begin(); it != attributes->end(); ++it)
+      visitor(**it);
+  }
+
+  template<class Visitor>
+  void Graph::forEachAttribute(const AttributeComposite& composite, Visitor visitor) const {
+    if (composite.isPooled()) {
+      const CompactAttributeComposite& pooled = static_cast<const CompactAttributeComposite&>(composite);
+      const vector<Attribute*>& slots = composite.graph->compactStorage->attributeSlots;
+      for (unsigned i = pooled.valuesBegin; i < pooled.valuesEnd; ++i)
+        visitor(*slots[i]);
+      return;
+    }
+    for (AttributeList::iterator it = composite.values->begin(); it != composite.values->end(); ++it)
+      visitor(**it);
+  }
+
   GraphEdge Graph::createEdge(GraphVertex fromVertex, GraphVertex toVertex, const string& type, Edge::eDirectionType directionType) {
     return createEdge(fromVertex, toVertex, strTable->set(type), directionType);
   }
 
   GraphEdge Graph::createEdge(GraphVertex fromVertex, GraphVertex toVertex, Key typeKey, Edge::eDirectionType directionType) {
-    
+    checkModifiable();
+
     AttributeList *elementAttr = new AttributeList();
     EdgeAttributes edgeAttr(elementAttr);
     EdgeDirection edgeDirection(directionType,elementAttr);
@@ -533,8 +677,7 @@ namespace columbus {  namespace graph {
     GraphEdge g_edge,revEdge;
     g_edge = edge.edge;
     revEdge = createEdge(fromVertex,toVertex,type,Edge::edtReverse);
-    edgePairMap.insert(make_pair(g_edge,revEdge));
-    edgePairMap.insert(make_pair(revEdge,g_edge));
+    setEdgePair(g_edge, revEdge);
     return Edge(this,revEdge);
   }
 
@@ -594,8 +737,7 @@ namespace columbus {  namespace graph {
       if(!gsReader->canAddEdge(type, Edge::edtReverse, to.getType().getType(), from.getType().getType()) )
         throw GraphSchemaException( COLUMBUS_LOCATION, CMSG_EX_CANT_ADD_REVERSE( type, to.getType().getType(), from.getType().getType()));
       revEdge = createEdge(toVertex,fromVertex,type,Edge::edtReverse);
-      edgePairMap.insert(make_pair(edge,revEdge));
-      edgePairMap.insert(make_pair(revEdge,edge));
+      setEdgePair(edge, revEdge);
 
     }
     return Edge(this,edge);
@@ -612,8 +754,7 @@ namespace columbus {  namespace graph {
     
     if(createReverse) {
       revEdge = createEdge(toVertex, fromVertex, typeKey, Edge::edtReverse);
-      edgePairMap.insert(make_pair(edge,revEdge));
-      edgePairMap.insert(make_pair(revEdge,edge));
+      setEdgePair(edge, revEdge);
 
     }
     return Edge(this,edge);
@@ -621,6 +762,7 @@ namespace columbus {  namespace graph {
 
 
   Edge Graph::createDirectedEdge(const string& fromUID, const string& toUID, const string& type, bool createReverse) {
+    checkModifiable();
 
     GraphVertex fromVertex, toVertex;
     KeyMap::iterator fromIt,toIt;
@@ -640,8 +782,7 @@ namespace columbus {  namespace graph {
         if(!gsReader->canAddEdge(type, Edge::edtDirectional, strTable->get(get(vertex_type,*getBGraph(),fromVertex)), strTable->get(get(vertex_type,*getBGraph(),toVertex))))
           throw GraphSchemaException( COLUMBUS_LOCATION, CMSG_EX_CANT_ADD_REVERSE( type, strTable->get(get(vertex_type,*getBGraph(),toVertex)),strTable->get(get(vertex_type,*getBGraph(),fromVertex))));
         revEdge = createEdge(toVertex,fromVertex,type,Edge::edtReverse);
-        edgePairMap.insert(make_pair(edge,revEdge));
-        edgePairMap.insert(make_pair(revEdge,edge));
+        setEdgePair(edge, revEdge);
       }
       return Edge(this,edge);
     }
@@ -656,8 +797,7 @@ namespace columbus {  namespace graph {
     GraphVertex fromVertex = from.vertex, toVertex = to.vertex;
     GraphEdge edge = createEdge(fromVertex,toVertex,type,Edge::edtBidirectional);
     GraphEdge revEdge = createEdge(toVertex,fromVertex,type,Edge::edtBidirectional);
-    edgePairMap.insert(make_pair(edge,revEdge));
-    edgePairMap.insert(make_pair(revEdge,edge));
+    setEdgePair(edge, revEdge);
     return Edge(this,edge);
   }
 
@@ -667,13 +807,13 @@ namespace columbus {  namespace graph {
     GraphVertex fromVertex = from.vertex, toVertex = to.vertex;
     GraphEdge edge = createEdge(fromVertex,toVertex, typeKey, Edge::edtBidirectional);
     GraphEdge revEdge = createEdge(toVertex,fromVertex, typeKey, Edge::edtBidirectional);
-    edgePairMap.insert(make_pair(edge,revEdge));
-    edgePairMap.insert(make_pair(revEdge,edge));
+    setEdgePair(edge, revEdge);
     return Edge(this,edge);
   }
 
 
   Edge Graph::createBidirectedEdge(const string& fromUID, const string& toUID, const string& type) {
+    checkModifiable();
 
     GraphVertex fromVertex, toVertex;
     KeyMap::iterator fromIt,toIt;
@@ -689,8 +829,7 @@ namespace columbus {  namespace graph {
 
       edge = createEdge(fromVertex,toVertex,type,Edge::edtBidirectional);
       revEdge = createEdge(toVertex,fromVertex,type,Edge::edtBidirectional);
-      edgePairMap.insert(make_pair(edge,revEdge));
-      edgePairMap.insert(make_pair(revEdge,edge));
+      setEdgePair(edge, revEdge);
       return Edge(this,edge);
     }
     return invalidEdge;
@@ -708,14 +847,14 @@ namespace columbus {  namespace graph {
   }
 
   Node::NodeIterator Graph::findNodes(const Node::NodeType& NTYPE) {
-    vertex_iter n_begin,n_end;
-    boost::tie(n_begin,n_end) = vertices(*g);
     Node::NodeTypeSet nts;
     nts.insert(NTYPE);
-    return Node::NodeIterator(n_begin,n_end,getNodeIterators(),this,nts);
+    return findNodes(nts);
   }
 
   Node::NodeIterator Graph::findNodes(const Node::NodeTypeSet& NTS) {
+    if (compactStorage)
+      return Node::NodeIterator(this, compactStorage->getVertexCount(), NTS);
     vertex_iter n_begin,n_end;
     boost::tie(n_begin,n_end) = vertices(*g);
     return Node::NodeIterator(n_begin,n_end,getNodeIterators(),this,NTS);
@@ -742,6 +881,13 @@ namespace columbus {  namespace graph {
 
 
   void Graph::delete_edge(const GraphEdge& edge) {
+    // the remaining pair must not refer to the deleted edge
+    if(hasEdgePair(edge)) {
+      GraphEdge edgePair = getEdgePair(edge);
+      if(get(edge_pair, *g, edgePair) == edge.get_property())
+        put(edge_pair, *g, edgePair, static_cast<void*>(NULL));
+    }
+
     AttributeList *edge_attr = getAttributeList(edge);
     deleteIteratorContainerFromEdge(edge);
     for(AttributeList::iterator it = edge_attr->begin(); it != edge_attr->end(); it++) {
@@ -752,17 +898,17 @@ namespace columbus {  namespace graph {
   }
 
   void Graph::deleteEdge(const Edge& edge) {
-    delete_edge(edge.edge);
+    checkModifiable();
     // remove edge pair
     if(hasEdgePair(edge.edge)) {
       GraphEdge edgePair = getEdgePair(edge.edge);
       delete_edge(edgePair);
-      edgePairMap.erase(edge.edge);
-      edgePairMap.erase(edgePair);
     }
+    delete_edge(edge.edge);
   }
 
   void Graph::deleteEdge(const Edge::EdgeType& type) {
+    checkModifiable();
     IndexMapEdgeTypes edgeTypes = get(edge_type,*g);
     IndexMapEdgeDirection edgeDirections = get(edge_direction,*g);
     Key typeKey = strTable->get(type.getType());
@@ -782,8 +928,6 @@ namespace columbus {  namespace graph {
             ++it;
           }
           delete_edge(edgePair);
-          edgePairMap.erase(*del_it);
-          edgePairMap.erase(edgePair);
         }
         delete_edge(*del_it);
       }
@@ -791,6 +935,7 @@ namespace columbus {  namespace graph {
   }
 
   void Graph::deleteEdge(const Node& from, const Node& to) {
+    checkModifiable();
     IndexMapEdgeDirection edgeDirections = get(edge_direction,*g);
     out_edge_iter it,e_begin, e_end;
     boost::tie(e_begin, e_end) = out_edges(from.vertex, *getBGraph());
@@ -804,8 +949,6 @@ namespace columbus {  namespace graph {
            (edgeDirections[*it] == static_cast<int>(Edge::edtDirectional)) ) ) {
           GraphEdge edgePair = getEdgePair(*it);
           delete_edge(edgePair);
-          edgePairMap.erase(*it);
-          edgePairMap.erase(edgePair);
         }
         ++it;
         delete_edge(*deletable_it);
@@ -817,21 +960,33 @@ namespace columbus {  namespace graph {
   }
 
   GraphEdge Graph::getEdgePair(GraphEdge edge) const {
-    EdgePairMap::const_iterator it = edgePairMap.find(edge);
-    if(it != edgePairMap.end() ) {
-      return it->second;
+    if (compactStorage) {
+      unsigned pair = compactStorage->edgePairs[CompactStorage::edgeIndex(edge)];
+      if (pair == CompactStorage::noPair)
+        throw EdgeNotFound("Graph::getEdgePair(GraphEdge edge)","Edge pair not found!");
+      return CompactStorage::edge(edge.m_target, edge.m_source, pair);
+    }
+    void* pairProperty = get(edge_pair, *g, edge);
+    if(pairProperty != NULL) {
+      // the pair always goes in the opposite direction
+      return GraphEdge(target(edge, *g), source(edge, *g), pairProperty);
     } else {
       throw EdgeNotFound("Graph::getEdgePair(GraphEdge edge)","Edge pair not found!");
     }
   }
 
   bool Graph::hasEdgePair(GraphEdge edge) const {
-    EdgePairMap::const_iterator it = edgePairMap.find(edge);
-    if(it != edgePairMap.end() ) {
-      return true;
-    } else {
-      return false;
-    }
+    if (compactStorage)
+      return compactStorage->edgePairs[CompactStorage::edgeIndex(edge)] != CompactStorage::noPair;
+    return get(edge_pair, *g, edge) != NULL;
+  }
+
+  void Graph::setEdgePair(GraphEdge edge, GraphEdge pair) {
+    // an existing pair is kept (like by the insertion into a map)
+    if(!hasEdgePair(edge))
+      put(edge_pair, *g, edge, pair.get_property());
+    if(!hasEdgePair(pair))
+      put(edge_pair, *g, pair, edge.get_property());
   }
 
   void Graph::traverseBreadthFirst(const Node& startNode, const Edge::EdgeTypeSet& edges, 
@@ -1057,9 +1212,9 @@ namespace columbus {  namespace graph {
           sio.writeAttribute(XML_GRAPH_NAME, attrComp.getName());
           sio.writeAttribute(XML_GRAPH_CONTEXT, attrComp.getContext());
           // write out composite elements
-          for(AttributeList::iterator it = attrComp.values->begin(); it != attrComp.values->end(); it++) {
-            writeAttributeToXml(**it, sio);
-          }
+          forEachAttribute(attrComp, [&](Attribute& value) {
+            writeAttributeToXml(value, sio);
+          });
           sio.writeEndElement();
         }
       default:
@@ -1085,14 +1240,12 @@ namespace columbus {  namespace graph {
     }
     sio.writeEndElement();
     sio.writeBeginElement(XML_GRAPH_DATA);
-    vertex_iter vertex_begin, vertex_end,vertex_it;
-    boost::tie(vertex_begin,vertex_end) = vertices(*g);
 
     list<Node> nodeList;
 
-    for(vertex_it = vertex_begin; vertex_it != vertex_end; vertex_it++) {
-      nodeList.push_back( Node( const_cast<Graph*>(this),*vertex_it) );
-    }
+    forEachVertex([&](GraphVertex vertex) {
+      nodeList.push_back( Node( const_cast<Graph*>(this),vertex) );
+    });
 
     nodeList.sort(compareNodeByUID);
 
@@ -1101,21 +1254,18 @@ namespace columbus {  namespace graph {
       GraphVertex vertex = it->vertex;
       // write node
       sio.writeBeginElement(XML_GRAPH_NODE);
-      sio.writeAttribute(XML_GRAPH_NAME, strTable->get(get(vertex_UID,*g,vertex) ) );
-      sio.writeAttribute(XML_GRAPH_TYPE,strTable->get(get(vertex_type,*g,vertex) ) );
-      AttributeList *vertex_attr = get(vertex_attributes,*g,vertex);
+      sio.writeAttribute(XML_GRAPH_NAME, strTable->get(getVertexUIDKey(vertex) ) );
+      sio.writeAttribute(XML_GRAPH_TYPE,strTable->get(getVertexTypeKey(vertex) ) );
       // write attributes
-      for(AttributeList::iterator it = vertex_attr->begin(); it != vertex_attr->end(); it++) {
-        writeAttributeToXml(**it,sio);
-      }
+      forEachAttribute(vertex, [&](Attribute& attribute) {
+        writeAttributeToXml(attribute,sio);
+      });
       // write out edges
-      out_edge_iter edge_begin, edge_end, edge_it;
-      boost::tie(edge_begin,edge_end) = out_edges(vertex,*g);
-      for(edge_it = edge_begin; edge_it != edge_end; edge_it++) {
-        if(get(edge_direction,*g,*edge_it) != Edge::edtReverse && savedEdgePairs.find(*edge_it) == savedEdgePairs.end() ) {
+      forEachOutEdge(vertex, [&](const GraphEdge& edge) {
+        if(getEdgeDirection(edge) != Edge::edtReverse && savedEdgePairs.find(edge) == savedEdgePairs.end() ) {
           sio.writeBeginElement(XML_GRAPh_EDGE);
-          sio.writeAttribute(XML_GRAPH_TYPE, strTable->get(get(edge_type,*g,*edge_it) ) );
-          switch(get(edge_direction,*g,*edge_it)) {
+          sio.writeAttribute(XML_GRAPH_TYPE, strTable->get(getEdgeTypeKey(edge) ) );
+          switch(getEdgeDirection(edge)) {
             case Edge::edtBidirectional:
               sio.writeAttribute(XML_GRAPH_DIRECTION,"bidirectional");
               break;
@@ -1125,25 +1275,23 @@ namespace columbus {  namespace graph {
             default:
               break;
           }
-          sio.writeAttribute(XML_GRAPH_EDGE_TO, strTable->get(get(vertex_UID,*g,target(*edge_it,*g) ) ) );
+          sio.writeAttribute(XML_GRAPH_EDGE_TO, strTable->get(getVertexUIDKey(target(edge,*g)) ) );
           // write reserve pair edge
-          if(hasEdgePair(*edge_it)) {
-            GraphEdge reservePair = getEdgePair(*edge_it);
+          if(hasEdgePair(edge)) {
+            GraphEdge reservePair = getEdgePair(edge);
             savedEdgePairs.insert(reservePair);
             sio.writeBeginElement(XML_GRAPH_EDGE_PAIR);
-            AttributeList *edge_attr = get(edge_attributes,*g,reservePair);
-            for(AttributeList::iterator it = edge_attr->begin(); it != edge_attr->end(); it++) {
-              writeAttributeToXml(**it,sio);
-            }
+            forEachAttribute(reservePair, [&](Attribute& attribute) {
+              writeAttributeToXml(attribute,sio);
+            });
             sio.writeEndElement();
           }
-          AttributeList *edge_attr = get(edge_attributes,*g,*edge_it);
-          for(AttributeList::iterator it = edge_attr->begin(); it != edge_attr->end(); it++) {
-            writeAttributeToXml(**it,sio);
-          }
+          forEachAttribute(edge, [&](Attribute& attribute) {
+            writeAttributeToXml(attribute,sio);
+          });
           sio.writeEndElement();
         }
-      }
+      });
       // write node end
       sio.writeEndElement();
     }
@@ -1301,40 +1449,29 @@ namespace columbus {  namespace graph {
       sio.writeAttribute("edgedefault", "directed");
       sio.writeAttribute("id", "G");
 
-      vertex_iter vertex_begin;
-      vertex_iter vertex_end;
-      vertex_iter vertex_it;
-
-      out_edge_iter edge_begin;
-      out_edge_iter edge_end;
-      out_edge_iter edge_it;
-
-      boost::tie(vertex_begin, vertex_end) = vertices(*g);
-
       unsigned edge_counter = 0;
       set<GraphEdge> visitedEdges;
 
 
       // For every vertex
-      for(vertex_it = vertex_begin; vertex_it != vertex_end; vertex_it++) {
-        createGMLNode(sio, *vertex_it, strTable->get(get(vertex_type, *g, *vertex_it)));
-        
-        boost::tie(edge_begin, edge_end) = out_edges(*vertex_it, *g);
+      forEachVertex([&](GraphVertex vertex) {
+        createGMLNode(sio, vertex, strTable->get(getVertexTypeKey(vertex)));
         
         // For every outgoing edges 
-        for(edge_it = edge_begin; edge_it != edge_end; edge_it++, edge_counter++) {
-          Edge::eDirectionType et = (Edge::eDirectionType)get(edge_direction, *g, *edge_it);
+        forEachOutEdge(vertex, [&](const GraphEdge& edge) {
+          Edge::eDirectionType et = getEdgeDirection(edge);
           
           if (et == Edge::edtBidirectional) {
             // Only one edge of the bidirectional edges are exported. 
-            if (visitedEdges.find(edgePairMap.find(*edge_it)->second) == visitedEdges.end()) {
-              createGMLEdge(sio, edge_counter, source(*edge_it, *g), target(*edge_it, *g), et, strTable->get(get(edge_type, *g, *edge_it)));
-              visitedEdges.insert(*edge_it);
+            if (visitedEdges.find(getEdgePair(edge)) == visitedEdges.end()) {
+              createGMLEdge(sio, edge_counter, source(edge, *g), target(edge, *g), et, strTable->get(getEdgeTypeKey(edge)));
+              visitedEdges.insert(edge);
             }
           } else
-            createGMLEdge(sio, edge_counter, source(*edge_it, *g), target(*edge_it, *g), et, strTable->get(get(edge_type, *g, *edge_it)));
-        }
-      }      
+            createGMLEdge(sio, edge_counter, source(edge, *g), target(edge, *g), et, strTable->get(getEdgeTypeKey(edge)));
+          edge_counter++;
+        });
+      });
       
       sio.writeEndElement();
 
@@ -1394,24 +1531,17 @@ namespace columbus {  namespace graph {
     
     NodeTypesMapType nodeTypes;
 
-    vertex_iter vertex_begin;
-    vertex_iter vertex_end;
-    vertex_iter vertex_it;
-
-    boost::tie(vertex_begin, vertex_end) = vertices(*g);
-
     // Collecting the vertex types and attributes
-    for(vertex_it = vertex_begin; vertex_it != vertex_end; vertex_it++) {
-
-      TripletSet& attributeSet = nodeTypes.insert(make_pair(get(vertex_type, *g, *vertex_it), TripletSet())).first->second;
+    forEachVertex([&](GraphVertex vertex) {
 
-      AttributeList *vertex_attr = get(vertex_attributes, *g, *vertex_it);
+      TripletSet& attributeSet = nodeTypes.insert(make_pair(getVertexTypeKey(vertex), TripletSet())).first->second;
 
       // Collceting the attributes of the vertex
-      for(AttributeList::iterator it = vertex_attr->begin(); it != vertex_attr->end(); it++)
-        attributeSet.insert(boost::make_tuple((*it)->name, (*it)->context, (*it)->getType()));
+      forEachAttribute(vertex, [&](Attribute& attribute) {
+        attributeSet.insert(boost::make_tuple(attribute.name, attribute.context, attribute.getType()));
+      });
 
-    }
+    });
 
     // Iterate through the vertices of each type
     for (NodeTypesMapType::const_iterator tit = nodeTypes.begin(); tit != nodeTypes.end(); ++tit) {
@@ -1426,28 +1556,28 @@ namespace columbus {  namespace graph {
       cio.writeNewLine();
 
       // Looking for an exact type of vertices
-      for(vertex_it = vertex_begin; vertex_it != vertex_end; vertex_it++)
-        if (tit->first == get(vertex_type, *g, *vertex_it)) {
+      forEachVertex([&](GraphVertex vertex) {
+        if (tit->first == getVertexTypeKey(vertex)) {
           // Write out the UID of the vertex
-          cio.writeColumn(strTable->get(get(vertex_UID, *g, *vertex_it)));
+          cio.writeColumn(strTable->get(getVertexUIDKey(vertex)));
 
           // Write out the attributes of the vertex
           for (TripletSet::const_iterator sit = tit->second.begin(); sit != tit->second.end(); ++sit) {
             bool found = false;
 
-            AttributeList *vertex_attr = get(vertex_attributes, *g, *vertex_it);
-            for(AttributeList::iterator it = vertex_attr->begin(); it != vertex_attr->end(); it++)
-              if (boost::make_tuple((*it)->name, (*it)->context, (*it)->getType()) == *sit) {
-                cio.writeColumn(getAttributeValue(*it));
+            forEachAttribute(vertex, [&](Attribute& attribute) {
+              if (!found && boost::make_tuple(attribute.name, attribute.context, attribute.getType()) == *sit) {
+                cio.writeColumn(getAttributeValue(&attribute));
                 found = true;
-                break;
               }
+            });
             
             if (!found)
               cio.writeColumn(_EMPTY_FIELD);
           }
           cio.writeNewLine();
         }
+      });
 
       cio.writeNewLine();
     }
@@ -2170,6 +2300,8 @@ namespace columbus {  namespace graph {
   //--- Create attributes end
 
   void Graph::initAttribute(const Node::NodeTypeSet& nodeTypeSet,const Attribute& attr) {
+    checkModifiable();
+
     vertex_iter vertex_begin, vertex_end, vertex_it;
     boost::tie(vertex_begin,vertex_end) = vertices(*g);
 
@@ -2185,11 +2317,9 @@ namespace columbus {  namespace graph {
   Node::NodeSet Graph::getRootByEdgeType(const Edge::EdgeType& edgeType) {
     Node::NodeSet root;
 
-    vertex_iter vertex_begin, vertex_end, vertex_it;
-    boost::tie(vertex_begin,vertex_end) = vertices(*g);
-
-    for(vertex_it = vertex_begin; vertex_it != vertex_end; vertex_it++) {
-      Node node(this,*vertex_it);
+    Node::NodeIterator nodeIt = getNodes();
+    while(nodeIt.hasNext()) {
+      Node node = nodeIt.next();
       Edge::EdgeIterator edgeIt = node.findOutEdges(edgeType);
       if(!edgeIt.hasNext()) {
         root.insert(node);
@@ -2202,11 +2332,9 @@ namespace columbus {  namespace graph {
   Node::NodeSet Graph::getLeafByEdgeType(const Edge::EdgeType& edgeType) {
     Node::NodeSet leaf;
     Node::NodeSet notLeaf;
-    vertex_iter vertex_begin, vertex_end, vertex_it;
-    boost::tie(vertex_begin,vertex_end) = vertices(*g);
-
-    for(vertex_it = vertex_begin; vertex_it != vertex_end; vertex_it++) {
-      Node node(this,*vertex_it);
+    Node::NodeIterator nodeIt = getNodes();
+    while(nodeIt.hasNext()) {
+      Node node = nodeIt.next();
 
 
       // ide mar mutatott el
@@ -2274,9 +2402,14 @@ namespace columbus {  namespace graph {
         out.writeUInt4(Attribute::atComposite);
         out.writeUInt4( ((AttributeComposite&)attribute).name );
         out.writeUInt4( ((AttributeComposite&)attribute).context );
-        out.writeUInt4(static_cast<unsigned int>( ((AttributeComposite&)attribute).values->size()));
-        for(AttributeList::iterator it = ((AttributeComposite&)attribute).values->begin(); it != ((AttributeComposite&)attribute).values->end(); it++) {
-          writeAttributeToBinary(**it, out);
+        {
+          AttributeComposite& attrComposite = (AttributeComposite&)attribute;
+          unsigned int compositeSize = 0;
+          forEachAttribute(attrComposite, [&](Attribute&) { ++compositeSize; });
+          out.writeUInt4(compositeSize);
+          forEachAttribute(attrComposite, [&](Attribute& value) {
+            writeAttributeToBinary(value, out);
+          });
         }
         break;
       default:
@@ -2287,7 +2420,7 @@ namespace columbus {  namespace graph {
 
   void Graph::saveBinary(const string& filename) const {
     io::BinaryIO out(filename, io::BinaryIO::omWrite);
-    set<GraphEdge> savedEdgePairs;
+    boost::unordered_set<GraphEdge, GraphEdgeHash> savedEdgePairs;
 
     // write out strTable
     strTable->save(out);
@@ -2300,47 +2433,43 @@ namespace columbus {  namespace graph {
     }
 
     // write out Nodes
-    vertex_iter vertex_begin, vertex_end,vertex_it;
-    boost::tie(vertex_begin,vertex_end) = vertices(*g);
-    for(vertex_it = vertex_begin; vertex_it != vertex_end; vertex_it++) {
+    forEachVertex([&](GraphVertex vertex) {
 
       // node uid, type key
 
-      out.writeUInt4(get(vertex_UID,*g,*vertex_it));
-      out.writeUInt4(get(vertex_type,*g,*vertex_it));
-      
+      out.writeUInt4(getVertexUIDKey(vertex));
+      out.writeUInt4(getVertexTypeKey(vertex));
+
       // write out attributes size
 
-      AttributeList *vertex_attr = get(vertex_attributes,*g,*vertex_it);
+      out.writeUInt4(static_cast<unsigned int>(getAttributeCount(vertex)));
 
       // write out attributes
-      out.writeUInt4(static_cast<unsigned int>(vertex_attr->size()));
-      for(AttributeList::iterator it = vertex_attr->begin(); it != vertex_attr->end(); it++) {
-        writeAttributeToBinary(**it,out);
-      }
+      forEachAttribute(vertex, [&](Attribute& attribute) {
+        writeAttributeToBinary(attribute,out);
+      });
 
       // write out edges
 
-      out_edge_iter edge_begin, edge_end, edge_it;
-      boost::tie(edge_begin,edge_end) = out_edges(*vertex_it,*g);
-      for(edge_it = edge_begin; edge_it != edge_end; edge_it++) {
-        if(get(edge_direction,*g,*edge_it) != Edge::edtReverse  && savedEdgePairs.find(*edge_it) == savedEdgePairs.end() ) {
+      forEachOutEdge(vertex, [&](const GraphEdge& edge) {
+        if(getEdgeDirection(edge) != Edge::edtReverse  && savedEdgePairs.find(edge) == savedEdgePairs.end() ) {
 
           // edge type
-          out.writeUInt4(get(edge_type,*g,*edge_it));
+          out.writeUInt4(getEdgeTypeKey(edge));
 
           // edge direction
 
-          out.writeUInt4(get(edge_direction,*g,*edge_it));
+          out.writeUInt4(getEdgeDirection(edge));
 
           // to node
-          out.writeUInt4(get(vertex_UID,*g,target(*edge_it,*g)));
+          out.writeUInt4(getVertexUIDKey(target(edge,*g)));
 
           // has pair
 
-          if(hasEdgePair(*edge_it)) {
+          bool hasPair = hasEdgePair(edge);
+          if(hasPair) {
             out.writeBool1(true);
-            savedEdgePairs.insert(getEdgePair(*edge_it));
+            savedEdgePairs.insert(getEdgePair(edge));
           } else {
             out.writeBool1(false);
           }
@@ -2348,29 +2477,27 @@ namespace columbus {  namespace graph {
 
           // write attributes
 
-          AttributeList *edge_attr = get(edge_attributes,*g,*edge_it);
+          out.writeUInt4(static_cast<unsigned int>(getAttributeCount(edge)));
 
-          out.writeUInt4(static_cast<unsigned int>(edge_attr->size()));
-
-          for(AttributeList::iterator it = edge_attr->begin(); it != edge_attr->end(); it++) {
-            writeAttributeToBinary(**it,out);
-          }
+          forEachAttribute(edge, [&](Attribute& attribute) {
+            writeAttributeToBinary(attribute,out);
+          });
 
           // write reserve pair edge
-          if(hasEdgePair(*edge_it)) {
+          if(hasPair) {
             // write attributes
 
-            AttributeList *edge_attr = get(edge_attributes,*g, getEdgePair(*edge_it));
+            GraphEdge reservePair = getEdgePair(edge);
 
-            out.writeUInt4(static_cast<unsigned int>(edge_attr->size()));
+            out.writeUInt4(static_cast<unsigned int>(getAttributeCount(reservePair)));
 
-            for(AttributeList::iterator it = edge_attr->begin(); it != edge_attr->end(); it++) {
-              writeAttributeToBinary(**it,out);
-            }
+            forEachAttribute(reservePair, [&](Attribute& attribute) {
+              writeAttributeToBinary(attribute,out);
+            });
           }
         }
 
-      }
+      });
       // write empty edge
 
       // edge type
@@ -2381,7 +2508,7 @@ namespace columbus {  namespace graph {
 
       // to node
       out.writeUInt4(0);
-    }
+    });
 
     //write empty node
     
@@ -2437,7 +2564,7 @@ namespace columbus {  namespace graph {
     }
   }
 
-  void Graph::loadBinary(const string& filename) {
+  void Graph::loadBinary(const string& filename, bool compact) {
     GraphSchemaReader::TurnOffFilterSafety turnOffFilterSafety(*gsReader);
     // delete old graph
 
@@ -2455,6 +2582,12 @@ namespace columbus {  namespace graph {
     }
 
     Key invalidNodeType = strTable->set("__INVALID__");
+
+    if(compact) {
+      loadCompactBinary(in, invalidNodeType);
+      in.close();
+      return;
+    }
     
     while(true) {
       if(in.eof())
@@ -2573,12 +2706,185 @@ namespace columbus {  namespace graph {
     in.close();
   }
 
+  unsigned Graph::readCompactAttributes(io::BinaryIO& in, unsigned first, unsigned count) {
+    CompactStorage& storage = *compactStorage;
+    unsigned slot = first;
+    for(unsigned int i = 0; i < count; i++) {
+      Attribute::aType type = static_cast<Attribute::aType>(in.readUInt4());
+      switch(type) {
+        case Attribute::atInt:
+          {
+            Key name = in.readUInt4();
+            Key context = in.readUInt4();
+            int value = in.readInt4();
+            storage.ints.push_back(AttributeInt(name, context, value, this));
+            storage.attributeSlots[slot++] = &storage.ints.back();
+            break;
+          }
+        case Attribute::atFloat:
+          {
+            Key name = in.readUInt4();
+            Key context = in.readUInt4();
+            float value = in.readFloat4();
+            storage.floats.push_back(AttributeFloat(name, context, value, this));
+            storage.attributeSlots[slot++] = &storage.floats.back();
+            break;
+          }
+        case Attribute::atString:
+          {
+            Key name = in.readUInt4();
+            Key context = in.readUInt4();
+            Key value = in.readUInt4();
+            storage.strings.push_back(AttributeString(name, context, value, this));
+            storage.attributeSlots[slot++] = &storage.strings.back();
+            break;
+          }
+        case Attribute::atComposite:
+          {
+            Key name = in.readUInt4();
+            Key context = in.readUInt4();
+            unsigned int attributes_length = in.readUInt4();
+            storage.composites.push_back(CompactAttributeComposite(name, context, this));
+            CompactAttributeComposite& attrComposite = storage.composites.back();
+            storage.attributeSlots[slot++] = &attrComposite;
+            // the contained attributes get their own range at the end of the slots
+            attrComposite.valuesBegin = static_cast<unsigned>(storage.attributeSlots.size());
+            storage.attributeSlots.resize(storage.attributeSlots.size() + attributes_length, NULL);
+            attrComposite.valuesEnd = readCompactAttributes(in, attrComposite.valuesBegin, attributes_length);
+            break;
+          }
+        default:
+          break;
+      }
+    }
+    return slot;
+  }
+
+  void Graph::loadCompactBinary(io::BinaryIO& in, Key invalidNodeType) {
+    compactStorage = new CompactStorage();
+    CompactStorage& storage = *compactStorage;
+
+    // reads the attributes of a vertex or an edge into a new range of slots, the existing attributes are moved before them
+    auto readAttributes = [&](unsigned& begin, unsigned& end) {
+      unsigned int attrSize = in.readUInt4();
+      if(attrSize == 0)
+        return;
+      unsigned first = static_cast<unsigned>(storage.attributeSlots.size());
+      storage.attributeSlots.resize(first + (end - begin) + attrSize, NULL);
+      for(unsigned i = begin; i < end; i++)
+        storage.attributeSlots[first + i - begin] = storage.attributeSlots[i];
+      end = readCompactAttributes(in, first + (end - begin), attrSize);
+      begin = first;
+    };
+
+    // the vertex index of the UID, a placeholder vertex is created for the unknown ones
+    auto findVertex = [&](Key UID, Key type) -> unsigned {
+      KeyMap::const_iterator nodeMapIt = nodeUIDs.find(UID);
+      if(nodeMapIt != nodeUIDs.end())
+        return CompactStorage::vertexIndex(nodeMapIt->second);
+      unsigned index = storage.addVertex(UID, type);
+      nodeUIDs.insert(make_pair(UID, CompactStorage::vertex(index)));
+      return index;
+    };
+
+    try {
+      while(true) {
+        if(in.eof())
+          throw GraphException( COLUMBUS_LOCATION, CMSG_EX_UNEXCPECTED_END_OF_LINE);
+
+        // read a node
+
+        unsigned int UID = in.readUInt4();
+        unsigned int type = in.readUInt4();
+
+        // last node
+
+        if( (UID == 0) && (type == 0) )
+          break;
+
+        // create node or find it (and overwrite its type like the list based loading)
+
+        unsigned node = findVertex(UID, type);
+        storage.vertexTypes[node] = type;
+
+        readAttributes(storage.vertexAttributeBegin[node], storage.vertexAttributeEnd[node]);
+
+        // read edges
+
+        while(true) {
+          if(in.eof())
+            throw GraphException( COLUMBUS_LOCATION, CMSG_EX_UNEXCPECTED_END_OF_LINE);
+
+          unsigned int edgeTypeKey = in.readUInt4();
+          unsigned int edgeDirectionKey = in.readUInt4();
+          unsigned int toNodeKey = in.readUInt4();
+
+          if( (edgeTypeKey == 0) && (edgeDirectionKey == 0) && (toNodeKey == 0) )
+            break;
+
+          bool hasPair = in.readBool1();
+
+          unsigned toNode = findVertex(toNodeKey, invalidNodeType);
+
+          // create edge (in the same order as the list based loading)
+
+          Edge::eDirectionType edgeDirection = static_cast<Edge::eDirectionType> (edgeDirectionKey);
+          unsigned edge = CompactStorage::noPair;
+
+          switch(edgeDirection) {
+            case Edge::edtBidirectional:
+              {
+                edge = storage.addEdge(node, toNode, edgeTypeKey, Edge::edtBidirectional);
+                unsigned revEdge = storage.addEdge(toNode, node, edgeTypeKey, Edge::edtBidirectional);
+                storage.setEdgePair(edge, revEdge);
+                break;
+              }
+            case Edge::edtDirectional:
+              edge = storage.addEdge(node, toNode, edgeTypeKey, Edge::edtDirectional);
+              break;
+            default:
+              // other direction can't be
+              break;
+          }
+
+          if(edge == CompactStorage::noPair) {
+            // the attributes and the pair of the invalid edge cannot be created
+            if(in.readUInt4() != 0)
+              throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_ADD_ATTRIBUTE_TO_INVALID_EDGE);
+            if(hasPair)
+              throw InvalidGetter( COLUMBUS_LOCATION, CMSG_EX_INVALID_EDGE_HASNOT_TONODE);
+            continue;
+          }
+
+          readAttributes(storage.edgeAttributeBegin[edge], storage.edgeAttributeEnd[edge]);
+
+          // add reverse pair attribute
+
+          if(hasPair) {
+            unsigned revPair = storage.addEdge(toNode, node, edgeTypeKey, Edge::edtReverse);
+            storage.setEdgePair(edge, revPair);
+            readAttributes(storage.edgeAttributeBegin[revPair], storage.edgeAttributeEnd[revPair]);
+          }
+        }
+      }
+    } catch(...) {
+      // the already loaded part remains usable
+      storage.buildAdjacency();
+      throw;
+    }
+
+    storage.buildAdjacency();
+  }
+
   void Graph::clear() {
 
     clearAttributes();
     clearHelperContaioners();
     clearHeaderInfo();
 
+    delete compactStorage;
+    compactStorage = NULL;
+
     if (g != NULL)
       delete g;
     g = new BGraph();
@@ -2594,6 +2900,8 @@ namespace columbus {  namespace graph {
   }
 
   Node::NodeIterator Graph::getNodes() {
+    if (compactStorage)
+      return Node::NodeIterator(this, compactStorage->getVertexCount(), Node::NodeTypeSet());
     vertex_iter begin, end;
     boost::tie(begin, end) = vertices(*g);
     return Node::NodeIterator(begin, end, getNodeIterators(), this, Node::NodeTypeSet());
@@ -2874,6 +3182,8 @@ namespace columbus {  namespace graph {
 
   void Graph::merge(Graph& graph, Graph::MergeMode nodeMode, Graph::CompsiteAndStringMergeMode nodeAttributeStringAndCompositeMode, Graph::NumericMergeMode nodeAttributeNumericMode,
     Graph::MergeMode edgeMode, Graph::CompsiteAndStringMergeMode edgeAttributeStringAndCompositeMode, Graph::NumericMergeMode edgeAttributeNumericMode) {
+    checkModifiable();
+
     // convert all nodes from 'graph' to this graph
     set<Node> visitedNodes;
     set<Edge> visitedEdges;
@@ -2922,11 +3232,258 @@ namespace columbus {  namespace graph {
     
   }
 
+  struct Graph::BinaryMergeInput {
+    BinaryMergeInput(const string& filename)
+      : filename(filename)
+      , file()
+      , graph()
+      , nodesOffset(0)
+      , mapped(false)
+    {
+    }
+
+    string filename;
+    boost::iostreams::mapped_file_source file;
+    // the string table and the header of the file, and the nodes of the record under merge
+    Graph graph;
+    size_t nodesOffset;
+    bool mapped;
+  };
+
+  bool Graph::prepareBinaryMergeInput(BinaryMergeInput& input) {
+    try {
+      input.file.open(input.filename);
+    } catch (const std::exception&) {
+      return false;
+    }
+
+    io::BinaryIO in;
+    in.openMemory(input.file.data(), input.file.size());
+    input.graph.strTable->load(in);
+
+    // reade header information
+    unsigned int headerCount = in.readUInt4();
+    for(unsigned int i = 0; i < headerCount; i++) {
+      unsigned int infoName = in.readUInt4();
+      unsigned int infoValue = in.readUInt4();
+      input.graph.setHeaderInfo(input.graph.strTable->get(infoName), input.graph.strTable->get(infoValue));
+    }
+    input.nodesOffset = static_cast<size_t>(in.getPosition());
+    in.close();
+
+    // touch the pages of the nodes, so they are read from the disk here instead of during the merge
+    const char* data = input.file.data();
+    volatile char touched = 0;
+    for (size_t offset = input.nodesOffset; offset < input.file.size(); offset += 4096)
+      touched ^= data[offset];
+
+    input.mapped = true;
+    return true;
+  }
+
+  void Graph::mergeBinaryMergeInput(BinaryMergeInput& input, Graph::MergeMode nodeMode, Graph::CompsiteAndStringMergeMode nodeAttributeStringAndCompositeMode, Graph::NumericMergeMode nodeAttributeNumericMode,
+    Graph::MergeMode edgeMode, Graph::CompsiteAndStringMergeMode edgeAttributeStringAndCompositeMode, Graph::NumericMergeMode edgeAttributeNumericMode) {
+    Graph& mergeGraph = input.graph;
+    GraphSchemaReader::TurnOffFilterSafety turnOffFilterSafety(*mergeGraph.gsReader);
+
+    io::BinaryIO in;
+    in.openMemory(input.file.data(), input.file.size());
+    in.setMemoryReadPosition(input.nodesOffset);
+
+    const string invalidNodeTypeName = "__INVALID__";
+    Key mergeInvalidNodeType = mergeGraph.strTable->set(invalidNodeTypeName);
+    Key invalidNodeType = strTable->set(invalidNodeTypeName);
+
+    // Only one record (a node with its out edges) of the file is in mergeGraph at a time. The target nodes which
+    // are not in this graph yet are created here without attributes, they get their type and attributes when their
+    // own record is read, as if the whole node had been added at the first reference.
+    boost::unordered_set<Key> recordedNodes;
+    boost::unordered_set<Key> placeholderNodes;
+    vector<Key> referencedNodes;
+
+    while(true) {
+      if(in.eof())
+        throw GraphException( COLUMBUS_LOCATION, CMSG_EX_UNEXCPECTED_END_OF_LINE);
+
+      // read a node
+
+      unsigned int UID = in.readUInt4();
+      unsigned int type = in.readUInt4();
+
+      // last node
+
+      if( (UID == 0) && (type == 0) )
+        break;
+
+      recordedNodes.insert(UID);
+      Node newNode = mergeGraph.createNode(UID, type);
+
+      // read attributes
+      unsigned int nodeAttrSize = in.readUInt4();
+      for(unsigned int i=0; i < nodeAttrSize; i++) {
+        mergeGraph.readAttributeToBinary(in, newNode);
+      }
+
+      // read edges
+      vector<Edge> newEdges;
+      while(true) {
+        if(in.eof())
+          throw GraphException( COLUMBUS_LOCATION, CMSG_EX_UNEXCPECTED_END_OF_LINE);
+
+        unsigned int edgeTypeKey = in.readUInt4();
+        unsigned int edgeDirectionKey = in.readUInt4();
+        unsigned int toNodeKey = in.readUInt4();
+
+        if( (edgeTypeKey == 0) && (edgeDirectionKey == 0) && (toNodeKey == 0) )
+          break;
+
+        bool hasPair = in.readBool1();
+
+        Node toNode;
+        KeyMap::const_iterator nodeMapIt = mergeGraph.nodeUIDs.find(toNodeKey);
+        if(nodeMapIt != mergeGraph.nodeUIDs.end()) {
+          toNode = Node(&mergeGraph, nodeMapIt->second);
+        } else {
+          toNode = mergeGraph.createNode(toNodeKey, mergeInvalidNodeType);
+          if (recordedNodes.find(toNodeKey) == recordedNodes.end())
+            referencedNodes.push_back(toNodeKey);
+        }
+
+        Edge edge;
+        switch(static_cast<Edge::eDirectionType>(edgeDirectionKey)) {
+          case Edge::edtBidirectional:
+            edge = mergeGraph.createBidirectedEdge(newNode, toNode, edgeTypeKey);
+            break;
+          case Edge::edtDirectional:
+            edge = mergeGraph.createDirectedEdge(newNode, toNode, edgeTypeKey, false);
+            break;
+          default:
+            // other direction can't be
+            break;
+        }
+
+        unsigned int edgeAttributeSize = in.readUInt4();
+        for(unsigned int i = 0; i < edgeAttributeSize; i++) {
+          mergeGraph.readAttributeToBinary(in, edge);
+        }
+
+        if(hasPair) {
+          Edge revPair = mergeGraph.createReservePair(edge);
+          unsigned int revEdgeAttributeSize = in.readUInt4();
+          for(unsigned int i = 0; i < revEdgeAttributeSize; i++) {
+            mergeGraph.readAttributeToBinary(in, revPair);
+          }
+        }
+        newEdges.push_back(edge);
+      }
+
+      // convert node
+      Key UIDKey = strTable->set(mergeGraph.strTable->get(UID));
+      KeyMap::iterator nodeIt = nodeUIDs.find(UIDKey);
+      if(nodeIt != nodeUIDs.end() && placeholderNodes.erase(UIDKey)) {
+        const string& typeName = newNode.getType().getType();
+        if(!gsReader->canAddNode(typeName))
+          throw GraphSchemaException( COLUMBUS_LOCATION, CMSG_EX_CANT_ADD_TYPE( typeName));
+        put(vertex_type, *g, nodeIt->second, strTable->set(typeName));
+        Node oldNode(this, nodeIt->second);
+        Attribute::AttributeIterator attrIt = newNode.getAttributes();
+        while(attrIt.hasNext()) {
+          oldNode.addAttribute(attrIt.next());
+        }
+      } else {
+        convertNodeMerge(newNode, *this, nodeMode, nodeAttributeStringAndCompositeMode, nodeAttributeNumericMode);
+      }
+
+      multimap<string, Edge> oldNodeTargets;
+      Node oldNode = this->findNode(newNode.getUID());
+      Edge::EdgeIterator eit = oldNode.getOutEdges();
+      while (eit.hasNext()) {
+        Edge edge = eit.next();
+        oldNodeTargets.insert(make_pair(edge.getToNode().getUID(), edge));
+      }
+
+      // convert edges
+      for(vector<Edge>::iterator edgeIt = newEdges.begin(); edgeIt != newEdges.end(); ++edgeIt) {
+        Key toUIDKey = strTable->set(edgeIt->getToNode().getUID());
+        if(nodeUIDs.find(toUIDKey) == nodeUIDs.end()) {
+          createNode(toUIDKey, invalidNodeType);
+          placeholderNodes.insert(toUIDKey);
+        }
+        convertEdgeMerge(oldNodeTargets, *edgeIt, *this, edgeMode, edgeAttributeStringAndCompositeMode, edgeAttributeNumericMode);
+      }
+
+      newEdges.clear();
+      mergeGraph.clearNodes();
+    }
+    in.close();
+
+    // the nodes which are only targets of edges in the file
+    for(vector<Key>::const_iterator it = referencedNodes.begin(); it != referencedNodes.end(); ++it) {
+      if(!recordedNodes.insert(*it).second)
+        continue;
+      Node newNode = mergeGraph.createNode(*it, mergeInvalidNodeType);
+      if(placeholderNodes.find(strTable->get(newNode.getUID())) != placeholderNodes.end() && !gsReader->canAddNode(invalidNodeTypeName))
+        throw GraphSchemaException( COLUMBUS_LOCATION, CMSG_EX_CANT_ADD_TYPE( invalidNodeTypeName));
+      convertNodeMerge(newNode, *this, nodeMode, nodeAttributeStringAndCompositeMode, nodeAttributeNumericMode);
+      mergeGraph.clearNodes();
+    }
+
+    // merge the headerinfo
+    for (StringMap::const_iterator pairIt = mergeGraph.headerInformations.begin(); pairIt != mergeGraph.headerInformations.end(); ++pairIt) {
+      setHeaderInfo(mergeGraph.strTable->get(pairIt->first), mergeGraph.strTable->get(pairIt->second));
+    }
+  }
+
   void Graph::mergeWithBinary(const string& filename, Graph::MergeMode nodeMode, Graph::CompsiteAndStringMergeMode nodeAttributeStringAndCompositeMode, Graph::NumericMergeMode nodeAttributeNumericMode,
     Graph::MergeMode edgeMode, Graph::CompsiteAndStringMergeMode edgeAttributeStringAndCompositeMode, Graph::NumericMergeMode edgeAttributeNumericMode) {
-    Graph mergeGraph;
-    mergeGraph.loadBinary(filename);
-    merge(mergeGraph, nodeMode, nodeAttributeStringAndCompositeMode, nodeAttributeNumericMode, edgeMode, edgeAttributeStringAndCompositeMode, edgeAttributeNumericMode);
+    mergeWithBinary(vector<string>(1, filename), nodeMode, nodeAttributeStringAndCompositeMode, nodeAttributeNumericMode, edgeMode, edgeAttributeStringAndCompositeMode, edgeAttributeNumericMode, 1);
+  }
+
+  void Graph::mergeWithBinary(const vector<string>& filenames, Graph::MergeMode nodeMode, Graph::CompsiteAndStringMergeMode nodeAttributeStringAndCompositeMode, Graph::NumericMergeMode nodeAttributeNumericMode,
+    Graph::MergeMode edgeMode, Graph::CompsiteAndStringMergeMode edgeAttributeStringAndCompositeMode, Graph::NumericMergeMode edgeAttributeNumericMode,
+    unsigned threads, fileVisitorCallback mergeFileFunc, void* data) {
+    checkModifiable();
+
+    thread::Executor& executor = thread::Executor::global();
+    if (threads == 0)
+      threads = executor.getConcurrency();
+
+    vector<BinaryMergeInput*> inputs;
+    vector<std::future<bool> > prepared;
+    for (vector<string>::const_iterator it = filenames.begin(); it != filenames.end(); ++it)
+      inputs.push_back(new BinaryMergeInput(*it));
+
+    // the files are prepared in the background, at most 'threads' files ahead of the merge
+    size_t next = 0;
+    try {
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        for (; next < inputs.size() && next < i + threads; ++next) {
+          BinaryMergeInput* input = inputs[next];
+          prepared.push_back(executor.submit([input]() { return prepareBinaryMergeInput(*input); }));
+        }
+
+        if (mergeFileFunc)
+          mergeFileFunc(inputs[i]->filename, data);
+
+        if (prepared[i].get()) {
+          mergeBinaryMergeInput(*inputs[i], nodeMode, nodeAttributeStringAndCompositeMode, nodeAttributeNumericMode, edgeMode, edgeAttributeStringAndCompositeMode, edgeAttributeNumericMode);
+        } else {
+          // the file cannot be mapped (e.g. it is empty or missing), it is loaded normally which reports the errors
+          Graph mergeGraph;
+          mergeGraph.loadBinary(inputs[i]->filename);
+          merge(mergeGraph, nodeMode, nodeAttributeStringAndCompositeMode, nodeAttributeNumericMode, edgeMode, edgeAttributeStringAndCompositeMode, edgeAttributeNumericMode);
+        }
+        delete inputs[i];
+        inputs[i] = NULL;
+      }
+    } catch (...) {
+      for (size_t i = 0; i < next; ++i)
+        if (inputs[i] && prepared[i].valid())
+          prepared[i].wait();
+      for (size_t i = 0; i < inputs.size(); ++i)
+        delete inputs[i];
+      throw;
+    }
   }
 
   void Graph::mergeWithXML(const string& filename, Graph::MergeMode nodeMode, Graph::CompsiteAndStringMergeMode nodeAttributeStringAndCompositeMode, Graph::NumericMergeMode nodeAttributeNumericMode,
@@ -0,0 +1,140 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#include "../privinc/CompactStorage.h"
+
+using namespace std;
+
+namespace columbus {  namespace graph {
+
+  CompactAttributeComposite::CompactAttributeComposite(Key nameKey, Key contextKey, Graph* g) :
+    AttributeComposite(),
+    valuesBegin(0),
+    valuesEnd(0)
+  {
+    name = nameKey;
+    context = contextKey;
+    graph = g;
+  }
+
+  CompactAttributeComposite::CompactAttributeComposite(const CompactAttributeComposite& attribute) :
+    AttributeComposite(),
+    valuesBegin(attribute.valuesBegin),
+    valuesEnd(attribute.valuesEnd)
+  {
+    name = attribute.name;
+    context = attribute.context;
+    graph = attribute.graph;
+  }
+
+  const unsigned CompactStorage::noPair;
+
+  CompactStorage::CompactStorage() :
+    vertexUIDs(),
+    vertexTypes(),
+    vertexAttributeBegin(),
+    vertexAttributeEnd(),
+    outEdgeBegin(),
+    edgeSources(),
+    edgeTargets(),
+    edgeTypes(),
+    edgeDirections(),
+    edgePairs(),
+    edgeAttributeBegin(),
+    edgeAttributeEnd(),
+    attributeSlots(),
+    ints(),
+    floats(),
+    strings(),
+    composites()
+  {
+  }
+
+  unsigned CompactStorage::addVertex(Key uid, Key type) {
+    vertexUIDs.push_back(uid);
+    vertexTypes.push_back(type);
+    vertexAttributeBegin.push_back(0);
+    vertexAttributeEnd.push_back(0);
+    return static_cast<unsigned>(vertexUIDs.size() - 1);
+  }
+
+  unsigned CompactStorage::addEdge(unsigned source, unsigned target, Key type, unsigned char direction) {
+    edgeSources.push_back(source);
+    edgeTargets.push_back(target);
+    edgeTypes.push_back(type);
+    edgeDirections.push_back(direction);
+    edgePairs.push_back(noPair);
+    edgeAttributeBegin.push_back(0);
+    edgeAttributeEnd.push_back(0);
+    return static_cast<unsigned>(edgeTargets.size() - 1);
+  }
+
+  void CompactStorage::setEdgePair(unsigned first, unsigned second) {
+    if (edgePairs[first] == noPair)
+      edgePairs[first] = second;
+    if (edgePairs[second] == noPair)
+      edgePairs[second] = first;
+  }
+
+  // Reorders the edge arrays with a stable counting sort by the source vertex.
+  template <class T>
+  static void permute(vector<T>& values, const vector<unsigned>& position) {
+    vector<T> sorted(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+      sorted[position[i]] = values[i];
+    values.swap(sorted);
+  }
+
+  void CompactStorage::buildAdjacency() {
+    unsigned vertexCount = getVertexCount();
+    size_t edgeCount = edgeTargets.size();
+
+    outEdgeBegin.assign(vertexCount + 1, 0);
+    for (size_t i = 0; i < edgeCount; ++i)
+      ++outEdgeBegin[edgeSources[i] + 1];
+    for (unsigned i = 0; i < vertexCount; ++i)
+      outEdgeBegin[i + 1] += outEdgeBegin[i];
+
+    vector<unsigned> next(outEdgeBegin.begin(), outEdgeBegin.end() - 1);
+    vector<unsigned> position(edgeCount);
+    for (size_t i = 0; i < edgeCount; ++i)
+      position[i] = next[edgeSources[i]]++;
+
+    for (size_t i = 0; i < edgeCount; ++i)
+      if (edgePairs[i] != noPair)
+        edgePairs[i] = position[edgePairs[i]];
+
+    permute(edgeTargets, position);
+    permute(edgeTypes, position);
+    permute(edgeDirections, position);
+    permute(edgePairs, position);
+    permute(edgeAttributeBegin, position);
+    permute(edgeAttributeEnd, position);
+
+    vector<unsigned>().swap(edgeSources);
+
+    vertexUIDs.shrink_to_fit();
+    vertexTypes.shrink_to_fit();
+    vertexAttributeBegin.shrink_to_fit();
+    vertexAttributeEnd.shrink_to_fit();
+    attributeSlots.shrink_to_fit();
+  }
+
+}}
@@ -21,6 +21,7 @@
 #include "../inc/graph.h"
 #include "../privinc/GraphSchemaReader.h"
 #include "../privinc/messages.h"
+#include "../privinc/CompactStorage.h"
 
 using namespace std;
 
@@ -49,13 +50,14 @@ namespace columbus {  namespace graph {
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_ADD_ATTRIBUTE_TO_INVALID_EDGE);
     if(attribute.graph == NULL) 
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_ADD_INVALID_ATTRIBUTE_TO_EDGE);
+    g->checkModifiable();
     AttributeList *attributes = get(edge_attributes,*g->getBGraph(),edge);
 
 /*    for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); it++){
       if(attribute.equals(**it)) throw AlreadyExist("Edge::addAttribute(const Attribute& attribute)","Attribute is already exist");
     }*/
 
-    if(!g->gsReader->canAddAttributeToEdge(getType().getType(), getType().getDirectionType(), getToNode().getType().getType(), getFromNode().getType().getType(), attribute))
+    if(g->gsReader->getIsEnabled() && !g->gsReader->canAddAttributeToEdge(getType().getType(), getType().getDirectionType(), getToNode().getType().getType(), getFromNode().getType().getType(), attribute))
       throw GraphSchemaException( COLUMBUS_LOCATION, CMSG_EX_CANT_ADD_ATTRIBUTE_TO_EDGE( attribute.getName(), getType().getType()));
 
     Attribute *attr;
@@ -73,6 +75,7 @@ namespace columbus {  namespace graph {
   void Edge::deleteAttributes() {
     if(g == NULL)
       throw InvalidSetter("Edge::deleteAttributes()","Can't del attribute to invalidEdge");
+    g->checkModifiable();
     AttributeList *attributes = get(edge_attributes,*g->getBGraph(),edge);
     for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); it++){
       delete *it;
@@ -84,6 +87,7 @@ namespace columbus {  namespace graph {
     bool deleted = false;
     if(g == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_EDGE);
+    g->checkModifiable();
     AttributeList *attributes = get(edge_attributes,*g->getBGraph(),edge);
     for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); ){
       if( ((**it).getName() == name) && ((**it).getType() == type) && ((**it).getContext() == context )) {
@@ -100,6 +104,7 @@ namespace columbus {  namespace graph {
   bool Edge::deleteAttribute(const Attribute& attribute) {
     if(g == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_EDGE);
+    g->checkModifiable();
     AttributeList *attributes = get(edge_attributes,*g->getBGraph(),edge);
     for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); it++){
       if( attribute == **it ) {
@@ -115,6 +120,7 @@ namespace columbus {  namespace graph {
     bool deleted = false;
     if(g == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_EDGE);
+    g->checkModifiable();
     AttributeList *attributes = get(edge_attributes,*g->getBGraph(),edge);
     for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); ){
       if( ((**it).getName() == name) && ((**it).getType() == type) ) {
@@ -130,6 +136,7 @@ namespace columbus {  namespace graph {
   bool Edge::deleteAttribute(Attribute::aType type) {
     if(g == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_EDGE);
+    g->checkModifiable();
     bool deleted = false;
     AttributeList *attributes = get(edge_attributes,*g->getBGraph(),edge);
     for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); ){
@@ -287,7 +294,11 @@ namespace columbus {  namespace graph {
     container_end(container_end),
     it(),
     iterators(itContainer),
-    lastOp(op_None)
+    lastOp(op_None),
+    compact(false),
+    compactBegin(0),
+    compactEnd(0),
+    compactIt(0)
   {
     for (EdgeTypeSet::const_iterator etsIt = filteredEdges.begin(); etsIt != filteredEdges.end(); ++etsIt) {
       this->filteredEdges.insert(make_pair(graph->getStrTable()->get(etsIt->getType()), etsIt->getDirectionType()));
@@ -296,6 +307,24 @@ namespace columbus {  namespace graph {
     iterators->push_back(this);
   }
 
+  Edge::EdgeIterator::EdgeIterator(Graph* graph, GraphVertex vertex, unsigned begin, unsigned end, const EdgeTypeSet &filteredEdges) :
+    graph(graph),
+    vertex(vertex),
+    container_begin(),
+    container_end(),
+    it(),
+    iterators(NULL),
+    lastOp(op_None),
+    compact(true),
+    compactBegin(begin),
+    compactEnd(end),
+    compactIt(end)
+  {
+    for (EdgeTypeSet::const_iterator etsIt = filteredEdges.begin(); etsIt != filteredEdges.end(); ++etsIt) {
+      this->filteredEdges.insert(make_pair(graph->getStrTable()->get(etsIt->getType()), etsIt->getDirectionType()));
+    }
+  }
+
   void Edge::EdgeIterator::add(const Edge &edge) {
 /*    switch (lastOp) {
       case op_None:
@@ -318,6 +347,8 @@ namespace columbus {  namespace graph {
   }
 
   void Edge::EdgeIterator::remove() {
+    if (compact)
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
     switch (lastOp) {
       case op_None:
       case op_Add:
@@ -343,7 +374,11 @@ namespace columbus {  namespace graph {
     it (),
     iterators(NULL),
     filteredEdges(),
-    lastOp(op_Invalidated)
+    lastOp(op_Invalidated),
+    compact(false),
+    compactBegin(0),
+    compactEnd(0),
+    compactIt(0)
   {
   }
 
@@ -355,13 +390,19 @@ namespace columbus {  namespace graph {
     it (iterator.it),
     iterators(iterator.iterators),
     filteredEdges(iterator.filteredEdges),
-    lastOp(iterator.lastOp)
+    lastOp(iterator.lastOp),
+    compact(iterator.compact),
+    compactBegin(iterator.compactBegin),
+    compactEnd(iterator.compactEnd),
+    compactIt(iterator.compactIt)
   {
     if (lastOp != op_Invalidated && iterators)
       iterators->push_back(this);
   }
 
   void Edge::EdgeIterator::removeIterator() {
+    if (!iterators)
+      return;
     for (IteratorContainer::iterator _it = iterators->begin(); _it != iterators->end(); ++_it) {
       if (*_it == this) {
         iterators->erase(_it);
@@ -396,12 +437,17 @@ namespace columbus {  namespace graph {
     }
 
     it = otherIt.it;
+    vertex = otherIt.vertex;
     container_begin = otherIt.container_begin;
     container_end = otherIt.container_end;
     iterators = otherIt.iterators;
     lastOp = otherIt.lastOp;
     graph = otherIt.graph;
     filteredEdges = otherIt.filteredEdges;
+    compact = otherIt.compact;
+    compactBegin = otherIt.compactBegin;
+    compactEnd = otherIt.compactEnd;
+    compactIt = otherIt.compactIt;
 
     if (lastOp != op_Invalidated && iterators && insertIntoIterators)
       iterators->push_back(this);
@@ -410,10 +456,22 @@ namespace columbus {  namespace graph {
   }
 
   bool Edge::EdgeIterator::hasNext() {
+    if (compact)
+      return nextCompactItem() != compactEnd;
     return nextItem() != container_end;
   }
 
   Edge Edge::EdgeIterator::next() {
+    if (compact) {
+      compactIt = nextCompactItem();
+      lastOp = op_Next;
+
+      if (compactIt == compactEnd)
+        throw GraphNoSuchElementException( COLUMBUS_LOCATION, CMSG_EX_ITERATOR_NOT_NEXT_ELEMENT);
+
+      return Edge(graph, compactEdge(compactIt));
+    }
+
     it = nextItem();
     lastOp = op_Next;
 
@@ -424,10 +482,22 @@ namespace columbus {  namespace graph {
   }
 
   bool Edge::EdgeIterator::hasPrevious() {
+    if (compact)
+      return previousCompactItem() != compactEnd;
     return previousItem() != container_end;
   }
 
   Edge Edge::EdgeIterator::previous() {
+    if (compact) {
+      compactIt = previousCompactItem();
+      lastOp = op_Previous;
+
+      if (compactIt == compactEnd)
+        throw GraphNoSuchElementException( COLUMBUS_LOCATION, CMSG_EX_ITERATOR_NOT_PREVIUS_ELEMENT);
+
+      return Edge(graph, compactEdge(compactIt));
+    }
+
     it = previousItem();
     lastOp = op_Previous;
 
@@ -556,6 +626,51 @@ namespace columbus {  namespace graph {
     return nextElement;
   }
 
+  GraphEdge Edge::EdgeIterator::compactEdge(unsigned index) const {
+    return CompactStorage::edge(vertex, CompactStorage::vertex(graph->compactStorage->edgeTargets[index]), index);
+  }
+
+  bool Edge::EdgeIterator::isOutFilteredCompactItem(unsigned index) const {
+    const CompactStorage& storage = *graph->compactStorage;
+    return !filteredEdges.empty() && filteredEdges.find(make_pair(storage.edgeTypes[index], (Edge::eDirectionType)storage.edgeDirections[index])) == filteredEdges.end();
+  }
+
+  unsigned Edge::EdgeIterator::nextCompactItem() {
+    unsigned j;
+    switch (lastOp) {
+      case op_None:       j = compactBegin; break;
+      case op_Previous:   return compactIt;
+      case op_Invalidated:
+        throw GraphInvalidIteratorException( COLUMBUS_LOCATION, CMSG_EX_INVALID_ITERATOR);
+      default:            j = compactIt == compactEnd ? compactEnd : compactIt + 1; break;
+    }
+    while (j != compactEnd && isOutFilteredCompactItem(j))
+      ++j;
+    return j;
+  }
+
+  unsigned Edge::EdgeIterator::previousCompactItem() {
+    switch (lastOp) {
+      case op_None:       return compactEnd;
+      case op_Add:
+      case op_Next:       return compactIt;
+      case op_Remove:
+      case op_Previous:
+        if (compactIt == compactBegin)
+          return compactEnd;
+        if (filteredEdges.empty())
+          return compactIt - 1;
+        // like findPreviousNotDeletedFiltered(), the first edge is not returned if there is a filter
+        for (unsigned j = compactIt - 1; j != compactBegin; --j)
+          if (!isOutFilteredCompactItem(j))
+            return j;
+        return compactEnd;
+      case op_Invalidated:
+        throw GraphInvalidIteratorException( COLUMBUS_LOCATION, CMSG_EX_INVALID_ITERATOR);
+    }
+    return compactEnd;
+  }
+
   void Edge::EdgeIterator::invalidate() {
     lastOp = op_Invalidated;
   }
@@ -134,7 +134,9 @@ namespace columbus {  namespace graph {
     if(type == Attribute::atComposite) {
       AttributeComposite& atComposite = (AttributeComposite&)attribute;
       sign += '\1';
-      for(AttributeList::iterator it = atComposite.values->begin(); it != atComposite.values->end(); it++) {
+      AttributeVector values;
+      atComposite.getValues(values);
+      for(AttributeVector::iterator it = values.begin(); it != values.end(); it++) {
         sign += createAttributeSign(**it);
       }      
       sign += '\2';
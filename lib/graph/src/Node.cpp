@@ -21,6 +21,7 @@
 #include "../inc/graph.h"
 #include "../privinc/GraphSchemaReader.h"
 #include "../privinc/messages.h"
+#include "../privinc/CompactStorage.h"
 #include <algorithm>
 
 using namespace std;
@@ -54,13 +55,15 @@ namespace columbus {  namespace graph {
     if(attribute.graph == NULL) 
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_ADD_INVALID_ATTRIBUTE_TO_NODE);
 
+    g->checkModifiable();
+
     AttributeList *attributes = get(vertex_attributes,*g->getBGraph(),vertex);
 
   /*  for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); it++){
       if(attribute.equals(**it)) throw AlreadyExist("Node::addAttribute(const Attribute& attribute)","Attribute is already exist in " + getUID());
     }*/
     
-    if(!g->gsReader->canAddAttributeToNode(getType().getType(), attribute) )
+    if(g->gsReader->getIsEnabled() && !g->gsReader->canAddAttributeToNode(getType().getType(), attribute) )
       throw GraphSchemaException( COLUMBUS_LOCATION, CMSG_EX_CANT_ADD_ATTRIBUTE_TO_NODE( attribute.getName(), getType().getType()));
 
     Attribute *attr = attribute.copy();
@@ -77,6 +80,7 @@ namespace columbus {  namespace graph {
   void Node::deleteAttributes() {
     if(g == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_NODE);
+    g->checkModifiable();
     AttributeList *attributes = get(vertex_attributes,*g->getBGraph(),vertex);
     for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); it++){
       delete *it;
@@ -87,6 +91,7 @@ namespace columbus {  namespace graph {
   bool Node::deleteAttribute(const Attribute& attribute){
     if(g == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_NODE);
+    g->checkModifiable();
     AttributeList *attributes = get(vertex_attributes,*g->getBGraph(),vertex);
     for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); it++){
       if( attribute == **it ) {
@@ -102,6 +107,7 @@ namespace columbus {  namespace graph {
     bool deleted = false;
     if(g == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_NODE);
+    g->checkModifiable();
     AttributeList *attributes = get(vertex_attributes,*g->getBGraph(),vertex);
     for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); ){
       if( ((**it).getName() == name) && ((**it).getType() == type) ) {
@@ -118,6 +124,7 @@ namespace columbus {  namespace graph {
     bool deleted = false;
     if(g == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_NODE);
+    g->checkModifiable();
     AttributeList *attributes = get(vertex_attributes,*g->getBGraph(),vertex);
     for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); ){
       if( ((**it).getName() == name) && ((**it).getType() == type) && ((**it).getContext() == context )) {
@@ -133,6 +140,7 @@ namespace columbus {  namespace graph {
   bool Node::deleteAttribute(Attribute::aType type){
     if(g == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_NODE);
+    g->checkModifiable();
     bool deleted = false;
     AttributeList *attributes = get(vertex_attributes,*g->getBGraph(),vertex);
     for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); ){
@@ -150,6 +158,7 @@ namespace columbus {  namespace graph {
     bool deleted = false;
     if(g == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_NO_DEL_ATTRIBUTE_TO_INVALID_NODE);
+    g->checkModifiable();
     AttributeList *attributes = get(vertex_attributes,*g->getBGraph(),vertex);
     for(AttributeList::iterator it = attributes->begin(); it != attributes->end(); ){
       if( ((**it).getContext() == context) ) {
@@ -211,6 +220,8 @@ namespace columbus {  namespace graph {
   Edge::EdgeIterator Node::getOutEdges() const{
     if(g == NULL)
       throw InvalidGetter("Node::getOutEdges()","Invalid node don't has out edges");
+    if(g->compactStorage)
+      return compactOutEdges(Edge::EdgeTypeSet());
     out_edge_iter e_begin, e_end;
     boost::tie(e_begin, e_end) = out_edges(vertex, *g->getBGraph());
 
@@ -220,22 +231,32 @@ namespace columbus {  namespace graph {
   Edge::EdgeIterator Node::findOutEdges(const Edge::EdgeType& type) const {
     if(g == NULL)
       throw InvalidGetter( COLUMBUS_LOCATION, CMSG_EX_INVALID_NODE_NO_OUT_EDGES);
-    out_edge_iter e_begin, e_end;
-    boost::tie(e_begin, e_end) = out_edges(vertex, *g->getBGraph());
     Edge::EdgeTypeSet typeSet;
     typeSet.insert(type);
+    if(g->compactStorage)
+      return compactOutEdges(typeSet);
+    out_edge_iter e_begin, e_end;
+    boost::tie(e_begin, e_end) = out_edges(vertex, *g->getBGraph());
     return Edge::EdgeIterator(e_begin,e_end,g->getEdgeIteratorOnNode(vertex), g, vertex,typeSet);
   }
 
   Edge::EdgeIterator Node::findOutEdges(const Edge::EdgeTypeSet& types) const {
     if(g == NULL)
       throw InvalidGetter( COLUMBUS_LOCATION, CMSG_EX_INVALID_NODE_NO_OUT_EDGES);
+    if(g->compactStorage)
+      return compactOutEdges(types);
     out_edge_iter e_begin, e_end;
     boost::tie(e_begin, e_end) = out_edges(vertex, *g->getBGraph());
 
     return Edge::EdgeIterator(e_begin,e_end,g->getEdgeIteratorOnNode(vertex),g, vertex,types);
   }
 
+  Edge::EdgeIterator Node::compactOutEdges(const Edge::EdgeTypeSet& types) const {
+    unsigned index = CompactStorage::vertexIndex(vertex);
+    const vector<unsigned>& outEdgeBegin = g->compactStorage->outEdgeBegin;
+    return Edge::EdgeIterator(g, vertex, outEdgeBegin[index], outEdgeBegin[index + 1], types);
+  }
+
 
   Node::NodeType Node::getType() const {
     if(g == NULL)
@@ -247,6 +268,10 @@ namespace columbus {  namespace graph {
     if(g == NULL)
       throw InvalidSetter( COLUMBUS_LOCATION, CMSG_EX_INVALID_NODE_NO_TYPE);
     Key typeKey = g->strTable->set(type.getType());
+    if(g->compactStorage) {
+      g->compactStorage->vertexTypes[CompactStorage::vertexIndex(vertex)] = typeKey;
+      return;
+    }
     IndexMapVertexTypes types = get(vertex_type,*(g->getBGraph()));
     put(types,vertex,typeKey);
   }
@@ -273,13 +298,13 @@ namespace columbus {  namespace graph {
     if(g != node.g)
       return false;
     
-    return (get(vertex_UID, *g->getBGraph(), vertex) == get(vertex_UID, *node.g->getBGraph(), node.vertex));
+    return (g->getVertexUIDKey(vertex) == node.g->getVertexUIDKey(node.vertex));
   }
 
   int Node::hashCode() const {
     if(g == NULL)
       return 0;
-    size_t hash = get(vertex_UID, *g->getBGraph(), vertex);
+    size_t hash = g->getVertexUIDKey(vertex);
     hash ^= (size_t)g;
     HASHLONGTOINT(hash);
     return (int)hash;
@@ -304,7 +329,7 @@ namespace columbus {  namespace graph {
       return false;
 
     if (g == node.g) {
-      return (get(vertex_UID, *g->getBGraph(), vertex) < get(vertex_UID, *node.g->getBGraph(), node.vertex));
+      return (g->getVertexUIDKey(vertex) < node.g->getVertexUIDKey(node.vertex));
     } else  {
       return (getUID() < node.getUID());
       
@@ -328,15 +353,34 @@ namespace columbus {  namespace graph {
     iterators(itContainer),
     filteredNodes(filteredNodes),
     it(),
-    lastOp(op_None)
+    lastOp(op_None),
+    compact(false),
+    compactIt(0),
+    compactEnd(0)
   {
     iterators->push_back(this);
   }
 
+  Node::NodeIterator::NodeIterator(Graph* graph, unsigned vertexCount, const NodeTypeSet &filteredNodes) :
+    graph(graph),
+    container_begin(),
+    container_end(),
+    iterators(NULL),
+    filteredNodes(filteredNodes),
+    it(),
+    lastOp(op_None),
+    compact(true),
+    compactIt(vertexCount),
+    compactEnd(vertexCount)
+  {
+  }
+
   void Node::NodeIterator::add(const Node &node) {
   }
 
   void Node::NodeIterator::remove() {
+    if (compact)
+      throw GraphException( COLUMBUS_LOCATION, CMSG_EX_COMPACT_GRAPH_IS_READ_ONLY);
     switch (lastOp) {
       case op_None:
       case op_Add:
@@ -361,7 +405,10 @@ namespace columbus {  namespace graph {
     iterators(NULL),
     filteredNodes(NodeTypeSet()),
     it(),
-    lastOp(op_Invalidated)
+    lastOp(op_Invalidated),
+    compact(false),
+    compactIt(0),
+    compactEnd(0)
   {
   }
 
@@ -372,14 +419,17 @@ namespace columbus {  namespace graph {
     iterators(iterator.iterators),
     filteredNodes(iterator.filteredNodes),
     it(),
-    lastOp(iterator.lastOp)
+    lastOp(iterator.lastOp),
+    compact(iterator.compact),
+    compactIt(iterator.compactIt),
+    compactEnd(iterator.compactEnd)
   {
     if (lastOp != op_Invalidated && iterators)
       iterators->push_back(this);
   }
 
   Node::NodeIterator::~NodeIterator() {
-    if (lastOp != op_Invalidated) {
+    if (lastOp != op_Invalidated && iterators) {
       for (IteratorContainer::iterator _it = iterators->begin(); _it != iterators->end(); ++_it) {
         if (*_it == this) {
           iterators->erase(_it);
@@ -419,6 +469,9 @@ namespace columbus {  namespace graph {
     lastOp = otherIt.lastOp;
     graph = otherIt.graph;
     filteredNodes = otherIt.filteredNodes;
+    compact = otherIt.compact;
+    compactIt = otherIt.compactIt;
+    compactEnd = otherIt.compactEnd;
 
     if (lastOp != op_Invalidated && iterators && insertIntoIterators)
       iterators->push_back(this);
@@ -427,10 +480,22 @@ namespace columbus {  namespace graph {
   }
 
   bool Node::NodeIterator::hasNext() {
+    if (compact)
+      return nextCompactItem() != compactEnd;
     return nextItem() != container_end;
   }
 
   Node Node::NodeIterator::next() {
+    if (compact) {
+      compactIt = nextCompactItem();
+      lastOp = op_Next;
+
+      if (compactIt == compactEnd)
+        throw GraphNoSuchElementException( COLUMBUS_LOCATION, CMSG_EX_ITERATOR_NOT_NEXT_ELEMENT);
+
+      return Node(graph, CompactStorage::vertex(compactIt));
+    }
+
     it = nextItem();
     lastOp = op_Next;
 
@@ -441,10 +506,22 @@ namespace columbus {  namespace graph {
   }
 
   bool Node::NodeIterator::hasPrevious() {
+    if (compact)
+      return previousCompactItem() != compactEnd;
     return previousItem() != container_end;
   }
 
   Node Node::NodeIterator::previous() {
+    if (compact) {
+      compactIt = previousCompactItem();
+      lastOp = op_Previous;
+
+      if (compactIt == compactEnd)
+        throw GraphNoSuchElementException( COLUMBUS_LOCATION, CMSG_EX_ITERATOR_NOT_PREVIUS_ELEMENT);
+
+      return Node(graph, CompactStorage::vertex(compactIt));
+    }
+
     it = previousItem();
     lastOp = op_Previous;
 
@@ -574,6 +651,46 @@ namespace columbus {  namespace graph {
     return nextElement;
  }
 
+  bool Node::NodeIterator::isOutFilteredCompactItem(unsigned index) const {
+    return !filteredNodes.empty() && filteredNodes.find(NodeType(graph->getVertexType(CompactStorage::vertex(index)))) == filteredNodes.end();
+  }
+
+  unsigned Node::NodeIterator::nextCompactItem() {
+    unsigned j;
+    switch (lastOp) {
+      case op_None:       j = 0; break;
+      case op_Previous:   return compactIt;
+      case op_Invalidated:
+        throw GraphInvalidIteratorException( COLUMBUS_LOCATION, CMSG_EX_INVALID_ITERATOR);
+      default:            j = compactIt == compactEnd ? compactEnd : compactIt + 1; break;
+    }
+    while (j != compactEnd && isOutFilteredCompactItem(j))
+      ++j;
+    return j;
+  }
+
+  unsigned Node::NodeIterator::previousCompactItem() {
+    switch (lastOp) {
+      case op_None:       return compactEnd;
+      case op_Add:
+      case op_Next:       return compactIt;
+      case op_Remove:
+      case op_Previous:
+        if (compactIt == 0)
+          return compactEnd;
+        if (filteredNodes.empty())
+          return compactIt - 1;
+        // like findPreviousNotDeletedFiltered(), the first vertex is not returned if there is a filter
+        for (unsigned j = compactIt - 1; j != 0; --j)
+          if (!isOutFilteredCompactItem(j))
+            return j;
+        return compactEnd;
+      case op_Invalidated:
+        throw GraphInvalidIteratorException( COLUMBUS_LOCATION, CMSG_EX_INVALID_ITERATOR);
+    }
+    return compactEnd;
+  }
+
   void Node::NodeIterator::invalidate() {
     lastOp = op_Invalidated;
   }
@@ -36,6 +36,12 @@ namespace columbus { namespace graphsupport {
 
   protected:
 
+    /**
+     * \internal
+     * \brief position in a file (line, column)
+     */
+    typedef std::pair<int, int> Position;
+
     /**
      * \internal
      * \brief node range
@@ -47,20 +53,31 @@ namespace columbus { namespace graphsupport {
       int endCol;
       graph::Node node;
 
-      bool operator<(const RangedNode& rangedNode);
+      bool operator<(const RangedNode& rangedNode) const;
       RangedNode() : line(0), col(0), endLine(0), endCol(0), node() {}
     };
 
     /**
      * \internal
-     * \brief list of node range
+     * \brief the nodes of a path ordered by their start position
+     *
+     * The nodes are stored in a sorted array, which is also an implicit balanced search tree: the root of the
+     * subtree of the [lo, hi) range is the middle element, and maxEnd holds the greatest end position of each subtree.
+     * The new nodes are appended to the end of the array and they are merged into the sorted part by the next query.
      */
-    typedef std::list< RangedNode > NodePrioritiList;
+    struct RangeIndex {
+      std::vector<RangedNode> nodes;
+      std::vector<Position> maxEnd;
+      size_t sorted;
+
+      RangeIndex() : nodes(), maxEnd(), sorted(0) {}
+    };
+
     /**
      * \internal
      * \brief index by path
      */
-    typedef std::map< columbus::Key, NodePrioritiList > PathIndex;
+    typedef std::map< columbus::Key, RangeIndex > PathIndex;
     /**
      * \internal
      * \brief container for indexers
@@ -132,6 +149,39 @@ namespace columbus { namespace graphsupport {
      */
     void addNode(graph::Graph& graph, graph::Node& node, const std::string& path, int line, int col, int endLine, int endCol);
 
+    /**
+     * \internal
+     * \brief gives back the index of the path
+     * \param graph [in] the graph, witch has indexer
+     * \param path [in] the searched path
+     * \return the sorted index of the path, or NULL if the graph doesn't have index or the index doesn't contains 'path'
+     */
+    RangeIndex* findRangeIndex(const graph::Graph& graph, const std::string& path);
+
+    /**
+     * \internal
+     * \brief sorts the newly added nodes of the index and rebuilds the maximal end positions
+     */
+    static void sortRangeIndex(RangeIndex& rangeIndex);
+
+    /**
+     * \internal
+     * \brief computes the maximal end positions of the subtree of the [lo, hi) range
+     */
+    static Position buildMaxEnd(RangeIndex& rangeIndex, size_t lo, size_t hi);
+
+    /**
+     * \internal
+     * \brief gives back the number of the nodes starting at or before the 'end' position
+     */
+    static size_t countNodesStartingUntil(const RangeIndex& rangeIndex, const Position& end);
+
+    /**
+     * \internal
+     * \brief collects the nodes of the subtree of the [lo, hi) range, which start before 'last' and end after 'start'
+     */
+    static void collectNodes(const RangeIndex& rangeIndex, size_t lo, size_t hi, size_t last, const Position& start, std::list<graph::Node>& nodes);
+
 
   public:
 
@@ -169,6 +219,29 @@ namespace columbus { namespace graphsupport {
      */
     bool findNodesByRange(graph::Graph& graph, const std::string& path, int line, int col, int endLine, int endCol, std::list<graph::Node>& nodes);
 
+    /**
+     * \brief a searched range for findNodesByRanges
+     */
+    struct RangeQuery {
+      std::string path;
+      int line;
+      int col;
+      int endLine;
+      int endCol;
+
+      RangeQuery() : path(), line(0), col(0), endLine(0), endCol(0) {}
+      RangeQuery(const std::string& path, int line, int col, int endLine, int endCol) : path(path), line(line), col(col), endLine(endLine), endCol(endCol) {}
+    };
+
+    /**
+     * \brief find nodes by several ranges
+     * \param graph [in] graph, witch has an index object
+     * \param queries [in] the searched ranges, the path of the consecutive ranges with the same path is looked up only once, so they should be sorted by path
+     * \param nodes [out] the founded nodes for each range (it has the same size as 'queries', and the list is empty if the path is not in the index)
+     * \return false, if graph doesn't have index, otherwise return true
+     */
+    bool findNodesByRanges(graph::Graph& graph, const std::vector<RangeQuery>& queries, std::vector< std::list<graph::Node> >& nodes);
+
     /**
     * \brieg get instance from GraphRangeIndexer singleton class
     * \return a GraphRangeIndexer object
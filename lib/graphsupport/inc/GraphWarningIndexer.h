@@ -0,0 +1,169 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _GRAPHWARNINGINDEXER_H
+#define _GRAPHWARNINGINDEXER_H
+
+#include <graph/inc/graph.h>
+#include <map>
+#include <vector>
+#include <boost/unordered_set.hpp>
+
+namespace columbus { namespace graphsupport {
+
+  /**
+   * \brief index the warnings of the nodes by their fingerprints for the duplicate checks of addWarningOnce
+   *
+   * The fingerprint is the hash of the name, path, range and text of the warning. The warnings of a node are
+   * indexed by the first lookup on the node, and the warnings added by addWarning() and addWarningOnce() are
+   * added to the index later. The warnings added to the node by other ways after its first lookup are not
+   * recognised, so the index has to be turned off and on again in this case.
+   */
+  class GraphWarningIndexer {
+
+  protected:
+
+    /**
+     * \internal
+     * \brief the fingerprints of the warnings of a node
+     */
+    typedef boost::unordered_set<std::size_t> FingerprintSet;
+    /**
+     * \internal
+     * \brief index by node
+     */
+    typedef std::map< graph::Node, FingerprintSet > NodeIndex;
+    /**
+     * \internal
+     * \brief container for indexers
+     */
+    typedef std::vector< std::pair<const graph::Graph*, NodeIndex > > IndexContainer;
+
+  protected:
+    /**
+     * \internal \brief actual graph indexer object
+     */
+    static GraphWarningIndexer* indexerObj;
+    /**
+     * \internal \brief container for indexers
+     */
+    IndexContainer indexContainer;
+
+  protected:
+    /**
+    * \internal
+    * \brief protected constructor for singleton GraphWarningIndexer class
+    */
+    GraphWarningIndexer();
+
+    /**
+     * \internal
+     * \brief copy constructor
+     */
+    GraphWarningIndexer(const GraphWarningIndexer&);
+
+    /**
+    * \internal
+    * \brief return the index of the graph, or NULL if the indexer is not on at the graph
+    * \param graph [in] the graph
+    */
+    NodeIndex* findGraphNodeIndex(const graph::Graph& graph);
+
+    /**
+    * \internal
+    * \brief return the fingerprints of the node, they are collected from the attributes of the node at the first call
+    * \param nodeIndex [in] the index of the graph of the node
+    * \param node [in] the node
+    */
+    FingerprintSet& getFingerprints(NodeIndex& nodeIndex, const graph::Node& node);
+
+    /**
+    * \internal
+    * \brief computes the fingerprint of a warning
+    */
+    static std::size_t getFingerprint(const std::string& name, const std::string& path, int line, int col, int endLine, int endCol, const std::string& text);
+
+    /**
+    * \internal
+    * \brief computes the fingerprint of a warning attribute
+    * \return false, if some of the compared values are missing from the warning
+    */
+    static bool getFingerprint(graph::AttributeComposite& warning, std::size_t& fingerprint);
+
+  public:
+
+    /**
+    * \brief turn on indexer service on graph
+    * \param graph [in] the graph
+    */
+    void turnOn(graph::Graph& graph);
+
+    /**
+     * \brief turn off indexer service on graph
+     * \param graph [in] the indexed graph
+     */
+    void turnOff(graph::Graph& graph);
+
+    /**
+     * \brief gives back true, if indexer is on at the graph
+     * \param graph [in] the graph
+     */
+    bool getIsOn(const graph::Graph& graph);
+
+    /**
+     * \brief checks the fingerprint of the warning
+     * \param graph [in] the graph of the node
+     * \param node [in] the node
+     * \param name [in] the name of the warning
+     * \param path [in] the path of the warning
+     * \param line [in] the line of the warning
+     * \param col [in] the column of the warning
+     * \param endLine [in] the end line of the warning
+     * \param endCol [in] the end column of the warning
+     * \param text [in] the text of the warning
+     * \return false, if the node surely doesn't have the warning, true if the fingerprint is found or the graph doesn't have index
+     */
+    bool mayHaveWarning(graph::Graph& graph, const graph::Node& node, const std::string& name, const std::string& path, int line, int col, int endLine, int endCol, const std::string& text);
+
+    /**
+     * \brief adds the fingerprint of a new warning of the node to the index
+     * \param graph [in] the graph of the node
+     * \param node [in] the node
+     * \param name [in] the name of the warning
+     * \param path [in] the path of the warning
+     * \param line [in] the line of the warning
+     * \param col [in] the column of the warning
+     * \param endLine [in] the end line of the warning
+     * \param endCol [in] the end column of the warning
+     * \param text [in] the text of the warning
+     */
+    void addWarning(graph::Graph& graph, const graph::Node& node, const std::string& name, const std::string& path, int line, int col, int endLine, int endCol, const std::string& text);
+
+    /**
+    * \brief get instance from GraphWarningIndexer singleton class
+    * \return a GraphWarningIndexer object
+    */
+    static GraphWarningIndexer& getGraphWarningIndexerInstance();
+
+  };
+
+}}
+
+#endif
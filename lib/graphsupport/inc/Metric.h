@@ -23,6 +23,7 @@
 
 #include <graph/inc/graph.h>
 #include "GraphRangeIndexer.h"
+#include "GraphWarningIndexer.h"
 #include <string>
 #include <map>
 
@@ -186,6 +186,73 @@ namespace columbus { namespace graphsupport {
   static const string IDColumn = "ID";
   static const string ParentColumn = "Parent";
 
+  /**
+   * \brief the layout of the csv rows of a node type
+   */
+  enum RowKind {
+    rkNone,          // the type is not exported
+    rkLogical,       // classes, methods, attributes and the similar types
+    rkCloneClass,
+    rkCloneInstance,
+    rkComponent,
+    rkScope,         // packages, namespaces and rpg systems
+    rkPhysical       // files and folders
+  };
+
+  static map<string, RowKind> createRowKinds() {
+    map<string, RowKind> rowKinds;
+    rowKinds[graphconstants::NTYPE_LIM_CLASS] = rkLogical;
+    rowKinds[graphconstants::NTYPE_LIM_STRUCTURE] = rkLogical;
+    rowKinds[graphconstants::NTYPE_LIM_UNION] = rkLogical;
+    rowKinds[graphconstants::NTYPE_LIM_ENUM] = rkLogical;
+    rowKinds[graphconstants::NTYPE_LIM_INTERFACE] = rkLogical;
+    rowKinds[graphconstants::NTYPE_LIM_ANNOTATION] = rkLogical;
+    rowKinds[graphconstants::NTYPE_LIM_METHOD] = rkLogical;
+    rowKinds[graphconstants::NTYPE_LIM_FUNCTION] = rkLogical;
+    rowKinds[graphconstants::NTYPE_LIM_ATTRIBUTE] = rkLogical;
+    rowKinds[graphconstants::NTYPE_RPG_PROGRAM] = rkLogical;
+    rowKinds[graphconstants::NTYPE_RPG_MODULE] = rkLogical;
+    rowKinds[graphconstants::NTYPE_RPG_PROCEDURE] = rkLogical;
+    rowKinds[graphconstants::NTYPE_RPG_SUBROUTINE] = rkLogical;
+    rowKinds[graphconstants::NTYPE_LIM_MODULE] = rkLogical;
+    rowKinds[graphconstants::NTYPE_DCF_CLONECLASS] = rkCloneClass;
+    rowKinds[graphconstants::NTYPE_DCF_CLONEINSTANCE] = rkCloneInstance;
+    rowKinds[graphconstants::NTYPE_LIM_COMPONENT] = rkComponent;
+    rowKinds[graphconstants::NTYPE_LIM_PACKAGE] = rkScope;
+    rowKinds[graphconstants::NTYPE_RPG_SYSTEM] = rkScope;
+    rowKinds[graphconstants::NTYPE_LIM_NAMESPACE] = rkScope;
+    rowKinds[graphconstants::NTYPE_LIM_FILE] = rkPhysical;
+    rowKinds[graphconstants::NTYPE_LIM_FOLDER] = rkPhysical;
+    return rowKinds;
+  }
+
+  static RowKind getRowKind(const string& nodeType) {
+    static const map<string, RowKind> rowKinds = createRowKinds();
+    map<string, RowKind>::const_iterator it = rowKinds.find(nodeType);
+    return it == rowKinds.end() ? rkNone : it->second;
+  }
+
+  /**
+   * \brief the open csv file of a node type
+   */
+  struct CsvWriter {
+    RowKind kind;
+    const StringVector* metrics;
+    io::CsvIO csv;
+
+    CsvWriter() : kind(rkNone), metrics(NULL), csv() {}
+  };
+
+  typedef map<string, CsvWriter> CsvWriterMap;
+
+  static void writePositionHeader(io::CsvIO& csvHeader) {
+    csvHeader.writeColumn(graphconstants::ATTR_PATH);
+    csvHeader.writeColumn(graphconstants::ATTR_LINE);
+    csvHeader.writeColumn(graphconstants::ATTR_COLUMN);
+    csvHeader.writeColumn(graphconstants::ATTR_ENDLINE);
+    csvHeader.writeColumn(graphconstants::ATTR_ENDCOLUMN);
+  }
+
   void exportReadableMetricsCSV(graph::Graph& graph, const string& filename, char separator, char dmark) {
     string fname, fext;
     common::splitExt(filename, fname, fext);
@@ -401,243 +468,183 @@ namespace columbus { namespace graphsupport {
       }
     } 
 
-    // Create the csv file headers
+    // Open the csv files and write their headers. The files remain open until all the rows are written.
+    CsvWriterMap writers;
     for (StringStringVectorMap::iterator nodeTypeIterator = reorderedMetricsMap.begin(); nodeTypeIterator != reorderedMetricsMap.end(); ++nodeTypeIterator) {
-      if (nodeTypeIterator->first == graphconstants::NTYPE_LIM_CLASS ||
-        nodeTypeIterator->first == graphconstants::NTYPE_LIM_STRUCTURE ||
-        nodeTypeIterator->first == graphconstants::NTYPE_LIM_UNION ||
-        nodeTypeIterator->first == graphconstants::NTYPE_LIM_ENUM ||
-        nodeTypeIterator->first == graphconstants::NTYPE_LIM_INTERFACE ||
-        nodeTypeIterator->first == graphconstants::NTYPE_LIM_ANNOTATION ||
-        nodeTypeIterator->first == graphconstants::NTYPE_LIM_METHOD ||
-        nodeTypeIterator->first == graphconstants::NTYPE_LIM_FUNCTION ||
-        nodeTypeIterator->first == graphconstants::NTYPE_LIM_ATTRIBUTE ||
-        nodeTypeIterator->first == graphconstants::NTYPE_RPG_PROGRAM ||
-        nodeTypeIterator->first == graphconstants::NTYPE_RPG_MODULE ||
-        nodeTypeIterator->first == graphconstants::NTYPE_RPG_PROCEDURE ||
-        nodeTypeIterator->first == graphconstants::NTYPE_RPG_SUBROUTINE ||
-        nodeTypeIterator->first == graphconstants::NTYPE_LIM_MODULE)
-      {
-        io::CsvIO csvHeader(csvName(fname, fext, nodeTypeIterator->first), io::IOBase::omWrite);
-        setCsvStyle(csvHeader, separator, dmark);
-        csvHeader.writeColumn(IDColumn);
-        csvHeader.writeColumn(graphconstants::ATTR_NAME);
-        csvHeader.writeColumn(graphconstants::ATTR_LONGNAME);
-        csvHeader.writeColumn(ParentColumn);
-        csvHeader.writeColumn(graphconstants::NTYPE_LIM_COMPONENT);
-
-        if (asg == graphconstants::HEADER_ASG_VALUE_CPP) {
-          csvHeader.writeColumn(graphconstants::ATTR_REALIZATIONLEVEL);
-        }
-       
-        csvHeader.writeColumn(graphconstants::ATTR_PATH);
-        csvHeader.writeColumn(graphconstants::ATTR_LINE);
-        csvHeader.writeColumn(graphconstants::ATTR_COLUMN);
-        csvHeader.writeColumn(graphconstants::ATTR_ENDLINE);
-        csvHeader.writeColumn(graphconstants::ATTR_ENDCOLUMN);
-       
-        writeMetricsHeader(nodeTypeIterator->second, csvHeader);
-        csvHeader.writeNewLine();
-        csvHeader.close();
-
-      } else if (nodeTypeIterator->first == graphconstants::NTYPE_DCF_CLONECLASS) {
-        io::CsvIO csvHeader(csvName(fname, fext, nodeTypeIterator->first), io::IOBase::omWrite);
-        setCsvStyle(csvHeader, separator, dmark);
-        csvHeader.writeColumn(IDColumn);
-        csvHeader.writeColumn(graphconstants::ATTR_NAME);
-        csvHeader.writeColumn(graphconstants::NTYPE_LIM_COMPONENT);
-        writeMetricsHeader(nodeTypeIterator->second, csvHeader);
-        csvHeader.writeNewLine();
-        csvHeader.close();
-
-      } else if (nodeTypeIterator->first == graphconstants::NTYPE_DCF_CLONEINSTANCE) {
-        io::CsvIO csvHeader(csvName(fname, fext, nodeTypeIterator->first), io::IOBase::omWrite);
-        setCsvStyle(csvHeader, separator, dmark);
-        csvHeader.writeColumn(IDColumn);
-        csvHeader.writeColumn(graphconstants::ATTR_NAME);
-        csvHeader.writeColumn(ParentColumn);
-        csvHeader.writeColumn(graphconstants::NTYPE_LIM_COMPONENT);
-
-        csvHeader.writeColumn(graphconstants::ATTR_PATH);
-        csvHeader.writeColumn(graphconstants::ATTR_LINE);
-        csvHeader.writeColumn(graphconstants::ATTR_COLUMN);
-        csvHeader.writeColumn(graphconstants::ATTR_ENDLINE);
-        csvHeader.writeColumn(graphconstants::ATTR_ENDCOLUMN);
-
-        writeMetricsHeader(nodeTypeIterator->second, csvHeader);
-        csvHeader.writeNewLine();
-        csvHeader.close();
-
-      } else if (nodeTypeIterator->first == graphconstants::NTYPE_LIM_COMPONENT) {
-        io::CsvIO csvHeader(csvName(fname, fext, nodeTypeIterator->first), io::IOBase::omWrite);
-        setCsvStyle(csvHeader, separator, dmark);
-        csvHeader.writeColumn(IDColumn);
-        csvHeader.writeColumn(graphconstants::ATTR_NAME);
-        csvHeader.writeColumn(graphconstants::ATTR_LONGNAME);
-        writeMetricsHeader(nodeTypeIterator->second, csvHeader);
-        csvHeader.writeNewLine();
-        csvHeader.close();
-
-      } else if (nodeTypeIterator->first == graphconstants::NTYPE_LIM_PACKAGE ||
-        nodeTypeIterator->first == graphconstants::NTYPE_RPG_SYSTEM ||
-        nodeTypeIterator->first == graphconstants::NTYPE_LIM_NAMESPACE)
-      {
-        io::CsvIO csvHeader(csvName(fname, fext, nodeTypeIterator->first), io::IOBase::omWrite);
-        setCsvStyle(csvHeader, separator, dmark);
-        csvHeader.writeColumn(IDColumn);
-        csvHeader.writeColumn(graphconstants::ATTR_NAME);
-        csvHeader.writeColumn(graphconstants::ATTR_LONGNAME);
-        csvHeader.writeColumn(ParentColumn);
-        csvHeader.writeColumn(graphconstants::NTYPE_LIM_COMPONENT);
-        writeMetricsHeader(nodeTypeIterator->second, csvHeader);
-        csvHeader.writeNewLine();
-        csvHeader.close();
-      } else if (nodeTypeIterator->first == graphconstants::NTYPE_LIM_FILE ||
-        nodeTypeIterator->first == graphconstants::NTYPE_LIM_FOLDER)
-      {
-        io::CsvIO csvHeader(csvName(fname, fext, nodeTypeIterator->first), io::IOBase::omWrite);
-        setCsvStyle(csvHeader, separator, dmark);
-        csvHeader.writeColumn(IDColumn);
-        csvHeader.writeColumn(graphconstants::ATTR_NAME);
-        csvHeader.writeColumn(graphconstants::ATTR_LONGNAME);
-        csvHeader.writeColumn(ParentColumn);
-        writeMetricsHeader(nodeTypeIterator->second, csvHeader);
-        csvHeader.writeNewLine();
-        csvHeader.close();
+      RowKind kind = getRowKind(nodeTypeIterator->first);
+      if (kind == rkNone)
+        continue;
+
+      CsvWriter& writer = writers[nodeTypeIterator->first];
+      writer.kind = kind;
+      writer.metrics = &nodeTypeIterator->second;
+      writer.csv.open(csvName(fname, fext, nodeTypeIterator->first), io::IOBase::omWrite);
+      io::CsvIO& csvHeader = writer.csv;
+      setCsvStyle(csvHeader, separator, dmark);
+      csvHeader.writeColumn(IDColumn);
+      csvHeader.writeColumn(graphconstants::ATTR_NAME);
+
+      switch (kind) {
+        case rkLogical:
+          csvHeader.writeColumn(graphconstants::ATTR_LONGNAME);
+          csvHeader.writeColumn(ParentColumn);
+          csvHeader.writeColumn(graphconstants::NTYPE_LIM_COMPONENT);
+          if (asg == graphconstants::HEADER_ASG_VALUE_CPP)
+            csvHeader.writeColumn(graphconstants::ATTR_REALIZATIONLEVEL);
+          writePositionHeader(csvHeader);
+          break;
+        case rkCloneClass:
+          csvHeader.writeColumn(graphconstants::NTYPE_LIM_COMPONENT);
+          break;
+        case rkCloneInstance:
+          csvHeader.writeColumn(ParentColumn);
+          csvHeader.writeColumn(graphconstants::NTYPE_LIM_COMPONENT);
+          writePositionHeader(csvHeader);
+          break;
+        case rkComponent:
+          csvHeader.writeColumn(graphconstants::ATTR_LONGNAME);
+          break;
+        case rkScope:
+          csvHeader.writeColumn(graphconstants::ATTR_LONGNAME);
+          csvHeader.writeColumn(ParentColumn);
+          csvHeader.writeColumn(graphconstants::NTYPE_LIM_COMPONENT);
+          break;
+        case rkPhysical:
+          csvHeader.writeColumn(graphconstants::ATTR_LONGNAME);
+          csvHeader.writeColumn(ParentColumn);
+          break;
+        default:
+          break;
       }
+
+      writeMetricsHeader(nodeTypeIterator->second, csvHeader);
+      csvHeader.writeNewLine();
     }
 
     // Write out the metric values
+    const bool writeRealizationLevel = asg == graphconstants::HEADER_ASG_VALUE_CPP;
+    const StringVector noMetrics;
     allNodes = graph.getNodes();
     while (allNodes.hasNext()) {
       Node node = allNodes.next();
       string nodeType = node.getType().getType();
-      if (nodeType == graphconstants::NTYPE_LIM_CLASS ||
-        nodeType == graphconstants::NTYPE_LIM_STRUCTURE ||
-        nodeType == graphconstants::NTYPE_LIM_UNION ||
-        nodeType == graphconstants::NTYPE_LIM_ENUM ||
-        nodeType == graphconstants::NTYPE_LIM_INTERFACE ||
-        nodeType == graphconstants::NTYPE_LIM_ANNOTATION ||
-        nodeType == graphconstants::NTYPE_LIM_METHOD ||
-        nodeType == graphconstants::NTYPE_LIM_FUNCTION ||
-        nodeType == graphconstants::NTYPE_LIM_ATTRIBUTE ||
-        nodeType == graphconstants::NTYPE_RPG_PROGRAM ||
-        nodeType == graphconstants::NTYPE_RPG_MODULE ||
-        nodeType == graphconstants::NTYPE_RPG_PROCEDURE ||
-        nodeType == graphconstants::NTYPE_RPG_SUBROUTINE ||
-        nodeType == graphconstants::NTYPE_LIM_MODULE)
-      {
-        io::CsvIO csvOut(csvName(fname, fext, nodeType), io::IOBase::omAppend);
-        setCsvStyle(csvOut, separator, dmark);
-        csvOut.writeColumn(node.getUID());
-        string name;
-        getNodeNameAttribute(node, name);
-        csvOut.writeColumn(name);
 
-        getNodeLongNameAttribute(node, name);
-        csvOut.writeColumn(name);
+      CsvWriterMap::iterator writerIt = writers.find(nodeType);
+      if (writerIt == writers.end()) {
+        RowKind kind = getRowKind(nodeType);
+        if (kind == rkNone)
+          continue;
 
-        writeParent(node, csvOut, Edge::EdgeType(graphconstants::ETYPE_LIM_LOGICALTREE, Edge::edtReverse));
+        // There is no header for this type, so the rows are appended to the existing file as before.
+        CsvWriter& writer = writers[nodeType];
+        writer.kind = kind;
+        writer.metrics = &noMetrics;
+        writer.csv.open(csvName(fname, fext, nodeType), io::IOBase::omAppend);
+        setCsvStyle(writer.csv, separator, dmark);
+        writerIt = writers.find(nodeType);
+      }
 
-        string asg = graph.getHeaderInfo(graphconstants::HEADER_ASG_KEY);
-        
-        writeComponents(node, csvOut);
-
-        writePositionColumns(node, csvOut, asg == graphconstants::HEADER_ASG_VALUE_CPP);
-        writeMetrics(reorderedMetricsMap[nodeType], node, csvOut);
-        csvOut.writeNewLine();
-        csvOut.close();
-
-      } else if (nodeType == graphconstants::NTYPE_DCF_CLONECLASS) {
-        const Attribute& cloneSmellAttr = getNodeAttribute(node, Attribute::atString, graphconstants::ATTR_DCF_CLONESMELLTYPE, graphconstants::CONTEXT_ATTRIBUTE);
-        if (cloneSmellAttr.getStringValue() != "cstDisappearing") {
-          io::CsvIO csvOut(csvName(fname, fext, nodeType), io::IOBase::omAppend);
-          setCsvStyle(csvOut, separator, dmark);
+      CsvWriter& writer = writerIt->second;
+      io::CsvIO& csvOut = writer.csv;
+      switch (writer.kind) {
+        case rkLogical: {
           csvOut.writeColumn(node.getUID());
           string name;
           getNodeNameAttribute(node, name);
           csvOut.writeColumn(name);
+
+          getNodeLongNameAttribute(node, name);
+          csvOut.writeColumn(name);
+
+          writeParent(node, csvOut, Edge::EdgeType(graphconstants::ETYPE_LIM_LOGICALTREE, Edge::edtReverse));
           writeComponents(node, csvOut);
-          writeMetrics(reorderedMetricsMap[nodeType], node, csvOut);
+          writePositionColumns(node, csvOut, writeRealizationLevel);
+          writeMetrics(*writer.metrics, node, csvOut);
           csvOut.writeNewLine();
-          csvOut.close();
+          break;
         }
-      } else if (nodeType == graphconstants::NTYPE_DCF_CLONEINSTANCE) {
-        const Attribute& cloneSmellAttr = getNodeAttribute(node, Attribute::atString, graphconstants::ATTR_DCF_CLONESMELLTYPE, graphconstants::CONTEXT_ATTRIBUTE);
-        bool fakeInstance = cloneSmellAttr.getStringValue() == "cstDisappearing";
-        if (!fakeInstance) {
-          Node parentNode = getParent(node,  Edge::EdgeType(graphconstants::ETYPE_DCF_CLONETREE, Edge::edtReverse));
-          const Attribute& cloneSmellAttr = getNodeAttribute(parentNode, Attribute::atString, graphconstants::ATTR_DCF_CLONESMELLTYPE, graphconstants::CONTEXT_ATTRIBUTE);
-          fakeInstance = cloneSmellAttr.getStringValue() == "cstDisappearing";
+        case rkCloneClass: {
+          const Attribute& cloneSmellAttr = getNodeAttribute(node, Attribute::atString, graphconstants::ATTR_DCF_CLONESMELLTYPE, graphconstants::CONTEXT_ATTRIBUTE);
+          if (cloneSmellAttr.getStringValue() != "cstDisappearing") {
+            csvOut.writeColumn(node.getUID());
+            string name;
+            getNodeNameAttribute(node, name);
+            csvOut.writeColumn(name);
+            writeComponents(node, csvOut);
+            writeMetrics(*writer.metrics, node, csvOut);
+            csvOut.writeNewLine();
+          }
+          break;
         }
-        if (!fakeInstance) {
-          io::CsvIO csvOut(csvName(fname, fext, nodeType), io::IOBase::omAppend);
-          setCsvStyle(csvOut, separator, dmark);
+        case rkCloneInstance: {
+          const Attribute& cloneSmellAttr = getNodeAttribute(node, Attribute::atString, graphconstants::ATTR_DCF_CLONESMELLTYPE, graphconstants::CONTEXT_ATTRIBUTE);
+          bool fakeInstance = cloneSmellAttr.getStringValue() == "cstDisappearing";
+          if (!fakeInstance) {
+            Node parentNode = getParent(node,  Edge::EdgeType(graphconstants::ETYPE_DCF_CLONETREE, Edge::edtReverse));
+            const Attribute& cloneSmellAttr = getNodeAttribute(parentNode, Attribute::atString, graphconstants::ATTR_DCF_CLONESMELLTYPE, graphconstants::CONTEXT_ATTRIBUTE);
+            fakeInstance = cloneSmellAttr.getStringValue() == "cstDisappearing";
+          }
+          if (!fakeInstance) {
+            csvOut.writeColumn(node.getUID());
+            string name;
+            getNodeNameAttribute(node, name);
+            csvOut.writeColumn(name);
+            writeParent(node, csvOut, Edge::EdgeType(graphconstants::ETYPE_DCF_CLONETREE, Edge::edtReverse));
+            writeComponents(node, csvOut);
+            writePositionColumns(node, csvOut);
+            writeMetrics(*writer.metrics, node, csvOut);
+            csvOut.writeNewLine();
+          }
+          break;
+        }
+        case rkComponent: {
           csvOut.writeColumn(node.getUID());
           string name;
           getNodeNameAttribute(node, name);
-          csvOut.writeColumn(name);        
-          writeParent(node, csvOut, Edge::EdgeType(graphconstants::ETYPE_DCF_CLONETREE, Edge::edtReverse));
-          writeComponents(node, csvOut);
-          writePositionColumns(node, csvOut);
-          writeMetrics(reorderedMetricsMap[nodeType], node, csvOut);
-          csvOut.writeNewLine();
-          csvOut.close();
-        }
-      } else if (nodeType == graphconstants::NTYPE_LIM_COMPONENT) {
-        io::CsvIO csvOut(csvName(fname, fext, nodeType), io::IOBase::omAppend);
-        setCsvStyle(csvOut, separator, dmark);
-        csvOut.writeColumn(node.getUID());
-        string name;
-        getNodeNameAttribute(node, name);
-        csvOut.writeColumn(name);
-
-        getNodeLongNameAttribute(node, name);
-        csvOut.writeColumn(name);
+          csvOut.writeColumn(name);
 
-        writeMetrics(reorderedMetricsMap[nodeType], node, csvOut);
-        csvOut.writeNewLine();
-        csvOut.close();
-
-      } else if (nodeType == graphconstants::NTYPE_LIM_PACKAGE ||
-        nodeType == graphconstants::NTYPE_RPG_SYSTEM ||
-        nodeType == graphconstants::NTYPE_LIM_NAMESPACE)
-      {
-        io::CsvIO csvOut(csvName(fname, fext, nodeType), io::IOBase::omAppend);
-        setCsvStyle(csvOut, separator, dmark);
-        csvOut.writeColumn(node.getUID());
-        string name;
-        getNodeNameAttribute(node, name);
-        csvOut.writeColumn(name);
+          getNodeLongNameAttribute(node, name);
+          csvOut.writeColumn(name);
 
-        getNodeLongNameAttribute(node, name);
-        csvOut.writeColumn(name);
+          writeMetrics(*writer.metrics, node, csvOut);
+          csvOut.writeNewLine();
+          break;
+        }
+        case rkScope: {
+          csvOut.writeColumn(node.getUID());
+          string name;
+          getNodeNameAttribute(node, name);
+          csvOut.writeColumn(name);
 
-        writeParent(node, csvOut, Edge::EdgeType(graphconstants::ETYPE_LIM_LOGICALTREE, Edge::edtReverse));
-        writeComponents(node, csvOut);
-        writeMetrics(reorderedMetricsMap[nodeType], node, csvOut);
-        csvOut.writeNewLine();
-        csvOut.close();
-
-      } else if (nodeType == graphconstants::NTYPE_LIM_FILE ||
-        nodeType == graphconstants::NTYPE_LIM_FOLDER)
-      {
-        io::CsvIO csvOut(csvName(fname, fext, nodeType), io::IOBase::omAppend);
-        setCsvStyle(csvOut, separator, dmark);
-        csvOut.writeColumn(node.getUID());
-        string name;
-        getNodeNameAttribute(node, name);
-        csvOut.writeColumn(name);
+          getNodeLongNameAttribute(node, name);
+          csvOut.writeColumn(name);
 
-        getNodeLongNameAttribute(node, name);
-        csvOut.writeColumn(name);
+          writeParent(node, csvOut, Edge::EdgeType(graphconstants::ETYPE_LIM_LOGICALTREE, Edge::edtReverse));
+          writeComponents(node, csvOut);
+          writeMetrics(*writer.metrics, node, csvOut);
+          csvOut.writeNewLine();
+          break;
+        }
+        case rkPhysical: {
+          csvOut.writeColumn(node.getUID());
+          string name;
+          getNodeNameAttribute(node, name);
+          csvOut.writeColumn(name);
 
-        writeParent(node, csvOut, Edge::EdgeType(graphconstants::ETYPE_LIM_PHYSICALTREE, Edge::edtReverse));
-        writeMetrics(reorderedMetricsMap[nodeType], node, csvOut);
-        csvOut.writeNewLine();
-        csvOut.close();
+          getNodeLongNameAttribute(node, name);
+          csvOut.writeColumn(name);
 
+          writeParent(node, csvOut, Edge::EdgeType(graphconstants::ETYPE_LIM_PHYSICALTREE, Edge::edtReverse));
+          writeMetrics(*writer.metrics, node, csvOut);
+          csvOut.writeNewLine();
+          break;
+        }
+        default:
+          break;
       }
     }
+
+    for (CsvWriterMap::iterator writerIt = writers.begin(); writerIt != writers.end(); ++writerIt)
+      writerIt->second.csv.close();
   }
 }}
@@ -22,6 +22,8 @@
 #include "../inc/Metric.h"
 #include "../inc/GraphConstants.h"
 #include <common/inc/StringSup.h>
+#include <algorithm>
+#include <climits>
 
 
 using namespace columbus::graph;
@@ -83,18 +85,12 @@ namespace columbus { namespace graphsupport {
     while(nodeIt.hasNext()) {
       Node node = nodeIt.next();
       RangedNode rangedNode;
-      Key path;
+      Key path = 0;
       rangedNode.node = node;
       getRangeFromNode(node, rangedNode, path);
 
-      NodePrioritiList& priList = index[path];
-      // insert node to list, list stay sorted
-      NodePrioritiList::iterator listIt;
-      for(listIt = priList.begin(); listIt != priList.end(); listIt++) {
-        if(rangedNode < *listIt) 
-          break;
-      }
-      priList.insert(listIt, rangedNode);
+      // the nodes are sorted by the first query
+      index[path].nodes.push_back(rangedNode);
     }
   }
 
@@ -111,43 +107,103 @@ namespace columbus { namespace graphsupport {
     indexContainer.erase(it);
   }
 
-  bool GraphRangeIndexer::findNodesByPath(graph::Graph& graph, const string& origPath, std::list<graph::Node>& nodes) {
+  GraphRangeIndexer::RangeIndex* GraphRangeIndexer::findRangeIndex(const graph::Graph& graph, const string& origPath) {
     if(!getIsOn(graph))
-      return false;
+      return NULL;
     string path = origPath;
     correctPath(path);
     Key pathKey = strTable.get(path);
     if(!pathKey)
-      return false;
+      return NULL;
     PathIndex& index = getGraphPathIndex(graph);
     PathIndex::iterator mapIt = index.find(pathKey);
     if(mapIt == index.end())
+      return NULL;
+    if(mapIt->second.sorted != mapIt->second.nodes.size())
+      sortRangeIndex(mapIt->second);
+    return &mapIt->second;
+  }
+
+  void GraphRangeIndexer::sortRangeIndex(RangeIndex& rangeIndex) {
+    // the stable sort and merge keep the nodes with the same start position in the order of their insertion
+    vector<RangedNode>::iterator middle = rangeIndex.nodes.begin() + rangeIndex.sorted;
+    stable_sort(middle, rangeIndex.nodes.end());
+    inplace_merge(rangeIndex.nodes.begin(), middle, rangeIndex.nodes.end());
+    rangeIndex.sorted = rangeIndex.nodes.size();
+
+    rangeIndex.maxEnd.resize(rangeIndex.nodes.size());
+    buildMaxEnd(rangeIndex, 0, rangeIndex.nodes.size());
+  }
+
+  GraphRangeIndexer::Position GraphRangeIndexer::buildMaxEnd(RangeIndex& rangeIndex, size_t lo, size_t hi) {
+    if(lo >= hi)
+      return Position(INT_MIN, INT_MIN);
+    size_t mid = lo + (hi - lo) / 2;
+    const RangedNode& rangedNode = rangeIndex.nodes[mid];
+    Position maxEnd = max(Position(rangedNode.endLine, rangedNode.endCol), max(buildMaxEnd(rangeIndex, lo, mid), buildMaxEnd(rangeIndex, mid + 1, hi)));
+    rangeIndex.maxEnd[mid] = maxEnd;
+    return maxEnd;
+  }
+
+  void GraphRangeIndexer::collectNodes(const RangeIndex& rangeIndex, size_t lo, size_t hi, size_t last, const Position& start, std::list<graph::Node>& nodes) {
+    if(lo >= hi || lo >= last)
+      return;
+    size_t mid = lo + (hi - lo) / 2;
+    // none of the nodes of the subtree reaches the start of the range
+    if(rangeIndex.maxEnd[mid] < start)
+      return;
+    collectNodes(rangeIndex, lo, mid, last, start, nodes);
+    if(mid < last) {
+      const RangedNode& rangedNode = rangeIndex.nodes[mid];
+      if(!(Position(rangedNode.endLine, rangedNode.endCol) < start))
+        nodes.push_back(rangedNode.node);
+      collectNodes(rangeIndex, mid + 1, hi, last, start, nodes);
+    }
+  }
+
+  bool GraphRangeIndexer::findNodesByPath(graph::Graph& graph, const string& origPath, std::list<graph::Node>& nodes) {
+    RangeIndex* rangeIndex = findRangeIndex(graph, origPath);
+    if(!rangeIndex)
       return false;
-    NodePrioritiList& list = mapIt->second;
-    for(NodePrioritiList::iterator it = list.begin(); it != list.end(); it++)
+    for(vector<RangedNode>::const_iterator it = rangeIndex->nodes.begin(); it != rangeIndex->nodes.end(); it++)
       nodes.push_back(it->node);
     return true;
   }
 
+  size_t GraphRangeIndexer::countNodesStartingUntil(const RangeIndex& rangeIndex, const Position& end) {
+    return upper_bound(rangeIndex.nodes.begin(), rangeIndex.nodes.end(), end, [](const Position& position, const RangedNode& rangedNode) {
+      return position < Position(rangedNode.line, rangedNode.col);
+    }) - rangeIndex.nodes.begin();
+  }
+
   bool GraphRangeIndexer::findNodesByRange(graph::Graph& graph, const string& origPath, int line, int col, int endLine, int endCol, std::list<graph::Node>& nodes) {
-    if(!getIsOn(graph))
+    RangeIndex* rangeIndex = findRangeIndex(graph, origPath);
+    if(!rangeIndex)
       return false;
-    string path = origPath;
-    correctPath(path);
-    Key pathKey = strTable.get(path);
-    if(!pathKey)
-      return false;
-    PathIndex& index = getGraphPathIndex(graph);
-    PathIndex::iterator mapIt = index.find(pathKey);
-    if(mapIt == index.end())
-      return false;
-    NodePrioritiList& list = mapIt->second;
-    for(NodePrioritiList::iterator it = list.begin(); it != list.end(); it++) {
-      if( (endLine < it->line) || ((endLine == it->line) && (endCol < it->col)) )
-        break;
+    // only the nodes starting before the end of the range can overlap it
+    size_t last = countNodesStartingUntil(*rangeIndex, Position(endLine, endCol));
+    collectNodes(*rangeIndex, 0, rangeIndex->nodes.size(), last, Position(line, col), nodes);
+    return true;
+  }
 
-      if( (line < it->endLine) || ((line == it->endLine) &&  (col <= (it->endCol))) )
-        nodes.push_back(it->node);
+  bool GraphRangeIndexer::findNodesByRanges(graph::Graph& graph, const std::vector<RangeQuery>& queries, std::vector< std::list<graph::Node> >& nodes) {
+    nodes.clear();
+    if(!getIsOn(graph))
+      return false;
+    nodes.resize(queries.size());
+
+    const string* lastPath = NULL;
+    RangeIndex* rangeIndex = NULL;
+    for(size_t i = 0; i < queries.size(); ++i) {
+      const RangeQuery& query = queries[i];
+      if(!lastPath || *lastPath != query.path) {
+        rangeIndex = findRangeIndex(graph, query.path);
+        lastPath = &query.path;
+      }
+      if(!rangeIndex)
+        continue;
+      size_t last = countNodesStartingUntil(*rangeIndex, Position(query.endLine, query.endCol));
+      collectNodes(*rangeIndex, 0, rangeIndex->nodes.size(), last, Position(query.line, query.col), nodes[i]);
     }
     return true;
   }
@@ -156,7 +212,7 @@ namespace columbus { namespace graphsupport {
 
   StrTable GraphRangeIndexer::strTable = StrTable();
 
-  bool GraphRangeIndexer::RangedNode::operator<(const GraphRangeIndexer::RangedNode &rangedNode) {
+  bool GraphRangeIndexer::RangedNode::operator<(const GraphRangeIndexer::RangedNode &rangedNode) const {
     if(this->line < rangedNode.line)
       return true;
     if(this->line == rangedNode.line)
@@ -178,14 +234,8 @@ namespace columbus { namespace graphsupport {
     rangedNode.endCol = endCol;
     rangedNode.endLine = endLine;
 
-    NodePrioritiList& priList = index[pathKey];
-    // insert node to list, list stay sorted
-    NodePrioritiList::iterator listIt;
-    for(listIt = priList.begin(); listIt != priList.end(); listIt++) {
-      if(rangedNode < *listIt) 
-        break;
-    }
-    priList.insert(listIt, rangedNode);
+    // the node is merged into the sorted nodes by the next query
+    index[pathKey].nodes.push_back(rangedNode);
   }
 
 
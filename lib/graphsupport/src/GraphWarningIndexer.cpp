@@ -0,0 +1,159 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#include "../inc/GraphWarningIndexer.h"
+#include "../inc/GraphConstants.h"
+#include <boost/functional/hash.hpp>
+
+
+using namespace columbus::graph;
+using namespace std;
+
+namespace columbus { namespace graphsupport {
+
+  GraphWarningIndexer::GraphWarningIndexer() : indexContainer() {
+  }
+
+  GraphWarningIndexer::GraphWarningIndexer(const GraphWarningIndexer&) : indexContainer() {
+  }
+
+  GraphWarningIndexer& GraphWarningIndexer::getGraphWarningIndexerInstance() {
+    if(indexerObj == NULL)
+      indexerObj = new GraphWarningIndexer();
+    return *indexerObj;
+  }
+
+  GraphWarningIndexer::NodeIndex* GraphWarningIndexer::findGraphNodeIndex(const graph::Graph& graph) {
+    for(IndexContainer::iterator it = indexContainer.begin(); it != indexContainer.end(); it++) {
+      if(it->first == &graph) {
+        return &it->second;
+      }
+    }
+    return NULL;
+  }
+
+  bool GraphWarningIndexer::getIsOn(const graph::Graph& graph) {
+    return findGraphNodeIndex(graph) != NULL;
+  }
+
+  void GraphWarningIndexer::turnOn(graph::Graph& graph) {
+    if(getIsOn(graph))
+      return;
+    // the nodes are indexed by their first lookup
+    indexContainer.push_back(make_pair(&graph, NodeIndex()));
+  }
+
+  void GraphWarningIndexer::turnOff(graph::Graph& graph) {
+    for(IndexContainer::iterator it = indexContainer.begin(); it != indexContainer.end(); it++) {
+      if(it->first == &graph) {
+        indexContainer.erase(it);
+        return;
+      }
+    }
+  }
+
+  size_t GraphWarningIndexer::getFingerprint(const string& name, const string& path, int line, int col, int endLine, int endCol, const string& text) {
+    size_t fingerprint = 0;
+    boost::hash_combine(fingerprint, name);
+    boost::hash_combine(fingerprint, path);
+    boost::hash_combine(fingerprint, line);
+    boost::hash_combine(fingerprint, col);
+    boost::hash_combine(fingerprint, endLine);
+    boost::hash_combine(fingerprint, endCol);
+    boost::hash_combine(fingerprint, text);
+    return fingerprint;
+  }
+
+  bool GraphWarningIndexer::getFingerprint(AttributeComposite& warning, size_t& fingerprint) {
+    const string* path = NULL;
+    const string* text = NULL;
+    int line = 0, col = 0, endLine = 0, endCol = 0;
+    int found = 0;
+
+    Attribute::AttributeIterator it = warning.getAttributes();
+    while(it.hasNext()) {
+      Attribute& attr = it.next();
+      const string& attrName = attr.getName();
+      if(attrName == graphconstants::ATTR_PATH && attr.getType() == Attribute::atString) {
+        path = &static_cast<AttributeString&>(attr).getValue();
+        found |= 1;
+      } else if(attrName == graphconstants::ATTR_WARNINGTEXT && attr.getType() == Attribute::atString) {
+        text = &static_cast<AttributeString&>(attr).getValue();
+        found |= 2;
+      } else if(attrName == graphconstants::ATTR_LINE && attr.getType() == Attribute::atInt) {
+        line = static_cast<AttributeInt&>(attr).getValue();
+        found |= 4;
+      } else if(attrName == graphconstants::ATTR_COLUMN && attr.getType() == Attribute::atInt) {
+        col = static_cast<AttributeInt&>(attr).getValue();
+        found |= 8;
+      } else if(attrName == graphconstants::ATTR_ENDLINE && attr.getType() == Attribute::atInt) {
+        endLine = static_cast<AttributeInt&>(attr).getValue();
+        found |= 16;
+      } else if(attrName == graphconstants::ATTR_ENDCOLUMN && attr.getType() == Attribute::atInt) {
+        endCol = static_cast<AttributeInt&>(attr).getValue();
+        found |= 32;
+      }
+    }
+
+    if(found != 63)
+      return false;
+    fingerprint = getFingerprint(warning.getName(), *path, line, col, endLine, endCol, *text);
+    return true;
+  }
+
+  GraphWarningIndexer::FingerprintSet& GraphWarningIndexer::getFingerprints(NodeIndex& nodeIndex, const graph::Node& node) {
+    NodeIndex::iterator nodeIt = nodeIndex.find(node);
+    if(nodeIt != nodeIndex.end())
+      return nodeIt->second;
+
+    FingerprintSet& fingerprints = nodeIndex[node];
+    Attribute::AttributeIterator it = node.findAttributeByContext(graphconstants::CONTEXT_WARNING);
+    while(it.hasNext()) {
+      Attribute& attr = it.next();
+      if(attr.getType() != Attribute::atComposite)
+        continue;
+      size_t fingerprint;
+      if(getFingerprint(static_cast<AttributeComposite&>(attr), fingerprint))
+        fingerprints.insert(fingerprint);
+    }
+    return fingerprints;
+  }
+
+  bool GraphWarningIndexer::mayHaveWarning(graph::Graph& graph, const graph::Node& node, const string& name, const string& path, int line, int col, int endLine, int endCol, const string& text) {
+    NodeIndex* nodeIndex = findGraphNodeIndex(graph);
+    if(!nodeIndex)
+      return true;
+    FingerprintSet& fingerprints = getFingerprints(*nodeIndex, node);
+    return fingerprints.find(getFingerprint(name, path, line, col, endLine, endCol, text)) != fingerprints.end();
+  }
+
+  void GraphWarningIndexer::addWarning(graph::Graph& graph, const graph::Node& node, const string& name, const string& path, int line, int col, int endLine, int endCol, const string& text) {
+    NodeIndex* nodeIndex = findGraphNodeIndex(graph);
+    if(!nodeIndex)
+      return;
+    // the not yet indexed nodes collect their warnings at the first lookup
+    NodeIndex::iterator nodeIt = nodeIndex->find(node);
+    if(nodeIt != nodeIndex->end())
+      nodeIt->second.insert(getFingerprint(name, path, line, col, endLine, endCol, text));
+  }
+
+  GraphWarningIndexer* GraphWarningIndexer::indexerObj = NULL;
+
+}}
@@ -70,6 +70,7 @@ namespace columbus { namespace graphsupport {
       attrComposite.addAttribute(*extraInfo);
       
     node.addAttribute(attrComposite);
+    GraphWarningIndexer::getGraphWarningIndexerInstance().addWarning(graph, node, name, path, line, col, endLine, endCol, text);
   }
 
   void addWarning(Graph& graph,Node& node, const string& name, const string& path, int line, int col, int endLine, int endCol, const string& text) {
@@ -81,7 +82,7 @@ namespace columbus { namespace graphsupport {
     addWarning(graph, node, name, path, line, col, endLine, endCol, text);
   }
 
-  static bool addWarningOnce(Graph& graph,Node& node, const string& name, const string& path, int line, int col, int endLine, int endCol, const string& text, const AttributeComposite* extraInfo) {
+  static bool hasWarning(Node& node, const string& name, const string& path, int line, int col, int endLine, int endCol, const string& text) {
     Attribute::AttributeIterator it = node.findAttribute(Attribute::atComposite, name, graphconstants::CONTEXT_WARNING);
     while(it.hasNext()) {
       int sameValues = 0;
@@ -111,8 +112,16 @@ namespace columbus { namespace graphsupport {
         }
       }
       if(sameValues == 6)
-        return false;
+        return true;
     }
+    return false;
+  }
+
+  static bool addWarningOnce(Graph& graph,Node& node, const string& name, const string& path, int line, int col, int endLine, int endCol, const string& text, const AttributeComposite* extraInfo) {
+    // the attributes are compared only if the fingerprint of the warning is already known
+    if(GraphWarningIndexer::getGraphWarningIndexerInstance().mayHaveWarning(graph, node, name, path, line, col, endLine, endCol, text)
+      && hasWarning(node, name, path, line, col, endLine, endCol, text))
+      return false;
     addWarning(graph, node, name, path, line, col, endLine, endCol, text, extraInfo);
     return true;
   }
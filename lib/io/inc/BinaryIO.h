@@ -21,6 +21,8 @@
 #ifndef BINARYIOIO_H
 #define BINARYIOIO_H
 
+#include <cstring>
+#include <vector>
 #include <io/inc/ioBase.h>
 
 /**
@@ -79,6 +81,68 @@ namespace columbus {  namespace io {
       * \param toError [in] if it is true, stream is open to stderr, otherwise stdout
       */
       BinaryIO(bool toError);
+
+      /**
+      * \brief destructor, writes out the content of the write buffer
+      */
+      virtual ~BinaryIO();
+
+      /**
+      * \brief Turns on or off the user-space buffering of the read and write operations.
+      *        While it is turned on the primitive reads and writes are served from a memory buffer, and the
+      *        underlying stream is only used when the buffer has to be refilled or flushed.
+      *        It has no effect if the file is opened for reading and writing at the same time.
+      *        It has to be turned on after the last setZip() call of a ZippedIO.
+      * \param buffered [in] turn buffering on or off
+      * \param bufferSize [in] the size of the buffer in bytes
+      * \throw IOException if the content of the buffer cannot be written out.
+      */
+      void setBuffered(bool buffered, std::size_t bufferSize = 1024 * 1024);
+
+      /**
+      * \brief Returns true if the user-space buffering is turned on.
+      */
+      bool isBuffered() const;
+
+      /**
+      * \brief Opens a memory block (e.g. a memory mapped file) for reading. The data is not copied,
+      *        so it has to be valid until the object is closed.
+      * \param data [in] the first byte of the memory block
+      * \param size [in] the size of the memory block
+      */
+      void openMemory(const char* data, std::size_t size);
+
+      /**
+      * \brief Sets the read position in the memory block opened by openMemory().
+      * \param offset [in] the new position from the beginning of the memory block
+      * \throw IOException if the offset is outside of the memory block or there is no opened memory block.
+      */
+      void setMemoryReadPosition(std::size_t offset);
+
+      /**
+      * \brief Gives back the current logical read or write position (the buffered bytes are taken into account).
+      * \return the position
+      * \throw IOException if the the file is not opened.
+      */
+      std::streampos getPosition();
+
+      /**
+      * \brief flush the write buffer and the file
+      * \throw IOException if the the file is closed or not opened.
+      * \throw IOException if can't flush the file
+      */
+      virtual void flush();
+
+      /**
+      * \brief write out the write buffer and close the opened file
+      * \throw IOException if can't close the file
+      */
+      virtual void close();
+
+      /**
+      * \brief return true, if there is no more data to read
+      */
+      virtual bool eof();
       
       /**
       * \brief Writes a boolean on 1 byte to the file.
@@ -86,7 +150,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOException if the open mode isn't write
       */
-      virtual void writeBool1(bool b);
+      void writeBool1(bool b);
 
       /**
       * \brief Reads 1 byte into a bool from the file.
@@ -94,7 +158,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual bool readBool1();
+      bool readBool1();
 
       /**
       * \brief Writes an unsigned charater on 1 byte to the file.
@@ -102,7 +166,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeUByte1(unsigned char b);
+      void writeUByte1(unsigned char b);
 
       /**
       * \brief Reads 1 byte into an unsigned char from the file.
@@ -110,7 +174,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual unsigned char readUByte1();
+      unsigned char readUByte1();
 
       /**
       * \brief Writes an charater on 1 byte to the file.
@@ -118,7 +182,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeByte1(char b);
+      void writeByte1(char b);
 
       /**
       * \brief Reads 1 byte into a char from the file.
@@ -126,7 +190,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual char readByte1();
+      char readByte1();
       
       /**
       * \brief Writes an unsigned short on 2 byte to the file.
@@ -134,7 +198,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeUShort2(unsigned short i);
+      void writeUShort2(unsigned short i);
 
       /**
       * \brief Reads 2 byte into an unsigned short from the file.
@@ -142,7 +206,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual unsigned short readUShort2();
+      unsigned short readUShort2();
 
       /**
       * \brief Writes a short on 2 byte to the file.
@@ -150,7 +214,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeShort2(short i);
+      void writeShort2(short i);
 
       /**
       * \brief Reads 2 byte into a short from the file.
@@ -158,7 +222,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual short readShort2();
+      short readShort2();
 
       /**
       * \brief Writes an unsigned integer on 4 byte to the file.
@@ -166,7 +230,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeUInt4(unsigned i);
+      void writeUInt4(unsigned i);
 
       /**
       * \brief Reads 4 byte into an unsigned integer from the file.
@@ -174,7 +238,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual unsigned readUInt4();
+      unsigned readUInt4();
       
       /**
       * \brief Writes an integer on 4 byte to the file.
@@ -182,7 +246,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeInt4(int i);
+      void writeInt4(int i);
 
       /**
       * \brief Reads 4 byte into an integer from the file.
@@ -190,7 +254,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual int readInt4();
+      int readInt4();
 
       /**
       * \brief Writes a long long on 8 byte to the file.
@@ -198,7 +262,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeLongLong8(long long i);
+      void writeLongLong8(long long i);
 
       /**
       * \brief Reads 8 byte into a long long from the file.
@@ -206,7 +270,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual long long readLongLong8();
+      long long readLongLong8();
 
       /**
       * \brief Writes an unsigned long long on 8 byte to the file.
@@ -214,7 +278,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeULongLong8(unsigned long long i);
+      void writeULongLong8(unsigned long long i);
 
       /**
       * \brief Reads 8 byte into an unsigned long long from the file.
@@ -222,7 +286,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual unsigned long long readULongLong8();
+      unsigned long long readULongLong8();
 
       /**
       * \brief Writes a double on 8 byte to the file.
@@ -230,7 +294,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeDouble8(double d);
+      void writeDouble8(double d);
 
       /**
       * \brief Reads 8 byte into a double from the file.
@@ -238,7 +302,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual double readDouble8();
+      double readDouble8();
 
             /**
       * \brief Writes a long double on 16 byte to the file.
@@ -246,7 +310,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeLongDouble16(long double d);
+      void writeLongDouble16(long double d);
 
       /**
       * \brief Reads 16 byte into a long double from the file.
@@ -254,7 +318,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual long double readLongDouble16();
+      long double readLongDouble16();
 
      /**
       * \brief Writes short string to the file. String maximum length is 65k and it can contain '\0' character
@@ -262,7 +326,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeShortString(const std::string& s);
+      void writeShortString(const std::string& s);
 
       /**
       * \brief Reads short string (can't read string) form the file. String length stored befor the data.
@@ -270,7 +334,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual const std::string readShortString();
+      const std::string readShortString();
 
       /**
       * \brief Reads short string form the file. String length stored befor the data.
@@ -278,14 +342,14 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual void readShortString(std::string &s);
+      void readShortString(std::string &s);
 
       /**
       * \brief Writes string to the file. String doesn't have maximum length but it can't contain '\0' character.
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */      
-      virtual void writeString(const std::string& s);
+      void writeString(const std::string& s);
 
       /**
       * \brief Reads string (can't read short string) form the file. It reads until '\0' character is found.
@@ -293,7 +357,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual const std::string readString();
+      const std::string readString();
 
       /**
       * \brief Reads string (can't read short string) form the file. It reads until '\0' character is found.
@@ -301,7 +365,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual void readString(std::string& s);
+      void readString(std::string& s);
 
       /**
       * \brief Writes a float on 4 byte to the file.
@@ -309,7 +373,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeFloat4(float f);
+      void writeFloat4(float f);
 
       /**
       * \brief Reads 4 byte into a float from the file.
@@ -317,7 +381,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual float readFloat4();
+      float readFloat4();
 
       /**
       * \brief Writes a void* on 'size' byte to the file.
@@ -326,7 +390,7 @@ namespace columbus {  namespace io {
       * \throw IOException if the writing is failed.
       * \throw IOExceotion if the open mode isn't write
       */
-      virtual void writeData(const void* data, std::streamsize size);
+      void writeData(const void* data, std::streamsize size);
 
       /**
       * \brief Reads 'size' byte into a void* from the file.
@@ -335,7 +399,43 @@ namespace columbus {  namespace io {
       * \throw IOException if the reading is failed.
       * \throw IOExceotion if the open mode isn't read
       */
-      virtual void readData (void* data, std::streamsize size);
+      void readData(void* data, std::streamsize size);
+
+      /**
+      * \brief Writes 'count' unsigned integers on 4 byte each to the file.
+      * \param values [in] the output values
+      * \param count [in] the number of values
+      * \throw IOException if the writing is failed.
+      * \throw IOExceotion if the open mode isn't write
+      */
+      void writeUInt4Array(const unsigned* values, std::size_t count);
+
+      /**
+      * \brief Reads 'count' unsigned integers of 4 byte each from the file.
+      * \param values [out] the readed values
+      * \param count [in] the number of values
+      * \throw IOException if the reading is failed.
+      * \throw IOExceotion if the open mode isn't read
+      */
+      void readUInt4Array(unsigned* values, std::size_t count);
+
+      /**
+      * \brief Reads 'size' byte from the file without copying them (if the file is buffered).
+      * \param size [in] the read length
+      * \return pointer to the data, which is valid until the next read operation
+      * \throw IOException if the reading is failed.
+      * \throw IOExceotion if the open mode isn't read
+      */
+      const char* readDataView(std::size_t size);
+
+      /**
+      * \brief Reads string written by writeString() without copying it (if the file is buffered).
+      * \param length [out] the length of the string
+      * \return pointer to the '\0' terminated string, which is valid until the next read operation
+      * \throw IOException if the reading is failed.
+      * \throw IOExceotion if the open mode isn't read
+      */
+      const char* readStringView(std::size_t& length);
 
       virtual void setEndianState(EndianType endianState);
 
@@ -365,7 +465,34 @@ namespace columbus {  namespace io {
       virtual std::streampos tellg();
       virtual void get(std::streambuf& sb, char delim);
 
+      /**
+      * \brief reads at most 'size' byte, it does not fail at the end of the file
+      * \return the number of the readed bytes
+      */
+      virtual std::streamsize readSome(char* data, std::streamsize size);
+
+      void readOutOfBuffer(void* data, std::size_t size);
+      void writeOutOfBuffer(const void* data, std::size_t size);
+
+      // Makes at least 'size' byte available in the read buffer. Returns false at the end of the file.
+      bool fillReadBuffer(std::size_t size);
+
+      template <typename T>
+      static T swapBytes(T value);
+
+      template <typename T>
+      T readValue();
+
+      template <typename T>
+      void writeValue(T value);
+
   protected:
+      // Writes out the content of the write buffer.
+      void flushWriteBuffer();
+
+      // Writes out the content of the write buffer and moves the stream back to the first unread buffered byte.
+      void syncBuffer();
+
       // 2 byte
       virtual void endianSwap2(unsigned short& value);
 
@@ -399,8 +526,143 @@ namespace columbus {  namespace io {
         double d;
         long double ld;
       } alltype;
+
+      std::vector<char> buffer;       // The user-space buffer (empty if the file is not buffered)
+      char* readPos;                   // The next byte to read from the buffer
+      char* readEnd;                   // The end of the readable bytes in the buffer
+      char* writePos;                  // The next free byte in the buffer
+      char* writeEnd;                  // The end of the buffer if it is used for writing
+      std::string stringView;          // Storage of readStringView() in unbuffered mode
+      const char* memoryBegin;         // The beginning of the memory block opened by openMemory()
+      std::streamoff writeBufferPos;   // The file position of the write buffer (-1 if it is not known yet)
   };
 
+  template <typename T>
+  inline T BinaryIO::swapBytes(T value) {
+    unsigned char bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));
+    for (std::size_t i = 0; i < sizeof(T) / 2; ++i) {
+      unsigned char c = bytes[i];
+      bytes[i] = bytes[sizeof(T) - 1 - i];
+      bytes[sizeof(T) - 1 - i] = c;
+    }
+    memcpy(&value, bytes, sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  inline T BinaryIO::readValue() {
+    T value;
+    if ((std::size_t)(readEnd - readPos) >= sizeof(T)) {
+      memcpy(&value, readPos, sizeof(T));
+      readPos += sizeof(T);
+    } else
+      readOutOfBuffer(&value, sizeof(T));
+
+    if (endianState != localEndianState)
+      value = swapBytes(value);
+    return value;
+  }
+
+  template <typename T>
+  inline void BinaryIO::writeValue(T value) {
+    if (endianState != localEndianState)
+      value = swapBytes(value);
+
+    if ((std::size_t)(writeEnd - writePos) >= sizeof(T)) {
+      memcpy(writePos, &value, sizeof(T));
+      writePos += sizeof(T);
+    } else
+      writeOutOfBuffer(&value, sizeof(T));
+  }
+
+  inline void BinaryIO::writeBool1(bool b) {
+    writeValue<char>(b ? 1 : 0);
+  }
+
+  inline bool BinaryIO::readBool1() {
+    return readValue<char>() == 1;
+  }
+
+  inline void BinaryIO::writeUByte1(unsigned char b) {
+    writeValue(b);
+  }
+
+  inline unsigned char BinaryIO::readUByte1() {
+    return readValue<unsigned char>();
+  }
+
+  inline void BinaryIO::writeByte1(char b) {
+    writeValue(b);
+  }
+
+  inline char BinaryIO::readByte1() {
+    return readValue<char>();
+  }
+
+  inline void BinaryIO::writeUShort2(unsigned short i) {
+    writeValue(i);
+  }
+
+  inline unsigned short BinaryIO::readUShort2() {
+    return readValue<unsigned short>();
+  }
+
+  inline void BinaryIO::writeShort2(short i) {
+    writeValue(i);
+  }
+
+  inline short BinaryIO::readShort2() {
+    return readValue<short>();
+  }
+
+  inline void BinaryIO::writeUInt4(unsigned i) {
+    writeValue(i);
+  }
+
+  inline unsigned BinaryIO::readUInt4() {
+    return readValue<unsigned>();
+  }
+
+  inline void BinaryIO::writeInt4(int i) {
+    writeValue(i);
+  }
+
+  inline int BinaryIO::readInt4() {
+    return readValue<int>();
+  }
+
+  inline void BinaryIO::writeLongLong8(long long i) {
+    writeValue(i);
+  }
+
+  inline long long BinaryIO::readLongLong8() {
+    return readValue<long long>();
+  }
+
+  inline void BinaryIO::writeULongLong8(unsigned long long i) {
+    writeValue(i);
+  }
+
+  inline unsigned long long BinaryIO::readULongLong8() {
+    return readValue<unsigned long long>();
+  }
+
+  inline void BinaryIO::writeDouble8(double d) {
+    writeValue(d);
+  }
+
+  inline double BinaryIO::readDouble8() {
+    return readValue<double>();
+  }
+
+  inline void BinaryIO::writeFloat4(float f) {
+    writeValue(f);
+  }
+
+  inline float BinaryIO::readFloat4() {
+    return readValue<float>();
+  }
 
 }}
 
@@ -35,6 +35,7 @@ namespace columbus {  namespace io {
         ZippedIO();
         ZippedIO(const std::string& filename, IOBase::eOpenMode mode, bool zipped = true);
         ZippedIO(const char *filename, IOBase::eOpenMode mode, bool zipped = true);
+        virtual ~ZippedIO();
 
         virtual void setZip(bool zipmode);
 
@@ -45,6 +46,7 @@ namespace columbus {  namespace io {
         virtual void write(const char* data, const std::streampos size) override;
         virtual void read(char* data, const std::streampos size) override;
         virtual void get(std::streambuf& sb, char delim) override;
+        virtual std::streamsize readSome(char* data, std::streamsize size) override;
 
 
     public:
@@ -33,6 +33,7 @@
 #define CMSG_EX_FILE_READ_ONLY       "File is opened only for reading"
 #define CMSG_EX_FILE_WRITE_ONLY      "File is opened only for writing"
 #define CMSG_EX_FILE_ZIPPED          "The opened file is zipped"
+#define CMSG_EX_END_OF_FILE          "Unexpected end of file"
 
 // xml exceptions
 #define CMSG_EX_XML_DECLARATION_TOP  "XML declaration can be writen only to the top of the file"
@@ -108,7 +108,15 @@ namespace columbus {  namespace io {
     IOBase(OperationMode::binary),
     localEndianState(),
     endianState(),
-    blockSizePosition(0)
+    blockSizePosition(0),
+    buffer(),
+    readPos(nullptr),
+    readEnd(nullptr),
+    writePos(nullptr),
+    writeEnd(nullptr),
+    stringView(),
+    memoryBegin(nullptr),
+    writeBufferPos(-1)
   {
     testSizes();
     testLocalEndian();
@@ -118,7 +126,15 @@ namespace columbus {  namespace io {
     IOBase(OperationMode::binary),
     localEndianState(),
     endianState(),
-    blockSizePosition(0)
+    blockSizePosition(0),
+    buffer(),
+    readPos(nullptr),
+    readEnd(nullptr),
+    writePos(nullptr),
+    writeEnd(nullptr),
+    stringView(),
+    memoryBegin(nullptr),
+    writeBufferPos(-1)
   {
     testSizes();
     testLocalEndian();
@@ -129,7 +145,15 @@ namespace columbus {  namespace io {
     IOBase(OperationMode::binary),
     localEndianState(),
     endianState(),
-    blockSizePosition(0)
+    blockSizePosition(0),
+    buffer(),
+    readPos(nullptr),
+    readEnd(nullptr),
+    writePos(nullptr),
+    writeEnd(nullptr),
+    stringView(),
+    memoryBegin(nullptr),
+    writeBufferPos(-1)
   {
     testSizes();
     testLocalEndian();
@@ -140,350 +164,345 @@ namespace columbus {  namespace io {
     IOBase(OperationMode::binary),
     localEndianState(),
     endianState(),
-    blockSizePosition(0)
+    blockSizePosition(0),
+    buffer(),
+    readPos(nullptr),
+    readEnd(nullptr),
+    writePos(nullptr),
+    writeEnd(nullptr),
+    stringView(),
+    memoryBegin(nullptr),
+    writeBufferPos(-1)
   {
     testSizes();
     testLocalEndian();
     open(toError);
   }
 
-  void BinaryIO::writeBool1(bool b) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-
-    char c = b ? 1 : 0;
+  BinaryIO::~BinaryIO() {
     try {
-      write(&c, 1);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+      flushWriteBuffer();
+    } catch(const exception&) {
     }
   }
 
-  bool BinaryIO::readBool1() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    char b = 0;
-    try {
-      read(&b, 1);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+  void BinaryIO::setBuffered(bool buffered, size_t bufferSize) {
+    // A memory block is always read directly.
+    if (memoryBegin)
+      return;
+
+    syncBuffer();
+    buffer.clear();
+    readPos = readEnd = writePos = writeEnd = nullptr;
+
+    if (!buffered || mode == omReadWrite)
+      return;
+
+    buffer.resize(bufferSize < 16 ? 16 : bufferSize);
+    if (mode == omRead) {
+      readPos = readEnd = buffer.data();
+    } else {
+      writePos = buffer.data();
+      writeEnd = buffer.data() + buffer.size();
     }
-    return b == 1;
   }
 
-  void BinaryIO::writeUByte1(unsigned char b) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      write((const char*)&b, 1);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+  bool BinaryIO::isBuffered() const {
+    return !buffer.empty();
   }
 
-  unsigned char BinaryIO::readUByte1() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    char b;
-    try {
-      read(&b, 1);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
-    return b;
+  void BinaryIO::openMemory(const char* data, size_t size) {
+    close();
+    buffer.clear();
+    mode = omRead;
+    memoryBegin = data;
+    readPos = const_cast<char*>(data);
+    readEnd = readPos + size;
   }
 
-  void BinaryIO::writeByte1(char b) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      write(&b, 1);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+  void BinaryIO::setMemoryReadPosition(size_t offset) {
+    if (!memoryBegin)
+      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_NOT_OPEN);
+    if (offset > (size_t)(readEnd - memoryBegin))
+      throw IOException(COLUMBUS_LOCATION, CMSG_EX_END_OF_FILE);
+
+    readPos = const_cast<char*>(memoryBegin) + offset;
   }
 
-  char BinaryIO::readByte1() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    char b;
-    try {
-      read(&b, 1);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+  streampos BinaryIO::getPosition() {
+    if (memoryBegin)
+      return readPos - memoryBegin;
+
+    if(!stream) {
+      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_NOT_OPEN);
     }
-    return b;    
-  }
 
-  void BinaryIO::writeUShort2(unsigned short i) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      endianSwap2(i);
-      write((const char*)&i,2);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+    if (writePos) {
+      // The file position is cached, because asking it from the stream is too slow to do it after every write.
+      if (writeBufferPos < 0)
+        writeBufferPos = tellg();
+      return writeBufferPos + (writePos - buffer.data());
     }
+
+    streampos pos = tellg();
+    if (readPos)
+      pos -= readEnd - readPos;
+    return pos;
   }
 
-  unsigned short BinaryIO::readUShort2() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    unsigned short s;
+  void BinaryIO::flushWriteBuffer() {
+    if (writePos == nullptr || writePos == buffer.data())
+      return;
+
+    streamsize size = writePos - buffer.data();
+    writePos = buffer.data();
     try {
-      read((char*)&s,2);
-      endianSwap2(s);
+      write(buffer.data(), size);
     } catch(const exception& fail) {
       throw IOException(COLUMBUS_LOCATION, fail.what());
     }
-    return s;
+    if (writeBufferPos >= 0)
+      writeBufferPos += size;
   }
 
-  void BinaryIO::writeShort2(short i) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      endianSwap2(*(reinterpret_cast<unsigned short*>(&i)));
-      write((const char*)&i,2);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+  void BinaryIO::syncBuffer() {
+    flushWriteBuffer();
+    // The stream may be moved after the synchronization.
+    writeBufferPos = -1;
+
+    if (readPos != readEnd && !memoryBegin) {
+      // The stream is ahead of the logical read position by the unread buffered bytes.
+      streamoff unread = readEnd - readPos;
+      readPos = readEnd = buffer.data();
+      seekg(-unread, ios_base::cur);
     }
   }
 
-  short BinaryIO::readShort2() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    short s;
-    try {
-      read((char*)&s,2);
-      endianSwap2(*(reinterpret_cast<unsigned short*>(&s)));
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
-    return s;
+  void BinaryIO::flush() {
+    flushWriteBuffer();
+    IOBase::flush();
   }
 
-  void BinaryIO::writeUInt4(unsigned i) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      endianSwap4(i);
-      write( (char*)&i, 4);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+  void BinaryIO::close() {
+    flushWriteBuffer();
+    buffer.clear();
+    readPos = readEnd = writePos = writeEnd = nullptr;
+    memoryBegin = nullptr;
+    writeBufferPos = -1;
+    IOBase::close();
   }
 
-  unsigned BinaryIO::readUInt4() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    unsigned u;
-    try {
-      read((char*)&u,4);
-      endianSwap4(u);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
-    return u;
+  bool BinaryIO::eof() {
+    if (memoryBegin)
+      return readPos == readEnd;
+
+    if (!buffer.empty() && readPos != nullptr)
+      return readPos == readEnd && !fillReadBuffer(1);
+
+    return IOBase::eof();
   }
 
-  void BinaryIO::writeInt4(int i) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      endianSwap4(*(reinterpret_cast<unsigned int*>(&i)));
-      write( (char*)&i, 4);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+  bool BinaryIO::fillReadBuffer(size_t size) {
+    size_t available = readEnd - readPos;
+    if (available >= size)
+      return true;
+
+    // A memory block cannot be refilled.
+    if (memoryBegin)
+      return false;
+
+    // Move the unread bytes to the front of the buffer and grow the buffer if it is too small.
+    if (available)
+      memmove(buffer.data(), readPos, available);
+    if (buffer.size() < size)
+      buffer.resize(size);
+    readPos = buffer.data();
+    readEnd = readPos + available;
+
+    while (available < size) {
+      streamsize count;
+      try {
+        count = readSome(readEnd, buffer.size() - available);
+      } catch(const exception& fail) {
+        throw IOException(COLUMBUS_LOCATION, fail.what());
+      }
+      if (count <= 0)
+        return false;
+
+      available += (size_t)count;
+      readEnd += count;
     }
+    return true;
   }
 
-  int BinaryIO::readInt4() {
+  void BinaryIO::readOutOfBuffer(void* data, size_t size) {
     if( !((mode == omRead) || (mode == omReadWrite)) ) 
       throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    int i;
-    try {
-      read((char*)&i,4);
-      endianSwap4(*(reinterpret_cast<unsigned int*>(&i)));
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+
+    if (readPos == nullptr) {
+      try {
+        read((char*)data, size);
+      } catch(const exception& fail) {
+        throw IOException(COLUMBUS_LOCATION, fail.what());
+      }
+      return;
     }
-    return i;
+
+    if (memoryBegin)
+      throw IOException(COLUMBUS_LOCATION, CMSG_EX_END_OF_FILE);
+
+    if (size > buffer.size()) {
+      // Large blocks are read directly into the destination.
+      size_t available = readEnd - readPos;
+      memcpy(data, readPos, available);
+      readPos = readEnd = buffer.data();
+      try {
+        read((char*)data + available, size - available);
+      } catch(const exception& fail) {
+        throw IOException(COLUMBUS_LOCATION, fail.what());
+      }
+      return;
+    }
+
+    if (!fillReadBuffer(size))
+      throw IOException(COLUMBUS_LOCATION, CMSG_EX_END_OF_FILE);
+
+    memcpy(data, readPos, size);
+    readPos += size;
   }
 
-  void BinaryIO::writeLongLong8(long long i) {
+  void BinaryIO::writeOutOfBuffer(const void* data, size_t size) {
     if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
       throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      endianSwap8(*(reinterpret_cast<unsigned long long*>(&i)));
-      write( (char*)&i, 8);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+
+    if (writePos == nullptr) {
+      try {
+        write((const char*)data, size);
+      } catch(const exception& fail) {
+        throw IOException(COLUMBUS_LOCATION, fail.what());
+      }
+      return;
+    }
+
+    flushWriteBuffer();
+    if (size >= buffer.size()) {
+      try {
+        write((const char*)data, size);
+      } catch(const exception& fail) {
+        throw IOException(COLUMBUS_LOCATION, fail.what());
+      }
+      if (writeBufferPos >= 0)
+        writeBufferPos += size;
+    } else {
+      memcpy(writePos, data, size);
+      writePos += size;
     }
   }
 
-  long long BinaryIO::readLongLong8() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    long long ll;
-    try {
-      read((char*)&ll,8);
-      endianSwap8(*(reinterpret_cast<unsigned long long*>(&ll)));
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+  void BinaryIO::writeUInt4Array(const unsigned* values, size_t count) {
+    if (endianState == localEndianState) {
+      writeData(values, (streamsize)count * 4);
+      return;
     }
-    return ll;
+
+    for (size_t i = 0; i < count; ++i)
+      writeValue(values[i]);
   }
 
-  void BinaryIO::writeULongLong8(unsigned long long i) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      endianSwap8(i);
-      write( (char*)&i, 8);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+  void BinaryIO::readUInt4Array(unsigned* values, size_t count) {
+    readData(values, (streamsize)count * 4);
+
+    if (endianState != localEndianState)
+      for (size_t i = 0; i < count; ++i)
+        values[i] = swapBytes(values[i]);
   }
 
-  unsigned long long BinaryIO::readULongLong8() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    unsigned long long ll;
-    try {
-      read((char*)&ll,8);
-      endianSwap8(ll);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+  const char* BinaryIO::readDataView(size_t size) {
+    if (readPos != nullptr && (size <= buffer.size() || memoryBegin)) {
+      if ((size_t)(readEnd - readPos) < size && !fillReadBuffer(size))
+        throw IOException(COLUMBUS_LOCATION, CMSG_EX_END_OF_FILE);
+
+      const char* data = readPos;
+      readPos += size;
+      return data;
     }
-    return ll;
+
+    stringView.resize(size);
+    if (size)
+      readData(&stringView[0], size);
+    return stringView.c_str();
   }
 
-  void BinaryIO::writeDouble8(double d) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      alltype x;
-      x.d = d;
-      endianSwap8(x.ull);
-      write( (char*)&x.ull, 8);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+  const char* BinaryIO::readStringView(size_t& length) {
+    if (readPos == nullptr) {
+      readString(stringView);
+      length = stringView.size();
+      return stringView.c_str();
     }
-  }
 
-  double BinaryIO::readDouble8() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    alltype x;
-    try {
-      read((char*)&x.ull,8);
-      endianSwap8(x.ull);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
+    size_t searched = 0;
+    while (true) {
+      const char* end = (const char*)memchr(readPos + searched, '\0', (readEnd - readPos) - searched);
+      if (end != nullptr) {
+        const char* data = readPos;
+        length = end - readPos;
+        readPos += length + 1;
+        return data;
+      }
+
+      searched = readEnd - readPos;
+      if (!fillReadBuffer(searched + 1) && (size_t)(readEnd - readPos) == searched)
+        throw IOException(COLUMBUS_LOCATION, CMSG_EX_END_OF_FILE);
     }
-    return x.d;
   }
 
   void  BinaryIO::writeLongDouble16(long double d){
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      alltype x;
-      x.d = d;
-      endianSwap16(x.ld);
-      write( (char*)&x.ull, 16);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+    alltype x;
+    x.d = d;
+    endianSwap16(x.ld);
+    writeData((char*)&x.ull, 16);
   }
 
   long double  BinaryIO::readLongDouble16(){
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
     alltype x;
-    try {
-      read((char*)&x.ld,16);
-      endianSwap16(x.ld);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+    readData((char*)&x.ld, 16);
+    endianSwap16(x.ld);
     return x.d;
   }
 
   void BinaryIO::writeShortString(const string& s) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      size_t size =  s.size();
-      
-      if (size > 0xFFFF)
-        throw IOException(COLUMBUS_LOCATION, CMSG_EX_TOO_LONG_STRING);
-      unsigned short writeSize = (unsigned short)size;
+    size_t size =  s.size();
 
-      writeShort2((short)size);
-      write(s.c_str(), writeSize);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+    if (size > 0xFFFF)
+      throw IOException(COLUMBUS_LOCATION, CMSG_EX_TOO_LONG_STRING);
+    unsigned short writeSize = (unsigned short)size;
 
+    writeShort2((short)size);
+    writeData(s.c_str(), writeSize);
   }
 
   const string BinaryIO::readShortString() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    try {
-      char* buffer;
-      unsigned short size = readShort2();
-
-      buffer = (char*)malloc(size);
-      if (!buffer)
-        throw IOException(COLUMBUS_LOCATION, CMSG_EX_MEMORY_ALLOCATION);
-        
-      read(buffer, size);
-      
-      string str;
-      str.assign(buffer, size);
-      free(buffer);
-      return str;
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+    unsigned short size = readShort2();
+    return string(readDataView(size), size);
   }
 
   void BinaryIO::readShortString(string& s) {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    try {
-      char* buffer;
-      unsigned short size = readShort2();
-
-      buffer = (char*)malloc(size);
-      if (!buffer)
-        throw IOException(COLUMBUS_LOCATION, CMSG_EX_MEMORY_ALLOCATION);
-        
-      read(buffer, size);
-      s.assign(buffer, size);
-      free(buffer);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+    unsigned short size = readShort2();
+    s.assign(readDataView(size), size);
   }
 
   void BinaryIO::writeString(const string& s) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    size_t len = s.size();
-    try {
-      write(s.c_str(),(streamsize)len+1);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+    writeData(s.c_str(), (streamsize)s.size() + 1);
   }
 
-
-
   void BinaryIO::readString(string& s) {
+    if (readPos != nullptr) {
+      size_t length;
+      const char* data = readStringView(length);
+      s.assign(data, length);
+      return;
+    }
+
     if( !((mode == omRead) || (mode == omReadWrite)) ) 
       throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
     try {
@@ -498,66 +517,26 @@ namespace columbus {  namespace io {
     }
   }
 
-
   const string BinaryIO::readString() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    try {
-      stringbuf ss;
-      get(ss,'\0');
-      // read string end 0
-      char zero;
-      read(&zero, 1);
-      return ss.str();
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+    string s;
+    readString(s);
+    return s;
   }
 
   void BinaryIO::writeData(const void* data, streamsize size) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      write((char*)data, size);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
+    if ((streamsize)(writeEnd - writePos) >= size) {
+      memcpy(writePos, data, (size_t)size);
+      writePos += size;
+    } else
+      writeOutOfBuffer(data, (size_t)size);
   }
 
   void BinaryIO::readData(void* data, streamsize size) {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    try {
-      read((char*)data,size);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
-  }
-
-  void BinaryIO::writeFloat4(float f) {
-    if( !((mode == omWrite) || (mode == omReadWrite) || (mode == omAppend)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_READ_ONLY);
-    try {
-      alltype x;
-      x.f = f;
-      endianSwap4(x.u);
-      write( (char*)&x.u, 4);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
-  }
-
-  float BinaryIO::readFloat4() {
-    if( !((mode == omRead) || (mode == omReadWrite)) ) 
-      throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_WRITE_ONLY);
-    alltype x;
-    try {
-      read((char*)&x.u,4);
-      endianSwap4(x.u);
-    } catch(const exception& fail) {
-      throw IOException(COLUMBUS_LOCATION, fail.what());
-    }
-    return x.f;
+    if ((streamsize)(readEnd - readPos) >= size) {
+      memcpy(data, readPos, (size_t)size);
+      readPos += size;
+    } else
+      readOutOfBuffer(data, (size_t)size);
   }
 
   void BinaryIO::setEndianState(EndianType endianState) {
@@ -569,20 +548,30 @@ namespace columbus {  namespace io {
   }
 
   void BinaryIO::writeStartSizeOfBlock() {
+    syncBuffer();
     blockSizePosition = tellg();
     writeLongLong8(0);
 
   }
 
   void BinaryIO::skipNext(streamsize length) {
+    if ((streamsize)(readEnd - readPos) >= length) {
+      readPos += length;
+      return;
+    }
+    if (memoryBegin)
+      throw IOException(COLUMBUS_LOCATION, CMSG_EX_END_OF_FILE);
+    syncBuffer();
     seekg(length,ios_base::cur);
   }
 
   void BinaryIO::writeEndSizeOfBlock() {
+    syncBuffer();
     streampos filepos = tellg();
     seekg(blockSizePosition);
     long long i = filepos - blockSizePosition;
     writeLongLong8(i);
+    flushWriteBuffer();
     seekg(0,ios::end);
   }
 
@@ -591,6 +580,7 @@ namespace columbus {  namespace io {
       throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_NOT_OPEN);
     }
 
+    syncBuffer();
     streampos seekSize = 1024 * 1024 * 1024;
     streampos curPos = ios_base::beg;
     seekg(0,ios_base::beg);
@@ -607,6 +597,7 @@ namespace columbus {  namespace io {
       throw IOException(COLUMBUS_LOCATION, CMSG_EX_FILE_NOT_OPEN);
     }
 
+    syncBuffer();
     streampos seekSize = 1024 * 1024 * 1024;
     streampos curPos = ios_base::beg;
     seekp(0,ios_base::beg);
@@ -648,6 +639,12 @@ namespace columbus {  namespace io {
     return stream->tellg();
   }
 
+  streamsize BinaryIO::readSome(char* data, streamsize size) {
+    // There is deliberately no nullptr pointer check as it is used only internally
+    // from the read methods, which already checks it.
+    return stream->rdbuf()->sgetn(data, size);
+  }
+
   void BinaryIO::get(streambuf& sb, char delim) {
     // There is deliberately no nullptr pointer check as it is used only internally
     // from the read methods, which already checks it.
@@ -43,6 +43,14 @@ namespace columbus {  namespace io {
         open(filename, mode, zipped);
     }
 
+    ZippedIO::~ZippedIO() {
+        // The buffered data has to go through the filters, so it is written out while they still exist.
+        try {
+            flushWriteBuffer();
+        } catch(const exception&) {
+        }
+    }
+
     void ZippedIO::open(const string& filename, eOpenMode mode, bool zipped) {
         if (!(mode == omRead || mode == omWrite || mode == omAppend))
             throw IOException(COLUMBUS_LOCATION, CMSG_EX_OPEN_ZIPPED_MODE);
@@ -78,6 +86,7 @@ namespace columbus {  namespace io {
             return;
 
         try {
+            flushWriteBuffer();
             filterstream->strict_sync();
             delete filterstream.release();
             BinaryIO::close();
@@ -91,6 +100,7 @@ namespace columbus {  namespace io {
             return;
 
         if (zip != zipmode) {
+            syncBuffer();
             filterstream->sync();
 
             filterstream->pop();
@@ -140,19 +150,40 @@ namespace columbus {  namespace io {
     void ZippedIO::write(const char* data, const streampos size) {
         // There is deliberately no nullptr pointer check as it is used only internally
         // from the write methods, which already checks it.
-        filterstream->write(data, size);
+        // The filter chain has no buffer of its own, so without compression the file can be used directly.
+        if (!zip)
+            stream->write(data, size);
+        else
+            filterstream->write(data, size);
     }
 
     void ZippedIO::read(char* data, const streampos size) {
         // There is deliberately no nullptr pointer check as it is used only internally
         // from the read methods, which already checks it.
-        filterstream->read(data, size);
+        // The filter chain has no buffer of its own, so without compression the file can be used directly.
+        if (!zip)
+            stream->read(data, size);
+        else
+            filterstream->read(data, size);
     }
 
     void ZippedIO::get(streambuf& sb, char delim) {
         // There is deliberately no nullptr pointer check as it is used only internally
         // from the read methods, which already checks it.
-        filterstream->get(sb, delim);
+        // The filter chain has no buffer of its own, so without compression the file can be used directly.
+        if (!zip)
+            stream->get(sb, delim);
+        else
+            filterstream->get(sb, delim);
+    }
+
+    streamsize ZippedIO::readSome(char* data, streamsize size) {
+        // There is deliberately no nullptr pointer check as it is used only internally
+        // from the read methods, which already checks it.
+        // The filter chain has no buffer of its own, so without compression the file can be used directly.
+        if (!zip)
+            return stream->rdbuf()->sgetn(data, size);
+        return filterstream->rdbuf()->sgetn(data, size);
     }
 
     void ZippedIO::writeStartSizeOfBlock() {
@@ -91,6 +91,7 @@ void Factory::save(const std::string &filename , CsiHeader &header) const {
 
   header.write(zipIo);
 
+  zipIo.setBuffered(true);
   // saving the ASG
   AlgorithmPreorder algPre;
   VisitorSave vSave(zipIo);
@@ -147,6 +148,7 @@ void Factory::load(const std::string &filename, CsiHeader &header) {
   header.read(zipIo);
   checkHeader(header);
 
+  zipIo.setBuffered(true);
   // loading the ASG
   NodeId id = zipIo.readUInt4();
   NodeKind kind = (NodeKind)zipIo.readUShort2();
@@ -23,6 +23,10 @@
 
 #include "lim/inc/lim.h"
 
+namespace boost { namespace iostreams {
+  class mapped_file_source;
+}}
+
 /**
 * \file Factory.h
 * \brief Contains declaration of Factory class.
@@ -76,6 +80,8 @@ namespace columbus { namespace lim { namespace asg {
 
       /**
       * \brief Saves the graph.
+      *        An uncompressed graph ends with the node index used by loadLazy(), it takes 20 bytes per node
+      *        (the id, kind, parent, parent edge kind and file position of every node) after the string table.
       * \param filename [in] The graph is saved into this file.
       * \param header   [in] The header information (also will be saved).
       */
@@ -118,6 +124,25 @@ namespace columbus { namespace lim { namespace asg {
 
       void load( const std::string &filename , std::list<HeaderData*> &headerDataList, std::streampos& startPosition);
 
+      /**
+      * \brief Loads the graph lazily. The file is memory mapped and only the header and the string table are loaded,
+      *        the nodes are created when they are first accessed (e.g. by getRef() or getPointer()).
+      *        If the file is compressed or it has no node index, the whole graph is loaded.
+      *        A lazily loaded factory is not safe for concurrent readers: the const getRef(), getPointer() and
+      *        getExist() create the nodes and modify the mutable containers, so materializeAll() must be called
+      *        before the factory is shared by threads.
+      * \param filename [in] The graph is loaded from this file.
+      * \param header   [in] The header information (also will be loaded).
+      * \return Returns true if the graph is loaded lazily.
+      */
+      bool loadLazy(const std::string &filename , std::list<HeaderData*> &headerDataList);
+
+      /**
+      * \brief Creates every node of a lazily loaded graph and releases the memory mapped file.
+      *        After it the const methods do not modify the factory, so it can be read by more threads.
+      */
+      void materializeAll() const;
+
       void clear();
 
       /**
@@ -268,7 +293,7 @@ namespace columbus { namespace lim { namespace asg {
       * \brief Get the iterator for the nodes
       * \return An iterator to the nodes.
       */
-      const const_iterator begin() const{return const_iterator(container.begin(),this);}
+      const const_iterator begin() const{materializeAll(); return const_iterator(container.begin(),this);}
 
       /**
       * \brief Get the iterator for the nodes.
@@ -297,7 +322,7 @@ namespace columbus { namespace lim { namespace asg {
       /**
       * \brief get the node individualiy state.
       */
-      bool isIndividual(NodeId id) const {return container[id] && (container[id]->getParent()==0);}
+      bool isIndividual(NodeId id) const {if (id < lazyNodes.size() && lazyNodes[id].offset) return lazyNodes[id].parent == 0; return container[id] && (container[id]->getParent()==0);}
 
 
       // ******************** Filter ********************
@@ -591,6 +616,20 @@ namespace columbus { namespace lim { namespace asg {
       */
       void alertNodeDestroy(const base::Base* node);
 
+      /**
+      * \internal
+      * \brief Creates and loads the node of a lazily loaded graph if it is not created yet.
+      * \param id [in] The id of the node.
+      * \return Pointer to the node or NULL if there is no node with the given id.
+      */
+      base::Base* materialize(NodeId id) const;
+
+      /**
+      * \internal
+      * \brief Releases the memory mapped file of a lazily loaded graph.
+      */
+      void releaseLazyFile() const;
+
     private:
 
       /**
@@ -608,7 +647,22 @@ namespace columbus { namespace lim { namespace asg {
       std::vector<std::pair<unsigned short, std::vector< unsigned char > > > unknownHeaderData;
 
       /** \internal \brief Container where the pointers to nodes are stored. */
-      Container container;
+      mutable Container container;
+
+      /** \internal \brief Location of a node in the memory mapped file which is not created yet. */
+      typedef struct LazyNode {
+        LazyNode() : offset(0), parent(0), parentEdgeKind(), kind() {}
+        unsigned long long offset;
+        NodeId parent;
+        EdgeKind parentEdgeKind;
+        NodeKind kind;
+      } LazyNode;
+
+      /** \internal \brief The memory mapped file of a lazily loaded graph (NULL if every node is created). */
+      mutable boost::iostreams::mapped_file_source* lazyFile;
+
+      /** \internal \brief The not yet created nodes of a lazily loaded graph indexed by their id (offset is 0 for the created nodes). */
+      mutable std::vector<LazyNode> lazyNodes;
 
       /** \internal \brief Reference to the StringTable. */
       RefDistributorStrTable* strTable;
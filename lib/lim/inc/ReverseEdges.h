@@ -51,6 +51,9 @@ namespace columbus { namespace lim { namespace asg {
       /** \internal \brief Type which stores for all nodes their reversed edges. */
       typedef std::vector<NodeEdgesType*> RevEdgesContainer;
 
+      /** \internal \brief The iterated list of the possible but missing reverse edges, so the const queries do not insert into the container. */
+      static const NodeListType emptyNodeList;
+
       /**
       * \internal
       * \brief Constructor.
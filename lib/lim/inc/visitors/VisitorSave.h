@@ -36,9 +36,10 @@ namespace columbus { namespace lim { namespace asg {
     protected:
       /**
       * \brief Constructor for Visitor.
-      * \param io [in] The graph is save into this IO.
+      * \param io      [in] The graph is save into this IO.
+      * \param offsets [in] If it is not NULL, the file position of each saved node is stored into it (indexed by the node id).
       */
-      VisitorSave(io::BinaryIO &io);
+      VisitorSave(io::BinaryIO &io, std::vector<unsigned long long>* offsets = NULL);
 
     public:
       /**
@@ -51,6 +52,9 @@ namespace columbus { namespace lim { namespace asg {
       /** \internal \brief Pointer to the "output". */
       io::BinaryIO &m_io;
 
+      /** \internal \brief The file positions of the saved nodes (can be NULL). */
+      std::vector<unsigned long long>* m_offsets;
+
       friend class Factory;
   }; // VisitorSave
 
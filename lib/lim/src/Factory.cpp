@@ -30,14 +30,23 @@
 
 #include "io/inc/ZippedIO.h"
 
+#include <boost/iostreams/device/mapped_file.hpp>
+
 #include "lim/inc/messages.h"
 
 #include "common/inc/FileSup.h"
 #include "common/inc/PlatformDependentDefines.h"
 
 namespace columbus { namespace lim { namespace asg {
+
+// The last bytes of a saved graph which has node index (see Factory::loadLazy).
+static const char nodeIndexMagic[] = "csiindex";
+static const size_t nodeIndexFooterSize = 2 * 8 + 8;
+
 Factory::Factory(RefDistributorStrTable& st, const std::string &rootPackageName, Language lang) :
   container(),
+  lazyFile(NULL),
+  lazyNodes(),
   strTable(&st),
   filter(NULL),
   filterOn(true),
@@ -94,9 +103,11 @@ Factory::~Factory() {
     if (*it)
       delete *it;
 
+  releaseLazyFile();
 }
 
 void Factory::swapStringTable(RefDistributorStrTable& newStrTable){
+  materializeAll();
   if (container.size() > 0 ) {
     std::map<Key,Key> oldAndNewStrKeyMap;
     for (Container::iterator it = container.begin() ;it!= container.end();++it) {
@@ -120,6 +131,7 @@ void Factory::save(const std::string &filename, std::list<HeaderData*> &headerDa
 }
 
 void Factory::save(io::ZippedIO& zipIo, std::list<HeaderData*> &headerDataList, bool zip) const {
+  materializeAll();
   TurnFilterOffSafely t(*this);
   zipIo.setEndianState(io::BinaryIO::etLittle);
   // storage the headerData Full size 
@@ -186,15 +198,44 @@ void Factory::save(io::ZippedIO& zipIo, std::list<HeaderData*> &headerDataList,
 
   if (zip)
     zipIo.setZip(true);
-  // saving the ASG
+  zipIo.setBuffered(true);
+  // saving the ASG (the positions of the nodes are collected only if they can be accessed directly)
+  std::vector<unsigned long long> nodeOffsets;
+  if (!zip)
+    nodeOffsets.resize(container.size(), 0);
   AlgorithmPreorder algPre;
   algPre.setSafeMode();
-  VisitorSave vSave(zipIo);
+  VisitorSave vSave(zipIo, zip ? NULL : &nodeOffsets);
   algPre.run(*this, vSave);
   // Writing the ENDMARK!
   zipIo.writeUInt4(0); // NodeId
   zipIo.writeUShort2(0); // NodeKind
+  unsigned long long strTableOffset = zip ? 0 : (unsigned long long)zipIo.getPosition();
   strTable->save(zipIo);
+
+  if (!zip) {
+    // saving the node index used by loadLazy()
+    unsigned long long nodeIndexOffset = zipIo.getPosition();
+    unsigned nodeCount = 0;
+    for (std::vector<unsigned long long>::const_iterator it = nodeOffsets.begin(); it != nodeOffsets.end(); ++it)
+      if (*it)
+        ++nodeCount;
+
+    zipIo.writeUInt4(nodeCount);
+    for (NodeId id = 0; id < nodeOffsets.size(); ++id) {
+      if (!nodeOffsets[id])
+        continue;
+      const base::Base* node = container[id];
+      zipIo.writeUInt4(id);
+      zipIo.writeUShort2(node->getNodeKind());
+      zipIo.writeUInt4(node->parent);
+      zipIo.writeUShort2(node->parentEdgeKind);
+      zipIo.writeULongLong8(nodeOffsets[id]);
+    }
+    zipIo.writeULongLong8(strTableOffset);
+    zipIo.writeULongLong8(nodeIndexOffset);
+    zipIo.writeData(nodeIndexMagic, 8);
+  }
   zipIo.close();
 }
 
@@ -288,6 +329,7 @@ void Factory::load( io::ZippedIO &zipIo, const std::list<HeaderData*> &headerDat
   loadHeader(zipIo, headerDataList);
   if (zip)
     zipIo.setZip(true);
+  zipIo.setBuffered(true);
   // loading the ASG
   NodeId id = zipIo.readUInt4();
   NodeKind kind = (NodeKind)zipIo.readUShort2();
@@ -318,8 +360,116 @@ void Factory::load( const std::string &filename , std::list<HeaderData*> &header
   load( zipIo, headerDataList);
 }
 
+bool Factory::loadLazy(const std::string &filename, std::list<HeaderData*> &headerDataList) {
+  boost::iostreams::mapped_file_source* file = new boost::iostreams::mapped_file_source();
+  try {
+    file->open(filename);
+  } catch (const std::exception&) {
+    delete file;
+    load(filename, headerDataList);
+    return false;
+  }
+
+  // checking the node index (only the uncompressed files have it)
+  const char* data = file->data();
+  size_t size = file->size();
+  unsigned long long strTableOffset = 0;
+  unsigned long long nodeIndexOffset = 0;
+  io::BinaryIO binIo;
+  binIo.openMemory(data, size);
+  if (size >= 4 + nodeIndexFooterSize && memcmp(data, "csi", 4) == 0 && memcmp(data + size - 8, nodeIndexMagic, 8) == 0) {
+    binIo.setMemoryReadPosition(size - nodeIndexFooterSize);
+    strTableOffset = binIo.readULongLong8();
+    nodeIndexOffset = binIo.readULongLong8();
+  }
+  if (strTableOffset <= 4 || nodeIndexOffset <= strTableOffset || nodeIndexOffset > size - nodeIndexFooterSize) {
+    binIo.close();
+    delete file;
+    load(filename, headerDataList);
+    return false;
+  }
+
+  clear();
+  lazyFile = file;
+  binIo.setMemoryReadPosition(4);
+  loadHeader(binIo, headerDataList);
+
+  // loading the node index
+  binIo.setMemoryReadPosition(nodeIndexOffset);
+  unsigned nodeCount = binIo.readUInt4();
+  for (unsigned i = 0; i < nodeCount; ++i) {
+    NodeId id = binIo.readUInt4();
+    if (lazyNodes.size() <= id)
+      lazyNodes.resize(id + 1);
+    LazyNode& lazyNode = lazyNodes[id];
+    lazyNode.kind = (NodeKind)binIo.readUShort2();
+    lazyNode.parent = binIo.readUInt4();
+    lazyNode.parentEdgeKind = (EdgeKind)binIo.readUShort2();
+    lazyNode.offset = binIo.readULongLong8();
+  }
+  container.resize(lazyNodes.size(), NULL);
+  filter->container.resize(lazyNodes.size(), Filter::NotFiltered);
+
+  // loading the string table (its strings are read directly from the mapped file)
+  binIo.setMemoryReadPosition(strTableOffset);
+  strTable->loadWithKeepingTheRefMap(binIo);
+  binIo.close();
+
+  root = dynamic_cast<logical::Package*>(materialize(100));
+  // fill the deletedNodeIdList with the free ids
+  for (size_t id = 100; id < container.size(); ++id)
+    if (!getExist(id))
+      deletedNodeIdList.push_back(id);
+
+  return true;
+}
+
+base::Base* Factory::materialize(NodeId id) const {
+  if (id >= lazyNodes.size() || !lazyNodes[id].offset)
+    return id < container.size() ? container[id] : NULL;
+
+  // The node is marked as created first, so the references to it from its own subtree do not load it again.
+  LazyNode lazyNode = lazyNodes[id];
+  lazyNodes[id].offset = 0;
+
+  io::BinaryIO binIo;
+  binIo.openMemory(lazyFile->data(), lazyFile->size());
+  binIo.setMemoryReadPosition(lazyNode.offset);
+  if (binIo.readUInt4() != id || (NodeKind)binIo.readUShort2() != lazyNode.kind)
+    throw LimException(COLUMBUS_LOCATION, CMSG_EX_INVALID_NODE_ID(id));
+
+  // The filter state is kept, it may have been set before the node is created.
+  Filter::FilterState filterState = filter->getFilterState(id);
+  base::Base& node = const_cast<Factory*>(this)->createNode(lazyNode.kind, id);
+  filter->container[id] = filterState;
+  node.load(binIo);
+  if (node.parent == 0) {
+    node.parent = lazyNode.parent;
+    node.parentEdgeKind = lazyNode.parentEdgeKind;
+  }
+  return &node;
+}
+
+void Factory::materializeAll() const {
+  if (!lazyFile)
+    return;
+
+  for (NodeId id = 0; id < lazyNodes.size(); ++id)
+    materialize(id);
+  releaseLazyFile();
+}
+
+void Factory::releaseLazyFile() const {
+  if (lazyFile) {
+    delete lazyFile;
+    lazyFile = NULL;
+  }
+  lazyNodes.clear();
+}
+
 void Factory::clear() {
   disableReverseEdges();
+  releaseLazyFile();
   for (Container::iterator i = container.begin(); i != container.end(); ++i) {
     if (*i) {
       alertNodeDestroy (*i);
@@ -355,6 +505,8 @@ logical::Package* Factory::getRoot() const {
 }
 
 bool Factory::getExist(NodeId id) const {
+  if (id < lazyNodes.size() && lazyNodes[id].offset)
+    return true;
   if (container.size() <= id)
     return false;
   return container[id] != NULL;
@@ -363,20 +515,16 @@ bool Factory::getExist(NodeId id) const {
 base::Base& Factory::getRef(NodeId id) const {
   base::Base* p = NULL;
   if (id < container.size())
-    p = container[id];
+    p = materialize(id);
   if (!p)
     throw LimException(COLUMBUS_LOCATION, CMSG_EX_INVALID_NODE_ID(id));
   return *p;
 }
 
 base::Base* Factory::getPointer(NodeId id) const {
-  base::Base* p = NULL;
-  try {
-    p = container.at(id);
-  } catch (std::out_of_range e) {
+  if (id >= container.size())
     throw LimException(COLUMBUS_LOCATION, CMSG_EX_INVALID_NODE_ID(id));
-  }
-  return p;
+  return materialize(id);
 }
 
 RefDistributorStrTable& Factory::getStringTable() const {
@@ -418,7 +566,7 @@ void Factory::destroyThisNodeOnly(NodeId id) {
   if (id >= container.size())
     throw LimException(COLUMBUS_LOCATION, CMSG_EX_THE_NODE_DOES_NOT_EXISTS);
 
-  if (!container[id])
+  if (!materialize(id))
     return;
 
   container[id]->prepareDelete(true);
@@ -432,6 +580,8 @@ void Factory::destroyThisNodeOnly(NodeId id) {
 }
 
 NodeKind Factory::getNodeKind(NodeId id) const {
+  if (id < lazyNodes.size() && lazyNodes[id].offset)
+    return lazyNodes[id].kind;
   return getRef(id).getNodeKind();
 }
 
@@ -458,10 +608,16 @@ const base::Base& Factory::ConstIterator::next() {
 }
 
 const Factory::ConstIterator Factory::constIterator() const {
+  materializeAll();
   return ConstIterator(&container,this);
 }
 
 bool Factory::isEmpty() const {
+  for (std::vector<LazyNode>::const_iterator it = lazyNodes.begin(); it != lazyNodes.end(); ++it) {
+    if (it->offset) {
+      return false;
+    }
+  }
   for (Container::const_iterator it = container.begin(); it != container.end(); ++it) {
     if (*it) {
       return false;
@@ -874,7 +1030,7 @@ physical::File& Factory::createFile(const std::string& path, NodeId nodeId) {
     throw LimException(COLUMBUS_LOCATION, CMSG_EX_FACTORY_INVALID_NODEID);
   }
 
-  if (nodeId != fileSystemId && container[nodeId]->getNodeKind() != ndkFolder) {
+  if (nodeId != fileSystemId && getPointer(nodeId)->getNodeKind() != ndkFolder) {
     throw LimException(COLUMBUS_LOCATION, CMSG_EX_FACTORY_INVALID_NODEKIND);
   }
 
@@ -894,9 +1050,9 @@ physical::File& Factory::createFile(const std::string& path, NodeId nodeId) {
   physical::FileSystem *fs = NULL;
   physical::Folder *folder = NULL;
   if (nodeId == fileSystemId) {
-    fs = (physical::FileSystem*)container[nodeId];
+    fs = (physical::FileSystem*)getPointer(nodeId);
   } else {
-    folder = (physical::Folder*)container[nodeId];
+    folder = (physical::Folder*)getPointer(nodeId);
   }
 
   pos = 0;
@@ -936,7 +1092,7 @@ physical::File& Factory::createFile(const std::string& path, NodeId nodeId) {
 
     if (found) {
       fs = NULL;
-      folder = (physical::Folder*)container[found];
+      folder = (physical::Folder*)getPointer(found);
     } else {
       // creating a new Folder
       physical::Folder& newFolder = (physical::Folder&)createNode(ndkFolder, container.size());
@@ -990,7 +1146,7 @@ physical::File& Factory::createFile(const std::string& path, NodeId nodeId) {
   }
 
   if (found) {
-    return (physical::File&)*container[found];
+    return (physical::File&)*getPointer(found);
   }
 
   // the File node is not found, creating a new one
@@ -25,6 +25,9 @@
 
 
 namespace columbus { namespace lim { namespace asg {
+
+const ReverseEdges::NodeListType ReverseEdges::emptyNodeList;
+
 ReverseEdges::ReverseEdges(const Factory *factory, FuncPtrWithBaseParameterType selectorFunction) : fact(factory),selectorFunc(selectorFunction),reContainer() {
   reContainer.resize(fact->size(), NULL);
   AlgorithmPreorder ap;
@@ -54,10 +57,8 @@ const ListIterator<base::Base> ReverseEdges::constIteratorBegin(NodeId id, EdgeK
   } else {
     base::Base& node = fact->getRef(id);
     if (possibleEdges[node.getNodeKind()][edge]) {
-      // creating an empty container and returning with it
-      NodeListType nodeList;
-      NodeEdgesType::const_iterator retIt = reContainer[id]->insert(std::make_pair(edge, nodeList)).first;
-      return ListIterator<base::Base>((ListIterator<base::Base>::Container*)&(retIt->second), fact, true);
+      // returning with a shared empty container, so the const query does not modify the container
+      return ListIterator<base::Base>((ListIterator<base::Base>::Container*)&emptyNodeList, fact, true);
     } else {
       throw LimException(COLUMBUS_LOCATION, CMSG_EX_INVALID_EDGE_KIND);
     }
@@ -74,10 +75,8 @@ const ListIterator<base::Base> ReverseEdges::constIteratorEnd(NodeId id, EdgeKin
   } else {
     base::Base& node = fact->getRef(id);
     if (possibleEdges[node.getNodeKind()][edge]) {
-      // creating an empty container and returning with it
-      NodeListType nodeList;
-      NodeEdgesType::const_iterator retIt = reContainer[id]->insert(std::make_pair(edge, nodeList)).first;
-      return ListIterator<base::Base>((ListIterator<base::Base>::Container*)&(retIt->second), fact, false);
+      // returning with a shared empty container, so the const query does not modify the container
+      return ListIterator<base::Base>((ListIterator<base::Base>::Container*)&emptyNodeList, fact, false);
     } else {
       throw LimException(COLUMBUS_LOCATION, CMSG_EX_INVALID_EDGE_KIND);
     }
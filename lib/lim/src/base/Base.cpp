@@ -61,7 +61,7 @@ namespace base {
 
   void Base::setParentEdge(const base::Base *childNode,EdgeKind _parentEdgeKind) const {
     if (childNode) {
-      if (childNode->parent != 0) {
+      if (childNode->parent != 0 && childNode->parent != m_id) {
         common::WriteMsg::write(CMSG_HAS_ALREADY_PARENT_THE_PARENT_WAS,childNode->getId(),Common::toString(childNode->getNodeKind()).c_str(),childNode->parent,Common::toString(childNode->getParent()->getNodeKind()).c_str() ,this->getId(),Common::toString(this->getNodeKind()).c_str()); 
       }
       childNode->parent = m_id;
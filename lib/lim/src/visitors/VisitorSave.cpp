@@ -22,10 +22,15 @@
 
 
 namespace columbus { namespace lim { namespace asg {
-  VisitorSave::VisitorSave(io::BinaryIO &_io) : VisitorAbstractNodes(), m_io(_io) {
+  VisitorSave::VisitorSave(io::BinaryIO &_io, std::vector<unsigned long long>* offsets) : VisitorAbstractNodes(), m_io(_io), m_offsets(offsets) {
   }
 
   void VisitorSave::visitEnd(const base::Base &node , bool callVirtualBase) {
+    if (m_offsets) {
+      if (m_offsets->size() <= node.getId())
+        m_offsets->resize(node.getId() + 1, 0);
+      (*m_offsets)[node.getId()] = m_io.getPosition();
+    }
     node.save(m_io);
   }
 
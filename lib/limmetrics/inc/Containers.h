@@ -28,6 +28,72 @@
 
 namespace columbus { namespace lim { namespace metrics {
 
+  /**
+  * The transitive closure of the class hierarchy of a LIM
+  * It is built once before the visit and only read afterwards, so it can be shared by the worker threads.
+  * The parents and children of the classes are collected by lim::Common, the closures are sparse bitsets
+  * in the depth-first order of the subclass graph, so the descendants of a class are mostly consecutive.
+  * The classes reaching a cycle of the hierarchy are not covered, because the results of the
+  * lim::Common functions depend on the order of the traversal there.
+  */
+  class ClassHierarchyIndex {
+
+    public:
+
+      ClassHierarchyIndex( asg::Factory& factory );
+
+      /**
+      * Collects the ancestors of the class, the same as lim::Common::collectAncestors
+      * \return false if the class is not covered (the set is not changed then)
+      */
+      bool collectAncestors( const asg::logical::Class& node, std::set<const asg::logical::Class*>& ancestors ) const;
+
+      /**
+      * Returns the number of the ancestors of the class or -1 if it is not covered
+      */
+      int getNumberOfAncestors( const asg::logical::Class& node ) const;
+
+      /**
+      * Returns the depth of the class, the same as the result of lim::Common::collectAncestors, or -1 if it is not covered
+      */
+      int getDepth( const asg::logical::Class& node ) const;
+
+      /**
+      * Returns the number of the descendants of the class and its instances, the same as the size of the
+      * set of InheritanceHelper::collectDescendants, or -1 if it is not covered
+      */
+      int getNumberOfDescendants( const asg::logical::Class& node ) const;
+
+    private:
+
+      /**
+      * 64 classes of a set (by their positions)
+      */
+      struct Block {
+        unsigned int index;
+        unsigned long long bits;
+      };
+
+      typedef std::vector<Block> ClassSet;
+
+      static const unsigned int NOT_INDEXED = (unsigned int) -1;
+
+      unsigned int getIndex( const asg::logical::Class& node ) const;
+
+      std::vector<unsigned int> indexOfNode;                        ///> The index of a class by its node id
+      std::vector<const asg::logical::Class*> classAtPosition;      ///> The classes by their bit positions
+      std::vector<unsigned int> position;                           ///> The bit positions of the classes
+      std::vector<bool> upCovered;
+      std::vector<ClassSet> ancestors;
+      std::vector<int> depth;
+      std::vector<bool> downCovered;
+      std::vector<ClassSet> descendants;                            ///> The descendants reached from a child (instances included)
+      std::vector<std::vector<unsigned int>> children;
+      std::vector<std::vector<unsigned int>> classInstances;
+      std::vector<bool> known;                                      ///> Whether all relatives of the class are indexed
+
+  };
+
   class InheritanceHelper {
 
     public:
@@ -42,24 +108,98 @@ namespace columbus { namespace lim { namespace metrics {
       void collectChildren( const asg::logical::Class& node, std::set<const asg::logical::Class*>& children );
       int collectDescendants( const asg::logical::Class& node, std::set<const asg::logical::Class*>& descendants );
 
+      /**
+      * The number of ancestors and descendants and the depth of a class without collecting them if the index covers it
+      */
+      int getNumberOfAncestors( const asg::logical::Class& node );
+      int getNumberOfDescendants( const asg::logical::Class& node );
+      int getDepth( const asg::logical::Class& node );
+
+      /**
+      * The hierarchy index used by the queries (it is not owned by the helper)
+      */
+      void setIndex( const ClassHierarchyIndex* index );
+      const ClassHierarchyIndex* getIndex() const;
+
     private:
       
       const asg::ReverseEdges& reverseEdges;
+      const ClassHierarchyIndex* index;
       asg::Common::InheritanceCache upCache;
       asg::Common::InheritanceCache downCache;
 
   };
 
 
+  //
+  // METRIC SLOTS
+  //
+
+  /**
+  * Registry of the integer slots of the metric names
+  * The collected values are keyed by these slots in the Info containers, so the metric
+  * handlers look up their slots once instead of comparing names for every node.
+  */
+  class MetricSlots {
+
+    public:
+
+      typedef unsigned int Slot;
+
+      /**
+      * Returns the slot of the given name (a new slot is registered for a new name)
+      */
+      static Slot get( const std::string& name );
+
+      /**
+      * Returns the slot of the total counterpart of a slot (the name with a "T" prefix)
+      */
+      static Slot total( Slot slot );
+
+      /**
+      * Returns the name of a slot
+      */
+      static std::string name( Slot slot );
+
+  };
+
+  /**
+  * Values keyed by metric slots, the names are accepted as well for convenience
+  */
+  template<class T> class SlotMap : public std::map<MetricSlots::Slot, T> {
+
+    public:
+
+      typedef std::map<MetricSlots::Slot, T> Base;
+
+      using Base::operator[];
+      using Base::find;
+      using Base::erase;
+
+      T& operator[]( const std::string& name ) {
+        return Base::operator[]( MetricSlots::get( name ) );
+      }
+
+      typename Base::iterator find( const std::string& name ) {
+        return Base::find( MetricSlots::get( name ) );
+      }
+
+      typename Base::size_type erase( const std::string& name ) {
+        return Base::erase( MetricSlots::get( name ) );
+      }
+
+  };
+
+
   //
   // SHARED CONTAINERS
   //
 
   struct Info {
 
-    typedef std::map<const std::string, int> IntMap;
-    typedef std::map<const std::string, std::set<NodeId>> SetMap;
-    typedef std::map<const std::string, std::map<NodeId, int>> MapMap;
+    typedef SlotMap<int> IntMap;
+    typedef SlotMap<std::set<NodeId>> SetMap;
+    typedef SlotMap<std::map<NodeId, int>> MapMap;
 
     /** Constructors */
     Info();
@@ -67,7 +207,14 @@ namespace columbus { namespace lim { namespace metrics {
     /** Adding two Infos */
     Info& merge( const Info& other );
 
+    /**
+    * Adds the values collected separately for the same node, including the children and the
+    * empty containers (the integers are summed, the sets are united, the map values are overwritten)
+    */
+    Info& accumulate( const Info& other );
+
     /** Counts a given map */
+    int mapCount( MetricSlots::Slot slot );
     int mapCount( const std::string& name );
 
     /** The nodes that appeared in the corresponding stack above this node (for easier aggregation) */
@@ -118,11 +265,25 @@ namespace columbus { namespace lim { namespace metrics {
 
     public:
 
+      SharedContainers();
+
       /**
       * Phase over signal for the individual shared containers
       */
       void phaseOver( DispatchPhases phase );
 
+      /**
+      * Swaps the collected values (the components, scopes, files and the contents of the LCOM maps)
+      * with the other containers, the stacks and the "outside" information are kept
+      */
+      void swapCollected( SharedContainers& other );
+
+      /**
+      * Adds the values collected separately into the other containers to these ones
+      * The LCOM entries of the other containers are appended after the existing ones.
+      */
+      void accumulate( const SharedContainers& other );
+
       /**
       * Stacks for the visit process
       */
@@ -41,6 +41,29 @@ namespace columbus { namespace lim { namespace metrics {
     phaseFinalize
   };
 
+  /**
+  * An enum for the metric levels of the nodes (see the NTYPE_LIM_* node types in
+  * the GraphConstants header), nlUnknown stands for every other node type
+  */
+  enum NodeLevel {
+    nlRoot,
+    nlComponent,
+    nlPackage,
+    nlNamespace,
+    nlModule,
+    nlClass,
+    nlStructure,
+    nlUnion,
+    nlInterface,
+    nlEnum,
+    nlAnnotation,
+    nlMethod,
+    nlFunction,
+    nlAttribute,
+    nlFile,
+    nlUnknown
+  };
+
 }}}
 
 #endif
\ No newline at end of file
@@ -26,6 +26,8 @@
 
 #include "RulParser.h"
 
+#include <boost/thread/mutex.hpp>
+
 //#include <set>
 //#include <string>
 
@@ -39,7 +41,11 @@ namespace columbus { namespace lim { namespace metrics {
       // CONSTRUCTOR
       //
 
-      LimMetricsVisitor( asg::Factory& factory, graph::Graph& graph, rul::RulHandler& rul, SharedContainers& shared);
+      /**
+      * If more than one thread is given, the top level class and function subtrees of the visit phase
+      * are computed in parallel (see apRunParallel), the results are the same as the serial ones.
+      */
+      LimMetricsVisitor( asg::Factory& factory, graph::Graph& graph, rul::RulHandler& rul, SharedContainers& shared, unsigned threads = 1 );
       virtual ~LimMetricsVisitor();
 
       //
@@ -49,6 +55,18 @@ namespace columbus { namespace lim { namespace metrics {
       void run();
       void apRun();
 
+      /**
+      * Visits the "normal" tree in the visit phase with the subtrees of the top level classes and
+      * functions (the ones directly inside packages) computed on separate threads.
+      *
+      * The visits are collected first. The parallel handlers of a subtree run on a worker thread with
+      * their own handler instances and shared containers, and the metric values are buffered. Then the
+      * visits are dispatched in the original order on the calling thread: the containers of a subtree
+      * are accumulated into the shared ones, the buffered values are replayed onto the graph and the
+      * remaining (serial) handlers are called directly.
+      */
+      void apRunParallel();
+
       //
       // VISITORS
       //
@@ -71,6 +89,31 @@ namespace columbus { namespace lim { namespace metrics {
       void begin( const asg::base::Base& node );
       void end( const asg::base::Base& node );
 
+      //
+      // PARALLEL VISIT
+      //
+
+      struct Subtree;
+      struct WorkerContext;
+
+      /**
+      * A collected visit (or visit end) of a node, or a placeholder of a whole subtree
+      */
+      struct Visit {
+        const asg::base::Base* node;
+        bool begin;
+        Subtree* subtree;
+      };
+
+      void collect( const asg::base::Base& node, bool begin );
+      void runSchedule();
+      void runSubtree( Subtree& subtree );
+      void commitSubtree( Subtree& subtree );
+      void clearSchedule();
+
+      WorkerContext* acquireContext();
+      void releaseContext( WorkerContext* context );
+
       //
       // DATA MEMBERS
       //
@@ -90,6 +133,22 @@ namespace columbus { namespace lim { namespace metrics {
 
       DispatchPhases phase;                   ///> Which phase should be used when dispatching
       bool useVisitEnd;                       ///> Whether or not to use the visitEnd methods in the current pass
+
+      rul::RulHandler& rulHandler;            ///> The rul handler for the handlers of the worker threads
+      SharedContainers& shared;               ///> The shared containers
+      unsigned threads;                       ///> The number of threads of the visit phase
+      ClassHierarchyIndex* hierarchyIndex;    ///> The class hierarchy index built for the run (or NULL)
+
+      bool collecting;                        ///> Whether the visits are collected instead of dispatched
+      std::vector<Visit> schedule;            ///> The collected visits in traversal order
+      std::vector<Subtree*> subtrees;         ///> The collected subtrees in traversal order
+      std::vector<const asg::base::Base*> openScopes;  ///> The packages around the current visit
+      Subtree* currentSubtree;                ///> The subtree being collected (or NULL)
+      unsigned currentDepth;                  ///> The depth of the current visit inside the current subtree
+
+      std::vector<WorkerContext*> contexts;   ///> The handlers and containers of the worker threads
+      std::vector<WorkerContext*> freeContexts;
+      boost::mutex contextMutex;
   };
 
 }}}
@@ -32,6 +32,7 @@
 
 #define CMSG_LIMMETRICS_EX_INVALID_GRAPH_NODE( id )               "Error: Invalid graph node for corresponding lim node (" + id + ")"
 #define CMSG_LIMMETRICS_EX_INVALID_METRIC_TYPE( metric )          "Error: Invalid metric type for " + metric
+#define CMSG_LIMMETRICS_EX_BUFFERED_METRIC_READ( metric )        "Error: The metric " + metric + " cannot be read from a buffered node"
 
 //------- OLD ---------
 #define CMSG_LIMMETRICS_CLASSKIND_NOT_FOUND               WriteMsg::mlDebug,   "Debug: Class node kind [%d] not found\n"
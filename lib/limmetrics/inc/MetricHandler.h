@@ -43,6 +43,14 @@ namespace columbus { namespace lim { namespace metrics {
   */
   typedef std::function<void(NodeWrapper&)> HandlerFunction;
 
+  /**
+  * The sizes of the dimensions of the dispatch table (see MetricHandler::dispatchKey)
+  */
+  const unsigned int DISPATCH_PHASE_COUNT = phaseFinalize + 1;
+  const unsigned int DISPATCH_LEVEL_COUNT = nlUnknown + 1;
+  const unsigned int DISPATCH_LANGUAGE_COUNT = asg::limLangJavaScript + 1;
+  const unsigned int DISPATCH_TABLE_SIZE = DISPATCH_PHASE_COUNT * DISPATCH_LEVEL_COUNT * DISPATCH_LANGUAGE_COUNT * 2;
+
   class MetricHandler {
 
     public:
@@ -91,6 +99,21 @@ namespace columbus { namespace lim { namespace metrics {
       */
       bool getIsOn() const;
 
+      /**
+      * Getter for the parallel attribute
+      * The visit handlers of a parallel metric can run on a separate thread for a class or function
+      * subtree (see LimMetricsVisitor), because they only read the lim and write the shared containers
+      * of their own thread and the buffered metric values of the visited nodes.
+      */
+      bool getIsParallel() const;
+
+      /**
+      * Getter for the hierarchyIndexed attribute
+      * It is true if the metric uses the ClassHierarchyIndex of the InheritanceHelper, which is only
+      * built for the run if at least one such metric is on.
+      */
+      bool getUsesHierarchyIndex() const;
+
       /**
       * Getter for the names of the other metrics on which the calculation of this metric depends
       */
@@ -113,8 +136,8 @@ namespace columbus { namespace lim { namespace metrics {
       /**
       * This method does the actual dispatching of nodes to their corresponding handlers which are looked
       * up in the dispatchMap below by phase (initialize, prepare, process, finalize, see aliases below),
-      * level (string values come from the GraphConstants header), language (enum values from the LIM
-      * Type.h header) and finally whether the current node is a variant or not.
+      * level (NodeLevel values standing for the node types of the GraphConstants header), language (enum
+      * values from the LIM Type.h header) and finally whether the current node is a variant or not.
       *
       * This dispatch mechanism will be common for every metric handler class, they only need to register
       * their corresponding member functions to the appropriate place in the dispatch map by calling the
@@ -130,6 +153,19 @@ namespace columbus { namespace lim { namespace metrics {
       */
       void dispatch( DispatchPhases phase, NodeWrapper& node );
 
+      /**
+      * Looks up the handler of the given phase, level, language and variant flag with the same
+      * translations and fallbacks as dispatch, returns NULL if there is none
+      * The result only depends on the arguments, so the RulParser resolves every combination once
+      * into its dispatch table instead of calling dispatch for every node.
+      */
+      const HandlerFunction* resolve( DispatchPhases phase, NodeLevel level, asg::Language language, bool isVariant ) const;
+
+      /**
+      * Packs the phase, level, language and variant flag into a dense index below DISPATCH_TABLE_SIZE
+      */
+      static unsigned int dispatchKey( DispatchPhases phase, NodeLevel level, asg::Language language, bool isVariant );
+
       /**
       * Translator method for the metric level by language
       * Can be used to set default redirects (see above)
@@ -169,12 +205,22 @@ namespace columbus { namespace lim { namespace metrics {
       std::string name;
       MetricDataTypes type;
 
+      /**
+      * The slot of the metric name in the Info containers
+      */
+      MetricSlots::Slot slot;
+
       bool enabled;
       bool dependency;
+      bool parallel;
+      bool hierarchyIndexed;
 
       std::set<std::string> dependencies;
 
-      std::map<DispatchPhases, std::map<std::string, std::map<asg::Language, std::map<bool, HandlerFunction>>>> dispatchMap;
+      /**
+      * The registered handlers by their dispatch keys
+      */
+      std::map<unsigned int, HandlerFunction> dispatchMap;
 
       SharedContainers* shared;
 
@@ -200,6 +246,11 @@ namespace columbus { namespace lim { namespace metrics {
       void cleanup( NodeWrapper& node, const std::string& name );
 
       bool isCalculatedFor( NodeWrapper& node );
+
+      /**
+      * Cached isCalculatedFor results by NodeLevel
+      */
+      std::vector<bool> calcLevels;
   };
 
 }}}
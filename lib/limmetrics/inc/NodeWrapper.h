@@ -24,8 +24,70 @@
 #include "lim/inc/lim.h"
 #include "graph/inc/graph.h"
 
+#include "Defines.h"
+
 namespace columbus { namespace lim { namespace metrics {
 
+  class NodeWrapper;
+
+  /**
+  * Records the metric values added to buffered nodes (see NodeWrapper) instead of writing
+  * them into the graph right away.
+  *
+  * The records are grouped by the visit and the dispatch entry which produced them, and they
+  * are replayed onto the graph nodes in the same order later, so the graph gets the same
+  * attributes and the same debug messages as if the values were added directly.
+  */
+  class MetricBuffer {
+
+    public:
+
+      MetricBuffer();
+
+      /**
+      * Selects the visit and the dispatch entry of the following records
+      */
+      void select( unsigned int visit, unsigned int entry );
+
+      /**
+      * Records a metric value or a disabled metric message for the selected visit and entry
+      */
+      void add( const std::string& metric, int value );
+      void add( const std::string& metric, float value );
+      void addDisabled( const std::string& metric );
+
+      /**
+      * Replays the records of the given visit and entry onto the target node
+      * The records have to be replayed in the order they were added.
+      */
+      void replay( unsigned int visit, unsigned int entry, NodeWrapper& target );
+
+      /**
+      * Drops every record
+      */
+      void clear();
+
+    private:
+
+      enum RecordKind { rkInt, rkFloat, rkDisabled };
+
+      struct Record {
+        unsigned int visit;
+        unsigned int entry;
+        RecordKind kind;
+        std::string metric;
+        int intValue;
+        float floatValue;
+      };
+
+      void record( RecordKind kind, const std::string& metric, int intValue, float floatValue );
+
+      std::vector<Record> records;
+      size_t cursor;                          ///> The first record which is not replayed yet
+      unsigned int visit;                     ///> The selected visit
+      unsigned int entry;                     ///> The selected dispatch entry
+  };
+
   /**
   * The NodeWrapper class encapsulates a LIM and a GRAPH node and adds helper
   * methods that make common, metrics related tasks easier.
@@ -49,9 +111,16 @@ namespace columbus { namespace lim { namespace metrics {
       * lim graph. The corresponding graph node is automatically loaded using a
       * unique id obtained from the lim node.
       */
-      NodeWrapper() {}
+      NodeWrapper() : limNode( NULL ), graph( NULL ), buffer( NULL ) {}
       NodeWrapper( const asg::base::Base& limNode, graph::Graph& graph );
 
+      /**
+      * Buffered node wrappers have no graph node, the added metric values are
+      * recorded into the buffer and the metric values cannot be read back.
+      * They are used by the parallel visit, where the graph must not be touched.
+      */
+      NodeWrapper( const asg::base::Base& limNode, MetricBuffer* buffer );
+
       //
       // GETTERS
       //
@@ -75,6 +144,11 @@ namespace columbus { namespace lim { namespace metrics {
       */
       const std::string& getLevel() const;
 
+      /**
+      * Getter for the metric level of the node as a NodeLevel
+      */
+      NodeLevel getLevelKind() const;
+
       /**
       * Getter for the source language of the node
       */
@@ -95,6 +169,11 @@ namespace columbus { namespace lim { namespace metrics {
       void addMetric( const std::string& metric, int value );
       void addMetric( const std::string& metric, float value );
 
+      /**
+      * Reports that the metric is disabled for this node (directly or into the buffer)
+      */
+      void reportDisabledMetric( const std::string& metric );
+
       /**
       * Metric value getters
       */
@@ -117,6 +196,20 @@ namespace columbus { namespace lim { namespace metrics {
       bool isGlobalAttribute() const;
       static bool isGlobalAttribute( const asg::base::Base& node );
 
+      //
+      // LEVELS
+      //
+
+      /**
+      * Converts a metric level (a node type string from the GraphConstants header) to a NodeLevel
+      */
+      static NodeLevel toLevelKind( const std::string& level );
+
+      /**
+      * Converts a NodeLevel back to its node type string
+      */
+      static const std::string& toLevel( NodeLevel level );
+
     private:
 
       static bool isParentClass( const asg::base::Base& node );
@@ -126,6 +219,7 @@ namespace columbus { namespace lim { namespace metrics {
       const asg::base::Base* limNode;
       graph::Node graphNode;
       graph::Graph* graph;
+      MetricBuffer* buffer;                   ///> The buffer of the metric values for buffered nodes, otherwise NULL
   };
 
 }}}
@@ -34,8 +34,9 @@ namespace columbus { namespace lim { namespace metrics {
 
       /**
       * Constructs a new RulParser from a "built-in" RulHandler
+      * (the handler instances of the parallel workers are created silently, verbose is false for them)
       */
-      RulParser( rul::RulHandler& rul, SharedContainers& shared );
+      RulParser( rul::RulHandler& rul, SharedContainers& shared, bool verbose = true );
 
       /**
       * Deletes the allocated MetricHandlers
@@ -48,11 +49,30 @@ namespace columbus { namespace lim { namespace metrics {
       */
       void dispatch( DispatchPhases phase, NodeWrapper& node );
 
+      /**
+      * Dispatches a buffered node of a class or function subtree to the parallel handler
+      * functions only, the added metric values are recorded for the given visit index
+      * (no messages are written, it can be called from a worker thread)
+      */
+      void dispatchParallel( DispatchPhases phase, NodeWrapper& node, unsigned int visit, MetricBuffer& buffer );
+
+      /**
+      * Dispatches the node like dispatch, but the values of the parallel handler functions are
+      * replayed from the buffer filled by dispatchParallel for the given visit index instead of
+      * computing them again
+      */
+      void dispatchRecorded( DispatchPhases phase, NodeWrapper& node, unsigned int visit, MetricBuffer& buffer );
+
       /**
       * Signals the shared containers that a given phase is over
       */
       void phaseOver( DispatchPhases phase );
 
+      /**
+      * Returns true if at least one handler that is on uses the class hierarchy index
+      */
+      bool getUsesHierarchyIndex() const;
+
     private:
 
       /**
@@ -76,6 +96,12 @@ namespace columbus { namespace lim { namespace metrics {
       */
       void sort();
 
+      /**
+      * This method resolves the handler functions of the sorted handlers for every cell of
+      * the dispatch table, so dispatching a node is a single index computation
+      */
+      void compile();
+
       /**
       * The (sorted) list of loaded metric handlers
       * (represented as a group of metric handlers mapped by their names and a separate
@@ -84,6 +110,23 @@ namespace columbus { namespace lim { namespace metrics {
       std::map<std::string, MetricHandler*> handlerMap;
       std::vector<std::string> handlerOrder;
 
+      /**
+      * A handler function of a metric handler in the dispatch table
+      * (the function is NULL if the handler has nothing to do in the cell, these entries are only
+      * stored at the mlDDebug message level to report them)
+      */
+      struct DispatchEntry {
+        MetricHandler* handler;
+        const HandlerFunction* function;
+        bool parallel;                        ///> The handler and all of its dependencies are parallel
+      };
+
+      /**
+      * The dispatch table indexed by MetricHandler::dispatchKey, every cell lists the
+      * handler functions to call in the order of handlerOrder
+      */
+      std::vector<std::vector<DispatchEntry>> dispatchTable;
+
       /**
       * The original rul handler
       */
@@ -93,6 +136,11 @@ namespace columbus { namespace lim { namespace metrics {
       * Shared containers
       */
       SharedContainers& shared;
+
+      /**
+      * Whether the creation of the handlers is reported
+      */
+      bool verbose;
       
       /**
       * Common stack maintenance for the shared containers
@@ -128,7 +128,7 @@ namespace columbus { namespace lim { namespace metrics {
     private:
       ScopePtr scopeLLOC;
       ComponentPtr componentLLOC;
-      std::string CLOC;
+      MetricSlots::Slot CLOC;
   };
 
   class CD : public CDBase {
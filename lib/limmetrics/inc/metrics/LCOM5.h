@@ -25,27 +25,21 @@
 
 namespace columbus { namespace lim { namespace metrics {
 
+  /**
+  * A method of the class in the connected component computation of LCOM5
+  * The elements are linked towards the roots of their components by the indices of the next
+  * elements, the attributes and called methods of a component are collected into its root.
+  */
   struct ConnectedComponentElement{
 
-    const lim::asg::Method* method;
-    ConnectedComponentElement *nextElement;
+    const lim::asg::logical::Method* method;
+    unsigned int nextElement;                 ///> The index of the next element towards the root (its own index for a root)
     std::set<const lim::asg::logical::Attribute*> accessedAttributes;
     std::set<const lim::asg::logical::Method*> methodCalls;
 
-    ConnectedComponentElement(const lim::asg::logical::Method* method) :
-        method(method), nextElement(NULL), accessedAttributes() {}
+    ConnectedComponentElement(const lim::asg::logical::Method* method, unsigned int index) :
+        method(method), nextElement(index), accessedAttributes(), methodCalls() {}
 
-    ConnectedComponentElement(const ConnectedComponentElement& element) :
-        method(element.method), nextElement(element.nextElement), accessedAttributes(element.accessedAttributes) {}
-
-    ConnectedComponentElement& operator = ( const ConnectedComponentElement& element ) {
-      method = element.method;
-      nextElement = element.nextElement;
-      accessedAttributes = element.accessedAttributes;
-
-      return *this;
-    }
-    
   };
 
   class LCOM5 : public MetricHandler {
@@ -54,7 +48,6 @@ namespace columbus { namespace lim { namespace metrics {
     protected:
       const std::string& translateLevel( asg::Language language, const std::string& level ) const override;
     private:
-      ConnectedComponentElement* getConnectedComponentRootElement( ConnectedComponentElement* element ) const;
       int calculateConnectedComponents( const asg::logical::Class& actClass, std::vector<ConnectedComponentElement>& connectedComponents, const std::set<const asg::logical::Class*>& parentClasses );
   };
 
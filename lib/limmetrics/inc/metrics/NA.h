@@ -34,7 +34,7 @@ namespace columbus { namespace lim { namespace metrics {
       void traverseClass( NodeWrapper& node );
       void processAttribute( const asg::logical::Attribute& attr, bool local );
       void add( const asg::logical::Attribute& attr, Info& info, bool local );
-      void innerAdd( const asg::logical::Attribute& attr, Info& info, bool local, std::string normalName, std::string localName );
+      void innerAdd( const asg::logical::Attribute& attr, Info& info, bool local, MetricSlots::Slot normalSlot, MetricSlots::Slot localSlot );
       const std::string& translateLevel( asg::Language language, const std::string& level ) const override;
 
       bool localMetric;
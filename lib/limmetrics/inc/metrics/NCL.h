@@ -32,7 +32,7 @@ namespace columbus { namespace lim { namespace metrics {
 
     protected:
       void processClass( NodeWrapper& node );
-      void add( const asg::logical::Class& clazz, Info& info, const std::string& name, const std::string& publicName );
+      void add( const asg::logical::Class& clazz, Info& info, MetricSlots::Slot name, MetricSlots::Slot publicName );
       const std::string& translateLevel( asg::Language language, const std::string& level ) const override;
   };
 
@@ -34,7 +34,7 @@ namespace columbus { namespace lim { namespace metrics {
       void traverseClass( NodeWrapper& node );
       void processMethod( const asg::logical::Method& method, bool local );
       void add( const asg::logical::Method& method, Info& info, bool local, int inc, bool useSets );
-      void innerAdd( const asg::logical::Method& method, Info& info, bool local, int inc, bool useSets, std::string normalName, std::string localName );
+      void innerAdd( const asg::logical::Method& method, Info& info, bool local, int inc, bool useSets, MetricSlots::Slot normalSlot, MetricSlots::Slot localSlot );
       const std::string& translateLevel( asg::Language language, const std::string& level ) const override;
 
       bool localMetric;
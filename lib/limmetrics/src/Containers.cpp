@@ -21,18 +21,372 @@
 #include "../inc/Containers.h"
 #include <iostream>
 
+#include <algorithm>
+#include <bitset>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
 using namespace std;
 using namespace common;
 using namespace columbus::lim::asg;
 
 namespace columbus { namespace lim { namespace metrics {
 
+  //
+  // CLASS HIERARCHY INDEX
+  //
+
+  namespace {
+
+    typedef vector<vector<unsigned int>> Graph;
+
+    /**
+    * Collects the strongly connected components of the graph by Tarjan's algorithm (without recursion)
+    * The components are listed after the components reachable from them, the nodes are numbered in the
+    * order of their discovery, starting the search from the nodes in the given order.
+    */
+    void collectComponents( const Graph& graph, const vector<unsigned int>& startOrder, vector<unsigned int>& discovery, vector<vector<unsigned int>>& components ) {
+      const unsigned int NOT_DISCOVERED = (unsigned int) -1;
+      const size_t size = graph.size();
+
+      discovery.assign( size, NOT_DISCOVERED );
+      vector<unsigned int> lowLink( size, 0 );
+      vector<bool> onStack( size, false );
+      vector<unsigned int> stack;
+      vector<pair<unsigned int, size_t>> path;     // the nodes of the search with the index of their next edge
+      unsigned int counter = 0;
+
+      for ( vector<unsigned int>::const_iterator start = startOrder.begin(); start != startOrder.end(); ++start ) {
+        if ( discovery[*start] != NOT_DISCOVERED ) {
+          continue;
+        }
+
+        path.push_back( make_pair( *start, (size_t) 0 ) );
+        discovery[*start] = lowLink[*start] = counter++;
+        stack.push_back( *start );
+        onStack[*start] = true;
+
+        while ( ! path.empty() ) {
+          unsigned int node = path.back().first;
+          size_t& edge = path.back().second;
+
+          if ( edge < graph[node].size() ) {
+            unsigned int next = graph[node][edge++];
+            if ( discovery[next] == NOT_DISCOVERED ) {
+              path.push_back( make_pair( next, (size_t) 0 ) );
+              discovery[next] = lowLink[next] = counter++;
+              stack.push_back( next );
+              onStack[next] = true;
+            } else if ( onStack[next] && discovery[next] < lowLink[node] ) {
+              lowLink[node] = discovery[next];
+            }
+            continue;
+          }
+
+          path.pop_back();
+          if ( ! path.empty() && lowLink[node] < lowLink[path.back().first] ) {
+            lowLink[path.back().first] = lowLink[node];
+          }
+
+          if ( lowLink[node] == discovery[node] ) {
+            components.push_back( vector<unsigned int>() );
+            unsigned int member;
+            do {
+              member = stack.back();
+              stack.pop_back();
+              onStack[member] = false;
+              components.back().push_back( member );
+            } while ( member != node );
+          }
+        }
+      }
+    }
+
+    template<class Set> void addSet( Set& target, const Set& source ) {
+      if ( source.empty() ) {
+        return;
+      }
+
+      Set result;
+      result.reserve( target.size() + source.size() );
+      typename Set::const_iterator t = target.begin(), tEnd = target.end(), s = source.begin(), sEnd = source.end();
+      while ( t != tEnd || s != sEnd ) {
+        if ( s == sEnd || ( t != tEnd && t->index < s->index ) ) {
+          result.push_back( *t++ );
+        } else if ( t == tEnd || s->index < t->index ) {
+          result.push_back( *s++ );
+        } else {
+          result.push_back( *t++ );
+          result.back().bits |= s++->bits;
+        }
+      }
+      target.swap( result );
+    }
+
+    template<class Set> void addPosition( Set& target, unsigned int position ) {
+      typename Set::value_type block;
+      block.index = position / 64;
+      block.bits = 0;
+
+      typename Set::iterator it = lower_bound( target.begin(), target.end(), block, []( const typename Set::value_type& a, const typename Set::value_type& b ) { return a.index < b.index; } );
+      if ( it == target.end() || it->index != block.index ) {
+        it = target.insert( it, block );
+      }
+      it->bits |= 1ULL << ( position % 64 );
+    }
+
+    template<class Set> int countPositions( const Set& set ) {
+      size_t counter = 0;
+      for ( typename Set::const_iterator it = set.begin(); it != set.end(); ++it ) {
+        counter += bitset<64>( it->bits ).count();
+      }
+      return (int) counter;
+    }
+
+    /**
+    * Marks the nodes which do not reach a cycle (or an unknown relative) as covered and computes their closures
+    */
+    template<class Set> void computeClosures( const Graph& graph, const vector<vector<unsigned int>>& components, const vector<bool>& known, const vector<unsigned int>& position, vector<bool>& covered, vector<Set>& closures ) {
+      covered.assign( graph.size(), false );
+      closures.resize( graph.size() );
+
+      for ( vector<vector<unsigned int>>::const_iterator component = components.begin(); component != components.end(); ++component ) {
+        if ( component->size() != 1 ) {
+          continue;
+        }
+
+        unsigned int node = component->front();
+        if ( ! known[node] ) {
+          continue;
+        }
+
+        bool reachesCycle = false;
+        for ( vector<unsigned int>::const_iterator next = graph[node].begin(); next != graph[node].end(); ++next ) {
+          if ( *next == node || ! covered[*next] ) {
+            reachesCycle = true;
+            break;
+          }
+        }
+        if ( reachesCycle ) {
+          continue;
+        }
+
+        covered[node] = true;
+        for ( vector<unsigned int>::const_iterator next = graph[node].begin(); next != graph[node].end(); ++next ) {
+          addPosition( closures[node], position[*next] );
+          addSet( closures[node], closures[*next] );
+        }
+      }
+    }
+
+  }
+
+  const unsigned int ClassHierarchyIndex::NOT_INDEXED;
+
+  ClassHierarchyIndex::ClassHierarchyIndex( asg::Factory& factory ) :
+    indexOfNode( factory.size(), NOT_INDEXED ),
+    classAtPosition(),
+    position(),
+    upCovered(),
+    ancestors(),
+    depth(),
+    downCovered(),
+    descendants(),
+    children(),
+    classInstances(),
+    known()
+  {
+    const ReverseEdges& reverseEdges = factory.getReverseEdges();
+
+    vector<const logical::Class*> classes;
+    for ( NodeId id = 0; id < factory.size(); ++id ) {
+      if ( factory.getExist( id ) && Common::getIsClass( factory.getRef( id ) ) ) {
+        indexOfNode[id] = (unsigned int) classes.size();
+        classes.push_back( dynamic_cast<const logical::Class*>( factory.getPointer( id ) ) );
+      }
+    }
+
+    const unsigned int size = (unsigned int) classes.size();
+
+    // the relatives found by lim::Common, the classes with a relative out of the index are not covered
+    Graph parents( size ), subclasses( size );
+    known.assign( size, true );
+    children.resize( size );
+    classInstances.resize( size );
+
+    for ( unsigned int i = 0; i < size; ++i ) {
+      set<const logical::Class*> relatives;
+      Common::collectParents( reverseEdges, *classes[i], relatives );
+      for ( set<const logical::Class*>::const_iterator it = relatives.begin(); it != relatives.end(); ++it ) {
+        unsigned int relative = getIndex( **it );
+        if ( relative == NOT_INDEXED ) {
+          known[i] = false;
+        } else {
+          parents[i].push_back( relative );
+        }
+      }
+
+      relatives.clear();
+      Common::collectChildren( reverseEdges, *classes[i], relatives );
+      for ( set<const logical::Class*>::const_iterator it = relatives.begin(); it != relatives.end(); ++it ) {
+        unsigned int relative = getIndex( **it );
+        if ( relative == NOT_INDEXED ) {
+          known[i] = false;
+        } else {
+          children[i].push_back( relative );
+        }
+      }
+
+      for ( ListIterator<logical::Member> it = classes[i]->getInstanceListIteratorBegin(); it != classes[i]->getInstanceListIteratorEnd(); ++it ) {
+        if ( Common::getIsClass( *it ) ) {
+          unsigned int instance = getIndex( dynamic_cast<const logical::Class&>( *it ) );
+          if ( instance == NOT_INDEXED ) {
+            known[i] = false;
+          } else {
+            classInstances[i].push_back( instance );
+          }
+        }
+      }
+    }
+
+    // the descendants of a class are searched through its generic instances as well
+    for ( unsigned int i = 0; i < size; ++i ) {
+      subclasses[i] = children[i];
+      for ( vector<unsigned int>::const_iterator instance = classInstances[i].begin(); instance != classInstances[i].end(); ++instance ) {
+        if ( Common::getIsClassGenericInstance( *classes[*instance] ) ) {
+          subclasses[i].insert( subclasses[i].end(), children[*instance].begin(), children[*instance].end() );
+          if ( ! known[*instance] ) {
+            known[i] = false;
+          }
+        }
+      }
+    }
+
+    // the positions follow the depth-first order of the subclasses starting from the roots of the hierarchy
+    vector<unsigned int> startOrder;
+    {
+      vector<bool> hasParent( size, false );
+      for ( unsigned int i = 0; i < size; ++i ) {
+        for ( vector<unsigned int>::const_iterator it = subclasses[i].begin(); it != subclasses[i].end(); ++it ) {
+          hasParent[*it] = true;
+        }
+      }
+      for ( unsigned int i = 0; i < size; ++i ) {
+        if ( ! hasParent[i] ) {
+          startOrder.push_back( i );
+        }
+      }
+      for ( unsigned int i = 0; i < size; ++i ) {
+        if ( hasParent[i] ) {
+          startOrder.push_back( i );
+        }
+      }
+    }
+
+    vector<vector<unsigned int>> components;
+    collectComponents( subclasses, startOrder, position, components );
+    classAtPosition.resize( size );
+    for ( unsigned int i = 0; i < size; ++i ) {
+      classAtPosition[position[i]] = classes[i];
+    }
+    computeClosures( subclasses, components, known, position, downCovered, descendants );
+
+    vector<unsigned int> upDiscovery;
+    components.clear();
+    startOrder.clear();
+    for ( unsigned int i = 0; i < size; ++i ) {
+      startOrder.push_back( i );
+    }
+    collectComponents( parents, startOrder, upDiscovery, components );
+    computeClosures( parents, components, known, position, upCovered, ancestors );
+
+    // the depths are computed in the same order as the closures (the parents first)
+    depth.assign( size, 0 );
+    for ( vector<vector<unsigned int>>::const_iterator component = components.begin(); component != components.end(); ++component ) {
+      unsigned int node = component->front();
+      if ( upCovered[node] ) {
+        int parentDepth = 0;
+        for ( vector<unsigned int>::const_iterator parent = parents[node].begin(); parent != parents[node].end(); ++parent ) {
+          if ( depth[*parent] > parentDepth ) {
+            parentDepth = depth[*parent];
+          }
+        }
+        depth[node] = parentDepth + 1;
+      }
+    }
+  }
+
+  unsigned int ClassHierarchyIndex::getIndex( const asg::logical::Class& node ) const {
+    NodeId id = node.getId();
+    return id < indexOfNode.size() ? indexOfNode[id] : NOT_INDEXED;
+  }
+
+  bool ClassHierarchyIndex::collectAncestors( const asg::logical::Class& node, std::set<const asg::logical::Class*>& ancestors ) const {
+    unsigned int i = getIndex( node );
+    if ( i == NOT_INDEXED || ! upCovered[i] ) {
+      return false;
+    }
+
+    const ClassSet& closure = this->ancestors[i];
+    for ( ClassSet::const_iterator it = closure.begin(); it != closure.end(); ++it ) {
+      for ( unsigned int bit = 0; bit < 64; ++bit ) {
+        if ( it->bits & ( 1ULL << bit ) ) {
+          ancestors.insert( classAtPosition[it->index * 64 + bit] );
+        }
+      }
+    }
+    return true;
+  }
+
+  int ClassHierarchyIndex::getNumberOfAncestors( const asg::logical::Class& node ) const {
+    unsigned int i = getIndex( node );
+    if ( i == NOT_INDEXED || ! upCovered[i] ) {
+      return -1;
+    }
+    return countPositions( ancestors[i] );
+  }
+
+  int ClassHierarchyIndex::getDepth( const asg::logical::Class& node ) const {
+    unsigned int i = getIndex( node );
+    if ( i == NOT_INDEXED || ! upCovered[i] ) {
+      return -1;
+    }
+    return depth[i];
+  }
+
+  int ClassHierarchyIndex::getNumberOfDescendants( const asg::logical::Class& node ) const {
+    unsigned int i = getIndex( node );
+    if ( i == NOT_INDEXED || ! known[i] ) {
+      return -1;
+    }
+
+    // the descendants of the instances of the class and the class itself
+    ClassSet result;
+    for ( size_t j = 0; j <= classInstances[i].size(); ++j ) {
+      unsigned int from = j < classInstances[i].size() ? classInstances[i][j] : i;
+      if ( ! known[from] ) {
+        return -1;
+      }
+      for ( vector<unsigned int>::const_iterator child = children[from].begin(); child != children[from].end(); ++child ) {
+        if ( ! downCovered[*child] ) {
+          return -1;
+        }
+        addPosition( result, position[*child] );
+        addSet( result, descendants[*child] );
+      }
+    }
+    return countPositions( result );
+  }
+
+
   //
   // INHERITANCE HELPER
   //
 
   InheritanceHelper::InheritanceHelper( const asg::ReverseEdges& reverseEdges ) :
     reverseEdges( reverseEdges ),
+    index( NULL ),
     upCache(),
     downCache()
     {}
@@ -42,6 +396,9 @@ namespace columbus { namespace lim { namespace metrics {
   }
 
   int InheritanceHelper::collectAncestors( const asg::logical::Class& node, std::set<const asg::logical::Class*>& ancestors ) {
+    if ( index && index->collectAncestors( node, ancestors ) ) {
+      return index->getDepth( node );
+    }
     return Common::collectAncestors( reverseEdges, node, ancestors, &upCache );
   }
 
@@ -71,6 +428,102 @@ namespace columbus { namespace lim { namespace metrics {
     return Common::collectDescendants( reverseEdges, node, descendants, &downCache );
   }
 
+  int InheritanceHelper::getNumberOfAncestors( const asg::logical::Class& node ) {
+    int number = index ? index->getNumberOfAncestors( node ) : -1;
+    if ( number < 0 ) {
+      set<const logical::Class*> ancestors;
+      Common::collectAncestors( reverseEdges, node, ancestors, &upCache );
+      number = (int) ancestors.size();
+    }
+    return number;
+  }
+
+  int InheritanceHelper::getNumberOfDescendants( const asg::logical::Class& node ) {
+    int number = index ? index->getNumberOfDescendants( node ) : -1;
+    if ( number < 0 ) {
+      set<const logical::Class*> descendants;
+      collectDescendants( node, descendants );
+      number = (int) descendants.size();
+    }
+    return number;
+  }
+
+  int InheritanceHelper::getDepth( const asg::logical::Class& node ) {
+    int depth = index ? index->getDepth( node ) : -1;
+    if ( depth < 0 ) {
+      set<const logical::Class*> ancestors;
+      depth = Common::collectAncestors( reverseEdges, node, ancestors, &upCache );
+    }
+    return depth;
+  }
+
+  void InheritanceHelper::setIndex( const ClassHierarchyIndex* index ) {
+    this->index = index;
+  }
+
+  const ClassHierarchyIndex* InheritanceHelper::getIndex() const {
+    return index;
+  }
+
+
+  //
+  // METRIC SLOTS
+  //
+
+  namespace {
+
+    // The slots are registered while the handlers are created, but the names can be
+    // looked up later as well, so the registry is guarded by a mutex
+    struct SlotRegistry {
+      boost::mutex mutex;
+      boost::unordered_map<string, MetricSlots::Slot> slots;
+      vector<string> names;
+      vector<MetricSlots::Slot> totals;
+    };
+
+    const MetricSlots::Slot NO_SLOT = (MetricSlots::Slot) -1;
+
+    SlotRegistry& slotRegistry() {
+      static SlotRegistry registry;
+      return registry;
+    }
+
+    MetricSlots::Slot registerSlot( SlotRegistry& registry, const string& name ) {
+      boost::unordered_map<string, MetricSlots::Slot>::const_iterator it = registry.slots.find( name );
+      if ( it != registry.slots.end() ) {
+        return it->second;
+      }
+
+      MetricSlots::Slot slot = (MetricSlots::Slot) registry.names.size();
+      registry.slots.insert( make_pair( name, slot ) );
+      registry.names.push_back( name );
+      registry.totals.push_back( NO_SLOT );
+      return slot;
+    }
+
+  }
+
+  MetricSlots::Slot MetricSlots::get( const string& name ) {
+    SlotRegistry& registry = slotRegistry();
+    boost::unique_lock<boost::mutex> lock( registry.mutex );
+    return registerSlot( registry, name );
+  }
+
+  MetricSlots::Slot MetricSlots::total( Slot slot ) {
+    SlotRegistry& registry = slotRegistry();
+    boost::unique_lock<boost::mutex> lock( registry.mutex );
+    if ( registry.totals[slot] == NO_SLOT ) {
+      Slot total = registerSlot( registry, "T" + registry.names[slot] );
+      registry.totals[slot] = total;
+    }
+    return registry.totals[slot];
+  }
+
+  string MetricSlots::name( Slot slot ) {
+    SlotRegistry& registry = slotRegistry();
+    boost::unique_lock<boost::mutex> lock( registry.mutex );
+    return registry.names[slot];
+  }
 
   //
   // INFO
@@ -86,14 +539,14 @@ namespace columbus { namespace lim { namespace metrics {
   Info& Info::merge( const Info& other ) {
 
     // ints
-    map<const string, int>::const_iterator ii = other.ints.begin();
+    IntMap::const_iterator ii = other.ints.begin();
     for ( ; ii != other.ints.end(); ++ii )
     {
       ints[ii->first] += ii->second;
     }
 
     // sets
-    map<const string, set<NodeId> >::const_iterator i = other.sets.begin();
+    SetMap::const_iterator i = other.sets.begin();
     for ( ; i != other.sets.end(); ++i )
     {
       set<NodeId>::const_iterator j = i->second.begin();
@@ -101,7 +554,7 @@ namespace columbus { namespace lim { namespace metrics {
     }
 
     // maps
-    map<const string, map<NodeId, int> >::const_iterator k = other.maps.begin();
+    MapMap::const_iterator k = other.maps.begin();
     for ( ; k != other.maps.end(); ++k )
     {
       map<NodeId, int>::const_iterator l = k->second.begin();
@@ -111,9 +564,40 @@ namespace columbus { namespace lim { namespace metrics {
     return *this;
   }
 
+  Info& Info::accumulate( const Info& other ) {
+
+    children.insert( other.children.begin(), other.children.end() );
+
+    IntMap::const_iterator ii = other.ints.begin();
+    for ( ; ii != other.ints.end(); ++ii )
+    {
+      ints[ii->first] += ii->second;
+    }
+
+    SetMap::const_iterator i = other.sets.begin();
+    for ( ; i != other.sets.end(); ++i )
+    {
+      sets[i->first].insert( i->second.begin(), i->second.end() );
+    }
+
+    MapMap::const_iterator k = other.maps.begin();
+    for ( ; k != other.maps.end(); ++k )
+    {
+      map<NodeId, int>& target = maps[k->first];
+      map<NodeId, int>::const_iterator l = k->second.begin();
+      for ( ; l != k->second.end(); ++l ) target[l->first] = l->second;
+    }
+
+    return *this;
+  }
+
   int Info::mapCount( const string& name ) {
+    return mapCount( MetricSlots::get( name ) );
+  }
+
+  int Info::mapCount( MetricSlots::Slot slot ) {
     unsigned int sum = 0;
-    map<const string, map<NodeId, int>>::iterator mapIt = maps.find( name );
+    MapMap::iterator mapIt = maps.find( slot );
     if ( mapIt == maps.end() ) {
       return 0;
     }
@@ -159,23 +643,23 @@ namespace columbus { namespace lim { namespace metrics {
     Info::IntMap newIntMap;
     Info::IntMap::iterator intIt = info.ints.begin(), intEnd = info.ints.end();
     for ( ; intIt != intEnd; ++intIt ) {
-      newIntMap["T" + intIt->first] = intIt->second;
+      newIntMap[MetricSlots::total( intIt->first )] = intIt->second;
     }
-    info.ints = newIntMap;
+    info.ints.swap( newIntMap );
 
     Info::SetMap newSetMap;
     Info::SetMap::iterator setIt = info.sets.begin(), setEnd = info.sets.end();
     for ( ; setIt != setEnd; ++setIt ) {
-      newSetMap["T" + setIt->first] = setIt->second;
+      newSetMap[MetricSlots::total( setIt->first )].swap( setIt->second );
     }
-    info.sets = newSetMap;
+    info.sets.swap( newSetMap );
 
     Info::MapMap newMapMap;
     Info::MapMap::iterator mapIt = info.maps.begin(), mapEnd = info.maps.end();
     for ( ; mapIt != mapEnd; ++mapIt ) {
-      newMapMap["T" + mapIt->first] = mapIt->second;
+      newMapMap[MetricSlots::total( mapIt->first )].swap( mapIt->second );
     }
-    info.maps = newMapMap;
+    info.maps.swap( newMapMap );
   }
 
   //
@@ -248,6 +732,24 @@ namespace columbus { namespace lim { namespace metrics {
   // SHARED CONTAINERS
   //
 
+  namespace {
+
+    void accumulateContainer( SharedContainer::ContainerType& target, const SharedContainer::ContainerType& source ) {
+      SharedContainer::ContainerType::const_iterator i = source.begin(), end = source.end();
+      for ( ; i != end; ++i ) {
+        target[i->first].accumulate( i->second );
+      }
+    }
+
+  }
+
+  SharedContainers::SharedContainers() :
+    overrides( NULL ),
+    factory( NULL ),
+    inheritance( NULL ),
+    LCOMMap( NULL )
+  {}
+
   void SharedContainers::phaseOver( DispatchPhases phase ) {
 
     // NEWSHARED
@@ -258,6 +760,33 @@ namespace columbus { namespace lim { namespace metrics {
     scopes.phaseOver( phase );
   }
 
+  void SharedContainers::swapCollected( SharedContainers& other ) {
+    components.map.swap( other.components.map );
+    scopes.map.swap( other.scopes.map );
+    files.swap( other.files );
+    if ( LCOMMap && other.LCOMMap ) {
+      LCOMMap->swap( *other.LCOMMap );
+    }
+  }
+
+  void SharedContainers::accumulate( const SharedContainers& other ) {
+    accumulateContainer( components.map, other.components.map );
+    accumulateContainer( scopes.map, other.scopes.map );
+    accumulateContainer( files, other.files );
+
+    if ( LCOMMap && other.LCOMMap ) {
+      LCOMMapType::const_iterator i = other.LCOMMap->begin(), end = other.LCOMMap->end();
+      for ( ; i != end; ++i ) {
+        map<string, vector<string>>& target = (*LCOMMap)[i->first];
+        map<string, vector<string>>::const_iterator j = i->second.begin();
+        for ( ; j != i->second.end(); ++j ) {
+          vector<string>& values = target[j->first];
+          values.insert( values.end(), j->second.begin(), j->second.end() );
+        }
+      }
+    }
+  }
+
   Info& SharedContainers::currentPackageInfo() {
     return scopes.map[&packageStack.back().getLimNode<logical::Package>()];
   }
@@ -25,6 +25,7 @@
 #include <common/inc/StringSup.h>
 #include <lim2graph/inc/VisitorGraphConverter.h>
 #include <graphsupport/inc/GraphConstants.h>
+#include <threadpool/inc/Executor.h>
 
 #include "../inc/metrics/NM.h"
 #include "../inc/metrics/LOC.h"
@@ -39,24 +40,92 @@ using namespace columbus::lim::asg;
 
 namespace columbus { namespace lim { namespace metrics {
 
+  namespace {
+
+    // The number of subtrees which can be computed ahead of the ordered dispatch for every thread
+    const unsigned SUBTREES_AHEAD_PER_THREAD = 4;
+
+  }
+
+  //
+  // PARALLEL VISIT DATA
+  //
+
+  /**
+  * The visits of a top level class or function subtree and the results of their parallel handlers
+  */
+  struct LimMetricsVisitor::Subtree {
+    std::vector<Visit> visits;                          ///> The visits inside the subtree in traversal order
+    std::vector<const base::Base*> scopes;              ///> The packages around the subtree
+    SharedContainers collected;                         ///> The values collected into the containers by the subtree
+    LCOMMapType lcom;                                   ///> The LCOM entries added by the subtree
+    MetricBuffer buffer;                                ///> The metric values of the visited nodes
+    std::future<void> done;                             ///> The result of the worker task
+  };
+
+  /**
+  * The handlers and containers used by one worker thread at a time
+  */
+  struct LimMetricsVisitor::WorkerContext {
+
+    WorkerContext( rul::RulHandler& rulHandler, const SharedContainers& main, const ReverseEdges& reverseEdges ) :
+      shared(),
+      inheritance( reverseEdges ),
+      lcom(),
+      rul( rulHandler, shared, false )
+    {
+      shared.overrides = main.overrides;
+      shared.factory = main.factory;
+      shared.inheritance = main.inheritance ? &inheritance : NULL;
+      if ( main.inheritance ) {
+        inheritance.setIndex( main.inheritance->getIndex() );
+      }
+      shared.LCOMMap = main.LCOMMap ? &lcom : NULL;
+    }
+
+    SharedContainers shared;
+    InheritanceHelper inheritance;
+    LCOMMapType lcom;
+    RulParser rul;
+  };
+
   //
   // CONSTRUCTOR
   //
 
-  LimMetricsVisitor::LimMetricsVisitor( Factory& factory, graph::Graph& graph, rul::RulHandler& rul, SharedContainers& shared) :
+  LimMetricsVisitor::LimMetricsVisitor( Factory& factory, graph::Graph& graph, rul::RulHandler& rul, SharedContainers& shared, unsigned threads ) :
     factory( factory ),
     graph( graph ),
     rul( RulParser( rul, shared ) ),
     reverseEdges( factory.getReverseEdges() ),
     phase( phaseVisit ),
-    useVisitEnd( true )
+    useVisitEnd( true ),
+    rulHandler( rul ),
+    shared( shared ),
+    threads( threads > 0 ? threads : 1 ),
+    hierarchyIndex( NULL ),
+    collecting( false ),
+    schedule(),
+    subtrees(),
+    openScopes(),
+    currentSubtree( NULL ),
+    currentDepth( 0 ),
+    contexts(),
+    freeContexts(),
+    contextMutex()
   {
     ap.setVisitSpecialNodes(true, true);
     ap.setCrossEdgeToTraversal(lim::asg::edkScope_HasMember);
     ap.setSafeMode();
   }
 
-  LimMetricsVisitor::~LimMetricsVisitor() {}
+  LimMetricsVisitor::~LimMetricsVisitor() {
+    clearSchedule();
+    if ( hierarchyIndex ) {
+      shared.inheritance->setIndex( NULL );
+      delete hierarchyIndex;
+    }
+  }
 
   //
   // MAIN LOGIC
@@ -64,6 +133,12 @@ namespace columbus { namespace lim { namespace metrics {
 
   void LimMetricsVisitor::run() {
 
+    // the class hierarchy is indexed once for the inheritance related metrics (if any of them is on)
+    if ( shared.inheritance && ! shared.inheritance->getIndex() && rul.getUsesHierarchyIndex() ) {
+      hierarchyIndex = new ClassHierarchyIndex( factory );
+      shared.inheritance->setIndex( hierarchyIndex );
+    }
+
     // main run
     WriteMsg::write( CMSG_LIMMETRICS_PHASE, "Visit" );
     apRun();
@@ -92,7 +167,11 @@ namespace columbus { namespace lim { namespace metrics {
 
   void LimMetricsVisitor::apRun() {
     // "normal" tree
-    ap.run( factory, *this, factory.getRoot()->getId() );
+    if ( phase == phaseVisit && threads > 1 ) {
+      apRunParallel();
+    } else {
+      ap.run( factory, *this, factory.getRoot()->getId() );
+    }
 
     // file system
     ap.run( factory, *this, factory.getFileSystemRoot() );
@@ -141,18 +220,218 @@ namespace columbus { namespace lim { namespace metrics {
   //
 
   void LimMetricsVisitor::begin( const base::Base& node ) {
+    if ( collecting ) {
+      collect( node, true );
+      return;
+    }
     VISIT_DEBUG( "begin" );
     NodeWrapper nw( node, graph );
     rul.dispatch( phase, nw );
   }
 
   void LimMetricsVisitor::end( const base::Base& node ) {
-    if ( useVisitEnd ) {
+    if ( collecting ) {
+      collect( node, false );
+    } else if ( useVisitEnd ) {
       VISIT_DEBUG( "end" );
       NodeWrapper nw( node, graph );
       rul.dispatch( phaseVisitEnd, nw );
     }
   }
+
+  //
+  // PARALLEL VISIT
+  //
+
+  void LimMetricsVisitor::apRunParallel() {
+
+    // the lim is only read by the worker threads, so the lazily loaded nodes are created in advance
+    factory.materializeAll();
+
+    try {
+      collecting = true;
+      ap.run( factory, *this, factory.getRoot()->getId() );
+      collecting = false;
+
+      for ( unsigned i = 0; i < threads; ++i ) {
+        contexts.push_back( new WorkerContext( rulHandler, shared, reverseEdges ) );
+      }
+      freeContexts = contexts;
+
+      runSchedule();
+    } catch ( ... ) {
+      collecting = false;
+      clearSchedule();
+      throw;
+    }
+
+    clearSchedule();
+  }
+
+  /*
+  * The packages are visited directly, every class or method directly inside a package (and the
+  * members, nested classes and local classes inside it) is collected as a separate subtree
+  */
+  void LimMetricsVisitor::collect( const base::Base& node, bool begin ) {
+
+    if ( currentSubtree ) {
+      Visit visit = { &node, begin, NULL };
+      currentSubtree->visits.push_back( visit );
+      if ( begin ) {
+        ++currentDepth;
+      } else if ( --currentDepth == 0 ) {
+        currentSubtree = NULL;
+      }
+      return;
+    }
+
+    if ( begin && !openScopes.empty() && ( Common::getIsClass( node ) || Common::getIsMethod( node ) ) ) {
+      Subtree* subtree = new Subtree;
+      subtrees.push_back( subtree );
+      subtree->scopes = openScopes;
+      subtree->collected.LCOMMap = shared.LCOMMap ? &subtree->lcom : NULL;
+
+      Visit placeholder = { NULL, true, subtree };
+      schedule.push_back( placeholder );
+
+      Visit visit = { &node, true, NULL };
+      subtree->visits.push_back( visit );
+      currentSubtree = subtree;
+      currentDepth = 1;
+      return;
+    }
+
+    Visit visit = { &node, begin, NULL };
+    schedule.push_back( visit );
+
+    if ( Common::getIsPackage( node ) ) {
+      if ( begin ) {
+        openScopes.push_back( &node );
+      } else {
+        openScopes.pop_back();
+      }
+    }
+  }
+
+  void LimMetricsVisitor::runSchedule() {
+
+    // declared after the subtrees and the contexts are created, so its threads are joined before they are deleted
+    thread::Executor executor( threads );
+
+    size_t ahead = threads * SUBTREES_AHEAD_PER_THREAD;
+    size_t submitted = 0;
+    size_t committed = 0;
+
+    for ( vector<Visit>::const_iterator it = schedule.begin(); it != schedule.end(); ++it ) {
+
+      if ( it->subtree == NULL ) {
+        if ( it->begin ) {
+          begin( *it->node );
+        } else {
+          end( *it->node );
+        }
+        continue;
+      }
+
+      for ( ; submitted < subtrees.size() && submitted < committed + ahead; ++submitted ) {
+        Subtree* subtree = subtrees[submitted];
+        subtree->done = executor.submit( [this, subtree]() { runSubtree( *subtree ); } );
+      }
+
+      commitSubtree( *it->subtree );
+
+      // the committed subtree is not needed anymore
+      delete subtrees[committed];
+      subtrees[committed] = NULL;
+      ++committed;
+    }
+  }
+
+  /*
+  * Runs on a worker thread, so only the containers of the context and the subtree are written
+  */
+  void LimMetricsVisitor::runSubtree( Subtree& subtree ) {
+
+    WorkerContext* context = acquireContext();
+    SharedContainers& local = context->shared;
+
+    try {
+      // the stacks are only left filled by a failed task
+      local.packageStack.clear();
+      local.classStack.clear();
+      local.methodStack.clear();
+      local.scopeStack.clear();
+
+      for ( vector<const base::Base*>::const_iterator it = subtree.scopes.begin(); it != subtree.scopes.end(); ++it ) {
+        NodeWrapper nw( **it, &subtree.buffer );
+        local.packageStack.push_back( nw );
+        local.scopeStack.push_back( nw );
+      }
+
+      for ( unsigned i = 0; i < subtree.visits.size(); ++i ) {
+        const Visit& visit = subtree.visits[i];
+        NodeWrapper nw( *visit.node, &subtree.buffer );
+        context->rul.dispatchParallel( visit.begin ? phaseVisit : phaseVisitEnd, nw, i, subtree.buffer );
+      }
+    } catch ( ... ) {
+      releaseContext( context );
+      throw;
+    }
+
+    local.swapCollected( subtree.collected );
+
+    releaseContext( context );
+  }
+
+  void LimMetricsVisitor::commitSubtree( Subtree& subtree ) {
+
+    // rethrows the exception of the worker task
+    subtree.done.get();
+
+    shared.accumulate( subtree.collected );
+
+    for ( unsigned i = 0; i < subtree.visits.size(); ++i ) {
+      const Visit& visit = subtree.visits[i];
+      const base::Base& node = *visit.node;
+      if ( visit.begin ) {
+        VISIT_DEBUG( "begin" );
+      } else {
+        VISIT_DEBUG( "end" );
+      }
+      NodeWrapper nw( node, graph );
+      rul.dispatchRecorded( visit.begin ? phaseVisit : phaseVisitEnd, nw, i, subtree.buffer );
+    }
+  }
+
+  void LimMetricsVisitor::clearSchedule() {
+    for ( vector<Subtree*>::iterator it = subtrees.begin(); it != subtrees.end(); ++it ) {
+      delete *it;
+    }
+    subtrees.clear();
+    schedule.clear();
+    openScopes.clear();
+    currentSubtree = NULL;
+    currentDepth = 0;
+
+    for ( vector<WorkerContext*>::iterator it = contexts.begin(); it != contexts.end(); ++it ) {
+      delete *it;
+    }
+    contexts.clear();
+    freeContexts.clear();
+  }
+
+  LimMetricsVisitor::WorkerContext* LimMetricsVisitor::acquireContext() {
+    // there are as many contexts as worker threads, so one is always free
+    boost::unique_lock<boost::mutex> lock( contextMutex );
+    WorkerContext* context = freeContexts.back();
+    freeContexts.pop_back();
+    return context;
+  }
+
+  void LimMetricsVisitor::releaseContext( WorkerContext* context ) {
+    boost::unique_lock<boost::mutex> lock( contextMutex );
+    freeContexts.push_back( context );
+  }
    
 }}}
 
@@ -29,13 +29,12 @@ using namespace columbus::graphsupport::graphconstants;
 namespace columbus { namespace lim { namespace metrics {
 
   MetricHandler::MetricHandler() :
-    name( "Undefined" ), type( mdtInt ), enabled( false ), dependency( false ), shared( NULL ) {}
+    name( "Undefined" ), type( mdtInt ), slot( MetricSlots::get( name ) ), enabled( false ), dependency( false ), parallel( true ), hierarchyIndexed( false ), shared( NULL ),
+    calcLevels( DISPATCH_LEVEL_COUNT, false ) {}
 
   MetricHandler::MetricHandler( const string& name, MetricDataTypes type, bool enabled, SharedContainers* shared ) :
-      name( name ), type( type ), enabled( enabled ), dependency( false ), shared( shared )
-  {
-    WriteMsg::write( CMSG_LIMMETRICS_HANDLER_CREATED, name.c_str() );
-  }
+      name( name ), type( type ), slot( MetricSlots::get( name ) ), enabled( enabled ), dependency( false ), parallel( true ), hierarchyIndexed( false ), shared( shared ),
+      calcLevels( DISPATCH_LEVEL_COUNT, false ) {}
 
   const std::string& MetricHandler::getName() const {
     return name;
@@ -61,6 +60,14 @@ namespace columbus { namespace lim { namespace metrics {
     return enabled || dependency;
   }
 
+  bool MetricHandler::getIsParallel() const {
+    return parallel;
+  }
+
+  bool MetricHandler::getUsesHierarchyIndex() const {
+    return hierarchyIndexed;
+  }
+
   const set<string>& MetricHandler::getDependencies() const {
     return dependencies;
   }
@@ -71,36 +78,13 @@ namespace columbus { namespace lim { namespace metrics {
 
   void MetricHandler::setCalculatedFor( const set<string>& c ) {
     calc = c;
+    for ( unsigned int level = 0; level < DISPATCH_LEVEL_COUNT; ++level ) {
+      calcLevels[level] = calc.find( NodeWrapper::toLevel( (NodeLevel) level ) ) != calc.end();
+    }
   }
 
   void MetricHandler::dispatch( DispatchPhases phase, NodeWrapper& node ) {
-    HandlerFunction* function = NULL;
-    
-    Language lang = node.getLanguage();
-    auto phaseIt = dispatchMap.find( phase );
-    if ( phaseIt != dispatchMap.end() ) {
-      auto levelIt = phaseIt->second.find( translateLevel( lang, node.getLevel() ) );
-      if ( levelIt != phaseIt->second.end() ) {
-        auto langIt = levelIt->second.find( lang );
-        if ( langIt != levelIt->second.end() ) {
-          auto variantIt = langIt->second.find( translateVariant( lang, node.getIsVariant() ) );
-          if ( variantIt != langIt->second.end() ) {
-            function = &variantIt->second;
-          }
-        }
-
-        // Fallback to the limLangOther language if there's no handler yet
-        if ( function == NULL ) {
-          langIt = levelIt->second.find( limLangOther );
-          if ( langIt != levelIt->second.end() ) {
-            auto variantIt = langIt->second.find( translateVariant( lang, node.getIsVariant() ) );
-            if ( variantIt != langIt->second.end() ) {
-              function = &variantIt->second;
-            }
-          }
-        }
-      }
-    }
+    const HandlerFunction* function = resolve( phase, node.getLevelKind(), node.getLanguage(), node.getIsVariant() );
 
     if ( function != NULL ) {
       WriteMsg::write( CMSG_LIMMETRICS_DISPATCH, name.c_str(), node.getLimNode<base::Base>().getId(), phase );
@@ -110,6 +94,28 @@ namespace columbus { namespace lim { namespace metrics {
     }
   }
 
+  const HandlerFunction* MetricHandler::resolve( DispatchPhases phase, NodeLevel level, Language language, bool isVariant ) const {
+    NodeLevel translatedLevel = NodeWrapper::toLevelKind( translateLevel( language, NodeWrapper::toLevel( level ) ) );
+    if ( translatedLevel == nlUnknown ) {
+      return NULL;
+    }
+
+    bool translatedVariant = translateVariant( language, isVariant );
+    map<unsigned int, HandlerFunction>::const_iterator it = dispatchMap.find( dispatchKey( phase, translatedLevel, language, translatedVariant ) );
+
+    // Fallback to the limLangOther language if there's no handler yet
+    if ( it == dispatchMap.end() ) {
+      it = dispatchMap.find( dispatchKey( phase, translatedLevel, limLangOther, translatedVariant ) );
+    }
+
+    return it != dispatchMap.end() ? &it->second : NULL;
+  }
+
+  unsigned int MetricHandler::dispatchKey( DispatchPhases phase, NodeLevel level, Language language, bool isVariant ) {
+    unsigned int lang = (unsigned int) language < DISPATCH_LANGUAGE_COUNT ? (unsigned int) language : (unsigned int) limLangOther;
+    return ( ( phase * DISPATCH_LEVEL_COUNT + level ) * DISPATCH_LANGUAGE_COUNT + lang ) * 2 + ( isVariant ? 1 : 0 );
+  }
+
   /*
   * Default level translations for equivalent classes in a language
   */
@@ -221,20 +227,11 @@ namespace columbus { namespace lim { namespace metrics {
     bool isVariant,
     HandlerFunction handler
   ) {
-
-    if ( dispatchMap.find( phase ) == dispatchMap.end() ) {
-      dispatchMap[phase] = map<string, map<Language, map<bool, HandlerFunction>>>();
-    }
-
-    if ( dispatchMap[phase].find( level ) == dispatchMap[phase].end() ) {
-      dispatchMap[phase][level] = map<Language, map<bool, HandlerFunction>>();
+    // levels without a NodeLevel can never be dispatched to
+    NodeLevel levelKind = NodeWrapper::toLevelKind( level );
+    if ( levelKind != nlUnknown ) {
+      dispatchMap[dispatchKey( phase, levelKind, language, isVariant )] = handler;
     }
-
-    if ( dispatchMap[phase][level].find( language ) == dispatchMap[phase][level].end() ) {
-      dispatchMap[phase][level][language] = map<bool, HandlerFunction>();
-    }
-
-    dispatchMap[phase][level][language][isVariant] = handler;
   }
 
   void MetricHandler::addMetric( NodeWrapper& node, int value ) {
@@ -244,7 +241,7 @@ namespace columbus { namespace lim { namespace metrics {
     if ( enabled && isCalculatedFor(node) ) {
       node.addMetric( name, value );
     } else {
-      WriteMsg::write( CMSG_LIMMETRICS_DISABLED_METRIC, name.c_str() );
+      node.reportDisabledMetric( name );
     }
   }
 
@@ -255,7 +252,7 @@ namespace columbus { namespace lim { namespace metrics {
     if ( enabled && isCalculatedFor(node) ) {
       node.addMetric( name, (float)value );
     } else {
-      WriteMsg::write( CMSG_LIMMETRICS_DISABLED_METRIC, name.c_str() );
+      node.reportDisabledMetric( name );
     }
   }
 
@@ -263,7 +260,7 @@ namespace columbus { namespace lim { namespace metrics {
     this->registerHandler( phase, level, lang, false, [this]( NodeWrapper& node ) {
       const base::Base* ptr = &node.getLimNode<base::Base>();
       Info& info = this->shared->scopes.map[ptr];
-      addMetric( node, info.ints[this->name] );
+      addMetric( node, info.ints[this->slot] );
     });
   }
 
@@ -271,7 +268,7 @@ namespace columbus { namespace lim { namespace metrics {
     registerHandler( phaseFinalize, NTYPE_LIM_COMPONENT, limLangOther, false, [this] ( NodeWrapper& node ) {
       const base::Base* ptr = &node.getLimNode<base::Base>();
       Info& info = this->shared->components.map[ptr];
-      addMetric( node, info.ints[this->name] );
+      addMetric( node, info.ints[this->slot] );
     });
   }
 
@@ -279,7 +276,7 @@ namespace columbus { namespace lim { namespace metrics {
     this->registerHandler( phase, level, lang, false, [this]( NodeWrapper& node ) {
       const base::Base* ptr = &node.getLimNode<base::Base>();
       Info& info = this->shared->scopes.map[ptr];
-      addMetric( node, (int) info.sets[this->name].size() );
+      addMetric( node, (int) info.sets[this->slot].size() );
     });
   }
 
@@ -287,7 +284,7 @@ namespace columbus { namespace lim { namespace metrics {
     registerHandler( phaseFinalize, NTYPE_LIM_COMPONENT, limLangOther, false, [this] ( NodeWrapper& node ) {
       const base::Base* ptr = &node.getLimNode<base::Base>();
       Info& info = this->shared->components.map[ptr];
-      addMetric( node, (int) info.sets[this->name].size() );
+      addMetric( node, (int) info.sets[this->slot].size() );
     });
   }
 
@@ -295,7 +292,7 @@ namespace columbus { namespace lim { namespace metrics {
     this->registerHandler( phase, level, lang, false, [this]( NodeWrapper& node ) {
       const base::Base* ptr = &node.getLimNode<base::Base>();
       Info& info = this->shared->scopes.map[ptr];
-      addMetric( node, info.mapCount( this->name ) );
+      addMetric( node, info.mapCount( this->slot ) );
     });
   }
 
@@ -303,7 +300,7 @@ namespace columbus { namespace lim { namespace metrics {
     registerHandler( phaseFinalize, NTYPE_LIM_COMPONENT, limLangOther, false, [this] ( NodeWrapper& node ) {
       const base::Base* ptr = &node.getLimNode<base::Base>();
       Info& info = this->shared->components.map[ptr];
-      addMetric( node, info.mapCount( this->name ) );
+      addMetric( node, info.mapCount( this->slot ) );
     });
   }
 
@@ -325,9 +322,10 @@ namespace columbus { namespace lim { namespace metrics {
       }
 
       if ( info ) {
-        info->ints.erase( name );
-        info->sets.erase( name );
-        info->maps.erase( name );
+        MetricSlots::Slot slot = MetricSlots::get( name );
+        info->ints.erase( slot );
+        info->sets.erase( slot );
+        info->maps.erase( slot );
       }
 
     }
@@ -335,7 +333,7 @@ namespace columbus { namespace lim { namespace metrics {
   }
 
   bool MetricHandler::isCalculatedFor( NodeWrapper& node ) {
-    return calc.find( node.getLevel() ) != calc.end();
+    return calcLevels[node.getLevelKind()];
   }
 
 }}}
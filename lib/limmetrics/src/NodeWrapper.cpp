@@ -26,64 +26,125 @@
 #include "lim2graph/inc/VisitorGraphConverter.h"
 
 using namespace std;
+using namespace common;
 using namespace columbus::lim::asg;
 using namespace columbus::graph;
 using namespace columbus::graphsupport::graphconstants;
 
 namespace columbus { namespace lim { namespace metrics {
 
-  NodeWrapper::NodeWrapper( const base::Base& limNode, Graph& graph ) : limNode( &limNode ), graph( &graph ) {
+  //
+  // METRIC BUFFER
+  //
+
+  MetricBuffer::MetricBuffer() : records(), cursor( 0 ), visit( 0 ), entry( 0 ) {}
+
+  void MetricBuffer::select( unsigned int visit, unsigned int entry ) {
+    this->visit = visit;
+    this->entry = entry;
+  }
+
+  void MetricBuffer::add( const std::string& metric, int value ) {
+    record( rkInt, metric, value, 0 );
+  }
+
+  void MetricBuffer::add( const std::string& metric, float value ) {
+    record( rkFloat, metric, 0, value );
+  }
+
+  void MetricBuffer::addDisabled( const std::string& metric ) {
+    record( rkDisabled, metric, 0, 0 );
+  }
+
+  void MetricBuffer::record( RecordKind kind, const std::string& metric, int intValue, float floatValue ) {
+    Record r;
+    r.visit = visit;
+    r.entry = entry;
+    r.kind = kind;
+    r.metric = metric;
+    r.intValue = intValue;
+    r.floatValue = floatValue;
+    records.push_back( r );
+  }
+
+  void MetricBuffer::replay( unsigned int visit, unsigned int entry, NodeWrapper& target ) {
+    for ( ; cursor < records.size() && records[cursor].visit == visit && records[cursor].entry == entry; ++cursor ) {
+      const Record& r = records[cursor];
+      switch ( r.kind ) {
+        case rkInt: target.addMetric( r.metric, r.intValue ); break;
+        case rkFloat: target.addMetric( r.metric, r.floatValue ); break;
+        case rkDisabled: target.reportDisabledMetric( r.metric ); break;
+      }
+    }
+  }
+
+  void MetricBuffer::clear() {
+    records.clear();
+    cursor = 0;
+  }
+
+  //
+  // NODE WRAPPER
+  //
+
+  NodeWrapper::NodeWrapper( const base::Base& limNode, Graph& graph ) : limNode( &limNode ), graph( &graph ), buffer( NULL ) {
     graphNode = graph.findNode( lim2graph::VisitorGraphConverter::determineNodeName( limNode ) );
     if ( this->graphNode == graph::Graph::invalidNode ) {
       throw Exception( COLUMBUS_LOCATION, CMSG_LIMMETRICS_EX_INVALID_GRAPH_NODE( Common::toString( limNode.getId() ) ) );
     }
   }
 
+  NodeWrapper::NodeWrapper( const base::Base& limNode, MetricBuffer* buffer ) : limNode( &limNode ), graph( NULL ), buffer( buffer ) {}
+
   const Node& NodeWrapper::getGraphNode() const {
     return graphNode;
   }
 
   const std::string& NodeWrapper::getLevel() const {
+    return toLevel( getLevelKind() );
+  }
+
+  NodeLevel NodeWrapper::getLevelKind() const {
 
     Language lang = getLanguage();
 
     if ( Common::getIsClass( *limNode ) ) {
       switch ( dynamic_cast<const logical::Class&>(*limNode).getClassKind() ) {
-        case clkAnnotation: return NTYPE_LIM_ANNOTATION;
-        case clkEnum: return NTYPE_LIM_ENUM;
-        case clkInterface: return NTYPE_LIM_INTERFACE;
-        case clkStruct: return NTYPE_LIM_STRUCTURE;
-        case clkUnion: return NTYPE_LIM_UNION;
+        case clkAnnotation: return nlAnnotation;
+        case clkEnum: return nlEnum;
+        case clkInterface: return nlInterface;
+        case clkStruct: return nlStructure;
+        case clkUnion: return nlUnion;
 
         case clkClass:
         default:
-          return NTYPE_LIM_CLASS;
+          return nlClass;
       }
 
     } else if ( Common::getIsMethod( *limNode ) ) {
 
-      if ( isFunction() ) return NTYPE_LIM_FUNCTION;
-      return NTYPE_LIM_METHOD;
+      if ( isFunction() ) return nlFunction;
+      return nlMethod;
 
     } else if ( Common::getIsAttribute( *limNode ) ) {
-      return NTYPE_LIM_ATTRIBUTE;
+      return nlAttribute;
 
     } else if ( Common::getIsPackage( *limNode ) ) {
 
-      if ( lang == limLangCpp || lang == limLangC || lang == limLangCsharp ) return NTYPE_LIM_NAMESPACE;
+      if ( lang == limLangCpp || lang == limLangC || lang == limLangCsharp ) return nlNamespace;
       if ( lang == limLangPython && dynamic_cast<const logical::Package&>( *limNode ).getPackageKind() == pkModule ) {
-        return NTYPE_LIM_MODULE;
+        return nlModule;
       }
-      return NTYPE_LIM_PACKAGE;
+      return nlPackage;
 
     } else if ( Common::getIsFile( *limNode ) ) {
-      return NTYPE_LIM_FILE;
+      return nlFile;
 
     } else if ( Common::getIsComponent( *limNode ) ) {
-      return NTYPE_LIM_COMPONENT;
+      return nlComponent;
     }
 
-    return NTYPE_LIM_ROOT;
+    return nlRoot;
   }
 
   Language NodeWrapper::lnk2limLang( LanguageKind kind ) {
@@ -121,6 +182,10 @@ namespace columbus { namespace lim { namespace metrics {
 
   void NodeWrapper::addMetric( const std::string& metric, int value ) {
     //cout << "  " << limNode->getId() << "(" << Common::to_string(limNode->getNodeKind()) << ") --> " << metric << "= " << value << endl;
+    if ( buffer ) {
+      buffer->add( metric, value );
+      return;
+    }
     graph::Attribute::AttributeIterator aIt = graphNode.findAttributeByName( metric );
     if ( aIt.hasNext() ) {
       ((graph::AttributeInt&)aIt.next()).incValue( value );
@@ -131,6 +196,10 @@ namespace columbus { namespace lim { namespace metrics {
 
   void NodeWrapper::addMetric( const std::string& metric, float value ) {
     //cout << "  " << limNode->getId() << "(" << Common::to_string(limNode->getNodeKind()) << ") --> " << metric << "= " << value << endl;
+    if ( buffer ) {
+      buffer->add( metric, value );
+      return;
+    }
     graph::Attribute::AttributeIterator aIt = graphNode.findAttributeByName( metric );
     if ( aIt.hasNext() ) {
       ((graph::AttributeFloat&)aIt.next()).incValue( value );
@@ -139,7 +208,18 @@ namespace columbus { namespace lim { namespace metrics {
     }
   }
 
+  void NodeWrapper::reportDisabledMetric( const std::string& metric ) {
+    if ( buffer ) {
+      buffer->addDisabled( metric );
+    } else {
+      WriteMsg::write( CMSG_LIMMETRICS_DISABLED_METRIC, metric.c_str() );
+    }
+  }
+
   int NodeWrapper::getIntMetric(const std::string& metric) {
+    if (buffer) {
+      throw Exception(COLUMBUS_LOCATION, CMSG_LIMMETRICS_EX_BUFFERED_METRIC_READ(metric));
+    }
     graph::Attribute::AttributeIterator aIt = graphNode.findAttributeByName(metric);
     if (aIt.hasNext()) {
       return ((graph::AttributeInt&)aIt.next()).getValue();
@@ -150,6 +230,9 @@ namespace columbus { namespace lim { namespace metrics {
   }
 
   float NodeWrapper::getFloatMetric(const std::string& metric) {
+    if (buffer) {
+      throw Exception(COLUMBUS_LOCATION, CMSG_LIMMETRICS_EX_BUFFERED_METRIC_READ(metric));
+    }
     graph::Attribute::AttributeIterator aIt = graphNode.findAttributeByName(metric);
     if (aIt.hasNext()) {
       return ((graph::AttributeFloat&)aIt.next()).getValue();
@@ -191,6 +274,53 @@ namespace columbus { namespace lim { namespace metrics {
     return Common::getIsAttribute( node ) && ! isParentClass( node );
   }
 
+  NodeLevel NodeWrapper::toLevelKind( const std::string& level ) {
+    static const std::map<std::string, NodeLevel> levels = {
+      { NTYPE_LIM_ROOT, nlRoot },
+      { NTYPE_LIM_COMPONENT, nlComponent },
+      { NTYPE_LIM_PACKAGE, nlPackage },
+      { NTYPE_LIM_NAMESPACE, nlNamespace },
+      { NTYPE_LIM_MODULE, nlModule },
+      { NTYPE_LIM_CLASS, nlClass },
+      { NTYPE_LIM_STRUCTURE, nlStructure },
+      { NTYPE_LIM_UNION, nlUnion },
+      { NTYPE_LIM_INTERFACE, nlInterface },
+      { NTYPE_LIM_ENUM, nlEnum },
+      { NTYPE_LIM_ANNOTATION, nlAnnotation },
+      { NTYPE_LIM_METHOD, nlMethod },
+      { NTYPE_LIM_FUNCTION, nlFunction },
+      { NTYPE_LIM_ATTRIBUTE, nlAttribute },
+      { NTYPE_LIM_FILE, nlFile }
+    };
+
+    std::map<std::string, NodeLevel>::const_iterator it = levels.find( level );
+    return it != levels.end() ? it->second : nlUnknown;
+  }
+
+  const std::string& NodeWrapper::toLevel( NodeLevel level ) {
+    static const std::string unknown;
+
+    switch ( level ) {
+      case nlRoot: return NTYPE_LIM_ROOT;
+      case nlComponent: return NTYPE_LIM_COMPONENT;
+      case nlPackage: return NTYPE_LIM_PACKAGE;
+      case nlNamespace: return NTYPE_LIM_NAMESPACE;
+      case nlModule: return NTYPE_LIM_MODULE;
+      case nlClass: return NTYPE_LIM_CLASS;
+      case nlStructure: return NTYPE_LIM_STRUCTURE;
+      case nlUnion: return NTYPE_LIM_UNION;
+      case nlInterface: return NTYPE_LIM_INTERFACE;
+      case nlEnum: return NTYPE_LIM_ENUM;
+      case nlAnnotation: return NTYPE_LIM_ANNOTATION;
+      case nlMethod: return NTYPE_LIM_METHOD;
+      case nlFunction: return NTYPE_LIM_FUNCTION;
+      case nlAttribute: return NTYPE_LIM_ATTRIBUTE;
+      case nlFile: return NTYPE_LIM_FILE;
+      default: break;
+    }
+    return unknown;
+  }
+
   bool NodeWrapper::isParentClass( const asg::base::Base& node ) {
     ListIterator<base::Base> it = node.getFactory().getReverseEdges().constIteratorBegin( node.getId(), edkScope_HasMember );
     if ( it != node.getFactory().getReverseEdges().constIteratorEnd( node.getId(), edkScope_HasMember ) ) {
@@ -49,14 +49,16 @@
 #define MATCH_SHARED( name ) if ( id == #name ) return new name( enabled, &shared );
 
 using namespace std;
+using namespace common;
 using namespace columbus::rul;
 using namespace columbus::lim::asg;
 
 namespace columbus { namespace lim { namespace metrics {
 
-  RulParser::RulParser( RulHandler& rul, SharedContainers& shared) : rul( rul ), shared( shared ) {
+  RulParser::RulParser( RulHandler& rul, SharedContainers& shared, bool verbose ) : rul( rul ), shared( shared ), verbose( verbose ) {
     parse();
     sort();
+    compile();
   }
 
   RulParser::~RulParser() {
@@ -88,6 +90,10 @@ namespace columbus { namespace lim { namespace metrics {
         string id = *metricsIt;
         bool enabled = rul.getIsEnabled( id );
         handlerMap[id] = matchHandler( id, enabled );
+        // the default handler of the unknown metrics is not reported
+        if ( verbose && handlerMap[id]->getName() == id ) {
+          WriteMsg::write( CMSG_LIMMETRICS_HANDLER_CREATED, id.c_str() );
+        }
         handlerMap[id]->setCalculatedFor( rul.getCalculatedForSet(id) );
         if ( enabled ) {
           queue.push_back( id );
@@ -303,15 +309,110 @@ namespace columbus { namespace lim { namespace metrics {
     } while ( orderSize != handlerOrder.size() );
   }
 
+  void RulParser::compile() {
+
+    dispatchTable.assign( DISPATCH_TABLE_SIZE, vector<DispatchEntry>() );
+
+    // a handler can only run in parallel if every metric it depends on does
+    map<string, bool> parallel;
+    vector<string>::const_iterator handlerIt = handlerOrder.begin(), handlerEnd = handlerOrder.end();
+    for ( ; handlerIt != handlerEnd; ++handlerIt ) {
+      MetricHandler* handler = handlerMap[*handlerIt];
+      bool isParallel = handler->getIsParallel();
+      const set<string>& dependencies = handler->getDependencies();
+      for ( set<string>::const_iterator dIt = dependencies.begin(); isParallel && dIt != dependencies.end(); ++dIt ) {
+        isParallel = parallel[*dIt];
+      }
+      parallel[*handlerIt] = isParallel;
+    }
+
+    // the handlers without a function are only kept in the cells for the CMSG_LIMMETRICS_NO_DISPATCH messages
+    bool reportNoDispatch = WriteMsg::getMessageLevel() >= WriteMsg::mlDDebug;
+
+    for ( unsigned int phase = 0; phase < DISPATCH_PHASE_COUNT; ++phase ) {
+      for ( unsigned int level = 0; level < DISPATCH_LEVEL_COUNT; ++level ) {
+        for ( unsigned int lang = 0; lang < DISPATCH_LANGUAGE_COUNT; ++lang ) {
+          for ( unsigned int variant = 0; variant < 2; ++variant ) {
+
+            unsigned int key = MetricHandler::dispatchKey( (DispatchPhases) phase, (NodeLevel) level, (Language) lang, variant == 1 );
+            vector<DispatchEntry>& cell = dispatchTable[key];
+
+            vector<string>::const_iterator orderIt = handlerOrder.begin(), orderEnd = handlerOrder.end();
+            for ( ; orderIt != orderEnd; ++orderIt ) {
+              MetricHandler* handler = handlerMap[*orderIt];
+              const HandlerFunction* function = handler->resolve( (DispatchPhases) phase, (NodeLevel) level, (Language) lang, variant == 1 );
+              if ( function != NULL || reportNoDispatch ) {
+                DispatchEntry entry = { handler, function, function != NULL && parallel[*orderIt] };
+                cell.push_back( entry );
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
   void RulParser::dispatch( DispatchPhases phase, NodeWrapper& node ) {
 
     if ( phase == phaseVisit ) {
       stack( node, true ); // push
     }
 
-    vector<string>::iterator orderIt = handlerOrder.begin(), orderEnd = handlerOrder.end();
-    for ( ; orderIt != orderEnd; ++orderIt ) {
-      handlerMap[*orderIt]->dispatch( phase, node );
+    const vector<DispatchEntry>& cell = dispatchTable[MetricHandler::dispatchKey( phase, node.getLevelKind(), node.getLanguage(), node.getIsVariant() )];
+    vector<DispatchEntry>::const_iterator entryIt = cell.begin(), entryEnd = cell.end();
+    for ( ; entryIt != entryEnd; ++entryIt ) {
+      if ( entryIt->function != NULL ) {
+        WriteMsg::write( CMSG_LIMMETRICS_DISPATCH, entryIt->handler->getName().c_str(), node.getLimNode<base::Base>().getId(), phase );
+        (*entryIt->function)( node );
+      } else {
+        WriteMsg::write( CMSG_LIMMETRICS_NO_DISPATCH, entryIt->handler->getName().c_str(), node.getLimNode<base::Base>().getId(), phase );
+      }
+    }
+
+    if ( phase == phaseVisitEnd ) {
+      stack( node, false ); // pop
+    }
+
+  }
+
+  void RulParser::dispatchParallel( DispatchPhases phase, NodeWrapper& node, unsigned int visit, MetricBuffer& buffer ) {
+
+    if ( phase == phaseVisit ) {
+      stack( node, true ); // push
+    }
+
+    const vector<DispatchEntry>& cell = dispatchTable[MetricHandler::dispatchKey( phase, node.getLevelKind(), node.getLanguage(), node.getIsVariant() )];
+    for ( unsigned int entry = 0; entry < cell.size(); ++entry ) {
+      if ( cell[entry].parallel ) {
+        buffer.select( visit, entry );
+        (*cell[entry].function)( node );
+      }
+    }
+
+    if ( phase == phaseVisitEnd ) {
+      stack( node, false ); // pop
+    }
+
+  }
+
+  void RulParser::dispatchRecorded( DispatchPhases phase, NodeWrapper& node, unsigned int visit, MetricBuffer& buffer ) {
+
+    if ( phase == phaseVisit ) {
+      stack( node, true ); // push
+    }
+
+    const vector<DispatchEntry>& cell = dispatchTable[MetricHandler::dispatchKey( phase, node.getLevelKind(), node.getLanguage(), node.getIsVariant() )];
+    for ( unsigned int entry = 0; entry < cell.size(); ++entry ) {
+      if ( cell[entry].function == NULL ) {
+        WriteMsg::write( CMSG_LIMMETRICS_NO_DISPATCH, cell[entry].handler->getName().c_str(), node.getLimNode<base::Base>().getId(), phase );
+        continue;
+      }
+      WriteMsg::write( CMSG_LIMMETRICS_DISPATCH, cell[entry].handler->getName().c_str(), node.getLimNode<base::Base>().getId(), phase );
+      if ( cell[entry].parallel ) {
+        buffer.replay( visit, entry, node );
+      } else {
+        (*cell[entry].function)( node );
+      }
     }
 
     if ( phase == phaseVisitEnd ) {
@@ -324,6 +425,16 @@ namespace columbus { namespace lim { namespace metrics {
     shared.phaseOver( phase );
   }
 
+  bool RulParser::getUsesHierarchyIndex() const {
+    map<string, MetricHandler*>::const_iterator i = handlerMap.begin(), end = handlerMap.end();
+    for ( ; i != end; ++i ) {
+      if ( i->second->getIsOn() && i->second->getUsesHierarchyIndex() ) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   /*
   * Stack maintenance + child relations among scopes for correct aggregation
   * Besides getting pushed to the scope stack, the following happens to each scope type 
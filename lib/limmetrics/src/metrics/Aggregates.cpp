@@ -77,6 +77,9 @@ namespace columbus {
         dependencies.insert("LLOC");
         dependencies.insert("CD");
 
+        // the values of the dependencies are read back from the graph
+        parallel = false;
+
         this->registerHandler(phaseVisitEnd, NTYPE_LIM_METHOD, limLangOther, false, [this](NodeWrapper& node) {
 
           double hvol = node.getFloatMetric("HVOL");
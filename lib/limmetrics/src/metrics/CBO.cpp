@@ -169,7 +169,7 @@ namespace columbus { namespace lim { namespace metrics {
       addMetric( node, cboNum );
 
       // propagate to package level
-      this->shared->currentPackageInfo().ints[this->name] += cboNum;
+      this->shared->currentPackageInfo().ints[this->slot] += cboNum;
 
       cleanup( node );
 
@@ -322,7 +322,7 @@ namespace columbus { namespace lim { namespace metrics {
 
       const logical::Class& clazz = node.getLimNode<logical::Class>();
       Info& info = this->shared->scopes.map[ &clazz ];
-      addMetric( node, (int) info.sets[this->name].size() );
+      addMetric( node, (int) info.sets[this->slot].size() );
       
       cleanup( node );
       
@@ -73,7 +73,7 @@ namespace columbus { namespace lim { namespace metrics {
         this->mapComments(method, this->shared->components.map[&(*i)]);
       }
 
-      addMetric( node, this->shared->currentMethodInfo().mapCount(this->name) );
+      addMetric( node, this->shared->currentMethodInfo().mapCount( this->slot ) );
 
     });
 
@@ -103,7 +103,7 @@ namespace columbus { namespace lim { namespace metrics {
         this->mapComments(clazz, this->shared->components.map[&(*i)]);
       }
 
-      addMetric( node, this->shared->currentClassInfo().mapCount(this->name) );
+      addMetric( node, this->shared->currentClassInfo().mapCount( this->slot ) );
 
     });
 
@@ -127,7 +127,7 @@ namespace columbus { namespace lim { namespace metrics {
   void DLOC::mapComments(const logical::Member& node, Info& info) const {
       ListIterator<base::Comment> commentIt = node.getCommentListIteratorBegin();
       for (; commentIt != node.getCommentListIteratorEnd(); ++commentIt) {
-          info.maps[this->name][commentIt->getId()] = getNumberOfEndLines(commentIt->getText());
+          info.maps[this->slot][commentIt->getId()] = getNumberOfEndLines(commentIt->getText());
       }
   }
 
@@ -169,16 +169,16 @@ namespace columbus { namespace lim { namespace metrics {
 
       // propagate the commentLines part only
       if (!this->shared->classStack.empty()) {
-        this->shared->currentClassInfo().ints[this->name] += mcl;
+        this->shared->currentClassInfo().ints[this->slot] += mcl;
       }
-      this->shared->currentPackageInfo().ints[this->name] += mcl;
+      this->shared->currentPackageInfo().ints[this->slot] += mcl;
 
       ListIterator<base::Component> i = method.getBelongsToListIteratorBegin(), end = method.getBelongsToListIteratorEnd();
       for (; i != end; ++i) {
-        this->shared->components.map[&(*i)].ints[this->name] += mcl;
+        this->shared->components.map[&(*i)].ints[this->slot] += mcl;
       }
 
-      int cloc = info.ints[this->name] = info.mapCount("DLOC") + mcl;
+      int cloc = info.ints[this->slot] = info.mapCount("DLOC") + mcl;
       addMetric(node, cloc);
 
       cleanup( node, "DLOC" );
@@ -190,14 +190,14 @@ namespace columbus { namespace lim { namespace metrics {
       const logical::Attribute& attr = node.getLimNode<logical::Attribute>();
       int acl = attr.getCommentLines();
       if ( ! this->shared->classStack.empty() ) {
-        this->shared->currentClassInfo().ints[this->name] += acl;
+        this->shared->currentClassInfo().ints[this->slot] += acl;
       }
-      this->shared->currentPackageInfo().ints[this->name] += acl;
+      this->shared->currentPackageInfo().ints[this->slot] += acl;
 
       // propagate to component level, like above
       ListIterator<base::Component> i = attr.getBelongsToListIteratorBegin(), end = attr.getBelongsToListIteratorEnd();
       for (; i != end; ++i) {
-        this->shared->components.map[&(*i)].ints[this->name] += acl;
+        this->shared->components.map[&(*i)].ints[this->slot] += acl;
       }
 
     });
@@ -209,15 +209,15 @@ namespace columbus { namespace lim { namespace metrics {
       int ccl = clazz.getCommentLines();
 
       // propagate to package level
-      this->shared->currentPackageInfo().ints[this->name] += ccl;
+      this->shared->currentPackageInfo().ints[this->slot] += ccl;
 
       // propagate to component level
       ListIterator<base::Component> i = clazz.getBelongsToListIteratorBegin(), end = clazz.getBelongsToListIteratorEnd();
       for (; i != end; ++i) {
-        this->shared->components.map[&(*i)].ints[this->name] += ccl;
+        this->shared->components.map[&(*i)].ints[this->slot] += ccl;
       }
 
-      int cloc = (info.ints[this->name] += info.mapCount("DLOC") + ccl);
+      int cloc = (info.ints[this->slot] += info.mapCount("DLOC") + ccl);
       addMetric(node, cloc);
 
       cleanup( node, "DLOC" );
@@ -233,10 +233,10 @@ namespace columbus { namespace lim { namespace metrics {
       // propagate to component level
       ListIterator<base::Component> i = package.getBelongsToListIteratorBegin(), end = package.getBelongsToListIteratorEnd();
       for (; i != end; ++i) {
-        this->shared->components.map[&(*i)].ints[this->name] += pcl;
+        this->shared->components.map[&(*i)].ints[this->slot] += pcl;
       }
 
-      int cloc = ( info.ints[this->name] += info.mapCount("DLOC") + pcl );
+      int cloc = ( info.ints[this->slot] += info.mapCount("DLOC") + pcl );
       addMetric( node, cloc );
       
     });
@@ -256,7 +256,7 @@ namespace columbus { namespace lim { namespace metrics {
     this->registerHandler(phaseVisitEnd, NTYPE_LIM_COMPONENT, limLangOther, false, [this](NodeWrapper& node) {
       const base::Base* ptr = &node.getLimNode<base::Base>();
       Info& info = this->shared->components.map[ptr];
-      info.ints[this->name] += info.mapCount("DLOC");
+      info.ints[this->slot] += info.mapCount("DLOC");
     });
 
   }
@@ -316,13 +316,16 @@ namespace columbus { namespace lim { namespace metrics {
 
   // (T)PDA
 
-  const string PUBLIC = "PUBLIC";
-  const string TOTAL_PUBLIC = "T" + PUBLIC;
-  const string PUBLIC_DOC = "PDA";
-  const string TOTAL_PUBLIC_DOC = "T" + PUBLIC_DOC;
+  const MetricSlots::Slot PUBLIC = MetricSlots::get( "PUBLIC" );
+  const MetricSlots::Slot TOTAL_PUBLIC = MetricSlots::total( PUBLIC );
+  const MetricSlots::Slot PUBLIC_DOC = MetricSlots::get( "PDA" );
+  const MetricSlots::Slot TOTAL_PUBLIC_DOC = MetricSlots::total( PUBLIC_DOC );
 
   PDA::PDA( bool enabled, SharedContainers* shared ) : DocBase( "PDA", mdtInt, enabled, shared ) {
 
+    // the resolved scopes are cached by mangled names in the visit order
+    parallel = false;
+
     registerHandler( phaseVisit, NTYPE_LIM_METHOD, limLangOther, false, [this] ( NodeWrapper& node ) {
       process( node );
     });
@@ -348,7 +351,7 @@ namespace columbus { namespace lim { namespace metrics {
 
     registerHandler( phaseFinishVisit, NTYPE_LIM_FILE, limLangOther, false, [this] ( NodeWrapper& node ) {
       const physical::File& file = node.getLimNode<const physical::File&>();
-      addMetric( node, (int) this->shared->files[&file].sets[this->name].size() );
+      addMetric( node, (int) this->shared->files[&file].sets[this->slot].size() );
     });
 
   }
@@ -636,12 +639,12 @@ namespace columbus { namespace lim { namespace metrics {
       dependencies.insert( "TCLOC" );
       scopeLLOC = &logical::Scope::getTLLOC;
       componentLLOC = &base::Component::getTLLOC;
-      CLOC = "TCLOC";
+      CLOC = MetricSlots::get( "TCLOC" );
     } else {
       dependencies.insert( "LLOC" );
       dependencies.insert( "CLOC" );
       scopeLLOC = &logical::Scope::getLLOC;
-      CLOC = "CLOC";
+      CLOC = MetricSlots::get( "CLOC" );
     }
 
     registerHandler( ( total ? phaseFinalize : phaseVisitEnd ), NTYPE_LIM_METHOD, limLangOther, false, [this] ( NodeWrapper& node ) {
@@ -50,10 +50,9 @@ namespace columbus { namespace lim { namespace metrics {
   }
 
   NOA::NOA( bool enabled, SharedContainers* shared ) : InheritanceBase( "NOA", mdtInt, enabled, shared ) {
+    hierarchyIndexed = true;
     registerHandler( phaseVisit, NTYPE_LIM_CLASS, limLangOther, false, [this]( NodeWrapper& node ) {
-      set<const logical::Class*> s;
-      this->shared->inheritance->collectAncestors( node.getLimNode<logical::Class>(), s );
-      addMetric( node, (int) s.size() );
+      addMetric( node, this->shared->inheritance->getNumberOfAncestors( node.getLimNode<logical::Class>() ) );
     });
   }
 
@@ -66,18 +65,16 @@ namespace columbus { namespace lim { namespace metrics {
   }
 
   NOD::NOD( bool enabled, SharedContainers* shared ) : InheritanceBase( "NOD", mdtInt, enabled, shared ) {
+    hierarchyIndexed = true;
     registerHandler( phaseVisit, NTYPE_LIM_CLASS, limLangOther, false, [this]( NodeWrapper& node ) {
-      set<const logical::Class*> s;
-      this->shared->inheritance->collectDescendants( node.getLimNode<logical::Class>(), s );
-      addMetric( node, (int) s.size() );
+      addMetric( node, this->shared->inheritance->getNumberOfDescendants( node.getLimNode<logical::Class>() ) );
     });
   }
 
   DIT::DIT( bool enabled, SharedContainers* shared ) : InheritanceBase( "DIT", mdtInt, enabled, shared ) {
+    hierarchyIndexed = true;
     registerHandler( phaseVisit, NTYPE_LIM_CLASS, limLangOther, false, [this]( NodeWrapper& node ) {
-      set<const logical::Class*> s;
-      // no performance loss from calling collectAncestors twice because it is already cached
-      int dit = this->shared->inheritance->collectAncestors( node.getLimNode<logical::Class>(), s );
+      int dit = this->shared->inheritance->getDepth( node.getLimNode<logical::Class>() );
       addMetric( node, dit - 1 );
     });
   }
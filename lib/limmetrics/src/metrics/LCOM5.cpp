@@ -20,6 +20,10 @@
 
 #include "../../inc/metrics/LCOM5.h"
 
+#include <queue>
+
+#include <boost/unordered_map.hpp>
+
 using namespace std;
 using namespace columbus::lim::asg;
 using namespace columbus::graphsupport::graphconstants;
@@ -27,6 +31,7 @@ using namespace columbus::graphsupport::graphconstants;
 namespace columbus { namespace lim { namespace metrics {
 
   LCOM5::LCOM5( bool enabled, SharedContainers* shared ) : MetricHandler( "LCOM5", mdtInt, enabled, shared ) {
+    hierarchyIndexed = true;
 
     registerHandler( phaseVisit, NTYPE_LIM_CLASS, limLangOther, false, [this] ( NodeWrapper& node ) {
 
@@ -34,11 +39,13 @@ namespace columbus { namespace lim { namespace metrics {
       set<const logical::Class*> parentClasses;
       parentClasses.insert( &clazz );
       if ( ! clazz.getIsSubclassIsEmpty() ) {
-        Common::collectAncestors( this->shared->factory->getReverseEdges(), clazz, parentClasses );
+        const ClassHierarchyIndex* index = this->shared->inheritance ? this->shared->inheritance->getIndex() : NULL;
+        if ( ! index || ! index->collectAncestors( clazz, parentClasses ) ) {
+          Common::collectAncestors( this->shared->factory->getReverseEdges(), clazz, parentClasses );
+        }
       }
 
       vector<ConnectedComponentElement> connectedComponents;
-      connectedComponents.reserve( 1000 );
 
       ListIterator<logical::Member> memberIt = clazz.getMemberListIteratorBegin(),
                                     memberEnd = clazz.getMemberListIteratorEnd();
@@ -48,7 +55,7 @@ namespace columbus { namespace lim { namespace metrics {
           const logical::Method& method = dynamic_cast<const logical::Method&>( *memberIt );
           if ( NodeWrapper::isDefinition( method ) ) {
             if ( !method.getIsAbstract() ) {
-              connectedComponents.push_back( ConnectedComponentElement( &method ) );
+              connectedComponents.push_back( ConnectedComponentElement( &method, (unsigned int) connectedComponents.size() ) );
 
               ListIterator<logical::AttributeAccess>  accessIt = method.getAccessesAttributeListIteratorBegin(),
                                                       accessEnd = method.getAccessesAttributeListIteratorEnd();
@@ -78,7 +85,7 @@ namespace columbus { namespace lim { namespace metrics {
       addMetric( node, lcom );
 
       // propagate to package level
-      this->shared->currentPackageInfo().ints[this->name] += lcom;
+      this->shared->currentPackageInfo().ints[this->slot] += lcom;
 
     });
 
@@ -104,242 +111,401 @@ namespace columbus { namespace lim { namespace metrics {
   }
 
 
-  ConnectedComponentElement* LCOM5::getConnectedComponentRootElement( ConnectedComponentElement* element ) const {
-    ConnectedComponentElement* ccelement = element;
-    if(element->nextElement != NULL && element->nextElement != element)
-      ccelement = getConnectedComponentRootElement(element->nextElement);
-    
-    return ccelement;
-  }
+  namespace {
 
-  int LCOM5::calculateConnectedComponents( const asg::logical::Class& actClass, vector<ConnectedComponentElement>& connectedComponents, const set<const logical::Class*>& parentClasses ) {
+    const unsigned int NO_ELEMENT = (unsigned int) -1;
 
-    NodeId actClassId = actClass.getId();
+    /**
+    * Returns the class of a member (its aggregated class if there is one) or NULL if it is not a class member
+    */
+    const logical::Class* getClassOfMember( const ReverseEdges& revEdges, NodeId id ) {
+      ListIterator<base::Base> it = revEdges.constIteratorBegin( id, edkScope_HasMember );
+      if ( it != revEdges.constIteratorEnd( id, edkScope_HasMember ) && Common::getIsClass( *it ) ) {
+        const logical::Class* clazz = (const logical::Class*)( &(*it) );
+        if ( clazz->getAggregated() != NULL )
+          clazz = (const logical::Class*)( clazz->getAggregated() );
+        return clazz;
+      }
+      return NULL;
+    }
 
-    const size_t connectedComponentsSize = connectedComponents.size();
-    const asg::ReverseEdges& revEdges = shared->factory->getReverseEdges();
-    
-    for(unsigned int i = 0; i < connectedComponentsSize; ++i){
-      ConnectedComponentElement& actualElement = connectedComponents[i];
-      const logical::Method &actualMethod = *actualElement.method;
+    /**
+    * The union of two sets of the joined components (the smaller one is inserted into the larger one)
+    */
+    template<class T> void mergeSets( set<T>& target, set<T>& source ) {
+      if ( target.size() < source.size() ) {
+        target.swap( source );
+      }
+      target.insert( source.begin(), source.end() );
+    }
 
-      if(!actualMethod.getCallsIsEmpty()){
-        ListIterator<logical::MethodCall> actualmethodCallIt = actualMethod.getCallsListIteratorBegin();
-        for (; actualmethodCallIt != actualMethod.getCallsListIteratorEnd(); ++actualmethodCallIt) {
-          const logical::Method* actualCalledMethod = actualmethodCallIt->getMethod();
+    /**
+    * The components of the elements
+    * The links between the elements (the next elements) are kept exactly as they are made, because they decide
+    * which element is the root of a component and which components are ignored. The roots are looked up through
+    * a union-find structure with path compression and union by rank instead of walking the links.
+    */
+    class ComponentForest {
+
+      public:
+
+        ComponentForest( vector<ConnectedComponentElement>& elements ) :
+          elements( elements ),
+          parent( elements.size() ),
+          rank( elements.size(), 0 ),
+          top( elements.size() )
+        {
+          for ( unsigned int e = 0; e < elements.size(); ++e ) {
+            parent[e] = e;
+            top[e] = e;
+          }
+        }
 
-          for (unsigned int j = 0; j < connectedComponentsSize; ++j) {
+        bool isRoot( unsigned int e ) const {
+          return elements[e].nextElement == e;
+        }
 
-            if(i != j){     //onmagaval nem vizsgaljuk
-              ConnectedComponentElement& elementInComponent = connectedComponents[j];
-              const logical::Method &methodInComponent = *connectedComponents[j].method;
+        unsigned int root( unsigned int e ) {
+          return top[find( e )];
+        }
 
-              if(actualCalledMethod != NULL && actualCalledMethod->getId() == methodInComponent.getId()){
+        /**
+        * Links a root to the root of another component, which becomes the root of the joined component
+        */
+        void link( unsigned int oldRoot, unsigned int newRoot ) {
+          elements[oldRoot].nextElement = newRoot;
+
+          unsigned int a = find( oldRoot ), b = find( newRoot );
+          if ( rank[a] < rank[b] ) {
+            parent[a] = b;
+          } else {
+            parent[b] = a;
+            if ( rank[a] == rank[b] ) {
+              ++rank[a];
+            }
+            top[a] = newRoot;
+          }
+        }
 
-                ListIterator<base::Base> it = revEdges.constIteratorBegin(actualCalledMethod->getId(), edkScope_HasMember);
-                if(it != revEdges.constIteratorEnd(actualCalledMethod->getId(), edkScope_HasMember)) {
-                  if (Common::getIsClass(*it)) {
-                    const logical::Class *classOfMethod = (const logical::Class*)(&(*it));
-                    if(classOfMethod->getAggregated() != NULL)
-                      classOfMethod = (const logical::Class*)(classOfMethod->getAggregated());
+      private:
 
-                    if (classOfMethod->getId() == actClassId) {
+        unsigned int find( unsigned int e ) {
+          unsigned int representative = e;
+          while ( parent[representative] != representative ) {
+            representative = parent[representative];
+          }
+          while ( parent[e] != representative ) {
+            unsigned int next = parent[e];
+            parent[e] = representative;
+            e = next;
+          }
+          return representative;
+        }
 
-                      if(actualElement.nextElement == NULL || actualElement.nextElement == &actualElement){                  //root elem hivott
+        vector<ConnectedComponentElement>& elements;
+        vector<unsigned int> parent;
+        vector<unsigned int> rank;
+        vector<unsigned int> top;             // the root element of the component of a representative
+    };
+
+    /**
+    * The roots containing an attribute or a called method in their sets
+    */
+    struct Bucket {
+      bool connects;                          // whether sharing the item connects two components
+      vector<unsigned int> roots;             // the roots which were merged into other components are dropped lazily
+    };
+
+    /**
+    * Pushes the roots of the bucket starting from the given index (except the current one) into the queue
+    */
+    void collectRoots( Bucket& bucket, const ComponentForest& forest, unsigned int current, unsigned int first, priority_queue<unsigned int, vector<unsigned int>, greater<unsigned int>>& queue ) {
+      vector<unsigned int>::iterator kept = bucket.roots.begin();
+      for ( vector<unsigned int>::iterator it = bucket.roots.begin(); it != bucket.roots.end(); ++it ) {
+        if ( forest.isRoot( *it ) ) {
+          *kept++ = *it;
+          if ( *it != current && *it >= first ) {
+            queue.push( *it );
+          }
+        }
+      }
+      bucket.roots.erase( kept, bucket.roots.end() );
+    }
 
-                        if(elementInComponent.nextElement == NULL || elementInComponent.nextElement == &elementInComponent){             //root elemet hivtunk
-                          elementInComponent.nextElement = &actualElement;                //vizsgalt elemet rakotjuk az aktualis elemre
+  }
 
-                          actualElement.accessedAttributes.insert(elementInComponent.accessedAttributes.begin(), elementInComponent.accessedAttributes.end());
-                          actualElement.methodCalls.insert(elementInComponent.methodCalls.begin(), elementInComponent.methodCalls.end());
+  /*
+  * The methods are connected in two steps:
+  * - a method is joined with the methods of the class it calls,
+  * - then every component (in the order of its root) takes over the later components sharing a used attribute
+  *   of the class or its ancestors with it, or calling the same method of them, in the order of their roots.
+  * The result depends on this order, so the components are joined exactly in the order of a simple pairwise scan
+  * of the methods, but the candidates are found through the methods by id and the attributes and called methods by
+  * the roots using them.
+  */
+  int LCOM5::calculateConnectedComponents( const asg::logical::Class& actClass, vector<ConnectedComponentElement>& connectedComponents, const set<const logical::Class*>& parentClasses ) {
 
-                        }
-                        else{
-                          ConnectedComponentElement* rootElement = getConnectedComponentRootElement(&elementInComponent);
-                          rootElement->nextElement = &actualElement;                      //vizsgalt elem gyokeret rakotjuk az aktualis elemre
+    NodeId actClassId = actClass.getId();
 
-                          actualElement.accessedAttributes.insert(rootElement->accessedAttributes.begin(), rootElement->accessedAttributes.end());
-                          actualElement.methodCalls.insert(rootElement->methodCalls.begin(), rootElement->methodCalls.end());
+    const unsigned int connectedComponentsSize = (unsigned int) connectedComponents.size();
+    const asg::ReverseEdges& revEdges = shared->factory->getReverseEdges();
 
-                        }
+    ComponentForest forest( connectedComponents );
 
-                      }
-                      else{                                                             //nem root elem hivott
+    //
+    // method calls inside the class
+    //
 
-                        ConnectedComponentElement* rootActualElement = getConnectedComponentRootElement(&actualElement);
-                  
-                        if(elementInComponent.nextElement == NULL || elementInComponent.nextElement == &elementInComponent){               //root elemet hivtunk
-                          elementInComponent.nextElement = rootActualElement;               //vizsgalt elemet rakotjuk az aktualis elem gyokerere
+    boost::unordered_map<NodeId, vector<unsigned int>> methodIndex;
+    for ( unsigned int i = 0; i < connectedComponentsSize; ++i ) {
+      methodIndex[connectedComponents[i].method->getId()].push_back( i );
+    }
 
-                          rootActualElement->accessedAttributes.insert(elementInComponent.accessedAttributes.begin(), elementInComponent.accessedAttributes.end());
-                          rootActualElement->methodCalls.insert(elementInComponent.methodCalls.begin(), elementInComponent.methodCalls.end());
+    for ( unsigned int i = 0; i < connectedComponentsSize; ++i ) {
+      const logical::Method& actualMethod = *connectedComponents[i].method;
 
-                        }
-                        else{
-                          ConnectedComponentElement* rootElement = getConnectedComponentRootElement(&elementInComponent);
-                          if(rootElement != rootActualElement){
-                      
-                            rootActualElement->nextElement = rootElement;                   //aktualis elem gyokeret rakotjuk az vizsgalt elem gyokerere
+      ListIterator<logical::MethodCall> callIt = actualMethod.getCallsListIteratorBegin(), callEnd = actualMethod.getCallsListIteratorEnd();
+      for ( ; callIt != callEnd; ++callIt ) {
+        const logical::Method* calledMethod = callIt->getMethod();
+        if ( calledMethod == NULL ) {
+          continue;
+        }
 
-                            rootElement->accessedAttributes.insert(rootActualElement->accessedAttributes.begin(), rootActualElement->accessedAttributes.end());
-                            rootElement->methodCalls.insert(rootActualElement->methodCalls.begin(), rootActualElement->methodCalls.end());
+        boost::unordered_map<NodeId, vector<unsigned int>>::const_iterator calledIt = methodIndex.find( calledMethod->getId() );
+        if ( calledIt == methodIndex.end() ) {
+          continue;
+        }
 
-                          }
+        const logical::Class* classOfMethod = getClassOfMember( revEdges, calledMethod->getId() );
+        if ( classOfMethod == NULL || classOfMethod->getId() != actClassId ) {
+          continue;
+        }
 
-                        }
-                  
-                      }
-                    }
-                  }
-                }
-              }
-            }
+        const vector<unsigned int>& called = calledIt->second;
+        for ( vector<unsigned int>::const_iterator j = called.begin(); j != called.end(); ++j ) {
+          if ( *j == i ) {
+            continue;
+          }
+
+          unsigned int rootActual = forest.root( i );
+          unsigned int rootCalled = forest.root( *j );
+          if ( rootActual == rootCalled ) {
+            continue;
+          }
+
+          // the component of the calling method takes over the other one, unless both methods were already joined
+          unsigned int oldRoot = rootCalled, newRoot = rootActual;
+          if ( ! forest.isRoot( i ) && ! forest.isRoot( *j ) ) {
+            oldRoot = rootActual;
+            newRoot = rootCalled;
           }
+
+          forest.link( oldRoot, newRoot );
+          mergeSets( connectedComponents[newRoot].accessedAttributes, connectedComponents[oldRoot].accessedAttributes );
+          mergeSets( connectedComponents[newRoot].methodCalls, connectedComponents[oldRoot].methodCalls );
         }
       }
     }
 
-    for(unsigned int i = 0; i < connectedComponentsSize; ++i){
-    ConnectedComponentElement& actualElement = connectedComponents[i];
-    set<const logical::Attribute*>& actualAttributes = actualElement.accessedAttributes;
-    set<const logical::Method*>& actualMethods = actualElement.methodCalls;
-      
-      if(actualElement.nextElement == NULL || actualElement.nextElement == &actualElement){                                //aktualis gyoker elem
-        for (unsigned int j = 0; j < connectedComponentsSize; ++j) {
-
-          if(i != j){     //onmagaval nem vizsgaljuk
-            ConnectedComponentElement& elementInComponent = connectedComponents[j];
-            set<const logical::Attribute*>& elementAttributes = elementInComponent.accessedAttributes;
-            set<const logical::Method*>& elementMethods = elementInComponent.methodCalls;
-
-            if(elementInComponent.nextElement == NULL || elementInComponent.nextElement == &elementInComponent){                     //vizsgalt gyoker elem
-
-              bool isConnected = false;
-              set<const logical::Attribute*>::const_iterator actualItEnd = actualAttributes.end();
-              set<const logical::Attribute*>::const_iterator elementItEnd = elementAttributes.end();
-              for(set<const logical::Attribute*>::const_iterator actualIt = actualAttributes.begin(); actualIt != actualItEnd; ++actualIt){
-                if(*actualIt != NULL && elementAttributes.find(*actualIt) != elementItEnd){
-                  
-                  ListIterator<base::Base> it = revEdges.constIteratorBegin((*actualIt)->getId(), edkScope_HasMember);
-                  if(it != revEdges.constIteratorEnd((*actualIt)->getId(), edkScope_HasMember)) {
-                    if (Common::getIsClass(*it)) {
-                      logical::Class *classOfAttribute = (logical::Class*)(&(*it));
-                      if(classOfAttribute->getAggregated() != NULL)
-                        classOfAttribute = (logical::Class*)(classOfAttribute->getAggregated());
-
-                      if (parentClasses.find(classOfAttribute) != parentClasses.end() || classOfAttribute->getId() == actClassId) {
-
-                        elementInComponent.nextElement = &actualElement;
-
-                        actualAttributes.insert(elementAttributes.begin(), elementAttributes.end());
-                        isConnected = true;
-                        break;
-                      }
-
-                    }
-                  }
- 
-                }
-          
-              }
-              if(isConnected)
-                continue;
-
-              set<const logical::Method*>::const_iterator actualCallsItEnd = actualMethods.end();
-              set<const logical::Method*>::const_iterator elementCallsItEnd = elementMethods.end();
-              for(set<const logical::Method*>::const_iterator callslIt = actualMethods.begin(); callslIt != actualCallsItEnd; ++callslIt){
-                if(*callslIt != NULL && elementMethods.find(*callslIt) != elementCallsItEnd){
-                  
-                  ListIterator<base::Base> it = revEdges.constIteratorBegin((*callslIt)->getId(), edkScope_HasMember);
-                  if(it != revEdges.constIteratorEnd((*callslIt)->getId(), edkScope_HasMember)) {
-                    if (Common::getIsClass(*it)) {
-                      logical::Class *classOfMethod = (logical::Class*)(&(*it));
-                      if(classOfMethod->getAggregated() != NULL)
-                        classOfMethod = (logical::Class*)(classOfMethod->getAggregated());
-
-                      if (parentClasses.find(classOfMethod) != parentClasses.end()) {
-
-                        elementInComponent.nextElement = &actualElement;
-
-                        actualMethods.insert(elementMethods.begin(), elementMethods.end());
-                        break;
-                      }
-
-                    }
-                  }
- 
-                }
-          
-              }
+    //
+    // shared attributes and called methods
+    //
 
-            }
+    boost::unordered_map<const logical::Attribute*, Bucket> attributeBuckets;
+    boost::unordered_map<const logical::Method*, Bucket> callBuckets;
 
+    auto attributeBucket = [&]( const logical::Attribute* attribute ) -> Bucket& {
+      boost::unordered_map<const logical::Attribute*, Bucket>::iterator it = attributeBuckets.find( attribute );
+      if ( it == attributeBuckets.end() ) {
+        const logical::Class* classOfAttribute = getClassOfMember( revEdges, attribute->getId() );
+        Bucket bucket;
+        bucket.connects = classOfAttribute != NULL && ( parentClasses.find( classOfAttribute ) != parentClasses.end() || classOfAttribute->getId() == actClassId );
+        it = attributeBuckets.insert( make_pair( attribute, bucket ) ).first;
+      }
+      return it->second;
+    };
+
+    auto callBucket = [&]( const logical::Method* method ) -> Bucket& {
+      boost::unordered_map<const logical::Method*, Bucket>::iterator it = callBuckets.find( method );
+      if ( it == callBuckets.end() ) {
+        const logical::Class* classOfMethod = getClassOfMember( revEdges, method->getId() );
+        Bucket bucket;
+        bucket.connects = classOfMethod != NULL && parentClasses.find( classOfMethod ) != parentClasses.end();
+        it = callBuckets.insert( make_pair( method, bucket ) ).first;
+      }
+      return it->second;
+    };
+
+    for ( unsigned int i = 0; i < connectedComponentsSize; ++i ) {
+      if ( forest.isRoot( i ) ) {
+        const ConnectedComponentElement& element = connectedComponents[i];
+        for ( set<const logical::Attribute*>::const_iterator it = element.accessedAttributes.begin(); it != element.accessedAttributes.end(); ++it ) {
+          Bucket& bucket = attributeBucket( *it );
+          if ( bucket.connects ) {
+            bucket.roots.push_back( i );
+          }
+        }
+        for ( set<const logical::Method*>::const_iterator it = element.methodCalls.begin(); it != element.methodCalls.end(); ++it ) {
+          Bucket& bucket = callBucket( *it );
+          if ( bucket.connects ) {
+            bucket.roots.push_back( i );
           }
-      
         }
       }
     }
 
-    // ignore components that contain only contructors, destructors, getters or setters
-    map<const ConnectedComponentElement*, bool> ignoreMap;
     for ( unsigned int i = 0; i < connectedComponentsSize; ++i ) {
-      ConnectedComponentElement& actualElement = connectedComponents[i];
+      if ( ! forest.isRoot( i ) ) {
+        continue;
+      }
 
-      // if the element is not already inspected
-      if ( ignoreMap.find(&actualElement) == ignoreMap.end() ) {
-        ConnectedComponentElement* step = &actualElement;
+      ConnectedComponentElement& actualElement = connectedComponents[i];
+      set<const logical::Attribute*>& actualAttributes = actualElement.accessedAttributes;
+      set<const logical::Method*>& actualMethods = actualElement.methodCalls;
 
-        // suppose that its component is irrelevant
-        bool ignore = true;
+      // the roots sharing a connecting attribute or called method with the current root, they are taken
+      // in increasing order and only the later ones are added when the sets of the current root grow
+      priority_queue<unsigned int, vector<unsigned int>, greater<unsigned int>> byAttribute, byCall;
 
-        // search through it from the current element
-        // if there is something relevant in it then don't ignore
-        for ( ;; ) {
+      for ( set<const logical::Attribute*>::const_iterator it = actualAttributes.begin(); it != actualAttributes.end(); ++it ) {
+        Bucket& bucket = attributeBucket( *it );
+        if ( bucket.connects ) {
+          collectRoots( bucket, forest, i, 0, byAttribute );
+        }
+      }
+      for ( set<const logical::Method*>::const_iterator it = actualMethods.begin(); it != actualMethods.end(); ++it ) {
+        Bucket& bucket = callBucket( *it );
+        if ( bucket.connects ) {
+          collectRoots( bucket, forest, i, 0, byCall );
+        }
+      }
 
-          MethodKind mk = step->method->getMethodKind();
-          if ( mk != mekConstructor && mk != mekDestructor && mk != mekGet && mk != mekSet ) {
-            ignore = false;
-            break;
-          }
+      while ( ! byAttribute.empty() || ! byCall.empty() ) {
+        unsigned int j = NO_ELEMENT;
+        if ( ! byAttribute.empty() ) {
+          j = byAttribute.top();
+        }
+        if ( ! byCall.empty() && byCall.top() < j ) {
+          j = byCall.top();
+        }
 
-          if ( step->nextElement == NULL || step->nextElement == step ) {
-            break;
-          }
+        // the shared attributes are checked first
+        bool sharesAttribute = ! byAttribute.empty() && byAttribute.top() == j;
+        while ( ! byAttribute.empty() && byAttribute.top() == j ) {
+          byAttribute.pop();
+        }
+        while ( ! byCall.empty() && byCall.top() == j ) {
+          byCall.pop();
+        }
 
-          step = step->nextElement;
+        if ( ! forest.isRoot( j ) ) {
+          continue;
         }
 
-        // propagate the ignore flag to the whole component after the current element
-        // ( if it is not already filled out )
-        if ( ignoreMap.find( step ) == ignoreMap.end() ) {
-          for ( ;; ) {
-            ignoreMap[step] = ignore;
-            if ( step->nextElement == NULL || step->nextElement == step ) {
-              break;
+        ConnectedComponentElement& elementInComponent = connectedComponents[j];
+        forest.link( j, i );
+
+        if ( sharesAttribute ) {
+          for ( set<const logical::Attribute*>::const_iterator it = elementInComponent.accessedAttributes.begin(); it != elementInComponent.accessedAttributes.end(); ++it ) {
+            if ( actualAttributes.insert( *it ).second ) {
+              Bucket& bucket = attributeBucket( *it );
+              if ( bucket.connects ) {
+                collectRoots( bucket, forest, i, j + 1, byAttribute );
+                bucket.roots.push_back( i );
+              }
             }
-            step = step->nextElement;
           }
+        } else {
+          for ( set<const logical::Method*>::const_iterator it = elementInComponent.methodCalls.begin(); it != elementInComponent.methodCalls.end(); ++it ) {
+            if ( actualMethods.insert( *it ).second ) {
+              Bucket& bucket = callBucket( *it );
+              if ( bucket.connects ) {
+                collectRoots( bucket, forest, i, j + 1, byCall );
+                bucket.roots.push_back( i );
+              }
+            }
+          }
+        }
+      }
+    }
+
+    //
+    // ignore components that contain only contructors, destructors, getters or setters
+    //
+
+    // The component of an element is ignored if there is nothing relevant on the path from the first (not
+    // already inspected) element of the component to its root, the elements from the first relevant one up
+    // to the root are not ignored.
+    vector<unsigned int> firstRelevant( connectedComponentsSize, NO_ELEMENT );
+    vector<bool> firstRelevantKnown( connectedComponentsSize, false );
+    vector<unsigned int> path;
+    for ( unsigned int i = 0; i < connectedComponentsSize; ++i ) {
+      unsigned int step = i;
+      unsigned int found = NO_ELEMENT;
+      for ( ;; ) {
+        if ( firstRelevantKnown[step] ) {
+          found = firstRelevant[step];
+          break;
         }
+        MethodKind mk = connectedComponents[step].method->getMethodKind();
+        if ( mk != mekConstructor && mk != mekDestructor && mk != mekGet && mk != mekSet ) {
+          found = step;
+          break;
+        }
+        path.push_back( step );
+        if ( forest.isRoot( step ) ) {
+          break;
+        }
+        step = connectedComponents[step].nextElement;
+      }
+      firstRelevantKnown[step] = true;
+      firstRelevant[step] = found;
+      for ( vector<unsigned int>::const_iterator it = path.begin(); it != path.end(); ++it ) {
+        firstRelevantKnown[*it] = true;
+        firstRelevant[*it] = found;
       }
+      path.clear();
     }
 
+    enum IgnoreState { isNotInspected, isKept, isIgnored };
+    vector<IgnoreState> ignoreState( connectedComponentsSize, isNotInspected );
+    for ( unsigned int i = 0; i < connectedComponentsSize; ++i ) {
+      if ( ignoreState[i] != isNotInspected ) {
+        continue;
+      }
+
+      bool ignore = firstRelevant[i] == NO_ELEMENT;
+      unsigned int step = ignore ? forest.root( i ) : firstRelevant[i];
+      if ( ignoreState[step] != isNotInspected ) {
+        continue;
+      }
+
+      if ( ignore ) {
+        ignoreState[step] = isIgnored;
+      } else {
+        // the rest of the path is already kept from an element below
+        for ( ; ignoreState[step] != isKept; step = connectedComponents[step].nextElement ) {
+          ignoreState[step] = isKept;
+          if ( forest.isRoot( step ) ) {
+            break;
+          }
+        }
+      }
+    }
 
     unsigned int connectedComponentCounter = 0;
     for ( unsigned int i = 0; i < connectedComponentsSize; ++i ) {
       ConnectedComponentElement& actualElement = connectedComponents[i];
+      bool ignored = ignoreState[i] == isIgnored;
 
-      if ( ! ignoreMap[&actualElement] && this->shared->LCOMMap != nullptr ) {
+      if ( ! ignored && this->shared->LCOMMap != nullptr ) {
 
         // export the actual components to the shared map
-        ConnectedComponentElement* last = &actualElement;
-        while ( last->nextElement != NULL && last->nextElement != last ) {
-          last = last->nextElement;
-        }
-
-        (*this->shared->LCOMMap)[actClass.getName()][last->method->getName()].push_back( actualElement.method->getName() );
+        const ConnectedComponentElement& last = connectedComponents[forest.root( i )];
+        (*this->shared->LCOMMap)[actClass.getName()][last.method->getName()].push_back( actualElement.method->getName() );
       }
 
-      if ( (actualElement.nextElement == NULL || actualElement.nextElement == &actualElement) && ! ignoreMap[&actualElement] ) {
+      if ( forest.isRoot( i ) && ! ignored ) {
         ++connectedComponentCounter;
       }
     }
@@ -40,7 +40,7 @@ namespace columbus { namespace lim { namespace metrics {
                                                       filesEnd = method.getIsContainedInListIteratorAssocEnd();
       for ( ; files != filesEnd; ++files ) {
         const physical::File* file = &(*files);
-        this->shared->files[file].ints[name] += max( (int) method.getNumberOfBranches() - 1, 0 );
+        this->shared->files[file].ints[slot] += max( (int) method.getNumberOfBranches() - 1, 0 );
       }
 
     });
@@ -51,7 +51,7 @@ namespace columbus { namespace lim { namespace metrics {
       // ( Plus 1, as it should have started from 1, not 0 )
       const physical::File* file = &node.getLimNode<physical::File>();
       Info& fileInfo = this->shared->files[file];
-      addMetric( node, fileInfo.ints[this->name] + 1 );
+      addMetric( node, fileInfo.ints[this->slot] + 1 );
     });
   }
 
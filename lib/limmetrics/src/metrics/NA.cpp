@@ -35,9 +35,10 @@ namespace columbus { namespace lim { namespace metrics {
   {
     if ( name == "NA" ) {
 
+      hierarchyIndexed = true;
       registerHandler( phaseVisit, NTYPE_LIM_CLASS, limLangOther, false, [this] ( NodeWrapper& node ) {
         traverseClass( node );
-        addMetric( node, (int) this->shared->currentClassInfo().sets[this->name].size() );
+        addMetric( node, (int) this->shared->currentClassInfo().sets[this->slot].size() );
       });
 
       propagateScopeSet( phaseVisitEnd, NTYPE_LIM_PACKAGE, limLangOther );
@@ -120,18 +121,21 @@ namespace columbus { namespace lim { namespace metrics {
 
   void NABase::add( const asg::logical::Attribute& attr, Info& info, bool local ) {
 
-    innerAdd( attr, info, local, "NA", "NLA" );
+    static const MetricSlots::Slot slotNA = MetricSlots::get( "NA" ), slotNLA = MetricSlots::get( "NLA" );
+    static const MetricSlots::Slot slotNPA = MetricSlots::get( "NPA" ), slotNLPA = MetricSlots::get( "NLPA" );
+
+    innerAdd( attr, info, local, slotNA, slotNLA );
 
     if ( attr.getAccessibility() == ackPublic )
     {
-      innerAdd( attr, info, local, "NPA", "NLPA" );
+      innerAdd( attr, info, local, slotNPA, slotNLPA );
     }
   }
 
-  void NABase::innerAdd( const asg::logical::Attribute& attr, Info& info, bool local, string normalName, string localName ) {
-    info.sets[normalName].insert( attr.getId() );
+  void NABase::innerAdd( const asg::logical::Attribute& attr, Info& info, bool local, MetricSlots::Slot normalSlot, MetricSlots::Slot localSlot ) {
+    info.sets[normalSlot].insert( attr.getId() );
     if ( local ) {
-      info.sets[localName].insert( attr.getId() );
+      info.sets[localSlot].insert( attr.getId() );
     }
   }
 
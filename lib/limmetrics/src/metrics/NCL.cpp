@@ -51,21 +51,25 @@ namespace columbus { namespace lim { namespace metrics {
 
   void NCLBase::processClass( NodeWrapper& node ) {
 
-    string name, publicName;
+    static const MetricSlots::Slot slotNCL = MetricSlots::get( "NCL" ), slotNPCL = MetricSlots::get( "NPCL" );
+    static const MetricSlots::Slot slotNIN = MetricSlots::get( "NIN" ), slotNPIN = MetricSlots::get( "NPIN" );
+    static const MetricSlots::Slot slotNEN = MetricSlots::get( "NEN" ), slotNPEN = MetricSlots::get( "NPEN" );
+    static const MetricSlots::Slot slotNST = MetricSlots::get( "NST" ), slotNPST = MetricSlots::get( "NPST" );
+    static const MetricSlots::Slot slotNUN = MetricSlots::get( "NUN" ), slotNPUN = MetricSlots::get( "NPUN" );
+
+    MetricSlots::Slot name, publicName;
     const logical::Class& clazz = node.getLimNode<logical::Class>();
     ClassKind clk = clazz.getClassKind();
 
     switch ( clk ) {
-      case clkClass:        name = "NCL"; publicName = "NPCL"; break;
-      case clkInterface:    name = "NIN"; publicName = "NPIN"; break;
-      case clkEnum:         name = "NEN"; publicName = "NPEN"; break;
-      case clkStruct:       name = "NST"; publicName = "NPST"; break;
-      case clkUnion:        name = "NUN"; publicName = "NPUN"; break;
-      default: break;
+      case clkClass:        name = slotNCL; publicName = slotNPCL; break;
+      case clkInterface:    name = slotNIN; publicName = slotNPIN; break;
+      case clkEnum:         name = slotNEN; publicName = slotNPEN; break;
+      case clkStruct:       name = slotNST; publicName = slotNPST; break;
+      case clkUnion:        name = slotNUN; publicName = slotNPUN; break;
+      default: return;
     }
 
-    if ( name.empty() ) return;
-
     // Package level
     add( clazz, shared->currentPackageInfo(), name, publicName );
 
@@ -78,7 +82,7 @@ namespace columbus { namespace lim { namespace metrics {
     }
   }
 
-  void NCLBase::add( const asg::logical::Class& clazz, Info& info, const string& name, const string& publicName ) {
+  void NCLBase::add( const asg::logical::Class& clazz, Info& info, MetricSlots::Slot name, MetricSlots::Slot publicName ) {
     info.sets[name].insert( clazz.getId() );
     if ( clazz.getAccessibility() == ackPublic ) {
       info.sets[publicName].insert( clazz.getId() );
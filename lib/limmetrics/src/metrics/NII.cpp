@@ -47,7 +47,7 @@ namespace columbus { namespace lim { namespace metrics {
 
       // add to class level NII
       if ( ! node.isFunction() ) {
-        this->shared->currentClassInfo().sets[this->name].insert( s.begin(), s.end() );
+        this->shared->currentClassInfo().sets[this->slot].insert( s.begin(), s.end() );
       }
     });
 
@@ -55,14 +55,14 @@ namespace columbus { namespace lim { namespace metrics {
     this->registerHandler( phaseVisitEnd, NTYPE_LIM_CLASS, limLangOther, false, [this]( NodeWrapper& node ) {
 
       const logical::Class& clazz = node.getLimNode<logical::Class>();
-      set<NodeId>& niiSet = this->shared->currentClassInfo().sets[this->name];
+      set<NodeId>& niiSet = this->shared->currentClassInfo().sets[this->slot];
 
       // self references removed
       for ( ListIterator<logical::Member> hasMemberIt = clazz.getMemberListIteratorBegin(); hasMemberIt != clazz.getMemberListIteratorEnd(); ++hasMemberIt ) {
         niiSet.erase( hasMemberIt->getId() );
       }
 
-      addMetric( node, (int) this->shared->currentClassInfo().sets[this->name].size() );
+      addMetric( node, (int) this->shared->currentClassInfo().sets[this->slot].size() );
 
       cleanup( node );
     });
@@ -38,9 +38,10 @@ namespace columbus { namespace lim { namespace metrics {
   {
     if ( name == "NM" ) {
 
+      hierarchyIndexed = true;
       registerHandler( phaseVisit, NTYPE_LIM_CLASS, limLangOther, false, [this] ( NodeWrapper& node ) {
         traverseClass( node );
-        addMetric( node, this->shared->currentClassInfo().ints[this->name] );
+        addMetric( node, this->shared->currentClassInfo().ints[this->slot] );
       });
 
       registerHandler( phaseVisit, NTYPE_LIM_METHOD, limLangOther, false, [this] ( NodeWrapper& node ) {
@@ -151,36 +152,41 @@ namespace columbus { namespace lim { namespace metrics {
 
   void NMBase::add( const asg::logical::Method& method, Info& info, bool local, int inc, bool useSets ) {
 
-    innerAdd( method, info, local, inc, useSets, "NM", "NLM" );
+    static const MetricSlots::Slot slotNM = MetricSlots::get( "NM" ), slotNLM = MetricSlots::get( "NLM" );
+    static const MetricSlots::Slot slotNG = MetricSlots::get( "NG" ), slotNLG = MetricSlots::get( "NLG" );
+    static const MetricSlots::Slot slotNS = MetricSlots::get( "NS" ), slotNLS = MetricSlots::get( "NLS" );
+    static const MetricSlots::Slot slotNPM = MetricSlots::get( "NPM" ), slotNLPM = MetricSlots::get( "NLPM" );
+
+    innerAdd( method, info, local, inc, useSets, slotNM, slotNLM );
 
     if ( method.getMethodKind() == mekGet ) {
-      innerAdd( method, info, local, inc, useSets, "NG", "NLG" );
+      innerAdd( method, info, local, inc, useSets, slotNG, slotNLG );
     }
 
     if ( method.getMethodKind() == mekSet ) {
-      innerAdd( method, info, local, inc, useSets, "NS", "NLS" );
+      innerAdd( method, info, local, inc, useSets, slotNS, slotNLS );
     }
 
     if ( method.getAccessibility() == ackPublic ) {
-      innerAdd( method, info, local, inc, useSets, "NPM", "NLPM" );
+      innerAdd( method, info, local, inc, useSets, slotNPM, slotNLPM );
     }
 
   }
 
-  void NMBase::innerAdd( const asg::logical::Method& method, Info& info, bool local, int inc, bool useSets, string normalName, string localName ) {
+  void NMBase::innerAdd( const asg::logical::Method& method, Info& info, bool local, int inc, bool useSets, MetricSlots::Slot normalSlot, MetricSlots::Slot localSlot ) {
     if ( useSets ) {
       if ( inc > 0 ) {
-        info.sets[normalName].insert( method.getId() );
+        info.sets[normalSlot].insert( method.getId() );
       }
       if ( local ) {
-        info.sets[localName].insert( method.getId() );
+        info.sets[localSlot].insert( method.getId() );
       }
     } else {
       if ( inc > 0 ) {
-        info.ints[normalName]++;
+        info.ints[normalSlot]++;
       }
       if ( local ) {
-        info.ints[localName]++;
+        info.ints[localSlot]++;
       }
     }
   }
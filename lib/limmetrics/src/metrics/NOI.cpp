@@ -50,7 +50,7 @@ namespace columbus { namespace lim { namespace metrics {
 
       // add to class level NOI
       if ( ! node.isFunction() ) {
-        this->shared->currentClassInfo().sets[this->name].insert( s.begin(), s.end() );
+        this->shared->currentClassInfo().sets[this->slot].insert( s.begin(), s.end() );
       }
     });
 
@@ -61,7 +61,7 @@ namespace columbus { namespace lim { namespace metrics {
       if ( ! this->shared->classStack.empty() ) {
         ListIterator<logical::MethodCall> i = attr.getCallsListIteratorBegin(), end = attr.getCallsListIteratorEnd();
         for ( ; i != end; ++i ) {
-          fillCalledMethods( *i, this->shared->currentClassInfo().sets[this->name], false );
+          fillCalledMethods( *i, this->shared->currentClassInfo().sets[this->slot], false );
         }
       }
     });
@@ -70,7 +70,7 @@ namespace columbus { namespace lim { namespace metrics {
     this->registerHandler( phaseVisitEnd, NTYPE_LIM_CLASS, limLangOther, false, [this]( NodeWrapper& node ) {
 
       const logical::Class& clazz = node.getLimNode<logical::Class>();
-      set<NodeId>& noiSet = this->shared->currentClassInfo().sets[this->name];
+      set<NodeId>& noiSet = this->shared->currentClassInfo().sets[this->slot];
 
       // self references removed
       for ( ListIterator<logical::Member> hasMemberIt = clazz.getMemberListIteratorBegin(); hasMemberIt != clazz.getMemberListIteratorEnd(); ++hasMemberIt ) {
@@ -35,22 +35,22 @@ namespace columbus { namespace lim { namespace metrics {
       int nos = (int) method.getNumberOfStatements();
 
       // add to method info
-      this->shared->currentMethodInfo().ints[this->name] = nos;
+      this->shared->currentMethodInfo().ints[this->slot] = nos;
       
       // add to class info (if not function)
       if ( ! this->shared->classStack.empty() ) {
-        this->shared->currentClassInfo().ints[this->name] += nos;
+        this->shared->currentClassInfo().ints[this->slot] += nos;
       }
 
       // add to package info
-      this->shared->currentPackageInfo().ints[this->name] += nos;
+      this->shared->currentPackageInfo().ints[this->slot] += nos;
 
       // add to component info
       auto i = method.getBelongsToListIteratorBegin();
       for ( ; i != method.getBelongsToListIteratorEnd(); ++i ) {
         const base::Component& c = dynamic_cast<const base::Component&>( *i );
         Info& cInfo = this->shared->components.map[&c];
-        cInfo.ints[this->name] += nos;
+        cInfo.ints[this->slot] += nos;
       }
 
       // add to file info
@@ -58,7 +58,7 @@ namespace columbus { namespace lim { namespace metrics {
                                                       filesEnd = method.getIsContainedInListIteratorAssocEnd();
       for ( ; files != filesEnd; ++files ) {
         const physical::File* file = &(*files);
-        this->shared->files[file].ints[name] += (int) method.getNumberOfStatements();
+        this->shared->files[file].ints[slot] += (int) method.getNumberOfStatements();
       }
 
       // add metric to method node
@@ -79,7 +79,7 @@ namespace columbus { namespace lim { namespace metrics {
 
       // Add the previously collected File level NOS to the node
       Info& fileInfo = this->shared->files[file];
-      addMetric( node, fileInfo.ints[this->name] );
+      addMetric( node, fileInfo.ints[this->slot] );
     });
 
   }
@@ -72,7 +72,7 @@ namespace columbus { namespace lim { namespace metrics {
 
         // add current package to its parent package
         Info& parentInfo = this->shared->scopes.map[&parentPackage];
-        parentInfo.sets[this->name].insert( package.getId() );
+        parentInfo.sets[this->slot].insert( package.getId() );
       }
 
       // if it's not the root package
@@ -82,7 +82,7 @@ namespace columbus { namespace lim { namespace metrics {
         for ( ; i != end; ++i ) {
           const base::Component& c = dynamic_cast<const base::Component&>( *i );
           Info& cInfo = this->shared->components.map[&c];
-          cInfo.sets[this->name].insert( package.getId() );
+          cInfo.sets[this->slot].insert( package.getId() );
         }
       }
     });
@@ -46,7 +46,7 @@ namespace columbus { namespace lim { namespace metrics {
       addMetric( node, rfc );
 
       // propagate to package level
-      this->shared->currentPackageInfo().ints[this->name] += rfc;
+      this->shared->currentPackageInfo().ints[this->slot] += rfc;
 
       cleanup( node, "NOI" );
     });
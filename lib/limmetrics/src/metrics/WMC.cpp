@@ -43,7 +43,7 @@ namespace columbus { namespace lim { namespace metrics {
       addMetric( node, wmc );
 
       // propagate to package level
-      this->shared->currentPackageInfo().ints[this->name] += wmc;
+      this->shared->currentPackageInfo().ints[this->slot] += wmc;
     });
 
   }
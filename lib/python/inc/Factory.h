@@ -101,6 +101,25 @@ namespace columbus { namespace python { namespace asg {
       */
       void load(const std::string &filename, CsiHeader &header);
 
+      /**
+      * \brief Loads the packages and modules of the given graph next to the existing ones (for example the graph of a shard of a parallel analysis).
+      *        The packages and modules of the loaded root are appended to the ones of the root, and the strings are moved into the string table of the factory.
+      *        A loaded package which has the same name as an existing package of the same parent is unified with it: its modules and packages
+      *        are appended to the existing one, and the loaded package node is deleted.
+      * \param filename [in] The graph is loaded from this file.
+      * \param header   [in] The header information (also will be loaded).
+      * \throw PythonException If a loaded node (except the root) has the same id as an existing node, PythonException is thrown.
+      */
+      void merge(const std::string &filename, CsiHeader &header);
+
+      /**
+      * \brief The new nodes get ids which are equal to offset modulo stride.
+      *        The factories of the shards of a parallel analysis use different offsets, so their graphs can be merged without renumbering the nodes.
+      * \param offset [in] The remainder of the new ids.
+      * \param stride [in] The modulus of the new ids.
+      */
+      void setNodeIdStride(NodeId offset, NodeId stride);
+
       void clear();
 
       /**
@@ -855,6 +874,14 @@ namespace columbus { namespace python { namespace asg {
       */
       base::Base& createNode(NodeKind ndk, NodeId id);
 
+      /**
+      * \internal
+      * \brief Appends a merged package to the parent, or unifies it with the package of the parent which has the same name.
+      * \param parent    [in] The parent package.
+      * \param packageId [in] The id of the merged package which has no parent yet.
+      */
+      void mergePackage(module::Package& parent, NodeId packageId);
+
       /**
       * \internal
       * \brief This function is call the alert list.
@@ -898,6 +925,12 @@ namespace columbus { namespace python { namespace asg {
       /** \internal \brief List of the ids of the deleted nodes. */
       std::list<NodeId> deletedNodeIdList;
 
+      /** \internal \brief The remainder of the ids of the new nodes (see setNodeIdStride()). */
+      NodeId idOffset;
+
+      /** \internal \brief The modulus of the ids of the new nodes (see setNodeIdStride()). */
+      NodeId idStride;
+
       friend class VisitorFilter;
 
       friend class base::Base;
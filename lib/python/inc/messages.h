@@ -48,6 +48,7 @@
 #define CMSG_EX_INVALID_NODE_ID(ID)                     "Invalid NodeId (" + Common::toString(ID) + ")"
 #define CMSG_EX_YOU_MUST_ENABLE_THE_REVERSE_EDGE_FIRST  "The reverse edge must be enabled first"
 #define CMSG_EX_THE_NODE_DOES_NOT_EXISTS                "The node does not exist"
+#define CMSG_EX_THE_NODE_ALREADY_EXISTS(ID)             "The node already exists (" + Common::toString(ID) + ")"
 #define CMSG_EX_NEXT_ELEMENT_DOES_NOT_EXIST             "Next element does not exist"
 #define CMSG_EX_THE_LOADED_FILTER_DOES_NOT_MATCH_TO_THE_CURRENT "The loaded filter does not match to the current ASG"
 #define CMSG_EX_INVALID_NODE_KIND                       "Invalid node kind"
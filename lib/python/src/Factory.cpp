@@ -39,7 +39,10 @@ Factory::Factory(RefDistributorStrTable& st) :
   filterOn(true),
   reverseEdges(NULL),
   registeredPointerStorage(),
-  root(NULL)
+  root(NULL),
+  deletedNodeIdList(),
+  idOffset(0),
+  idStride(1)
 {
   filter = new Filter(*this);
   root = dynamic_cast<module::Package*>(&createNode(ndkPackage, 100));
@@ -87,6 +90,7 @@ void Factory::save(const std::string &filename , CsiHeader &header) const {
 
   header.write(zipIo);
 
+  zipIo.setBuffered(true);
   // saving the ASG
   AlgorithmPreorder algPre;
   VisitorSave vSave(zipIo);
@@ -143,6 +147,7 @@ void Factory::load(const std::string &filename, CsiHeader &header) {
   header.read(zipIo);
   checkHeader(header);
 
+  zipIo.setBuffered(true);
   // loading the ASG
   NodeId id = zipIo.readUInt4();
   NodeKind kind = (NodeKind)zipIo.readUShort2();
@@ -168,6 +173,121 @@ void Factory::load(const std::string &filename, CsiHeader &header) {
 
 }
 
+void Factory::merge(const std::string &filename, CsiHeader &header) {
+  disableReverseEdges();
+
+  io::ZippedIO zipIo(filename.c_str(), io::IOBase::omRead, false);
+
+  // loading header
+  header.read(zipIo);
+  checkHeader(header);
+
+  zipIo.setBuffered(true);
+  // loading the ASG (the root is saved last, so its packages and modules are already loaded when it is read)
+  std::list<NodeId> loadedNodes;
+  std::list<NodeId> loadedPackages;
+  std::list<NodeId> loadedModules;
+  NodeId id = zipIo.readUInt4();
+  NodeKind kind = (NodeKind)zipIo.readUShort2();
+
+  while (id || kind) {
+    if (id == root->getId()) {
+      module::Package loadedRoot(id, this);
+      loadedRoot.load(zipIo);
+      for (ListIterator<module::Package> it = loadedRoot.getPackageListIteratorBegin(); it != loadedRoot.getPackageListIteratorEnd(); ++it)
+        loadedPackages.push_back(it->getId());
+      for (ListIterator<module::Module> it = loadedRoot.getModuleListIteratorBegin(); it != loadedRoot.getModuleListIteratorEnd(); ++it)
+        loadedModules.push_back(it->getId());
+    } else {
+      if (getExist(id))
+        throw PythonException(COLUMBUS_LOCATION, CMSG_EX_THE_NODE_ALREADY_EXISTS(id));
+      createNode(kind, id);
+      container[id]->load(zipIo);
+      loadedNodes.push_back(id);
+    }
+
+    id = zipIo.readUInt4();
+    kind = (NodeKind)zipIo.readUShort2();
+  }
+
+  // loading the string table of the file and moving the strings of the loaded nodes into the own one
+  RefDistributorStrTable loadedStrTable;
+  loadedStrTable.loadWithKeepingTheRefMap(zipIo);
+  zipIo.close();
+
+  RefDistributorStrTable* ownStrTable = strTable;
+  std::map<Key,Key> oldAndNewStrKeyMap;
+  for (std::list<NodeId>::const_iterator it = loadedNodes.begin(); it != loadedNodes.end(); ++it) {
+    strTable = &loadedStrTable;
+    container[*it]->swapStringTable(*ownStrTable, oldAndNewStrKeyMap);
+    // the path of the position is not swapped by the node
+    if (Common::getIsPositioned(*container[*it])) {
+      base::Positioned& positioned = dynamic_cast<base::Positioned&>(*container[*it]);
+      const Range position = positioned.getPosition();
+      strTable = ownStrTable;
+      positioned.setPosition(position);
+    }
+  }
+  strTable = ownStrTable;
+
+  for (std::list<NodeId>::const_iterator it = loadedPackages.begin(); it != loadedPackages.end(); ++it) {
+    container[*it]->parent = 0;
+    mergePackage(*root, *it);
+  }
+  for (std::list<NodeId>::const_iterator it = loadedModules.begin(); it != loadedModules.end(); ++it) {
+    container[*it]->parent = 0;
+    root->addModule(*it);
+  }
+
+  // fill the deletedNodeIdList with the free ids
+  deletedNodeIdList.clear();
+  for (size_t id = 100; id < container.size(); ++id)
+    if (container[id] == NULL)
+      deletedNodeIdList.push_back(id);
+}
+
+void Factory::mergePackage(module::Package& parent, NodeId packageId) {
+  module::Package& package = dynamic_cast<module::Package&>(*container[packageId]);
+
+  module::Package* existing = NULL;
+  for (ListIterator<module::Package> it = parent.getPackageListIteratorBegin(); it != parent.getPackageListIteratorEnd(); ++it) {
+    if (it->getName() == package.getName()) {
+      existing = dynamic_cast<module::Package*>(container[it->getId()]);
+      break;
+    }
+  }
+
+  if (!existing) {
+    parent.addPackage(packageId);
+    return;
+  }
+
+  std::list<NodeId> modules;
+  for (ListIterator<module::Module> it = package.getModuleListIteratorBegin(); it != package.getModuleListIteratorEnd(); ++it)
+    modules.push_back(it->getId());
+  for (std::list<NodeId>::const_iterator it = modules.begin(); it != modules.end(); ++it) {
+    package.removeModule(*it);
+    existing->addModule(*it);
+  }
+
+  std::list<NodeId> packages;
+  for (ListIterator<module::Package> it = package.getPackageListIteratorBegin(); it != package.getPackageListIteratorEnd(); ++it)
+    packages.push_back(it->getId());
+  for (std::list<NodeId>::const_iterator it = packages.begin(); it != packages.end(); ++it) {
+    package.removePackage(*it);
+    mergePackage(*existing, *it);
+  }
+
+  // the emptied package is not referenced by any node (the reverse edges are disabled during the merge)
+  delete container[packageId];
+  container[packageId] = NULL;
+}
+
+void Factory::setNodeIdStride(NodeId offset, NodeId stride) {
+  idOffset = offset;
+  idStride = stride;
+}
+
 void Factory::clear() {
   disableReverseEdges();
   for (Container::iterator i = container.begin(); i != container.end(); ++i) {
@@ -452,9 +572,12 @@ bool Factory::getExistsReverseEdges() const {
 base::Base* Factory::createNode(NodeKind kind) {
   base::Base *p = 0;
   NodeId id;
-  if (deletedNodeIdList.empty())
+  if (deletedNodeIdList.empty()) {
     id = container.size();
-  else {
+    // the ids of the other residue classes are left free
+    if (idStride > 1)
+      id += (idOffset + idStride - id % idStride) % idStride;
+  } else {
     id = deletedNodeIdList.front();
     deletedNodeIdList.pop_front();
   }
@@ -0,0 +1,142 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _CONCURRENTSTRTABLE_H
+#define _CONCURRENTSTRTABLE_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/thread/mutex.hpp>
+
+#include "strtable/inc/StrTable.h"
+
+namespace columbus {
+
+/**
+ * Thread-safe string table which can be filled by several threads at the same time.
+ * The table is split into shards. A string is stored in the shard selected by its 64 bit hash, so looking it up
+ * needs only that hash. Its key is generated in the shard of its bucket (the same bucket the StrTable uses), which
+ * also indexes the key. Both kinds of insertion have their own lock per shard, while looking up an already interned
+ * string or key does not take any lock.
+ * The keys are generated exactly the same way as in the StrTable, so after the parallel work is done the
+ * content can be moved into a regular StrTable (see copyTo()) and all the given keys remain valid.
+ * The references given back by get(Key) are stable during the lifetime of the table.
+ */
+class ConcurrentStrTable
+{
+  public:
+    ConcurrentStrTable(const unsigned buckets = 511, const unsigned shards = 64);
+
+    // Creates a concurrent table which contains all the strings of the given table with the same keys.
+    ConcurrentStrTable(const StrTable& st, const unsigned shards = 64);
+
+    ~ConcurrentStrTable();
+
+    // Inserts the given string into the string table and gives back a "unique" key.
+    Key set(const char* s, StrTable::StrType type = StrTable::strDefault);
+    Key set(const char* s, unsigned length, StrTable::StrType type = StrTable::strDefault);
+    Key set(const std::string& s, StrTable::StrType type = StrTable::strDefault);
+
+    // Gives back the "unique" key of the given string if it is in the string table. Otherwise it returns 0.
+    Key get(const char* s) const;
+    Key get(const char* s, unsigned length) const;
+    Key get(const std::string& s) const;
+
+    // Gives back the string stored in the string table with the given "unique" key or an empty string in case 
+    // there is no string in the table with that key.
+    const std::string& get(const Key key) const;
+
+    // Gives back the number of the stored strings.
+    std::size_t size() const;
+
+    // Copies the content into the given table. All data exist in the given table will be lost.
+    // It must not be called while other threads are inserting.
+    void copyTo(StrTable& st) const;
+
+  protected:
+    struct Entry {
+      std::string        str;
+      unsigned long long hash_value;
+      Key                key;
+      StrTable::StrType  type;
+    };
+
+    // Open addressing index. Once an index is published it is never modified except filling its
+    // empty slots, so readers can use it without locking.
+    struct Index {
+      explicit Index(std::size_t capacity);
+
+      std::size_t                                     capacity;
+      std::unique_ptr<std::atomic<const Entry*>[]>    slots;
+    };
+
+    // The indexes of one kind of a shard.
+    struct Indexes {
+      Indexes();
+
+      std::atomic<Index*>                 current;   // The currently used index
+      std::vector<std::unique_ptr<Index>> all;       // All the indexes (the old ones can still be read)
+    };
+
+    struct Shard {
+      Shard();
+
+      boost::mutex                        str_mutex; // Guards the insertion of the strings of the shard
+      std::deque<Entry>                   entries;   // The strings whose 64 bit hash selects the shard
+      Indexes                             str_index;
+
+      boost::mutex                        key_mutex; // Guards the keys of the buckets of the shard
+      std::vector<const Entry*>           keyed;     // The entries whose bucket selects the shard
+      Indexes                             key_index;
+    };
+
+    unsigned                             no_buckets;
+    unsigned                             shard_mask;
+    std::vector<unsigned short>          count;       // Internal counter for each bucket (guarded by the shard of the bucket)
+    std::unique_ptr<Shard[]>             shards;
+    std::atomic<std::size_t>             no_strings;
+
+    void init(unsigned shards);
+    // The high bits are used, the low ones select the slot in the index of the shard.
+    Shard& getStrShard(unsigned long long hash_value) const { return shards[(unsigned)(hash_value >> 48) & shard_mask]; }
+    Shard& getKeyShard(Key key) const { return shards[((key >> 16) % no_buckets) & shard_mask]; }
+
+    static const Entry* findEntry(const Index& index, const char* s, std::size_t length, unsigned long long hash_value);
+    static const Entry* findEntry(const Index& index, Key key);
+
+    // Stores the entry in the shard of its string. The str_mutex of the shard must be held by the caller.
+    Entry& addEntry(Shard& shard, const char* s, std::size_t length, unsigned long long hash_value, StrTable::StrType type);
+    // Makes the entry findable by its string or key. The str_mutex or key_mutex of the shard must be held by the caller.
+    void publishStr(Shard& shard, const Entry& entry);
+    void publishKey(Shard& shard, const Entry& entry);
+    static void insert(Index& index, const Entry& entry, std::size_t hash_value);
+
+  private:
+    ConcurrentStrTable(const ConcurrentStrTable&);
+    ConcurrentStrTable& operator=(const ConcurrentStrTable&);
+};
+
+} // namespace columbus
+
+#endif
@@ -21,7 +21,7 @@
 #ifndef _STRTABLE_H
 #define _STRTABLE_H
 
-#include <map>
+#include <deque>
 #include <string>
 #include <vector>
 #include <cstdio>
@@ -98,26 +98,56 @@ class StrTable
     void dump();
     
   protected:
-    typedef std::map<Key, std::pair<std::string, StrType> > Map;
+    // One interned string. The entries are stored in a deque so the references given back by get(Key) remain
+    // valid while the table grows.
+    struct Entry {
+      std::string        str;
+      unsigned long long hash_value;   // 64 bit hash of the string (used by the string index)
+      Key                key;
+      StrType            type;
+    };
 
-    unsigned                       no_buckets;           // Number of buckets
+    unsigned                       no_buckets;           // Number of buckets (only used to compute the keys)
     std::vector<unsigned short>    count;                // Internal counter for each bucket 
-    std::vector<Map>               str_table;            // The string table 
+    std::deque<Entry>              entries;              // The stored strings in insertion order
+    std::vector<unsigned>          str_index;            // Open addressing index by string (entry index + 1, 0 means empty slot)
+    std::vector<unsigned>          key_index;            // Open addressing index by key (entry index + 1, 0 means empty slot)
+
+
+    static unsigned short hash(const char* pString);
+    static unsigned short hash(const char* pString, unsigned long length);
+    static unsigned long long hash64(const char* s, std::size_t length);
+    Key get(const char* s, std::size_t length, unsigned long long hash_value) const;
+
+    // Finds the entry with the given key. Returns NULL if there is no such entry.
+    const Entry* findEntry(Key key) const;
+
+    // Inserts a new entry without checking whether the string is already in the table.
+    Entry& insertEntry(Key key, const char* s, std::size_t length, unsigned long long hash_value, StrType type);
 
+    // Inserts an entry read from a file, unless an entry with the same key is already in the table.
+    void insertLoadedEntry(Key key, const char* s, std::size_t length);
 
-    unsigned short hash(const char* pString) const;     
-    unsigned short hash(const char* pString, unsigned long length) const;     
-    Key get(const char* s, std::size_t length, unsigned short hash_value, unsigned bucket_index) const;
+    // Gives back a new key for the given string and increments the counter of its bucket.
+    Key newKey(const char* s, std::size_t length);
+
+    void rehash(std::size_t capacity);
+    void clear();
+
+    // Gives back the indexes of the entries in the order they have to be saved (by bucket, then by key).
+    std::vector<unsigned> getSaveOrder(StrType filterType) const;
 
     void copy(const StrTable& st); 
+
+    friend class ConcurrentStrTable;
+
 #ifdef DOSTAT    
     struct table_stat {
-      unsigned long      element_count;
       unsigned long      number_of_search;
       unsigned long long number_of_it;
     };
     
-    table_stat* statistic_counter;
+    mutable table_stat statistic_counter;
 #endif
 
 };
@@ -0,0 +1,79 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _STRTABLEREWRITER_H
+#define _STRTABLEREWRITER_H
+
+#include <string>
+#include <functional>
+#include <unordered_set>
+#include "StrTable.h"
+
+namespace columbus {
+
+// Changes the strings of the string table saved at the end of a binary ASG file without loading the ASG.
+// The factories save the nodes, then an end mark (a zero node id and node kind), then the string table, and
+// the nodes refer to the strings only by their keys. So a string can be replaced if its key is kept, and
+// everything in front of the string table is copied byte by byte.
+// The string table shares the keys among the equal strings, so a path can have the same key as a string literal.
+// Therefore the path changing tools do not use it until the paths are saved with their own keys.
+class StrTableRewriter
+{
+  public:
+    enum Result {
+      rrRewritten,  // Some strings are changed and the new file is written.
+      rrUnchanged,  // None of the strings is changed, nothing is written.
+      rrNotFound,   // The string table cannot be located unambiguously (for example the node section is compressed).
+      rrConflict,   // A changed string would be equal to another string of the table, so the keys cannot be kept.
+      rrIOError     // The input file cannot be read or the output file cannot be written.
+    };
+
+    // Changes the given string in place and gives back true if it is changed.
+    typedef std::function<bool(std::string&)> Rewrite;
+
+    // The keys of the strings which can be changed.
+    typedef std::unordered_set<Key> KeySet;
+
+    // Applies the rewrite function to every string of the string table of the input file and writes the
+    // result into the output file (which can be the same as the input). The output is written only if the
+    // result is rrRewritten, and the number of the changed strings is given back in the changed parameter.
+    // Every string of the table is given to the rewrite function, not only the ones used as paths.
+    static Result rewrite(const std::string& inFilename, const std::string& outFilename, const Rewrite& rewrite, unsigned& changed);
+
+    // Same as the previous one, but only the strings having the given keys (for example the keys of the
+    // paths of the Ranges) are given to the rewrite function, the others are kept.
+    static Result rewrite(const std::string& inFilename, const std::string& outFilename, const Rewrite& rewrite, const KeySet& keys, unsigned& changed);
+
+  private:
+    // Gives back the offset of the "STRTBL" tag of the string table, or std::string::npos if there is no
+    // such tag or there are more than one candidates which could be parsed to the end of the content.
+    static std::size_t locate(const std::string& content);
+
+    // Returns true if a complete string table starts at the given offset and it ends exactly at the end of
+    // the content.
+    static bool isTable(const std::string& content, std::size_t offset);
+
+    // Does the rewriting, if keys is NULL every string is given to the rewrite function.
+    static Result rewrite(const std::string& inFilename, const std::string& outFilename, const Rewrite& rewrite, const KeySet* keys, unsigned& changed);
+};
+
+} // namespace columbus
+
+#endif
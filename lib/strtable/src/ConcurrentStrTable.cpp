@@ -0,0 +1,297 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#include <cstring>
+#include <common/inc/WriteMessage.h>
+#include "../inc/messages.h"
+#include "../inc/ConcurrentStrTable.h"
+
+namespace columbus {
+
+// The indexes of the shards are always kept at most half full.
+static const std::size_t MIN_SHARD_CAPACITY = 64;
+
+static inline std::size_t keyHash(Key key)
+{
+  unsigned long long h = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+  return (std::size_t)(h ^ (h >> 32));
+}
+
+ConcurrentStrTable::Index::Index(std::size_t capacity)
+  : capacity(capacity)
+  , slots(new std::atomic<const Entry*>[capacity])
+{
+  for (std::size_t i = 0; i < capacity; ++i)
+    slots[i].store(NULL, std::memory_order_relaxed);
+}
+
+ConcurrentStrTable::Indexes::Indexes() : current(NULL), all()
+{
+  all.push_back(std::unique_ptr<Index>(new Index(MIN_SHARD_CAPACITY)));
+  current.store(all.back().get(), std::memory_order_release);
+}
+
+ConcurrentStrTable::Shard::Shard() : str_mutex(), entries(), str_index(), key_mutex(), keyed(), key_index()
+{
+}
+
+ConcurrentStrTable::ConcurrentStrTable(const unsigned buckets, const unsigned shards)
+  : no_buckets(buckets), shard_mask(0), count(buckets, 1), shards(), no_strings(0)
+{
+  init(shards);
+}
+
+ConcurrentStrTable::ConcurrentStrTable(const StrTable& st, const unsigned shards)
+  : no_buckets(st.no_buckets), shard_mask(0), count(st.count), shards(), no_strings(0)
+{
+  init(shards);
+
+  for (std::deque<StrTable::Entry>::const_iterator it = st.entries.begin(); it != st.entries.end(); ++it) {
+    Shard& key_shard = getKeyShard(it->key);
+    if (findEntry(*key_shard.key_index.current.load(std::memory_order_relaxed), it->key))
+      continue;
+
+    Shard& str_shard = getStrShard(it->hash_value);
+    Entry& entry = addEntry(str_shard, it->str.c_str(), it->str.size(), it->hash_value, it->type);
+    entry.key = it->key;
+    publishKey(key_shard, entry);
+    publishStr(str_shard, entry);
+  }
+}
+
+ConcurrentStrTable::~ConcurrentStrTable()
+{
+}
+
+void ConcurrentStrTable::init(unsigned no_shards)
+{
+  // The number of shards is rounded up to a power of two.
+  unsigned size = 1;
+  while (size < no_shards)
+    size <<= 1;
+
+  shard_mask = size - 1;
+  shards.reset(new Shard[size]);
+}
+
+const ConcurrentStrTable::Entry* ConcurrentStrTable::findEntry(const Index& index, const char* s, std::size_t length, unsigned long long hash_value)
+{
+  const std::size_t mask = index.capacity - 1;
+
+  for (std::size_t pos = (std::size_t)hash_value & mask; ; pos = (pos + 1) & mask) {
+    const Entry* entry = index.slots[pos].load(std::memory_order_acquire);
+    if (!entry)
+      return NULL;
+
+    if ((entry->hash_value == hash_value) && (entry->str.length() == length) && (entry->str.compare(0, length, s, length) == 0))
+      return entry;
+  }
+}
+
+const ConcurrentStrTable::Entry* ConcurrentStrTable::findEntry(const Index& index, Key key)
+{
+  const std::size_t mask = index.capacity - 1;
+
+  for (std::size_t pos = keyHash(key) & mask; ; pos = (pos + 1) & mask) {
+    const Entry* entry = index.slots[pos].load(std::memory_order_acquire);
+    if (!entry || entry->key == key)
+      return entry;
+  }
+}
+
+void ConcurrentStrTable::insert(Index& index, const Entry& entry, std::size_t hash_value)
+{
+  const std::size_t mask = index.capacity - 1;
+
+  std::size_t pos = hash_value & mask;
+  while (index.slots[pos].load(std::memory_order_relaxed))
+    pos = (pos + 1) & mask;
+  index.slots[pos].store(&entry, std::memory_order_release);
+}
+
+ConcurrentStrTable::Entry& ConcurrentStrTable::addEntry(Shard& shard, const char* s, std::size_t length, unsigned long long hash_value, StrTable::StrType type)
+{
+  shard.entries.push_back(Entry());
+  Entry& entry = shard.entries.back();
+  entry.str.assign(s, length);
+  entry.hash_value = hash_value;
+  entry.key = 0;
+  entry.type = type;
+
+  no_strings.fetch_add(1, std::memory_order_relaxed);
+  return entry;
+}
+
+void ConcurrentStrTable::publishStr(Shard& shard, const Entry& entry)
+{
+  Index* index = shard.str_index.current.load(std::memory_order_relaxed);
+  if (shard.entries.size() * 2 > index->capacity) {
+    // The readers may still use the old index, so it is kept alive and a new one is published.
+    Index* new_index = new Index(index->capacity * 2);
+    shard.str_index.all.push_back(std::unique_ptr<Index>(new_index));
+
+    for (std::deque<Entry>::const_iterator it = shard.entries.begin(); it != shard.entries.end(); ++it)
+      insert(*new_index, *it, (std::size_t)it->hash_value);
+
+    shard.str_index.current.store(new_index, std::memory_order_release);
+  } else
+    insert(*index, entry, (std::size_t)entry.hash_value);
+}
+
+void ConcurrentStrTable::publishKey(Shard& shard, const Entry& entry)
+{
+  shard.keyed.push_back(&entry);
+
+  Index* index = shard.key_index.current.load(std::memory_order_relaxed);
+  if (shard.keyed.size() * 2 > index->capacity) {
+    Index* new_index = new Index(index->capacity * 2);
+    shard.key_index.all.push_back(std::unique_ptr<Index>(new_index));
+
+    for (std::vector<const Entry*>::const_iterator it = shard.keyed.begin(); it != shard.keyed.end(); ++it)
+      insert(*new_index, **it, keyHash((*it)->key));
+
+    shard.key_index.current.store(new_index, std::memory_order_release);
+  } else
+    insert(*index, entry, keyHash(entry.key));
+}
+
+Key ConcurrentStrTable::set(const std::string& s, StrTable::StrType type)
+{
+  return set(s.c_str(), (unsigned)s.size(), type);
+}
+
+Key ConcurrentStrTable::set(const char* s, StrTable::StrType type)
+{
+  if (s == NULL)
+    return 0;
+
+  if (!s[0])
+    return 0;
+
+  return set(s, (unsigned)strlen(s), type);
+}
+
+Key ConcurrentStrTable::set(const char* s, unsigned length, StrTable::StrType type)
+{
+  if (s == NULL)
+    return 0;
+
+  if (length == 0)
+    return 0;
+
+  unsigned long long hash64_value = StrTable::hash64(s, length);
+  Shard& str_shard = getStrShard(hash64_value);
+
+  // Fast path: the string is already in the table
+  const Entry* found = findEntry(*str_shard.str_index.current.load(std::memory_order_acquire), s, length, hash64_value);
+  if (found)
+    return found->key;
+
+  boost::mutex::scoped_lock str_lock(str_shard.str_mutex);
+
+  // Another thread may have inserted it in the meantime
+  found = findEntry(*str_shard.str_index.current.load(std::memory_order_relaxed), s, length, hash64_value);
+  if (found)
+    return found->key;
+
+  // The bucket hash is only needed for the new key
+  unsigned short hash_value = StrTable::hash(s, length);
+  unsigned bucket_index = hash_value % no_buckets;
+  Entry& entry = addEntry(str_shard, s, length, hash64_value, type);
+  {
+    Shard& key_shard = getKeyShard((Key)hash_value << 16);
+    boost::mutex::scoped_lock key_lock(key_shard.key_mutex);
+
+    entry.key = ((Key)hash_value << 16) | count[bucket_index]++;
+
+    if (count[bucket_index] == 0xFFFF)
+      common::WriteMsg::writeToErr( CMSG_BUCKET_IS_FULL, bucket_index);
+
+    publishKey(key_shard, entry);
+  }
+
+  // The key is published first, so whoever finds the string can also look up its key.
+  publishStr(str_shard, entry);
+  return entry.key;
+}
+
+Key ConcurrentStrTable::get(const std::string& s) const
+{
+  return get(s.c_str(), (unsigned)s.size());
+}
+
+Key ConcurrentStrTable::get(const char* s) const
+{
+  if (s == NULL)
+    return 0;
+
+  if (!s[0])
+    return 0;
+
+  return get(s, (unsigned)strlen(s));
+}
+
+Key ConcurrentStrTable::get(const char* s, unsigned length) const
+{
+  if (s == NULL)
+    return 0;
+
+  if (length == 0)
+    return 0;
+
+  unsigned long long hash_value = StrTable::hash64(s, length);
+  const Shard& shard = getStrShard(hash_value);
+
+  const Entry* entry = findEntry(*shard.str_index.current.load(std::memory_order_acquire), s, length, hash_value);
+  return entry ? entry->key : 0;
+}
+
+const std::string& ConcurrentStrTable::get(Key key) const
+{
+  static std::string empty_string;
+
+  const Shard& shard = getKeyShard(key);
+
+  const Entry* entry = findEntry(*shard.key_index.current.load(std::memory_order_acquire), key);
+  if (entry)
+    return entry->str;
+
+  return empty_string;
+}
+
+std::size_t ConcurrentStrTable::size() const
+{
+  return no_strings.load(std::memory_order_relaxed);
+}
+
+void ConcurrentStrTable::copyTo(StrTable& st) const
+{
+  st.no_buckets = no_buckets;
+  st.clear();
+  st.count = count;
+
+  for (unsigned i = 0; i <= shard_mask; ++i) {
+    const std::deque<Entry>& entries = shards[i].entries;
+    for (std::deque<Entry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+      st.insertEntry(it->key, it->str.c_str(), it->str.size(), it->hash_value, it->type);
+  }
+}
+
+} // columbus namespace
@@ -20,6 +20,7 @@
 
 #include <cstring>
 #include <cstdlib>
+#include <algorithm>
 #include <common/inc/WriteMessage.h>
 #include <io/inc/IO.h>
 #include "../inc/messages.h"
@@ -56,27 +57,27 @@ unsigned char random_numbers[] =  /* Table from p. 678.*/
    163,200,222,235,248,243,219, 10,152,131,123,229,203, 76,120,209
 };
 
-StrTable::StrTable(const unsigned buckets) : no_buckets(buckets), count(), str_table()
-#ifdef DOSTAT
-  , statistic_counter(NULL)
-#endif  
+// The index tables are always kept at most half full.
+static const std::size_t MIN_INDEX_CAPACITY = 1024;
+
+static inline std::size_t keyHash(Key key)
+{
+  unsigned long long h = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+  return (std::size_t)(h ^ (h >> 32));
+}
+
+StrTable::StrTable(const unsigned buckets) : no_buckets(buckets), count(), entries(), str_index(), key_index()
 {
-  str_table.resize(no_buckets);
   count.resize(no_buckets, 1);
+  rehash(MIN_INDEX_CAPACITY);
 
 #ifdef DOSTAT
-  statistic_counter = (table_stat*)calloc(no_buckets , sizeof(table_stat));
-  if (!statistic_counter) {
-    common::WriteMsg::writeToErr( CMSG_ERROR_MEMORY_ALLOCATION);
-    abort();
-  }
+  statistic_counter.number_of_search = 0;
+  statistic_counter.number_of_it = 0;
 #endif
 }
 
-StrTable::StrTable(const StrTable& st) : no_buckets(), count(), str_table()
-#ifdef DOSTAT
-  , statistic_counter(NULL)
-#endif  
+StrTable::StrTable(const StrTable& st) : no_buckets(), count(), entries(), str_index(), key_index()
 {
   copy(st);
 }
@@ -84,40 +85,25 @@ StrTable::StrTable(const StrTable& st) : no_buckets(), count(), str_table()
 StrTable::~StrTable()
 {
 #ifdef DOSTAT
-  for (unsigned i = 0; i < no_buckets; i++)
-    fprintf(stderr, "%03d[noe:%08lu nos:%08lu noit:%020llu avg:%.2lf]\n", i, statistic_counter[i].element_count, statistic_counter[i].number_of_search, statistic_counter[i].number_of_it, (double)statistic_counter[i].number_of_it / statistic_counter[i].number_of_search);
-
-  free(statistic_counter);
+  fprintf(stderr, "[noe:%08lu nos:%08lu noit:%020llu avg:%.2lf]\n", (unsigned long)entries.size(), statistic_counter.number_of_search, statistic_counter.number_of_it, (double)statistic_counter.number_of_it / statistic_counter.number_of_search);
 #endif
 }
 
 void StrTable::copy(const StrTable& st)
 {
+  if (this == &st)
+    return;
+
   no_buckets = st.no_buckets;
+  count = st.count;
+  entries = st.entries;
+  str_index = st.str_index;
+  key_index = st.key_index;
 
 #ifdef DOSTAT
-  free(statistic_counter);
-
-  statistic_counter = (table_stat*)calloc(no_buckets , sizeof(table_stat));
-  if (!statistic_counter) {
-    common::WriteMsg::writeToErr( CMSG_ERROR_MEMORY_ALLOCATION);
-    abort();
-  }
+  statistic_counter.number_of_search = 0;
+  statistic_counter.number_of_it = 0;
 #endif
-
-  count.clear();
-  count.resize(no_buckets);
-
-  str_table.clear();
-  str_table.resize(no_buckets);
-
-  for (unsigned i = 0; i < no_buckets; i++) {
-    count[i] = st.count[i];
-
-    for (Map::const_iterator it = st.str_table[i].begin(); it != st.str_table[i].end(); ++it) {
-      str_table[i].insert(Map::value_type(it->first, std::make_pair(it->second.first, it->second.second)));
-    }
-  }
 }
 
 StrTable& StrTable::operator=(const StrTable& rhs)
@@ -131,10 +117,40 @@ unsigned StrTable::getNumberOfBuckets() const
   return no_buckets;
 }
 
+void StrTable::clear()
+{
+  entries.clear();
+  str_index.clear();
+  key_index.clear();
+  rehash(MIN_INDEX_CAPACITY);
+}
+
+void StrTable::rehash(std::size_t capacity)
+{
+  str_index.assign(capacity, 0);
+  key_index.assign(capacity, 0);
+
+  const std::size_t mask = capacity - 1;
+
+  for (std::size_t i = 0; i < entries.size(); ++i) {
+    const Entry& entry = entries[i];
+
+    std::size_t pos = (std::size_t)entry.hash_value & mask;
+    while (str_index[pos])
+      pos = (pos + 1) & mask;
+    str_index[pos] = (unsigned)i + 1;
+
+    pos = keyHash(entry.key) & mask;
+    while (key_index[pos])
+      pos = (pos + 1) & mask;
+    key_index[pos] = (unsigned)i + 1;
+  }
+}
+
 /* Hashing function described in                   */
 /* "Fast Hashing of Variable-Length Text Strings," */
 /* by Peter K. Pearson, CACM, June 1990.           */
-unsigned short StrTable::hash(const char* string) const
+unsigned short StrTable::hash(const char* string)
 {
   unsigned hash_hi  = 0;
   unsigned hash_low = 0;
@@ -159,7 +175,7 @@ unsigned short StrTable::hash(const char* string) const
   return (hash_hi << 8) | hash_low;
 }
 
-unsigned short StrTable::hash(const char* string,unsigned long length) const
+unsigned short StrTable::hash(const char* string,unsigned long length)
 {
   unsigned hash_hi  = 0;
   unsigned hash_low = 0;
@@ -184,70 +200,163 @@ unsigned short StrTable::hash(const char* string,unsigned long length) const
   return (hash_hi << 8) | hash_low;
 }
 
-Key StrTable::set(const std::string& s, StrType type)
+/* MurmurHash64A by Austin Appleby (public domain). */
+unsigned long long StrTable::hash64(const char* s, std::size_t length)
 {
-  return set(s.c_str(), (unsigned)s.size(), type);
-}
+  const unsigned long long m = 0xc6a4a7935bd1e995ULL;
+  const int r = 47;
 
-Key StrTable::set(const char* s, unsigned length, StrType type)
-{
-  if (s == NULL)
-    return 0;
+  unsigned long long h = 0x5bd1e9955bd1e995ULL ^ (length * m);
 
-  if(length == 0)
-    return 0;
+  const char* end = s + (length & ~(std::size_t)7);
+  for (; s != end; s += 8) {
+    unsigned long long k;
+    memcpy(&k, s, 8);
 
-  Key key;
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+
+    h ^= k;
+    h *= m;
+  }
+
+  const unsigned char* tail = (const unsigned char*)s;
+  switch (length & 7) {
+    case 7: h ^= (unsigned long long)tail[6] << 48; // fall through
+    case 6: h ^= (unsigned long long)tail[5] << 40; // fall through
+    case 5: h ^= (unsigned long long)tail[4] << 32; // fall through
+    case 4: h ^= (unsigned long long)tail[3] << 24; // fall through
+    case 3: h ^= (unsigned long long)tail[2] << 16; // fall through
+    case 2: h ^= (unsigned long long)tail[1] << 8;  // fall through
+    case 1: h ^= (unsigned long long)tail[0];
+            h *= m;
+  }
+
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+
+  return h;
+}
+
+Key StrTable::newKey(const char* s, std::size_t length)
+{
   unsigned short hash_value = hash(s, length);
   unsigned bucket_index = hash_value % no_buckets;
 
-  // If the string does not exists in the table we insert it
-  if (!(key = get(s,length, hash_value, bucket_index))) {
+  Key key = ((Key)hash_value << 16) | count[bucket_index]++;
 
-    key = ((Key)hash_value << 16) | count[bucket_index]++;
+  if (count[bucket_index] == 0xFFFF)
+    common::WriteMsg::writeToErr( CMSG_BUCKET_IS_FULL, bucket_index);
 
-    if (count[bucket_index] == 0xFFFF)
-      common::WriteMsg::writeToErr( CMSG_BUCKET_IS_FULL, bucket_index);
+  return key;
+}
 
+StrTable::Entry& StrTable::insertEntry(Key key, const char* s, std::size_t length, unsigned long long hash_value, StrType type)
+{
+  if ((entries.size() + 1) * 2 > str_index.size())
+    rehash(str_index.size() * 2);
+
+  entries.push_back(Entry());
+  Entry& entry = entries.back();
+  entry.str.assign(s, length);
+  entry.hash_value = hash_value;
+  entry.key = key;
+  entry.type = type;
+
+  const std::size_t mask = str_index.size() - 1;
+  const unsigned index = (unsigned)entries.size();
+
+  std::size_t pos = (std::size_t)hash_value & mask;
+  while (str_index[pos])
+    pos = (pos + 1) & mask;
+  str_index[pos] = index;
+
+  pos = keyHash(key) & mask;
+  while (key_index[pos])
+    pos = (pos + 1) & mask;
+  key_index[pos] = index;
+
+  return entry;
+}
 
-    str_table[bucket_index].insert(Map::value_type(key, std::make_pair(std::string(s,length), type)));
+void StrTable::insertLoadedEntry(Key key, const char* s, std::size_t length)
+{
+  if ((entries.size() + 1) * 2 > str_index.size())
+    rehash(str_index.size() * 2);
+
+  // the free slot of the key is searched only once, it is also the check of the duplicated keys
+  const std::size_t mask = key_index.size() - 1;
+  std::size_t key_pos = keyHash(key) & mask;
+  for (; key_index[key_pos]; key_pos = (key_pos + 1) & mask)
+    if (entries[key_index[key_pos] - 1].key == key)
+      return;
+
+  unsigned long long hash_value = hash64(s, length);
+  entries.push_back(Entry());
+  Entry& entry = entries.back();
+  entry.str.assign(s, length);
+  entry.hash_value = hash_value;
+  entry.key = key;
+  entry.type = strDefault;
+
+  const unsigned index = (unsigned)entries.size();
+  key_index[key_pos] = index;
+
+  std::size_t pos = (std::size_t)hash_value & mask;
+  while (str_index[pos])
+    pos = (pos + 1) & mask;
+  str_index[pos] = index;
+}
 
-#ifdef DOSTAT
-    statistic_counter[bucket_index].element_count++;
-#endif
+const StrTable::Entry* StrTable::findEntry(Key key) const
+{
+  const std::size_t mask = key_index.size() - 1;
+
+  for (std::size_t pos = keyHash(key) & mask; key_index[pos]; pos = (pos + 1) & mask) {
+    const Entry& entry = entries[key_index[pos] - 1];
+    if (entry.key == key)
+      return &entry;
   }
-  return key;
+
+  return NULL;
 }
 
-Key StrTable::set(const char* s, StrType type)
+Key StrTable::set(const std::string& s, StrType type)
+{
+  return set(s.c_str(), (unsigned)s.size(), type);
+}
+
+Key StrTable::set(const char* s, unsigned length, StrType type)
 {
   if (s == NULL)
     return 0;
 
-  if (!s[0])
+  if(length == 0)
     return 0;
 
+  unsigned long long hash_value = hash64(s, length);
   Key key;
-  unsigned short hash_value = hash(s);
-  unsigned bucket_index = hash_value % no_buckets;
 
   // If the string does not exists in the table we insert it
-  if (!(key = get(s, strlen(s), hash_value, bucket_index))) {
-
-    key = ((Key)hash_value << 16) | count[bucket_index]++;
-
-    if (count[bucket_index] == 0xFFFF)
-      common::WriteMsg::writeToErr( CMSG_BUCKET_IS_FULL, bucket_index);
+  if (!(key = get(s, length, hash_value))) {
+    key = newKey(s, length);
+    insertEntry(key, s, length, hash_value, type);
+  }
 
+  return key;
+}
 
-    str_table[bucket_index].insert(Map::value_type(key, std::make_pair(s, type)));
+Key StrTable::set(const char* s, StrType type)
+{
+  if (s == NULL)
+    return 0;
 
-#ifdef DOSTAT
-    statistic_counter[bucket_index].element_count++;
-#endif
-  }
+  if (!s[0])
+    return 0;
 
-  return key;
+  return set(s, (unsigned)strlen(s), type);
 }
 
 void StrTable::setType(const char *s, StrType type)
@@ -258,52 +367,41 @@ void StrTable::setType(const char *s, StrType type)
   if (!s[0])
     return;
 
+  size_t length = strlen(s);
+  unsigned long long hash_value = hash64(s, length);
   Key key;
-  unsigned short hash_value = hash(s);
-  unsigned bucket_index = hash_value % no_buckets;
 
   // If the string does not exists in the table we insert it
-  if (!(key = get(s, strlen(s), hash_value, bucket_index))) {
-
-    key = ((Key)hash_value << 16) | count[bucket_index]++;
-
-    if (count[bucket_index] == 0xFFFF)
-      common::WriteMsg::writeToErr( CMSG_BUCKET_IS_FULL, bucket_index);
-
-    str_table[bucket_index].insert(Map::value_type(key, std::make_pair(s, type)));
-
-#ifdef DOSTAT
-    statistic_counter[bucket_index].element_count++;
-#endif
+  if (!(key = get(s, length, hash_value))) {
+    key = newKey(s, length);
+    insertEntry(key, s, length, hash_value, type);
   } else    // Just modify the type of it
-    str_table[bucket_index].find(key)->second.second = type;
+    const_cast<Entry*>(findEntry(key))->type = type;
 }
 
 void StrTable::setType(const Key key, StrType type)
 {
-  unsigned bucket_index = (key >>16) % no_buckets;
-
-  Map::iterator it = str_table[bucket_index].find(key);
-  if (it != str_table[bucket_index].end())
-    it->second.second = type;
+  Entry* entry = const_cast<Entry*>(findEntry(key));
+  if (entry)
+    entry->type = type;
 }
 
-Key StrTable::get(const char* s, size_t length, unsigned short hash_value, unsigned bucket_index) const
+Key StrTable::get(const char* s, size_t length, unsigned long long hash_value) const
 {
   // It does not check the s because it is already checked in StrTable::set or in StrTable::get.
 #ifdef DOSTAT
-  statistic_counter[bucket_index].number_of_search++;
+  statistic_counter.number_of_search++;
 #endif
 
-  Map::const_iterator from = str_table[bucket_index].lower_bound((Key)hash_value << 16);
-  Map::const_iterator to = str_table[bucket_index].upper_bound(((Key)hash_value << 16) + 0xFFFF);
+  const std::size_t mask = str_index.size() - 1;
 
-  for(Map::const_iterator it = from; it != to; ++it) {
+  for (std::size_t pos = (std::size_t)hash_value & mask; str_index[pos]; pos = (pos + 1) & mask) {
 #ifdef DOSTAT
-    statistic_counter[bucket_index].number_of_it++;
+    statistic_counter.number_of_it++;
 #endif
-    if ((it->second.first.length() == length)&&(it->second.first.compare(0,length,s,length) == 0)) {
-      return it->first;
+    const Entry& entry = entries[str_index[pos] - 1];
+    if ((entry.hash_value == hash_value) && (entry.str.length() == length) && (entry.str.compare(0, length, s, length) == 0)) {
+      return entry.key;
     }
   }
   return 0;
@@ -322,10 +420,7 @@ Key StrTable::get(const char* s) const
   if (!s[0])
     return 0;
 
-  unsigned short hash_value = hash(s);
-  unsigned bucket_index = hash_value % no_buckets;
-
-  return get(s, strlen(s), hash_value, bucket_index);
+  return get(s, (unsigned)strlen(s));
 }
 
 Key StrTable::get(const char* s, unsigned length) const
@@ -336,25 +431,51 @@ Key StrTable::get(const char* s, unsigned length) const
   if (length == 0)
     return 0;
 
-  unsigned short hash_value = hash(s, length);
-  unsigned bucket_index = hash_value % no_buckets;
-
-  return get(s, length, hash_value, bucket_index);
-
+  return get(s, length, hash64(s, length));
 }
 
 const std::string& StrTable::get(Key key) const
 {
   static std::string empty_string;
-  unsigned bucket_index = (key >>16) % no_buckets;
 
-  Map::const_iterator it = str_table[bucket_index].find(key);
-  if (it != str_table[bucket_index].end())
-    return it->second.first;
+  const Entry* entry = findEntry(key);
+  if (entry)
+    return entry->str;
 
   return empty_string;
 }
 
+std::vector<unsigned> StrTable::getSaveOrder(StrType filterType) const
+{
+  // The format requires the strings grouped by bucket and ordered by key inside the buckets. The order is
+  // sorted by (bucket, key) packed into one number, so the comparisons do not have to reach the entries.
+  std::vector<std::pair<unsigned long long, unsigned> > sorted;
+  sorted.reserve(entries.size());
+
+  for (unsigned i = 0; i < entries.size(); ++i) {
+    const Entry& entry = entries[i];
+    if (filterType == strTmp) {      // In tmp mode nodes with tmp flag will be skipped.
+      if (entry.type == strTmp)
+        continue;
+    } else
+      if (filterType == strToSave)  // In save mode only nodes with save flag will be written out.
+        if (entry.type != strToSave)
+          continue;
+
+    unsigned long long bucket = (entry.key >> 16) % no_buckets;
+    sorted.push_back(std::make_pair((bucket << 32) | entry.key, i));
+  }
+
+  std::sort(sorted.begin(), sorted.end());
+
+  std::vector<unsigned> order;
+  order.reserve(sorted.size());
+  for (std::vector<std::pair<unsigned long long, unsigned> >::const_iterator it = sorted.begin(); it != sorted.end(); ++it)
+    order.push_back(it->second);
+
+  return order;
+}
+
 void StrTable::save(FILE* file, StrType filterType) const
 {
   CHECKIO(fwrite("STRTBL", 6, 1, file), CMSG_WRITE_ERR);     // ID string (6)
@@ -366,29 +487,19 @@ void StrTable::save(FILE* file, StrType filterType) const
   }
 
   // write out each element
-  for (unsigned j = 0; j < no_buckets; j++) {
-    const Map& current_map = str_table[j];
+  std::vector<unsigned> order = getSaveOrder(filterType);
+  for (std::vector<unsigned>::const_iterator it = order.begin(); it != order.end(); ++it) {
+    const Entry& entry = entries[*it];
 
-    for (Map::const_iterator it = current_map.begin(); it != current_map.end(); ++it) {
-      if (filterType == strTmp) {      // In tmp mode nodes with tmp flag will be skipped.
-        if (it->second.second == strTmp)
-          continue;
-      } else
-        if (filterType == strToSave)  // In save mode only nodes with save flag will be written out.
-          if (it->second.second != strToSave)
-            continue;
-
-      CHECKIO(fwrite(&it->first, 4, 1, file), CMSG_WRITE_ERR);   // The key (4)
-      unsigned str_size = (unsigned)it->second.first.size();
-      CHECKIO(fwrite(&str_size, 4, 1, file), CMSG_WRITE_ERR);    // Size of the string (4)
+    CHECKIO(fwrite(&entry.key, 4, 1, file), CMSG_WRITE_ERR);   // The key (4)
+    unsigned str_size = (unsigned)entry.str.size();
+    CHECKIO(fwrite(&str_size, 4, 1, file), CMSG_WRITE_ERR);    // Size of the string (4)
 
-      CHECKIO(fwrite(it->second.first.c_str(), str_size, 1, file), CMSG_WRITE_ERR); // Characters of the string (n)
-
-    }
+    CHECKIO(fwrite(entry.str.c_str(), str_size, 1, file), CMSG_WRITE_ERR); // Characters of the string (n)
   }
 
   // Write out the end of StringTable sign
-  unsigned long end_sign = 0;
+  unsigned end_sign = 0;
   CHECKIO(fwrite(&end_sign, 4, 1, file), CMSG_WRITE_ERR);    
  
 }
@@ -403,23 +514,14 @@ void StrTable::save(columbus::io::BinaryIO& file, StrType filterType) const
     file.writeUShort2(ic);  // no_buckets x Internal counter (2)
   }
 
-  for (unsigned j = 0; j < no_buckets; j++) {
-    const Map& current_map = str_table[j];
+  std::vector<unsigned> order = getSaveOrder(filterType);
+  for (std::vector<unsigned>::const_iterator it = order.begin(); it != order.end(); ++it) {
+    const Entry& entry = entries[*it];
 
-    for (Map::const_iterator it = current_map.begin(); it != current_map.end(); ++it) {
-      if (filterType == strTmp) {      // In tmp mode nodes with tmp flag will be skipped.
-        if (it->second.second == strTmp)
-          continue;
-      } else
-        if (filterType == strToSave)  // In save mode only nodes with save flag will be written out.
-          if (it->second.second != strToSave)
-            continue;
-
-      file.writeUInt4(it->first);
-      size_t str_size = it->second.first.size();
-      file.writeUInt4((unsigned)str_size);
-      file.writeData(it->second.first.c_str(), str_size);
-    }
+    file.writeUInt4(entry.key);
+    size_t str_size = entry.str.size();
+    file.writeUInt4((unsigned)str_size);
+    file.writeData(entry.str.c_str(), str_size);
   }
     // Write out the end of StringTable sign
   file.writeUInt4(0);
@@ -435,28 +537,18 @@ void StrTable::load(FILE* file)
   }
 
   CHECKIO(fread(&no_buckets, 4, 1, file), CMSG_READ_ERR);
-  str_table.clear();
-  str_table.resize(no_buckets);
+  clear();
 
   count.clear();
   count.resize(no_buckets, 0);
 
-#ifdef DOSTAT
-  free(statistic_counter);
-
-  statistic_counter = (table_stat*)calloc(no_buckets , sizeof(table_stat));
-  if (!statistic_counter) {
-    common::WriteMsg::writeToErr( CMSG_ERROR_MEMORY_ALLOCATION);
-    abort();
-  }
-#endif
-
   for (unsigned i = 0; i < no_buckets; i++) {
     unsigned short ic;
     CHECKIO(fread(&ic, 2, 1, file), CMSG_READ_ERR);     // no_buckets x Internal counter (2)
     count[i] = ic;
   }
   
+  std::string buffer;
   while (true) {
     Key key = 0;
 
@@ -469,17 +561,11 @@ void StrTable::load(FILE* file)
     unsigned str_size;
     CHECKIO(fread(&str_size, 4, 1, file), CMSG_READ_ERR); // Size of the string (4)
 
-    char* buffer = (char*)calloc(1, str_size + 1);
-    if (!buffer) {
-      common::WriteMsg::writeToErr( CMSG_LOAD_ERROR);
-      abort();
-    }
+    buffer.resize(str_size);
+    if (str_size)
+      CHECKIO(fread(&buffer[0], str_size, 1, file), CMSG_READ_ERR);  // Characters of the string (n)
 
-    CHECKIO(fread(buffer, str_size, 1, file), CMSG_READ_ERR);  // Characters of the string (n)
-    unsigned bucket_index = (key >>16) % no_buckets;
-    str_table[bucket_index].insert(Map::value_type(key, std::make_pair(std::string(buffer, str_size), strDefault)));
-    
-    free(buffer);
+    insertLoadedEntry(key, buffer.data(), str_size);
   }
 }
 
@@ -493,22 +579,11 @@ void StrTable::load(columbus::io::BinaryIO& file)
   }
 
   no_buckets = file.readUInt4();
-  str_table.clear();
-  str_table.resize(no_buckets);
+  clear();
 
   count.clear();
   count.resize(no_buckets, 0);
 
-#ifdef DOSTAT
-  free(statistic_counter);
-
-  statistic_counter = (table_stat*)calloc(no_buckets , sizeof(table_stat));
-  if (!statistic_counter) {
-    common::WriteMsg::writeToErr( CMSG_ERROR_MEMORY_ALLOCATION);
-    abort();
-  }
-#endif
-
   for (unsigned i = 0; i < no_buckets; i++) {
     count[i] = file.readUShort2();  // no_buckets x Internal counter (2)
   }
@@ -523,37 +598,33 @@ void StrTable::load(columbus::io::BinaryIO& file)
 
     unsigned str_size = file.readUInt4(); // Size of the string (4)
 
-    char* buffer = (char*)calloc(1, str_size + 1);
-    if (!buffer) {
-      common::WriteMsg::writeToErr( CMSG_LOAD_ERROR);
-      abort();
-    }
-
-    file.readData(buffer, str_size); // Characters of the string (n)
+    const char* data = file.readDataView(str_size); // Characters of the string (n)
 
-    unsigned bucket_index = (key >>16) % no_buckets;
-    str_table[bucket_index].insert(Map::value_type(key, std::make_pair(std::string(buffer, str_size), strDefault)));
-
-    free(buffer);
+    insertLoadedEntry(key, data, str_size);
   }
 }
 
 void StrTable::dump()
 {
-  unsigned i = 0;
-  Map::size_type total_counter = 0;
-  for (std::vector<Map>::const_iterator it = str_table.begin(); it != str_table.end(); ++it) {
-    common::WriteMsg::write( CMSG_BUCKET_TOTAL_NUMBER, i++, it->size());
-    for (Map::const_iterator sit = it->begin(); sit != it->end(); ++sit)
-      printf("[%X]:[%s][%d]\n", sit->first, sit->second.first.c_str(),  sit->second.second);
-    total_counter += it->size();
+  std::vector<unsigned> order = getSaveOrder(strDefault);
+  std::vector<unsigned> bucket_sizes(no_buckets, 0);
+  for (std::vector<unsigned>::const_iterator it = order.begin(); it != order.end(); ++it)
+    bucket_sizes[(entries[*it].key >> 16) % no_buckets]++;
+
+  std::vector<unsigned>::const_iterator it = order.begin();
+  for (unsigned i = 0; i < no_buckets; ++i) {
+    common::WriteMsg::write( CMSG_BUCKET_TOTAL_NUMBER, i, (size_t)bucket_sizes[i]);
+    for (unsigned j = 0; j < bucket_sizes[i]; ++j, ++it) {
+      const Entry& entry = entries[*it];
+      printf("[%X]:[%s][%d]\n", entry.key, entry.str.c_str(), entry.type);
+    }
   }
   
   for (unsigned i = 0; i < no_buckets; ++i) {
     printf("Counter[%u]:%hu\n", i, count[i]);
   }
   
-  common::WriteMsg::write( CMSG_TOTAL_COUNT, total_counter);
+  common::WriteMsg::write( CMSG_TOTAL_COUNT, entries.size());
 }
 
 } // columbus namespace
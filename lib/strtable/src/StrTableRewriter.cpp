@@ -0,0 +1,188 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include "../inc/StrTableRewriter.h"
+
+namespace columbus {
+
+namespace {
+
+  // The string table is written in little endian (see Factory::save).
+  unsigned readUInt4(const std::string& content, std::size_t pos)
+  {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(content.data() + pos);
+    return (unsigned)data[0] | ((unsigned)data[1] << 8) | ((unsigned)data[2] << 16) | ((unsigned)data[3] << 24);
+  }
+
+  void writeUInt4(std::string& content, unsigned value)
+  {
+    for (int i = 0; i < 4; ++i) {
+      content.push_back((char)(value & 0xFF));
+      value >>= 8;
+    }
+  }
+
+  const char   TABLE_ID[] = "STRTBL";
+  const size_t TABLE_ID_SIZE = 6;
+  const size_t END_MARK_SIZE = 6;   // NodeId (4) + NodeKind (2)
+
+}
+
+bool StrTableRewriter::isTable(const std::string& content, std::size_t offset)
+{
+  const size_t size = content.size();
+  if (offset < END_MARK_SIZE || offset + TABLE_ID_SIZE + 4 > size)
+    return false;
+
+  for (size_t i = offset - END_MARK_SIZE; i < offset; ++i)
+    if (content[i] != 0)
+      return false;
+
+  if (content.compare(offset, TABLE_ID_SIZE, TABLE_ID) != 0)
+    return false;
+
+  size_t pos = offset + TABLE_ID_SIZE;
+  const unsigned buckets = readUInt4(content, pos);
+  pos += 4;
+  if (buckets == 0 || (size - pos) / 2 < buckets)
+    return false;
+  pos += 2 * (size_t)buckets;
+
+  // The entries are grouped by bucket and ordered by key inside the buckets (see StrTable::getSaveOrder).
+  unsigned lastBucket = 0;
+  Key lastKey = 0;
+  while (pos + 4 <= size) {
+    Key key = readUInt4(content, pos);
+    pos += 4;
+    if (!key)
+      return pos == size;
+
+    unsigned bucket = (key >> 16) % buckets;
+    if (lastKey && (bucket < lastBucket || (bucket == lastBucket && key <= lastKey)))
+      return false;
+    lastBucket = bucket;
+    lastKey = key;
+
+    if (pos + 4 > size)
+      return false;
+    unsigned length = readUInt4(content, pos);
+    pos += 4;
+    if (size - pos < length)
+      return false;
+    pos += length;
+  }
+  return false;
+}
+
+std::size_t StrTableRewriter::locate(const std::string& content)
+{
+  size_t found = std::string::npos;
+  for (size_t pos = content.find(TABLE_ID); pos != std::string::npos; pos = content.find(TABLE_ID, pos + 1)) {
+    if (isTable(content, pos)) {
+      if (found != std::string::npos)
+        return std::string::npos;
+      found = pos;
+    }
+  }
+  return found;
+}
+
+StrTableRewriter::Result StrTableRewriter::rewrite(const std::string& inFilename, const std::string& outFilename, const Rewrite& rewrite, unsigned& changed)
+{
+  return StrTableRewriter::rewrite(inFilename, outFilename, rewrite, NULL, changed);
+}
+
+StrTableRewriter::Result StrTableRewriter::rewrite(const std::string& inFilename, const std::string& outFilename, const Rewrite& rewrite, const KeySet& keys, unsigned& changed)
+{
+  return StrTableRewriter::rewrite(inFilename, outFilename, rewrite, &keys, changed);
+}
+
+StrTableRewriter::Result StrTableRewriter::rewrite(const std::string& inFilename, const std::string& outFilename, const Rewrite& rewrite, const KeySet* keys, unsigned& changed)
+{
+  changed = 0;
+
+  std::string content;
+  {
+    std::ifstream in(inFilename.c_str(), std::ios::in | std::ios::binary);
+    if (!in)
+      return rrIOError;
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    if (in.bad())
+      return rrIOError;
+    content = buffer.str();
+  }
+
+  const size_t offset = locate(content);
+  if (offset == std::string::npos)
+    return rrNotFound;
+
+  // The nodes, the end mark, the tag, the number of buckets and the bucket counters are kept as they are.
+  size_t pos = offset + TABLE_ID_SIZE;
+  const unsigned buckets = readUInt4(content, pos);
+  pos += 4 + 2 * (size_t)buckets;
+
+  std::string result;
+  result.reserve(content.size());
+  result.append(content, 0, pos);
+
+  // The table contains every string only once, so the keys can be kept only if the changed strings remain unique.
+  std::unordered_set<std::string> strings;
+  std::string str;
+  while (true) {
+    Key key = readUInt4(content, pos);
+    pos += 4;
+    writeUInt4(result, key);
+    if (!key)
+      break;
+
+    unsigned length = readUInt4(content, pos);
+    pos += 4;
+    str.assign(content, pos, length);
+    pos += length;
+
+    if ((!keys || keys->count(key)) && rewrite(str))
+      ++changed;
+
+    if (!strings.insert(str).second)
+      return rrConflict;
+
+    writeUInt4(result, (unsigned)str.size());
+    result.append(str);
+  }
+
+  if (!changed)
+    return rrUnchanged;
+
+  std::ofstream out(outFilename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out)
+    return rrIOError;
+  out.write(result.data(), result.size());
+  out.close();
+  if (!out)
+    return rrIOError;
+
+  return rrRewritten;
+}
+
+} // namespace columbus
@@ -25,6 +25,9 @@
 #include<queue>
 #include<stack>
 #include<map>
+#include<algorithm>
+
+#include <threadpool/inc/Executor.h>
 
 #include "sequence.h"
 
@@ -383,6 +386,228 @@ public:
 };
 
 
+template<class T>
+class SaisSuffixArray : public SuffixArray<T> {
+
+  using SuffixArray<T>::sequence;
+  using SuffixArray<T>::suffixes;
+
+protected:
+
+  static const unsigned EMPTY = (unsigned)-1;
+
+  // the number of the positions processed by one task of the parallel loops
+  static const unsigned BLOCK_SIZE = 1 << 16;
+
+  columbus::thread::Executor* executor;
+
+  // calls func(begin, end) for the consecutive blocks of [0, n), in parallel if there is an executor
+  template<class Func>
+  void forEachBlock(unsigned n, const Func& func) {
+    unsigned blocks = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    if(executor == NULL || executor->getConcurrency() < 2 || blocks < 2) {
+      func(0, n);
+      return;
+    }
+    columbus::thread::parallel_for(*executor, 0u, blocks, 1u, [&](unsigned block) {
+      func(block * BLOCK_SIZE, std::min(n, (block + 1) * BLOCK_SIZE));
+    });
+  }
+
+  // gives the start (or the end) of the buckets of the characters
+  static void getBuckets(const unsigned* s, unsigned n, unsigned* bkt, unsigned K, bool end) {
+    std::fill(bkt, bkt + K, 0);
+    for(unsigned i = 0; i < n; ++i) bkt[s[i]]++;
+    for(unsigned i = 0, sum = 0; i < K; ++i) {
+      sum += bkt[i];
+      bkt[i] = end ? sum : sum - bkt[i];
+    }
+  }
+
+  // induces the order of the L-type suffixes from the sorted LMS suffixes
+  static void induceL(const std::vector<bool>& t, unsigned* SA, const unsigned* s, unsigned* bkt, unsigned n, unsigned K) {
+    getBuckets(s, n, bkt, K, false);
+    for(unsigned i = 0; i < n; ++i) {
+      if(SA[i] != EMPTY && SA[i] > 0) {
+        unsigned j = SA[i] - 1;
+        if(!t[j]) SA[bkt[s[j]]++] = j;
+      }
+    }
+  }
+
+  // induces the order of the S-type suffixes from the sorted L-type suffixes
+  static void induceS(const std::vector<bool>& t, unsigned* SA, const unsigned* s, unsigned* bkt, unsigned n, unsigned K) {
+    getBuckets(s, n, bkt, K, true);
+    for(unsigned i = n; i-- > 0;) {
+      if(SA[i] != EMPTY && SA[i] > 0) {
+        unsigned j = SA[i] - 1;
+        if(t[j]) SA[--bkt[s[j]]] = j;
+      }
+    }
+  }
+
+  static inline bool isLMS(const std::vector<bool>& t, unsigned i) {
+    return i > 0 && t[i] && !t[i-1];
+  }
+
+  // find the suffix array SA of s[0..n-1] in {0..K-1}^n
+  // require s[n-1]=0 to be the unique smallest character, n>=2
+  // the reduced problem of the recursion is stored in the unused part of SA
+  static void suffixArray(const unsigned* s, unsigned* SA, unsigned n, unsigned K) {
+    // classify the suffixes: true means S-type, false means L-type
+    std::vector<bool> t(n);
+    t[n-1] = true;
+    t[n-2] = false;
+    for(unsigned i = n - 2; i-- > 0;)
+      t[i] = s[i] < s[i+1] || (s[i] == s[i+1] && t[i+1]);
+
+    // sort the LMS substrings
+    std::vector<unsigned> bkt(K);
+    getBuckets(s, n, &bkt[0], K, true);
+    std::fill(SA, SA + n, EMPTY);
+    for(unsigned i = 1; i < n; ++i)
+      if(isLMS(t, i)) SA[--bkt[s[i]]] = i;
+    induceL(t, SA, s, &bkt[0], n, K);
+    induceS(t, SA, s, &bkt[0], n, K);
+
+    // compact the sorted LMS substrings into the first n1 items of SA
+    unsigned n1 = 0;
+    for(unsigned i = 0; i < n; ++i)
+      if(isLMS(t, SA[i])) SA[n1++] = SA[i];
+
+    // name the LMS substrings
+    std::fill(SA + n1, SA + n, EMPTY);
+    unsigned name = 0, prev = EMPTY;
+    for(unsigned i = 0; i < n1; ++i) {
+      unsigned pos = SA[i];
+      bool diff = false;
+      for(unsigned d = 0; ; ++d) {
+        if(prev == EMPTY || s[pos+d] != s[prev+d] || t[pos+d] != t[prev+d]) {
+          diff = true;
+          break;
+        } else if(d > 0 && (isLMS(t, pos+d) || isLMS(t, prev+d)))
+          break;
+      }
+      if(diff) {
+        name++;
+        prev = pos;
+      }
+      SA[n1 + pos / 2] = name - 1;
+    }
+    for(unsigned i = n, j = n; i-- > n1;)
+      if(SA[i] != EMPTY) SA[--j] = SA[i];
+
+    // sort the LMS suffixes, recurse if names are not yet unique
+    unsigned* SA1 = SA;
+    unsigned* s1 = SA + n - n1;
+    if(name < n1)
+      suffixArray(s1, SA1, n1, name);
+    else
+      for(unsigned i = 0; i < n1; ++i) SA1[s1[i]] = i;
+
+    // induce the suffix array from the sorted LMS suffixes
+    getBuckets(s, n, &bkt[0], K, true);
+    for(unsigned i = 1, j = 0; i < n; ++i)
+      if(isLMS(t, i)) s1[j++] = i;
+    for(unsigned i = 0; i < n1; ++i)
+      SA1[i] = s1[SA1[i]];
+    std::fill(SA + n1, SA + n, EMPTY);
+    for(unsigned i = n1; i-- > 0;) {
+      unsigned j = SA[i];
+      SA[i] = EMPTY;
+      SA[--bkt[s[j]]] = j;
+    }
+    induceL(t, SA, s, &bkt[0], n, K);
+    induceS(t, SA, s, &bkt[0], n, K);
+  }
+
+  /*
+   * paper:
+   * Juha Karkkainen, Giovanni Manzini, Simon J. Puglisi
+   * Permuted Longest-Common-Prefix Array
+   *
+   * The Phi array (the previous suffix of each suffix in the sorted order) is built in the place of the
+   * suffix array and it is replaced by the permuted LCP array in text order, so no Rank array is needed.
+   * The text is processed in blocks in parallel, every block starts the matching from zero.
+   */
+  void computeLCP(const unsigned* normSeq, unsigned* sa, unsigned n) {
+    suffixes = new typename SuffixArray<T>::SuffixArrayElement[n];
+    // sa[0] is the sentinel
+    forEachBlock(n, [&](unsigned begin, unsigned end) {
+      for(unsigned i = begin; i < end; ++i)
+        suffixes[i].position = sa[i+1];
+    });
+
+    unsigned* phi = sa;
+    forEachBlock(n, [&](unsigned begin, unsigned end) {
+      for(unsigned i = begin; i < end; ++i)
+        phi[suffixes[i].position] = i > 0 ? suffixes[i-1].position : EMPTY;
+    });
+
+    unsigned* plcp = phi;
+    forEachBlock(n, [&](unsigned begin, unsigned end) {
+      unsigned h = 0;
+      for(unsigned i = begin; i < end; ++i) {
+        unsigned k = phi[i];
+        if(k == EMPTY) {
+          h = 0;
+        } else {
+          while(normSeq[i+h] == normSeq[k+h]) h++;
+        }
+        plcp[i] = h;
+        if(h > 0) h--;
+      }
+    });
+
+    forEachBlock(n, [&](unsigned begin, unsigned end) {
+      for(unsigned i = begin; i < end; ++i)
+        suffixes[i].lcp = plcp[suffixes[i].position];
+    });
+  }
+
+public:
+
+    /**
+     * Paper:
+     * Linear Suffix Array Construction by Almost Pure Induced-Sorting
+     * Ge Nong, Sen Zhang, Wai Hong Chan
+     *
+     * \param _executor The normalization of the sequence and the LCP computation run on it if it is not NULL.
+     */
+  SaisSuffixArray(Sequence<T>& _sequence, columbus::thread::Executor* _executor = NULL) : SuffixArray<T>(_sequence), executor(_executor) {
+    if(_sequence.getLength() > 1) {
+      unsigned n = sequence.getLength();
+
+      // create normalize map
+      std::vector<T> values;
+      {
+        std::set<T> valueSet;
+        for(unsigned i = 0; i < n; ++i) {
+          valueSet.insert(sequence[i]);
+        }
+        values.assign(valueSet.begin(), valueSet.end());
+      }
+
+      // create normalized sequence, 0 is the sentinel
+      unsigned* normSeq = new unsigned[n + 1];
+      forEachBlock(n, [&](unsigned begin, unsigned end) {
+        for(unsigned i = begin; i < end; ++i)
+          normSeq[i] = (unsigned)(std::lower_bound(values.begin(), values.end(), sequence[i]) - values.begin()) + 1;
+      });
+      normSeq[n] = 0;
+      unsigned K = (unsigned)values.size() + 1;
+      std::vector<T>().swap(values);
+
+      unsigned* sa = new unsigned[n + 1];
+      suffixArray(normSeq, sa, n + 1, K);
+      computeLCP(normSeq, sa, n);
+      delete[] sa;
+      delete[] normSeq;
+    }
+  }
+};
+
+
 template<class T>
 class UniversalSuffixArray : public SuffixArray<T> {
 
@@ -0,0 +1,315 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#ifndef _EXECUTOR_H
+#define _EXECUTOR_H
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include <future>
+#include <exception>
+
+#include <boost/smart_ptr/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+/**
+ * \file Executor.h
+ * \brief Interface of the work-stealing executor and its helpers
+ *
+ */
+
+namespace columbus { namespace thread {
+
+  /**
+   * \brief Work-stealing executor with a fixed number of worker threads.
+   *
+   * Every worker has its own deque. The tasks submitted from a worker are pushed into the back of its own deque
+   * and the worker pops its tasks from the back, while the idle workers steal from the front of the other deques.
+   * The tasks submitted from outside of the executor are distributed among the workers in round robin order.
+   * The threads waiting for a TaskGroup execute the pending tasks meanwhile, so the nested use of the executor
+   * does not start new threads and never exceeds the concurrency of the executor.
+   */
+  class Executor {
+  public:
+    typedef std::function<void()> Job;
+
+    /**
+     * \brief constructor, starts the worker threads
+     * \param concurrency [in] the number of worker threads (0 means the number of cpu cores)
+     */
+    Executor(unsigned concurrency = 0);
+
+    /**
+     * \brief destructor, executes the remaining tasks and stops the worker threads
+     */
+    ~Executor();
+
+    /**
+     * \brief gives the number of the worker threads
+     */
+    unsigned getConcurrency() const;
+
+    /**
+     * \brief schedules a task for execution
+     * \param job [in] the task
+     */
+    void spawn(const Job& job);
+
+    /**
+     * \brief schedules a function for execution
+     * \param func [in] the function
+     * \return the future of the result of the function
+     * \note Waiting for the future inside a task of the same executor can block a worker thread, use a TaskGroup instead.
+     */
+    template <typename Func>
+    std::future<typename std::result_of<Func()>::type> submit(Func func)
+    {
+      typedef typename std::result_of<Func()>::type Result;
+      boost::shared_ptr<std::packaged_task<Result()> > task(new std::packaged_task<Result()>(func));
+      std::future<Result> result = task->get_future();
+      spawn([task]() { (*task)(); });
+      return result;
+    }
+
+    /**
+     * \brief executes one pending task on the calling thread, if there is any
+     * \return true if a task was executed
+     */
+    bool runPendingTask();
+
+    /**
+     * \brief gives the executor shared by the whole program
+     * \note Its concurrency can be set by setGlobalConcurrency() before the first call.
+     */
+    static Executor& global();
+
+    /**
+     * \brief sets the concurrency of the global executor
+     * \param concurrency [in] the number of worker threads (0 means the number of cpu cores)
+     * \return false if the global executor is already running
+     */
+    static bool setGlobalConcurrency(unsigned concurrency);
+
+  private:
+    struct Worker {
+      boost::mutex mutex;
+      std::deque<Job> jobs;
+    };
+
+    Executor(const Executor&);
+    Executor& operator=(const Executor&);
+
+    void workerLoop(unsigned id);
+    bool popJob(unsigned id, Job& job);
+    bool stealJob(unsigned id, Job& job);
+
+    /**
+     * \internal \brief the per worker deques
+     */
+    std::vector<Worker*> _workers;
+
+    /**
+     * \internal \brief the worker threads
+     */
+    boost::thread_group _threads;
+
+    /**
+     * \internal \brief the number of the queued tasks and the sleeping workers are guarded by this mutex
+     */
+    boost::mutex _idleMutex;
+
+    /**
+     * \internal \brief the sleeping workers wait for this condition variable
+     */
+    boost::condition_variable _idleCond;
+
+    /**
+     * \internal \brief the number of the tasks in the deques
+     */
+    size_t _queued;
+
+    /**
+     * \internal \brief the next worker receiving an external task
+     */
+    unsigned _nextWorker;
+
+    /**
+     * \internal \brief true if the workers have to stop
+     */
+    bool _stop;
+  };
+
+  /**
+   * \brief Set of tasks which can be waited for together.
+   *
+   * The tasks of a group can start new tasks in the same or in another group. The first exception thrown by a
+   * task of the group is rethrown by wait().
+   */
+  class TaskGroup {
+  public:
+    /**
+     * \brief constructor
+     * \param executor [in] the executor running the tasks of the group
+     */
+    TaskGroup(Executor& executor = Executor::global());
+
+    /**
+     * \brief destructor, waits for the tasks of the group
+     */
+    ~TaskGroup();
+
+    /**
+     * \brief schedules a task in the group
+     * \param job [in] the task
+     */
+    void run(const Executor::Job& job);
+
+    /**
+     * \brief waits until all tasks of the group are finished and executes pending tasks meanwhile
+     * \throw The first exception thrown by a task of the group.
+     * \note The pending tasks executed meanwhile are not necessarily the tasks of this group, they can be any task of
+     *       the executor. Therefore the caller must not hold a lock which can be needed by another task.
+     */
+    void wait();
+
+    /**
+     * \brief gives the executor of the group
+     */
+    Executor& getExecutor() const;
+
+  private:
+    TaskGroup(const TaskGroup&);
+    TaskGroup& operator=(const TaskGroup&);
+
+    void finished(std::exception_ptr exception);
+
+    Executor& _executor;
+    boost::mutex _mutex;
+    boost::condition_variable _cond;
+    size_t _pending;
+    std::exception_ptr _exception;
+  };
+
+  /**
+   * \brief calls func(i) for every i in [begin, end) in parallel
+   * \param executor [in] the executor running the iterations
+   * \param begin    [in] the first index
+   * \param end      [in] the index after the last one
+   * \param grain    [in] the maximum number of iterations executed by one task (0 means automatic)
+   * \param func     [in] the function called for each index
+   */
+  template <typename Index, typename Func>
+  void parallel_for(Executor& executor, Index begin, Index end, Index grain, const Func& func)
+  {
+    if (!(begin < end))
+      return;
+
+    if (grain == 0) {
+      grain = (end - begin) / (Index)(executor.getConcurrency() * 8);
+      if (grain == 0)
+        grain = 1;
+    }
+
+    TaskGroup group(executor);
+    std::function<void(Index, Index)> split = [&](Index first, Index last)
+    {
+      while (grain < last - first) {
+        Index middle = first + (last - first) / 2;
+        group.run(std::bind(split, middle, last));
+        last = middle;
+      }
+      for (Index i = first; i < last; ++i)
+        func(i);
+    };
+    try {
+      split(begin, end);
+    } catch (...) {
+      // The scheduled tasks refer to split, grain and func, so they have to finish before these are destroyed.
+      try {
+        group.wait();
+      } catch (...) {
+      }
+      throw;
+    }
+    group.wait();
+  }
+
+  /**
+   * \brief calls func(i) for every i in [begin, end) in parallel on the global executor
+   */
+  template <typename Index, typename Func>
+  void parallel_for(Index begin, Index end, const Func& func)
+  {
+    parallel_for(Executor::global(), begin, end, Index(0), func);
+  }
+
+  /**
+   * \brief combines the results of map(i) for every i in [begin, end) in parallel
+   * \param executor [in] the executor running the iterations
+   * \param begin    [in] the first index
+   * \param end      [in] the index after the last one
+   * \param grain    [in] the maximum number of iterations executed by one task (0 means automatic)
+   * \param identity [in] the identity element of combine
+   * \param map      [in] the function called for each index
+   * \param combine  [in] associative function combining two partial results
+   * \return the combined result
+   */
+  template <typename Index, typename Value, typename Map, typename Combine>
+  Value parallel_reduce(Executor& executor, Index begin, Index end, Index grain, const Value& identity, const Map& map, const Combine& combine)
+  {
+    if (!(begin < end))
+      return identity;
+
+    if (grain == 0) {
+      grain = (end - begin) / (Index)(executor.getConcurrency() * 8);
+      if (grain == 0)
+        grain = 1;
+    }
+
+    // The partial results are combined in the order of the chunks, so combine does not need to be commutative.
+    // The partials are wrapped, because the elements of std::vector<bool> can not be written from several threads.
+    struct Partial {
+      Value value;
+    };
+    size_t chunks = (size_t)((end - begin + grain - 1) / grain);
+    Partial initial = { identity };
+    std::vector<Partial> partials(chunks, initial);
+    parallel_for(executor, (size_t)0, chunks, (size_t)1, [&](size_t chunk)
+    {
+      Index first = begin + (Index)chunk * grain;
+      Index last = (end - first) < grain ? end : first + grain;
+      Value value = identity;
+      for (Index i = first; i < last; ++i)
+        value = combine(value, map(i));
+      partials[chunk].value = value;
+    });
+
+    Value result = identity;
+    for (typename std::vector<Partial>::const_iterator it = partials.begin(); it != partials.end(); ++it)
+      result = combine(result, it->value);
+    return result;
+  }
+
+}}
+
+#endif
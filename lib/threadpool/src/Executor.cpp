@@ -0,0 +1,282 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+#include "../inc/Executor.h"
+#include "../inc/ThreadPool.h"
+
+using namespace boost;
+using namespace std;
+
+namespace columbus { namespace thread {
+
+  namespace {
+
+    // The executor and the index of the worker running on the current thread.
+    thread_local Executor* currentExecutor = NULL;
+    thread_local unsigned currentWorker = 0;
+
+    boost::mutex globalMutex;
+    unsigned globalConcurrency = 0;
+    bool globalStarted = false;
+
+  }
+
+  Executor::Executor(unsigned concurrency)
+    : _workers()
+    , _threads()
+    , _idleMutex()
+    , _idleCond()
+    , _queued(0)
+    , _nextWorker(0)
+    , _stop(false)
+  {
+    if (concurrency == 0) {
+      int cores = ThreadPool::getNumberOfCores();
+      concurrency = cores > 0 ? cores : 1;
+    }
+
+    for (unsigned i = 0; i < concurrency; ++i)
+      _workers.push_back(new Worker);
+
+    for (unsigned i = 0; i < concurrency; ++i)
+      _threads.create_thread([this, i]() { workerLoop(i); });
+  }
+
+  Executor::~Executor()
+  {
+    {
+      boost::unique_lock<boost::mutex> lock(_idleMutex);
+      _stop = true;
+    }
+    _idleCond.notify_all();
+    _threads.join_all();
+
+    for (vector<Worker*>::iterator it = _workers.begin(); it != _workers.end(); ++it)
+      delete *it;
+  }
+
+  unsigned Executor::getConcurrency() const
+  {
+    return (unsigned)_workers.size();
+  }
+
+  void Executor::spawn(const Job& job)
+  {
+    Worker* worker;
+    if (currentExecutor == this) {
+      worker = _workers[currentWorker];
+    } else {
+      boost::unique_lock<boost::mutex> lock(_idleMutex);
+      worker = _workers[_nextWorker];
+      _nextWorker = (_nextWorker + 1) % _workers.size();
+    }
+
+    {
+      boost::unique_lock<boost::mutex> lock(worker->mutex);
+      worker->jobs.push_back(job);
+    }
+
+    {
+      boost::unique_lock<boost::mutex> lock(_idleMutex);
+      ++_queued;
+    }
+    _idleCond.notify_one();
+  }
+
+  bool Executor::popJob(unsigned id, Job& job)
+  {
+    Worker* worker = _workers[id];
+    {
+      boost::unique_lock<boost::mutex> lock(worker->mutex);
+      if (worker->jobs.empty())
+        return false;
+      job.swap(worker->jobs.back());
+      worker->jobs.pop_back();
+    }
+
+    boost::unique_lock<boost::mutex> lock(_idleMutex);
+    --_queued;
+    return true;
+  }
+
+  bool Executor::stealJob(unsigned id, Job& job)
+  {
+    for (size_t i = 1; i <= _workers.size(); ++i) {
+      Worker* victim = _workers[(id + i) % _workers.size()];
+      {
+        boost::unique_lock<boost::mutex> lock(victim->mutex);
+        if (victim->jobs.empty())
+          continue;
+        job.swap(victim->jobs.front());
+        victim->jobs.pop_front();
+      }
+
+      boost::unique_lock<boost::mutex> lock(_idleMutex);
+      --_queued;
+      return true;
+    }
+    return false;
+  }
+
+  bool Executor::runPendingTask()
+  {
+    Job job;
+    if (currentExecutor == this) {
+      if (!popJob(currentWorker, job) && !stealJob(currentWorker, job))
+        return false;
+    } else if (!stealJob(0, job)) {
+      return false;
+    }
+
+    try {
+      job();
+    } catch (...) {
+      // the exceptions are forwarded by the futures and task groups
+    }
+    return true;
+  }
+
+  void Executor::workerLoop(unsigned id)
+  {
+    currentExecutor = this;
+    currentWorker = id;
+
+    while (true) {
+      Job job;
+      if (popJob(id, job) || stealJob(id, job)) {
+        try {
+          job();
+        } catch (...) {
+          // the exceptions are forwarded by the futures and task groups
+        }
+        continue;
+      }
+
+      boost::unique_lock<boost::mutex> lock(_idleMutex);
+      while (_queued == 0 && !_stop)
+        _idleCond.wait(lock);
+
+      if (_queued == 0 && _stop)
+        break;
+    }
+  }
+
+  Executor& Executor::global()
+  {
+    unsigned concurrency;
+    {
+      boost::unique_lock<boost::mutex> lock(globalMutex);
+      globalStarted = true;
+      concurrency = globalConcurrency;
+    }
+    static Executor executor(concurrency);
+    return executor;
+  }
+
+  bool Executor::setGlobalConcurrency(unsigned concurrency)
+  {
+    boost::unique_lock<boost::mutex> lock(globalMutex);
+    if (globalStarted)
+      return false;
+    globalConcurrency = concurrency;
+    return true;
+  }
+
+
+  TaskGroup::TaskGroup(Executor& executor)
+    : _executor(executor)
+    , _mutex()
+    , _cond()
+    , _pending(0)
+    , _exception()
+  {
+  }
+
+  TaskGroup::~TaskGroup()
+  {
+    try {
+      wait();
+    } catch (...) {
+      // the exception is lost if wait() is not called explicitly
+    }
+  }
+
+  void TaskGroup::run(const Executor::Job& job)
+  {
+    {
+      boost::unique_lock<boost::mutex> lock(_mutex);
+      ++_pending;
+    }
+
+    _executor.spawn([this, job]()
+    {
+      try {
+        job();
+      } catch (...) {
+        finished(std::current_exception());
+        return;
+      }
+      finished(std::exception_ptr());
+    });
+  }
+
+  void TaskGroup::finished(std::exception_ptr exception)
+  {
+    boost::unique_lock<boost::mutex> lock(_mutex);
+    if (exception && !_exception)
+      _exception = exception;
+    if (--_pending == 0)
+      _cond.notify_all();
+  }
+
+  void TaskGroup::wait()
+  {
+    while (true) {
+      {
+        boost::unique_lock<boost::mutex> lock(_mutex);
+        if (_pending == 0)
+          break;
+      }
+
+      if (_executor.runPendingTask())
+        continue;
+
+      // The remaining tasks of the group are running on other threads. The wait is limited, because these
+      // tasks can spawn new ones which should be helped with.
+      boost::unique_lock<boost::mutex> lock(_mutex);
+      if (_pending != 0)
+        _cond.timed_wait(lock, boost::posix_time::milliseconds(1));
+    }
+
+    std::exception_ptr exception;
+    {
+      boost::unique_lock<boost::mutex> lock(_mutex);
+      exception.swap(_exception);
+    }
+    if (exception)
+      std::rethrow_exception(exception);
+  }
+
+  Executor& TaskGroup::getExecutor() const
+  {
+    return _executor;
+  }
+
+}}
@@ -0,0 +1,207 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+/*
+ * Checks the assignment used by the clone genealogy of DuplicatedCodeFinder. The BlockAssignment must give the
+ * same pairs as the former HungarianMethod on the whole dense similarity matrix when every component is small
+ * (also when the components are solved on the Executor), the SparseAssignment must give an optimal assignment
+ * (the most pairs with the least total cost, checked by brute force), and the large components solved by the
+ * SparseAssignment must never be worse than the HungarianMethod.
+ */
+
+#include <common/inc/math/linear/block_assignment.h>
+#include <threadpool/inc/Executor.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace common::math;
+
+namespace {
+
+  const double inf = numeric_limits<double>::max();
+
+  typedef boost::numeric::ublas::matrix<double> Matrix;
+  typedef map<unsigned int, unsigned int> Solution;
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+  // A sparse cost matrix consisting of random blocks, the rows and the columns of the blocks are interleaved.
+  Matrix generateBlocks(mt19937& random, unsigned blocks, unsigned maxBlockSize, double density) {
+    vector<unsigned> blockRows, blockCols;
+    for (unsigned b = 0; b < blocks; ++b) {
+      unsigned rows = 1 + random() % maxBlockSize, cols = 1 + random() % maxBlockSize;
+      blockRows.insert(blockRows.end(), rows, b);
+      blockCols.insert(blockCols.end(), cols, b);
+    }
+    shuffle(blockRows.begin(), blockRows.end(), random);
+    shuffle(blockCols.begin(), blockCols.end(), random);
+
+    uniform_real_distribution<double> cost(0.01, 10.0), chance(0.0, 1.0);
+    Matrix m(blockRows.size(), blockCols.size());
+    for (unsigned i = 0; i < m.size1(); ++i)
+      for (unsigned j = 0; j < m.size2(); ++j)
+        m(i, j) = blockRows[i] == blockCols[j] && chance(random) < density ? cost(random) : inf;
+    return m;
+  }
+
+  // The former mapping: the HungarianMethod on the whole matrix, the infinite pairs are dropped.
+  Solution solveDense(const Matrix& m) {
+    Matrix m_orig(m);
+    HungarianMethod<string, double> Hm(m_orig);
+    Solution hmSolution = Hm.solve(HungarianMethod<string, double>::INJECTIVE_KIND);
+    Solution solution;
+    for (Solution::const_iterator it = hmSolution.begin(); it != hmSolution.end(); ++it)
+      if (it->second < m.size1() && it->first < m.size2() && m(it->second, it->first) != inf)
+        solution.insert(*it);
+    return solution;
+  }
+
+  template <class Assignment>
+  void addEdges(Assignment& assignment, const Matrix& m) {
+    for (unsigned i = 0; i < m.size1(); ++i)
+      for (unsigned j = 0; j < m.size2(); ++j)
+        if (m(i, j) != inf)
+          assignment.addEdge(i, j, m(i, j));
+  }
+
+  double totalCost(const Matrix& m, const Solution& solution) {
+    double cost = 0.0;
+    for (Solution::const_iterator it = solution.begin(); it != solution.end(); ++it)
+      cost += m(it->second, it->first);
+    return cost;
+  }
+
+  bool isMatching(const Matrix& m, const Solution& solution) {
+    set<unsigned int> rows;
+    for (Solution::const_iterator it = solution.begin(); it != solution.end(); ++it)
+      if (it->first >= m.size2() || it->second >= m.size1() || m(it->second, it->first) == inf || !rows.insert(it->second).second)
+        return false;
+    return true;
+  }
+
+  // The most pairs and their least total cost, by trying every matching of the rows.
+  void bruteForce(const Matrix& m, unsigned row, vector<bool>& usedCols, unsigned pairs, double cost, unsigned& bestPairs, double& bestCost) {
+    if (row == m.size1()) {
+      if (pairs > bestPairs || (pairs == bestPairs && cost < bestCost)) {
+        bestPairs = pairs;
+        bestCost = cost;
+      }
+      return;
+    }
+    bruteForce(m, row + 1, usedCols, pairs, cost, bestPairs, bestCost);
+    for (unsigned j = 0; j < m.size2(); ++j) {
+      if (usedCols[j] || m(row, j) == inf)
+        continue;
+      usedCols[j] = true;
+      bruteForce(m, row + 1, usedCols, pairs + 1, cost + m(row, j), bestPairs, bestCost);
+      usedCols[j] = false;
+    }
+  }
+
+  bool checkBlocksAgainstDense(mt19937& random) {
+    bool ok = true;
+    columbus::thread::Executor executor(4);
+    for (unsigned round = 0; round < 200; ++round) {
+      Matrix m = generateBlocks(random, 1 + random() % 8, 1 + random() % 10, round % 2 ? 0.5 : 0.9);
+      Solution dense = solveDense(m);
+
+      BlockAssignment<double> sequential(m.size1(), m.size2(), 64);
+      addEdges(sequential, m);
+      ok &= check(sequential.solve() == dense, "the block mapping differs from the HungarianMethod on the whole matrix");
+
+      BlockAssignment<double> parallel(m.size1(), m.size2(), 64);
+      addEdges(parallel, m);
+      Solution parallelSolution = parallel.solve([&](size_t n, const function<void(size_t)>& func) {
+        columbus::thread::parallel_for(executor, (size_t)0, n, (size_t)1, func);
+      });
+      ok &= check(parallelSolution == dense, "the block mapping solved on the Executor differs from the HungarianMethod");
+    }
+    return ok;
+  }
+
+  bool checkSparseAgainstBruteForce(mt19937& random) {
+    bool ok = true;
+    uniform_real_distribution<double> cost(0.0, 5.0), chance(0.0, 1.0);
+    for (unsigned round = 0; round < 500; ++round) {
+      Matrix m(1 + random() % 6, 1 + random() % 6);
+      double density = 0.2 + chance(random) * 0.8;
+      for (unsigned i = 0; i < m.size1(); ++i)
+        for (unsigned j = 0; j < m.size2(); ++j)
+          // rounded costs, so there are equal alternatives too
+          m(i, j) = chance(random) < density ? floor(cost(random) * 2) / 2 : inf;
+
+      SparseAssignment<double> assignment(m.size1(), m.size2());
+      addEdges(assignment, m);
+      Solution solution = assignment.solve();
+
+      unsigned bestPairs = 0;
+      double bestCost = 0.0;
+      vector<bool> usedCols(m.size2(), false);
+      bruteForce(m, 0, usedCols, 0, 0.0, bestPairs, bestCost);
+
+      ok &= check(isMatching(m, solution), "the SparseAssignment gives an invalid matching");
+      ok &= check(solution.size() == bestPairs, "the SparseAssignment does not give the most pairs");
+      ok &= check(fabs(totalCost(m, solution) - bestCost) < 1e-9, "the SparseAssignment does not give the least total cost");
+    }
+    return ok;
+  }
+
+  bool checkLargeComponents(mt19937& random) {
+    bool ok = true;
+    for (unsigned round = 0; round < 20; ++round) {
+      // a few blocks above the dense limit of 16 next to small ones
+      Matrix m = generateBlocks(random, 4, 40, 0.3);
+      Solution dense = solveDense(m);
+
+      BlockAssignment<double> blocks(m.size1(), m.size2(), 16);
+      addEdges(blocks, m);
+      Solution solution = blocks.solve();
+
+      ok &= check(isMatching(m, solution), "the block mapping gives an invalid matching");
+      ok &= check(solution.size() >= dense.size(), "the block mapping gives fewer pairs than the HungarianMethod");
+      ok &= check(solution.size() > dense.size() || totalCost(m, solution) <= totalCost(m, dense) + 1e-9,
+        "the block mapping gives a higher total cost than the HungarianMethod");
+    }
+    return ok;
+  }
+
+}
+
+int main() {
+  mt19937 random(20180501);
+  bool ok = true;
+  ok &= checkBlocksAgainstDense(random);
+  ok &= checkSparseAgainstBruteForce(random);
+  ok &= checkLargeComponents(random);
+  if (ok)
+    cout << "BlockAssignmentTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,152 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+/*
+ * Checks that the keys and the strings given by a ConcurrentStrTable filled by several threads are stable:
+ * every thread gets the same key for the same string, the references of the strings do not move while the
+ * table grows, and after the table is copied back into the RefDistributorStrTable it was created from, the
+ * StringReferences given out before remain valid and all the keys of the concurrent table can be used.
+ */
+
+#include <strtable/inc/ConcurrentStrTable.h>
+#include <strtable/inc/RefDistributorStrTable.h>
+#include <common/inc/StringSup.h>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <atomic>
+#include <iostream>
+#include <set>
+#include <vector>
+
+using namespace std;
+using namespace columbus;
+
+namespace {
+
+  const unsigned THREADS = 8;
+  const unsigned STRINGS = 20000;        // The number of different strings inserted by the threads
+  const unsigned SEEDED_STRINGS = 1000;  // The number of strings of the original table
+
+  string getString(unsigned i) {
+    return "com.example.package" + common::toString(i % 97) + ".Class" + common::toString(i);
+  }
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+  struct Inserted {
+    Key key;
+    const string* str;   // The reference given by get(Key) right after the insertion
+  };
+
+  // Every thread inserts all the strings, each of them in a different order, so the same strings are inserted at the same time.
+  void insertAll(ConcurrentStrTable& table, unsigned thread, vector<Inserted>& inserted) {
+    inserted.resize(STRINGS);
+    for (unsigned n = 0; n < STRINGS; ++n) {
+      unsigned i = (n * 7919 + thread * 104729) % STRINGS;
+      inserted[i].key = table.set(getString(i));
+      inserted[i].str = &table.get(inserted[i].key);
+    }
+  }
+
+  // Looks up the strings of the original table while the others insert, none of them can disappear or change.
+  void lookUp(const ConcurrentStrTable& table, const vector<Key>& seededKeys, const atomic<bool>& stop, atomic<unsigned>& errors) {
+    while (!stop.load()) {
+      for (unsigned i = 0; i < seededKeys.size(); ++i) {
+        const string expected = "seeded" + common::toString(i);
+        if (table.get(seededKeys[i]) != expected || table.get(expected) != seededKeys[i])
+          ++errors;
+      }
+    }
+  }
+
+}
+
+int main() {
+  bool ok = true;
+
+  RefDistributorStrTable strTable;
+  vector<Key> seededKeys;
+  vector<const StringReference*> references;
+  for (unsigned i = 0; i < SEEDED_STRINGS; ++i) {
+    references.push_back(strTable.setStr("seeded" + common::toString(i)));
+    seededKeys.push_back(references.back()->getKey());
+  }
+
+  ConcurrentStrTable table(strTable);
+  ok &= check(table.size() == SEEDED_STRINGS, "the concurrent table does not contain the strings of the original table");
+
+  vector<vector<Inserted> > inserted(THREADS);
+  atomic<bool> stop(false);
+  atomic<unsigned> errors(0);
+  {
+    boost::thread reader(lookUp, boost::cref(table), boost::cref(seededKeys), boost::cref(stop), boost::ref(errors));
+    boost::thread_group writers;
+    for (unsigned t = 0; t < THREADS; ++t)
+      writers.create_thread(boost::bind(insertAll, boost::ref(table), t, boost::ref(inserted[t])));
+    writers.join_all();
+    stop.store(true);
+    reader.join();
+  }
+  ok &= check(errors.load() == 0, "a string of the original table is not found while the others insert");
+  ok &= check(table.size() == SEEDED_STRINGS + STRINGS, "the number of the strings is " + common::toString((unsigned)table.size()));
+
+  for (unsigned i = 0; i < STRINGS; ++i) {
+    const Inserted& first = inserted[0][i];
+    bool same = true;
+    for (unsigned t = 1; t < THREADS; ++t)
+      same &= inserted[t][i].key == first.key && inserted[t][i].str == first.str;
+    ok &= check(same, "the threads got different keys for " + getString(i));
+    ok &= check(first.key != 0 && table.get(getString(i)) == first.key, "the key of " + getString(i) + " is lost");
+    ok &= check(&table.get(first.key) == first.str && *first.str == getString(i), "the reference of " + getString(i) + " has moved");
+  }
+  for (unsigned i = 0; i < SEEDED_STRINGS; ++i)
+    ok &= check(table.set("seeded" + common::toString(i)) == seededKeys[i], "the key of a string of the original table has changed");
+
+  table.copyTo(strTable);
+
+  for (unsigned i = 0; i < SEEDED_STRINGS; ++i) {
+    const string expected = "seeded" + common::toString(i);
+    ok &= check(references[i]->getKey() == seededKeys[i] && references[i]->get() == expected, "the StringReference of " + expected + " is invalid after the copy");
+    ok &= check(strTable.getRefByKey(seededKeys[i]) == references[i], "a new StringReference is given for " + expected);
+  }
+  for (unsigned i = 0; i < STRINGS; ++i) {
+    Key key = inserted[0][i].key;
+    ok &= check(strTable.get(key) == getString(i) && strTable.get(getString(i).c_str()) == key, "the key of " + getString(i) + " is different after the copy");
+    ok &= check(strTable.getRefByKey(key)->get() == getString(i), "the StringReference of " + getString(i) + " is invalid after the copy");
+  }
+
+  // the copied table goes on with new keys which do not collide with the ones given out
+  set<Key> keys(seededKeys.begin(), seededKeys.end());
+  for (unsigned i = 0; i < STRINGS; ++i)
+    keys.insert(inserted[0][i].key);
+  for (unsigned i = 0; i < 1000; ++i) {
+    const string str = "inserted after the copy" + common::toString(i);
+    Key key = strTable.set(str);
+    ok &= check(keys.insert(key).second && strTable.get(key) == str, "the key of " + str + " collides with an earlier one");
+  }
+
+  if (ok)
+    cout << "ConcurrentStrTableTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
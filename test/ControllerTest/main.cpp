@@ -0,0 +1,391 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+/*
+ * Checks Controller::executeTasks with fake tasks, which sleep and record when they start and end: every task is
+ * started only after the tasks it depends on are finished, at most maxThreads tasks run at the same time (and as many
+ * run if there are enough ready ones), no new task is started after a critical error (or after any error in
+ * EM_FAIL_ON_ANY_ERROR mode) but the running ones are finished, the ready tasks are started in the order of their
+ * durations in the previous run, and the timeline.csv and task-times.csv files contain the executed tasks.
+ */
+
+#include <controller/inc/Controller.h>
+#include <Exception.h>
+#include <boost/filesystem.hpp>
+#include <boost/thread/mutex.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace columbus;
+using namespace columbus::controller;
+
+namespace {
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+  // the starts and ends of the tasks in their order, and the number of the tasks running at the same time
+  class Recorder {
+    public:
+      Recorder() : running(0), maxRunning(0) {}
+
+      void start(const string& name) {
+        boost::mutex::scoped_lock lock(mutex);
+        events.push_back("start " + name);
+        maxRunning = max(maxRunning, ++running);
+      }
+
+      void end(const string& name) {
+        boost::mutex::scoped_lock lock(mutex);
+        events.push_back("end " + name);
+        --running;
+      }
+
+      // the index of the event, or -1 if it did not happen
+      int find(const string& event) const {
+        for (size_t i = 0; i < events.size(); ++i)
+          if (events[i] == event)
+            return (int)i;
+        return -1;
+      }
+
+      vector<string> events;
+      unsigned running;
+      unsigned maxRunning;
+
+    private:
+      boost::mutex mutex;
+  };
+
+  enum Outcome { OK, ERROR, CRITICAL };
+
+  class FakeTask : public Task {
+    public:
+      FakeTask(const BaseProperties& properties, Recorder& recorder, const string& name, unsigned milliseconds, Outcome outcome)
+        : Task(properties), recorder(recorder), name(name), milliseconds(milliseconds), outcome(outcome) {}
+
+      virtual ExecutionResult execute() {
+        recorder.start(name);
+        this_thread::sleep_for(chrono::milliseconds(milliseconds));
+        recorder.end(name);
+
+        ExecutionResult result;
+        if (outcome == ERROR)
+          result.setError();
+        else if (outcome == CRITICAL)
+          result.setCriticalError();
+        return result;
+      }
+
+      virtual const string& getName() const {
+        return name;
+      }
+
+    private:
+      Recorder& recorder;
+      string name;
+      unsigned milliseconds;
+      Outcome outcome;
+  };
+
+  struct TaskDef {
+    string name;
+    unsigned milliseconds;
+    Outcome outcome;
+    vector<string> dependsOn;
+  };
+
+  int execute(const BaseProperties& properties, Recorder& recorder, const vector<TaskDef>& tasks, Controller::ExecutionMode mode) {
+    Controller controller(properties);
+    for (vector<TaskDef>::const_iterator it = tasks.begin(); it != tasks.end(); ++it) {
+      Task* task = new FakeTask(properties, recorder, it->name, it->milliseconds, it->outcome);
+      for (vector<string>::const_iterator dependency = it->dependsOn.begin(); dependency != it->dependsOn.end(); ++dependency)
+        task->addDependsOn(*dependency);
+      controller.addTask(task);
+    }
+    return controller.executeTasks(mode);
+  }
+
+  vector<vector<string> > readCsv(const boost::filesystem::path& filename) {
+    vector<vector<string> > rows;
+    ifstream file(filename.string().c_str());
+    string line;
+    while (getline(file, line)) {
+      rows.push_back(vector<string>());
+      string::size_type begin = 0;
+      string::size_type end;
+      while ((end = line.find(',', begin)) != string::npos) {
+        rows.back().push_back(line.substr(begin, end - begin));
+        begin = end + 1;
+      }
+      rows.back().push_back(line.substr(begin));
+    }
+    return rows;
+  }
+
+  bool checkDependencies(const Recorder& recorder, const vector<TaskDef>& tasks, const string& name) {
+    bool ok = true;
+    for (vector<TaskDef>::const_iterator it = tasks.begin(); it != tasks.end(); ++it) {
+      int start = recorder.find("start " + it->name);
+      if (start == -1)
+        continue;
+      for (vector<string>::const_iterator dependency = it->dependsOn.begin(); dependency != it->dependsOn.end(); ++dependency) {
+        int end = recorder.find("end " + *dependency);
+        ok &= check(end != -1 && end < start, name + ": " + it->name + " is started before " + *dependency + " is finished");
+      }
+    }
+    return ok;
+  }
+
+  // the rows of timeline.csv must be the executed tasks in the order of the tasks, with consistent times
+  bool checkTimeline(const boost::filesystem::path& filename, const vector<TaskDef>& tasks, const Recorder& recorder, const string& name) {
+    vector<vector<string> > rows = readCsv(filename);
+    bool ok = check(!rows.empty() && rows[0] == vector<string>({ "Task", "Start", "End", "Duration", "Result" }), name + ": wrong timeline header");
+
+    map<string, vector<string> > rowsByTask;
+    vector<string> order;
+    for (size_t i = 1; i < rows.size(); ++i) {
+      if (!check(rows[i].size() == 5, name + ": wrong timeline row " + to_string(i)))
+        return false;
+      rowsByTask[rows[i][0]] = rows[i];
+      order.push_back(rows[i][0]);
+    }
+
+    vector<string> expectedOrder;
+    for (vector<TaskDef>::const_iterator it = tasks.begin(); it != tasks.end(); ++it) {
+      if (recorder.find("start " + it->name) == -1) {
+        ok &= check(rowsByTask.find(it->name) == rowsByTask.end(), name + ": " + it->name + " is in the timeline, but it was not started");
+        continue;
+      }
+      expectedOrder.push_back(it->name);
+
+      const vector<string>& row = rowsByTask[it->name];
+      if (!check(!row.empty(), name + ": " + it->name + " is missing from the timeline"))
+        continue;
+      double start = atof(row[1].c_str());
+      double end = atof(row[2].c_str());
+      double duration = atof(row[3].c_str());
+      ok &= check(start >= 0 && end >= start && fabs(end - start - duration) < 0.0015, name + ": inconsistent times of " + it->name);
+      ok &= check(duration >= it->milliseconds / 1000.0 - 0.0015, name + ": the duration of " + it->name + " is too short");
+      const string result = it->outcome == OK ? "OK" : it->outcome == ERROR ? "error " : "critical error ";
+      ok &= check(row[4] == result, name + ": the result of " + it->name + " is " + row[4] + " instead of " + result);
+
+      // the timeline must be consistent with the dependencies as well
+      for (vector<string>::const_iterator dependency = it->dependsOn.begin(); dependency != it->dependsOn.end(); ++dependency)
+        if (rowsByTask.find(*dependency) != rowsByTask.end())
+          ok &= check(atof(rowsByTask[*dependency][2].c_str()) <= start, name + ": " + it->name + " starts before the end of " + *dependency + " in the timeline");
+    }
+    ok &= check(order == expectedOrder, name + ": the timeline does not contain the started tasks in their order");
+    return ok;
+  }
+
+  // task-times.csv must contain the duration of the executed tasks and keep the former durations of the other ones
+  bool checkTaskTimes(const boost::filesystem::path& filename, const vector<TaskDef>& tasks, const Recorder& recorder, const map<string, double>& former, const string& name) {
+    vector<vector<string> > rows = readCsv(filename);
+    map<string, double> times;
+    bool ok = true;
+    for (size_t i = 0; i < rows.size(); ++i) {
+      ok &= check(rows[i].size() == 2, name + ": wrong task-times row " + to_string(i));
+      if (rows[i].size() == 2)
+        times[rows[i][0]] = atof(rows[i][1].c_str());
+    }
+
+    set<string> executed;
+    for (vector<TaskDef>::const_iterator it = tasks.begin(); it != tasks.end(); ++it) {
+      if (recorder.find("start " + it->name) == -1)
+        continue;
+      executed.insert(it->name);
+      ok &= check(times.find(it->name) != times.end() && times[it->name] >= it->milliseconds / 1000.0 - 0.0015,
+        name + ": the duration of " + it->name + " is not saved into task-times.csv");
+    }
+    for (map<string, double>::const_iterator it = former.begin(); it != former.end(); ++it)
+      if (executed.find(it->first) == executed.end())
+        ok &= check(times.find(it->first) != times.end() && fabs(times[it->first] - it->second) < 1e-9,
+          name + ": the former duration of " + it->first + " is not kept in task-times.csv");
+    ok &= check(times.size() == executed.size() + former.size() - count_if(former.begin(), former.end(),
+      [&executed](const pair<const string, double>& time) { return executed.find(time.first) != executed.end(); }), name + ": task-times.csv has unknown tasks");
+    return ok;
+  }
+
+  BaseProperties makeProperties(const boost::filesystem::path& directory, int maxThreads) {
+    BaseProperties properties;
+    properties.logDir = directory;
+    properties.timelineFile = directory / "timeline.csv";
+    properties.taskTimesFile = directory / "task-times.csv";
+    properties.maxThreads = maxThreads;
+    return properties;
+  }
+
+  void writeTaskTimes(const BaseProperties& properties, const map<string, double>& times) {
+    ofstream file(properties.taskTimesFile.string().c_str());
+    for (map<string, double>::const_iterator it = times.begin(); it != times.end(); ++it)
+      file << it->first << "," << it->second << "\n";
+  }
+
+  bool testDependencies(const boost::filesystem::path& directory) {
+    const string name = "dependencies";
+    const BaseProperties properties = makeProperties(directory, 2);
+    map<string, double> former;
+    former["Removed"] = 5;
+    writeTaskTimes(properties, former);
+
+    const vector<TaskDef> tasks = {
+      { "E", 30, OK, { "C", "D" } },
+      { "A", 100, OK, {} },
+      { "B", 60, OK, {} },
+      { "C", 50, OK, { "A" } },
+      { "D", 50, OK, { "A", "B" } },
+      { "F", 40, OK, {} },
+    };
+    Recorder recorder;
+    bool ok = check(execute(properties, recorder, tasks, Controller::EM_FAIL_ON_ANY_ERROR) == 0, name + ": the execution failed");
+    ok &= check(recorder.events.size() == 2 * tasks.size(), name + ": not every task is executed");
+    ok &= checkDependencies(recorder, tasks, name);
+    ok &= check(recorder.maxRunning == 2, name + ": " + to_string(recorder.maxRunning) + " tasks run at the same time instead of 2");
+    ok &= checkTimeline(properties.timelineFile, tasks, recorder, name);
+    ok &= checkTaskTimes(properties.taskTimesFile, tasks, recorder, former, name);
+    return ok;
+  }
+
+  bool testMaxThreads(const boost::filesystem::path& directory) {
+    bool ok = true;
+    for (int maxThreads = 1; maxThreads <= 4; ++maxThreads) {
+      const string name = "maxThreads " + to_string(maxThreads);
+      const BaseProperties properties = makeProperties(directory, maxThreads);
+      boost::filesystem::remove(properties.taskTimesFile);
+      vector<TaskDef> tasks;
+      for (unsigned i = 0; i < 8; ++i)
+        tasks.push_back({ "T" + to_string(i), 20, OK, {} });
+      tasks.push_back({ "Last", 10, OK, { "T0", "T7" } });
+
+      Recorder recorder;
+      ok &= check(execute(properties, recorder, tasks, Controller::EM_FAIL_ON_ANY_ERROR) == 0, name + ": the execution failed");
+      ok &= check(recorder.events.size() == 2 * tasks.size(), name + ": not every task is executed");
+      ok &= checkDependencies(recorder, tasks, name);
+      ok &= check(recorder.maxRunning == (unsigned)maxThreads, name + ": " + to_string(recorder.maxRunning) + " tasks run at the same time");
+      ok &= checkTimeline(properties.timelineFile, tasks, recorder, name);
+      ok &= checkTaskTimes(properties.taskTimesFile, tasks, recorder, map<string, double>(), name);
+    }
+    return ok;
+  }
+
+  bool testFailure(const boost::filesystem::path& directory, Outcome outcome, Controller::ExecutionMode mode, bool stops) {
+    const string name = string(outcome == CRITICAL ? "critical error" : "error") + (mode == Controller::EM_FAIL_ON_ANY_ERROR ? " (fail on any error)" : " (fail on critical error only)");
+    const BaseProperties properties = makeProperties(directory, 2);
+    map<string, double> former;
+    former["Other"] = 0.5;
+    former["AfterFailing"] = 0.5;
+    writeTaskTimes(properties, former);
+
+    // Long and Failing are started first, Other and AfterFailing can be started only after Failing is finished
+    const vector<TaskDef> tasks = {
+      { "Long", 150, OK, {} },
+      { "Failing", 20, outcome, {} },
+      { "Other", 10, OK, {} },
+      { "AfterFailing", 10, OK, { "Failing" } },
+    };
+    Recorder recorder;
+    int result = execute(properties, recorder, tasks, mode);
+    bool ok = check(result == (stops ? 1 : 0), name + ": the execution returned " + to_string(result));
+    ok &= check(recorder.find("end Long") != -1, name + ": the running task is not finished");
+    int failed = recorder.find("end Failing");
+    ok &= check(failed != -1, name + ": the failing task is not executed");
+    if (stops) {
+      for (size_t i = failed + 1; i < recorder.events.size(); ++i)
+        ok &= check(recorder.events[i].compare(0, 6, "start ") != 0, name + ": " + recorder.events[i] + " after the failure");
+    } else
+      ok &= check(recorder.events.size() == 2 * tasks.size(), name + ": not every task is executed");
+    ok &= checkDependencies(recorder, tasks, name);
+    ok &= checkTimeline(properties.timelineFile, tasks, recorder, name);
+    ok &= checkTaskTimes(properties.taskTimesFile, tasks, recorder, former, name);
+    return ok;
+  }
+
+  // with one thread, the ready tasks are started in the decreasing order of their critical paths (the tasks without
+  // a former duration are counted with 1 second), the tasks of the same critical path in the order of their addition
+  bool testPriority(const boost::filesystem::path& directory) {
+    const string name = "priority";
+    const BaseProperties properties = makeProperties(directory, 1);
+    map<string, double> former;
+    former["Short"] = 0.1;
+    former["Long"] = 3;
+    former["BeforeLonger"] = 0.2;
+    former["Longer"] = 4;
+    writeTaskTimes(properties, former);
+
+    const vector<TaskDef> tasks = {
+      { "Short", 10, OK, {} },
+      { "Long", 10, OK, {} },
+      { "BeforeLonger", 10, OK, {} },
+      { "Longer", 10, OK, { "BeforeLonger" } },
+      { "Unknown", 10, OK, {} },
+      { "AlsoUnknown", 10, OK, {} },
+    };
+    Recorder recorder;
+    bool ok = check(execute(properties, recorder, tasks, Controller::EM_FAIL_ON_ANY_ERROR) == 0, name + ": the execution failed");
+    const vector<string> expected = {
+      "start BeforeLonger", "end BeforeLonger", "start Longer", "end Longer", "start Long", "end Long",
+      "start Unknown", "end Unknown", "start AlsoUnknown", "end AlsoUnknown", "start Short", "end Short"
+    };
+    ok &= check(recorder.events == expected, name + ": the tasks are not started in the order of their critical paths");
+    ok &= checkTimeline(properties.timelineFile, tasks, recorder, name);
+    ok &= checkTaskTimes(properties.taskTimesFile, tasks, recorder, former, name);
+    return ok;
+  }
+
+}
+
+int main() {
+  boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("ControllerTest-%%%%-%%%%");
+  boost::filesystem::create_directories(directory);
+
+  bool ok = true;
+  try {
+    ok &= testDependencies(directory);
+    ok &= testMaxThreads(directory);
+    ok &= testFailure(directory, CRITICAL, Controller::EM_FAIL_ON_CRITICAL_ERROR_ONLY, true);
+    ok &= testFailure(directory, CRITICAL, Controller::EM_FAIL_ON_ANY_ERROR, true);
+    ok &= testFailure(directory, ERROR, Controller::EM_FAIL_ON_ANY_ERROR, true);
+    ok &= testFailure(directory, ERROR, Controller::EM_FAIL_ON_CRITICAL_ERROR_ONLY, false);
+    ok &= testPriority(directory);
+  } catch (const columbus::Exception& e) {
+    cerr << "FAILED: " << e.getLocation() << " : " << e.getMessage() << endl;
+    ok = false;
+  }
+
+  boost::filesystem::remove_all(directory);
+
+  if (ok)
+    cout << "ControllerTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,271 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+/*
+ * Runs the python DuplicatedCodeFinder (given as the first argument) on the same components with
+ * -threads 1 and with more threads, and checks that the clone lists, the genealogies and the graphs
+ * are the same. The components are the modules of separate ASGs with separate LIM components, and
+ * -metrics is set, so the coverage and the node embeddedness of the components are computed in
+ * parallel. The detection is run twice, so the clone instances of the second system are mapped to
+ * the ones of the first system as well.
+ */
+
+#include <lim/inc/lim.h>
+#include <python/inc/python.h>
+#include <common/inc/StringSup.h>
+#include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace columbus;
+
+namespace {
+
+  const unsigned componentCount = 4;
+  const unsigned functionCount = 3;
+  const unsigned statementCount = 8;
+  const unsigned threadCount = 4;
+
+  /**
+  * Builds the ASG and the LIM nodes of the components, and maps the modules and the functions to the LIM nodes.
+  */
+  class ComponentBuilder {
+
+    public:
+
+      ComponentBuilder(lim::asg::Factory& limFactory, LimOrigin& origin, const string& name) :
+        strTable(),
+        factory(strTable),
+        limFactory(limFactory),
+        origin(origin),
+        component(limFactory.createComponent(name)),
+        path(name + "/mod.py"),
+        file(limFactory.createFile(path))
+      {
+      }
+
+      // the module of the component: a helper function and the functions calling it, the
+      // statements of the functions differ a bit, so there are clone classes of different lengths
+      void build(unsigned seed) {
+        const unsigned lineCount = 4 + functionCount * (statementCount + 2);
+        python::asg::module::Module& module = *factory.createModuleNode();
+        module.setName("mod");
+        module.setPosition(python::asg::Range(strTable, path, 1, 1, lineCount, 1));
+        factory.getRoot()->addModule(&module);
+
+        lim::asg::logical::Package& package = *limFactory.createPackageNode();
+        package.setName(component.getName());
+        package.setLanguage(lim::asg::lnkPython);
+        package.addBelongsTo(&component);
+        limFactory.getRoot()->addMember(&package);
+        map(module, package);
+
+        python::asg::statement::FunctionDef& helper = function(module, package, "helper", 1, 3);
+        python::asg::statement::Return& ret = *factory.createReturnNode();
+        ret.setPosition(python::asg::Range(strTable, path, 2, 5, 2, 15));
+        ret.setExpression(&identifier("v", 2, 12));
+        helper.getBody()->addStatement(&ret);
+
+        unsigned line = 4;
+        for (unsigned i = 0; i < functionCount; ++i) {
+          python::asg::statement::FunctionDef& def = function(module, package, "f" + common::toString(i), line, line + statementCount);
+          for (unsigned j = 1; j <= statementCount; ++j) {
+            python::asg::statement::Assign& assign = *factory.createAssignNode();
+            assign.setPosition(python::asg::Range(strTable, path, line + j, 5, line + j, 25));
+            python::asg::statement::TargetList& targets = *factory.createTargetListNode();
+            targets.setPosition(python::asg::Range(strTable, path, line + j, 5, line + j, 7));
+            targets.addTarget(&identifier("x" + common::toString(j), line + j, 5));
+            assign.setTargetList(&targets);
+            if ((seed + i + j) % 3 == 0) {
+              python::asg::expression::Call& call = *factory.createCallNode();
+              call.setPosition(python::asg::Range(strTable, path, line + j, 10, line + j, 25));
+              call.setExpression(&identifier("helper", line + j, 10));
+              call.setRefersTo(&helper);
+              assign.setExpression(&call);
+            } else {
+              python::asg::expression::BinaryArithmetic& binary = *factory.createBinaryArithmeticNode();
+              binary.setPosition(python::asg::Range(strTable, path, line + j, 10, line + j, 25));
+              binary.setKind(python::asg::bakAddition);
+              binary.setLeftExpression(&identifier("x" + common::toString(j - 1), line + j, 10));
+              python::asg::expression::IntegerLiteral& literal = *factory.createIntegerLiteralNode();
+              literal.setPosition(python::asg::Range(strTable, path, line + j, 20, line + j, 25));
+              literal.setValue(j);
+              binary.setRightExpression(&literal);
+              assign.setExpression(&binary);
+            }
+            def.getBody()->addStatement(&assign);
+          }
+          line += statementCount + 2;
+        }
+      }
+
+      void save(const string& filename) {
+        CsiHeader header;
+        header.add(CsiHeader::csih_OriginalLocation, component.getName());
+        factory.save(filename, header);
+      }
+
+    private:
+
+      python::asg::statement::FunctionDef& function(python::asg::module::Module& module, lim::asg::logical::Package& package, const string& name, unsigned line, unsigned endLine) {
+        python::asg::statement::FunctionDef& def = *factory.createFunctionDefNode();
+        def.setName(name);
+        def.setPosition(python::asg::Range(strTable, path, line, 1, endLine, 25));
+        python::asg::statement::Suite& body = *factory.createSuiteNode();
+        body.setPosition(python::asg::Range(strTable, path, line + 1, 5, endLine, 25));
+        def.setBody(&body);
+        module.addStatement(&def);
+
+        lim::asg::logical::Method& method = *limFactory.createMethodNode();
+        method.setName(name);
+        method.setLanguage(lim::asg::lnkPython);
+        method.setAccessibility(lim::asg::ackPublic);
+        lim::asg::SourcePosition position;
+        position.setRealizationLevel(lim::asg::relDefines);
+        position.setLine(line);
+        position.setEndLine(endLine);
+        method.addIsContainedIn(file.getId(), position);
+        method.addBelongsTo(&component);
+        package.addMember(&method);
+        map(def, method);
+        return def;
+      }
+
+      python::asg::expression::Identifier& identifier(const string& name, unsigned line, unsigned col) {
+        python::asg::expression::Identifier& node = *factory.createIdentifierNode();
+        node.setName(name);
+        node.setPosition(python::asg::Range(strTable, path, line, col, line, col + static_cast<unsigned>(name.size())));
+        return node;
+      }
+
+      void map(const python::asg::base::Base& node, const lim::asg::base::Base& limNode) {
+        origin.addCompIdCppIdLimIdToMap(component.getId(), node.getId(), limNode.getId());
+      }
+
+      RefDistributorStrTable strTable;
+      python::asg::Factory factory;
+      lim::asg::Factory& limFactory;
+      LimOrigin& origin;
+      lim::asg::base::Component& component;
+      string path;
+      lim::asg::physical::File& file;
+  };
+
+  string readFile(const boost::filesystem::path& filename) {
+    ifstream in(filename.string().c_str(), ios::binary);
+    ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+  }
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+  // the results of the two detections of a thread count
+  struct Results {
+    string clones[2];
+    string graph;
+    string genealogy;
+  };
+
+  Results detect(const string& dcf, const boost::filesystem::path& directory, const vector<string>& components, unsigned threads) {
+    const boost::filesystem::path genealogy = directory / "clones.gsi";
+    const boost::filesystem::path graph = directory / "clones.graph";
+    boost::filesystem::remove(genealogy);
+
+    Results results;
+    for (unsigned run = 0; run < 2; ++run) {
+      const boost::filesystem::path out = directory / "clones.txt";
+      boost::filesystem::remove(out);
+      boost::filesystem::remove(graph);
+
+      string command = "\"" + dcf + "\""
+        + " -lim:\"" + (directory / "system.lim").string() + "\""
+        + " -out:\"" + out.string() + "\""
+        + " -graph:\"" + graph.string() + "\""
+        + " -genealogy:\"" + genealogy.string() + "\""
+        + " -metrics -minlines:3 -minnodes:10"
+        + " -threads:" + common::toString(threads);
+      for (vector<string>::const_iterator it = components.begin(); it != components.end(); ++it)
+        command += " \"" + *it + "\"";
+
+      if (!check(system(command.c_str()) == 0, "the detection failed: " + command))
+        return Results();
+      results.clones[run] = readFile(out);
+    }
+    results.graph = readFile(graph);
+    results.genealogy = readFile(genealogy);
+    return results;
+  }
+
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    cerr << "Usage: DCFThreadsTest <DuplicatedCodeFinder_python>" << endl;
+    return EXIT_FAILURE;
+  }
+
+  boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("DCFThreadsTest-%%%%-%%%%");
+  boost::filesystem::create_directories(directory);
+
+  bool ok = true;
+  try {
+    RefDistributorStrTable strTable;
+    lim::asg::Factory limFactory(strTable, "", lim::asg::limLangPython);
+    LimOrigin origin;
+    vector<string> components;
+    for (unsigned i = 0; i < componentCount; ++i) {
+      const string name = "c" + common::toString(i);
+      ComponentBuilder builder(limFactory, origin, name);
+      builder.build(i % 2);
+      components.push_back((directory / (name + ".psi")).string());
+      builder.save(components.back());
+    }
+    list<HeaderData*> header;
+    header.push_back(&origin);
+    limFactory.save((directory / "system.lim").string(), header);
+
+    const Results sequential = detect(argv[1], directory, components, 1);
+    const Results parallel = detect(argv[1], directory, components, threadCount);
+
+    ok &= check(sequential.clones[0].find("CloneClass") != string::npos, "no clone class was detected:\n" + sequential.clones[0]);
+    for (unsigned run = 0; run < 2; ++run)
+      ok &= check(parallel.clones[run] == sequential.clones[run], "run " + common::toString(run + 1) + ": the clones differ:\n" + parallel.clones[run] + "expected:\n" + sequential.clones[run]);
+    ok &= check(!sequential.graph.empty() && parallel.graph == sequential.graph, "the graphs differ");
+    ok &= check(!sequential.genealogy.empty() && parallel.genealogy == sequential.genealogy, "the genealogies differ");
+  } catch (const columbus::Exception& e) {
+    cerr << "FAILED: " << e.getLocation() << " : " << e.getMessage() << endl;
+    ok = false;
+  }
+
+  boost::filesystem::remove_all(directory);
+
+  if (ok)
+    cout << "DCFThreadsTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,115 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+/*
+ * Checks that the compiled rules of a DirectoryFilter (plain literals, anchored literals, literal prefilters of the
+ * regular expressions) give the same results as matching every rule as an extended regular expression, both path by
+ * path and in the parallel batch check. The rules contain zero-width assertions (\< \> \` \') which look like escaped
+ * characters but must not be treated as literals.
+ */
+
+#include <common/inc/DirectoryFilter.h>
+#include <threadpool/inc/Executor.h>
+#include <boost/filesystem.hpp>
+#include <boost/regex.hpp>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+  const char* rules[] = {
+    "-/test/",
+    "+/test/keep\\.py$",
+    "-^/usr/lib",
+    "-\\<gen\\>",
+    "-\\.min\\.",
+    "+\\`/src/main",
+    "-build\\'",
+    "-[0-9]+\\.tmp$",
+    "-(vendor|third_party)/",
+    "-x\\/y",
+  };
+  const unsigned ruleCount = sizeof(rules) / sizeof(rules[0]);
+
+  const char* directories[] = { "", "/src", "/src/main", "/src/gen", "/src/generated", "/src/regen", "/usr/lib", "/usr/lib64",
+    "/opt/usr/lib", "/test", "/attest", "/x/y", "/xy", "/vendor", "/third_party/z" };
+  const char* files[] = { "a.py", "keep.py", "keep.pyc", "gen", "gen.py", "lib.min.js", "lib_min.js", "build", "build.py", "12.tmp", "x.tmp" };
+
+  // matches the rules the way the filter did before the rules were compiled
+  bool isFilteredOutByRegex(const string& path) {
+    for (unsigned i = ruleCount; i-- > 0;) {
+#ifdef _WIN32
+      boost::regex re(rules[i] + 1, boost::regex::extended | boost::regex::icase);
+#else
+      boost::regex re(rules[i] + 1, boost::regex::extended);
+#endif
+      if (boost::regex_search(path, re))
+        return rules[i][0] == '-';
+    }
+    return false;
+  }
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+}
+
+int main() {
+  boost::filesystem::path filterFile = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("DirectoryFilterTest-%%%%-%%%%.txt");
+  {
+    ofstream out(filterFile.string().c_str());
+    for (unsigned i = 0; i < ruleCount; ++i)
+      out << rules[i] << "\n";
+  }
+
+  // the same paths several times, so the batch check is split into several chunks
+  vector<string> paths;
+  for (unsigned n = 0; n < 4; ++n)
+    for (unsigned d = 0; d < sizeof(directories) / sizeof(directories[0]); ++d)
+      for (unsigned f = 0; f < sizeof(files) / sizeof(files[0]); ++f)
+        paths.push_back(string(directories[d]) + "/" + files[f]);
+
+  bool ok = true;
+  DirectoryFilter filter;
+  ok &= check(filter.openFilterFile(filterFile.string()), "the filter file can not be opened");
+  boost::filesystem::remove(filterFile);
+
+  columbus::thread::Executor sequential(1);
+  columbus::thread::Executor parallel(4);
+  vector<bool> sequentialResults = filter.areFilteredOut(paths, sequential);
+  vector<bool> parallelResults = filter.areFilteredOut(paths, parallel);
+  for (size_t i = 0; i < paths.size(); ++i) {
+    bool expected = isFilteredOutByRegex(paths[i]);
+    ok &= check(filter.isFilteredOut(paths[i]) == expected, "isFilteredOut is wrong for " + paths[i]);
+    ok &= check(sequentialResults[i] == expected, "the sequential areFilteredOut is wrong for " + paths[i]);
+    ok &= check(parallelResults[i] == expected, "the parallel areFilteredOut is wrong for " + paths[i]);
+  }
+
+  if (ok)
+    cout << "DirectoryFilterTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
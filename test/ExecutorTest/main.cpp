@@ -0,0 +1,179 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+/*
+ * Checks the Executor and its helpers: every index of parallel_for is visited once, parallel_reduce combines the
+ * chunks in order (also for bool values), the exceptions of the tasks reach the futures and the task groups, and
+ * an exception thrown by the body of parallel_for on the calling thread is propagated only after every scheduled
+ * task of the loop is finished (the tasks refer to the locals of parallel_for).
+ */
+
+#include <threadpool/inc/Executor.h>
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace columbus::thread;
+
+namespace {
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+  bool checkParallelFor(Executor& executor) {
+    const size_t size = 100000;
+    vector<atomic<int> > visits(size);
+    for (size_t i = 0; i < size; ++i)
+      visits[i] = 0;
+
+    parallel_for(executor, (size_t)0, size, (size_t)0, [&](size_t i) { ++visits[i]; });
+
+    bool ok = true;
+    for (size_t i = 0; i < size; ++i)
+      if (visits[i] != 1)
+        ok = false;
+    return check(ok, "parallel_for does not visit every index exactly once");
+  }
+
+  bool checkParallelReduce(Executor& executor) {
+    bool ok = true;
+
+    long long sum = parallel_reduce(executor, 0, 100000, 7, 0LL, [](int i) { return (long long)i; },
+      [](long long a, long long b) { return a + b; });
+    ok &= check(sum == 100000LL * 99999 / 2, "parallel_reduce gives a wrong sum");
+
+    // not commutative, so the chunks must be combined in order
+    string text = parallel_reduce(executor, 0, 26, 1, string(), [](int i) { return string(1, (char)('a' + i)); },
+      [](const string& a, const string& b) { return a + b; });
+    ok &= check(text == "abcdefghijklmnopqrstuvwxyz", "parallel_reduce combines the chunks out of order");
+
+    for (int round = 0; round < 20; ++round) {
+      bool all = parallel_reduce(executor, 0, 10000, 1, true, [](int i) { return i >= 0; },
+        [](bool a, bool b) { return a && b; });
+      bool any = parallel_reduce(executor, 0, 10000, 1, false, [](int i) { return i == 9999; },
+        [](bool a, bool b) { return a || b; });
+      ok &= check(all && any, "parallel_reduce gives a wrong bool result");
+    }
+    return ok;
+  }
+
+  bool checkSubmit(Executor& executor) {
+    bool ok = true;
+
+    vector<future<int> > results;
+    for (int i = 0; i < 1000; ++i)
+      results.push_back(executor.submit([i]() { return i * i; }));
+    for (int i = 0; i < 1000; ++i)
+      ok &= check(results[i].get() == i * i, "a future of submit gives a wrong value");
+
+    future<int> failing = executor.submit([]() -> int { throw runtime_error("task"); });
+    bool thrown = false;
+    try {
+      failing.get();
+    } catch (const runtime_error&) {
+      thrown = true;
+    }
+    ok &= check(thrown, "the exception of a task is not forwarded by its future");
+    return ok;
+  }
+
+  bool checkTaskGroup(Executor& executor) {
+    bool ok = true;
+
+    // nested groups must not block the workers
+    atomic<int> count(0);
+    TaskGroup outer(executor);
+    for (int i = 0; i < 16; ++i) {
+      outer.run([&executor, &count]()
+      {
+        TaskGroup inner(executor);
+        for (int j = 0; j < 16; ++j)
+          inner.run([&count]() { ++count; });
+        inner.wait();
+      });
+    }
+    outer.wait();
+    ok &= check(count == 16 * 16, "the nested task groups do not run every task");
+
+    TaskGroup failing(executor);
+    failing.run([]() { throw runtime_error("task"); });
+    bool thrown = false;
+    try {
+      failing.wait();
+    } catch (const runtime_error&) {
+      thrown = true;
+    }
+    ok &= check(thrown, "the exception of a task is not rethrown by TaskGroup::wait");
+    return ok;
+  }
+
+  bool checkParallelForThrowsOnCaller(Executor& executor) {
+    bool ok = true;
+
+    for (int round = 0; round < 20; ++round) {
+      atomic<int> running(0);
+      bool thrown = false;
+      try {
+        // the calling thread executes index 0 after all the other ranges are scheduled
+        parallel_for(executor, 0, 4096, 1, [&running](int i)
+        {
+          ++running;
+          if (i == 0) {
+            --running;
+            throw runtime_error("body");
+          }
+          boost::this_thread::yield();
+          --running;
+        });
+      } catch (const runtime_error&) {
+        thrown = true;
+      }
+      ok &= check(thrown, "the exception of the body of parallel_for is not propagated");
+      ok &= check(running == 0, "parallel_for returns while its tasks are still running");
+    }
+    return ok;
+  }
+
+}
+
+int main() {
+  bool ok = true;
+
+  unsigned concurrencies[] = { 1, 4 };
+  for (unsigned i = 0; i < sizeof(concurrencies) / sizeof(concurrencies[0]); ++i) {
+    Executor executor(concurrencies[i]);
+    ok &= checkParallelFor(executor);
+    ok &= checkParallelReduce(executor);
+    ok &= checkSubmit(executor);
+    ok &= checkTaskGroup(executor);
+    ok &= checkParallelForThrowsOnCaller(executor);
+  }
+
+  if (ok)
+    cout << "ExecutorTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
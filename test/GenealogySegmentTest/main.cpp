@@ -0,0 +1,242 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+/*
+ * Checks the round trip of the segmented genealogy. The systems are built the same way as the DuplicatedCodeFinder
+ * does: once into a single genealogy, and once into a SegmentStore, where only the last segment is loaded, the links
+ * to the previous system are collected by SegmentStore::collectLinks and the older systems are removed before the
+ * new segment is appended. The merged segments must give the same nodes, attributes and edges (the prev/next edges
+ * between the segments included) as the single genealogy, also after the oldest segments are compacted and after a
+ * new segment is appended to the compacted store.
+ */
+
+#include <genealogy/inc/genealogy.h>
+#include <genealogy/inc/SegmentStore.h>
+#include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace columbus;
+using namespace columbus::genealogy;
+
+namespace {
+
+  const unsigned systemCount = 3;
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+  // the last system of the genealogy (NULL if there is none)
+  System* getLastSystem(Factory& factory) {
+    System* last = NULL;
+    for (ListIterator<System> it = factory.getRoot()->getSystemsListIteratorBegin(); it != factory.getRoot()->getSystemsListIteratorEnd(); ++it)
+      last = const_cast<System*>(&*it);
+    return last;
+  }
+
+  // A system with random clone classes, the classes of the same fingerprint and their instances are mapped to the
+  // ones of the last system. The nodes are created in the same order for the same sequence number.
+  System& buildSystem(Factory& factory, unsigned sequence) {
+    mt19937 random(sequence);
+    System* last = getLastSystem(factory);
+
+    System& system = *factory.createSystemNode();
+    system.setName("system");
+    system.setVersion("v" + to_string(sequence));
+    system.setAge(sequence);
+    factory.getRoot()->addSystems(&system);
+    if (last) {
+      system.setPrev(last->getId());
+      last->setNext(system.getId());
+    }
+
+    vector<Component*> components;
+    for (unsigned i = 0; i < 2; ++i) {
+      components.push_back(factory.createComponentNode());
+      components.back()->setName("c" + to_string(i));
+      system.addComponents(components.back());
+    }
+
+    unsigned classCount = 3 + random() % 3;
+    for (unsigned i = 0; i < classCount; ++i) {
+      CloneClass& cloneClass = *factory.createCloneClassNode();
+      cloneClass.setFingerprint("fp" + to_string(random() % 5));
+      system.addCloneClasses(&cloneClass);
+
+      unsigned instanceCount = 2 + random() % 2;
+      vector<CloneInstance*> instances;
+      for (unsigned j = 0; j < instanceCount; ++j) {
+        CloneInstance& instance = *factory.createCloneInstanceNode();
+        instance.setPath("src/file" + to_string(random() % 4) + ".py");
+        instance.setLine(1 + random() % 100);
+        instance.setCloneClass(&cloneClass);
+        instance.setComponent(components[random() % components.size()]);
+        cloneClass.addItems(&instance);
+        instances.push_back(&instance);
+      }
+
+      if (!last)
+        continue;
+      for (ListIterator<CloneClass> it = last->getCloneClassesListIteratorBegin(); it != last->getCloneClassesListIteratorEnd(); ++it) {
+        if (it->getFingerprint() != cloneClass.getFingerprint())
+          continue;
+        CloneClass& candidate = const_cast<CloneClass&>(*it);
+        cloneClass.addPrev(candidate.getId());
+        candidate.addNext(cloneClass.getId());
+        size_t j = 0;
+        for (ListIterator<CloneInstance> item = candidate.getItemsListIteratorBegin(); item != candidate.getItemsListIteratorEnd() && j < instances.size(); ++item, ++j) {
+          CloneInstance& prev = const_cast<CloneInstance&>(*item);
+          instances[j]->addPrev(prev.getId());
+          prev.addNext(instances[j]);
+        }
+        break;
+      }
+    }
+    return system;
+  }
+
+  // the new system is appended as a segment the same way as the DuplicatedCodeFinder does it
+  void appendSystem(const string& indexFilename, unsigned sequence) {
+    SegmentStore store(indexFilename);
+    RefDistributorStrTable strTable;
+    Factory factory(strTable);
+    CsiHeader header;
+    store.loadLast(factory, header);
+
+    System& system = buildSystem(factory, sequence);
+
+    SegmentStore::Links links;
+    SegmentStore::collectLinks(factory, system.getId(), links);
+    factory.enableReverseEdges();
+    vector<NodeId> otherSystems;
+    for (ListIterator<System> it = factory.getRoot()->getSystemsListIteratorBegin(); it != factory.getRoot()->getSystemsListIteratorEnd(); ++it)
+      if (&*it != &system)
+        otherSystems.push_back(it->getId());
+    for (vector<NodeId>::const_iterator it = otherSystems.begin(); it != otherSystems.end(); ++it)
+      factory.destroyNode(*it);
+
+    store.append(factory, header, links);
+  }
+
+  string dump(Factory& factory) {
+    set<string> lines;
+    const ReverseEdges& reverseEdges = factory.getReverseEdges();
+    vector<EdgeKind> edges;
+    for (NodeId id = 0; id < factory.size(); ++id) {
+      if (!factory.getExist(id))
+        continue;
+
+      const Base& node = factory.getRef(id);
+      string line = "node " + to_string(id) + " " + to_string(node.getNodeKind());
+      switch (node.getNodeKind()) {
+        case ndkSystem: {
+          const System& system = dynamic_cast<const System&>(node);
+          line += " " + system.getName() + " " + system.getVersion() + " " + to_string(system.getAge());
+          break;
+        }
+        case ndkComponent:
+          line += " " + dynamic_cast<const Component&>(node).getName();
+          break;
+        case ndkCloneClass:
+          line += " " + dynamic_cast<const CloneClass&>(node).getFingerprint();
+          break;
+        case ndkCloneInstance: {
+          const CloneInstance& instance = dynamic_cast<const CloneInstance&>(node);
+          line += " " + instance.getPath() + ":" + to_string(instance.getLine());
+          break;
+        }
+        default:
+          break;
+      }
+      lines.insert(line);
+
+      edges.clear();
+      reverseEdges.getAllExistingEdges(id, edges);
+      for (vector<EdgeKind>::const_iterator edge = edges.begin(); edge != edges.end(); ++edge)
+        for (ListIterator<Base> it = reverseEdges.constIteratorBegin(id, *edge); it != reverseEdges.constIteratorEnd(id, *edge); ++it)
+          lines.insert("edge " + to_string(it->getId()) + " -> " + to_string(id) + " " + to_string(*edge));
+    }
+
+    string result;
+    for (ListIterator<System> it = factory.getRoot()->getSystemsListIteratorBegin(); it != factory.getRoot()->getSystemsListIteratorEnd(); ++it)
+      result += "system " + to_string(it->getId()) + "\n";
+    for (set<string>::const_iterator it = lines.begin(); it != lines.end(); ++it)
+      result += *it + "\n";
+    return result;
+  }
+
+  bool checkMerge(const string& indexFilename, Factory& single, const string& name) {
+    SegmentStore store(indexFilename);
+    RefDistributorStrTable strTable;
+    Factory merged(strTable);
+    store.merge(merged);
+    const string expected = dump(single);
+    const string actual = dump(merged);
+    bool ok = check(actual == expected, name + ": the merged segments differ from the single genealogy:\n" + actual + "expected:\n" + expected);
+    ok &= check(expected.find(" -> ") != string::npos && getLastSystem(merged) && getLastSystem(merged)->getPrev() != NULL,
+      name + ": the systems of the segments are not linked");
+    return ok;
+  }
+
+}
+
+int main() {
+  boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("GenealogySegmentTest-%%%%-%%%%");
+  boost::filesystem::create_directories(directory);
+
+  bool ok = true;
+  try {
+    const string indexFilename = (directory / "clones.gsi").string();
+    RefDistributorStrTable strTable;
+    Factory single(strTable);
+    for (unsigned sequence = 1; sequence <= systemCount; ++sequence) {
+      buildSystem(single, sequence);
+      appendSystem(indexFilename, sequence);
+    }
+    ok &= check(SegmentStore(indexFilename).getSegmentCount() == systemCount, "a segment is not appended for every system");
+    ok &= checkMerge(indexFilename, single, "appended segments");
+
+    SegmentStore(indexFilename).compact(2);
+    ok &= check(SegmentStore(indexFilename).getSegmentCount() == systemCount - 1, "the oldest segments are not compacted");
+    ok &= checkMerge(indexFilename, single, "compacted segments");
+
+    buildSystem(single, systemCount + 1);
+    appendSystem(indexFilename, systemCount + 1);
+    ok &= checkMerge(indexFilename, single, "segment appended after the compaction");
+  } catch (const columbus::Exception& e) {
+    cerr << "FAILED: " << e.getLocation() << " : " << e.getMessage() << endl;
+    ok = false;
+  }
+
+  boost::filesystem::remove_all(directory);
+
+  if (ok)
+    cout << "GenealogySegmentTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,205 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+/*
+ * Checks the compact storage of the graph: a graph loaded by loadBinary(filename, true) must be seen through the
+ * Node, Edge and Attribute handles exactly like the same file loaded into the list based graph (iteration order in
+ * both directions, edge pairs, nested composite attributes, findNode), it must be saved into the same binary and
+ * XML files, its attribute values can be changed, but its structure cannot.
+ */
+
+#include <graph/inc/graph.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace columbus::graph;
+
+namespace {
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+  string readFile(const string& filename) {
+    ifstream in(filename.c_str(), ios::binary);
+    stringstream content;
+    content << in.rdbuf();
+    return content.str();
+  }
+
+  void generate(const string& filename) {
+    Graph graph;
+    graph.setHeaderInfo("generator", "GraphCompactTest");
+    for (int i = 0; i < 200; ++i) {
+      Node node = graph.createNode("N" + to_string(i), Node::NodeType(i % 3 ? "Class" : "Package"));
+      if (i % 4 == 0)
+        continue;
+      node.addAttribute(graph.createAttributeInt("LOC", "metric", i));
+      node.addAttribute(graph.createAttributeFloat("TLOC", "metric", i / 4.0f));
+      node.addAttribute(graph.createAttributeString("Name", "", "name" + to_string(i)));
+      if (i % 5 == 0) {
+        AttributeComposite warning = graph.createAttributeComposite("Warning", "rule");
+        warning.addAttribute(graph.createAttributeString("Path", "", "src/file" + to_string(i)));
+        AttributeComposite position = graph.createAttributeComposite("Position", "");
+        position.addAttribute(graph.createAttributeInt("Line", "", i));
+        position.addAttribute(graph.createAttributeInt("Column", "", i % 7));
+        warning.addAttribute(position);
+        warning.addAttribute(graph.createAttributeComposite("Empty", ""));
+        node.addAttribute(warning);
+      }
+    }
+    for (int i = 1; i < 200; ++i) {
+      string parent = "N" + to_string(i / 2), child = "N" + to_string(i);
+      Edge contains = graph.createDirectedEdge(parent, child, "contains", i % 3 != 0);
+      if (i % 6 == 0)
+        contains.addAttribute(graph.createAttributeInt("weight", "", i));
+      if (i % 7 == 0) {
+        Edge uses = graph.createBidirectedEdge(child, "N" + to_string((i * 13) % 200), "uses");
+        uses.addAttribute(graph.createAttributeString("kind", "", "call"));
+        uses.getReversePair().addAttribute(graph.createAttributeString("kind", "", "callee"));
+      }
+    }
+    graph.saveBinary(filename);
+  }
+
+  void dumpAttribute(ostream& out, Attribute& attribute, int depth) {
+    out << string(depth, ' ') << attribute.getType() << ' ' << attribute.getName() << ' ' << attribute.getContext()
+        << ' ' << attribute.getStringValue() << '\n';
+    if (attribute.getType() == Attribute::atComposite) {
+      Attribute::AttributeIterator it = dynamic_cast<AttributeComposite&>(attribute).getAttributes();
+      while (it.hasNext())
+        dumpAttribute(out, it.next(), depth + 1);
+      while (it.hasPrevious())
+        out << string(depth, ' ') << '<' << it.previous().getName() << '\n';
+    }
+  }
+
+  // Everything that can be reached through the handles.
+  string dump(Graph& graph) {
+    ostringstream out;
+    Node::NodeIterator nodeIt = graph.getNodes();
+    while (nodeIt.hasNext()) {
+      Node node = nodeIt.next();
+      out << node.getUID() << ' ' << node.getType().getType() << ' ' << (graph.findNode(node.getUID()) == node) << '\n';
+      Attribute::AttributeIterator attributeIt = node.getAttributes();
+      while (attributeIt.hasNext())
+        dumpAttribute(out, attributeIt.next(), 1);
+      out << ' ' << node.findAttributeByName("Name").hasNext() << node.findAttributeByContext("metric").hasNext() << '\n';
+      Edge::EdgeIterator edgeIt = node.getOutEdges();
+      while (edgeIt.hasNext()) {
+        Edge edge = edgeIt.next();
+        Edge pair = edge.getReversePair();
+        out << " edge " << edge.getType().getType() << ' ' << edge.getType().getDirectionType() << ' '
+            << edge.getFromNode().getUID() << ' ' << edge.getToNode().getUID() << ' ' << (pair == Graph::invalidEdge) << '\n';
+        if (pair != Graph::invalidEdge)
+          out << "  pair " << pair.getToNode().getUID() << ' ' << (pair.getReversePair() == edge) << '\n';
+        Attribute::AttributeIterator edgeAttributeIt = edge.getAttributes();
+        while (edgeAttributeIt.hasNext())
+          dumpAttribute(out, edgeAttributeIt.next(), 2);
+      }
+      Edge::EdgeIterator containsIt = node.findOutEdges(Edge::EdgeType("contains", Edge::edtReverse));
+      while (containsIt.hasNext())
+        out << " parent " << containsIt.next().getToNode().getUID() << '\n';
+      while (edgeIt.hasPrevious())
+        out << " <" << edgeIt.previous().getToNode().getUID() << '\n';
+    }
+    while (nodeIt.hasPrevious())
+      out << '<' << nodeIt.previous().getUID() << '\n';
+    Node::NodeIterator packageIt = graph.findNodes(Node::NodeType("Package"));
+    while (packageIt.hasNext())
+      out << "package " << packageIt.next().getUID() << '\n';
+    return out.str();
+  }
+
+  template <class Function>
+  bool throwsGraphException(Function function) {
+    try {
+      function();
+    } catch (const GraphException&) {
+      return true;
+    }
+    return false;
+  }
+
+}
+
+int main() {
+  bool ok = true;
+
+  boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("GraphCompactTest-%%%%-%%%%");
+  boost::filesystem::create_directories(directory);
+  const string graphFile = (directory / "generated.graph").string();
+  generate(graphFile);
+
+  {
+    Graph list, compact;
+    list.loadBinary(graphFile);
+    compact.loadBinary(graphFile, true);
+    ok &= check(!list.isCompact() && compact.isCompact(), "isCompact() does not report the storage");
+    ok &= check(dump(list) == dump(compact), "the compact graph is seen differently through the handles");
+
+    list.saveBinary((directory / "list.graph").string());
+    compact.saveBinary((directory / "compact.graph").string());
+    ok &= check(readFile((directory / "list.graph").string()) == readFile((directory / "compact.graph").string()),
+      "the compact graph is saved into a different binary file");
+
+    list.saveXML((directory / "list.xml").string());
+    compact.saveXML((directory / "compact.xml").string());
+    ok &= check(readFile((directory / "list.xml").string()) == readFile((directory / "compact.xml").string()),
+      "the compact graph is saved into a different XML file");
+
+    // the values and the types can be changed
+    Node node = compact.findNode("N5");
+    Attribute::AttributeIterator it = node.findAttribute(Attribute::atInt, "LOC", "metric");
+    dynamic_cast<AttributeInt&>(it.next()).setValue(42);
+    node.setType(Node::NodeType("Interface"));
+    Node changed = compact.findNode("N5");
+    ok &= check(changed.getType().getType() == "Interface", "the type of a compact node cannot be changed");
+    ok &= check(dynamic_cast<AttributeInt&>(changed.findAttribute(Attribute::atInt, "LOC", "metric").next()).getValue() == 42,
+      "the attribute of a compact node cannot be changed");
+
+    // but the structure cannot
+    ok &= check(throwsGraphException([&]() { compact.createNode("X", Node::NodeType("Class")); }), "a node can be added to the compact graph");
+    ok &= check(throwsGraphException([&]() { compact.deleteNode("N1"); }), "a node can be deleted from the compact graph");
+    ok &= check(throwsGraphException([&]() { compact.createDirectedEdge("N1", "N2", "uses", false); }), "an edge can be added to the compact graph");
+    ok &= check(throwsGraphException([&]() { node.addAttribute(compact.createAttributeInt("NOM", "metric", 1)); }), "an attribute can be added to a compact node");
+    ok &= check(throwsGraphException([&]() { node.deleteAttributes(); }), "the attributes of a compact node can be deleted");
+    ok &= check(throwsGraphException([&]() { compact.mergeWithBinary(graphFile, Graph::mmUnionAttribute, Graph::csmmUnionNewAttributes, Graph::nmmSummarizeAttributes, Graph::mmUnionAttribute, Graph::csmmUnionNewAttributes, Graph::nmmSummarizeAttributes); }),
+      "a graph can be merged into the compact graph");
+
+    // after clear() the graph is a modifiable list based graph again
+    compact.clear();
+    ok &= check(!compact.isCompact() && compact.createNode("X", Node::NodeType("Class")) != Graph::invalidNode,
+      "the cleared compact graph cannot be modified");
+  }
+
+  boost::filesystem::remove_all(directory);
+
+  if (ok)
+    cout << "GraphCompactTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
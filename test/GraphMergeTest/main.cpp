@@ -0,0 +1,284 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+/*
+ * Checks that Graph::mergeWithBinary, which streams the nodes of the files into the graph, gives the same graph as
+ * loading every file into a separate graph and merging it with Graph::merge, for every combination of the node and
+ * edge MergeMode, CompsiteAndStringMergeMode and NumericMergeMode. The files are random graphs with shared node
+ * UIDs, forward references and edge targets without a record of their own (placeholders), and they are merged both
+ * one by one and with the overload taking the list of the files.
+ */
+
+#include <graph/inc/graph.h>
+#include <io/inc/BinaryIO.h>
+#include <strtable/inc/StrTable.h>
+#include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace columbus;
+using namespace columbus::graph;
+
+namespace {
+
+  const unsigned fileCount = 3;
+  const unsigned nodeCount = 24;
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+  string dump(Attribute::AttributeIterator it) {
+    string result;
+    while (it.hasNext()) {
+      Attribute& attribute = it.next();
+      result += " " + attribute.getName() + "@" + attribute.getContext() + "=" + attribute.getStringValue();
+    }
+    return result;
+  }
+
+  // the nodes and the edges are sorted, the attributes are kept in their order
+  string dump(Graph& graph) {
+    multiset<string> lines;
+    Node::NodeIterator nodes = graph.getNodes();
+    while (nodes.hasNext()) {
+      Node node = nodes.next();
+      lines.insert("node " + node.getUID() + " " + node.getType().getType() + dump(node.getAttributes()));
+      Edge::EdgeIterator edges = node.getOutEdges();
+      while (edges.hasNext()) {
+        Edge edge = edges.next();
+        lines.insert("edge " + node.getUID() + " -> " + edge.getToNode().getUID() + " " + edge.getType().getType()
+          + " " + to_string(edge.getType().getDirectionType()) + dump(edge.getAttributes()));
+      }
+    }
+    string result;
+    for (multiset<string>::const_iterator it = lines.begin(); it != lines.end(); ++it)
+      result += *it + "\n";
+    return result;
+  }
+
+  void addAttributes(Graph& graph, mt19937& random, Node node) {
+    unsigned count = random() % 4;
+    for (unsigned i = 0; i < count; ++i) {
+      string context = random() % 2 ? "metric" : "";
+      switch (random() % 4) {
+        case 0:
+          node.addAttribute(graph.createAttributeInt("LOC", context, random() % 10));
+          break;
+        case 1:
+          node.addAttribute(graph.createAttributeFloat("TLOC", context, (random() % 10) / 4.0f));
+          break;
+        case 2:
+          node.addAttribute(graph.createAttributeString("Name", context, "name" + to_string(random() % 3)));
+          break;
+        default: {
+          AttributeComposite warning = graph.createAttributeComposite("Warning", "rule");
+          warning.addAttribute(graph.createAttributeString("Path", "", "src/file" + to_string(random() % 3)));
+          warning.addAttribute(graph.createAttributeInt("Line", "", random() % 100));
+          node.addAttribute(warning);
+        }
+      }
+    }
+  }
+
+  // a random graph, the UIDs of the nodes are shared by the files
+  void generate(const string& filename, unsigned seed) {
+    mt19937 random(seed);
+    Graph graph;
+    graph.setHeaderInfo("file", to_string(seed));
+    vector<Node> nodes;
+    for (unsigned i = 0; i < nodeCount; ++i) {
+      string uid = "N" + to_string(random() % (nodeCount * 2));
+      if (graph.nodeIsExist(uid))
+        continue;
+      nodes.push_back(graph.createNode(uid, Node::NodeType(random() % 2 ? "Class" : "Method")));
+      addAttributes(graph, random, nodes.back());
+    }
+    for (unsigned i = 0; i < nodeCount * 2; ++i) {
+      const Node& from = nodes[random() % nodes.size()];
+      const Node& to = nodes[random() % nodes.size()];
+      string type = random() % 2 ? "calls" : "contains";
+      Edge edge;
+      switch (random() % 3) {
+        case 0:
+          edge = graph.createDirectedEdge(from, to, type, false);
+          break;
+        case 1:
+          edge = graph.createDirectedEdge(from, to, type, true);
+          break;
+        default:
+          edge = graph.createBidirectedEdge(from, to, type);
+      }
+      if (random() % 2)
+        edge.addAttribute(graph.createAttributeInt("weight", "", random() % 5));
+    }
+    graph.saveBinary(filename);
+  }
+
+  void writeAttribute(io::BinaryIO& out, StrTable& strTable, const string& name, int value) {
+    out.writeUInt4(Attribute::atInt);
+    out.writeUInt4(strTable.set(name));
+    out.writeUInt4(strTable.set(""));
+    out.writeInt4(value);
+  }
+
+  void writeEdge(io::BinaryIO& out, StrTable& strTable, const string& type, const string& to, int weight) {
+    out.writeUInt4(strTable.set(type));
+    out.writeUInt4(Edge::edtDirectional);
+    out.writeUInt4(strTable.set(to));
+    out.writeBool1(false);
+    out.writeUInt4(1);
+    writeAttribute(out, strTable, "weight", weight);
+  }
+
+  // a graph file which cannot be saved by Graph: the edge targets "P<seed>" and "N1" have no record of their own,
+  // and "N3" is referenced before its record
+  void generatePlaceholders(const string& filename, unsigned seed) {
+    StrTable strTable;
+    strTable.set("");
+    const string records[] = { "N" + to_string(seed % 5), "N3" };
+    for (unsigned i = 0; i < 2; ++i)
+      strTable.set(records[i]);
+    strTable.set("P" + to_string(seed));
+    strTable.set("N1");
+    strTable.set("Class");
+    strTable.set("calls");
+    strTable.set("weight");
+    strTable.set("LOC");
+
+    io::BinaryIO out(filename, io::BinaryIO::omWrite);
+    strTable.save(out);
+    out.writeUInt4(0);
+
+    out.writeUInt4(strTable.set(records[0]));
+    out.writeUInt4(strTable.set("Class"));
+    out.writeUInt4(1);
+    writeAttribute(out, strTable, "LOC", seed);
+    writeEdge(out, strTable, "calls", "P" + to_string(seed), 1);
+    writeEdge(out, strTable, "calls", "N1", 2);
+    writeEdge(out, strTable, "calls", "N3", 3);
+    out.writeUInt4(0);
+    out.writeUInt4(0);
+    out.writeUInt4(0);
+
+    out.writeUInt4(strTable.set(records[1]));
+    out.writeUInt4(strTable.set("Class"));
+    out.writeUInt4(1);
+    writeAttribute(out, strTable, "LOC", seed + 1);
+    writeEdge(out, strTable, "calls", "P" + to_string(seed), 4);
+    out.writeUInt4(0);
+    out.writeUInt4(0);
+    out.writeUInt4(0);
+
+    out.writeUInt4(0);
+    out.writeUInt4(0);
+    out.close();
+  }
+
+  struct Modes {
+    Graph::MergeMode merge;
+    Graph::CompsiteAndStringMergeMode compositeAndString;
+    Graph::NumericMergeMode numeric;
+
+    string toString() const {
+      return to_string(merge) + "/" + to_string(compositeAndString) + "/" + to_string(numeric);
+    }
+  };
+
+  void countFiles(const string& filename, void* data) {
+    static_cast<vector<string>*>(data)->push_back(filename);
+  }
+
+  bool testMerge(const string& base, const vector<string>& files, const Modes& node, const Modes& edge) {
+    const string modes = "node modes " + node.toString() + ", edge modes " + edge.toString();
+
+    Graph expected;
+    expected.loadBinary(base);
+    for (vector<string>::const_iterator it = files.begin(); it != files.end(); ++it) {
+      Graph graph;
+      graph.loadBinary(*it);
+      expected.merge(graph, node.merge, node.compositeAndString, node.numeric, edge.merge, edge.compositeAndString, edge.numeric);
+    }
+    const string expectedDump = dump(expected);
+
+    Graph streamed;
+    streamed.loadBinary(base);
+    for (vector<string>::const_iterator it = files.begin(); it != files.end(); ++it)
+      streamed.mergeWithBinary(*it, node.merge, node.compositeAndString, node.numeric, edge.merge, edge.compositeAndString, edge.numeric);
+    bool ok = check(dump(streamed) == expectedDump, modes + ": mergeWithBinary differs from merge:\n" + dump(streamed) + "expected:\n" + expectedDump);
+
+    Graph listed;
+    listed.loadBinary(base);
+    vector<string> mergedFiles;
+    listed.mergeWithBinary(files, node.merge, node.compositeAndString, node.numeric, edge.merge, edge.compositeAndString, edge.numeric, 2, countFiles, &mergedFiles);
+    ok &= check(dump(listed) == expectedDump, modes + ": mergeWithBinary of the file list differs from merge:\n" + dump(listed) + "expected:\n" + expectedDump);
+    ok &= check(mergedFiles == files, modes + ": the callback is not called for the files in their order");
+    return ok;
+  }
+
+}
+
+int main() {
+  boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("GraphMergeTest-%%%%-%%%%");
+  boost::filesystem::create_directories(directory);
+
+  bool ok = true;
+  try {
+    const string base = (directory / "base.graph").string();
+    generate(base, 1);
+    vector<string> files;
+    for (unsigned i = 0; i < fileCount; ++i) {
+      files.push_back((directory / ("file" + to_string(i) + ".graph")).string());
+      generate(files.back(), i + 2);
+      files.push_back((directory / ("placeholders" + to_string(i) + ".graph")).string());
+      generatePlaceholders(files.back(), i);
+    }
+
+    vector<Modes> allModes;
+    for (int merge = Graph::mmDropOldAttributes; merge <= Graph::mmUnionAttribute; ++merge)
+      for (int compositeAndString = Graph::csmmDropOldAttributes; compositeAndString <= Graph::csmmUnionNewAttributes; ++compositeAndString)
+        for (int numeric = Graph::nmmDropOldAttributes; numeric <= Graph::nmmSummarizeAttributes; ++numeric) {
+          Modes modes = { static_cast<Graph::MergeMode>(merge), static_cast<Graph::CompsiteAndStringMergeMode>(compositeAndString), static_cast<Graph::NumericMergeMode>(numeric) };
+          allModes.push_back(modes);
+        }
+
+    // every node mode with every edge mode, stopping at the first difference
+    for (vector<Modes>::const_iterator node = allModes.begin(); ok && node != allModes.end(); ++node)
+      for (vector<Modes>::const_iterator edge = allModes.begin(); ok && edge != allModes.end(); ++edge)
+        ok &= testMerge(base, files, *node, *edge);
+  } catch (const columbus::Exception& e) {
+    cerr << "FAILED: " << e.getLocation() << " : " << e.getMessage() << endl;
+    ok = false;
+  }
+
+  boost::filesystem::remove_all(directory);
+
+  if (ok)
+    cout << "GraphMergeTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,512 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+/*
+ * Checks the LCOM5 metric of the LimMetricsVisitor.
+ * The values of small hand made classes are checked against their known values, and the values and the exported
+ * components (LCOMMap) of random classes are compared with the pairwise scan of the previous implementation,
+ * which joined the components in the same order.
+ */
+
+#include <lim/inc/lim.h>
+#include <lim2graph/inc/Lim2GraphConverter.h>
+#include <limmetrics/inc/LimMetrics.h>
+#include <graphsupport/inc/GraphConstants.h>
+#include <rul/inc/RulHandler.h>
+#include <iostream>
+#include <random>
+
+using namespace std;
+using namespace columbus;
+using namespace columbus::lim::asg;
+using namespace columbus::graphsupport::graphconstants;
+
+namespace {
+
+  typedef lim::metrics::LCOMMapType LCOMMap;
+
+  /**
+  * Builds the classes of a Java LIM.
+  */
+  class LimBuilder {
+
+    public:
+
+      LimBuilder( Factory& factory ) : factory( factory ), package( *factory.createPackageNode() ), file( factory.createFile( "src/Test.java" ) ) {
+        package.setName( "test" );
+        package.setLanguage( lnkJava );
+        factory.getRoot()->addMember( &package );
+      }
+
+      logical::Class& clazz( const string& name, const logical::Class* base = NULL ) {
+        logical::Class& node = *factory.createClassNode();
+        member( node, name, true );
+        node.setClassKind( clkClass );
+        package.addMember( &node );
+        if ( base ) {
+          factory.beginType();
+          factory.addTypeFormer( factory.createTypeFormerType( base->getId() ).getId() );
+          node.addIsSubclass( factory.endType().getId() );
+        }
+        return node;
+      }
+
+      logical::Attribute& attribute( logical::Class& parent, const string& name ) {
+        logical::Attribute& node = *factory.createAttributeNode();
+        member( node, name, true );
+        parent.addMember( &node );
+        return node;
+      }
+
+      logical::Method& method( logical::Class& parent, const string& name, MethodKind kind = mekNormal, bool defined = true, bool isAbstract = false ) {
+        logical::Method& node = *factory.createMethodNode();
+        member( node, name, defined );
+        node.setMethodKind( kind );
+        node.setIsAbstract( isAbstract );
+        parent.addMember( &node );
+        return node;
+      }
+
+      void access( logical::Method& method, const logical::Attribute& attribute ) {
+        method.addAccessesAttribute( &factory.createAttributeAccess( attribute.getId() ) );
+      }
+
+      void call( logical::Method& method, const logical::Method& called ) {
+        method.addCalls( &factory.createMethodCall( called.getId() ) );
+      }
+
+    private:
+
+      void member( logical::Member& node, const string& name, bool defined ) {
+        dynamic_cast<base::Named&>( node ).setName( name );
+        node.setLanguage( lnkJava );
+        node.setAccessibility( ackPublic );
+        SourcePosition position;
+        position.setRealizationLevel( defined ? relDefines : relDeclares );
+        position.setLine( 1 );
+        position.setEndLine( 2 );
+        node.addIsContainedIn( file.getId(), position );
+      }
+
+      Factory& factory;
+      logical::Package& package;
+      physical::File& file;
+  };
+
+  /**
+  * A method in the pairwise scan of the previous implementation.
+  */
+  struct ReferenceElement {
+    const logical::Method* method;
+    ReferenceElement* nextElement;
+    set<const logical::Attribute*> accessedAttributes;
+    set<const logical::Method*> methodCalls;
+  };
+
+  bool isRoot( const ReferenceElement& element ) {
+    return element.nextElement == NULL || element.nextElement == &element;
+  }
+
+  ReferenceElement* getRoot( ReferenceElement* element ) {
+    while ( ! isRoot( *element ) ) {
+      element = element->nextElement;
+    }
+    return element;
+  }
+
+  const logical::Class* getClassOfMember( const ReverseEdges& revEdges, NodeId id ) {
+    ListIterator<base::Base> it = revEdges.constIteratorBegin( id, edkScope_HasMember );
+    if ( it == revEdges.constIteratorEnd( id, edkScope_HasMember ) || ! Common::getIsClass( *it ) ) {
+      return NULL;
+    }
+    const logical::Class* clazz = dynamic_cast<const logical::Class*>( &*it );
+    if ( clazz->getAggregated() != NULL ) {
+      clazz = dynamic_cast<const logical::Class*>( clazz->getAggregated() );
+    }
+    return clazz;
+  }
+
+  template<class T> void insertAll( set<T>& target, const set<T>& source ) {
+    target.insert( source.begin(), source.end() );
+  }
+
+  /**
+  * The LCOM5 of the class computed by the pairwise scan of the previous implementation (the order of the joins,
+  * the roots of the components and the ignored getter/setter/constructor/destructor components are the same).
+  */
+  int referenceLCOM5( Factory& factory, const logical::Class& actClass, LCOMMap& lcomMap ) {
+    const ReverseEdges& revEdges = factory.getReverseEdges();
+
+    set<const logical::Class*> parentClasses;
+    parentClasses.insert( &actClass );
+    if ( ! actClass.getIsSubclassIsEmpty() ) {
+      Common::collectAncestors( revEdges, actClass, parentClasses );
+    }
+
+    vector<ReferenceElement> elements;
+    for ( ListIterator<logical::Member> it = actClass.getMemberListIteratorBegin(); it != actClass.getMemberListIteratorEnd(); ++it ) {
+      if ( ! Common::getIsMethod( *it ) || ! lim::metrics::NodeWrapper::isDefinition( *it ) ) {
+        continue;
+      }
+      const logical::Method& method = dynamic_cast<const logical::Method&>( *it );
+      if ( method.getIsAbstract() ) {
+        continue;
+      }
+      ReferenceElement element;
+      element.method = &method;
+      element.nextElement = NULL;
+      for ( ListIterator<logical::AttributeAccess> access = method.getAccessesAttributeListIteratorBegin(); access != method.getAccessesAttributeListIteratorEnd(); ++access ) {
+        if ( access->getAttribute() ) {
+          element.accessedAttributes.insert( access->getAttribute() );
+        }
+      }
+      for ( ListIterator<logical::MethodCall> call = method.getCallsListIteratorBegin(); call != method.getCallsListIteratorEnd(); ++call ) {
+        if ( call->getMethod() ) {
+          element.methodCalls.insert( call->getMethod() );
+        }
+      }
+      elements.push_back( element );
+    }
+    const size_t size = elements.size();
+
+    // method calls inside the class
+    for ( size_t i = 0; i < size; ++i ) {
+      ReferenceElement& actual = elements[i];
+      for ( ListIterator<logical::MethodCall> call = actual.method->getCallsListIteratorBegin(); call != actual.method->getCallsListIteratorEnd(); ++call ) {
+        const logical::Method* called = call->getMethod();
+        for ( size_t j = 0; j < size; ++j ) {
+          ReferenceElement& other = elements[j];
+          if ( i == j || called == NULL || called->getId() != other.method->getId() ) {
+            continue;
+          }
+          const logical::Class* classOfMethod = getClassOfMember( revEdges, called->getId() );
+          if ( classOfMethod == NULL || classOfMethod->getId() != actClass.getId() ) {
+            continue;
+          }
+
+          if ( isRoot( actual ) ) {
+            ReferenceElement* root = isRoot( other ) ? &other : getRoot( &other );
+            root->nextElement = &actual;
+            insertAll( actual.accessedAttributes, root->accessedAttributes );
+            insertAll( actual.methodCalls, root->methodCalls );
+          } else {
+            ReferenceElement* actualRoot = getRoot( &actual );
+            if ( isRoot( other ) ) {
+              other.nextElement = actualRoot;
+              insertAll( actualRoot->accessedAttributes, other.accessedAttributes );
+              insertAll( actualRoot->methodCalls, other.methodCalls );
+            } else {
+              ReferenceElement* root = getRoot( &other );
+              if ( root != actualRoot ) {
+                actualRoot->nextElement = root;
+                insertAll( root->accessedAttributes, actualRoot->accessedAttributes );
+                insertAll( root->methodCalls, actualRoot->methodCalls );
+              }
+            }
+          }
+        }
+      }
+    }
+
+    // shared attributes and called methods
+    for ( size_t i = 0; i < size; ++i ) {
+      ReferenceElement& actual = elements[i];
+      if ( ! isRoot( actual ) ) {
+        continue;
+      }
+      for ( size_t j = 0; j < size; ++j ) {
+        ReferenceElement& other = elements[j];
+        if ( i == j || ! isRoot( other ) ) {
+          continue;
+        }
+
+        bool isConnected = false;
+        for ( set<const logical::Attribute*>::const_iterator it = actual.accessedAttributes.begin(); it != actual.accessedAttributes.end(); ++it ) {
+          if ( other.accessedAttributes.find( *it ) == other.accessedAttributes.end() ) {
+            continue;
+          }
+          const logical::Class* classOfAttribute = getClassOfMember( revEdges, ( *it )->getId() );
+          if ( classOfAttribute != NULL && ( parentClasses.find( classOfAttribute ) != parentClasses.end() || classOfAttribute->getId() == actClass.getId() ) ) {
+            other.nextElement = &actual;
+            insertAll( actual.accessedAttributes, other.accessedAttributes );
+            isConnected = true;
+            break;
+          }
+        }
+        if ( isConnected ) {
+          continue;
+        }
+
+        for ( set<const logical::Method*>::const_iterator it = actual.methodCalls.begin(); it != actual.methodCalls.end(); ++it ) {
+          if ( other.methodCalls.find( *it ) == other.methodCalls.end() ) {
+            continue;
+          }
+          const logical::Class* classOfMethod = getClassOfMember( revEdges, ( *it )->getId() );
+          if ( classOfMethod != NULL && parentClasses.find( classOfMethod ) != parentClasses.end() ) {
+            other.nextElement = &actual;
+            insertAll( actual.methodCalls, other.methodCalls );
+            break;
+          }
+        }
+      }
+    }
+
+    // the components containing only constructors, destructors, getters or setters are ignored
+    map<const ReferenceElement*, bool> ignoreMap;
+    for ( size_t i = 0; i < size; ++i ) {
+      if ( ignoreMap.find( &elements[i] ) != ignoreMap.end() ) {
+        continue;
+      }
+      ReferenceElement* step = &elements[i];
+      bool ignore = true;
+      for ( ;; ) {
+        MethodKind kind = step->method->getMethodKind();
+        if ( kind != mekConstructor && kind != mekDestructor && kind != mekGet && kind != mekSet ) {
+          ignore = false;
+          break;
+        }
+        if ( isRoot( *step ) ) {
+          break;
+        }
+        step = step->nextElement;
+      }
+      if ( ignoreMap.find( step ) == ignoreMap.end() ) {
+        for ( ;; ) {
+          ignoreMap[step] = ignore;
+          if ( isRoot( *step ) ) {
+            break;
+          }
+          step = step->nextElement;
+        }
+      }
+    }
+
+    int lcom = 0;
+    for ( size_t i = 0; i < size; ++i ) {
+      ReferenceElement& actual = elements[i];
+      if ( ! ignoreMap[&actual] ) {
+        lcomMap[actClass.getName()][getRoot( &actual )->method->getName()].push_back( actual.method->getName() );
+        if ( isRoot( actual ) ) {
+          ++lcom;
+        }
+      }
+    }
+    return lcom;
+  }
+
+  /**
+  * Runs the metrics on the LIM and gives back the LCOM5 values of the classes by their ids.
+  */
+  map<NodeId, int> calculate( Factory& factory, OverrideRelations& overrides, rul::RulHandler& rul, LCOMMap& lcomMap ) {
+    factory.initializeFilter();
+
+    graph::Graph graph;
+    lim2graph::convertBaseGraph( factory, graph, true, true, true, true, false );
+
+    lim::metrics::SharedContainers shared;
+    lim::metrics::InheritanceHelper inheritance( factory.getReverseEdges() );
+    shared.overrides = &overrides;
+    shared.factory = &factory;
+    shared.inheritance = &inheritance;
+    shared.LCOMMap = &lcomMap;
+
+    lim::metrics::LimMetricsVisitor visitor( factory, graph, rul, shared );
+    visitor.run();
+
+    map<NodeId, int> values;
+    for ( Factory::const_iterator it = factory.begin(); it != factory.end(); ++it ) {
+      if ( ! Common::getIsClass( **it ) ) {
+        continue;
+      }
+      graph::Node node = graph.findNode( "L" + Common::toString( ( *it )->getId() ) );
+      if ( node == graph::Graph::invalidNode ) {
+        continue;
+      }
+      graph::Attribute::AttributeIterator attribute = node.findAttribute( graph::Attribute::atInt, "LCOM5", CONTEXT_METRIC );
+      if ( attribute.hasNext() ) {
+        values[( *it )->getId()] = dynamic_cast<graph::AttributeInt&>( attribute.next() ).getValue();
+      }
+    }
+    return values;
+  }
+
+  bool check( bool condition, const string& message ) {
+    if ( ! condition ) {
+      cerr << "FAILED: " << message << endl;
+    }
+    return condition;
+  }
+
+  bool checkValue( const map<NodeId, int>& values, const logical::Class& clazz, int expected ) {
+    map<NodeId, int>::const_iterator it = values.find( clazz.getId() );
+    if ( it == values.end() ) {
+      return check( false, "there is no LCOM5 for " + clazz.getName() );
+    }
+    return check( it->second == expected, "the LCOM5 of " + clazz.getName() + " is " + Common::toString( it->second ) + " instead of " + Common::toString( expected ) );
+  }
+
+  bool testKnownValues( rul::RulHandler& rul ) {
+    RefDistributorStrTable strTable;
+    Factory factory( strTable, "", limLangJava );
+    OverrideRelations overrides( factory );
+    LimBuilder lim( factory );
+
+    // two methods sharing an attribute and an independent one
+    logical::Class& sharedAttribute = lim.clazz( "SharedAttribute" );
+    logical::Attribute& a = lim.attribute( sharedAttribute, "a" );
+    logical::Attribute& b = lim.attribute( sharedAttribute, "b" );
+    lim.access( lim.method( sharedAttribute, "m1" ), a );
+    lim.access( lim.method( sharedAttribute, "m2" ), a );
+    lim.access( lim.method( sharedAttribute, "m3" ), b );
+
+    // a call chain inside the class and an independent method
+    logical::Class& calls = lim.clazz( "Calls" );
+    logical::Method& c1 = lim.method( calls, "c1" );
+    logical::Method& c2 = lim.method( calls, "c2" );
+    logical::Method& c3 = lim.method( calls, "c3" );
+    lim.method( calls, "c4" );
+    lim.call( c1, c2 );
+    lim.call( c3, c2 );
+
+    // the getters, setters and constructors alone are not counted
+    logical::Class& accessors = lim.clazz( "Accessors" );
+    logical::Attribute& x = lim.attribute( accessors, "x" );
+    logical::Attribute& y = lim.attribute( accessors, "y" );
+    lim.access( lim.method( accessors, "getX", mekGet ), x );
+    lim.access( lim.method( accessors, "setX", mekSet ), x );
+    lim.method( accessors, "Accessors", mekConstructor );
+    logical::Method& getY = lim.method( accessors, "getY", mekGet );
+    lim.access( getY, y );
+    lim.access( lim.method( accessors, "compute" ), y );
+
+    // the inherited attributes connect the methods, the attributes of other classes don't
+    logical::Class& other = lim.clazz( "Other" );
+    logical::Attribute& foreign = lim.attribute( other, "foreign" );
+    lim.access( lim.method( other, "use" ), foreign );
+    logical::Class& derived = lim.clazz( "Derived", &sharedAttribute );
+    lim.access( lim.method( derived, "d1" ), a );
+    lim.access( lim.method( derived, "d2" ), a );
+    lim.access( lim.method( derived, "d3" ), foreign );
+    lim.access( lim.method( derived, "d4" ), foreign );
+
+    // the abstract and the declared only methods are not counted, calling the same method of the class connects
+    logical::Class& abstractCalls = lim.clazz( "AbstractCalls" );
+    logical::Method& hook = lim.method( abstractCalls, "hook", mekNormal, true, true );
+    lim.call( lim.method( abstractCalls, "t1" ), hook );
+    lim.call( lim.method( abstractCalls, "t2" ), hook );
+    lim.method( abstractCalls, "declared", mekNormal, false );
+
+    // no methods at all
+    logical::Class& empty = lim.clazz( "Empty" );
+    lim.attribute( empty, "e" );
+
+    LCOMMap lcomMap;
+    map<NodeId, int> values = calculate( factory, overrides, rul, lcomMap );
+
+    bool ok = true;
+    ok &= checkValue( values, sharedAttribute, 2 );
+    ok &= checkValue( values, calls, 2 );
+    ok &= checkValue( values, accessors, 1 );
+    ok &= checkValue( values, other, 1 );
+    ok &= checkValue( values, derived, 3 );
+    ok &= checkValue( values, abstractCalls, 1 );
+    ok &= checkValue( values, empty, 0 );
+    return ok;
+  }
+
+  bool testRandomClasses( rul::RulHandler& rul, unsigned seed ) {
+    RefDistributorStrTable strTable;
+    Factory factory( strTable, "", limLangJava );
+    OverrideRelations overrides( factory );
+    LimBuilder lim( factory );
+    mt19937 random( seed );
+
+    const MethodKind kinds[] = { mekNormal, mekNormal, mekNormal, mekGet, mekSet, mekConstructor, mekDestructor };
+    vector<logical::Class*> classes;
+    vector<vector<logical::Method*>> methods;
+    vector<vector<logical::Attribute*>> attributes;
+    for ( unsigned c = 0; c < 60; ++c ) {
+      string name = "C" + Common::toString( c );
+      logical::Class* base = ! classes.empty() && random() % 2 ? classes[random() % classes.size()] : NULL;
+      classes.push_back( &lim.clazz( name, base ) );
+      attributes.push_back( vector<logical::Attribute*>() );
+      methods.push_back( vector<logical::Method*>() );
+      for ( unsigned i = random() % 5; i; --i ) {
+        attributes.back().push_back( &lim.attribute( *classes.back(), name + "_a" + Common::toString( i ) ) );
+      }
+      for ( unsigned i = 1 + random() % 14; i; --i ) {
+        methods.back().push_back( &lim.method( *classes.back(), name + "_m" + Common::toString( i ), kinds[random() % 7], random() % 8 != 0, random() % 8 == 0 ) );
+      }
+    }
+
+    // mostly the members of the own class, sometimes the members of any class (the ancestors among them)
+    for ( size_t c = 0; c < classes.size(); ++c ) {
+      for ( size_t m = 0; m < methods[c].size(); ++m ) {
+        for ( unsigned i = random() % 4; i; --i ) {
+          size_t target = random() % 4 ? c : random() % classes.size();
+          lim.call( *methods[c][m], *methods[target][random() % methods[target].size()] );
+        }
+        for ( unsigned i = random() % 4; i; --i ) {
+          size_t target = random() % 4 ? c : random() % classes.size();
+          if ( ! attributes[target].empty() ) {
+            lim.access( *methods[c][m], *attributes[target][random() % attributes[target].size()] );
+          }
+        }
+      }
+    }
+
+    LCOMMap lcomMap;
+    map<NodeId, int> values = calculate( factory, overrides, rul, lcomMap );
+
+    bool ok = check( values.size() == classes.size(), "the LCOM5 is not calculated for every class" );
+    LCOMMap referenceMap;
+    for ( size_t c = 0; c < classes.size(); ++c ) {
+      int expected = referenceLCOM5( factory, *classes[c], referenceMap );
+      ok &= checkValue( values, *classes[c], expected );
+    }
+    ok &= check( lcomMap == referenceMap, "the exported components differ from the ones of the pairwise scan (seed " + Common::toString( seed ) + ")" );
+    return ok;
+  }
+
+}
+
+int main( int argc, char* argv[] ) {
+  if ( argc < 2 ) {
+    cerr << "Usage: " << argv[0] << " MET.rul" << endl;
+    return EXIT_FAILURE;
+  }
+
+  bool ok = true;
+  try {
+    rul::RulHandler rul( argv[1], "java", "eng" );
+    ok &= testKnownValues( rul );
+    for ( unsigned seed = 1; seed <= 20; ++seed ) {
+      ok &= testRandomClasses( rul, seed );
+    }
+  } catch ( const columbus::Exception& e ) {
+    cerr << "FAILED: " << e.getLocation() << " : " << e.getMessage() << endl;
+    ok = false;
+  }
+
+  if ( ok ) {
+    cout << "LCOM5Test passed" << endl;
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
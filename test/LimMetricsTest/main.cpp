@@ -0,0 +1,471 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+/*
+ * Checks the LimMetricsVisitor on synthetic Java and C++ LIMs (packages, nested and local classes, functions,
+ * multiple inheritance, generic instances, calls and accesses).
+ * The graph and the LCOMMap computed with more threads, where the subtrees of the top level classes and functions
+ * are visited on workers and their metric values are replayed from MetricBuffers, must be the same as the serial
+ * ones. The answers of the ClassHierarchyIndex must be the same as the lim::Common traversals used before it, and
+ * the classes reaching a cyclic hierarchy must not be covered by the index, so the InheritanceHelper falls back to
+ * the traversal for them.
+ */
+
+#include <lim/inc/lim.h>
+#include <lim2graph/inc/Lim2GraphConverter.h>
+#include <limmetrics/inc/LimMetrics.h>
+#include <rul/inc/RulHandler.h>
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+using namespace std;
+using namespace columbus;
+using namespace columbus::lim::asg;
+
+namespace {
+
+  /**
+  * Builds a random LIM of the given language.
+  */
+  class LimGenerator {
+
+    public:
+
+      LimGenerator( Factory& factory, bool cpp, unsigned seed ) : factory( factory ), cpp( cpp ), random( seed ), classes(), methods(), attributes(), files(), components() {
+      }
+
+      void build( unsigned packageCount, unsigned classCount ) {
+        base::Component& root = factory.getComponentRootRef();
+        for ( unsigned i = 0; i < 3; ++i ) {
+          base::Component& component = factory.createComponent( "component" + Common::toString( i ) );
+          root.addContains( &component );
+          components.push_back( &component );
+        }
+        components[0]->addContains( components[2] );
+
+        for ( unsigned i = 0; i < 20; ++i ) {
+          physical::File& file = factory.createFile( "src/dir" + Common::toString( i % 4 ) + "/file" + Common::toString( i ) + ( cpp ? ".cpp" : ".java" ) );
+          file.setLOC( 100 + next( 100 ) );
+          file.setLLOC( 50 + next( 50 ) );
+          file.setCLOC( next( 30 ) );
+          file.setNumberOfBranches( next( 20 ) );
+          components[next( 3 )]->addFiles( &file );
+          files.push_back( file.getId() );
+        }
+
+        for ( unsigned i = 0; i < packageCount; ++i ) {
+          package( *factory.getRoot(), "pkg" + Common::toString( i ), 0, classCount );
+        }
+
+        for ( size_t i = 0; i < methods.size(); ++i ) {
+          logical::Method& method = dynamic_cast<logical::Method&>( factory.getRef( methods[i] ) );
+          for ( unsigned c = next( 5 ); c; --c ) {
+            method.addCalls( &factory.createMethodCall( methods[next( methods.size() )] ) );
+          }
+          for ( unsigned a = attributes.empty() ? 0 : next( 4 ); a; --a ) {
+            method.addAccessesAttribute( &factory.createAttributeAccess( attributes[next( attributes.size() )] ) );
+          }
+          if ( next( 3 ) == 0 ) {
+            method.addUses( type( classes[next( classes.size() )] ).getId() );
+          }
+        }
+      }
+
+    private:
+
+      unsigned next( size_t n ) {
+        return random() % n;
+      }
+
+      type::Type& type( NodeId refersTo ) {
+        factory.beginType();
+        factory.addTypeFormer( factory.createTypeFormerType( refersTo ).getId() );
+        return factory.endType();
+      }
+
+      void member( logical::Member& node, const string& name ) {
+        dynamic_cast<base::Named&>( node ).setName( name );
+        node.setLanguage( cpp ? lnkCpp : lnkJava );
+        node.setAccessibility( static_cast<AccessibilityKind>( next( ackLAST ) ) );
+        node.setIsStatic( next( 4 ) == 0 );
+        node.setCommentLines( next( 3 ) ? 0 : next( 20 ) );
+        if ( next( 2 ) ) {
+          node.addComment( &factory.createComment( "/** doc */" ) );
+        }
+
+        SourcePosition position;
+        position.setRealizationLevel( next( 5 ) ? relDefines : relDeclares );
+        position.setLine( 1 + next( 100 ) );
+        position.setColumn( 1 );
+        position.setEndLine( 100 + next( 100 ) );
+        position.setEndColumn( 2 );
+        node.addIsContainedIn( files[next( files.size() )], position );
+        node.addBelongsTo( components[next( components.size() )] );
+        if ( next( 3 ) == 0 ) {
+          node.addBelongsTo( components[next( components.size() )] );
+        }
+      }
+
+      void scope( logical::Scope& node ) {
+        unsigned loc = 1 + next( 200 );
+        node.setLOC( loc );
+        node.setLLOC( loc / 2 );
+        node.setTLOC( loc + next( 50 ) );
+        node.setTLLOC( loc / 2 + next( 20 ) );
+      }
+
+      logical::Method& method( logical::Scope& parent, const string& name ) {
+        const MethodKind kinds[] = { mekNormal, mekNormal, mekGet, mekSet, mekConstructor };
+        logical::Method& node = *factory.createMethodNode();
+        member( node, name );
+        scope( node );
+        node.setMethodKind( kinds[next( 5 )] );
+        node.setNumberOfBranches( next( 12 ) );
+        node.setNumberOfStatements( next( 40 ) );
+        node.setNestingLevel( next( 5 ) );
+        node.setNestingLevelElseIf( next( 5 ) );
+        node.setDistinctOperands( next( 30 ) );
+        node.setDistinctOperators( next( 20 ) );
+        node.setTotalOperands( next( 100 ) );
+        node.setTotalOperators( next( 90 ) );
+        node.setIsAbstract( next( 8 ) == 0 );
+        node.setIsVirtual( next( 3 ) == 0 );
+        for ( unsigned i = next( 4 ); i; --i ) {
+          logical::Parameter& parameter = *factory.createParameterNode();
+          parameter.setName( "p" + Common::toString( i ) );
+          node.addParameter( &parameter );
+        }
+        parent.addMember( &node );
+        methods.push_back( node.getId() );
+        return node;
+      }
+
+      void attribute( logical::Scope& parent, const string& name ) {
+        logical::Attribute& node = *factory.createAttributeNode();
+        member( node, name );
+        parent.addMember( &node );
+        attributes.push_back( node.getId() );
+      }
+
+      // the base classes are created earlier, so the hierarchy is acyclic
+      void clazz( logical::Scope& parent, const string& name, int depth ) {
+        const ClassKind cppKinds[] = { clkClass, clkClass, clkStruct, clkUnion, clkInterface, clkEnum };
+        const ClassKind javaKinds[] = { clkClass, clkClass, clkClass, clkInterface, clkEnum, clkAnnotation };
+        logical::Class& node = *factory.createClassNode();
+        member( node, name );
+        scope( node );
+        node.setClassKind( cpp ? cppKinds[next( 6 )] : javaKinds[next( 6 )] );
+        node.setIsAbstract( next( 5 ) == 0 );
+        parent.addMember( &node );
+        for ( unsigned i = classes.empty() ? 0 : next( 3 ); i; --i ) {
+          node.addIsSubclass( type( classes[next( classes.size() )] ).getId() );
+        }
+        classes.push_back( node.getId() );
+
+        if ( ! cpp && next( 6 ) == 0 ) {
+          logical::ClassGenericInstance& instance = *factory.createClassGenericInstanceNode();
+          member( instance, name + "<T>" );
+          instance.setClassKind( node.getClassKind() );
+          parent.addMember( &instance );
+          node.addInstance( &instance );
+          classes.push_back( instance.getId() );
+        }
+
+        for ( unsigned i = next( 5 ); i; --i ) {
+          attribute( node, name + "_a" + Common::toString( i ) );
+        }
+        for ( unsigned i = 1 + next( 6 ); i; --i ) {
+          logical::Method& m = method( node, name + "_m" + Common::toString( i ) );
+          if ( depth < 2 && next( 10 ) == 0 ) {
+            clazz( m, name + "_local" + Common::toString( i ), depth + 1 );
+          }
+        }
+        if ( depth < 2 && next( 5 ) == 0 ) {
+          clazz( node, name + "_inner", depth + 1 );
+        }
+      }
+
+      void package( logical::Package& parent, const string& name, int depth, unsigned classCount ) {
+        logical::Package& node = *factory.createPackageNode();
+        node.setName( name );
+        node.setLanguage( cpp ? lnkCpp : lnkJava );
+        node.setAccessibility( ackPublic );
+        scope( node );
+        parent.addMember( &node );
+        for ( unsigned i = 0; i < classCount; ++i ) {
+          clazz( node, name + "_C" + Common::toString( i ), 0 );
+        }
+        if ( cpp ) {
+          for ( unsigned i = next( 4 ); i; --i ) {
+            method( node, name + "_f" + Common::toString( i ) );
+          }
+          for ( unsigned i = next( 3 ); i; --i ) {
+            attribute( node, name + "_g" + Common::toString( i ) );
+          }
+        }
+        if ( depth < 2 ) {
+          for ( unsigned i = next( 3 ); i; --i ) {
+            package( node, name + "_sub" + Common::toString( i ), depth + 1, classCount / 2 + 1 );
+          }
+        }
+      }
+
+      Factory& factory;
+      bool cpp;
+      mt19937 random;
+      vector<NodeId> classes;
+      vector<NodeId> methods;
+      vector<NodeId> attributes;
+      vector<NodeId> files;
+      vector<base::Component*> components;
+  };
+
+  bool check( bool condition, const string& message ) {
+    if ( ! condition ) {
+      cerr << "FAILED: " << message << endl;
+    }
+    return condition;
+  }
+
+  /**
+  * Runs the metrics and dumps the attributes of the graph nodes (sorted) and the LCOMMap.
+  */
+  string calculate( Factory& factory, rul::RulHandler& rul, unsigned threads ) {
+    OverrideRelations overrides( factory );
+    graph::Graph graph;
+    lim2graph::convertBaseGraph( factory, graph, true, true, true, true, false );
+
+    lim::metrics::SharedContainers shared;
+    lim::metrics::InheritanceHelper inheritance( factory.getReverseEdges() );
+    lim::metrics::LCOMMapType lcomMap;
+    shared.overrides = &overrides;
+    shared.factory = &factory;
+    shared.inheritance = &inheritance;
+    shared.LCOMMap = &lcomMap;
+
+    lim::metrics::LimMetricsVisitor visitor( factory, graph, rul, shared, threads );
+    visitor.run();
+
+    vector<string> lines;
+    graph::Node::NodeIterator nodes = graph.getNodes();
+    while ( nodes.hasNext() ) {
+      graph::Node node = nodes.next();
+      vector<string> values;
+      graph::Attribute::AttributeIterator attributes = node.getAttributes();
+      while ( attributes.hasNext() ) {
+        graph::Attribute& attribute = attributes.next();
+        values.push_back( attribute.getName() + "@" + attribute.getContext() + "=" + attribute.getStringValue() );
+      }
+      sort( values.begin(), values.end() );
+      string line = node.getUID();
+      for ( vector<string>::const_iterator it = values.begin(); it != values.end(); ++it ) {
+        line += " " + *it;
+      }
+      lines.push_back( line );
+    }
+    sort( lines.begin(), lines.end() );
+
+    ostringstream out;
+    for ( vector<string>::const_iterator it = lines.begin(); it != lines.end(); ++it ) {
+      out << *it << "\n";
+    }
+    for ( lim::metrics::LCOMMapType::const_iterator clazz = lcomMap.begin(); clazz != lcomMap.end(); ++clazz ) {
+      for ( map<string, vector<string>>::const_iterator component = clazz->second.begin(); component != clazz->second.end(); ++component ) {
+        out << "LCOM " << clazz->first << " " << component->first;
+        for ( vector<string>::const_iterator method = component->second.begin(); method != component->second.end(); ++method ) {
+          out << " " << *method;
+        }
+        out << "\n";
+      }
+    }
+    return out.str();
+  }
+
+  string firstDifference( const string& actual, const string& expected ) {
+    istringstream actualLines( actual ), expectedLines( expected );
+    string actualLine, expectedLine;
+    while ( getline( expectedLines, expectedLine ) ) {
+      if ( ! getline( actualLines, actualLine ) ) {
+        actualLine = "<end>";
+      }
+      if ( actualLine != expectedLine ) {
+        return actualLine + "\nexpected:\n" + expectedLine;
+      }
+    }
+    return "<longer than expected>";
+  }
+
+  bool testParallel( rul::RulHandler& rul, bool cpp, unsigned seed ) {
+    RefDistributorStrTable strTable;
+    Factory factory( strTable, "", cpp ? limLangCpp : limLangJava );
+    LimGenerator( factory, cpp, seed ).build( 4, 6 );
+    factory.initializeFilter();
+
+    const string name = string( cpp ? "C++" : "Java" ) + " LIM (seed " + Common::toString( seed ) + ")";
+    const string serial = calculate( factory, rul, 1 );
+    bool ok = check( serial.find( "LCOM5@" ) != string::npos, name + ": the metrics are not calculated" );
+    const unsigned threadCounts[] = { 2, 3, 4, 8 };
+    for ( unsigned i = 0; i < 4; ++i ) {
+      const string parallel = calculate( factory, rul, threadCounts[i] );
+      ok &= check( parallel == serial, name + ", " + Common::toString( threadCounts[i] ) + " threads: the metrics differ from the serial ones:\n" + firstDifference( parallel, serial ) );
+    }
+    return ok;
+  }
+
+  /**
+  * Compares the answers of the index for every class with the traversals of lim::Common. The ancestors and the
+  * descendants reaching a cycle must not be covered, and the helper must fall back to the traversal for them.
+  */
+  bool compareIndex( Factory& factory, const string& name, const set<NodeId>& ancestorsInCycle, const set<NodeId>& descendantsInCycle ) {
+    const ReverseEdges& reverseEdges = factory.getReverseEdges();
+    lim::metrics::ClassHierarchyIndex index( factory );
+    lim::metrics::InheritanceHelper indexed( reverseEdges );
+    indexed.setIndex( &index );
+
+    bool ok = true;
+    for ( Factory::const_iterator it = factory.begin(); it != factory.end(); ++it ) {
+      if ( ! Common::getIsClass( **it ) ) {
+        continue;
+      }
+      const logical::Class& clazz = dynamic_cast<const logical::Class&>( **it );
+      const string className = name + ", " + clazz.getName();
+
+      // a fresh traversal for every class, so the results of a cycle do not depend on the order of the classes
+      lim::metrics::InheritanceHelper traversal( reverseEdges );
+      set<const logical::Class*> ancestors;
+      int depth = traversal.collectAncestors( clazz, ancestors );
+      set<const logical::Class*> descendants;
+      traversal.collectDescendants( clazz, descendants );
+
+      if ( ancestorsInCycle.count( clazz.getId() ) ) {
+        set<const logical::Class*> notCollected;
+        ok &= check( index.getNumberOfAncestors( clazz ) < 0 && index.getDepth( clazz ) < 0 && ! index.collectAncestors( clazz, notCollected ),
+          className + ": the ancestors reaching a cycle are covered by the index" );
+        lim::metrics::InheritanceHelper fallback( reverseEdges );
+        fallback.setIndex( &index );
+        ok &= check( fallback.getNumberOfAncestors( clazz ) == (int) ancestors.size(), className + ": the fallback number of ancestors differs from the traversal" );
+        lim::metrics::InheritanceHelper fallbackDepth( reverseEdges );
+        fallbackDepth.setIndex( &index );
+        ok &= check( fallbackDepth.getDepth( clazz ) == depth, className + ": the fallback depth differs from the traversal" );
+      } else {
+        set<const logical::Class*> indexedAncestors;
+        ok &= check( index.collectAncestors( clazz, indexedAncestors ) && indexedAncestors == ancestors, className + ": the ancestors differ from the traversal" );
+        ok &= check( index.getNumberOfAncestors( clazz ) == (int) ancestors.size(), className + ": the number of ancestors differs from the traversal" );
+        ok &= check( index.getDepth( clazz ) == depth, className + ": the depth " + Common::toString( index.getDepth( clazz ) ) + " differs from the traversal " + Common::toString( depth ) );
+
+        set<const logical::Class*> helperAncestors;
+        ok &= check( indexed.collectAncestors( clazz, helperAncestors ) == depth && helperAncestors == ancestors, className + ": the indexed helper differs from the traversal" );
+      }
+
+      if ( descendantsInCycle.count( clazz.getId() ) ) {
+        ok &= check( index.getNumberOfDescendants( clazz ) < 0, className + ": the descendants reaching a cycle are covered by the index" );
+        lim::metrics::InheritanceHelper fallback( reverseEdges );
+        fallback.setIndex( &index );
+        ok &= check( fallback.getNumberOfDescendants( clazz ) == (int) descendants.size(), className + ": the fallback number of descendants differs from the traversal" );
+      } else {
+        ok &= check( index.getNumberOfDescendants( clazz ) == (int) descendants.size(), className + ": the number of descendants differs from the traversal" );
+      }
+    }
+    return ok;
+  }
+
+  bool testIndex( bool cpp, unsigned seed ) {
+    RefDistributorStrTable strTable;
+    Factory factory( strTable, "", cpp ? limLangCpp : limLangJava );
+    LimGenerator( factory, cpp, seed ).build( 3, 8 );
+    return compareIndex( factory, string( cpp ? "C++" : "Java" ) + " LIM (seed " + Common::toString( seed ) + ")", set<NodeId>(), set<NodeId>() );
+  }
+
+  // A <- B <- C <- A is a cycle, D derives from C and E from D, F derives from the acyclic G only
+  bool testCyclicHierarchy() {
+    RefDistributorStrTable strTable;
+    Factory factory( strTable, "", limLangJava );
+    logical::Package& package = *factory.createPackageNode();
+    package.setName( "cycle" );
+    package.setLanguage( lnkJava );
+    factory.getRoot()->addMember( &package );
+
+    const char* names[] = { "A", "B", "C", "D", "E", "F", "G" };
+    map<string, logical::Class*> classes;
+    for ( unsigned i = 0; i < 7; ++i ) {
+      logical::Class& clazz = *factory.createClassNode();
+      clazz.setName( names[i] );
+      clazz.setLanguage( lnkJava );
+      clazz.setClassKind( clkClass );
+      package.addMember( &clazz );
+      classes[names[i]] = &clazz;
+    }
+    const char* subclasses[][2] = { { "B", "A" }, { "C", "B" }, { "A", "C" }, { "D", "C" }, { "E", "D" }, { "F", "G" } };
+    for ( unsigned i = 0; i < 6; ++i ) {
+      factory.beginType();
+      factory.addTypeFormer( factory.createTypeFormerType( classes[subclasses[i][1]]->getId() ).getId() );
+      classes[subclasses[i][0]]->addIsSubclass( factory.endType().getId() );
+    }
+
+    // the ancestors of A-E and the descendants of A-C reach the cycle, the covered classes are checked as usual
+    set<NodeId> ancestorsInCycle, descendantsInCycle;
+    for ( unsigned i = 0; i < 5; ++i ) {
+      ancestorsInCycle.insert( classes[names[i]]->getId() );
+      if ( i < 3 ) {
+        descendantsInCycle.insert( classes[names[i]]->getId() );
+      }
+    }
+    bool ok = compareIndex( factory, "cyclic hierarchy", ancestorsInCycle, descendantsInCycle );
+
+    lim::metrics::ClassHierarchyIndex index( factory );
+    ok &= check( index.getNumberOfAncestors( *classes["F"] ) == 1 && index.getNumberOfDescendants( *classes["G"] ) == 1,
+      "the acyclic part of the cyclic hierarchy is not covered by the index" );
+    ok &= check( index.getNumberOfDescendants( *classes["E"] ) == 0, "the leaf below the cycle is not covered by the index for its descendants" );
+    return ok;
+  }
+
+}
+
+int main( int argc, char* argv[] ) {
+  if ( argc < 2 ) {
+    cerr << "Usage: " << argv[0] << " MET.rul" << endl;
+    return EXIT_FAILURE;
+  }
+
+  bool ok = true;
+  try {
+    rul::RulHandler javaRul( argv[1], "java", "eng" );
+    rul::RulHandler cppRul( argv[1], "cpp", "eng" );
+    for ( unsigned seed = 1; seed <= 3; ++seed ) {
+      ok &= testParallel( javaRul, false, seed );
+      ok &= testParallel( cppRul, true, seed );
+    }
+    for ( unsigned seed = 1; seed <= 10; ++seed ) {
+      ok &= testIndex( false, seed );
+      ok &= testIndex( true, seed );
+    }
+    ok &= testCyclicHierarchy();
+  } catch ( const columbus::Exception& e ) {
+    cerr << "FAILED: " << e.getLocation() << " : " << e.getMessage() << endl;
+    ok = false;
+  }
+
+  if ( ok ) {
+    cout << "LimMetricsTest passed" << endl;
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,197 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+/*
+ * Checks that the ASGs of the shards of a parallel PAN run, built with disjoint node ids
+ * (Factory::setNodeIdStride) and merged with Factory::merge, give the same ASG as the
+ * sequential parsing of the files, and that the merged ASG can be saved, reloaded and extended.
+ */
+
+#include <python/inc/python.h>
+#include <common/inc/StringSup.h>
+#include <boost/filesystem.hpp>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+using namespace columbus;
+using namespace columbus::python::asg;
+
+namespace {
+
+  struct SourceFile {
+    const char* directory;
+    const char* name;
+  };
+
+  // the order of the sequential parsing, the shards get contiguous parts of it
+  const SourceFile files[] = {
+    { "",    "setup" },
+    { "a",   "m1" },
+    { "a/b", "m2" },
+    { "a",   "m3" },
+    { "c",   "m4" },
+    { "a/b", "m5" },
+    { "a",   "m6" },
+    { "c/d", "m7" },
+    { "",    "main" },
+  };
+  const unsigned fileCount = sizeof(files) / sizeof(files[0]);
+
+  module::Package& getPackage(Factory& factory, module::Package& parent, const string& name) {
+    for (ListIterator<module::Package> it = parent.getPackageListIteratorBegin(); it != parent.getPackageListIteratorEnd(); ++it)
+      if (it->getName() == name)
+        return dynamic_cast<module::Package&>(factory.getRef(it->getId()));
+
+    module::Package& package = *factory.createPackageNode();
+    package.setName(name);
+    parent.addPackage(&package);
+    return package;
+  }
+
+  // builds the nodes of a file like the PAN visitor: the packages of the directories, the module and its statements
+  void parse(Factory& factory, const SourceFile& file) {
+    module::Package* package = factory.getRoot();
+    string directory = file.directory;
+    string path;
+    istringstream names(directory);
+    string name;
+    while (getline(names, name, '/')) {
+      package = &getPackage(factory, *package, name);
+      path += name + "/";
+    }
+    path += string(file.name) + ".py";
+
+    module::Module& module = *factory.createModuleNode();
+    module.setName(file.name);
+    module.setPosition(Range(factory.getStringTable(), path, 1, 1, 20, 1));
+    for (unsigned line = 2; line < 5; ++line) {
+      statement::Pass& statement = *factory.createPassNode();
+      statement.setPosition(Range(factory.getStringTable(), path, line, 1, line, 5));
+      module.addStatement(&statement);
+    }
+    package->addModule(&module);
+  }
+
+  void dump(const module::Package& package, const string& indent, ostream& out) {
+    out << indent << "package " << package.getName() << "\n";
+    for (ListIterator<module::Module> it = package.getModuleListIteratorBegin(); it != package.getModuleListIteratorEnd(); ++it) {
+      out << indent << "  module " << it->getName() << " " << it->getPosition().getPath();
+      for (ListIterator<base::Positioned> statement = it->getStatementListIteratorBegin(); statement != it->getStatementListIteratorEnd(); ++statement)
+        out << " " << statement->getPosition().getPath() << ":" << statement->getPosition().getLine();
+      out << "\n";
+    }
+    for (ListIterator<module::Package> it = package.getPackageListIteratorBegin(); it != package.getPackageListIteratorEnd(); ++it)
+      dump(*it, indent + "  ", out);
+  }
+
+  string dump(const Factory& factory) {
+    ostringstream out;
+    dump(*factory.getRoot(), "", out);
+    return out.str();
+  }
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+  bool testMerge(unsigned shardCount, const boost::filesystem::path& directory) {
+    RefDistributorStrTable sequentialStrTable;
+    Factory sequential(sequentialStrTable);
+    for (unsigned i = 0; i < fileCount; ++i)
+      parse(sequential, files[i]);
+    const string expected = dump(sequential);
+
+    vector<string> shardFiles;
+    for (unsigned shard = 0; shard < shardCount; ++shard) {
+      RefDistributorStrTable strTable;
+      // the string tables of the shards are different, the keys of the same strings differ
+      strTable.set("shard" + common::toString(shard));
+      Factory factory(strTable);
+      factory.setNodeIdStride(shard, shardCount);
+      for (unsigned i = shard * fileCount / shardCount; i < (shard + 1) * fileCount / shardCount; ++i)
+        parse(factory, files[i]);
+
+      shardFiles.push_back((directory / ("shard" + common::toString(shard) + ".psi")).string());
+      CsiHeader header;
+      factory.save(shardFiles.back(), header);
+    }
+
+    RefDistributorStrTable strTable;
+    Factory merged(strTable);
+    for (vector<string>::const_iterator it = shardFiles.begin(); it != shardFiles.end(); ++it) {
+      CsiHeader header;
+      merged.merge(*it, header);
+    }
+
+    bool ok = check(dump(merged) == expected, common::toString(shardCount) + " shards: the merged ASG differs from the sequential one:\n" + dump(merged) + "expected:\n" + expected);
+
+    string mergedFile = (directory / "merged.psi").string();
+    {
+      CsiHeader header;
+      merged.save(mergedFile, header);
+    }
+
+    RefDistributorStrTable reloadedStrTable;
+    Factory reloaded(reloadedStrTable);
+    CsiHeader header;
+    reloaded.load(mergedFile, header);
+    ok &= check(dump(reloaded) == expected, common::toString(shardCount) + " shards: the reloaded ASG differs from the sequential one");
+
+    // the ids of the deleted duplicate packages can be reused, but no existing node can be overwritten
+    size_t nodeCount = 0;
+    for (NodeId id = 0; id < reloaded.size(); ++id)
+      if (reloaded.getExist(id))
+        ++nodeCount;
+    module::Module* module = reloaded.createModuleNode();
+    ok &= check(module != NULL && reloaded.getExist(module->getId()), "the reloaded ASG can not be extended");
+    size_t newNodeCount = 0;
+    for (NodeId id = 0; id < reloaded.size(); ++id)
+      if (reloaded.getExist(id))
+        ++newNodeCount;
+    ok &= check(newNodeCount == nodeCount + 1, "a new node overwrote an existing one");
+
+    return ok;
+  }
+
+}
+
+int main() {
+  boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("PythonMergeTest-%%%%-%%%%");
+  boost::filesystem::create_directories(directory);
+
+  bool ok = true;
+  try {
+    for (unsigned shardCount = 1; shardCount <= 4; ++shardCount)
+      ok &= testMerge(shardCount, directory);
+  } catch (const columbus::Exception& e) {
+    cerr << "FAILED: " << e.getLocation() << " : " << e.getMessage() << endl;
+    ok = false;
+  }
+
+  boost::filesystem::remove_all(directory);
+
+  if (ok)
+    cout << "PythonMergeTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,151 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+/*
+ * Checks that StrTableRewriter changes only the strings having the given keys (the paths of the Ranges)
+ * and keeps every other string, the keys and the nodes of the file, like the -fast mode of the ChangePath tools.
+ */
+
+#include <strtable/inc/StrTableRewriter.h>
+#include <io/inc/BinaryIO.h>
+#include <common/inc/StringSup.h>
+#include <boost/filesystem.hpp>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace columbus;
+
+namespace {
+
+  const string FROM = "/home/user/project";
+  const string TO   = "/work/project";
+
+  bool changePath(string& str) {
+    return common::changePath(str, FROM, TO);
+  }
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+  string readFile(const string& filename) {
+    ifstream in(filename.c_str(), ios::binary);
+    ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+  }
+
+  // Writes a file with the layout of a saved ASG: some node data referring to the keys, the end mark and the string table.
+  void writeAsg(const string& filename, const StrTable& strTable, Key pathKey, Key literalKey) {
+    io::BinaryIO binIo(filename, io::IOBase::omWrite);
+    binIo.writeUInt4(100);
+    binIo.writeUShort2(1);
+    binIo.writeUInt4(pathKey);
+    binIo.writeUInt4(literalKey);
+    // the end mark
+    binIo.writeUInt4(0);
+    binIo.writeUShort2(0);
+    strTable.save(binIo);
+    binIo.close();
+  }
+
+  // Loads the string table of a file written by writeAsg, and gives back the node data in front of it.
+  string loadAsg(const string& filename, StrTable& strTable) {
+    string content = readFile(filename);
+    io::BinaryIO binIo(filename, io::IOBase::omRead);
+    for (int i = 0; i < 3; ++i)
+      binIo.readUInt4();
+    binIo.readUShort2();
+    binIo.readUInt4();
+    binIo.readUShort2();
+    strTable.load(binIo);
+    binIo.close();
+    return content.substr(0, 20);
+  }
+
+}
+
+int main() {
+  boost::filesystem::path directory = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("StrTableRewriterTest-%%%%-%%%%");
+  boost::filesystem::create_directories(directory);
+  const string inFilename = (directory / "in.asg").string();
+  const string outFilename = (directory / "out.asg").string();
+
+  const string path = FROM + "/src/Main.java";
+  const string literal = "see " + FROM + "/README";
+  const string name = "Main";
+
+  StrTable strTable;
+  const Key pathKey = strTable.set(path);
+  const Key literalKey = strTable.set(literal);
+  const Key nameKey = strTable.set(name);
+  writeAsg(inFilename, strTable, pathKey, literalKey);
+  const string nodes = readFile(inFilename).substr(0, 20);
+
+  bool ok = true;
+  unsigned changed = 0;
+
+  // only the path is changed
+  StrTableRewriter::KeySet pathKeys;
+  pathKeys.insert(pathKey);
+  StrTableRewriter::Result result = StrTableRewriter::rewrite(inFilename, outFilename, changePath, pathKeys, changed);
+  ok &= check(result == StrTableRewriter::rrRewritten && changed == 1, "the path is not rewritten");
+  if (result == StrTableRewriter::rrRewritten) {
+    StrTable rewritten;
+    ok &= check(loadAsg(outFilename, rewritten) == nodes, "the nodes are changed");
+    ok &= check(rewritten.get(pathKey) == TO + "/src/Main.java", "the path is wrong: " + rewritten.get(pathKey));
+    ok &= check(rewritten.get(literalKey) == literal, "the literal is changed: " + rewritten.get(literalKey));
+    ok &= check(rewritten.get(nameKey) == name, "the name is changed");
+  }
+
+  // without keys every string containing the fragment is changed
+  result = StrTableRewriter::rewrite(inFilename, outFilename, changePath, changed);
+  ok &= check(result == StrTableRewriter::rrRewritten && changed == 2, "the strings are not rewritten");
+
+  // the keys of the paths which are not changed
+  StrTableRewriter::KeySet nameKeys;
+  nameKeys.insert(nameKey);
+  result = StrTableRewriter::rewrite(inFilename, outFilename, changePath, nameKeys, changed);
+  ok &= check(result == StrTableRewriter::rrUnchanged && changed == 0, "a string without the fragment is rewritten");
+
+  // the changed path would be equal to another string, so its key can not be kept
+  const Key otherKey = strTable.set(TO + "/src/Main.java");
+  writeAsg(inFilename, strTable, pathKey, otherKey);
+  result = StrTableRewriter::rewrite(inFilename, outFilename, changePath, pathKeys, changed);
+  ok &= check(result == StrTableRewriter::rrConflict, "the conflict is not detected");
+
+  // there is no string table in the file
+  {
+    ofstream out(inFilename.c_str(), ios::binary | ios::trunc);
+    out << "not an ASG";
+  }
+  result = StrTableRewriter::rewrite(inFilename, outFilename, changePath, pathKeys, changed);
+  ok &= check(result == StrTableRewriter::rrNotFound, "a string table is found in a wrong file");
+
+  boost::filesystem::remove_all(directory);
+
+  if (ok)
+    cout << "StrTableRewriterTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
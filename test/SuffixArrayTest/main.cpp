@@ -0,0 +1,184 @@
+/*
+ *  This file is part of OpenStaticAnalyzer.
+ *
+ *  Copyright (c) 2004-2018 Department of Software Engineering - University of Szeged
+ *
+ *  Licensed under Version 1.2 of the EUPL (the "Licence");
+ *
+ *  You may not use this work except in compliance with the Licence.
+ *
+ *  You may obtain a copy of the Licence in the LICENSE file or at:
+ *
+ *  https://joinup.ec.europa.eu/software/page/eupl
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the Licence is distributed on an "AS IS" basis,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the Licence for the specific language governing permissions and
+ *  limitations under the Licence.
+ */
+
+
+/*
+ * Checks that SaisSuffixArray gives the same suffix array and LCP array as LinearSuffixArray (the DC3 based builder)
+ * on random sequences: small and large alphabets, negative symbols (the unique separators of the clone detection),
+ * sequences of copied units like the serialized ASGs, and degenerate ones (two symbols, one repeated symbol). The
+ * short sequences are checked against the naively sorted suffixes too. Every sequence is built without an executor
+ * and on an executor, and the lengths of the longer ones are around the block boundaries of the parallel loops.
+ */
+
+#include <Exception.h>
+#include <suffixarray/inc/suffix_array.h>
+#include <threadpool/inc/Executor.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace columbus;
+using namespace columbus::suffix_array;
+
+namespace {
+
+  const unsigned threadCount = 4;
+
+  // the length of a block of the parallel loops of SaisSuffixArray
+  const unsigned blockSize = 1 << 16;
+
+  bool check(bool condition, const string& message) {
+    if (!condition)
+      cerr << "FAILED: " << message << endl;
+    return condition;
+  }
+
+  // gives access to the suffixes of the builders
+  template <class Builder>
+  class Checked : public Builder {
+    public:
+      Checked(Sequence<int>& sequence) : Builder(sequence) {}
+      Checked(Sequence<int>& sequence, thread::Executor* executor) : Builder(sequence, executor) {}
+
+      unsigned getPosition(unsigned i) const { return this->SuffixArray<int>::suffixes[i].position; }
+      unsigned getLcp(unsigned i) const { return this->SuffixArray<int>::suffixes[i].lcp; }
+  };
+
+  template <class Expected, class Actual>
+  bool same(const Expected& expected, const Actual& actual, unsigned length, const string& name) {
+    for (unsigned i = 0; i < length; ++i) {
+      if (expected.getPosition(i) != actual.getPosition(i) || expected.getLcp(i) != actual.getLcp(i))
+        return check(false, name + ": differs at " + to_string(i) + ": position " + to_string(actual.getPosition(i)) + " lcp " + to_string(actual.getLcp(i))
+          + ", expected position " + to_string(expected.getPosition(i)) + " lcp " + to_string(expected.getLcp(i)));
+    }
+    return true;
+  }
+
+  // the suffixes sorted by comparing them one by one
+  class Naive {
+    public:
+      Naive(const vector<int>& symbols) : positions(symbols.size()), lcps(symbols.size(), 0) {
+        for (unsigned i = 0; i < positions.size(); ++i)
+          positions[i] = i;
+        sort(positions.begin(), positions.end(), [&symbols](unsigned a, unsigned b) {
+          return lexicographical_compare(symbols.begin() + a, symbols.end(), symbols.begin() + b, symbols.end());
+        });
+        for (unsigned i = 1; i < positions.size(); ++i) {
+          unsigned a = positions[i - 1];
+          unsigned b = positions[i];
+          while (a + lcps[i] < symbols.size() && b + lcps[i] < symbols.size() && symbols[a + lcps[i]] == symbols[b + lcps[i]])
+            ++lcps[i];
+        }
+      }
+
+      unsigned getPosition(unsigned i) const { return positions[i]; }
+      unsigned getLcp(unsigned i) const { return lcps[i]; }
+
+    private:
+      vector<unsigned> positions;
+      vector<unsigned> lcps;
+  };
+
+  bool test(vector<int> symbols, thread::Executor& executor, const string& name) {
+    Sequence<int> sequence(symbols);
+    const unsigned length = (unsigned)symbols.size();
+    Checked<LinearSuffixArray<int> > dc3(sequence);
+
+    bool ok = true;
+    if (length <= 2000)
+      ok &= same(Naive(symbols), dc3, length, name + " (dc3 vs. naive)");
+    {
+      Checked<SaisSuffixArray<int> > sais(sequence);
+      ok &= same(dc3, sais, length, name + " (sais)");
+    }
+    {
+      Checked<SaisSuffixArray<int> > sais(sequence, &executor);
+      ok &= same(dc3, sais, length, name + " (sais on the executor)");
+    }
+    return ok;
+  }
+
+  vector<int> randomSymbols(mt19937& random, unsigned length, int minSymbol, int maxSymbol) {
+    uniform_int_distribution<int> symbol(minSymbol, maxSymbol);
+    vector<int> symbols(length);
+    for (vector<int>::iterator it = symbols.begin(); it != symbols.end(); ++it)
+      *it = symbol(random);
+    return symbols;
+  }
+
+  // copies of a few units with some changed symbols, every unit is closed by a unique negative separator
+  vector<int> copiedUnits(mt19937& random, unsigned length, unsigned unitCount) {
+    uniform_int_distribution<unsigned> unitLength(5, 60);
+    vector<vector<int> > units(unitCount);
+    for (vector<vector<int> >::iterator it = units.begin(); it != units.end(); ++it)
+      *it = randomSymbols(random, unitLength(random), 1, 50);
+
+    vector<int> symbols;
+    int separator = -1;
+    while (symbols.size() < length) {
+      const vector<int>& unit = units[random() % units.size()];
+      for (vector<int>::const_iterator it = unit.begin(); it != unit.end(); ++it)
+        symbols.push_back(random() % 20 ? *it : 1 + (int)(random() % 50));
+      symbols.push_back(separator--);
+    }
+    symbols.resize(length);
+    return symbols;
+  }
+
+}
+
+int main() {
+  bool ok = true;
+  try {
+    thread::Executor executor(threadCount);
+    mt19937 random(42);
+
+    ok &= test(vector<int>(2, 7), executor, "two equal symbols");
+    ok &= test({ 3, 1 }, executor, "two different symbols");
+    ok &= test(vector<int>(1000, 5), executor, "one repeated symbol");
+    ok &= test(vector<int>(blockSize + 1, 5), executor, "one repeated symbol, long");
+
+    for (unsigned i = 0; ok && i < 200; ++i) {
+      unsigned length = 2 + random() % 300;
+      ok &= test(randomSymbols(random, length, 0, 1), executor, "binary sequence " + to_string(i));
+      ok &= test(randomSymbols(random, length, 1, 4), executor, "small alphabet " + to_string(i));
+      ok &= test(randomSymbols(random, length, -1000000, 1000000), executor, "large alphabet " + to_string(i));
+      ok &= test(copiedUnits(random, length, 3), executor, "copied units " + to_string(i));
+    }
+
+    const unsigned lengths[] = { blockSize - 1, blockSize, blockSize + 1, 3 * blockSize + 7 };
+    for (unsigned i = 0; ok && i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+      ok &= test(randomSymbols(random, lengths[i], 1, 3), executor, "small alphabet of length " + to_string(lengths[i]));
+      ok &= test(randomSymbols(random, lengths[i], 1, 100000), executor, "large alphabet of length " + to_string(lengths[i]));
+      ok &= test(copiedUnits(random, lengths[i], 50), executor, "copied units of length " + to_string(lengths[i]));
+    }
+  } catch (const columbus::Exception& e) {
+    cerr << "FAILED: " << e.getLocation() << " : " << e.getMessage() << endl;
+    ok = false;
+  }
+
+  if (ok)
+    cout << "SuffixArrayTest passed" << endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}